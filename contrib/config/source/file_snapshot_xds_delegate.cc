@@ -0,0 +1,291 @@
+#include "contrib/config/source/file_snapshot_xds_delegate.h"
+
+#include "envoy/registry/registry.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/utility.h"
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/str_cat.h"
+
+#include "contrib/config/source/xds_snapshot.pb.h"
+#include "contrib/envoy/extensions/config/v3alpha/file_snapshot_xds_delegate_config.pb.validate.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Config {
+
+namespace {
+
+constexpr std::chrono::milliseconds DefaultFlushInterval{1000};
+
+FileSnapshotXdsDelegateStats generateStats(Stats::Scope& scope) {
+  const std::string prefix = "xds_delegate.file_snapshot.";
+  return {ALL_FILE_SNAPSHOT_XDS_DELEGATE_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                               POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
+} // namespace
+
+FileSnapshotXdsDelegate::FileSnapshotXdsDelegate(
+    const envoy::extensions::config::v3alpha::FileSnapshotXdsDelegateConfig& config, Api::Api& api,
+    Event::Dispatcher& dispatcher)
+    : file_system_(api.fileSystem()), filename_(config.filename()),
+      flush_interval_(PROTOBUF_GET_MS_OR_DEFAULT(config, flush_interval,
+                                                 DefaultFlushInterval.count())),
+      stats_(generateStats(api.rootScope())),
+      flush_timer_(dispatcher.createTimer([this]() { flush(); })) {
+  loadSnapshot();
+  writer_thread_ = api.threadFactory().createThread([this]() { writerThread(); },
+                                                    Thread::Options{"xds_snapshot"});
+}
+
+FileSnapshotXdsDelegate::~FileSnapshotXdsDelegate() {
+  // Persist the updates accepted since the last flush before shutting down.
+  flush();
+  {
+    absl::MutexLock lock(&mutex_);
+    terminate_ = true;
+  }
+  writer_thread_->join();
+}
+
+void FileSnapshotXdsDelegate::loadSnapshot() {
+  if (!file_system_.fileExists(filename_)) {
+    ENVOY_LOG(info, "xDS snapshot file {} does not exist yet", filename_);
+    return;
+  }
+  const absl::StatusOr<std::string> contents_or_error = file_system_.fileReadToEnd(filename_);
+  XdsSnapshot snapshot;
+  if (!contents_or_error.ok() || !snapshot.ParseFromString(contents_or_error.value()) ||
+      !snapshot.complete()) {
+    ENVOY_LOG(warn, "Failed to load xDS snapshot file {}, ignoring it", filename_);
+    stats_.snapshot_load_failed_.inc();
+    return;
+  }
+  for (auto& source : *snapshot.mutable_sources()) {
+    auto resources = std::make_shared<ResourceMap>();
+    for (auto& resource : *source.mutable_resources()) {
+      const std::string name = resource.name();
+      resources->insert_or_assign(name, std::make_shared<envoy::service::discovery::v3::Resource>(
+                                            std::move(resource)));
+    }
+    num_resources_ += resources->size();
+    sources_[source.key()] = std::move(resources);
+  }
+  stats_.resources_.set(num_resources_);
+  stats_.snapshot_bytes_.set(contents_or_error.value().size());
+  stats_.snapshot_load_success_.inc();
+  ENVOY_LOG(info, "Loaded {} resources of {} xDS sources from snapshot file {}", num_resources_,
+            sources_.size(), filename_);
+}
+
+std::vector<envoy::service::discovery::v3::Resource> FileSnapshotXdsDelegate::getResources(
+    const Envoy::Config::XdsSourceId& source_id,
+    const absl::flat_hash_set<std::string>& resource_names) const {
+  std::vector<envoy::service::discovery::v3::Resource> resources;
+  const auto it = sources_.find(source_id.toKey());
+  if (it == sources_.end()) {
+    return resources;
+  }
+  const ResourceMap& source_resources = *it->second;
+  if (resource_names.empty()) {
+    resources.reserve(source_resources.size());
+    for (const auto& [name, resource] : source_resources) {
+      UNREFERENCED_PARAMETER(name);
+      resources.push_back(*resource);
+    }
+  } else {
+    for (const std::string& name : resource_names) {
+      if (const auto resource = source_resources.find(name); resource != source_resources.end()) {
+        resources.push_back(*resource->second);
+      }
+    }
+  }
+  stats_.resources_loaded_.add(resources.size());
+  return resources;
+}
+
+void FileSnapshotXdsDelegate::onConfigUpdated(
+    const Envoy::Config::XdsSourceId& source_id,
+    const std::vector<Envoy::Config::DecodedResourceRef>& resources) {
+  // A state-of-the-world update replaces all the resources of the source.
+  auto source_resources = std::make_shared<ResourceMap>();
+  source_resources->reserve(resources.size());
+  for (const auto& decoded_resource_ref : resources) {
+    const Envoy::Config::DecodedResource& decoded_resource = decoded_resource_ref.get();
+    if (!decoded_resource.hasResource()) {
+      continue;
+    }
+    auto resource = std::make_shared<envoy::service::discovery::v3::Resource>();
+    resource->set_name(decoded_resource.name());
+    resource->set_version(decoded_resource.version());
+    resource->mutable_aliases()->Add(decoded_resource.aliases().begin(),
+                                     decoded_resource.aliases().end());
+    resource->mutable_resource()->PackFrom(decoded_resource.resource());
+    source_resources->insert_or_assign(decoded_resource.name(), std::move(resource));
+  }
+  updateSource(source_id.toKey(), std::move(source_resources));
+}
+
+void FileSnapshotXdsDelegate::onDeltaConfigUpdated(
+    const Envoy::Config::XdsSourceId& source_id,
+    const Protobuf::RepeatedPtrField<envoy::service::discovery::v3::Resource>& added_resources,
+    const Protobuf::RepeatedPtrField<std::string>& removed_resources) {
+  const std::string key = source_id.toKey();
+  // The resource map may be in the process of being written, so a copy is updated. Only pointers
+  // to the unchanged resources are copied.
+  auto source_resources = std::make_shared<ResourceMap>();
+  if (const auto it = sources_.find(key); it != sources_.end()) {
+    *source_resources = *it->second;
+  }
+  for (const auto& resource : added_resources) {
+    // Heartbeats and unresolved aliases carry no resource to persist.
+    if (!resource.has_resource()) {
+      continue;
+    }
+    source_resources->insert_or_assign(
+        resource.name(), std::make_shared<envoy::service::discovery::v3::Resource>(resource));
+  }
+  for (const std::string& name : removed_resources) {
+    source_resources->erase(name);
+  }
+  updateSource(key, std::move(source_resources));
+}
+
+void FileSnapshotXdsDelegate::onResourceLoadFailed(
+    const Envoy::Config::XdsSourceId& source_id, const std::string& resource_name,
+    const absl::optional<EnvoyException>& exception) {
+  ENVOY_LOG(warn, "Failed to load persisted xDS resource {} of {}: {}", resource_name,
+            source_id.toKey(), exception.has_value() ? exception->what() : "unknown error");
+  stats_.resource_load_failed_.inc();
+}
+
+void FileSnapshotXdsDelegate::updateSource(const std::string& key,
+                                           ResourceMapSharedPtr resources) {
+  ResourceMapSharedPtr& entry = sources_[key];
+  if (entry != nullptr) {
+    num_resources_ -= entry->size();
+  }
+  num_resources_ += resources->size();
+  entry = std::move(resources);
+  stats_.resources_.set(num_resources_);
+
+  dirty_ = true;
+  if (!flush_timer_->enabled()) {
+    flush_timer_->enableTimer(flush_interval_);
+  }
+}
+
+void FileSnapshotXdsDelegate::flush() {
+  if (!dirty_) {
+    return;
+  }
+  dirty_ = false;
+  flush_timer_->disableTimer();
+  absl::MutexLock lock(&mutex_);
+  // A snapshot that the writer thread did not get to yet is superseded by this one.
+  pending_snapshot_ = sources_;
+}
+
+void FileSnapshotXdsDelegate::waitForFlush() {
+  const auto condition = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return !pending_snapshot_.has_value() && !writing_;
+  };
+  absl::MutexLock lock(&mutex_);
+  mutex_.Await(absl::Condition(&condition));
+}
+
+void FileSnapshotXdsDelegate::writerThread() {
+  const auto condition = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return pending_snapshot_.has_value() || terminate_;
+  };
+  while (true) {
+    SourceMap sources;
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(&condition));
+      // Pending snapshots are written even when terminating, as the last one is handed over by
+      // the destructor.
+      if (!pending_snapshot_.has_value()) {
+        return;
+      }
+      sources = std::move(pending_snapshot_.value());
+      pending_snapshot_.reset();
+      writing_ = true;
+    }
+    writeSnapshot(sources);
+    {
+      absl::MutexLock lock(&mutex_);
+      writing_ = false;
+    }
+  }
+}
+
+void FileSnapshotXdsDelegate::writeSnapshot(const SourceMap& sources) {
+  XdsSnapshot snapshot;
+  for (const auto& [key, resources] : sources) {
+    XdsSnapshot::Source& source = *snapshot.add_sources();
+    source.set_key(key);
+    source.mutable_resources()->Reserve(resources->size());
+    for (const auto& [name, resource] : *resources) {
+      UNREFERENCED_PARAMETER(name);
+      *source.add_resources() = *resource;
+    }
+  }
+  snapshot.set_complete(true);
+  const std::string contents = snapshot.SerializeAsString();
+
+  // The snapshot is written to a temporary file which then replaces the previous snapshot, so that
+  // a crash while writing never leaves a truncated snapshot behind.
+  const std::string tmp_filename = absl::StrCat(filename_, ".tmp");
+  static constexpr Filesystem::FlagSet DefaultFlags{1 << Filesystem::File::Operation::Write |
+                                                    1 << Filesystem::File::Operation::Create};
+  Filesystem::FilePathAndType file_info{Filesystem::DestinationType::File, tmp_filename};
+  auto file = file_system_.createFile(file_info);
+  if (!file || !file->open(DefaultFlags).return_value_) {
+    ENVOY_LOG(error, "Failed to open xDS snapshot file {}", tmp_filename);
+    stats_.flush_failed_.inc();
+    return;
+  }
+  const Api::IoCallSizeResult result = file->write(contents);
+  file->close();
+  if (!result.ok() || static_cast<size_t>(result.return_value_) != contents.size()) {
+    ENVOY_LOG(error, "Failed to write xDS snapshot file {}", tmp_filename);
+    stats_.flush_failed_.inc();
+    return;
+  }
+  const Api::SysCallIntResult rename_result =
+      Api::OsSysCallsSingleton::get().rename(tmp_filename.c_str(), filename_.c_str());
+  if (rename_result.return_value_ != 0) {
+    ENVOY_LOG(error, "Failed to replace xDS snapshot file {}: {}", filename_,
+              errorDetails(rename_result.errno_));
+    stats_.flush_failed_.inc();
+    return;
+  }
+  stats_.snapshot_bytes_.set(contents.size());
+  stats_.flush_success_.inc();
+}
+
+Envoy::ProtobufTypes::MessagePtr FileSnapshotXdsDelegateFactory::createEmptyConfigProto() {
+  return std::make_unique<envoy::extensions::config::v3alpha::FileSnapshotXdsDelegateConfig>();
+}
+
+std::string FileSnapshotXdsDelegateFactory::name() const {
+  return "envoy.xds_delegates.file_snapshot";
+}
+
+Envoy::Config::XdsResourcesDelegatePtr FileSnapshotXdsDelegateFactory::createXdsResourcesDelegate(
+    const ProtobufWkt::Any& config, ProtobufMessage::ValidationVisitor& validation_visitor,
+    Api::Api& api, Event::Dispatcher& dispatcher) {
+  const auto delegate_config = MessageUtil::anyConvertAndValidate<
+      envoy::extensions::config::v3alpha::FileSnapshotXdsDelegateConfig>(config,
+                                                                          validation_visitor);
+  return std::make_unique<FileSnapshotXdsDelegate>(delegate_config, api, dispatcher);
+}
+
+REGISTER_FACTORY(FileSnapshotXdsDelegateFactory, Envoy::Config::XdsResourcesDelegateFactory);
+
+} // namespace Config
+} // namespace Extensions
+} // namespace Envoy
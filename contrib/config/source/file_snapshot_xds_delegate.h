@@ -0,0 +1,136 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/api/api.h"
+#include "envoy/config/xds_resources_delegate.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread/thread.h"
+
+#include "source/common/common/logger.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "contrib/envoy/extensions/config/v3alpha/file_snapshot_xds_delegate_config.pb.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Config {
+
+/**
+ * All file snapshot xDS delegate stats. @see stats_macros.h
+ */
+#define ALL_FILE_SNAPSHOT_XDS_DELEGATE_STATS(COUNTER, GAUGE)                                       \
+  COUNTER(flush_failed)                                                                            \
+  COUNTER(flush_success)                                                                           \
+  COUNTER(resource_load_failed)                                                                    \
+  COUNTER(resources_loaded)                                                                        \
+  COUNTER(snapshot_load_failed)                                                                    \
+  COUNTER(snapshot_load_success)                                                                   \
+  GAUGE(resources, NeverImport)                                                                    \
+  GAUGE(snapshot_bytes, NeverImport)
+
+/**
+ * Struct definition for all file snapshot xDS delegate stats. @see stats_macros.h
+ */
+struct FileSnapshotXdsDelegateStats {
+  ALL_FILE_SNAPSHOT_XDS_DELEGATE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * An xDS resources delegate which keeps the last accepted resources of every xDS source, keyed by
+ * XdsSourceId::toKey() (i.e. per authority and type URL), and persists them to a snapshot file.
+ *
+ * The resources are kept as immutable shared objects, so that a flush only copies pointers on the
+ * main thread. Serializing and writing the snapshot happens on a dedicated thread.
+ */
+class FileSnapshotXdsDelegate : public Envoy::Config::XdsResourcesDelegate,
+                                Logger::Loggable<Logger::Id::config> {
+public:
+  FileSnapshotXdsDelegate(
+      const envoy::extensions::config::v3alpha::FileSnapshotXdsDelegateConfig& config,
+      Api::Api& api, Event::Dispatcher& dispatcher);
+  ~FileSnapshotXdsDelegate() override;
+
+  // Config::XdsResourcesDelegate
+  std::vector<envoy::service::discovery::v3::Resource>
+  getResources(const Envoy::Config::XdsSourceId& source_id,
+               const absl::flat_hash_set<std::string>& resource_names) const override;
+  void onConfigUpdated(const Envoy::Config::XdsSourceId& source_id,
+                       const std::vector<Envoy::Config::DecodedResourceRef>& resources) override;
+  void onDeltaConfigUpdated(
+      const Envoy::Config::XdsSourceId& source_id,
+      const Protobuf::RepeatedPtrField<envoy::service::discovery::v3::Resource>& added_resources,
+      const Protobuf::RepeatedPtrField<std::string>& removed_resources) override;
+  void onResourceLoadFailed(const Envoy::Config::XdsSourceId& source_id,
+                            const std::string& resource_name,
+                            const absl::optional<EnvoyException>& exception) override;
+
+  /**
+   * Hands the current resources to the writer thread, if they changed since the last flush.
+   */
+  void flush() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  /**
+   * Blocks until the writer thread has written all the flushed resources. Intended for tests.
+   */
+  void waitForFlush() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  const FileSnapshotXdsDelegateStats& stats() const { return stats_; }
+
+private:
+  using ResourceSharedPtr = std::shared_ptr<const envoy::service::discovery::v3::Resource>;
+  // The resources of a single xDS source, keyed by resource name.
+  using ResourceMap = absl::flat_hash_map<std::string, ResourceSharedPtr>;
+  using ResourceMapSharedPtr = std::shared_ptr<const ResourceMap>;
+  // Keyed by XdsSourceId::toKey().
+  using SourceMap = absl::flat_hash_map<std::string, ResourceMapSharedPtr>;
+
+  void loadSnapshot();
+  void updateSource(const std::string& key, ResourceMapSharedPtr resources);
+  void writerThread() ABSL_LOCKS_EXCLUDED(mutex_);
+  void writeSnapshot(const SourceMap& sources);
+
+  Filesystem::Instance& file_system_;
+  const std::string filename_;
+  const std::chrono::milliseconds flush_interval_;
+  FileSnapshotXdsDelegateStats stats_;
+  // Only accessed on the main thread.
+  SourceMap sources_;
+  uint64_t num_resources_{};
+  bool dirty_{};
+  Event::TimerPtr flush_timer_;
+
+  absl::Mutex mutex_;
+  // The resources to be written next by the writer thread.
+  absl::optional<SourceMap> pending_snapshot_ ABSL_GUARDED_BY(mutex_);
+  bool writing_ ABSL_GUARDED_BY(mutex_){};
+  bool terminate_ ABSL_GUARDED_BY(mutex_){};
+  Thread::ThreadPtr writer_thread_;
+};
+
+// A factory for creating instances of FileSnapshotXdsDelegate from the typed_config field of a
+// TypedExtensionConfig protocol buffer message.
+class FileSnapshotXdsDelegateFactory : public Envoy::Config::XdsResourcesDelegateFactory {
+public:
+  FileSnapshotXdsDelegateFactory() = default;
+
+  Envoy::ProtobufTypes::MessagePtr createEmptyConfigProto() override;
+
+  std::string name() const override;
+
+  Envoy::Config::XdsResourcesDelegatePtr
+  createXdsResourcesDelegate(const ProtobufWkt::Any& config,
+                             ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api,
+                             Event::Dispatcher& dispatcher) override;
+};
+
+} // namespace Config
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,90 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "envoy/api/os_sys_calls.h"
+#include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/service/discovery/v3/discovery.pb.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/config_subscription/grpc/xds_source_id.h"
+
+#include "test/benchmark/main.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/resources.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "contrib/config/source/file_snapshot_xds_delegate.h"
+
+using ::benchmark::State;
+using Envoy::benchmark::skipExpensiveBenchmarks;
+
+namespace Envoy {
+namespace {
+
+const Config::XdsConfigSourceId& cdsSourceId() {
+  CONSTRUCT_ON_FIRST_USE(Config::XdsConfigSourceId, "xds_cluster", Config::TypeUrl::get().Cluster);
+}
+
+envoy::extensions::config::v3alpha::FileSnapshotXdsDelegateConfig snapshotConfig() {
+  envoy::extensions::config::v3alpha::FileSnapshotXdsDelegateConfig config;
+  config.set_filename(TestEnvironment::temporaryPath("xds_snapshot_speed_test.pb"));
+  return config;
+}
+
+// Writes a snapshot holding num_clusters clusters of hosts_per_cluster endpoints each.
+void writeSnapshot(Api::Api& api, Event::Dispatcher& dispatcher, size_t num_clusters,
+                   size_t hosts_per_cluster) {
+  const auto config = snapshotConfig();
+  Api::OsSysCallsSingleton().get().unlink(config.filename().c_str());
+  Extensions::Config::FileSnapshotXdsDelegate delegate(config, api, dispatcher);
+  Protobuf::RepeatedPtrField<envoy::service::discovery::v3::Resource> added_resources;
+  for (size_t i = 0; i < num_clusters; ++i) {
+    envoy::config::cluster::v3::Cluster cluster;
+    cluster.set_name(absl::StrCat("cluster_", i));
+    cluster.set_type(envoy::config::cluster::v3::Cluster::STATIC);
+    cluster.mutable_connect_timeout()->set_seconds(1);
+    auto* endpoints = cluster.mutable_load_assignment()->add_endpoints();
+    for (size_t j = 0; j < hosts_per_cluster; ++j) {
+      auto* socket_address = endpoints->add_lb_endpoints()
+                                 ->mutable_endpoint()
+                                 ->mutable_address()
+                                 ->mutable_socket_address();
+      socket_address->set_address("10.0.1.1");
+      socket_address->set_port_value(1000 + j);
+    }
+    auto* resource = added_resources.Add();
+    resource->set_name(cluster.name());
+    resource->set_version("1");
+    resource->mutable_resource()->PackFrom(cluster);
+  }
+  delegate.onDeltaConfigUpdated(cdsSourceId(), added_resources, {});
+  delegate.flush();
+  delegate.waitForFlush();
+}
+
+} // namespace
+} // namespace Envoy
+
+// Measures the startup cost of loading a snapshot and handing its resources to a subscription.
+static void loadSnapshot(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  Envoy::Stats::IsolatedStoreImpl store;
+  Envoy::Api::ApiPtr api = Envoy::Api::createApiForTest(store);
+  Envoy::Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  // if we've been instructed to skip tests, only run once no matter the argument:
+  const size_t num_clusters = skipExpensiveBenchmarks() ? 1 : state.range(0);
+  Envoy::writeSnapshot(*api, *dispatcher, num_clusters, 4);
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    Envoy::Extensions::Config::FileSnapshotXdsDelegate delegate(Envoy::snapshotConfig(), *api,
+                                                                *dispatcher);
+    const auto resources = delegate.getResources(Envoy::cdsSourceId(), {});
+    RELEASE_ASSERT(resources.size() == num_clusters, "");
+  }
+}
+
+BENCHMARK(loadSnapshot)->Arg(1000)->Arg(30000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,262 @@
+#include "envoy/api/os_sys_calls.h"
+#include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/service/discovery/v3/discovery.pb.h"
+
+#include "source/extensions/config_subscription/grpc/xds_source_id.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/resources.h"
+#include "test/test_common/utility.h"
+
+#include "contrib/config/source/file_snapshot_xds_delegate.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+using ::Envoy::Config::XdsConfigSourceId;
+using ::Envoy::Extensions::Config::FileSnapshotXdsDelegate;
+
+class FileSnapshotXdsDelegateTest : public testing::Test {
+public:
+  FileSnapshotXdsDelegateTest()
+      : api_(Api::createApiForTest(store_)), dispatcher_(api_->allocateDispatcher("test_thread")),
+        filename_(TestEnvironment::temporaryPath("xds_snapshot.pb")) {
+    Api::OsSysCallsSingleton().get().unlink(filename_.c_str());
+    Api::OsSysCallsSingleton().get().unlink(tmp_filename_.c_str());
+    createDelegate();
+  }
+
+  void createDelegate() {
+    // Destroying the previous delegate flushes its pending updates.
+    delegate_.reset();
+    envoy::extensions::config::v3alpha::FileSnapshotXdsDelegateConfig config;
+    config.set_filename(filename_);
+    delegate_ = std::make_unique<FileSnapshotXdsDelegate>(config, *api_, *dispatcher_);
+  }
+
+  void flush() {
+    delegate_->flush();
+    delegate_->waitForFlush();
+  }
+
+  static envoy::config::cluster::v3::Cluster makeCluster(const std::string& name,
+                                                         uint32_t timeout_seconds = 1) {
+    envoy::config::cluster::v3::Cluster cluster;
+    cluster.set_name(name);
+    cluster.mutable_connect_timeout()->set_seconds(timeout_seconds);
+    return cluster;
+  }
+
+  static envoy::service::discovery::v3::Resource makeResource(const std::string& name,
+                                                              const std::string& version,
+                                                              uint32_t timeout_seconds = 1) {
+    envoy::service::discovery::v3::Resource resource;
+    resource.set_name(name);
+    resource.set_version(version);
+    resource.mutable_resource()->PackFrom(makeCluster(name, timeout_seconds));
+    return resource;
+  }
+
+  // @return the persisted resources of the source, keyed by name.
+  absl::flat_hash_map<std::string, envoy::service::discovery::v3::Resource>
+  getResources(const XdsConfigSourceId& source_id) {
+    absl::flat_hash_map<std::string, envoy::service::discovery::v3::Resource> resources;
+    for (auto& resource : delegate_->getResources(source_id, {})) {
+      const std::string name = resource.name();
+      resources.emplace(name, std::move(resource));
+    }
+    return resources;
+  }
+
+  Stats::TestUtil::TestStore store_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  const std::string filename_;
+  const std::string tmp_filename_{filename_ + ".tmp"};
+  std::unique_ptr<FileSnapshotXdsDelegate> delegate_;
+  const XdsConfigSourceId cds_source_id_{"xds_cluster", Config::TypeUrl::get().Cluster};
+};
+
+// Resources of a state-of-the-world update are available after a restart.
+TEST_F(FileSnapshotXdsDelegateTest, SotwUpdateRoundTrip) {
+  const auto decoded_resources =
+      TestUtility::decodeResources({makeCluster("cluster_1"), makeCluster("cluster_2")});
+  delegate_->onConfigUpdated(cds_source_id_, decoded_resources.refvec_);
+  EXPECT_EQ(2, store_.gauge("xds_delegate.file_snapshot.resources",
+                            Stats::Gauge::ImportMode::NeverImport)
+                   .value());
+  flush();
+  EXPECT_EQ(1, store_.counter("xds_delegate.file_snapshot.flush_success").value());
+
+  createDelegate();
+  EXPECT_EQ(1, store_.counter("xds_delegate.file_snapshot.snapshot_load_success").value());
+  auto resources = getResources(cds_source_id_);
+  ASSERT_EQ(2, resources.size());
+  envoy::config::cluster::v3::Cluster cluster;
+  ASSERT_TRUE(MessageUtil::unpackTo(resources["cluster_1"].resource(), cluster).ok());
+  EXPECT_TRUE(TestUtility::protoEqual(makeCluster("cluster_1"), cluster));
+  EXPECT_TRUE(resources.contains("cluster_2"));
+
+  // A subsequent state-of-the-world update replaces all of the source's resources.
+  const auto updated_resources = TestUtility::decodeResources({makeCluster("cluster_3")});
+  delegate_->onConfigUpdated(cds_source_id_, updated_resources.refvec_);
+  resources = getResources(cds_source_id_);
+  ASSERT_EQ(1, resources.size());
+  EXPECT_TRUE(resources.contains("cluster_3"));
+}
+
+// Delta updates are applied on top of the persisted resources of the source.
+TEST_F(FileSnapshotXdsDelegateTest, DeltaUpdates) {
+  Protobuf::RepeatedPtrField<envoy::service::discovery::v3::Resource> added_resources;
+  *added_resources.Add() = makeResource("cluster_1", "1");
+  *added_resources.Add() = makeResource("cluster_2", "1");
+  delegate_->onDeltaConfigUpdated(cds_source_id_, added_resources, {});
+  flush();
+  createDelegate();
+
+  added_resources.Clear();
+  *added_resources.Add() = makeResource("cluster_2", "2", 5);
+  *added_resources.Add() = makeResource("cluster_3", "1");
+  // Entries without a resource, e.g. heartbeats, are not persisted.
+  added_resources.Add()->set_name("cluster_4");
+  Protobuf::RepeatedPtrField<std::string> removed_resources;
+  removed_resources.Add("cluster_1");
+  delegate_->onDeltaConfigUpdated(cds_source_id_, added_resources, removed_resources);
+  flush();
+  createDelegate();
+
+  auto resources = getResources(cds_source_id_);
+  ASSERT_EQ(2, resources.size());
+  EXPECT_EQ("2", resources["cluster_2"].version());
+  envoy::config::cluster::v3::Cluster cluster;
+  ASSERT_TRUE(MessageUtil::unpackTo(resources["cluster_2"].resource(), cluster).ok());
+  EXPECT_EQ(5, cluster.connect_timeout().seconds());
+  EXPECT_EQ("1", resources["cluster_3"].version());
+}
+
+// Sources are kept apart per authority and type URL, and resources can be looked up by name.
+TEST_F(FileSnapshotXdsDelegateTest, MultipleSources) {
+  const XdsConfigSourceId other_source_id{"other_cluster", Config::TypeUrl::get().Cluster};
+  Protobuf::RepeatedPtrField<envoy::service::discovery::v3::Resource> added_resources;
+  *added_resources.Add() = makeResource("cluster_1", "1");
+  *added_resources.Add() = makeResource("cluster_2", "1");
+  delegate_->onDeltaConfigUpdated(cds_source_id_, added_resources, {});
+  added_resources.Clear();
+  *added_resources.Add() = makeResource("cluster_3", "1");
+  delegate_->onDeltaConfigUpdated(other_source_id, added_resources, {});
+  flush();
+  createDelegate();
+
+  EXPECT_EQ(2, getResources(cds_source_id_).size());
+  EXPECT_EQ(1, getResources(other_source_id).size());
+  EXPECT_TRUE(
+      getResources(XdsConfigSourceId{"xds_cluster", Config::TypeUrl::get().Listener}).empty());
+
+  const auto named_resources = delegate_->getResources(cds_source_id_, {"cluster_2", "unknown"});
+  ASSERT_EQ(1, named_resources.size());
+  EXPECT_EQ("cluster_2", named_resources[0].name());
+}
+
+// Updates that were not flushed yet are written when the delegate is destroyed.
+TEST_F(FileSnapshotXdsDelegateTest, FlushOnDestruction) {
+  Protobuf::RepeatedPtrField<envoy::service::discovery::v3::Resource> added_resources;
+  *added_resources.Add() = makeResource("cluster_1", "1");
+  delegate_->onDeltaConfigUpdated(cds_source_id_, added_resources, {});
+  createDelegate();
+  EXPECT_EQ(1, getResources(cds_source_id_).size());
+}
+
+// Updates are flushed once the flush interval elapsed.
+TEST_F(FileSnapshotXdsDelegateTest, FlushOnTimer) {
+  envoy::extensions::config::v3alpha::FileSnapshotXdsDelegateConfig config;
+  config.set_filename(filename_);
+  config.mutable_flush_interval()->set_nanos(1000000);
+  delegate_ = std::make_unique<FileSnapshotXdsDelegate>(config, *api_, *dispatcher_);
+
+  Protobuf::RepeatedPtrField<envoy::service::discovery::v3::Resource> added_resources;
+  *added_resources.Add() = makeResource("cluster_1", "1");
+  delegate_->onDeltaConfigUpdated(cds_source_id_, added_resources, {});
+  while (store_.counter("xds_delegate.file_snapshot.flush_success").value() == 0) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    delegate_->waitForFlush();
+  }
+}
+
+// A snapshot file that cannot be parsed, or that was only partially written, is ignored.
+TEST_F(FileSnapshotXdsDelegateTest, InvalidSnapshot) {
+  Protobuf::RepeatedPtrField<envoy::service::discovery::v3::Resource> added_resources;
+  *added_resources.Add() = makeResource("cluster_1", "1");
+  delegate_->onDeltaConfigUpdated(cds_source_id_, added_resources, {});
+  flush();
+  delegate_.reset();
+
+  const std::string contents = TestEnvironment::readFileToStringForTest(filename_);
+  // The completion marker is the last field of the snapshot.
+  TestEnvironment::writeStringToFileForTest(filename_, contents.substr(0, contents.size() - 2),
+                                            true);
+  createDelegate();
+  EXPECT_EQ(1, store_.counter("xds_delegate.file_snapshot.snapshot_load_failed").value());
+  EXPECT_TRUE(getResources(cds_source_id_).empty());
+
+  TestEnvironment::writeStringToFileForTest(filename_, "not a snapshot", true);
+  createDelegate();
+  EXPECT_EQ(2, store_.counter("xds_delegate.file_snapshot.snapshot_load_failed").value());
+  EXPECT_TRUE(getResources(cds_source_id_).empty());
+}
+
+// Snapshots are written to a temporary file which replaces the previous snapshot, so that a
+// partially written file left behind by a crash doesn't affect the last complete snapshot.
+TEST_F(FileSnapshotXdsDelegateTest, SnapshotReplacedAtomically) {
+  Protobuf::RepeatedPtrField<envoy::service::discovery::v3::Resource> added_resources;
+  *added_resources.Add() = makeResource("cluster_1", "1");
+  delegate_->onDeltaConfigUpdated(cds_source_id_, added_resources, {});
+  flush();
+  EXPECT_EQ(1, store_.counter("xds_delegate.file_snapshot.flush_success").value());
+  EXPECT_TRUE(api_->fileSystem().fileExists(filename_));
+  EXPECT_FALSE(api_->fileSystem().fileExists(tmp_filename_));
+  delegate_.reset();
+
+  TestEnvironment::writeStringToFileForTest(tmp_filename_, "partial snapshot", true);
+  createDelegate();
+  EXPECT_EQ(0, store_.counter("xds_delegate.file_snapshot.snapshot_load_failed").value());
+  EXPECT_EQ(1, getResources(cds_source_id_).size());
+
+  // The next flush overwrites the stale temporary file.
+  *added_resources.Add() = makeResource("cluster_2", "1");
+  delegate_->onDeltaConfigUpdated(cds_source_id_, added_resources, {});
+  flush();
+  EXPECT_FALSE(api_->fileSystem().fileExists(tmp_filename_));
+  createDelegate();
+  EXPECT_EQ(2, getResources(cds_source_id_).size());
+}
+
+// Resources that fail to load are counted.
+TEST_F(FileSnapshotXdsDelegateTest, ResourceLoadFailed) {
+  delegate_->onResourceLoadFailed(cds_source_id_, "cluster_1",
+                                  EnvoyException("invalid cluster"));
+  EXPECT_EQ(1, store_.counter("xds_delegate.file_snapshot.resource_load_failed").value());
+}
+
+TEST_F(FileSnapshotXdsDelegateTest, Factory) {
+  const std::string config_str = fmt::format(R"EOF(
+    name: envoy.xds_delegates.file_snapshot
+    typed_config:
+      "@type": type.googleapis.com/envoy.extensions.config.v3alpha.FileSnapshotXdsDelegateConfig
+      filename: {}
+    )EOF",
+                                             filename_);
+  envoy::config::core::v3::TypedExtensionConfig config;
+  TestUtility::loadFromYaml(config_str, config);
+  auto* factory = Registry::FactoryRegistry<Config::XdsResourcesDelegateFactory>::getFactory(
+      "envoy.xds_delegates.file_snapshot");
+  ASSERT_NE(nullptr, factory);
+  EXPECT_NE(nullptr,
+            factory->createXdsResourcesDelegate(config.typed_config(),
+                                                ProtobufMessage::getStrictValidationVisitor(),
+                                                *api_, *dispatcher_));
+}
+
+} // namespace
+} // namespace Envoy
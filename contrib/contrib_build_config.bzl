@@ -48,6 +48,7 @@ CONTRIB_EXTENSIONS = {
 
     "envoy.tls.key_providers.cryptomb":                         "//contrib/cryptomb/private_key_providers/source:config",
     "envoy.tls.key_providers.qat":                              "//contrib/qat/private_key_providers/source:config",
+    "envoy.tls.key_providers.thread_pool":                      "//contrib/thread_pool/private_key_providers/source:config",
 
     #
     # Socket interface extensions
@@ -82,6 +83,7 @@ CONTRIB_EXTENSIONS = {
     # xDS delegates
     #
 
+    "envoy.xds_delegates.file_snapshot":                       "//contrib/config/source:file_snapshot_xds_delegate",
     "envoy.xds_delegates.kv_store":                            "//contrib/config/source:kv_store_xds_delegate",
 
     #
@@ -0,0 +1,388 @@
+#include "contrib/thread_pool/private_key_providers/source/thread_pool_private_key_provider.h"
+
+#include <memory>
+
+#include "envoy/server/options.h"
+#include "envoy/server/transport_socket_config.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/macros.h"
+#include "source/common/config/datasource.h"
+#include "source/common/protobuf/utility.h"
+
+#include "openssl/ec_key.h"
+#include "openssl/evp.h"
+#include "openssl/pem.h"
+#include "openssl/rsa.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+
+ThreadPoolPrivateKeyStats generateThreadPoolPrivateKeyStats(const std::string& prefix,
+                                                            Stats::Scope& scope) {
+  return ThreadPoolPrivateKeyStats{ALL_THREAD_POOL_PRIVATE_KEY_STATS(
+      POOL_COUNTER_PREFIX(scope, prefix), POOL_GAUGE_PREFIX(scope, prefix),
+      POOL_HISTOGRAM_PREFIX(scope, prefix))};
+}
+
+void DispatcherHandle::post(Event::PostCb callback) {
+  absl::MutexLock lock(&mutex_);
+  if (dispatcher_ != nullptr) {
+    dispatcher_->post(std::move(callback));
+  }
+}
+
+void DispatcherHandle::detach() {
+  absl::MutexLock lock(&mutex_);
+  dispatcher_ = nullptr;
+}
+
+PrivateKeyOperationPool::PrivateKeyOperationPool(bssl::UniquePtr<EVP_PKEY> pkey,
+                                                 uint32_t thread_count,
+                                                 Thread::ThreadFactory& thread_factory,
+                                                 TimeSource& time_source,
+                                                 ThreadPoolPrivateKeyStats& stats)
+    : pkey_(std::move(pkey)), time_source_(time_source), stats_(stats) {
+  ASSERT(thread_count > 0);
+  threads_.reserve(thread_count);
+  while (threads_.size() < thread_count) {
+    threads_.push_back(
+        thread_factory.createThread([this]() { worker(); }, Thread::Options{"tls_key_pool"}));
+  }
+}
+
+PrivateKeyOperationPool::~PrivateKeyOperationPool() {
+  {
+    absl::MutexLock lock(&mutex_);
+    terminate_ = true;
+    // The connections of queued operations are gone, as they keep the provider alive.
+    while (!queue_.empty()) {
+      stats_.queue_depth_.sub(queue_.front().operations_.size());
+      queue_.pop();
+    }
+  }
+  for (auto& thread : threads_) {
+    thread->join();
+  }
+}
+
+void PrivateKeyOperationPool::submit(PrivateKeyOperationBatch&& batch) {
+  stats_.queue_depth_.add(batch.operations_.size());
+  absl::MutexLock lock(&mutex_);
+  queue_.push(std::move(batch));
+}
+
+void PrivateKeyOperationPool::worker() {
+  const auto condition = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return !queue_.empty() || terminate_;
+  };
+  while (true) {
+    PrivateKeyOperationBatch batch;
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(&condition));
+      if (terminate_) {
+        return;
+      }
+      batch = std::move(queue_.front());
+      queue_.pop();
+    }
+    stats_.queue_depth_.sub(batch.operations_.size());
+
+    for (const PrivateKeyOperationSharedPtr& operation : batch.operations_) {
+      if (operation->cancelled_) {
+        continue;
+      }
+      operation->started_ = time_source_.monotonicTime();
+      operation->succeeded_ = perform(pkey_.get(), *operation);
+    }
+
+    // The callbacks of the connections are only invoked on their worker thread, where they are
+    // dropped when the connection is closed.
+    batch.dispatcher_->post([operations = std::move(batch.operations_), &stats = stats_,
+                             &time_source = time_source_]() {
+      const MonotonicTime now = time_source.monotonicTime();
+      for (const PrivateKeyOperationSharedPtr& operation : operations) {
+        if (operation->cb_ == nullptr) {
+          continue;
+        }
+        stats.queue_time_us_.recordValue(std::chrono::duration_cast<std::chrono::microseconds>(
+                                             operation->started_ - operation->submitted_)
+                                             .count());
+        stats.operation_time_us_.recordValue(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - operation->submitted_)
+                .count());
+        if (!operation->succeeded_) {
+          stats.failed_operations_.inc();
+        }
+        // The status can't be set beforehand, because the callback asserts if someone else races
+        // to call doHandshake() and the status goes to HandshakeComplete.
+        operation->status_ =
+            operation->succeeded_ ? RequestStatus::Success : RequestStatus::Error;
+        operation->cb_->onPrivateKeyMethodComplete();
+      }
+    });
+  }
+}
+
+bool PrivateKeyOperationPool::perform(EVP_PKEY* pkey, PrivateKeyOperation& operation) {
+  if (operation.type_ == PrivateKeyOperation::Type::Decrypt) {
+    RSA* rsa = EVP_PKEY_get0_RSA(pkey);
+    if (rsa == nullptr) {
+      return false;
+    }
+    operation.output_.resize(RSA_size(rsa));
+    size_t out_len;
+    // BoringSSL removes the padding of the RSA key exchange itself.
+    if (!RSA_decrypt(rsa, &out_len, operation.output_.data(), operation.output_.size(),
+                     operation.input_.data(), operation.input_.size(), RSA_NO_PADDING)) {
+      return false;
+    }
+    operation.output_.resize(out_len);
+    return true;
+  }
+
+  const EVP_MD* md = SSL_get_signature_algorithm_digest(operation.signature_algorithm_);
+  bssl::ScopedEVP_MD_CTX ctx;
+  EVP_PKEY_CTX* pkey_ctx;
+  if (!EVP_DigestSignInit(ctx.get(), &pkey_ctx, md, nullptr, pkey)) {
+    return false;
+  }
+  if (SSL_is_signature_algorithm_rsa_pss(operation.signature_algorithm_) &&
+      (!EVP_PKEY_CTX_set_rsa_padding(pkey_ctx, RSA_PKCS1_PSS_PADDING) ||
+       !EVP_PKEY_CTX_set_rsa_pss_saltlen(pkey_ctx, -1 /* salt length is digest length */))) {
+    return false;
+  }
+  operation.output_.resize(EVP_PKEY_size(pkey));
+  size_t out_len = operation.output_.size();
+  if (!EVP_DigestSign(ctx.get(), operation.output_.data(), &out_len, operation.input_.data(),
+                      operation.input_.size())) {
+    return false;
+  }
+  operation.output_.resize(out_len);
+  return true;
+}
+
+PrivateKeyOperationQueue::PrivateKeyOperationQueue(Event::Dispatcher& dispatcher,
+                                                   PrivateKeyOperationPool& pool,
+                                                   uint32_t max_batch_size,
+                                                   ThreadPoolPrivateKeyStats& stats)
+    : dispatcher_(dispatcher), pool_(pool), max_batch_size_(max_batch_size), stats_(stats),
+      dispatcher_handle_(std::make_shared<DispatcherHandle>(dispatcher)),
+      flush_callback_(dispatcher.createSchedulableCallback([this]() { flush(); })) {
+  pending_.reserve(max_batch_size_);
+}
+
+PrivateKeyOperationQueue::~PrivateKeyOperationQueue() { dispatcher_handle_->detach(); }
+
+void PrivateKeyOperationQueue::add(PrivateKeyOperationSharedPtr operation) {
+  pending_.push_back(std::move(operation));
+  if (pending_.size() >= max_batch_size_) {
+    flush_callback_->cancel();
+    flush();
+  } else if (pending_.size() == 1) {
+    // Gather the operations of the other connections which are handled in this iteration.
+    flush_callback_->scheduleCallbackCurrentIteration();
+  }
+}
+
+void PrivateKeyOperationQueue::flush() {
+  PrivateKeyOperationBatch batch{{}, dispatcher_handle_};
+  batch.operations_.reserve(pending_.size());
+  for (PrivateKeyOperationSharedPtr& operation : pending_) {
+    if (!operation->cancelled_) {
+      batch.operations_.push_back(std::move(operation));
+    }
+  }
+  pending_.clear();
+  if (batch.operations_.empty()) {
+    return;
+  }
+  stats_.batch_size_.recordValue(batch.operations_.size());
+  pool_.submit(std::move(batch));
+}
+
+ThreadPoolPrivateKeyConnection::ThreadPoolPrivateKeyConnection(
+    Ssl::PrivateKeyConnectionCallbacks& cb, PrivateKeyOperationQueue& queue,
+    TimeSource& time_source, ThreadPoolPrivateKeyStats& stats)
+    : cb_(cb), queue_(queue), time_source_(time_source), stats_(stats) {}
+
+ThreadPoolPrivateKeyConnection::~ThreadPoolPrivateKeyConnection() {
+  if (operation_ != nullptr && operation_->status_ == RequestStatus::Retry) {
+    operation_->cb_ = nullptr;
+    operation_->cancelled_ = true;
+    stats_.cancelled_operations_.inc();
+  }
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyConnection::submit(PrivateKeyOperation::Type type,
+                                                                uint16_t signature_algorithm,
+                                                                const uint8_t* in, size_t in_len) {
+  const EVP_PKEY* pkey = queue_.pool().privateKey();
+  if (type == PrivateKeyOperation::Type::Sign) {
+    // Check if the SSL instance has correct data attached to it.
+    if (EVP_PKEY_id(pkey) != SSL_get_signature_algorithm_key_type(signature_algorithm)) {
+      return ssl_private_key_failure;
+    }
+    stats_.sign_operations_.inc();
+  } else {
+    if (EVP_PKEY_id(pkey) != EVP_PKEY_RSA) {
+      return ssl_private_key_failure;
+    }
+    stats_.decrypt_operations_.inc();
+  }
+  operation_ = std::make_shared<PrivateKeyOperation>(type, signature_algorithm, in, in_len, cb_,
+                                                     time_source_.monotonicTime());
+  queue_.add(operation_);
+  return ssl_private_key_retry;
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyConnection::complete(uint8_t* out, size_t* out_len,
+                                                                  size_t max_out) {
+  // Check if the operation is done yet. This can happen if someone calls the top-level SSL
+  // function too early. The status is only set from this thread.
+  if (operation_ == nullptr) {
+    return ssl_private_key_failure;
+  }
+  if (operation_->status_ == RequestStatus::Retry) {
+    return ssl_private_key_retry;
+  }
+  PrivateKeyOperationSharedPtr operation = std::move(operation_);
+  if (operation->status_ != RequestStatus::Success) {
+    ENVOY_LOG(warn, "private key operation failed.");
+    return ssl_private_key_failure;
+  }
+  if (operation->output_.size() > max_out) {
+    return ssl_private_key_failure;
+  }
+  *out_len = operation->output_.size();
+  memcpy(out, operation->output_.data(), *out_len); // NOLINT(safe-memcpy)
+  return ssl_private_key_success;
+}
+
+namespace {
+
+ThreadPoolPrivateKeyConnection* connectionFromSsl(SSL* ssl) {
+  return ssl == nullptr ? nullptr
+                        : static_cast<ThreadPoolPrivateKeyConnection*>(SSL_get_ex_data(
+                              ssl, ThreadPoolPrivateKeyMethodProvider::connectionIndex()));
+}
+
+ssl_private_key_result_t privateKeySign(SSL* ssl, uint8_t*, size_t*, size_t,
+                                        uint16_t signature_algorithm, const uint8_t* in,
+                                        size_t in_len) {
+  ThreadPoolPrivateKeyConnection* connection = connectionFromSsl(ssl);
+  return connection == nullptr ? ssl_private_key_failure
+                               : connection->submit(PrivateKeyOperation::Type::Sign,
+                                                    signature_algorithm, in, in_len);
+}
+
+ssl_private_key_result_t privateKeyDecrypt(SSL* ssl, uint8_t*, size_t*, size_t, const uint8_t* in,
+                                           size_t in_len) {
+  ThreadPoolPrivateKeyConnection* connection = connectionFromSsl(ssl);
+  return connection == nullptr
+             ? ssl_private_key_failure
+             : connection->submit(PrivateKeyOperation::Type::Decrypt, 0, in, in_len);
+}
+
+ssl_private_key_result_t privateKeyComplete(SSL* ssl, uint8_t* out, size_t* out_len,
+                                            size_t max_out) {
+  ThreadPoolPrivateKeyConnection* connection = connectionFromSsl(ssl);
+  return connection == nullptr ? ssl_private_key_failure
+                               : connection->complete(out, out_len, max_out);
+}
+
+int createIndex() {
+  int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+  RELEASE_ASSERT(index >= 0, "Failed to get SSL user data index.");
+  return index;
+}
+
+} // namespace
+
+int ThreadPoolPrivateKeyMethodProvider::connectionIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, createIndex());
+}
+
+ThreadPoolPrivateKeyMethodProvider::ThreadPoolPrivateKeyMethodProvider(
+    const envoy::extensions::private_key_providers::thread_pool::v3alpha::
+        ThreadPoolPrivateKeyMethodConfig& conf,
+    Server::Configuration::TransportSocketFactoryContext& factory_context)
+    : time_source_(factory_context.serverFactoryContext().api().timeSource()),
+      stats_(generateThreadPoolPrivateKeyStats("thread_pool_private_key",
+                                               factory_context.statsScope())) {
+  Api::Api& api = factory_context.serverFactoryContext().api();
+  std::string private_key =
+      THROW_OR_RETURN_VALUE(Config::DataSource::read(conf.private_key(), false, api), std::string);
+
+  bssl::UniquePtr<BIO> bio(
+      BIO_new_mem_buf(const_cast<char*>(private_key.data()), private_key.size()));
+  bssl::UniquePtr<EVP_PKEY> pkey(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
+  if (pkey == nullptr) {
+    throw EnvoyException("Failed to read private key.");
+  }
+
+  // The operations are performed by BoringSSL, so the key is as FIPS compliant as it would be
+  // without the provider.
+  switch (EVP_PKEY_id(pkey.get())) {
+  case EVP_PKEY_RSA: {
+    const unsigned bits = RSA_bits(EVP_PKEY_get0_RSA(pkey.get()));
+    fips_compliant_ = bits == 2048 || bits == 3072 || bits == 4096;
+    break;
+  }
+  case EVP_PKEY_EC: {
+    const int curve =
+        EC_GROUP_get_curve_name(EC_KEY_get0_group(EVP_PKEY_get0_EC_KEY(pkey.get())));
+    fips_compliant_ = curve == NID_X9_62_prime256v1 || curve == NID_secp384r1;
+    break;
+  }
+  default:
+    throw EnvoyException("Not supported key type, only EC and RSA are supported.");
+  }
+
+  method_ = std::make_shared<SSL_PRIVATE_KEY_METHOD>();
+  method_->sign = privateKeySign;
+  method_->decrypt = privateKeyDecrypt;
+  method_->complete = privateKeyComplete;
+
+  const uint32_t concurrency = factory_context.serverFactoryContext().options().concurrency();
+  const uint32_t thread_count =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(conf, thread_count, std::max(concurrency, 1U));
+  const uint32_t max_batch_size = PROTOBUF_GET_WRAPPED_OR_DEFAULT(conf, max_batch_size, 16);
+  ENVOY_LOG(debug, "thread pool private key provider created with {} threads", thread_count);
+  pool_ = std::make_unique<PrivateKeyOperationPool>(std::move(pkey), thread_count,
+                                                    api.threadFactory(), time_source_, stats_);
+
+  tls_ = ThreadLocal::TypedSlot<PrivateKeyOperationQueue>::makeUnique(
+      factory_context.serverFactoryContext().threadLocal());
+  tls_->set([this, max_batch_size](Event::Dispatcher& dispatcher) {
+    return std::make_shared<PrivateKeyOperationQueue>(dispatcher, *pool_, max_batch_size, stats_);
+  });
+}
+
+void ThreadPoolPrivateKeyMethodProvider::registerPrivateKeyMethod(
+    SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb, Event::Dispatcher&) {
+  if (SSL_get_ex_data(ssl, connectionIndex()) != nullptr) {
+    throw EnvoyException("Not registering the thread pool provider twice for same context");
+  }
+  ASSERT(tls_->currentThreadRegistered(), "Current thread needs to be registered.");
+  SSL_set_ex_data(ssl, connectionIndex(),
+                  new ThreadPoolPrivateKeyConnection(cb, *tls_->get(), time_source_, stats_));
+}
+
+void ThreadPoolPrivateKeyMethodProvider::unregisterPrivateKeyMethod(SSL* ssl) {
+  auto* connection =
+      static_cast<ThreadPoolPrivateKeyConnection*>(SSL_get_ex_data(ssl, connectionIndex()));
+  SSL_set_ex_data(ssl, connectionIndex(), nullptr);
+  delete connection;
+}
+
+bool ThreadPoolPrivateKeyMethodProvider::checkFips() { return fips_compliant_; }
+
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
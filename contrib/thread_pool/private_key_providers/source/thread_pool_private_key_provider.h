@@ -0,0 +1,216 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <queue>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/ssl/private_key/private_key.h"
+#include "envoy/ssl/private_key/private_key_config.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread/thread.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/common/common/logger.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "contrib/envoy/extensions/private_key_providers/thread_pool/v3alpha/thread_pool.pb.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+
+#define ALL_THREAD_POOL_PRIVATE_KEY_STATS(COUNTER, GAUGE, HISTOGRAM)                               \
+  COUNTER(cancelled_operations)                                                                    \
+  COUNTER(decrypt_operations)                                                                      \
+  COUNTER(failed_operations)                                                                       \
+  COUNTER(sign_operations)                                                                         \
+  GAUGE(queue_depth, NeverImport)                                                                  \
+  HISTOGRAM(batch_size, Unspecified)                                                               \
+  HISTOGRAM(operation_time_us, Microseconds)                                                       \
+  HISTOGRAM(queue_time_us, Microseconds)
+
+/**
+ * Thread pool private key provider stats struct definition. @see stats_macros.h
+ */
+struct ThreadPoolPrivateKeyStats {
+  ALL_THREAD_POOL_PRIVATE_KEY_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT,
+                                    GENERATE_HISTOGRAM_STRUCT)
+};
+
+ThreadPoolPrivateKeyStats generateThreadPoolPrivateKeyStats(const std::string& prefix,
+                                                            Stats::Scope& scope);
+
+enum class RequestStatus { Retry, Success, Error };
+
+// A private key operation of a connection. The input and the connection's state are only touched
+// by the worker thread of the connection, and the output only by the pool thread which performs
+// the operation until the operation is handed back to the worker thread.
+struct PrivateKeyOperation {
+  enum class Type { Sign, Decrypt };
+
+  PrivateKeyOperation(Type type, uint16_t signature_algorithm, const uint8_t* in, size_t in_len,
+                      Ssl::PrivateKeyConnectionCallbacks& cb, MonotonicTime submitted)
+      : type_(type), signature_algorithm_(signature_algorithm), input_(in, in + in_len), cb_(&cb),
+        submitted_(submitted) {}
+
+  const Type type_;
+  const uint16_t signature_algorithm_;
+  const std::vector<uint8_t> input_;
+
+  // Worker thread only. Null once the connection is gone.
+  Ssl::PrivateKeyConnectionCallbacks* cb_;
+  RequestStatus status_{RequestStatus::Retry};
+  const MonotonicTime submitted_;
+
+  // Tells the pool to skip the operation of a connection which is gone.
+  std::atomic<bool> cancelled_{false};
+
+  // Written by the pool thread.
+  std::vector<uint8_t> output_;
+  bool succeeded_{};
+  MonotonicTime started_;
+};
+
+using PrivateKeyOperationSharedPtr = std::shared_ptr<PrivateKeyOperation>;
+
+// Lets the pool threads post to the dispatcher of a worker thread as long as the worker's queue
+// exists. The queue is destroyed on its worker thread before the dispatcher is.
+class DispatcherHandle {
+public:
+  explicit DispatcherHandle(Event::Dispatcher& dispatcher) : dispatcher_(&dispatcher) {}
+
+  void post(Event::PostCb callback) ABSL_LOCKS_EXCLUDED(mutex_);
+  void detach() ABSL_LOCKS_EXCLUDED(mutex_);
+
+private:
+  absl::Mutex mutex_;
+  Event::Dispatcher* dispatcher_ ABSL_GUARDED_BY(mutex_);
+};
+
+using DispatcherHandleSharedPtr = std::shared_ptr<DispatcherHandle>;
+
+// The operations of a worker thread which are handed to the pool together.
+struct PrivateKeyOperationBatch {
+  std::vector<PrivateKeyOperationSharedPtr> operations_;
+  DispatcherHandleSharedPtr dispatcher_;
+};
+
+// PrivateKeyOperationPool performs the private key operations of all worker threads with a single
+// key on a fixed number of threads. Each batch is performed by one thread, and its results are
+// posted back to its worker thread at once.
+class PrivateKeyOperationPool : public Logger::Loggable<Logger::Id::connection> {
+public:
+  PrivateKeyOperationPool(bssl::UniquePtr<EVP_PKEY> pkey, uint32_t thread_count,
+                          Thread::ThreadFactory& thread_factory, TimeSource& time_source,
+                          ThreadPoolPrivateKeyStats& stats);
+  ~PrivateKeyOperationPool() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  void submit(PrivateKeyOperationBatch&& batch) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  const EVP_PKEY* privateKey() const { return pkey_.get(); }
+
+  // Performs an operation with the given key, on the calling thread.
+  static bool perform(EVP_PKEY* pkey, PrivateKeyOperation& operation);
+
+private:
+  void worker() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  const bssl::UniquePtr<EVP_PKEY> pkey_;
+  TimeSource& time_source_;
+  ThreadPoolPrivateKeyStats& stats_;
+
+  absl::Mutex mutex_;
+  std::queue<PrivateKeyOperationBatch> queue_ ABSL_GUARDED_BY(mutex_);
+  bool terminate_ ABSL_GUARDED_BY(mutex_){};
+
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+// PrivateKeyOperationQueue gathers the operations of the connections of a worker thread during an
+// event loop iteration and hands them to the pool as one batch, which keeps the cost of waking up
+// the pool and the worker thread independent of the number of connections.
+class PrivateKeyOperationQueue : public ThreadLocal::ThreadLocalObject {
+public:
+  PrivateKeyOperationQueue(Event::Dispatcher& dispatcher, PrivateKeyOperationPool& pool,
+                           uint32_t max_batch_size, ThreadPoolPrivateKeyStats& stats);
+  ~PrivateKeyOperationQueue() override;
+
+  void add(PrivateKeyOperationSharedPtr operation);
+
+  Event::Dispatcher& dispatcher() { return dispatcher_; }
+  PrivateKeyOperationPool& pool() { return pool_; }
+
+private:
+  void flush();
+
+  Event::Dispatcher& dispatcher_;
+  PrivateKeyOperationPool& pool_;
+  const uint32_t max_batch_size_;
+  ThreadPoolPrivateKeyStats& stats_;
+  DispatcherHandleSharedPtr dispatcher_handle_;
+  std::vector<PrivateKeyOperationSharedPtr> pending_;
+  Event::SchedulableCallbackPtr flush_callback_;
+};
+
+// ThreadPoolPrivateKeyConnection maintains the data needed by a given SSL connection.
+class ThreadPoolPrivateKeyConnection : public Logger::Loggable<Logger::Id::connection> {
+public:
+  ThreadPoolPrivateKeyConnection(Ssl::PrivateKeyConnectionCallbacks& cb,
+                                 PrivateKeyOperationQueue& queue, TimeSource& time_source,
+                                 ThreadPoolPrivateKeyStats& stats);
+  ~ThreadPoolPrivateKeyConnection();
+
+  ssl_private_key_result_t submit(PrivateKeyOperation::Type type, uint16_t signature_algorithm,
+                                  const uint8_t* in, size_t in_len);
+  ssl_private_key_result_t complete(uint8_t* out, size_t* out_len, size_t max_out);
+
+private:
+  Ssl::PrivateKeyConnectionCallbacks& cb_;
+  PrivateKeyOperationQueue& queue_;
+  TimeSource& time_source_;
+  ThreadPoolPrivateKeyStats& stats_;
+  PrivateKeyOperationSharedPtr operation_;
+};
+
+// ThreadPoolPrivateKeyMethodProvider handles the private key method operations for an SSL socket.
+class ThreadPoolPrivateKeyMethodProvider : public virtual Ssl::PrivateKeyMethodProvider,
+                                           public Logger::Loggable<Logger::Id::connection> {
+public:
+  ThreadPoolPrivateKeyMethodProvider(
+      const envoy::extensions::private_key_providers::thread_pool::v3alpha::
+          ThreadPoolPrivateKeyMethodConfig& config,
+      Server::Configuration::TransportSocketFactoryContext& factory_context);
+
+  // Ssl::PrivateKeyMethodProvider
+  void registerPrivateKeyMethod(SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb,
+                                Event::Dispatcher& dispatcher) override;
+  void unregisterPrivateKeyMethod(SSL* ssl) override;
+  bool checkFips() override;
+  bool isAvailable() override { return true; }
+  Ssl::BoringSslPrivateKeyMethodSharedPtr getBoringSslPrivateKeyMethod() override {
+    return method_;
+  }
+
+  static int connectionIndex();
+
+private:
+  TimeSource& time_source_;
+  ThreadPoolPrivateKeyStats stats_;
+  bool fips_compliant_{};
+  Ssl::BoringSslPrivateKeyMethodSharedPtr method_;
+  // Destroyed before the stats. The queues only hand it the operations of live connections, which
+  // keep the provider alive.
+  std::unique_ptr<PrivateKeyOperationPool> pool_;
+  ThreadLocal::TypedSlotPtr<PrivateKeyOperationQueue> tls_;
+};
+
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
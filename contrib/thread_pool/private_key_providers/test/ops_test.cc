@@ -0,0 +1,266 @@
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "contrib/thread_pool/private_key_providers/source/thread_pool_private_key_provider.h"
+#include "gtest/gtest.h"
+#include "openssl/evp.h"
+#include "openssl/pem.h"
+#include "openssl/rsa.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+namespace {
+
+bssl::UniquePtr<EVP_PKEY> makeKey(const std::string& name) {
+  std::string file = TestEnvironment::readFileToStringForTest(
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/" + name));
+  bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(file.data(), file.size()));
+  bssl::UniquePtr<EVP_PKEY> key(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
+  RELEASE_ASSERT(key != nullptr, "PEM_read_bio_PrivateKey failed.");
+  return key;
+}
+
+// Stops the dispatcher once the expected number of operations completed.
+class TestCallbacks : public Envoy::Ssl::PrivateKeyConnectionCallbacks {
+public:
+  TestCallbacks(Event::Dispatcher& dispatcher, uint32_t& completed, uint32_t expected)
+      : dispatcher_(dispatcher), completed_(completed), expected_(expected) {}
+
+  void onPrivateKeyMethodComplete() override {
+    if (++completed_ == expected_) {
+      dispatcher_.exit();
+    }
+  }
+
+private:
+  Event::Dispatcher& dispatcher_;
+  uint32_t& completed_;
+  const uint32_t expected_;
+};
+
+class ThreadPoolProviderTest : public testing::Test {
+protected:
+  ThreadPoolProviderTest()
+      : api_(Api::createApiForTest(store_)), dispatcher_(api_->allocateDispatcher("test_thread")),
+        stats_(generateThreadPoolPrivateKeyStats("thread_pool_private_key", *store_.rootScope())) {}
+
+  void initialize(const std::string& key_name, uint32_t max_batch_size = 16) {
+    pkey_ = makeKey(key_name);
+    pool_ = std::make_unique<PrivateKeyOperationPool>(makeKey(key_name), 2, api_->threadFactory(),
+                                                      api_->timeSource(), stats_);
+    queue_ = std::make_unique<PrivateKeyOperationQueue>(*dispatcher_, *pool_, max_batch_size,
+                                                        stats_);
+  }
+
+  std::unique_ptr<ThreadPoolPrivateKeyConnection>
+  makeConnection(Ssl::PrivateKeyConnectionCallbacks& cb) {
+    return std::make_unique<ThreadPoolPrivateKeyConnection>(cb, *queue_, api_->timeSource(),
+                                                            stats_);
+  }
+
+  bool verify(uint16_t signature_algorithm) {
+    bssl::ScopedEVP_MD_CTX ctx;
+    EVP_PKEY_CTX* pkey_ctx;
+    if (!EVP_DigestVerifyInit(ctx.get(), &pkey_ctx,
+                              SSL_get_signature_algorithm_digest(signature_algorithm), nullptr,
+                              pkey_.get())) {
+      return false;
+    }
+    if (SSL_is_signature_algorithm_rsa_pss(signature_algorithm) &&
+        (!EVP_PKEY_CTX_set_rsa_padding(pkey_ctx, RSA_PKCS1_PSS_PADDING) ||
+         !EVP_PKEY_CTX_set_rsa_pss_saltlen(pkey_ctx, -1))) {
+      return false;
+    }
+    return EVP_DigestVerify(ctx.get(), out_, out_len_, in_, in_len_) == 1;
+  }
+
+  Stats::TestUtil::TestStore store_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  ThreadPoolPrivateKeyStats stats_;
+  bssl::UniquePtr<EVP_PKEY> pkey_;
+  std::unique_ptr<PrivateKeyOperationPool> pool_;
+  std::unique_ptr<PrivateKeyOperationQueue> queue_;
+  uint32_t completed_{};
+
+  // A size for signing operation input chosen for tests.
+  static constexpr size_t in_len_ = 32;
+  // Test input bytes for signing operations chosen for tests.
+  static constexpr uint8_t in_[in_len_] = {0x7f};
+
+  // Maximum size of out_ in all tests cases.
+  static constexpr size_t max_out_len_ = 512;
+  uint8_t out_[max_out_len_] = {0};
+
+  // Size of output in out_ from an operation.
+  size_t out_len_ = 0;
+
+  const std::string batch_size_histogram_name_ = "thread_pool_private_key.batch_size";
+};
+
+TEST_F(ThreadPoolProviderTest, TestRsaPssSigning) {
+  initialize("san_dns_key.pem");
+  TestCallbacks cb(*dispatcher_, completed_, 1);
+  auto connection = makeConnection(cb);
+
+  EXPECT_EQ(ssl_private_key_retry,
+            connection->submit(PrivateKeyOperation::Type::Sign, SSL_SIGN_RSA_PSS_RSAE_SHA256, in_,
+                               in_len_));
+  // The operation is not done before the worker thread picks up its result.
+  EXPECT_EQ(ssl_private_key_retry, connection->complete(out_, &out_len_, max_out_len_));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(ssl_private_key_success, connection->complete(out_, &out_len_, max_out_len_));
+  EXPECT_EQ(256, out_len_);
+  EXPECT_TRUE(verify(SSL_SIGN_RSA_PSS_RSAE_SHA256));
+  EXPECT_EQ(1, store_.counterFromString("thread_pool_private_key.sign_operations").value());
+  EXPECT_EQ(0, store_.gaugeFromString("thread_pool_private_key.queue_depth",
+                                      Stats::Gauge::ImportMode::NeverImport)
+                   .value());
+}
+
+TEST_F(ThreadPoolProviderTest, TestRsaPkcs1Signing) {
+  initialize("san_dns_key.pem");
+  TestCallbacks cb(*dispatcher_, completed_, 1);
+  auto connection = makeConnection(cb);
+
+  EXPECT_EQ(ssl_private_key_retry,
+            connection->submit(PrivateKeyOperation::Type::Sign, SSL_SIGN_RSA_PKCS1_SHA256, in_,
+                               in_len_));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(ssl_private_key_success, connection->complete(out_, &out_len_, max_out_len_));
+  EXPECT_TRUE(verify(SSL_SIGN_RSA_PKCS1_SHA256));
+}
+
+TEST_F(ThreadPoolProviderTest, TestEcdsaSigning) {
+  initialize("selfsigned_ecdsa_p256_key.pem");
+  TestCallbacks cb(*dispatcher_, completed_, 1);
+  auto connection = makeConnection(cb);
+
+  EXPECT_EQ(ssl_private_key_retry,
+            connection->submit(PrivateKeyOperation::Type::Sign, SSL_SIGN_ECDSA_SECP256R1_SHA256,
+                               in_, in_len_));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(ssl_private_key_success, connection->complete(out_, &out_len_, max_out_len_));
+  EXPECT_TRUE(verify(SSL_SIGN_ECDSA_SECP256R1_SHA256));
+}
+
+TEST_F(ThreadPoolProviderTest, TestRsaDecrypt) {
+  initialize("san_dns_key.pem");
+  TestCallbacks cb(*dispatcher_, completed_, 1);
+  auto connection = makeConnection(cb);
+
+  // The provider does not remove any padding, so the plaintext is a full sized value.
+  RSA* rsa = EVP_PKEY_get0_RSA(pkey_.get());
+  std::vector<uint8_t> plaintext(RSA_size(rsa), 0x7f);
+  plaintext[0] = 0;
+  std::vector<uint8_t> ciphertext(RSA_size(rsa));
+  size_t ciphertext_len;
+  ASSERT_EQ(1, RSA_encrypt(rsa, &ciphertext_len, ciphertext.data(), ciphertext.size(),
+                           plaintext.data(), plaintext.size(), RSA_NO_PADDING));
+
+  EXPECT_EQ(ssl_private_key_retry, connection->submit(PrivateKeyOperation::Type::Decrypt, 0,
+                                                      ciphertext.data(), ciphertext_len));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(ssl_private_key_success, connection->complete(out_, &out_len_, max_out_len_));
+  EXPECT_EQ(std::vector<uint8_t>(out_, out_ + out_len_), plaintext);
+  EXPECT_EQ(1, store_.counterFromString("thread_pool_private_key.decrypt_operations").value());
+}
+
+TEST_F(ThreadPoolProviderTest, TestErrors) {
+  initialize("selfsigned_ecdsa_p256_key.pem");
+  TestCallbacks cb(*dispatcher_, completed_, 1);
+  auto connection = makeConnection(cb);
+
+  // Nothing was submitted.
+  EXPECT_EQ(ssl_private_key_failure, connection->complete(out_, &out_len_, max_out_len_));
+  // The key does not match the signature algorithm.
+  EXPECT_EQ(ssl_private_key_failure,
+            connection->submit(PrivateKeyOperation::Type::Sign, SSL_SIGN_RSA_PSS_RSAE_SHA256, in_,
+                               in_len_));
+  // Decryption needs an RSA key.
+  EXPECT_EQ(ssl_private_key_failure,
+            connection->submit(PrivateKeyOperation::Type::Decrypt, 0, in_, in_len_));
+
+  // The output buffer is too small for the signature.
+  EXPECT_EQ(ssl_private_key_retry,
+            connection->submit(PrivateKeyOperation::Type::Sign, SSL_SIGN_ECDSA_SECP256R1_SHA256,
+                               in_, in_len_));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(ssl_private_key_failure, connection->complete(out_, &out_len_, 8));
+}
+
+TEST_F(ThreadPoolProviderTest, TestFailedOperation) {
+  initialize("san_dns_key.pem");
+  TestCallbacks cb(*dispatcher_, completed_, 1);
+  auto connection = makeConnection(cb);
+
+  // The ciphertext is larger than the modulus.
+  std::vector<uint8_t> ciphertext(256, 0xff);
+  EXPECT_EQ(ssl_private_key_retry, connection->submit(PrivateKeyOperation::Type::Decrypt, 0,
+                                                      ciphertext.data(), ciphertext.size()));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(ssl_private_key_failure, connection->complete(out_, &out_len_, max_out_len_));
+  EXPECT_EQ(1, store_.counterFromString("thread_pool_private_key.failed_operations").value());
+}
+
+// The operations submitted in the same event loop iteration are handed to the pool together.
+TEST_F(ThreadPoolProviderTest, TestBatching) {
+  initialize("selfsigned_ecdsa_p256_key.pem", 3);
+  const uint32_t connection_count = 5;
+  TestCallbacks cb(*dispatcher_, completed_, connection_count);
+  std::vector<std::unique_ptr<ThreadPoolPrivateKeyConnection>> connections;
+  for (uint32_t i = 0; i < connection_count; ++i) {
+    connections.push_back(makeConnection(cb));
+    EXPECT_EQ(ssl_private_key_retry,
+              connections.back()->submit(PrivateKeyOperation::Type::Sign,
+                                         SSL_SIGN_ECDSA_SECP256R1_SHA256, in_, in_len_));
+  }
+  // The first batch is full and handed over right away.
+  EXPECT_EQ(std::vector<uint64_t>({3}), store_.histogramValues(batch_size_histogram_name_, true));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(std::vector<uint64_t>({2}), store_.histogramValues(batch_size_histogram_name_, true));
+  for (auto& connection : connections) {
+    EXPECT_EQ(ssl_private_key_success, connection->complete(out_, &out_len_, max_out_len_));
+    EXPECT_TRUE(verify(SSL_SIGN_ECDSA_SECP256R1_SHA256));
+  }
+}
+
+// The operations of connections which are closed before they are handed to the pool are dropped.
+TEST_F(ThreadPoolProviderTest, TestCancelledOperation) {
+  initialize("selfsigned_ecdsa_p256_key.pem");
+  TestCallbacks cancelled_cb(*dispatcher_, completed_, 0);
+  TestCallbacks cb(*dispatcher_, completed_, 1);
+  auto cancelled = makeConnection(cancelled_cb);
+  auto connection = makeConnection(cb);
+
+  EXPECT_EQ(ssl_private_key_retry,
+            cancelled->submit(PrivateKeyOperation::Type::Sign, SSL_SIGN_ECDSA_SECP256R1_SHA256,
+                              in_, in_len_));
+  EXPECT_EQ(ssl_private_key_retry,
+            connection->submit(PrivateKeyOperation::Type::Sign, SSL_SIGN_ECDSA_SECP256R1_SHA256,
+                               in_, in_len_));
+  cancelled.reset();
+  EXPECT_EQ(1, store_.counterFromString("thread_pool_private_key.cancelled_operations").value());
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(1, completed_);
+  EXPECT_EQ(std::vector<uint64_t>({1}), store_.histogramValues(batch_size_histogram_name_, true));
+  EXPECT_EQ(ssl_private_key_success, connection->complete(out_, &out_len_, max_out_len_));
+}
+
+} // namespace
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
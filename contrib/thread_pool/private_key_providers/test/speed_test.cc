@@ -0,0 +1,143 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "source/common/common/assert.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "contrib/thread_pool/private_key_providers/source/thread_pool_private_key_provider.h"
+#include "openssl/bn.h"
+#include "openssl/evp.h"
+#include "openssl/rsa.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+
+bssl::UniquePtr<EVP_PKEY> makeRsaKey(int bits) {
+  bssl::UniquePtr<RSA> rsa(RSA_new());
+  bssl::UniquePtr<BIGNUM> e(BN_new());
+  RELEASE_ASSERT(BN_set_word(e.get(), RSA_F4), "BN_set_word failed.");
+  RELEASE_ASSERT(RSA_generate_key_ex(rsa.get(), bits, e.get(), nullptr),
+                 "RSA_generate_key_ex failed.");
+  bssl::UniquePtr<EVP_PKEY> key(EVP_PKEY_new());
+  RELEASE_ASSERT(EVP_PKEY_assign_RSA(key.get(), rsa.release()), "EVP_PKEY_assign_RSA failed.");
+  return key;
+}
+
+constexpr uint8_t Digest[32] = {0x7f};
+
+// Stops the dispatcher once all operations of an iteration completed.
+class BenchmarkCallbacks : public Ssl::PrivateKeyConnectionCallbacks {
+public:
+  BenchmarkCallbacks(Event::Dispatcher& dispatcher, uint32_t& pending)
+      : dispatcher_(dispatcher), pending_(pending) {}
+
+  void onPrivateKeyMethodComplete() override {
+    if (--pending_ == 0) {
+      dispatcher_.exit();
+    }
+  }
+
+private:
+  Event::Dispatcher& dispatcher_;
+  uint32_t& pending_;
+};
+
+// Signs on the calling thread, which is what a worker thread does for its handshakes without a
+// private key provider. The whole time is spent on the worker thread.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_RSA_Signing_Inline(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("worker");
+  bssl::UniquePtr<EVP_PKEY> pkey = makeRsaKey(state.range(0));
+  uint32_t pending = 0;
+  BenchmarkCallbacks cb(*dispatcher, pending);
+  std::chrono::nanoseconds worker_time{};
+  for (auto _ : state) { // NOLINT
+    const auto start = std::chrono::steady_clock::now();
+    PrivateKeyOperation operation(PrivateKeyOperation::Type::Sign, SSL_SIGN_RSA_PSS_RSAE_SHA256,
+                                  Digest, sizeof(Digest), cb, MonotonicTime());
+    RELEASE_ASSERT(PrivateKeyOperationPool::perform(pkey.get(), operation), "");
+    worker_time += std::chrono::steady_clock::now() - start;
+  }
+  state.counters["Requests"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+  state.counters["WorkerUsPerRequest"] =
+      std::chrono::duration<double, std::micro>(worker_time).count() / state.iterations();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RSA_Signing_Inline)->Arg(2048)->Arg(3072)->Unit(::benchmark::kMicrosecond);
+
+// Signs the operations of a number of concurrent handshakes of a worker thread on the pool. The
+// worker thread only spends the time it takes to hand the operations over and pick up their
+// results, and is otherwise free to serve other connections.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_RSA_Signing_ThreadPool(benchmark::State& state) {
+  Stats::IsolatedStoreImpl store;
+  Api::ApiPtr api = Api::createApiForTest(store);
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("worker");
+  ThreadPoolPrivateKeyStats stats =
+      generateThreadPoolPrivateKeyStats("thread_pool_private_key", *store.rootScope());
+  const uint32_t connection_count = state.range(1);
+  const uint32_t thread_count = state.range(2);
+  PrivateKeyOperationPool pool(makeRsaKey(state.range(0)), thread_count, api->threadFactory(),
+                               api->timeSource(), stats);
+  // Spread the operations of an iteration over all threads of the pool.
+  PrivateKeyOperationQueue queue(*dispatcher, pool,
+                                 std::max(connection_count / thread_count, 1U), stats);
+
+  uint32_t pending = 0;
+  BenchmarkCallbacks cb(*dispatcher, pending);
+  std::vector<std::unique_ptr<ThreadPoolPrivateKeyConnection>> connections;
+  uint8_t out[512];
+  size_t out_len;
+  std::chrono::nanoseconds worker_time{};
+  for (auto _ : state) { // NOLINT
+    connections.clear();
+    pending = connection_count;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < connection_count; ++i) {
+      connections.push_back(
+          std::make_unique<ThreadPoolPrivateKeyConnection>(cb, queue, api->timeSource(), stats));
+      connections.back()->submit(PrivateKeyOperation::Type::Sign, SSL_SIGN_RSA_PSS_RSAE_SHA256,
+                                 Digest, sizeof(Digest));
+    }
+    worker_time += std::chrono::steady_clock::now() - start;
+
+    // The time the worker thread waits for the pool is not spent on the worker thread.
+    dispatcher->run(Event::Dispatcher::RunType::Block);
+
+    start = std::chrono::steady_clock::now();
+    for (auto& connection : connections) {
+      RELEASE_ASSERT(connection->complete(out, &out_len, sizeof(out)) == ssl_private_key_success,
+                     "");
+    }
+    worker_time += std::chrono::steady_clock::now() - start;
+  }
+  const uint64_t requests = state.iterations() * connection_count;
+  state.counters["Requests"] = benchmark::Counter(requests, benchmark::Counter::kIsRate);
+  state.counters["WorkerUsPerRequest"] =
+      std::chrono::duration<double, std::micro>(worker_time).count() / requests;
+  state.SetItemsProcessed(requests);
+}
+// Key size, operations in flight per worker thread and pool threads.
+BENCHMARK(BM_RSA_Signing_ThreadPool)
+    ->Args({2048, 1, 1})
+    ->Args({2048, 16, 1})
+    ->Args({2048, 16, 4})
+    ->Args({3072, 16, 4})
+    ->Unit(::benchmark::kMicrosecond);
+
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
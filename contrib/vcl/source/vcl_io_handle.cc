@@ -328,6 +328,24 @@ Api::IoCallUint64Result VclIoHandle::sendmsg(const Buffer::RawSlice* slices, uin
   return vclCallResultToIoCallResult(result);
 }
 
+Api::IoCallUint64Result
+VclIoHandle::sendmmsg(const Buffer::RawSlice* messages, uint64_t num_messages, int flags,
+                      const Envoy::Network::Address::Instance& peer_address) {
+  // VCL has no sendmmsg semantics- Send the messages one at a time.
+  uint64_t num_sent = 0;
+  for (; num_sent < num_messages; ++num_sent) {
+    Api::IoCallUint64Result result =
+        sendmsg(&messages[num_sent], 1, flags, nullptr, peer_address);
+    if (!result.ok()) {
+      if (num_sent == 0) {
+        return result;
+      }
+      break;
+    }
+  }
+  return {num_sent, Api::IoError::none()};
+}
+
 Api::IoCallUint64Result VclIoHandle::recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
                                              uint32_t self_port, const UdpSaveCmsgConfig&,
                                              RecvMsgOutput& output) {
@@ -42,6 +42,9 @@ public:
   Api::IoCallUint64Result sendmsg(const Buffer::RawSlice* slices, uint64_t num_slice, int flags,
                                   const Envoy::Network::Address::Ip* self_ip,
                                   const Envoy::Network::Address::Instance& peer_address) override;
+  Api::IoCallUint64Result sendmmsg(const Buffer::RawSlice* messages, uint64_t num_messages,
+                                   int flags,
+                                   const Envoy::Network::Address::Instance& peer_address) override;
   Api::IoCallUint64Result recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
                                   uint32_t self_port, const UdpSaveCmsgConfig& save_cmsg_config,
                                   RecvMsgOutput& output) override;
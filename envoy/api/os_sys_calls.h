@@ -105,6 +105,12 @@ public:
   virtual SysCallIntResult recvmmsg(os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen,
                                     int flags, struct timespec* timeout) PURE;
 
+  /**
+   * @see sendmmsg (man 2 sendmmsg)
+   */
+  virtual SysCallIntResult sendmmsg(os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                    int flags) PURE;
+
   /**
    * return true if the OS supports recvmmsg() and sendmmsg().
    */
@@ -219,6 +225,11 @@ public:
    */
   virtual SysCallIntResult unlink(const char* pathname) const PURE;
 
+  /**
+   * @see man 2 rename
+   */
+  virtual SysCallIntResult rename(const char* oldpath, const char* newpath) const PURE;
+
   /**
    * @see man 2 unlink
    */
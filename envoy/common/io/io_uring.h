@@ -29,7 +29,11 @@ public:
     Shutdown = 0x40,
   };
 
-  Request(RequestType type, IoUringSocket& socket) : type_(type), socket_(socket) {}
+  Request(RequestType type, IoUringSocket& socket) : type_(type), socket_(&socket) {}
+  /**
+   * Constructs a request which doesn't belong to a socket, e.g. a file operation.
+   */
+  explicit Request(RequestType type) : type_(type) {}
   virtual ~Request() = default;
 
   /**
@@ -38,13 +42,14 @@ public:
   RequestType type() const { return type_; }
 
   /**
-   * Returns the io_uring socket the request belongs to.
+   * Returns the io_uring socket the request belongs to. Must not be called for a request which
+   * doesn't belong to a socket.
    */
-  IoUringSocket& socket() const { return socket_; }
+  IoUringSocket& socket() const { return *socket_; }
 
 private:
   RequestType type_;
-  IoUringSocket& socket_;
+  IoUringSocket* socket_{};
 };
 
 /**
@@ -93,6 +98,13 @@ public:
    */
   virtual void forEveryCompletion(const CompletionCb& completion_cb) PURE;
 
+  /**
+   * Blocks until there is at least one entry in the completion queue, without consuming it, using
+   * `io_uring_wait_cqe()`. The entries are then consumed with forEveryCompletion().
+   * Returns IoUringResult::Ok once there is an entry and IoUringResult::Failed otherwise.
+   */
+  virtual IoUringResult waitForCompletion() PURE;
+
   /**
    * Prepares an accept system call and puts it into the submission queue.
    * Returns IoUringResult::Failed in case the submission queue is full already
@@ -126,6 +138,27 @@ public:
   virtual IoUringResult prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                                       off_t offset, Request* user_data) PURE;
 
+  /**
+   * Prepares a read system call into a single buffer and puts it into the submission queue.
+   * @param fd is the file descriptor to read from, or the index of a file registered with
+   * registerFiles() if fixed_file is true.
+   * @param buf_index is the index of the buffer registered with registerBuffers() which buf is
+   * in, or -1 if buf is not in a registered buffer.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareRead(os_fd_t fd, bool fixed_file, void* buf, unsigned nbytes,
+                                    off_t offset, int buf_index, Request* user_data) PURE;
+
+  /**
+   * Prepares a write system call from a single buffer and puts it into the submission queue.
+   * The parameters are the same as for prepareRead().
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareWrite(os_fd_t fd, bool fixed_file, const void* buf, unsigned nbytes,
+                                     off_t offset, int buf_index, Request* user_data) PURE;
+
   /**
    * Prepares a close system call and puts it into the submission queue.
    * Returns IoUringResult::Failed in case the submission queue is full already
@@ -157,6 +190,29 @@ public:
    */
   virtual IoUringResult submit() PURE;
 
+  /**
+   * Registers an empty table of files with the ring, so that files which are placed in it with
+   * updateRegisteredFile() can be used without the kernel looking up their file descriptors on
+   * every request.
+   * Returns IoUringResult::Failed if the kernel doesn't support it.
+   */
+  virtual IoUringResult registerFiles(unsigned count) PURE;
+
+  /**
+   * Places a file in the table of registered files, or removes the file at an index if fd is -1.
+   * A registered file holds a reference to the file until it is removed from the table.
+   * Returns IoUringResult::Failed if the update failed.
+   */
+  virtual IoUringResult updateRegisteredFile(unsigned index, os_fd_t fd) PURE;
+
+  /**
+   * Registers buffers with the ring, so that they are not mapped into the kernel on every request.
+   * The buffers must outlive the ring.
+   * Returns IoUringResult::Failed if the buffers couldn't be registered, e.g. because they exceed
+   * the locked memory limit.
+   */
+  virtual IoUringResult registerBuffers(const struct iovec* iovecs, unsigned count) PURE;
+
   /**
    * Inject a request completion into the io_uring. Those completions will be iterated
    * when calling the `forEveryCompletion`. This is used to inject an emulated iouring
@@ -87,6 +87,34 @@ public:
    *         the route config name for a envoy.config.route.v3.RouteConfiguration message.
    */
   virtual std::string resourceName(const Protobuf::Message& resource) PURE;
+
+  /**
+   * @return bool whether decodeResourceConcurrently() and resourceName() may be invoked from
+   *         threads other than the main thread.
+   */
+  virtual bool supportsConcurrentDecoding() const { return false; }
+
+  /**
+   * Variant of decodeResource() that is safe to invoke concurrently from threads other than the
+   * main thread. Only validation that does not depend on the server's validation visitor (proto
+   * constraints and duration bounds) is performed; validateDecodedResource() must subsequently be
+   * invoked on the main thread to complete the validation. Only called if
+   * supportsConcurrentDecoding() returns true.
+   * @param resource some opaque resource (ProtobufWkt::Any).
+   * @return ProtobufTypes::MessagePtr decoded protobuf message in the opaque resource.
+   * @throw EnvoyException if the resource does not satisfy its type constraints.
+   */
+  virtual ProtobufTypes::MessagePtr decodeResourceConcurrently(const ProtobufWkt::Any& resource) {
+    return decodeResource(resource);
+  }
+
+  /**
+   * Completes the validation of a resource returned by decodeResourceConcurrently(), e.g. checking
+   * for unknown and deprecated fields. Must be invoked on the main thread.
+   * @param resource a protobuf message returned by decodeResourceConcurrently().
+   * @throw EnvoyException if the resource is rejected by the validation visitor.
+   */
+  virtual void validateDecodedResource(const Protobuf::Message&) {}
 };
 
 using OpaqueResourceDecoderSharedPtr = std::shared_ptr<OpaqueResourceDecoder>;
@@ -119,7 +119,8 @@ public:
   virtual std::shared_ptr<GrpcMux>
   create(std::unique_ptr<Grpc::RawAsyncClient>&& async_client,
          std::unique_ptr<Grpc::RawAsyncClient>&& async_failover_client,
-         Event::Dispatcher& dispatcher, Random::RandomGenerator& random, Stats::Scope& scope,
+         Event::Dispatcher& dispatcher, Api::Api& api, Random::RandomGenerator& random,
+         Stats::Scope& scope,
          const envoy::config::core::v3::ApiConfigSource& ads_config,
          const LocalInfo::LocalInfo& local_info,
          std::unique_ptr<CustomConfigValidators>&& config_validators,
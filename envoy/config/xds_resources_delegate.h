@@ -33,7 +33,8 @@ public:
 
 /**
  * An interface for hooking into xDS resource fetch and update events.
- * Currently, this interface only supports the SotW (state-of-the-world) xDS protocol.
+ * Both the SotW (state-of-the-world) and the delta xDS protocols report their updates to the
+ * delegate; the former through onConfigUpdated() and the latter through onDeltaConfigUpdated().
  *
  * Instances of this interface get invoked on the main Envoy thread. Thus, it is important for
  * implementations of this interface to not execute any blocking operations on the same thread.
@@ -72,6 +73,23 @@ public:
   virtual void onConfigUpdated(const XdsSourceId& source_id,
                                const std::vector<DecodedResourceRef>& resources) PURE;
 
+  /**
+   * Invoked when delta xDS configuration updates have been received from an xDS authority, have
+   * been applied on the Envoy instance, and are about to be ACK'ed. Unlike onConfigUpdated(), the
+   * update only carries the resources that changed; the resources not mentioned in it are
+   * unchanged.
+   *
+   * @param source_id The xDS source for the updated resources.
+   * @param added_resources The resources added or updated by the DeltaDiscoveryResponse, with their
+   *        per-resource versions. Entries without a resource (e.g. heartbeats) may be present.
+   * @param removed_resources The names of the resources removed by the DeltaDiscoveryResponse.
+   */
+  virtual void
+  onDeltaConfigUpdated(const XdsSourceId& /*source_id*/,
+                       const Protobuf::RepeatedPtrField<envoy::service::discovery::v3::Resource>&
+                       /*added_resources*/,
+                       const Protobuf::RepeatedPtrField<std::string>& /*removed_resources*/) {}
+
   /**
    * Invoked when loading a resource obtained from the getResources() call resulted in a failure.
    * This would typically happen when there is a parsing or validation error on the xDS resource
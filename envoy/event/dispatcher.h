@@ -176,6 +176,13 @@ public:
    */
   virtual MonotonicTime approximateMonotonicTime() const PURE;
 
+  /**
+   * Returns the time at which the current iteration of the event loop finished polling and started
+   * processing events. Unlike approximateMonotonicTime(), it is not changed by
+   * updateApproximateMonotonicTime() during the iteration.
+   */
+  virtual MonotonicTime iterationStartTime() const PURE;
+
   /**
    * Initializes stats for this dispatcher. Note that this can't generally be done at construction
    * time, since the main and worker thread dispatchers are constructed before
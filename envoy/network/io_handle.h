@@ -129,6 +129,20 @@ public:
                                           int flags, const Address::Ip* self_ip,
                                           const Address::Instance& peer_address) PURE;
 
+  /**
+   * Send several messages to the address, in as few system calls as the platform allows.
+   * @param messages points to the messages to be sent, one slice per message.
+   * @param num_messages indicates number of messages |messages| contains.
+   * @param flags flags to pass to the underlying sendmmsg or sendmsg function.
+   * @param peer_address is the destination address.
+   * @return a Api::IoCallUint64Result with err_ = an Api::IoError instance or
+   * err_ = nullptr and rc_ = the number of messages sent for success, which may be less than
+   * num_messages.
+   */
+  virtual Api::IoCallUint64Result sendmmsg(const Buffer::RawSlice* messages,
+                                           uint64_t num_messages, int flags,
+                                           const Address::Instance& peer_address) PURE;
+
   struct RecvMsgPerPacketInfo {
     // The destination address from transport header.
     Address::InstanceConstSharedPtr local_address_;
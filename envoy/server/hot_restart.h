@@ -4,7 +4,9 @@
 #include <string>
 
 #include "envoy/common/pure.h"
+#include "envoy/common/time.h"
 #include "envoy/event/dispatcher.h"
+#include "envoy/ssl/context_config.h"
 #include "envoy/stats/allocator.h"
 #include "envoy/stats/store.h"
 #include "envoy/thread/thread.h"
@@ -31,6 +33,14 @@ public:
     bool enable_reuse_port_default_;
   };
 
+  struct TlsSessionStateFromParent {
+    // The session ticket keys shared by the parent's TLS contexts, newest first, with the times
+    // they were created.
+    std::vector<std::pair<Ssl::ServerContextConfig::SessionTicketKey, SystemTime>> ticket_keys_;
+    // The sessions in the parent's shared TLS session cache, serialized by SSL_SESSION_to_bytes().
+    std::vector<std::string> sessions_;
+  };
+
   virtual ~HotRestart() = default;
 
   /**
@@ -103,6 +113,14 @@ public:
    */
   virtual ServerStatsFromParent mergeParentStatsIfAny(Stats::StoreRoot& stats_store) PURE;
 
+  /**
+   * Retrieve the session cache and session ticket keys shared by the TLS contexts of our parent
+   * process, so that clients of the parent can resume their sessions with this process.
+   * @return the parent's state, or absl::nullopt if there is no parent or it doesn't support
+   *         handing over its TLS sessions.
+   */
+  virtual absl::optional<TlsSessionStateFromParent> getParentTlsSessionState() PURE;
+
   /**
    * Shutdown the half of our hot restarter that acts as a parent.
    */
@@ -101,6 +101,12 @@ public:
    */
   virtual bool autoSniSanMatch() const PURE;
 
+  /**
+   * @return the maximum number of cached certificate chain verification results, or 0 if the
+   * results are not cached.
+   */
+  virtual uint32_t verificationCacheSize() const PURE;
+
   // SECURITY NOTE
   //
   // When adding or changing this interface, it is likely that a change is needed to
@@ -173,6 +173,18 @@ public:
     MustStaple,
   };
 
+  struct SharedSessionResumptionConfig {
+    bool operator==(const SharedSessionResumptionConfig& other) const {
+      return max_cached_sessions_ == other.max_cached_sessions_ &&
+             ticket_key_rotation_interval_ == other.ticket_key_rotation_interval_ &&
+             ticket_key_overlap_ == other.ticket_key_overlap_;
+    }
+
+    uint32_t max_cached_sessions_;
+    std::chrono::milliseconds ticket_key_rotation_interval_;
+    std::chrono::milliseconds ticket_key_overlap_;
+  };
+
   /**
    * @return True if client certificate is required, false otherwise.
    */
@@ -207,6 +219,12 @@ public:
    */
   virtual bool disableStatefulSessionResumption() const PURE;
 
+  /**
+   * @return the settings of the session cache and session ticket keys shared by all server
+   * contexts of the process, or absl::nullopt if the context doesn't use them.
+   */
+  virtual const absl::optional<SharedSessionResumptionConfig>& sharedSessionResumption() const PURE;
+
   /**
    * @return True if we allow full scan certificates when there is no cert matching SNI during
    * downstream TLS handshake, false otherwise.
@@ -333,6 +333,15 @@ public:
    */
   virtual ClusterInfoMaps clusters() const PURE;
 
+  /**
+   * @param cluster_name the name of the cluster.
+   * @return ClusterConstOptRef the active cluster with the given name, if any. Unlike clusters(),
+   *         this doesn't copy the maps of all clusters.
+   *
+   * NOTE: This method is only thread safe on the main thread. It should not be called elsewhere.
+   */
+  virtual ClusterConstOptRef getActiveCluster(const std::string& cluster_name) const PURE;
+
   using ClusterSet = absl::flat_hash_set<std::string>;
 
   /**
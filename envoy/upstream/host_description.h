@@ -337,6 +337,13 @@ public:
    * return true if all matches support ALPN, false otherwise.
    */
   virtual bool allMatchesSupportAlpn() const PURE;
+
+  /**
+   * @return a hash of the transport socket configs the matcher selects from, and of their match
+   * criteria. Matchers with the same hash resolve hosts to identically configured transport
+   * sockets.
+   */
+  virtual uint64_t configHash() const PURE;
 };
 
 using TransportSocketMatcherPtr = std::unique_ptr<TransportSocketMatcher>;
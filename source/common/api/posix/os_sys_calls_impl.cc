@@ -95,6 +95,20 @@ SysCallIntResult OsSysCallsImpl::recvmmsg(os_fd_t sockfd, struct mmsghdr* msgvec
 #endif
 }
 
+SysCallIntResult OsSysCallsImpl::sendmmsg(os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                          int flags) {
+#if ENVOY_MMSG_MORE
+  const int rc = ::sendmmsg(sockfd, msgvec, vlen, flags);
+  return {rc, rc != -1 ? 0 : errno};
+#else
+  UNREFERENCED_PARAMETER(sockfd);
+  UNREFERENCED_PARAMETER(msgvec);
+  UNREFERENCED_PARAMETER(vlen);
+  UNREFERENCED_PARAMETER(flags);
+  return {-1, EOPNOTSUPP};
+#endif
+}
+
 bool OsSysCallsImpl::supportsMmsg() const {
 #if ENVOY_MMSG_MORE
   return true;
@@ -273,6 +287,11 @@ SysCallIntResult OsSysCallsImpl::unlink(const char* pathname) const {
   return {rc, rc != -1 ? 0 : errno};
 }
 
+SysCallIntResult OsSysCallsImpl::rename(const char* oldpath, const char* newpath) const {
+  const int rc = ::rename(oldpath, newpath);
+  return {rc, rc != -1 ? 0 : errno};
+}
+
 SysCallIntResult OsSysCallsImpl::linkat(os_fd_t olddirfd, const char* oldpath, os_fd_t newdirfd,
                                         const char* newpath, int flags) const {
   const int rc = ::linkat(olddirfd, oldpath, newdirfd, newpath, flags);
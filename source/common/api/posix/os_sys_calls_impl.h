@@ -28,6 +28,8 @@ public:
   SysCallSizeResult recvmsg(os_fd_t sockfd, msghdr* msg, int flags) override;
   SysCallIntResult recvmmsg(os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen, int flags,
                             struct timespec* timeout) override;
+  SysCallIntResult sendmmsg(os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                            int flags) override;
   bool supportsMmsg() const override;
   bool supportsUdpGro() const override;
   bool supportsUdpGso() const override;
@@ -53,6 +55,7 @@ public:
   SysCallIntResult open(const char* pathname, int flags) const override;
   SysCallIntResult open(const char* pathname, int flags, mode_t mode) const override;
   SysCallIntResult unlink(const char* pathname) const override;
+  SysCallIntResult rename(const char* oldpath, const char* newpath) const override;
   SysCallIntResult linkat(os_fd_t olddirfd, const char* oldpath, os_fd_t newdirfd,
                           const char* newpath, int flags) const override;
   SysCallIntResult mkstemp(char* tmplate) const override;
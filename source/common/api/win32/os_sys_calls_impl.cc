@@ -197,6 +197,11 @@ SysCallIntResult OsSysCallsImpl::recvmmsg(os_fd_t sockfd, struct mmsghdr* msgvec
   PANIC("not implemented");
 }
 
+SysCallIntResult OsSysCallsImpl::sendmmsg(os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                          int flags) {
+  PANIC("not implemented");
+}
+
 bool OsSysCallsImpl::supportsMmsg() const {
   // Windows doesn't support it.
   return false;
@@ -320,6 +325,14 @@ SysCallIntResult OsSysCallsImpl::unlink(const char* pathname) const {
   return {rc, rc != -1 ? 0 : ::WSAGetLastError()};
 }
 
+SysCallIntResult OsSysCallsImpl::rename(const char* oldpath, const char* newpath) const {
+  // Unlike POSIX rename(), ::rename() fails on Windows if newpath already exists.
+  if (!::MoveFileExA(oldpath, newpath, MOVEFILE_REPLACE_EXISTING)) {
+    return {-1, static_cast<int>(::GetLastError())};
+  }
+  return {0, 0};
+}
+
 SysCallIntResult OsSysCallsImpl::linkat(os_fd_t olddirfd, const char* oldpath, os_fd_t newdirfd,
                                         const char* newpath, int flags) const {
   PANIC("not implemented");
@@ -0,0 +1,108 @@
+#include "source/common/common/json_escape_string.h"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "absl/numeric/bits.h"
+
+namespace Envoy {
+namespace {
+
+// Portable check for a single byte. The unsigned comparisons also cover bytes with the high bit
+// set, which is what the vectorized versions below compute as well.
+template <bool StopAtNonAscii> inline bool isStopByte(uint8_t byte) {
+  if (byte < 0x20 || byte == '"' || byte == '\\') {
+    return true;
+  }
+  return StopAtNonAscii && byte >= 0x7f;
+}
+
+template <bool StopAtNonAscii> size_t findFirstStopByte(absl::string_view input) {
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(input.data());
+  const size_t size = input.size();
+  size_t position = 0;
+
+#if defined(__SSE2__)
+  // SSE2 is part of the x86-64 baseline, so this needs no runtime CPU detection.
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i last_control = _mm_set1_epi8(0x1f);
+  const __m128i del = _mm_set1_epi8(0x7f);
+  for (; position + 16 <= size; position += 16) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position));
+    // There are no unsigned byte comparisons in SSE2: chunk <= 0x1f iff min(chunk, 0x1f) == chunk.
+    __m128i stop = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+        _mm_cmpeq_epi8(_mm_min_epu8(chunk, last_control), chunk));
+    if (StopAtNonAscii) {
+      stop = _mm_or_si128(stop, _mm_cmpeq_epi8(_mm_max_epu8(chunk, del), chunk));
+    }
+    const uint32_t mask = _mm_movemask_epi8(stop);
+    if (mask != 0) {
+      return position + absl::countr_zero(mask);
+    }
+  }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+  const uint8x16_t quote = vdupq_n_u8('"');
+  const uint8x16_t backslash = vdupq_n_u8('\\');
+  const uint8x16_t space = vdupq_n_u8(0x20);
+  const uint8x16_t del = vdupq_n_u8(0x7f);
+  for (; position + 16 <= size; position += 16) {
+    const uint8x16_t chunk = vld1q_u8(data + position);
+    uint8x16_t stop = vorrq_u8(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)),
+                               vcltq_u8(chunk, space));
+    if (StopAtNonAscii) {
+      stop = vorrq_u8(stop, vcgeq_u8(chunk, del));
+    }
+    if (vmaxvq_u8(stop) != 0) {
+      // NEON has no movemask; the scalar loop below finds the byte within this chunk.
+      break;
+    }
+  }
+#else
+  // Without SIMD, test 8 bytes at a time in a 64-bit word. For each byte b < 0x80, the high bit
+  // of (b - n) & ~b is set iff b < n, and bytes equal to c are those for which b ^ c is less than
+  // 1. Borrows and carries can only flag bytes after an actual match, so the word is just tested
+  // for any match, and the scalar loop below finds its position.
+  constexpr uint64_t ones = 0x0101010101010101ULL;
+  constexpr uint64_t high_bits = 0x8080808080808080ULL;
+  const auto less_than = [](uint64_t word, uint8_t n) { return (word - ones * n) & ~word; };
+  for (; position + 8 <= size; position += 8) {
+    uint64_t word;
+    memcpy(&word, data + position, sizeof(word));
+    uint64_t stop = less_than(word, 0x20) | less_than(word ^ (ones * '"'), 1) |
+                    less_than(word ^ (ones * '\\'), 1);
+    if (StopAtNonAscii) {
+      // Bytes >= 0x7f are those with the high bit set after adding 1, or the high bit set already.
+      stop |= (word + ones) | word;
+    }
+    if ((stop & high_bits) != 0) {
+      break;
+    }
+  }
+#endif
+
+  for (; position < size; ++position) {
+    if (isStopByte<StopAtNonAscii>(data[position])) {
+      break;
+    }
+  }
+  return position;
+}
+
+} // namespace
+
+size_t JsonEscaper::findFirstEscape(absl::string_view input) {
+  return findFirstStopByte<false>(input);
+}
+
+size_t JsonEscaper::findFirstEscapeOrNonAscii(absl::string_view input) {
+  return findFirstStopByte<true>(input);
+}
+
+} // namespace Envoy
@@ -26,7 +26,17 @@ public:
     std::string result(input.size() + required_size, '\\');
     uint64_t position = 0;
 
-    for (const auto& character : input) {
+    while (!input.empty()) {
+      // Bulk-copy the span of characters that are added as-is.
+      const size_t span = findFirstEscape(input);
+      input.copy(&result[position], span);
+      position += span;
+      if (span == input.size()) {
+        break;
+      }
+      const char character = input[span];
+      input.remove_prefix(span + 1);
+
       switch (character) {
       case '"':
         // Quotation mark (0x22).
@@ -64,16 +74,11 @@ public:
         position += 2;
         break;
       default:
-        if (character == 0x00 || (character > 0x00 && character <= 0x1f)) {
-          // Print character as unicode hex.
-          sprintf(&result[position + 1], "u%04x", static_cast<int>(character));
-          position += 6;
-          // Overwrite trailing null character.
-          result[position] = '\\';
-        } else {
-          // All other characters are added as-is.
-          result[position++] = character;
-        }
+        // Print the remaining control characters as unicode hex.
+        sprintf(&result[position + 1], "u%04x", static_cast<int>(character));
+        position += 6;
+        // Overwrite trailing null character.
+        result[position] = '\\';
         break;
       }
     }
@@ -86,8 +91,9 @@ public:
   // @return uint64_t the number of extra characters required to to build a JSON escaped string.
   static uint64_t extraSpace(absl::string_view input) {
     uint64_t result = 0;
-    for (const auto& character : input) {
-      switch (character) {
+    for (size_t position = findFirstEscape(input); position < input.size();
+         position += 1 + findFirstEscape(input.substr(position + 1))) {
+      switch (input[position]) {
       case '"':
         FALLTHRU;
       case '\\':
@@ -107,15 +113,25 @@ public:
       }
 
       default: {
-        if (character == 0x00 || (character > 0x00 && character <= 0x1f)) {
-          // From character (1 byte) to unicode hex (6 bytes).
-          result += 5;
-        }
+        // From control character (1 byte) to unicode hex (6 bytes).
+        result += 5;
         break;
       }
       }
     }
     return result;
   }
+
+  // Find the first character that needs to be escaped, i.e. a control character, a quotation
+  // mark or a reverse solidus. Uses SSE2 or NEON to test 16 characters at a time where available.
+  // @param input input string.
+  // @return size_t the offset of the first character to escape, or input.size() if there is none.
+  static size_t findFirstEscape(absl::string_view input);
+
+  // Same as findFirstEscape(), but also stops at DEL (0x7f) and at bytes with the high bit set,
+  // i.e. at anything which isn't printable 7-bit ascii.
+  // @param input input string.
+  // @return size_t the offset of the first such character, or input.size() if there is none.
+  static size_t findFirstEscapeOrNonAscii(absl::string_view input);
 };
 } // namespace Envoy
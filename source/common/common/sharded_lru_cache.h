@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+
+/**
+ * A bounded cache keyed by strings, which is split into shards with their own locks so that all
+ * threads can use it concurrently. Each shard evicts its least recently used entries when it is
+ * full, so the cache holds at most max(max_entries / NumShards, 1) entries per shard.
+ */
+template <class Value, uint32_t NumShards = 16> class ShardedLruCache {
+public:
+  explicit ShardedLruCache(uint32_t max_entries)
+      : max_entries_per_shard_(std::max<uint32_t>(max_entries / NumShards, 1)) {}
+
+  struct InsertResult {
+    // Whether a new entry was added, rather than the value of an existing one replaced.
+    bool inserted_;
+    // Whether the least recently used entry of the shard was evicted to make room for it.
+    bool evicted_;
+  };
+
+  /**
+   * Adds an entry, or replaces the value of the entry with the same key, and marks it as most
+   * recently used.
+   */
+  InsertResult insert(absl::string_view key, Value value) {
+    Shard& shard = this->shard(key);
+    absl::MutexLock lock(&shard.mutex_);
+    if (auto it = shard.index_.find(key); it != shard.index_.end()) {
+      // The key of the index refers to the entry, so the entry is replaced in place.
+      it->second->second = std::move(value);
+      shard.lru_.splice(shard.lru_.begin(), shard.lru_, it->second);
+      return {/*inserted_=*/false, /*evicted_=*/false};
+    }
+    shard.lru_.emplace_front(std::string(key), std::move(value));
+    shard.index_.emplace(shard.lru_.front().first, shard.lru_.begin());
+    if (shard.lru_.size() <= max_entries_per_shard_) {
+      return {/*inserted_=*/true, /*evicted_=*/false};
+    }
+    shard.index_.erase(shard.lru_.back().first);
+    shard.lru_.pop_back();
+    return {/*inserted_=*/true, /*evicted_=*/true};
+  }
+
+  /**
+   * Looks up the entry with the given key, and marks it as most recently used.
+   * @param fn called with the value of the entry under the lock of its shard. It returns whether
+   * the entry is still valid; an invalid entry is removed.
+   * @return whether a valid entry was found.
+   */
+  template <class Fn> bool lookup(absl::string_view key, Fn fn) {
+    Shard& shard = this->shard(key);
+    absl::MutexLock lock(&shard.mutex_);
+    auto it = shard.index_.find(key);
+    if (it == shard.index_.end()) {
+      return false;
+    }
+    if (!fn(it->second->second)) {
+      const auto entry = it->second;
+      shard.index_.erase(it);
+      shard.lru_.erase(entry);
+      return false;
+    }
+    shard.lru_.splice(shard.lru_.begin(), shard.lru_, it->second);
+    return true;
+  }
+
+  /**
+   * @return whether an entry with the given key was removed.
+   */
+  bool remove(absl::string_view key) {
+    Shard& shard = this->shard(key);
+    absl::MutexLock lock(&shard.mutex_);
+    auto it = shard.index_.find(key);
+    if (it == shard.index_.end()) {
+      return false;
+    }
+    const auto entry = it->second;
+    shard.index_.erase(it);
+    shard.lru_.erase(entry);
+    return true;
+  }
+
+  /**
+   * Calls fn with the key and value of every entry, shard by shard, least recently used first.
+   */
+  template <class Fn> void forEach(Fn fn) const {
+    for (const Shard& shard : shards_) {
+      absl::MutexLock lock(&shard.mutex_);
+      for (auto it = shard.lru_.rbegin(); it != shard.lru_.rend(); ++it) {
+        fn(it->first, it->second);
+      }
+    }
+  }
+
+  size_t size() const {
+    size_t size = 0;
+    for (const Shard& shard : shards_) {
+      absl::MutexLock lock(&shard.mutex_);
+      size += shard.lru_.size();
+    }
+    return size;
+  }
+
+  static constexpr uint32_t numShards() { return NumShards; }
+
+private:
+  struct Shard {
+    using Entry = std::pair<std::string, Value>;
+
+    mutable absl::Mutex mutex_;
+    // Most recently used first.
+    std::list<Entry> lru_ ABSL_GUARDED_BY(mutex_);
+    absl::flat_hash_map<absl::string_view, typename std::list<Entry>::iterator>
+        index_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  Shard& shard(absl::string_view key) { return shards_[absl::HashOf(key) % NumShards]; }
+
+  const uint32_t max_entries_per_shard_;
+  std::array<Shard, NumShards> shards_;
+};
+
+} // namespace Envoy
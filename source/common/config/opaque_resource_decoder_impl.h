@@ -2,6 +2,7 @@
 
 #include "envoy/config/subscription.h"
 
+#include "source/common/protobuf/message_validator_impl.h"
 #include "source/common/protobuf/utility.h"
 
 namespace Envoy {
@@ -28,6 +29,26 @@ public:
     return MessageUtil::getStringField(resource, name_field_);
   }
 
+  bool supportsConcurrentDecoding() const override { return true; }
+
+  ProtobufTypes::MessagePtr decodeResourceConcurrently(const ProtobufWkt::Any& resource) override {
+    auto typed_message = std::make_unique<Current>();
+    if (!resource.type_url().empty()) {
+      // The validation visitor (and the runtime it consults for deprecated fields) may only be
+      // used on the main thread, so the unexpected field checks are left to
+      // validateDecodedResource().
+      MessageUtil::anyConvertAndValidate<Current>(resource, *typed_message,
+                                                  ProtobufMessage::getNullValidationVisitor());
+    }
+    return typed_message;
+  }
+
+  void validateDecodedResource(const Protobuf::Message& resource) override {
+    if (!validation_visitor_.skipValidation()) {
+      MessageUtil::checkForUnexpectedFields(resource, validation_visitor_);
+    }
+  }
+
 private:
   ProtobufMessage::ValidationVisitor& validation_visitor_;
   const std::string name_field_;
@@ -79,10 +79,17 @@ DispatcherImpl::DispatcherImpl(const std::string& name, Thread::ThreadFactory& t
   ASSERT(!name_.empty());
   FatalErrorHandler::registerFatalErrorHandler(*this);
   updateApproximateMonotonicTimeInternal();
-  if (Runtime::runtimeFeatureEnabled("envoy.restart_features.fix_dispatcher_approximate_now")) {
-    base_scheduler_.registerOnCheckCallback(
-        std::bind(&DispatcherImpl::updateApproximateMonotonicTime, this));
-  } else {
+  iteration_start_time_ = approximate_monotonic_time_;
+  const bool update_approximate_time_on_check =
+      Runtime::runtimeFeatureEnabled("envoy.restart_features.fix_dispatcher_approximate_now");
+  // The scheduler takes a single check callback, which also records when each iteration starts.
+  base_scheduler_.registerOnCheckCallback([this, update_approximate_time_on_check]() {
+    iteration_start_time_ = time_source_.monotonicTime();
+    if (update_approximate_time_on_check) {
+      approximate_monotonic_time_ = iteration_start_time_;
+    }
+  });
+  if (!update_approximate_time_on_check) {
     base_scheduler_.registerOnPrepareCallback(
         std::bind(&DispatcherImpl::updateApproximateMonotonicTime, this));
   }
@@ -91,6 +91,7 @@ public:
   void popTrackedObject(const ScopeTrackedObject* expected_object) override;
   bool trackedObjectStackIsEmpty() const override { return tracked_object_stack_.empty(); }
   MonotonicTime approximateMonotonicTime() const override;
+  MonotonicTime iterationStartTime() const override { return iteration_start_time_; }
   void updateApproximateMonotonicTime() override;
   void shutdown() override;
 
@@ -172,6 +173,7 @@ private:
       tracked_object_stack_;
   bool deferred_deleting_{};
   MonotonicTime approximate_monotonic_time_;
+  MonotonicTime iteration_start_time_;
   WatchdogRegistrationPtr watchdog_registration_;
   const ScaledRangeTimerManagerPtr scaled_timer_manager_;
 };
@@ -151,6 +151,53 @@ IoUringResult IoUringImpl::prepareWritev(os_fd_t fd, const struct iovec* iovecs,
   return IoUringResult::Ok;
 }
 
+IoUringResult IoUringImpl::prepareRead(os_fd_t fd, bool fixed_file, void* buf, unsigned nbytes,
+                                       off_t offset, int buf_index, Request* user_data) {
+  ENVOY_LOG(trace, "prepare read for fd = {}, fixed file = {}, buffer index = {}", fd, fixed_file,
+            buf_index);
+  // TODO (soulxu): Handling the case of CQ ring is overflow.
+  ASSERT(!(*(ring_.sq.kflags) & IORING_SQ_CQ_OVERFLOW));
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  if (buf_index >= 0) {
+    io_uring_prep_read_fixed(sqe, fd, buf, nbytes, offset, buf_index);
+  } else {
+    io_uring_prep_read(sqe, fd, buf, nbytes, offset);
+  }
+  if (fixed_file) {
+    sqe->flags |= IOSQE_FIXED_FILE;
+  }
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareWrite(os_fd_t fd, bool fixed_file, const void* buf,
+                                        unsigned nbytes, off_t offset, int buf_index,
+                                        Request* user_data) {
+  ENVOY_LOG(trace, "prepare write for fd = {}, fixed file = {}, buffer index = {}", fd, fixed_file,
+            buf_index);
+  // TODO (soulxu): Handling the case of CQ ring is overflow.
+  ASSERT(!(*(ring_.sq.kflags) & IORING_SQ_CQ_OVERFLOW));
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  if (buf_index >= 0) {
+    io_uring_prep_write_fixed(sqe, fd, buf, nbytes, offset, buf_index);
+  } else {
+    io_uring_prep_write(sqe, fd, buf, nbytes, offset);
+  }
+  if (fixed_file) {
+    sqe->flags |= IOSQE_FIXED_FILE;
+  }
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
 IoUringResult IoUringImpl::prepareClose(os_fd_t fd, Request* user_data) {
   ENVOY_LOG(trace, "prepare close for fd = {}", fd);
   // TODO (soulxu): Handling the case of CQ ring is overflow.
@@ -195,12 +242,52 @@ IoUringResult IoUringImpl::prepareShutdown(os_fd_t fd, int how, Request* user_da
   return IoUringResult::Ok;
 }
 
+IoUringResult IoUringImpl::waitForCompletion() {
+  struct io_uring_cqe* cqe;
+  int res;
+  do {
+    res = io_uring_wait_cqe(&ring_, &cqe);
+  } while (res == -EINTR);
+  if (res != 0) {
+    ENVOY_LOG(debug, "unable to wait for io_uring completion: {}", errorDetails(-res));
+    return IoUringResult::Failed;
+  }
+  return IoUringResult::Ok;
+}
+
 IoUringResult IoUringImpl::submit() {
   int res = io_uring_submit(&ring_);
   RELEASE_ASSERT(res >= 0 || res == -EBUSY, "unable to submit io_uring queue entries");
   return res == -EBUSY ? IoUringResult::Busy : IoUringResult::Ok;
 }
 
+IoUringResult IoUringImpl::registerFiles(unsigned count) {
+  int res = io_uring_register_files_sparse(&ring_, count);
+  if (res != 0) {
+    ENVOY_LOG(debug, "unable to register files: {}", errorDetails(-res));
+    return IoUringResult::Failed;
+  }
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::updateRegisteredFile(unsigned index, os_fd_t fd) {
+  int res = io_uring_register_files_update(&ring_, index, &fd, 1);
+  if (res != 1) {
+    ENVOY_LOG(debug, "unable to update registered file {}: {}", index, errorDetails(-res));
+    return IoUringResult::Failed;
+  }
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::registerBuffers(const struct iovec* iovecs, unsigned count) {
+  int res = io_uring_register_buffers(&ring_, iovecs, count);
+  if (res != 0) {
+    ENVOY_LOG(debug, "unable to register buffers: {}", errorDetails(-res));
+    return IoUringResult::Failed;
+  }
+  return IoUringResult::Ok;
+}
+
 void IoUringImpl::injectCompletion(os_fd_t fd, Request* user_data, int32_t result) {
   injected_completions_.emplace_back(fd, user_data, result);
   ENVOY_LOG(trace, "inject completion, fd = {}, req = {}, num injects = {}", fd,
@@ -32,6 +32,7 @@ public:
   void unregisterEventfd() override;
   bool isEventfdRegistered() const override;
   void forEveryCompletion(const CompletionCb& completion_cb) override;
+  IoUringResult waitForCompletion() override;
   IoUringResult prepareAccept(os_fd_t fd, struct sockaddr* remote_addr, socklen_t* remote_addr_len,
                               Request* user_data) override;
   IoUringResult prepareConnect(os_fd_t fd, const Network::Address::InstanceConstSharedPtr& address,
@@ -40,10 +41,17 @@ public:
                              Request* user_data) override;
   IoUringResult prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                               off_t offset, Request* user_data) override;
+  IoUringResult prepareRead(os_fd_t fd, bool fixed_file, void* buf, unsigned nbytes, off_t offset,
+                            int buf_index, Request* user_data) override;
+  IoUringResult prepareWrite(os_fd_t fd, bool fixed_file, const void* buf, unsigned nbytes,
+                             off_t offset, int buf_index, Request* user_data) override;
   IoUringResult prepareClose(os_fd_t fd, Request* user_data) override;
   IoUringResult prepareCancel(Request* cancelling_user_data, Request* user_data) override;
   IoUringResult prepareShutdown(os_fd_t fd, int how, Request* user_data) override;
   IoUringResult submit() override;
+  IoUringResult registerFiles(unsigned count) override;
+  IoUringResult updateRegisteredFile(unsigned index, os_fd_t fd) override;
+  IoUringResult registerBuffers(const struct iovec* iovecs, unsigned count) override;
   void injectCompletion(os_fd_t fd, Request* user_data, int32_t result) override;
   void removeInjectedCompletion(os_fd_t fd) override;
 
@@ -1,8 +1,7 @@
 #include "source/common/json/json_sanitizer.h"
 
 #include "source/common/common/assert.h"
-#include "source/common/common/thread.h"
-#include "source/common/json/json_internal.h"
+#include "source/common/common/json_escape_string.h"
 
 #include "absl/strings/str_format.h"
 #include "utf8_validity.h"
@@ -10,78 +9,32 @@
 namespace Envoy {
 namespace Json {
 
-// clang-format off
-// SPELLCHECKER(off)
-//
-// Performance benchmarks show this is slightly faster as an array of uint32_t
-// rather than an array of bool.
-static constexpr uint32_t needs_slow_sanitizer[256] = {
-  // Control-characters 0-31 all require escapes.
-  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-
-  // Pass through printable characters starting with space. Double-quote and
-  // backslash require an escape.
-  0, 0, 1 /* " */, 0, 0, 0, 0, 0,         //  !"#$%&'
-  0, 0, 0, 0, 0, 0, 0, 0,                 // ()*+,-.7
-  0, 0, 0, 0, 0, 0, 0, 0,                 // 01234567
-  0, 0, 0, 0, 0, 0, 0, 0,                 // 89:;<=>?
-  0, 0, 0, 0, 0, 0, 0, 0,                 // @ABCDEFG
-  0, 0, 0, 0, 0, 0, 0, 0,                 // HIJKLMNO
-  0, 0, 0, 0, 0, 0, 0, 0,                 // PQRSTUVW
-  0, 0, 0, 0, 1 /* backslash */, 0, 0, 0, // XYZ[\]^_
-  0, 0, 0, 0, 0, 0, 0, 0,                 // `abcdefg
-  0, 0, 0, 0, 0, 0, 0, 0,                 // hijklmno
-  0, 0, 0, 0, 0, 0, 0, 0,                 // pqrstuvw
-  0, 0, 0, 0, 0, 0, 0, 1,                 // xyz{|}~\177
-
-  // 0x80-0xff, all of which require calling the slow sanitizer.
-  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-};
-// SPELLCHECKER(on)
-// clang-format on
-
 absl::string_view sanitize(std::string& buffer, absl::string_view str) {
   // Fast-path to see whether any escapes or utf-encoding are needed. If str has
   // only unescaped ascii characters, we can simply return it.
   //
-  // Benchmarks show it's faster to just rip through the string with no
-  // conditionals, so we only check the arithmetically ORed condition after the
-  // loop. This avoids branches and allows simpler loop unrolling by the
-  // compiler.
-  static_assert(ARRAY_SIZE(needs_slow_sanitizer) == 256);
-  uint32_t need_slow = 0;
-  for (char c : str) {
-    // We need to escape control characters, characters >= 127, and double-quote
-    // and backslash.
-    need_slow |= needs_slow_sanitizer[static_cast<uint8_t>(c)];
-  }
-  if (need_slow == 0) {
+  // We need to escape control characters, characters >= 127, and double-quote
+  // and backslash. The scan tests 16 characters at a time where SIMD is
+  // available.
+  const size_t first_slow = JsonEscaper::findFirstEscapeOrNonAscii(str);
+  if (first_slow == str.size()) {
     return str; // Fast path, should be executed most of the time.
   }
-  if (utf8_range::IsStructurallyValid(str)) {
-    // The Nlohmann JSON library supports serialization and is not too slow. A
-    // hand-rolled sanitizer can be a little over 2x faster at the cost of added
-    // production complexity. The main drawback is that this code cannot be used
-    // in the data plane as it throws exceptions. Should this become an issue,
-    // #20428 can be revived which is faster and doesn't throw exceptions, but
-    // adds complexity to the production code base.
-    buffer = Nlohmann::Factory::serialize(str);
-    return stripDoubleQuotes(buffer);
+
+  // Everything before first_slow is 7-bit ascii, so only the remainder can
+  // hold invalid utf-8. The validator is itself vectorized.
+  if (utf8_range::IsStructurallyValid(str.substr(first_slow))) {
+    // Valid utf-8 is passed through, and quotes, backslashes and control
+    // characters are escaped, which is the same output as the Nlohmann JSON
+    // serializer produces, but the spans of characters that need no escaping
+    // are copied in bulk and no exceptions are involved.
+    buffer = JsonEscaper::escapeString(str, JsonEscaper::extraSpace(str));
   } else {
-    // If Nlohmann throws an error, emit a hex escape for any character
-    // requiring it. This can occur for invalid utf-8 sequences, and we don't
-    // want to crash the server if such a sequence makes its way into a string
-    // we need to serialize. For example, if admin endpoint /stats?format=json
-    // is called, and a stat name was synthesized from dynamic content such as a
-    // gRPC method.
+    // For invalid utf-8, emit a hex escape for any character requiring it. We
+    // don't want to crash the server if such a sequence makes its way into a
+    // string we need to serialize. For example, if admin endpoint
+    // /stats?format=json is called, and a stat name was synthesized from
+    // dynamic content such as a gRPC method.
     //
     // Note that JSON string escapes are always 4 digit hex. 3 digit octal would
     // be more compact, and is legal JavaScript, but not legal JSON. See
@@ -93,12 +46,14 @@ absl::string_view sanitize(std::string& buffer, absl::string_view str) {
     // test/common/json/json_sanitizer_test_util.h. We don't expect to hit this
     // often, so it isn't a priority to use these more compact encodings.
     buffer.clear();
-    for (char c : str) {
-      if (needs_slow_sanitizer[static_cast<uint8_t>(c)]) {
-        buffer.append(absl::StrFormat("\\u%04x", c));
-      } else {
-        buffer.append(1, c);
+    while (true) {
+      const size_t span = JsonEscaper::findFirstEscapeOrNonAscii(str);
+      buffer.append(str.data(), span);
+      if (span == str.size()) {
+        break;
       }
+      absl::StrAppendFormat(&buffer, "\\u%04x", str[span]);
+      str.remove_prefix(span + 1);
     }
   }
 
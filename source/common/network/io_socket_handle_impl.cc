@@ -230,6 +230,52 @@ Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slic
   }
 }
 
+Api::IoCallUint64Result IoSocketHandleImpl::sendmmsg(const Buffer::RawSlice* messages,
+                                                     uint64_t num_messages, int flags,
+                                                     const Address::Instance& peer_address) {
+  if (!supportsMmsg()) {
+    // Send the messages one at a time, stopping at the first one which can't be sent.
+    uint64_t num_sent = 0;
+    for (; num_sent < num_messages; ++num_sent) {
+      Api::IoCallUint64Result result =
+          sendmsg(&messages[num_sent], 1, flags, nullptr, peer_address);
+      if (!result.ok()) {
+        if (num_sent == 0) {
+          return result;
+        }
+        break;
+      }
+    }
+    return {num_sent, Api::IoError::none()};
+  }
+
+  const auto* address_base = dynamic_cast<const Address::InstanceBase*>(&peer_address);
+  sockaddr* sock_addr =
+      address_base != nullptr ? const_cast<sockaddr*>(address_base->sockAddr()) : nullptr;
+  if (sock_addr == nullptr) {
+    // Unlikely to happen unless the wrong peer address is passed.
+    return IoSocketError::ioResultSocketInvalidAddress();
+  }
+  absl::FixedArray<iovec> iov(num_messages);
+  absl::FixedArray<mmsghdr> mmsg(num_messages);
+  for (uint64_t i = 0; i < num_messages; i++) {
+    iov[i].iov_base = messages[i].mem_;
+    iov[i].iov_len = messages[i].len_;
+    msghdr& message = mmsg[i].msg_hdr;
+    message.msg_name = reinterpret_cast<void*>(sock_addr);
+    message.msg_namelen = address_base->sockAddrLen();
+    message.msg_iov = &iov[i];
+    message.msg_iovlen = 1;
+    message.msg_control = nullptr;
+    message.msg_controllen = 0;
+    message.msg_flags = 0;
+    mmsg[i].msg_len = 0;
+  }
+  const Api::SysCallIntResult result =
+      Api::OsSysCallsSingleton::get().sendmmsg(fd_, mmsg.begin(), num_messages, flags);
+  return sysCallResultToIoCallResult(result);
+}
+
 Address::InstanceConstSharedPtr
 IoSocketHandleImpl::getOrCreateEnvoyAddressInstance(sockaddr_storage ss, socklen_t ss_len) {
   if (!recent_received_addresses_) {
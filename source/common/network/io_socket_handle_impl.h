@@ -54,6 +54,9 @@ public:
                                   const Address::Ip* self_ip,
                                   const Address::Instance& peer_address) override;
 
+  Api::IoCallUint64Result sendmmsg(const Buffer::RawSlice* messages, uint64_t num_messages,
+                                   int flags, const Address::Instance& peer_address) override;
+
   Api::IoCallUint64Result recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
                                   uint32_t self_port, const UdpSaveCmsgConfig& save_cmsg_config,
                                   RecvMsgOutput& output) override;
@@ -45,6 +45,8 @@ public:
   Api::IoCallUint64Result sendmsg(const Buffer::RawSlice* slices, uint64_t num_slice, int flags,
                                   const Address::Ip* self_ip,
                                   const Address::Instance& peer_address) override;
+  Api::IoCallUint64Result sendmmsg(const Buffer::RawSlice* messages, uint64_t num_messages,
+                                   int flags, const Address::Instance& peer_address) override;
   Api::IoCallUint64Result recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
                                   uint32_t self_port,
                                   const IoHandle::UdpSaveCmsgConfig& udp_save_cmsg_config,
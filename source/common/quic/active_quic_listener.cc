@@ -38,7 +38,7 @@ ActiveQuicListener::ActiveQuicListener(
     EnvoyQuicProofSourceFactoryInterface& proof_source_factory,
     QuicConnectionIdGeneratorPtr&& cid_generator, QuicConnectionIdWorkerSelector worker_selector,
     EnvoyQuicConnectionDebugVisitorFactoryInterfaceOptRef debug_visitor_factory,
-    bool reject_new_connections)
+    bool reject_new_connections, bool flush_batched_writes_per_event_loop)
     : Server::ActiveUdpListenerBase(
           worker_index, concurrency, parent, *listen_socket,
           std::make_unique<Network::UdpListenerImpl>(
@@ -49,6 +49,8 @@ ActiveQuicListener::ActiveQuicListener(
       version_manager_(reject_new_connections ? quic::ParsedQuicVersionVector()
                                               : quic::CurrentSupportedHttp3Versions()),
       kernel_worker_routing_(kernel_worker_routing),
+      forward_misrouted_packets_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.quic_forward_misrouted_packets")),
       packets_to_read_to_connection_count_ratio_(packets_to_read_to_connection_count_ratio),
       crypto_server_stream_factory_(crypto_server_stream_factory),
       connection_id_generator_(std::move(cid_generator)),
@@ -105,13 +107,19 @@ ActiveQuicListener::ActiveQuicListener(
   // Some packet writers (like `UdpGsoBatchWriter`) already directly implement
   // `quic::QuicPacketWriter` and can be used directly here. Other types need
   // `EnvoyQuicPacketWriter` as an adapter.
-  auto* quic_packet_writer = dynamic_cast<quic::QuicPacketWriter*>(udp_packet_writer.get());
-  if (quic_packet_writer != nullptr) {
-    quic_dispatcher_->InitializeWithWriter(quic_packet_writer);
+  std::unique_ptr<quic::QuicPacketWriter> quic_packet_writer;
+  if (auto* writer = dynamic_cast<quic::QuicPacketWriter*>(udp_packet_writer.get());
+      writer != nullptr) {
+    quic_packet_writer.reset(writer);
     udp_packet_writer.release();
   } else {
-    quic_dispatcher_->InitializeWithWriter(new EnvoyQuicPacketWriter(std::move(udp_packet_writer)));
+    quic_packet_writer = std::make_unique<EnvoyQuicPacketWriter>(std::move(udp_packet_writer));
   }
+  if (flush_batched_writes_per_event_loop && quic_packet_writer->IsBatchMode()) {
+    quic_packet_writer = std::make_unique<EnvoyQuicDeferredFlushWriter>(
+        std::move(quic_packet_writer), dispatcher_, listener_config.listenerScope());
+  }
+  quic_dispatcher_->InitializeWithWriter(quic_packet_writer.release());
 
   if (listener_config.udpListenerConfig()) {
     const auto& save_cmsg_configs =
@@ -222,14 +230,25 @@ void ActiveQuicListener::shutdownListener(const Network::ExtraShutdownListenerOp
 }
 
 uint32_t ActiveQuicListener::destination(const Network::UdpRecvData& data) const {
-  if (kernel_worker_routing_) {
-    // The kernel has already routed the packet correctly. Make it stay on the current worker.
-    return worker_index_;
+  // The worker selector is equivalent to the kernel BPF program, which is cheap enough to run
+  // on every packet.
+  const uint32_t dest = select_connection_id_worker_(*data.buffer_, worker_index_);
+  if (!kernel_worker_routing_) {
+    // Taking this path is not as performant as it could be. It means most packets are being
+    // delivered by the kernel to the wrong worker, and then redirected to the correct worker.
+    return dest;
   }
 
-  // Taking this path is not as performant as it could be. It means most packets are being
-  // delivered by the kernel to the wrong worker, and then redirected to the correct worker.
-  return select_connection_id_worker_(*data.buffer_, worker_index_);
+  // The kernel should have already routed the packet correctly. If it didn't, e.g. because the
+  // sockets of the SO_REUSEPORT group are not in worker order, the connection of the packet lives
+  // on another worker.
+  if (dest != worker_index_) {
+    udp_stats_.downstream_rx_datagram_misrouted_.inc();
+    if (forward_misrouted_packets_) {
+      return dest;
+    }
+  }
+  return worker_index_;
 }
 
 size_t ActiveQuicListener::numPacketsExpectedPerEventLoop() const {
@@ -264,7 +283,8 @@ ActiveQuicListenerFactory::ActiveQuicListenerFactory(
       packets_to_read_to_connection_count_ratio_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, packets_to_read_to_connection_count_ratio,
                                           DEFAULT_PACKETS_TO_READ_PER_CONNECTION)),
-      context_(context), reject_new_connections_(config.reject_new_connections()) {
+      context_(context), reject_new_connections_(config.reject_new_connections()),
+      flush_batched_writes_per_event_loop_(config.flush_batched_writes_per_event_loop()) {
   const int64_t idle_network_timeout_ms =
       config.has_idle_timeout() ? DurationUtil::durationToMilliseconds(config.idle_timeout())
                                 : 300000;
@@ -435,7 +455,8 @@ ActiveQuicListenerFactory::createActiveQuicListener(
       listener_config, quic_config, kernel_worker_routing, enabled, quic_stat_names,
       packets_to_read_to_connection_count_ratio, crypto_server_stream_factory, proof_source_factory,
       std::move(cid_generator), worker_selector_,
-      makeOptRefFromPtr(connection_debug_visitor_factory_.get()), reject_new_connections_);
+      makeOptRefFromPtr(connection_debug_visitor_factory_.get()), reject_new_connections_,
+      flush_batched_writes_per_event_loop_);
 }
 
 } // namespace Quic
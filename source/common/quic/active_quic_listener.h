@@ -42,7 +42,8 @@ public:
                      QuicConnectionIdGeneratorPtr&& cid_generator,
                      QuicConnectionIdWorkerSelector worker_selector,
                      EnvoyQuicConnectionDebugVisitorFactoryInterfaceOptRef debug_visitor_factory,
-                     bool reject_new_connections = false);
+                     bool reject_new_connections = false,
+                     bool flush_batched_writes_per_event_loop = false);
 
   ~ActiveQuicListener() override;
 
@@ -87,6 +88,8 @@ private:
   quic::QuicVersionManager version_manager_;
   std::unique_ptr<EnvoyQuicDispatcher> quic_dispatcher_;
   const bool kernel_worker_routing_;
+  // Latches envoy.reloadable_features.quic_forward_misrouted_packets.
+  const bool forward_misrouted_packets_;
   absl::optional<Runtime::FeatureFlag> enabled_{};
   Network::UdpPacketWriter* udp_packet_writer_;
 
@@ -160,6 +163,7 @@ private:
   bool kernel_worker_routing_{};
   Server::Configuration::ListenerFactoryContext& context_;
   bool reject_new_connections_{};
+  bool flush_batched_writes_per_event_loop_{};
 
   static bool disable_kernel_bpf_packet_routing_for_test_;
 };
@@ -74,5 +74,49 @@ quic::WriteResult EnvoyQuicPacketWriter::Flush() {
   return convertToQuicWriteResult(result);
 }
 
+EnvoyQuicDeferredFlushWriter::EnvoyQuicDeferredFlushWriter(
+    std::unique_ptr<quic::QuicPacketWriter> writer, Event::Dispatcher& dispatcher,
+    Stats::Scope& scope)
+    : writer_(std::move(writer)),
+      flush_cb_(dispatcher.createSchedulableCallback([this]() { flush(); })),
+      stats_({QUIC_DEFERRED_FLUSH_WRITER_STATS(POOL_COUNTER(scope))}) {
+  ASSERT(writer_->IsBatchMode());
+}
+
+quic::WriteResult EnvoyQuicDeferredFlushWriter::WritePacket(
+    const char* buffer, size_t buf_len, const quic::QuicIpAddress& self_address,
+    const quic::QuicSocketAddress& peer_address, quic::PerPacketOptions* options,
+    const quic::QuicPacketWriterParams& params) {
+  const quic::WriteResult result =
+      writer_->WritePacket(buffer, buf_len, self_address, peer_address, options, params);
+  if (result.status == quic::WRITE_STATUS_OK ||
+      result.status == quic::WRITE_STATUS_BLOCKED_DATA_BUFFERED) {
+    // The packet may have been buffered. Connections flush at the end of their bursts anyway, but
+    // this makes sure that nothing stays buffered beyond the current iteration.
+    flush_cb_->scheduleCallbackCurrentIteration();
+  }
+  return result;
+}
+
+void EnvoyQuicDeferredFlushWriter::SetWritable() {
+  writer_->SetWritable();
+  // Packets which were buffered when the socket blocked are sent even if no connection writes.
+  flush_cb_->scheduleCallbackCurrentIteration();
+}
+
+quic::WriteResult EnvoyQuicDeferredFlushWriter::Flush() {
+  flush_cb_->scheduleCallbackCurrentIteration();
+  return {quic::WRITE_STATUS_OK, 0};
+}
+
+void EnvoyQuicDeferredFlushWriter::flush() {
+  const quic::WriteResult result = writer_->Flush();
+  if (quic::IsWriteError(result.status)) {
+    ENVOY_LOG_MISC(debug, "deferred flush of batched QUIC packets failed with error code {}",
+                   result.error_code);
+    stats_.deferred_flush_errors_.inc();
+  }
+}
+
 } // namespace Quic
 } // namespace Envoy
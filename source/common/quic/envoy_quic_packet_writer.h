@@ -1,6 +1,12 @@
 #pragma once
 
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/schedulable_cb.h"
 #include "envoy/network/udp_packet_writer_handler.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "absl/types/optional.h"
 
 #include "quiche/quic/core/quic_packet_writer.h"
 
@@ -36,5 +42,64 @@ private:
   Network::UdpPacketWriterPtr envoy_udp_packet_writer_;
 };
 
+#define QUIC_DEFERRED_FLUSH_WRITER_STATS(COUNTER) COUNTER(deferred_flush_errors)
+
+/**
+ * Wrapper struct for the stats of EnvoyQuicDeferredFlushWriter. @see stats_macros.h
+ */
+struct QuicDeferredFlushWriterStats {
+  QUIC_DEFERRED_FLUSH_WRITER_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * A batch mode writer which is shared by all QUIC connections of a listener on a worker, and
+ * defers flushing the batched packets of the wrapped writer to the end of the current dispatcher
+ * iteration. QUICHE flushes batch writers at the end of every burst of writes of a connection, and
+ * a connection usually has several bursts per iteration, e.g. one for each ACK it read. Deferring
+ * the flush lets the wrapped writer combine the packets of consecutive bursts, e.g. into GSO
+ * segments of a single sendmsg() call. The wrapped writer still flushes on its own when its batch
+ * is full or the next packet cannot be batched, e.g. because it is for another peer or has another
+ * release time, so pacing offload is preserved.
+ */
+class EnvoyQuicDeferredFlushWriter : public quic::QuicPacketWriter {
+public:
+  EnvoyQuicDeferredFlushWriter(std::unique_ptr<quic::QuicPacketWriter> writer,
+                               Event::Dispatcher& dispatcher, Stats::Scope& scope);
+
+  // quic::QuicPacketWriter
+  quic::WriteResult WritePacket(const char* buffer, size_t buf_len,
+                                const quic::QuicIpAddress& self_address,
+                                const quic::QuicSocketAddress& peer_address,
+                                quic::PerPacketOptions* options,
+                                const quic::QuicPacketWriterParams& params) override;
+  bool IsWriteBlocked() const override { return writer_->IsWriteBlocked(); }
+  void SetWritable() override;
+  bool IsBatchMode() const override { return true; }
+  bool SupportsReleaseTime() const override { return writer_->SupportsReleaseTime(); }
+  bool SupportsEcn() const override { return writer_->SupportsEcn(); }
+  absl::optional<int> MessageTooBigErrorCode() const override {
+    return writer_->MessageTooBigErrorCode();
+  }
+  quic::QuicByteCount GetMaxPacketSize(const quic::QuicSocketAddress& peer_address) const override {
+    return writer_->GetMaxPacketSize(peer_address);
+  }
+  quic::QuicPacketBuffer GetNextWriteLocation(const quic::QuicIpAddress& self_address,
+                                              const quic::QuicSocketAddress& peer_address) override {
+    return writer_->GetNextWriteLocation(self_address, peer_address);
+  }
+  // Schedules the flush of the wrapped writer, and always succeeds. The batch flushed at the end
+  // of the iteration holds the packets of any number of connections, so the error of a failed
+  // deferred flush can't be attributed to one of them. It is counted and logged instead, and the
+  // lost packets are retransmitted by their connections.
+  quic::WriteResult Flush() override;
+
+private:
+  void flush();
+
+  const std::unique_ptr<quic::QuicPacketWriter> writer_;
+  const Event::SchedulableCallbackPtr flush_cb_;
+  QuicDeferredFlushWriterStats stats_;
+};
+
 } // namespace Quic
 } // namespace Envoy
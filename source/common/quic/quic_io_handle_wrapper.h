@@ -59,6 +59,14 @@ public:
     }
     return io_handle_.sendmsg(slices, num_slice, flags, self_ip, peer_address);
   }
+  Api::IoCallUint64Result sendmmsg(const Buffer::RawSlice* messages, uint64_t num_messages,
+                                   int flags,
+                                   const Network::Address::Instance& peer_address) override {
+    if (closed_) {
+      return {0, Network::IoSocketError::getIoSocketEbadfError()};
+    }
+    return io_handle_.sendmmsg(messages, num_messages, flags, peer_address);
+  }
   Api::IoCallUint64Result recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
                                   uint32_t self_port, const UdpSaveCmsgConfig& udp_save_cmsg_config,
                                   RecvMsgOutput& output) override {
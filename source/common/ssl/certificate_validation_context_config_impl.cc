@@ -44,7 +44,9 @@ CertificateValidationContextConfigImpl::CertificateValidationContextConfigImpl(
       max_verify_depth_(config.has_max_verify_depth()
                             ? absl::optional<uint32_t>(config.max_verify_depth().value())
                             : absl::nullopt),
-      auto_sni_san_match_(auto_sni_san_match) {}
+      auto_sni_san_match_(auto_sni_san_match),
+      verification_cache_size_(
+          config.has_verification_cache_size() ? config.verification_cache_size().value() : 0) {}
 
 absl::StatusOr<std::unique_ptr<CertificateValidationContextConfigImpl>>
 CertificateValidationContextConfigImpl::create(
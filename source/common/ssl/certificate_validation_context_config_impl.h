@@ -60,6 +60,8 @@ public:
 
   bool autoSniSanMatch() const override { return auto_sni_san_match_; }
 
+  uint32_t verificationCacheSize() const override { return verification_cache_size_; }
+
 protected:
   CertificateValidationContextConfigImpl(
       std::string ca_cert, std::string certificate_revocation_list,
@@ -86,6 +88,7 @@ private:
   const bool only_verify_leaf_cert_crl_;
   absl::optional<uint32_t> max_verify_depth_;
   const bool auto_sni_san_match_;
+  const uint32_t verification_cache_size_;
 };
 
 } // namespace Ssl
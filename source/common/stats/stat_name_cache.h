@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "source/common/stats/symbol_table.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * Caches a value derived from each StatName, such as the rendered name and tags of a metric in a
+ * stats sink, for as long as the StatName keeps being looked up. Each entry holds the symbols of
+ * its StatName, so that they aren't reused for another name while it is cached.
+ *
+ * The cache is meant to be used once per flush: the entries which weren't looked up since the
+ * previous call to evictUnused() are removed by it, such as those of deleted metrics.
+ *
+ * This class is not thread-safe.
+ */
+template <class Value> class StatNameCache {
+public:
+  explicit StatNameCache(SymbolTable& symbol_table) : symbol_table_(symbol_table) {}
+
+  /**
+   * @param stat_name the StatName to look up.
+   * @param make_value called to compute the value of the StatName if it isn't cached.
+   * @return the cached value of the StatName.
+   */
+  template <class MakeValue> Value& get(StatName stat_name, MakeValue make_value) {
+    auto it = entries_.find(stat_name);
+    if (it == entries_.end()) {
+      auto entry = std::make_unique<Entry>(stat_name, symbol_table_, make_value());
+      const StatName key = entry->stat_name_storage_.statName();
+      it = entries_.emplace(key, std::move(entry)).first;
+    }
+    it->second->last_used_ = generation_;
+    return it->second->value_;
+  }
+
+  /**
+   * Calls fn with the value of every entry.
+   */
+  template <class Fn> void forEach(Fn fn) {
+    for (auto& entry : entries_) {
+      fn(entry.second->value_);
+    }
+  }
+
+  /**
+   * Removes the entries which weren't looked up since the previous call.
+   */
+  void evictUnused() {
+    absl::erase_if(entries_,
+                   [this](const auto& entry) { return entry.second->last_used_ != generation_; });
+    generation_++;
+  }
+
+  size_t size() const { return entries_.size(); }
+
+private:
+  struct Entry {
+    Entry(StatName stat_name, SymbolTable& symbol_table, Value value)
+        : stat_name_storage_(stat_name, symbol_table), value_(std::move(value)) {}
+
+    const StatNameManagedStorage stat_name_storage_;
+    Value value_;
+    // The value of generation_ when the entry was last looked up.
+    uint64_t last_used_{};
+  };
+
+  SymbolTable& symbol_table_;
+  // Keyed by the StatName held by the entry, which the unique_ptr keeps at a stable address.
+  StatNameHashMap<std::unique_ptr<Entry>> entries_;
+  uint64_t generation_{};
+};
+
+} // namespace Stats
+} // namespace Envoy
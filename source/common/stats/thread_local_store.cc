@@ -1,5 +1,6 @@
 #include "source/common/stats/thread_local_store.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <list>
@@ -807,27 +808,44 @@ ThreadLocalHistogramImpl::ThreadLocalHistogramImpl(StatName name, Histogram::Uni
                                                    const StatNameTagVector& stat_name_tags,
                                                    SymbolTable& symbol_table)
     : HistogramImplHelper(name, tag_extracted_name, stat_name_tags, symbol_table), unit_(unit),
-      used_(false), created_thread_id_(std::this_thread::get_id()), symbol_table_(symbol_table) {
-  histograms_[0] = hist_alloc();
-  histograms_[1] = hist_alloc();
-}
+      used_(false), created_thread_id_(std::this_thread::get_id()), symbol_table_(symbol_table) {}
 
 ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() {
   MetricImpl::clear(symbol_table_);
-  hist_free(histograms_[0]);
-  hist_free(histograms_[1]);
+  for (histogram_t* histogram : histograms_) {
+    if (histogram != nullptr) {
+      hist_free(histogram);
+    }
+  }
 }
 
 void ThreadLocalHistogramImpl::recordValue(uint64_t value) {
   ASSERT(std::this_thread::get_id() == created_thread_id_);
-  hist_insert_intscale(histograms_[current_active_], value, 0, 1);
+  histogram_t*& histogram = histograms_[current_active_];
+  if (histogram == nullptr) {
+    histogram = hist_alloc();
+  }
+  hist_insert_intscale(histogram, value, 0, 1);
   used_ = true;
 }
 
 void ThreadLocalHistogramImpl::merge(histogram_t* target) {
-  histogram_t** other_histogram = &histograms_[otherHistogramIndex()];
-  hist_accumulate(target, other_histogram, 1);
-  hist_clear(*other_histogram);
+  histogram_t*& other_histogram = histograms_[otherHistogramIndex()];
+  if (other_histogram != nullptr && hist_sample_count(other_histogram) > 0) {
+    hist_accumulate(target, &other_histogram, 1);
+    hist_clear(other_histogram);
+    empty_merges_ = 0;
+    return;
+  }
+  if (empty_merges_ < MaxEmptyMerges) {
+    ++empty_merges_;
+  }
+  // The buffer currently recording becomes the other one at the next merge, so both are released
+  // by consecutive merges if the histogram stays idle.
+  if (empty_merges_ == MaxEmptyMerges && other_histogram != nullptr) {
+    hist_free(other_histogram);
+    other_histogram = nullptr;
+  }
 }
 
 ParentHistogramImpl::ParentHistogramImpl(StatName name, Histogram::Unit unit,
@@ -836,8 +854,8 @@ ParentHistogramImpl::ParentHistogramImpl(StatName name, Histogram::Unit unit,
                                          const StatNameTagVector& stat_name_tags,
                                          ConstSupportedBuckets& supported_buckets, uint64_t id)
     : MetricImpl(name, tag_extracted_name, stat_name_tags, thread_local_store.symbolTable()),
-      unit_(unit), thread_local_store_(thread_local_store), interval_histogram_(hist_alloc()),
-      cumulative_histogram_(hist_alloc()),
+      unit_(unit), thread_local_store_(thread_local_store),
+      interval_histogram_(hist_alloc_nbins(1)), cumulative_histogram_(hist_alloc_nbins(1)),
       interval_statistics_(interval_histogram_, unit, supported_buckets),
       cumulative_statistics_(cumulative_histogram_, unit, supported_buckets), id_(id) {}
 
@@ -926,6 +944,23 @@ void ParentHistogramImpl::merge() {
     // Since TLS merge is done, we can release the lock here.
     lock.release();
     hist_accumulate(cumulative_histogram_, &interval_histogram_, 1);
+
+    if (hist_sample_count(interval_histogram_) > 0) {
+      empty_merges_ = 0;
+    } else if (empty_merges_ < ThreadLocalHistogramImpl::MaxEmptyMerges) {
+      ++empty_merges_;
+    }
+    const uint32_t interval_buckets = hist_num_buckets(interval_histogram_);
+    if (interval_buckets > interval_allocated_bins_ ||
+        (empty_merges_ == ThreadLocalHistogramImpl::MaxEmptyMerges &&
+         interval_allocated_bins_ > 1)) {
+      compact(interval_histogram_, interval_allocated_bins_);
+    }
+    const uint32_t cumulative_buckets = hist_num_buckets(cumulative_histogram_);
+    if (cumulative_buckets > cumulative_allocated_bins_) {
+      compact(cumulative_histogram_, cumulative_allocated_bins_);
+    }
+
     cumulative_statistics_.refresh(cumulative_histogram_);
     interval_statistics_.refresh(interval_histogram_);
     merged_ = true;
@@ -978,6 +1013,28 @@ ParentHistogramImpl::detailedlBucketsHelper(const histogram_t& histogram) {
   return buckets;
 }
 
+void ParentHistogramImpl::compact(histogram_t*& histogram, uint32_t& allocated_bins) {
+  const uint32_t num_buckets = hist_num_buckets(histogram);
+  hist_bucket_t bucket;
+  uint64_t count;
+  uint32_t used_bins = 0;
+  for (uint32_t i = 0; i < num_buckets; ++i) {
+    hist_bucket_idx_bucket(histogram, i, &bucket, &count);
+    used_bins += count > 0 ? 1 : 0;
+  }
+  allocated_bins = std::max<uint32_t>(used_bins, 1);
+  histogram_t* compacted = hist_alloc_nbins(allocated_bins);
+  // Buckets are sorted, so each insertion appends to the new histogram.
+  for (uint32_t i = 0; i < num_buckets; ++i) {
+    hist_bucket_idx_bucket(histogram, i, &bucket, &count);
+    if (count > 0) {
+      hist_insert_raw(compacted, bucket, count);
+    }
+  }
+  hist_free(histogram);
+  histogram = compacted;
+}
+
 void ParentHistogramImpl::addTlsHistogram(const TlsHistogramSharedPtr& hist_ptr) {
   Thread::LockGuard lock(merge_lock_);
   tls_histograms_.emplace_back(hist_ptr);
@@ -30,15 +30,35 @@ namespace Stats {
  * A histogram that is stored in TLS and used to record values per thread. This holds two
  * histograms, one to collect the values and other as backup that is used for merge process. The
  * swap happens during the merge process.
+ *
+ * Both histograms are allocated on the first value recorded into them, and released again once
+ * the histogram has been idle for MaxEmptyMerges merges, so that the many histograms which are
+ * rarely or never recorded on a given worker don't each hold two circllhist buffers.
  */
 class ThreadLocalHistogramImpl : public HistogramImplHelper {
 public:
+  // Number of consecutive merges without any recorded value after which the buffers are released.
+  static constexpr uint32_t MaxEmptyMerges = 3;
+
   ThreadLocalHistogramImpl(StatName name, Histogram::Unit unit, StatName tag_extracted_name,
                            const StatNameTagVector& stat_name_tags, SymbolTable& symbol_table);
   ~ThreadLocalHistogramImpl() override;
 
+  /**
+   * Accumulates the values recorded before the last beginMerge() into target, and releases the
+   * buffer holding them if the histogram has been idle for MaxEmptyMerges merges. This is called
+   * on the main thread, which is the only one touching that buffer until the next beginMerge().
+   */
   void merge(histogram_t* target);
 
+  /**
+   * @return the number of circllhist buffers currently allocated, between 0 and 2. This must be
+   * called on the thread which owns the histogram.
+   */
+  uint32_t numAllocatedBuffers() const {
+    return (histograms_[0] != nullptr ? 1 : 0) + (histograms_[1] != nullptr ? 1 : 0);
+  }
+
   /**
    * Called in the beginning of merge process. Swaps the histogram used for collection so that we do
    * not have to lock the histogram in high throughput TLS writes.
@@ -66,7 +86,8 @@ private:
   Histogram::Unit unit_;
   uint64_t otherHistogramIndex() const { return 1 - current_active_; }
   uint64_t current_active_{0};
-  histogram_t* histograms_[2];
+  histogram_t* histograms_[2]{nullptr, nullptr};
+  uint32_t empty_merges_{0}; // Only accessed by merge().
   std::atomic<bool> used_;
   std::thread::id created_thread_id_;
   SymbolTable& symbol_table_;
@@ -96,7 +117,9 @@ public:
    * This method is called during the main stats flush process for each of the histograms. It
    * iterates through the TLS histograms and collects the histogram data of all of them
    * in to "interval_histogram". Then the collected "interval_histogram" is merged to a
-   * "cumulative_histogram".
+   * "cumulative_histogram". Both are then kept compact: they hold just the bins they use, and the
+   * interval histogram shrinks back to a single bin once idle for
+   * ThreadLocalHistogramImpl::MaxEmptyMerges merges.
    */
   void merge() override;
 
@@ -131,11 +154,19 @@ private:
   bool usedLockHeld() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(merge_lock_);
   static std::vector<Stats::ParentHistogram::Bucket>
   detailedlBucketsHelper(const histogram_t& histogram);
+  // Replaces histogram by a copy allocating exactly its used bins, or a single one if empty, and
+  // updates allocated_bins accordingly.
+  static void compact(histogram_t*& histogram, uint32_t& allocated_bins);
 
   Histogram::Unit unit_;
   ThreadLocalStoreImpl& thread_local_store_;
   histogram_t* interval_histogram_;
   histogram_t* cumulative_histogram_;
+  // Number of bins allocated by the last compact() of each histogram. circllhist only grows a
+  // histogram when its used bins reach its allocation, so using more bins than this means it grew.
+  uint32_t interval_allocated_bins_{1};
+  uint32_t cumulative_allocated_bins_{1};
+  uint32_t empty_merges_{0};
   HistogramStatisticsImpl interval_statistics_;
   HistogramStatisticsImpl cumulative_statistics_;
   mutable Thread::MutexBasicLockable merge_lock_;
@@ -0,0 +1,72 @@
+#include "source/common/tls/cert_validator/cert_verification_cache.h"
+
+#include <algorithm>
+
+#include "source/common/tls/utility.h"
+
+#include "openssl/digest.h"
+#include "openssl/x509.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+CertVerificationCache::CertVerificationCache(uint32_t max_entries, TimeSource& time_source,
+                                             SslStats& stats)
+    : time_source_(time_source), stats_(stats), cache_(max_entries) {}
+
+std::string CertVerificationCache::key(STACK_OF(X509)& cert_chain, bool is_server) {
+  bssl::ScopedEVP_MD_CTX md;
+  if (!EVP_DigestInit(md.get(), EVP_sha256())) {
+    return "";
+  }
+  const uint8_t role = is_server;
+  EVP_DigestUpdate(md.get(), &role, sizeof(role));
+  for (X509* cert : &cert_chain) {
+    // Hashing the certificates is far cheaper than verifying their signatures.
+    uint8_t cert_digest[SHA256_DIGEST_LENGTH];
+    unsigned int cert_digest_length;
+    if (!X509_digest(cert, EVP_sha256(), cert_digest, &cert_digest_length)) {
+      return "";
+    }
+    EVP_DigestUpdate(md.get(), cert_digest, cert_digest_length);
+  }
+  std::string key(SHA256_DIGEST_LENGTH, '\0');
+  unsigned int key_length;
+  if (!EVP_DigestFinal(md.get(), reinterpret_cast<uint8_t*>(key.data()), &key_length)) {
+    return "";
+  }
+  return key;
+}
+
+bool CertVerificationCache::lookup(absl::string_view key) {
+  const SystemTime now = time_source_.systemTime();
+  if (!cache_.lookup(key, [now](SystemTime expiration) { return expiration > now; })) {
+    stats_.verify_cache_miss_.inc();
+    return false;
+  }
+  stats_.verify_cache_hit_.inc();
+  return true;
+}
+
+void CertVerificationCache::insert(absl::string_view key, STACK_OF(X509)& cert_chain,
+                                   SystemTime max_expiration) {
+  SystemTime expiration = max_expiration;
+  for (const X509* cert : &cert_chain) {
+    expiration = std::min(expiration, Utility::getExpirationTime(*cert));
+  }
+  if (expiration <= time_source_.systemTime()) {
+    // An expired chain which was accepted because of allow_expired_certificate, or a stale CRL.
+    return;
+  }
+
+  cache_.insert(key, expiration);
+}
+
+size_t CertVerificationCache::size() const { return cache_.size(); }
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "envoy/common/time.h"
+
+#include "source/common/common/sharded_lru_cache.h"
+#include "source/common/tls/stats.h"
+
+#include "absl/strings/string_view.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * A bounded cache of the certificate chains which a validator verified against its trusted CA,
+ * keyed by the SHA-256 digest of the chain. An entry expires with the first certificate of its
+ * chain which expires, or when the CRLs of the validator are due to be updated. The cache is shared
+ * by the handshakes of all workers, and sharded to keep them from contending on a single lock.
+ *
+ * The cache belongs to a validator, which is replaced, together with the cache, whenever its
+ * validation context, including the trusted CA and the CRL, changes.
+ */
+class CertVerificationCache {
+public:
+  CertVerificationCache(uint32_t max_entries, TimeSource& time_source, SslStats& stats);
+
+  /**
+   * @param cert_chain the chain presented by the peer.
+   * @param is_server whether the chain is verified by a server, i.e. it is a client certificate.
+   * @return the key of the chain, or an empty string if it could not be computed.
+   */
+  static std::string key(STACK_OF(X509)& cert_chain, bool is_server);
+
+  /**
+   * @return whether the chain with the given key was verified and has not expired since.
+   */
+  bool lookup(absl::string_view key);
+
+  /**
+   * Records that the given chain was verified.
+   * @param key the key of the chain.
+   * @param cert_chain the chain.
+   * @param max_expiration the time after which the verification must be repeated even if no
+   * certificate of the chain expired, such as the next update of a CRL.
+   */
+  void insert(absl::string_view key, STACK_OF(X509)& cert_chain, SystemTime max_expiration);
+
+  size_t size() const;
+
+  static constexpr uint32_t NumShards = 16;
+
+private:
+  TimeSource& time_source_;
+  SslStats& stats_;
+  // The expiration time of the verified chains.
+  ShardedLruCache<SystemTime, NumShards> cache_;
+};
+
+using CertVerificationCachePtr = std::unique_ptr<CertVerificationCache>;
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
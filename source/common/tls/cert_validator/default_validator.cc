@@ -52,9 +52,20 @@ DefaultCertValidator::DefaultCertValidator(
     allow_untrusted_certificate_ = config_->trustChainVerification() ==
                                    envoy::extensions::transport_sockets::tls::v3::
                                        CertificateValidationContext::ACCEPT_UNTRUSTED;
+    if (config_->verificationCacheSize() > 0) {
+      verification_cache_ = std::make_unique<CertVerificationCache>(
+          config_->verificationCacheSize(), context_.timeSource(), stats_);
+    }
   }
 };
 
+void DefaultCertValidator::recordCrlNextUpdate(const X509_CRL& crl) {
+  const absl::optional<SystemTime> next_update = Utility::getNextUpdateTime(crl);
+  if (next_update.has_value()) {
+    crl_next_update_ = std::min(crl_next_update_, *next_update);
+  }
+}
+
 absl::StatusOr<int> DefaultCertValidator::initializeSslContexts(std::vector<SSL_CTX*> contexts,
                                                                 bool provides_certificates) {
 
@@ -99,6 +110,7 @@ absl::StatusOr<int> DefaultCertValidator::initializeSslContexts(std::vector<SSL_
         }
         if (item->crl) {
           X509_STORE_add_crl(store, item->crl);
+          recordCrlNextUpdate(*item->crl);
           has_crl = true;
         }
       }
@@ -146,6 +158,7 @@ absl::StatusOr<int> DefaultCertValidator::initializeSslContexts(std::vector<SSL_
       for (const X509_INFO* item : list.get()) {
         if (item->crl) {
           X509_STORE_add_crl(store, item->crl);
+          recordCrlNextUpdate(*item->crl);
         }
       }
       X509_STORE_set_flags(store, config_->onlyVerifyLeafCertificateCrl()
@@ -157,15 +170,12 @@ absl::StatusOr<int> DefaultCertValidator::initializeSslContexts(std::vector<SSL_
   const Envoy::Ssl::CertificateValidationContextConfig* cert_validation_config = config_;
   if (cert_validation_config != nullptr) {
     if (!cert_validation_config->subjectAltNameMatchers().empty()) {
-      for (const envoy::extensions::transport_sockets::tls::v3::SubjectAltNameMatcher& matcher :
-           cert_validation_config->subjectAltNameMatchers()) {
-        auto san_matcher = createStringSanMatcher(matcher, context_);
-        if (san_matcher == nullptr) {
-          return absl::InvalidArgumentError(
-              absl::StrCat("Failed to create string SAN matcher of type ", matcher.san_type()));
-        }
-        subject_alt_name_matchers_.emplace_back(std::move(san_matcher));
-      }
+      // The matchers are compiled into one, which looks up exact names instead of evaluating
+      // every matcher against every name of the certificate.
+      absl::StatusOr<SanMatcherPtr> san_matcher =
+          CompiledSanMatcher::create(cert_validation_config->subjectAltNameMatchers(), context_);
+      RETURN_IF_NOT_OK_REF(san_matcher.status());
+      subject_alt_name_matchers_.emplace_back(std::move(*san_matcher));
       verify_mode = verify_mode_validation_context;
     }
 
@@ -313,39 +323,48 @@ ValidationResults DefaultCertValidator::doVerifyCertChain(
   X509* leaf_cert = sk_X509_value(&cert_chain, 0);
   ASSERT(leaf_cert);
   if (verify_trusted_ca_) {
-    X509_STORE* verify_store = SSL_CTX_get_cert_store(&ssl_ctx);
-    ASSERT(verify_store);
-    bssl::UniquePtr<X509_STORE_CTX> ctx(X509_STORE_CTX_new());
-    if (!ctx || !X509_STORE_CTX_init(ctx.get(), verify_store, leaf_cert, &cert_chain) ||
-        // We need to inherit the verify parameters. These can be determined by
-        // the context: if it's a server it will verify SSL client certificates or
-        // vice versa.
-        !X509_STORE_CTX_set_default(ctx.get(), is_server ? "ssl_client" : "ssl_server") ||
-        // Anything non-default in "param" should overwrite anything in the ctx.
-        !X509_VERIFY_PARAM_set1(X509_STORE_CTX_get0_param(ctx.get()),
-                                SSL_CTX_get0_param(&ssl_ctx))) {
-      OPENSSL_PUT_ERROR(SSL, ERR_R_X509_LIB);
-      const char* error = "verify cert failed: init and setup X509_STORE_CTX";
-      stats_.fail_verify_error_.inc();
-      ENVOY_LOG(debug, error);
-      return {ValidationResults::ValidationStatus::Failed,
-              Envoy::Ssl::ClientValidationStatus::Failed, absl::nullopt, error};
-    }
-    const bool verify_succeeded = (X509_verify_cert(ctx.get()) == 1);
-
-    if (!verify_succeeded) {
-      const std::string error =
-          absl::StrCat("verify cert failed: ", Utility::getX509VerificationErrorInfo(ctx.get()));
-      stats_.fail_verify_error_.inc();
-      ENVOY_LOG(debug, error);
-      if (allow_untrusted_certificate_) {
-        return ValidationResults{ValidationResults::ValidationStatus::Successful,
-                                 Envoy::Ssl::ClientValidationStatus::Failed, absl::nullopt,
-                                 absl::nullopt};
+    // A chain which was verified before is not verified again until the cached result expires.
+    const std::string cache_key = verification_cache_ != nullptr
+                                      ? CertVerificationCache::key(cert_chain, is_server)
+                                      : std::string();
+    if (cache_key.empty() || !verification_cache_->lookup(cache_key)) {
+      X509_STORE* verify_store = SSL_CTX_get_cert_store(&ssl_ctx);
+      ASSERT(verify_store);
+      bssl::UniquePtr<X509_STORE_CTX> ctx(X509_STORE_CTX_new());
+      if (!ctx || !X509_STORE_CTX_init(ctx.get(), verify_store, leaf_cert, &cert_chain) ||
+          // We need to inherit the verify parameters. These can be determined by
+          // the context: if it's a server it will verify SSL client certificates or
+          // vice versa.
+          !X509_STORE_CTX_set_default(ctx.get(), is_server ? "ssl_client" : "ssl_server") ||
+          // Anything non-default in "param" should overwrite anything in the ctx.
+          !X509_VERIFY_PARAM_set1(X509_STORE_CTX_get0_param(ctx.get()),
+                                  SSL_CTX_get0_param(&ssl_ctx))) {
+        OPENSSL_PUT_ERROR(SSL, ERR_R_X509_LIB);
+        const char* error = "verify cert failed: init and setup X509_STORE_CTX";
+        stats_.fail_verify_error_.inc();
+        ENVOY_LOG(debug, error);
+        return {ValidationResults::ValidationStatus::Failed,
+                Envoy::Ssl::ClientValidationStatus::Failed, absl::nullopt, error};
+      }
+      const bool verify_succeeded = (X509_verify_cert(ctx.get()) == 1);
+
+      if (!verify_succeeded) {
+        const std::string error =
+            absl::StrCat("verify cert failed: ", Utility::getX509VerificationErrorInfo(ctx.get()));
+        stats_.fail_verify_error_.inc();
+        ENVOY_LOG(debug, error);
+        if (allow_untrusted_certificate_) {
+          return ValidationResults{ValidationResults::ValidationStatus::Successful,
+                                   Envoy::Ssl::ClientValidationStatus::Failed, absl::nullopt,
+                                   absl::nullopt};
+        }
+        return {ValidationResults::ValidationStatus::Failed,
+                Envoy::Ssl::ClientValidationStatus::Failed,
+                SSL_alert_from_verify_result(X509_STORE_CTX_get_error(ctx.get())), error};
+      }
+      if (!cache_key.empty()) {
+        verification_cache_->insert(cache_key, cert_chain, crl_next_update_);
       }
-      return {ValidationResults::ValidationStatus::Failed,
-              Envoy::Ssl::ClientValidationStatus::Failed,
-              SSL_alert_from_verify_result(X509_STORE_CTX_get_error(ctx.get())), error};
     }
     detailed_status = Envoy::Ssl::ClientValidationStatus::Validated;
   }
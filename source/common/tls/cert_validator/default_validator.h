@@ -20,6 +20,7 @@
 #include "source/common/common/matchers.h"
 #include "source/common/stats/symbol_table.h"
 #include "source/common/tls/cert_validator/cert_validator.h"
+#include "source/common/tls/cert_validator/cert_verification_cache.h"
 #include "source/common/tls/cert_validator/san_matcher.h"
 #include "source/common/tls/stats.h"
 
@@ -109,9 +110,14 @@ private:
                                  Envoy::Ssl::ClientValidationStatus& detailed_status,
                                  std::string* error_details, uint8_t* out_alert);
 
+  void recordCrlNextUpdate(const X509_CRL& crl);
+
   const Envoy::Ssl::CertificateValidationContextConfig* config_;
   SslStats& stats_;
   Server::Configuration::CommonFactoryContext& context_;
+  CertVerificationCachePtr verification_cache_;
+  // The earliest next update of the CRLs, after which cached verifications must be repeated.
+  SystemTime crl_next_update_{SystemTime::max()};
 
   bssl::UniquePtr<X509> ca_cert_;
   std::string ca_file_path_;
@@ -9,6 +9,9 @@
 
 #include "source/common/tls/utility.h"
 
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace TransportSockets {
@@ -71,6 +74,108 @@ SanMatcherPtr createStringSanMatcher(
   return nullptr;
 }
 
+absl::StatusOr<SanMatcherPtr> CompiledSanMatcher::create(
+    const std::vector<envoy::extensions::transport_sockets::tls::v3::SubjectAltNameMatcher>&
+        matchers,
+    Server::Configuration::CommonFactoryContext& context) {
+  using envoy::extensions::transport_sockets::tls::v3::SubjectAltNameMatcher;
+  // Not using std::make_unique since the constructor is private.
+  auto compiled = std::unique_ptr<CompiledSanMatcher>(new CompiledSanMatcher());
+  for (const SubjectAltNameMatcher& matcher : matchers) {
+    const bool exact = matcher.matcher().match_pattern_case() ==
+                       envoy::type::matcher::v3::StringMatcher::MatchPatternCase::kExact;
+    // Other names are looked up with their OID, so they are left to the matchers which are
+    // evaluated in order.
+    int general_name_type = GEN_OTHERNAME;
+    switch (matcher.san_type()) {
+    case SubjectAltNameMatcher::EMAIL:
+      general_name_type = GEN_EMAIL;
+      break;
+    case SubjectAltNameMatcher::URI:
+      general_name_type = GEN_URI;
+      break;
+    case SubjectAltNameMatcher::IP_ADDRESS:
+      general_name_type = GEN_IPADD;
+      break;
+    default:
+      break;
+    }
+
+    if (exact && matcher.san_type() == SubjectAltNameMatcher::DNS) {
+      // DNS names are matched with DNS semantics, which ignore case.
+      std::string name = absl::AsciiStrToLower(matcher.matcher().exact());
+      const size_t dot = name.find('.');
+      if (dot != std::string::npos) {
+        compiled->dns_names_by_parent_[name.substr(dot + 1)].push_back(name);
+      }
+      compiled->dns_names_.insert(std::move(name));
+    } else if (exact && general_name_type != GEN_OTHERNAME) {
+      if (matcher.matcher().ignore_case()) {
+        compiled->exact_names_ignore_case_[general_name_type].insert(
+            absl::AsciiStrToLower(matcher.matcher().exact()));
+      } else {
+        compiled->exact_names_[general_name_type].insert(matcher.matcher().exact());
+      }
+    } else {
+      SanMatcherPtr san_matcher = createStringSanMatcher(matcher, context);
+      if (san_matcher == nullptr) {
+        return absl::InvalidArgumentError(
+            absl::StrCat("Failed to create string SAN matcher of type ", matcher.san_type()));
+      }
+      compiled->matchers_.push_back(std::move(san_matcher));
+    }
+  }
+  return compiled;
+}
+
+bool CompiledSanMatcher::match(const GENERAL_NAME* general_name) const {
+  if (general_name->type == GEN_DNS) {
+    if (!dns_names_.empty() && matchDns(Utility::generalNameAsString(general_name))) {
+      return true;
+    }
+  } else if (!exact_names_.empty() || !exact_names_ignore_case_.empty()) {
+    const std::string name = Utility::generalNameAsString(general_name);
+    if (const auto it = exact_names_.find(general_name->type);
+        it != exact_names_.end() && it->second.contains(name)) {
+      return true;
+    }
+    if (const auto it = exact_names_ignore_case_.find(general_name->type);
+        it != exact_names_ignore_case_.end() && it->second.contains(absl::AsciiStrToLower(name))) {
+      return true;
+    }
+  }
+  for (const SanMatcherPtr& matcher : matchers_) {
+    if (matcher->match(general_name)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CompiledSanMatcher::matchDns(absl::string_view name) const {
+  const std::string lower_case_name = absl::AsciiStrToLower(name);
+  if (dns_names_.contains(lower_case_name)) {
+    return true;
+  }
+  // A wildcard SAN only matches the names of the domain below its left-most label, see
+  // Utility::dnsNameMatch().
+  const size_t dot = lower_case_name.find('.');
+  if (dot == std::string::npos ||
+      absl::string_view(lower_case_name).substr(0, dot).find('*') == absl::string_view::npos) {
+    return false;
+  }
+  const auto it = dns_names_by_parent_.find(absl::string_view(lower_case_name).substr(dot + 1));
+  if (it == dns_names_by_parent_.end()) {
+    return false;
+  }
+  for (const std::string& dns_name : it->second) {
+    if (Utility::dnsNameMatch(dns_name, lower_case_name)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 } // namespace Tls
 } // namespace TransportSockets
 } // namespace Extensions
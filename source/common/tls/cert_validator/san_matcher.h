@@ -1,6 +1,8 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "envoy/config/core/v3/extension.pb.h"
 #include "envoy/extensions/transport_sockets/tls/v3/common.pb.h"
@@ -12,6 +14,9 @@
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/tls/utility.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
 #include "openssl/x509v3.h"
 
 namespace Envoy {
@@ -71,6 +76,35 @@ SanMatcherPtr createStringSanMatcher(
     const envoy::extensions::transport_sockets::tls::v3::SubjectAltNameMatcher& matcher,
     Server::Configuration::CommonFactoryContext& context);
 
+// A SAN matcher which matches if any of a list of matchers matches. The exact DNS, email, URI and
+// IP address matchers are looked up by name instead of being evaluated one by one, so the cost of
+// matching a name does not grow with the number of configured names. The other matchers are
+// evaluated in order.
+class CompiledSanMatcher : public SanMatcher {
+public:
+  static absl::StatusOr<SanMatcherPtr>
+  create(const std::vector<envoy::extensions::transport_sockets::tls::v3::SubjectAltNameMatcher>&
+             matchers,
+         Server::Configuration::CommonFactoryContext& context);
+
+  bool match(const GENERAL_NAME* general_name) const override;
+
+private:
+  CompiledSanMatcher() = default;
+
+  bool matchDns(absl::string_view name) const;
+
+  // The lower case names of the exact DNS matchers.
+  absl::flat_hash_set<std::string> dns_names_;
+  // The names of the exact DNS matchers by their parent domain, to match wildcard SANs.
+  absl::flat_hash_map<std::string, std::vector<std::string>> dns_names_by_parent_;
+  // The names of the other exact matchers by general name type. The names of matchers which
+  // ignore case are in lower case.
+  absl::flat_hash_map<int, absl::flat_hash_set<std::string>> exact_names_;
+  absl::flat_hash_map<int, absl::flat_hash_set<std::string>> exact_names_ignore_case_;
+  std::vector<SanMatcherPtr> matchers_;
+};
+
 } // namespace Tls
 } // namespace TransportSockets
 } // namespace Extensions
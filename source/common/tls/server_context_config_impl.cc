@@ -160,6 +160,16 @@ ServerContextConfigImpl::ServerContextConfigImpl(
         std::chrono::seconds(DurationUtil::durationToSeconds(config.session_timeout()));
   }
 
+  if (config.has_shared_session_resumption()) {
+    const auto& shared_session_resumption = config.shared_session_resumption();
+    shared_session_resumption_ = SharedSessionResumptionConfig{
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(shared_session_resumption, max_cached_sessions, 20480),
+        std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(
+            shared_session_resumption, ticket_key_rotation_interval, 60 * 60 * 1000)),
+        std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(shared_session_resumption,
+                                                             ticket_key_overlap, 2 * 60 * 60 * 1000))};
+  }
+
   if (config.common_tls_context().has_custom_tls_certificate_selector()) {
     // If a custom tls context provider is configured, derive the factory from the config.
     const auto& provider_config = config.common_tls_context().custom_tls_certificate_selector();
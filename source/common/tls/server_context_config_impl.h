@@ -39,6 +39,9 @@ public:
   bool disableStatefulSessionResumption() const override {
     return disable_stateful_session_resumption_;
   }
+  const absl::optional<SharedSessionResumptionConfig>& sharedSessionResumption() const override {
+    return shared_session_resumption_;
+  }
 
   bool fullScanCertsOnSNIMismatch() const override { return full_scan_certs_on_sni_mismatch_; }
   bool preferClientCiphers() const override { return prefer_client_ciphers_; }
@@ -75,6 +78,7 @@ private:
   absl::optional<std::chrono::seconds> session_timeout_;
   const bool disable_stateless_session_resumption_;
   const bool disable_stateful_session_resumption_;
+  absl::optional<SharedSessionResumptionConfig> shared_session_resumption_;
   bool full_scan_certs_on_sni_mismatch_;
   const bool prefer_client_ciphers_;
 };
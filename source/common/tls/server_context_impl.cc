@@ -27,6 +27,7 @@
 #include "source/common/runtime/runtime_features.h"
 #include "source/common/stats/utility.h"
 #include "source/common/tls/cert_validator/factory.h"
+#include "source/common/tls/session_resumption_manager.h"
 #include "source/common/tls/stats.h"
 #include "source/common/tls/utility.h"
 
@@ -122,6 +123,14 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
   SET_AND_RETURN_IF_NOT_OK(id_or_error.status(), creation_status);
   const SessionContextID& session_id = *id_or_error;
 
+  if (config.sharedSessionResumption().has_value()) {
+    session_resumption_manager_ = SessionResumptionManager::singleton(
+        factory_context.singletonManager(), factory_context.timeSource(),
+        factory_context.serverScope());
+    SET_AND_RETURN_IF_NOT_OK(
+        session_resumption_manager_->configure(*config.sharedSessionResumption()), creation_status);
+  }
+
   // First, configure the base context for ClientHello interception.
   // TODO(htuch): replace with SSL_IDENTITY when we have this as a means to do multi-cert in
   // BoringSSL.
@@ -176,10 +185,16 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
             return server_context_impl->sessionTicketProcess(ssl, key_name, iv, ctx, hmac_ctx,
                                                              encrypt);
           });
+    } else if (session_resumption_manager_ != nullptr &&
+               !config.capabilities().handles_session_resumption) {
+      session_resumption_manager_->installTicketKeys(ctx.ssl_ctx_.get());
     }
 
     if (config.disableStatefulSessionResumption()) {
       SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(), SSL_SESS_CACHE_OFF);
+    } else if (session_resumption_manager_ != nullptr &&
+               !config.capabilities().handles_session_resumption) {
+      session_resumption_manager_->installSessionCache(ctx.ssl_ctx_.get());
     }
 
     if (config.sessionTimeout() && !config.capabilities().handles_session_resumption) {
@@ -0,0 +1,297 @@
+#include "source/common/tls/session_resumption_manager.h"
+
+#include <algorithm>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/macros.h"
+#include "source/common/tls/utility.h"
+
+#include "openssl/evp.h"
+#include "openssl/hmac.h"
+#include "openssl/rand.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+SINGLETON_MANAGER_REGISTRATION(tls_session_resumption_manager);
+
+namespace {
+
+absl::string_view sessionId(const SSL_SESSION* session) {
+  unsigned int length;
+  const uint8_t* id = SSL_SESSION_get_id(session, &length);
+  return {reinterpret_cast<const char*>(id), length};
+}
+
+} // namespace
+
+ShardedSessionCache::ShardedSessionCache(uint32_t max_sessions, SessionResumptionStats& stats)
+    : stats_(stats), cache_(max_sessions) {}
+
+void ShardedSessionCache::insert(bssl::UniquePtr<SSL_SESSION> session) {
+  const absl::string_view id = sessionId(session.get());
+  if (id.empty()) {
+    return;
+  }
+  const auto result = cache_.insert(id, std::move(session));
+  if (result.inserted_) {
+    stats_.cache_insert_.inc();
+    stats_.cache_size_.inc();
+  }
+  if (result.evicted_) {
+    stats_.cache_evicted_.inc();
+    stats_.cache_size_.dec();
+  }
+}
+
+bssl::UniquePtr<SSL_SESSION> ShardedSessionCache::lookup(absl::string_view id) {
+  SSL_SESSION* session = nullptr;
+  if (!cache_.lookup(id, [&session](const bssl::UniquePtr<SSL_SESSION>& cached) {
+        session = cached.get();
+        SSL_SESSION_up_ref(session);
+        return true;
+      })) {
+    stats_.cache_miss_.inc();
+    return nullptr;
+  }
+  stats_.cache_hit_.inc();
+  return bssl::UniquePtr<SSL_SESSION>(session);
+}
+
+void ShardedSessionCache::remove(absl::string_view id) {
+  if (cache_.remove(id)) {
+    stats_.cache_size_.dec();
+  }
+}
+
+std::vector<bssl::UniquePtr<SSL_SESSION>> ShardedSessionCache::sessions() const {
+  std::vector<bssl::UniquePtr<SSL_SESSION>> sessions;
+  cache_.forEach([&sessions](absl::string_view, const bssl::UniquePtr<SSL_SESSION>& session) {
+    SSL_SESSION_up_ref(session.get());
+    sessions.emplace_back(session.get());
+  });
+  return sessions;
+}
+
+SessionResumptionManager::SessionResumptionManager(TimeSource& time_source, Stats::Scope& scope)
+    : time_source_(time_source),
+      stats_({ALL_SESSION_RESUMPTION_STATS(POOL_COUNTER_PREFIX(scope, "tls_session_resumption."),
+                                           POOL_GAUGE_PREFIX(scope, "tls_session_resumption."))}),
+      import_ctx_(SSL_CTX_new(TLS_method())) {}
+
+std::shared_ptr<SessionResumptionManager>
+SessionResumptionManager::singleton(Singleton::Manager& singleton_manager, TimeSource& time_source,
+                                    Stats::Scope& scope) {
+  return singleton_manager.getTyped<SessionResumptionManager>(
+      SINGLETON_MANAGER_REGISTERED_NAME(tls_session_resumption_manager),
+      [&time_source, &scope] {
+        return std::make_shared<SessionResumptionManager>(time_source, scope);
+      },
+      /*pin=*/true);
+}
+
+int SessionResumptionManager::exDataIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, []() -> int {
+    int index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    RELEASE_ASSERT(index >= 0, "");
+    return index;
+  }());
+}
+
+SessionResumptionManager& SessionResumptionManager::fromSslCtx(const SSL_CTX* ctx) {
+  auto* manager = static_cast<SessionResumptionManager*>(SSL_CTX_get_ex_data(ctx, exDataIndex()));
+  RELEASE_ASSERT(manager != nullptr, "");
+  return *manager;
+}
+
+absl::Status SessionResumptionManager::configure(const Config& config) {
+  if (config_.has_value()) {
+    if (!(*config_ == config)) {
+      return absl::InvalidArgumentError(
+          "all TLS contexts with shared_session_resumption must use the same settings");
+    }
+    return absl::OkStatus();
+  }
+  config_ = config;
+  session_cache_ = std::make_unique<ShardedSessionCache>(config.max_cached_sessions_, stats_);
+  applyImportedState();
+  return absl::OkStatus();
+}
+
+void SessionResumptionManager::installSessionCache(SSL_CTX* ctx) {
+  ASSERT(session_cache_ != nullptr);
+  SSL_CTX_set_ex_data(ctx, exDataIndex(), this);
+  // Only the shared cache is used, so that sessions can be resumed with any context which has the
+  // same session ID context.
+  SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+  SSL_CTX_sess_set_new_cb(ctx, [](SSL* ssl, SSL_SESSION* session) -> int {
+    fromSslCtx(SSL_get_SSL_CTX(ssl))
+        .session_cache_->insert(bssl::UniquePtr<SSL_SESSION>(session));
+    return 1; // The cache took over the reference to the session.
+  });
+  SSL_CTX_sess_set_get_cb(
+      ctx, [](SSL* ssl, const uint8_t* id, int id_len, int* out_copy) -> SSL_SESSION* {
+        *out_copy = 0; // The returned reference is passed to the caller.
+        return fromSslCtx(SSL_get_SSL_CTX(ssl))
+            .session_cache_->lookup({reinterpret_cast<const char*>(id), static_cast<size_t>(id_len)})
+            .release();
+      });
+  SSL_CTX_sess_set_remove_cb(ctx, [](SSL_CTX* ctx, SSL_SESSION* session) {
+    fromSslCtx(ctx).session_cache_->remove(sessionId(session));
+  });
+}
+
+void SessionResumptionManager::installTicketKeys(SSL_CTX* ctx) {
+  ASSERT(config_.has_value());
+  SSL_CTX_set_ex_data(ctx, exDataIndex(), this);
+  SSL_CTX_set_tlsext_ticket_key_cb(ctx,
+                                   [](SSL* ssl, uint8_t* key_name, uint8_t* iv,
+                                      EVP_CIPHER_CTX* cipher_ctx, HMAC_CTX* hmac_ctx,
+                                      int encrypt) -> int {
+                                     return fromSslCtx(SSL_get_SSL_CTX(ssl))
+                                         .ticketKeyCallback(key_name, iv, cipher_ctx, hmac_ctx,
+                                                            encrypt);
+                                   });
+}
+
+int SessionResumptionManager::ticketKeyCallback(uint8_t* key_name, uint8_t* iv,
+                                                EVP_CIPHER_CTX* cipher_ctx, HMAC_CTX* hmac_ctx,
+                                                int encrypt) {
+  const EVP_MD* hmac = EVP_sha256();
+  const EVP_CIPHER* cipher = EVP_aes_256_cbc();
+
+  if (encrypt == 1) {
+    const Ssl::ServerContextConfig::SessionTicketKey key = currentTicketKey();
+    std::copy_n(key.name_.begin(), SSL_TICKET_KEY_NAME_LEN, key_name);
+    const int rc = RAND_bytes(iv, EVP_CIPHER_iv_length(cipher));
+    ASSERT(rc);
+    if (!EVP_EncryptInit_ex(cipher_ctx, cipher, nullptr, key.aes_key_.data(), iv) ||
+        !HMAC_Init_ex(hmac_ctx, key.hmac_key_.data(), key.hmac_key_.size(), hmac, nullptr)) {
+      return -1;
+    }
+    return 1;
+  }
+
+  const SystemTime now = time_source_.systemTime();
+  absl::ReaderMutexLock lock(&keys_mutex_);
+  for (size_t i = 0; i < ticket_keys_.size(); ++i) {
+    const auto& [key, created] = ticket_keys_[i];
+    if (!std::equal(key.name_.begin(), key.name_.end(), key_name)) {
+      continue;
+    }
+    // A key which has been replaced is accepted for the overlap after it was replaced.
+    if (i > 0 && now >= ticket_keys_[i - 1].second + config_->ticket_key_overlap_) {
+      break;
+    }
+    if (!HMAC_Init_ex(hmac_ctx, key.hmac_key_.data(), key.hmac_key_.size(), hmac, nullptr) ||
+        !EVP_DecryptInit_ex(cipher_ctx, cipher, nullptr, key.aes_key_.data(), iv)) {
+      return -1;
+    }
+    if (i == 0 && now < created + config_->ticket_key_rotation_interval_) {
+      stats_.ticket_decrypted_.inc();
+      return 1; // Success.
+    }
+    // Renew the ticket with the current key.
+    stats_.ticket_decrypted_with_previous_key_.inc();
+    return 2;
+  }
+  stats_.ticket_key_not_found_.inc();
+  return 0;
+}
+
+Ssl::ServerContextConfig::SessionTicketKey SessionResumptionManager::currentTicketKey() {
+  const SystemTime now = time_source_.systemTime();
+  {
+    absl::ReaderMutexLock lock(&keys_mutex_);
+    if (!ticket_keys_.empty() &&
+        now < ticket_keys_.front().second + config_->ticket_key_rotation_interval_) {
+      return ticket_keys_.front().first;
+    }
+  }
+  absl::MutexLock lock(&keys_mutex_);
+  // Another thread may have rotated the keys in the meantime.
+  if (ticket_keys_.empty() ||
+      now >= ticket_keys_.front().second + config_->ticket_key_rotation_interval_) {
+    rotateTicketKeys(now);
+  }
+  return ticket_keys_.front().first;
+}
+
+void SessionResumptionManager::rotateTicketKeys(SystemTime now) {
+  Ssl::ServerContextConfig::SessionTicketKey key;
+  RELEASE_ASSERT(RAND_bytes(key.name_.data(), key.name_.size()) &&
+                     RAND_bytes(key.hmac_key_.data(), key.hmac_key_.size()) &&
+                     RAND_bytes(key.aes_key_.data(), key.aes_key_.size()),
+                 Utility::getLastCryptoError().value_or(""));
+  ticket_keys_.insert(ticket_keys_.begin(), {key, now});
+  stats_.ticket_key_rotated_.inc();
+
+  // Drop the keys which are past their overlap, i.e. whose successor is older than the overlap.
+  for (size_t i = 1; i < ticket_keys_.size(); ++i) {
+    if (now >= ticket_keys_[i - 1].second + config_->ticket_key_overlap_) {
+      ticket_keys_.resize(i);
+      break;
+    }
+  }
+}
+
+std::vector<SessionResumptionManager::TimedTicketKey> SessionResumptionManager::ticketKeys() const {
+  absl::ReaderMutexLock lock(&keys_mutex_);
+  return ticket_keys_;
+}
+
+std::vector<std::string> SessionResumptionManager::serializedSessions() const {
+  std::vector<std::string> serialized;
+  if (session_cache_ == nullptr) {
+    return serialized;
+  }
+  for (const auto& session : session_cache_->sessions()) {
+    uint8_t* data;
+    size_t length;
+    if (SSL_SESSION_to_bytes(session.get(), &data, &length)) {
+      serialized.emplace_back(reinterpret_cast<const char*>(data), length);
+      OPENSSL_free(data);
+    }
+  }
+  return serialized;
+}
+
+void SessionResumptionManager::importState(std::vector<TimedTicketKey>&& ticket_keys,
+                                           std::vector<std::string>&& sessions) {
+  imported_ticket_keys_ = std::move(ticket_keys);
+  imported_sessions_ = std::move(sessions);
+  if (config_.has_value()) {
+    applyImportedState();
+  }
+}
+
+void SessionResumptionManager::applyImportedState() {
+  if (!imported_ticket_keys_.empty()) {
+    absl::MutexLock lock(&keys_mutex_);
+    stats_.imported_ticket_keys_.add(imported_ticket_keys_.size());
+    ticket_keys_.insert(ticket_keys_.end(), imported_ticket_keys_.begin(),
+                        imported_ticket_keys_.end());
+    std::stable_sort(ticket_keys_.begin(), ticket_keys_.end(),
+                     [](const TimedTicketKey& a, const TimedTicketKey& b) {
+                       return a.second > b.second;
+                     });
+  }
+  for (const std::string& serialized : imported_sessions_) {
+    bssl::UniquePtr<SSL_SESSION> session(
+        SSL_SESSION_from_bytes(reinterpret_cast<const uint8_t*>(serialized.data()),
+                               serialized.size(), import_ctx_.get()));
+    if (session != nullptr) {
+      session_cache_->insert(std::move(session));
+      stats_.imported_sessions_.inc();
+    }
+  }
+  imported_ticket_keys_.clear();
+  imported_sessions_.clear();
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
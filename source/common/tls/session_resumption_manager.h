@@ -0,0 +1,161 @@
+#pragma once
+
+#include <openssl/ssl.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/singleton/manager.h"
+#include "envoy/ssl/context_config.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/common/common/sharded_lru_cache.h"
+
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+#define ALL_SESSION_RESUMPTION_STATS(COUNTER, GAUGE)                                               \
+  COUNTER(cache_evicted)                                                                           \
+  COUNTER(cache_hit)                                                                               \
+  COUNTER(cache_insert)                                                                            \
+  COUNTER(cache_miss)                                                                              \
+  COUNTER(imported_sessions)                                                                       \
+  COUNTER(imported_ticket_keys)                                                                    \
+  COUNTER(ticket_decrypted)                                                                        \
+  COUNTER(ticket_decrypted_with_previous_key)                                                      \
+  COUNTER(ticket_key_not_found)                                                                    \
+  COUNTER(ticket_key_rotated)                                                                      \
+  GAUGE(cache_size, NeverImport)
+
+/**
+ * Wrapper struct for the stats of the shared TLS session resumption. @see stats_macros.h
+ */
+struct SessionResumptionStats {
+  ALL_SESSION_RESUMPTION_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * A bounded TLS session cache, which is split into shards with their own locks so that the
+ * handshakes of all workers can use it concurrently. Each shard evicts its least recently used
+ * sessions when it is full.
+ */
+class ShardedSessionCache {
+public:
+  ShardedSessionCache(uint32_t max_sessions, SessionResumptionStats& stats);
+
+  // Takes ownership of the reference to the session.
+  void insert(bssl::UniquePtr<SSL_SESSION> session);
+  // @return a new reference to the session with the given ID, or nullptr if it isn't cached.
+  bssl::UniquePtr<SSL_SESSION> lookup(absl::string_view id);
+  void remove(absl::string_view id);
+  // @return the cached sessions, least recently used first.
+  std::vector<bssl::UniquePtr<SSL_SESSION>> sessions() const;
+
+  static constexpr uint32_t NumShards = 16;
+
+private:
+  SessionResumptionStats& stats_;
+  ShardedLruCache<bssl::UniquePtr<SSL_SESSION>, NumShards> cache_;
+};
+
+/**
+ * The TLS session cache and session ticket keys shared by all server contexts of the process which
+ * enable shared session resumption, so that sessions can be resumed on any worker and after any
+ * listener update. Session ticket keys are rotated lazily by the handshakes which use them. The
+ * state is handed over to the new process during a hot restart.
+ *
+ * This is a pinned singleton: it is created by the first context which uses it, or by the server
+ * when it imports the state of its hot restart parent, and lives as long as the server. It is
+ * configured and installed into contexts on the main thread, and used by the handshakes of all
+ * threads.
+ */
+class SessionResumptionManager : public Singleton::Instance {
+public:
+  using Config = Ssl::ServerContextConfig::SharedSessionResumptionConfig;
+  using TimedTicketKey = std::pair<Ssl::ServerContextConfig::SessionTicketKey, SystemTime>;
+
+  SessionResumptionManager(TimeSource& time_source, Stats::Scope& scope);
+
+  static std::shared_ptr<SessionResumptionManager>
+  singleton(Singleton::Manager& singleton_manager, TimeSource& time_source, Stats::Scope& scope);
+
+  /**
+   * Sets up the shared state for the given settings, or checks that they are the settings the
+   * state was set up with by another context.
+   */
+  absl::Status configure(const Config& config);
+
+  /**
+   * Makes the server context use the shared session cache.
+   */
+  void installSessionCache(SSL_CTX* ctx);
+
+  /**
+   * Makes the server context encrypt and decrypt session tickets with the shared keys.
+   */
+  void installTicketKeys(SSL_CTX* ctx);
+
+  /**
+   * @return the current session ticket keys, newest first, for handing them over to a hot restart
+   *         child.
+   */
+  std::vector<TimedTicketKey> ticketKeys() const;
+
+  /**
+   * @return the cached sessions, serialized, for handing them over to a hot restart child.
+   */
+  std::vector<std::string> serializedSessions() const;
+
+  /**
+   * Imports the ticket keys and sessions of the hot restart parent. They are used once the state
+   * is configured.
+   */
+  void importState(std::vector<TimedTicketKey>&& ticket_keys, std::vector<std::string>&& sessions);
+
+  const SessionResumptionStats& stats() const { return stats_; }
+
+private:
+  static int exDataIndex();
+  static SessionResumptionManager& fromSslCtx(const SSL_CTX* ctx);
+
+  int ticketKeyCallback(uint8_t* key_name, uint8_t* iv, EVP_CIPHER_CTX* cipher_ctx,
+                        HMAC_CTX* hmac_ctx, int encrypt);
+  // Rotates the keys if the newest one is too old to encrypt tickets, and drops expired keys.
+  Ssl::ServerContextConfig::SessionTicketKey currentTicketKey();
+  void rotateTicketKeys(SystemTime now) ABSL_EXCLUSIVE_LOCKS_REQUIRED(keys_mutex_);
+  void applyImportedState();
+
+  TimeSource& time_source_;
+  SessionResumptionStats stats_;
+  absl::optional<Config> config_;
+  std::unique_ptr<ShardedSessionCache> session_cache_;
+  // Only used to parse imported sessions.
+  bssl::UniquePtr<SSL_CTX> import_ctx_;
+
+  mutable absl::Mutex keys_mutex_;
+  // Newest first.
+  std::vector<TimedTicketKey> ticket_keys_ ABSL_GUARDED_BY(keys_mutex_);
+
+  // The state of the hot restart parent until the state is configured. Only used on the main
+  // thread.
+  std::vector<TimedTicketKey> imported_ticket_keys_;
+  std::vector<std::string> imported_sessions_;
+};
+
+using SessionResumptionManagerSharedPtr = std::shared_ptr<SessionResumptionManager>;
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
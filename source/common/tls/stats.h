@@ -21,6 +21,8 @@ namespace Tls {
   COUNTER(ocsp_staple_omitted)                                                                     \
   COUNTER(ocsp_staple_responses)                                                                   \
   COUNTER(ocsp_staple_requests)                                                                    \
+  COUNTER(verify_cache_hit)                                                                        \
+  COUNTER(verify_cache_miss)                                                                       \
   COUNTER(was_key_usage_invalid)
 
 /**
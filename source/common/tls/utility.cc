@@ -500,6 +500,18 @@ SystemTime Utility::getExpirationTime(const X509& cert) {
   return std::chrono::system_clock::from_time_t(static_cast<time_t>(days) * 24 * 60 * 60 + seconds);
 }
 
+absl::optional<SystemTime> Utility::getNextUpdateTime(const X509_CRL& crl) {
+  const ASN1_TIME* next_update = X509_CRL_get0_nextUpdate(&crl);
+  if (next_update == nullptr) {
+    return absl::nullopt;
+  }
+  int days, seconds;
+  if (ASN1_TIME_diff(&days, &seconds, &epochASN1Time(), next_update) != 1) {
+    return absl::nullopt;
+  }
+  return std::chrono::system_clock::from_time_t(static_cast<time_t>(days) * 24 * 60 * 60 + seconds);
+}
+
 absl::optional<std::string> Utility::getLastCryptoError() {
   auto err = ERR_get_error();
 
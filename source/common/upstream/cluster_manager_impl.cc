@@ -327,8 +327,10 @@ ClusterManagerImpl::ClusterManagerImpl(
     Router::Context& router_context, Server::Instance& server, Config::XdsManager& xds_manager,
     absl::Status& creation_status)
     : server_(server), factory_(factory), runtime_(runtime), stats_(stats), tls_(tls),
-      xds_manager_(xds_manager), random_(api.randomGenerator()),
+      xds_manager_(xds_manager), api_(api), random_(api.randomGenerator()),
       deferred_cluster_creation_(bootstrap.cluster_manager().enable_deferred_cluster_creation()),
+      deferred_cluster_idle_timeout_(PROTOBUF_GET_MS_OR_DEFAULT(bootstrap.cluster_manager(),
+                                                                deferred_cluster_idle_timeout, 0)),
       bind_config_(bootstrap.cluster_manager().has_upstream_bind_config()
                        ? absl::make_optional(bootstrap.cluster_manager().upstream_bind_config())
                        : absl::nullopt),
@@ -480,9 +482,10 @@ ClusterManagerImpl::initialize(const envoy::config::bootstrap::v3::Bootstrap& bo
                                      primary_client, failover_client));
       ads_mux_ =
           factory->create(std::move(primary_client), std::move(failover_client), dispatcher_,
-                          random_, *stats_.rootScope(), dyn_resources.ads_config(), local_info_,
-                          std::move(custom_config_validators), std::move(backoff_strategy),
-                          xds_manager_.xdsConfigTracker(), {}, use_eds_cache);
+                          api_, random_, *stats_.rootScope(), dyn_resources.ads_config(),
+                          local_info_, std::move(custom_config_validators),
+                          std::move(backoff_strategy), xds_manager_.xdsConfigTracker(), {},
+                          use_eds_cache);
     } else {
       absl::Status status = Config::Utility::checkTransportVersion(dyn_resources.ads_config());
       RETURN_IF_NOT_OK(status);
@@ -512,7 +515,7 @@ ClusterManagerImpl::initialize(const envoy::config::bootstrap::v3::Bootstrap& bo
       RETURN_IF_NOT_OK(createClients(factory_primary_or_error.value(), factory_failover,
                                      primary_client, failover_client));
       ads_mux_ = factory->create(std::move(primary_client), std::move(failover_client), dispatcher_,
-                                 random_, *stats_.rootScope(), dyn_resources.ads_config(),
+                                 api_, random_, *stats_.rootScope(), dyn_resources.ads_config(),
                                  local_info_, std::move(custom_config_validators),
                                  std::move(backoff_strategy), xds_manager_.xdsConfigTracker(),
                                  xds_manager_.xdsResourcesDelegate(), use_eds_cache);
@@ -707,7 +710,8 @@ ThreadLocalClusterManagerStats
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::generateStats(Stats::Scope& scope,
                                                                  const std::string& thread_name) {
   const std::string final_prefix = absl::StrCat("thread_local_cluster_manager.", thread_name);
-  return {ALL_THREAD_LOCAL_CLUSTER_MANAGER_STATS(POOL_GAUGE_PREFIX(scope, final_prefix))};
+  return {ALL_THREAD_LOCAL_CLUSTER_MANAGER_STATS(POOL_COUNTER_PREFIX(scope, final_prefix),
+                                                 POOL_GAUGE_PREFIX(scope, final_prefix))};
 }
 
 absl::Status ClusterManagerImpl::onClusterInit(ClusterManagerCluster& cm_cluster) {
@@ -1001,8 +1005,7 @@ bool ClusterManagerImpl::removeCluster(const std::string& cluster_name, const bo
       }
       cluster_manager->thread_local_clusters_.erase(cluster_name);
       cluster_manager->thread_local_deferred_clusters_.erase(cluster_name);
-      cluster_manager->local_stats_.clusters_inflated_.set(
-          cluster_manager->thread_local_clusters_.size());
+      cluster_manager->updateClusterCountStats();
     });
     cluster_initialization_map_.erase(cluster_name);
   }
@@ -1151,6 +1154,7 @@ ThreadLocalCluster* ClusterManagerImpl::getThreadLocalCluster(absl::string_view
 
   auto entry = cluster_manager.thread_local_clusters_.find(cluster);
   if (entry != cluster_manager.thread_local_clusters_.end()) {
+    entry->second->used_ = true;
     return entry->second.get();
   } else {
     return cluster_manager.initializeClusterInlineIfExists(cluster);
@@ -1379,30 +1383,10 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(ClusterManagerCluster& cm_
       ENVOY_LOG(debug, "Deferring add or update for TLS cluster {}", info->name());
       cluster_manager->thread_local_deferred_clusters_[info->name()] =
           cluster_initialization_object;
+      cluster_manager->updateClusterCountStats();
 
       // Invoke similar logic of onClusterAddOrUpdate.
-      ThreadLocalClusterCommand command = [&cluster_manager,
-                                           cluster_name = info->name()]() -> ThreadLocalCluster& {
-        // If we have multiple callbacks only the first one needs to use the
-        // command to initialize the cluster.
-        auto existing_cluster_entry = cluster_manager->thread_local_clusters_.find(cluster_name);
-        if (existing_cluster_entry != cluster_manager->thread_local_clusters_.end()) {
-          return *existing_cluster_entry->second;
-        }
-
-        auto* cluster_entry = cluster_manager->initializeClusterInlineIfExists(cluster_name);
-        ASSERT(cluster_entry != nullptr, "Deferred clusters initiailization should not fail.");
-        return *cluster_entry;
-      };
-      for (auto cb_it = cluster_manager->update_callbacks_.begin();
-           cb_it != cluster_manager->update_callbacks_.end();) {
-        // The current callback may remove itself from the list, so a handle for
-        // the next item is fetched before calling the callback.
-        auto curr_cb_it = cb_it;
-        ++cb_it;
-        (*curr_cb_it)->onClusterAddOrUpdate(info->name(), command);
-      }
-
+      cluster_manager->notifyDeferredClusterAddOrUpdate(info->name());
     } else {
       // Broadcast
       ThreadLocalClusterManagerImpl::ClusterEntry* new_cluster = nullptr;
@@ -1416,13 +1400,16 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(ClusterManagerCluster& cm_
         new_cluster = new ThreadLocalClusterManagerImpl::ClusterEntry(*cluster_manager, info,
                                                                       load_balancer_factory);
         cluster_manager->thread_local_clusters_[info->name()].reset(new_cluster);
-        cluster_manager->local_stats_.clusters_inflated_.set(
-            cluster_manager->thread_local_clusters_.size());
+        cluster_manager->updateClusterCountStats();
       }
 
       if (cluster_manager->thread_local_clusters_[info->name()]) {
         cluster_manager->thread_local_clusters_[info->name()]->setDropOverload(drop_overload);
         cluster_manager->thread_local_clusters_[info->name()]->setDropCategory(drop_category);
+        if (cluster_initialization_object != nullptr) {
+          cluster_manager->thread_local_clusters_[info->name()]->initialization_object_ =
+              cluster_initialization_object;
+        }
       }
       for (const auto& per_priority : params.per_priority_update_params_) {
         cluster_manager->updateClusterMembership(
@@ -1433,6 +1420,7 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(ClusterManagerCluster& cm_
 
       if (new_cluster != nullptr) {
         ThreadLocalClusterCommand command = [&new_cluster]() -> ThreadLocalCluster& {
+          new_cluster->pinned_ = true;
           return *new_cluster;
         };
         for (auto cb_it = cluster_manager->update_callbacks_.begin();
@@ -1519,7 +1507,6 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::initializeClusterInlineIfExis
   ClusterEntry* cluster_entry_ptr = cluster_entry.get();
 
   thread_local_clusters_[cluster] = std::move(cluster_entry);
-  local_stats_.clusters_inflated_.set(thread_local_clusters_.size());
 
   for (const auto& [_, per_priority] : initialization_object->per_priority_state_) {
     updateClusterMembership(initialization_object->cluster_info_->name(), per_priority.priority_,
@@ -1529,15 +1516,71 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::initializeClusterInlineIfExis
                             per_priority.overprovisioning_factor_,
                             initialization_object->cross_priority_host_map_);
   }
-  thread_local_clusters_[cluster]->setDropOverload(initialization_object->drop_overload_);
-  thread_local_clusters_[cluster]->setDropCategory(initialization_object->drop_category_);
+  cluster_entry_ptr->setDropOverload(initialization_object->drop_overload_);
+  cluster_entry_ptr->setDropCategory(initialization_object->drop_category_);
+  // The cluster is initialized because it is about to be used.
+  cluster_entry_ptr->used_ = true;
 
-  // Remove the CIO as we've initialized the cluster.
+  // Move the CIO to the cluster as we've initialized it, it's needed to reclaim the cluster.
+  cluster_entry_ptr->initialization_object_ = std::move(entry->second);
   thread_local_deferred_clusters_.erase(entry);
+  updateClusterCountStats();
 
   return cluster_entry_ptr;
 }
 
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::notifyDeferredClusterAddOrUpdate(
+    const std::string& cluster_name) {
+  ThreadLocalClusterCommand command = [this, &cluster_name]() -> ThreadLocalCluster& {
+    // If we have multiple callbacks only the first one needs to use the
+    // command to initialize the cluster.
+    ClusterEntry* cluster_entry;
+    auto existing_cluster_entry = thread_local_clusters_.find(cluster_name);
+    if (existing_cluster_entry != thread_local_clusters_.end()) {
+      cluster_entry = existing_cluster_entry->second.get();
+    } else {
+      cluster_entry = initializeClusterInlineIfExists(cluster_name);
+      ASSERT(cluster_entry != nullptr, "Deferred clusters initiailization should not fail.");
+    }
+    cluster_entry->pinned_ = true;
+    return *cluster_entry;
+  };
+  for (auto cb_it = update_callbacks_.begin(); cb_it != update_callbacks_.end();) {
+    // The current callback may remove itself from the list, so a handle for
+    // the next item is fetched before calling the callback.
+    auto curr_cb_it = cb_it;
+    ++cb_it;
+    (*curr_cb_it)->onClusterAddOrUpdate(cluster_name, command);
+  }
+}
+
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::reclaimIdleClusters() {
+  std::vector<std::string> idle_clusters;
+  for (auto& [name, cluster_entry] : thread_local_clusters_) {
+    if (&cluster_entry->prioritySet() != local_priority_set_ && cluster_entry->reclaimable()) {
+      idle_clusters.push_back(name);
+    }
+    cluster_entry->used_ = false;
+  }
+
+  for (const std::string& name : idle_clusters) {
+    auto entry = thread_local_clusters_.find(name);
+    ENVOY_LOG(debug, "reclaiming idle TLS cluster {}", name);
+    thread_local_deferred_clusters_[name] = std::move(entry->second->initialization_object_);
+    // The entry may still be referred to by the current call stack.
+    entry->second->reclaimed_ = true;
+    thread_local_dispatcher_.deferredDelete(std::move(entry->second));
+    thread_local_clusters_.erase(entry);
+    local_stats_.clusters_reclaimed_.inc();
+  }
+  updateClusterCountStats();
+}
+
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::updateClusterCountStats() {
+  local_stats_.clusters_inflated_.set(thread_local_clusters_.size());
+  local_stats_.clusters_deferred_.set(thread_local_deferred_clusters_.size());
+}
+
 ClusterManagerImpl::ClusterInitializationObject::ClusterInitializationObject(
     const ThreadLocalClusterUpdateParams& params, ClusterInfoConstSharedPtr cluster_info,
     LoadBalancerFactorySharedPtr load_balancer_factory, HostMapConstSharedPtr map,
@@ -1907,7 +1950,16 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ThreadLocalClusterManagerImpl
     thread_local_clusters_[local_cluster_name] = std::make_unique<ClusterEntry>(
         *this, local_cluster_params->info_, local_cluster_params->load_balancer_factory_);
     local_priority_set_ = &thread_local_clusters_[local_cluster_name]->prioritySet();
-    local_stats_.clusters_inflated_.set(thread_local_clusters_.size());
+    updateClusterCountStats();
+  }
+  // Clusters are only deferred on worker threads.
+  if (parent_.deferred_cluster_creation_ && parent_.deferred_cluster_idle_timeout_.count() > 0 &&
+      !Envoy::Thread::MainThread::isMainThread()) {
+    idle_cluster_timer_ = dispatcher.createTimer([this]() {
+      reclaimIdleClusters();
+      idle_cluster_timer_->enableTimer(parent_.deferred_cluster_idle_timeout_);
+    });
+    idle_cluster_timer_->enableTimer(parent_.deferred_cluster_idle_timeout_);
   }
 }
 
@@ -1926,6 +1978,8 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::~ThreadLocalClusterManagerImp
       cluster.second.reset();
     }
   }
+  // Reclaimed clusters pending deletion may also be registered with the local cluster.
+  thread_local_dispatcher_.clearDeferredDeleteList();
   thread_local_clusters_.clear();
 
   // Ensure that all pools are completely destructed.
@@ -2095,6 +2149,25 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::drainOrCloseConnPools(
   }
 }
 
+bool ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::reclaimable() const {
+  if (used_ || pinned_ || initialization_object_ == nullptr ||
+      lazy_http_async_client_ != nullptr) {
+    return false;
+  }
+  // Connection pools and connections outlive the cluster entry, but destroying the entry drains
+  // them. Clusters with connections to their hosts are thus kept.
+  for (const auto& host_set : priority_set_.hostSetsPerPriority()) {
+    for (const HostSharedPtr& host : host_set->hosts()) {
+      if (parent_.host_http_conn_pool_map_.contains(host) ||
+          parent_.host_tcp_conn_pool_map_.contains(host) ||
+          parent_.host_tcp_conn_map_.contains(host)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::~ClusterEntry() {
   // We need to drain all connection pools for the cluster being removed. Then we can remove the
   // cluster.
@@ -2102,7 +2175,12 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::~ClusterEntry()
   // TODO(mattklein123): Optimally, we would just fire member changed callbacks and remove all of
   // the hosts inside of the HostImpl destructor. That is a change with wide implications, so we
   // are going with a more targeted approach for now.
-  drainConnPools();
+  //
+  // A reclaimed entry had no connection pools, and the pools of its hosts created since then are
+  // used by the entry which replaced it.
+  if (!reclaimed_) {
+    drainConnPools();
+  }
 }
 
 Http::ConnectionPool::Instance*
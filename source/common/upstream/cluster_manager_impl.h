@@ -17,6 +17,7 @@
 #include "envoy/config/core/v3/address.pb.h"
 #include "envoy/config/core/v3/config_source.pb.h"
 #include "envoy/config/xds_resources_delegate.h"
+#include "envoy/event/deferred_deletable.h"
 #include "envoy/http/codes.h"
 #include "envoy/local_info/local_info.h"
 #include "envoy/router/context.h"
@@ -227,13 +228,16 @@ struct ClusterManagerStats {
 /**
  * All thread local cluster manager stats. @see stats_macros.h
  */
-#define ALL_THREAD_LOCAL_CLUSTER_MANAGER_STATS(GAUGE) GAUGE(clusters_inflated, NeverImport)
+#define ALL_THREAD_LOCAL_CLUSTER_MANAGER_STATS(COUNTER, GAUGE)                                     \
+  COUNTER(clusters_reclaimed)                                                                      \
+  GAUGE(clusters_deferred, NeverImport)                                                            \
+  GAUGE(clusters_inflated, NeverImport)
 
 /**
  * Struct definition for all cluster manager stats. @see stats_macros.h
  */
 struct ThreadLocalClusterManagerStats {
-  ALL_THREAD_LOCAL_CLUSTER_MANAGER_STATS(GENERATE_GAUGE_STRUCT)
+  ALL_THREAD_LOCAL_CLUSTER_MANAGER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
 };
 
 /**
@@ -284,6 +288,14 @@ public:
     return clusters_maps;
   }
 
+  ClusterConstOptRef getActiveCluster(const std::string& cluster_name) const override {
+    auto cluster = active_clusters_.find(cluster_name);
+    if (cluster == active_clusters_.end()) {
+      return absl::nullopt;
+    }
+    return *cluster->second->cluster_;
+  }
+
   const ClusterSet& primaryClusters() override { return primary_clusters_; }
   ThreadLocalCluster* getThreadLocalCluster(absl::string_view cluster) override;
 
@@ -576,7 +588,7 @@ private:
           connections_;
     };
 
-    class ClusterEntry : public ThreadLocalCluster {
+    class ClusterEntry : public ThreadLocalCluster, public Event::DeferredDeletable {
     public:
       ClusterEntry(ThreadLocalClusterManagerImpl& parent, ClusterInfoConstSharedPtr cluster,
                    const LoadBalancerFactorySharedPtr& lb_factory);
@@ -625,6 +637,21 @@ private:
         drop_category_ = drop_category;
       }
 
+      // Whether the entry can be destroyed and returned to the deferred state, as it was not used
+      // since the last call and nothing else refers to it.
+      bool reclaimable() const;
+
+      // The latest initialization object of the cluster, used to return the entry to the deferred
+      // state. Only set if deferred cluster creation is supported for the cluster.
+      ClusterInitializationObjectConstSharedPtr initialization_object_;
+      // Set whenever the entry is looked up, and cleared when checking for idle entries.
+      bool used_{};
+      // Set once the entry has been handed to cluster update callbacks, which may keep referring
+      // to it. Such entries are not reclaimed.
+      bool pinned_{};
+      // Set once the entry has been reclaimed, until its deferred deletion.
+      bool reclaimed_{};
+
     private:
       Http::ConnectionPool::Instance*
       httpConnPoolImpl(HostConstSharedPtr host, ResourcePriority priority,
@@ -714,6 +741,19 @@ private:
      */
     ClusterEntry* initializeClusterInlineIfExists(absl::string_view cluster);
 
+    /**
+     * Notifies the cluster update callbacks of a cluster that was deferred, handing them a command
+     * that initializes the cluster once it is invoked.
+     */
+    void notifyDeferredClusterAddOrUpdate(const std::string& cluster_name);
+
+    /**
+     * Returns the clusters that have not been used since the previous call to the deferred state.
+     */
+    void reclaimIdleClusters();
+
+    void updateClusterCountStats();
+
     OptRef<Quic::EnvoyQuicNetworkObserverRegistry> getNetworkObserverRegistry() {
       return makeOptRefFromPtr(network_observer_registry_.get());
     }
@@ -747,6 +787,8 @@ private:
     bool destroying_{};
     ClusterDiscoveryManager cdm_;
     ThreadLocalClusterManagerStats local_stats_;
+    // Only set on worker threads if idle clusters are reclaimed.
+    Event::TimerPtr idle_cluster_timer_;
 
   private:
     static ThreadLocalClusterManagerStats generateStats(Stats::Scope& scope,
@@ -917,8 +959,11 @@ private:
   // Contains information about ongoing on-demand cluster discoveries.
   ClusterCreationsMap pending_cluster_creations_;
   Config::XdsManager& xds_manager_;
+  Api::Api& api_;
   Random::RandomGenerator& random_;
   const bool deferred_cluster_creation_;
+  // Zero if idle clusters are not reclaimed.
+  const std::chrono::milliseconds deferred_cluster_idle_timeout_;
   absl::optional<envoy::config::core::v3::BindConfig> bind_config_;
   Outlier::EventLoggerSharedPtr outlier_event_logger_;
   const LocalInfo::LocalInfo& local_info_;
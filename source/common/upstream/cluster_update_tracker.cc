@@ -4,12 +4,20 @@ namespace Envoy {
 namespace Upstream {
 
 ClusterUpdateTracker::ClusterUpdateTracker(ClusterManager& cm, const std::string& cluster_name)
-    : cluster_name_(cluster_name),
-      cluster_update_callbacks_handle_(cm.addThreadLocalClusterUpdateCallbacks(*this)) {
-  Upstream::ThreadLocalCluster* cluster = cm.getThreadLocalCluster(cluster_name_);
-  if (cluster != nullptr) {
-    thread_local_cluster_ = *cluster;
+    : cm_(cm), cluster_name_(cluster_name),
+      cluster_update_callbacks_handle_(cm.addThreadLocalClusterUpdateCallbacks(*this)) {}
+
+ThreadLocalClusterOptRef ClusterUpdateTracker::threadLocalCluster() {
+  if (thread_local_cluster_.has_value() || removed_) {
+    return thread_local_cluster_;
+  }
+  // A cluster which was looked up, rather than handed to the callbacks, may be reclaimed once it
+  // is idle, so it isn't cached.
+  ThreadLocalCluster* cluster = cm_.getThreadLocalCluster(cluster_name_);
+  if (cluster == nullptr) {
+    return absl::nullopt;
   }
+  return *cluster;
 }
 
 void ClusterUpdateTracker::onClusterAddOrUpdate(absl::string_view cluster_name,
@@ -18,6 +26,7 @@ void ClusterUpdateTracker::onClusterAddOrUpdate(absl::string_view cluster_name,
     return;
   }
   thread_local_cluster_ = get_cluster();
+  removed_ = false;
 }
 
 void ClusterUpdateTracker::onClusterRemoval(const std::string& cluster) {
@@ -25,6 +34,7 @@ void ClusterUpdateTracker::onClusterRemoval(const std::string& cluster) {
     return;
   }
   thread_local_cluster_.reset();
+  removed_ = true;
 }
 
 } // namespace Upstream
@@ -9,12 +9,14 @@ namespace Upstream {
  * Keeps track of cluster updates in order to spot addition and removal.
  *
  * Use this class as a performance optimization to avoid going through ClusterManager::get()
- * on the hot path.
+ * on the hot path. The cluster is only cached once it was handed to the update callbacks, which
+ * keeps it from being reclaimed while idle. Until then, it is looked up on each call, unless it
+ * was removed.
  */
 class ClusterUpdateTracker : public ClusterUpdateCallbacks {
 public:
   ClusterUpdateTracker(ClusterManager& cm, const std::string& cluster_name);
-  ThreadLocalClusterOptRef threadLocalCluster() { return thread_local_cluster_; };
+  ThreadLocalClusterOptRef threadLocalCluster();
 
   // ClusterUpdateCallbacks
   void onClusterAddOrUpdate(absl::string_view cluster_name,
@@ -22,10 +24,13 @@ public:
   void onClusterRemoval(const std::string& cluster) override;
 
 private:
+  ClusterManager& cm_;
   const std::string cluster_name_;
   const ClusterUpdateCallbacksHandlePtr cluster_update_callbacks_handle_;
 
   ThreadLocalClusterOptRef thread_local_cluster_;
+  // Set once the cluster was removed, until it is added again.
+  bool removed_{};
 };
 
 } // namespace Upstream
@@ -338,6 +338,10 @@ void DetectorImpl::initialize(Cluster& cluster) {
 
           host_monitors_.erase(host);
         }
+
+        if (!hosts_added.empty() || !hosts_removed.empty()) {
+          host_list_stale_ = true;
+        }
         return absl::OkStatus();
       });
 
@@ -613,9 +617,32 @@ void DetectorImpl::onConsecutiveErrorWorker(HostSharedPtr host,
   }
 }
 
-DetectorImpl::EjectionPair DetectorImpl::successRateEjectionThreshold(
-    double success_rate_sum, const std::vector<HostSuccessRatePair>& valid_success_rate_hosts,
-    double success_rate_stdev_factor) {
+namespace {
+
+// Sums f(value) over the values of a column. The additions are spread over independent partial
+// sums, which removes the dependency of each addition on the previous one so that the compiler can
+// pipeline and vectorize them without reassociating a single chain of floating point additions.
+template <class F> double sumColumn(absl::Span<const double> column, F f) {
+  constexpr size_t Lanes = 4;
+  double partial[Lanes] = {};
+  const size_t size = column.size();
+  size_t i = 0;
+  for (; i + Lanes <= size; i += Lanes) {
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+      partial[lane] += f(column[i + lane]);
+    }
+  }
+  for (; i < size; ++i) {
+    partial[i % Lanes] += f(column[i]);
+  }
+  return (partial[0] + partial[1]) + (partial[2] + partial[3]);
+}
+
+} // namespace
+
+DetectorImpl::EjectionPair
+DetectorImpl::successRateEjectionThreshold(absl::Span<const double> success_rates,
+                                           double success_rate_stdev_factor) {
   // This function is using mean and standard deviation as statistical measures for outlier
   // detection. First the mean is calculated by dividing the sum of success rate data over the
   // number of data points. Then variance is calculated by taking the mean of the
@@ -631,18 +658,32 @@ DetectorImpl::EjectionPair DetectorImpl::successRateEjectionThreshold(
   // variance = 400
   // stdev = 20
   // threshold returned = 52
-  double mean = success_rate_sum / valid_success_rate_hosts.size();
-  double variance = 0;
-  std::for_each(valid_success_rate_hosts.begin(), valid_success_rate_hosts.end(),
-                [&variance, mean](HostSuccessRatePair v) {
-                  variance += std::pow(v.success_rate_ - mean, 2);
-                });
-  variance /= valid_success_rate_hosts.size();
-  double stdev = std::sqrt(variance);
+  ASSERT(!success_rates.empty());
+  const double mean =
+      sumColumn(success_rates, [](double v) { return v; }) / success_rates.size();
+  const double variance = sumColumn(success_rates,
+                                    [mean](double v) {
+                                      const double diff = v - mean;
+                                      return diff * diff;
+                                    }) /
+                          success_rates.size();
+  const double stdev = std::sqrt(variance);
 
   return {mean, (mean - (success_rate_stdev_factor * stdev))};
 }
 
+void DetectorImpl::refreshHostList() {
+  if (!host_list_stale_) {
+    return;
+  }
+  host_list_.clear();
+  host_list_.reserve(host_monitors_.size());
+  for (const auto& host : host_monitors_) {
+    host_list_.emplace_back(host.first, host.second);
+  }
+  host_list_stale_ = false;
+}
+
 void DetectorImpl::processSuccessRateEjections(
     DetectorHostMonitor::SuccessRateMonitorType monitor_type) {
   uint64_t success_rate_minimum_hosts = runtime_.snapshot().getInteger(
@@ -654,81 +695,95 @@ void DetectorImpl::processSuccessRateEjections(
   uint64_t failure_percentage_request_volume = runtime_.snapshot().getInteger(
       FailurePercentageRequestVolumeRuntime, config_.failurePercentageRequestVolume());
 
-  std::vector<HostSuccessRatePair> valid_success_rate_hosts;
-  std::vector<HostSuccessRatePair> valid_failure_percentage_hosts;
-  double success_rate_sum = 0;
-
   // Reset the Detector's success rate mean and stdev.
   getSRNums(monitor_type) = {-1, -1};
 
   // Exit early if there are not enough hosts.
-  if (host_monitors_.size() < success_rate_minimum_hosts &&
-      host_monitors_.size() < failure_percentage_minimum_hosts) {
+  if (host_list_.size() < success_rate_minimum_hosts &&
+      host_list_.size() < failure_percentage_minimum_hosts) {
     return;
   }
 
-  // reserve upper bound of vector size to avoid reallocation.
-  valid_success_rate_hosts.reserve(host_monitors_.size());
-  valid_failure_percentage_hosts.reserve(host_monitors_.size());
-
-  for (const auto& host : host_monitors_) {
+  // Flush the counts of the last window of the hosts which are not ejected, and which received
+  // requests, into the columns.
+  SuccessRateColumns& columns = success_rate_columns_;
+  columns.clear();
+  for (uint32_t i = 0; i < host_list_.size(); ++i) {
+    const auto& [host, monitor] = host_list_[i];
     // Don't do work if the host is already ejected.
-    if (!host.first->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK)) {
-      absl::optional<std::pair<double, uint64_t>> host_success_rate_and_volume =
-          host.second->getSRMonitor(monitor_type)
-              .successRateAccumulator()
-              .getSuccessRateAndVolume();
-
-      if (!host_success_rate_and_volume) {
-        continue;
-      }
-      double success_rate = host_success_rate_and_volume.value().first;
-      double request_volume = host_success_rate_and_volume.value().second;
+    if (host->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK)) {
+      continue;
+    }
+    const auto [success, total] =
+        monitor->getSRMonitor(monitor_type).successRateAccumulator().lastWindowCounts();
+    if (total == 0) {
+      continue;
+    }
+    columns.host_index_.push_back(i);
+    columns.request_volume_.push_back(total);
+    columns.success_rate_.push_back(success);
+  }
 
-      if (request_volume >=
-          std::min(success_rate_request_volume, failure_percentage_request_volume)) {
-        host.second->successRate(monitor_type, success_rate);
-      }
+  const size_t size = columns.size();
+  const uint64_t* request_volume = columns.request_volume_.data();
+  double* success_rate = columns.success_rate_.data();
+  for (size_t i = 0; i < size; ++i) {
+    success_rate[i] = success_rate[i] * 100.0 / request_volume[i];
+  }
 
-      if (request_volume >= success_rate_request_volume) {
-        valid_success_rate_hosts.emplace_back(HostSuccessRatePair(host.first, success_rate));
-        success_rate_sum += success_rate;
-      }
-      if (request_volume >= failure_percentage_request_volume) {
-        valid_failure_percentage_hosts.emplace_back(HostSuccessRatePair(host.first, success_rate));
-      }
+  const uint64_t minimum_request_volume =
+      std::min(success_rate_request_volume, failure_percentage_request_volume);
+  for (size_t i = 0; i < size; ++i) {
+    if (request_volume[i] >= minimum_request_volume) {
+      host_list_[columns.host_index_[i]].second->successRate(monitor_type, success_rate[i]);
     }
   }
 
-  if (!valid_success_rate_hosts.empty() &&
-      valid_success_rate_hosts.size() >= success_rate_minimum_hosts) {
+  // Compact the hosts with enough requests for success rate ejection without branching: every host
+  // is written, and the write position only advances past the valid ones.
+  columns.valid_host_index_.resize(size);
+  columns.valid_success_rate_.resize(size);
+  size_t valid_success_rate_hosts = 0;
+  for (size_t i = 0; i < size; ++i) {
+    columns.valid_host_index_[valid_success_rate_hosts] = columns.host_index_[i];
+    columns.valid_success_rate_[valid_success_rate_hosts] = success_rate[i];
+    valid_success_rate_hosts += request_volume[i] >= success_rate_request_volume;
+  }
+
+  if (valid_success_rate_hosts > 0 && valid_success_rate_hosts >= success_rate_minimum_hosts) {
     const double success_rate_stdev_factor =
         runtime_.snapshot().getInteger(SuccessRateStdevFactorRuntime,
                                        config_.successRateStdevFactor()) /
         1000.0;
     getSRNums(monitor_type) = successRateEjectionThreshold(
-        success_rate_sum, valid_success_rate_hosts, success_rate_stdev_factor);
+        absl::MakeConstSpan(columns.valid_success_rate_.data(), valid_success_rate_hosts),
+        success_rate_stdev_factor);
     const double success_rate_ejection_threshold = getSRNums(monitor_type).ejection_threshold_;
-    for (const auto& host_success_rate_pair : valid_success_rate_hosts) {
-      if (host_success_rate_pair.success_rate_ < success_rate_ejection_threshold) {
+    for (size_t i = 0; i < valid_success_rate_hosts; ++i) {
+      if (columns.valid_success_rate_[i] < success_rate_ejection_threshold) {
         stats_.ejections_success_rate_.inc(); // Deprecated.
+        const auto& [host, monitor] = host_list_[columns.valid_host_index_[i]];
         const envoy::data::cluster::v3::OutlierEjectionType type =
-            host_monitors_[host_success_rate_pair.host_]
-                ->getSRMonitor(monitor_type)
-                .getEjectionType();
+            monitor->getSRMonitor(monitor_type).getEjectionType();
         updateDetectedEjectionStats(type);
-        ejectHost(host_success_rate_pair.host_, type);
+        ejectHost(host, type);
       }
     }
   }
 
-  if (!valid_failure_percentage_hosts.empty() &&
-      valid_failure_percentage_hosts.size() >= failure_percentage_minimum_hosts) {
+  size_t valid_failure_percentage_hosts = 0;
+  for (size_t i = 0; i < size; ++i) {
+    valid_failure_percentage_hosts += request_volume[i] >= failure_percentage_request_volume;
+  }
+
+  if (valid_failure_percentage_hosts > 0 &&
+      valid_failure_percentage_hosts >= failure_percentage_minimum_hosts) {
     const double failure_percentage_threshold = runtime_.snapshot().getInteger(
         FailurePercentageThresholdRuntime, config_.failurePercentageThreshold());
 
-    for (const auto& host_success_rate_pair : valid_failure_percentage_hosts) {
-      if ((100.0 - host_success_rate_pair.success_rate_) >= failure_percentage_threshold) {
+    for (size_t i = 0; i < size; ++i) {
+      if (request_volume[i] >= failure_percentage_request_volume &&
+          (100.0 - success_rate[i]) >= failure_percentage_threshold) {
         // We should eject.
 
         // The ejection type returned by the SuccessRateMonitor's getEjectionType() will be a
@@ -738,7 +793,7 @@ void DetectorImpl::processSuccessRateEjections(
                 ? envoy::data::cluster::v3::FAILURE_PERCENTAGE
                 : envoy::data::cluster::v3::FAILURE_PERCENTAGE_LOCAL_ORIGIN;
         updateDetectedEjectionStats(type);
-        ejectHost(host_success_rate_pair.host_, type);
+        ejectHost(host_list_[columns.host_index_[i]].first, type);
       }
     }
   }
@@ -747,24 +802,24 @@ void DetectorImpl::processSuccessRateEjections(
 void DetectorImpl::onIntervalTimer() {
   MonotonicTime now = time_source_.monotonicTime();
 
-  for (auto host : host_monitors_) {
-    checkHostForUneject(host.first, host.second, now);
+  refreshHostList();
+  for (const auto& [host, monitor] : host_list_) {
+    checkHostForUneject(host, monitor, now);
 
     // Need to update the writer bucket to keep the data valid.
-    host.second->updateCurrentSuccessRateBucket();
+    monitor->updateCurrentSuccessRateBucket();
     // Refresh host success rate stat for the /clusters endpoint. If there is a new valid value, it
     // will get updated in processSuccessRateEjections().
-    host.second->successRate(DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin, -1);
-    host.second->successRate(DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin, -1);
+    monitor->successRate(DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin, -1);
+    monitor->successRate(DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin, -1);
   }
 
   processSuccessRateEjections(DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin);
   processSuccessRateEjections(DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin);
 
   // Decrement time backoff for all hosts which have not been ejected.
-  for (auto host : host_monitors_) {
-    if (!host.first->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK)) {
-      auto& monitor = host.second;
+  for (const auto& [host, monitor] : host_list_) {
+    if (!host->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK)) {
       // Node is healthy and was not ejected since the last check.
       if (monitor->lastUnejectionTime().has_value() &&
           ((now - monitor->lastUnejectionTime().value()) >=
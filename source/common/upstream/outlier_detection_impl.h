@@ -24,6 +24,7 @@
 #include "source/common/upstream/upstream_impl.h"
 
 #include "absl/container/node_hash_map.h"
+#include "absl/types/span.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -40,16 +41,6 @@ public:
                    EventLoggerSharedPtr event_logger, Random::RandomGenerator& random);
 };
 
-/**
- * Thin struct to facilitate calculations for success rate outlier detection.
- */
-struct HostSuccessRatePair {
-  HostSuccessRatePair(HostSharedPtr host, double success_rate)
-      : host_(host), success_rate_(success_rate) {}
-  HostSharedPtr host_;
-  double success_rate_;
-};
-
 struct SuccessRateAccumulatorBucket {
   std::atomic<uint64_t> success_request_counter_;
   std::atomic<uint64_t> total_request_counter_;
@@ -82,6 +73,15 @@ public:
    */
   absl::optional<std::pair<double, uint64_t>> getSuccessRateAndVolume();
 
+  /**
+   * @return the number of successful requests and the total number of requests of the last
+   *         complete window of time.
+   */
+  std::pair<uint64_t, uint64_t> lastWindowCounts() const {
+    return {backup_success_rate_bucket_->success_request_counter_.load(),
+            backup_success_rate_bucket_->total_request_counter_.load()};
+  }
+
 private:
   std::unique_ptr<SuccessRateAccumulatorBucket> current_success_rate_bucket_;
   std::unique_ptr<SuccessRateAccumulatorBucket> backup_success_rate_bucket_;
@@ -114,6 +114,31 @@ private:
   double success_rate_{-1};
 };
 
+/**
+ * The request counts of the last window of the hosts of a cluster, flushed into contiguous columns
+ * on each interval so that the success rate statistics of the cluster are computed by tight passes
+ * over arrays, which the compiler can vectorize, rather than by chasing pointers host by host.
+ */
+struct SuccessRateColumns {
+  void clear() {
+    host_index_.clear();
+    request_volume_.clear();
+    success_rate_.clear();
+  }
+  size_t size() const { return host_index_.size(); }
+
+  // The index of each host in the host list of the detector.
+  std::vector<uint32_t> host_index_;
+  std::vector<uint64_t> request_volume_;
+  // Holds the number of successful requests until the success rates are computed.
+  std::vector<double> success_rate_;
+
+  // The hosts with enough requests for success rate ejection, compacted into a column of their
+  // own.
+  std::vector<uint32_t> valid_host_index_;
+  std::vector<double> valid_success_rate_;
+};
+
 class DetectorImpl;
 
 /**
@@ -402,19 +427,17 @@ public:
    * This function returns pair of double values for success rate outlier detection. The pair
    * contains the average success rate of all valid hosts in the cluster and the ejection threshold.
    * If a host's success rate is under this threshold, the host is an outlier.
-   * @param success_rate_sum is the sum of the data in the success_rate_data vector.
-   * @param valid_success_rate_hosts is the vector containing the individual success rate data
-   *        points.
+   * @param success_rates the success rates of the valid hosts, which must not be empty.
+   * @param success_rate_stdev_factor the number of standard deviations below the average success
+   *        rate at which the threshold lies.
    * @return EjectionPair
    */
   struct EjectionPair {
     double success_rate_average_; // average success rate of all valid hosts in the cluster
     double ejection_threshold_;   // ejection threshold for the cluster
   };
-  static EjectionPair
-  successRateEjectionThreshold(double success_rate_sum,
-                               const std::vector<HostSuccessRatePair>& valid_success_rate_hosts,
-                               double success_rate_stdev_factor);
+  static EjectionPair successRateEjectionThreshold(absl::Span<const double> success_rates,
+                                                   double success_rate_stdev_factor);
 
   const absl::node_hash_map<HostSharedPtr, DetectorHostMonitorImpl*>& getHostMonitors() {
     return host_monitors_;
@@ -441,6 +464,7 @@ private:
   void updateEnforcedEjectionStats(envoy::data::cluster::v3::OutlierEjectionType type);
   void updateDetectedEjectionStats(envoy::data::cluster::v3::OutlierEjectionType type);
   void processSuccessRateEjections(DetectorHostMonitor::SuccessRateMonitorType monitor_type);
+  void refreshHostList();
 
   // The helper to double write value and gauge. The gauge could be null value since because any
   // stat might be deactivated.
@@ -468,6 +492,14 @@ private:
   Event::TimerPtr interval_timer_;
   std::list<ChangeStateCb> callbacks_;
   absl::node_hash_map<HostSharedPtr, DetectorHostMonitorImpl*> host_monitors_;
+  // The contents of host_monitors_ in a dense array, which the interval timer walks instead of the
+  // map. It is rebuilt by the first interval after the membership of the cluster changes, so it
+  // may keep removed hosts alive until then.
+  std::vector<std::pair<HostSharedPtr, DetectorHostMonitorImpl*>> host_list_;
+  bool host_list_stale_{true};
+  // Reused across intervals, so that they don't allocate once they have grown to the size of the
+  // cluster.
+  SuccessRateColumns success_rate_columns_;
   EventLoggerSharedPtr event_logger_;
   Common::CallbackHandlePtr member_update_cb_;
   Random::RandomGenerator& random_generator_;
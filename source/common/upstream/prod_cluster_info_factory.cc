@@ -25,7 +25,8 @@ ProdClusterInfoFactory::createClusterInfo(const CreateClusterInfoParams& params)
       Network::UpstreamTransportSocketFactoryPtr);
   auto socket_matcher = THROW_OR_RETURN_VALUE(
       TransportSocketMatcherImpl::create(params.cluster_.transport_socket_matches(),
-                                         factory_context, socket_factory, *scope),
+                                         factory_context, socket_factory,
+                                         params.cluster_.transport_socket(), *scope),
       std::unique_ptr<TransportSocketMatcherImpl>);
 
   return THROW_OR_RETURN_VALUE(
@@ -4,7 +4,9 @@
 #include "envoy/config/core/v3/base.pb.h"
 #include "envoy/server/transport_socket_config.h"
 
+#include "source/common/common/hash.h"
 #include "source/common/config/utility.h"
+#include "source/common/protobuf/utility.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -13,10 +15,12 @@ absl::StatusOr<std::unique_ptr<TransportSocketMatcherImpl>> TransportSocketMatch
     const Protobuf::RepeatedPtrField<envoy::config::cluster::v3::Cluster::TransportSocketMatch>&
         socket_matches,
     Server::Configuration::TransportSocketFactoryContext& factory_context,
-    Network::UpstreamTransportSocketFactoryPtr& default_factory, Stats::Scope& stats_scope) {
+    Network::UpstreamTransportSocketFactoryPtr& default_factory,
+    const envoy::config::core::v3::TransportSocket& default_config, Stats::Scope& stats_scope) {
   absl::Status creation_status = absl::OkStatus();
-  auto ret = std::unique_ptr<TransportSocketMatcherImpl>(new TransportSocketMatcherImpl(
-      socket_matches, factory_context, default_factory, stats_scope, creation_status));
+  auto ret = std::unique_ptr<TransportSocketMatcherImpl>(
+      new TransportSocketMatcherImpl(socket_matches, factory_context, default_factory,
+                                     default_config, stats_scope, creation_status));
   RETURN_IF_NOT_OK(creation_status);
   return ret;
 }
@@ -25,11 +29,14 @@ TransportSocketMatcherImpl::TransportSocketMatcherImpl(
     const Protobuf::RepeatedPtrField<envoy::config::cluster::v3::Cluster::TransportSocketMatch>&
         socket_matches,
     Server::Configuration::TransportSocketFactoryContext& factory_context,
-    Network::UpstreamTransportSocketFactoryPtr& default_factory, Stats::Scope& stats_scope,
+    Network::UpstreamTransportSocketFactoryPtr& default_factory,
+    const envoy::config::core::v3::TransportSocket& default_config, Stats::Scope& stats_scope,
     absl::Status& creation_status)
     : stats_scope_(stats_scope),
-      default_match_("default", std::move(default_factory), generateStats("default")) {
+      default_match_("default", std::move(default_factory), generateStats("default")),
+      config_hash_(MessageUtil::hash(default_config)) {
   for (const auto& socket_match : socket_matches) {
+    config_hash_ = HashUtil::xxHash64Value(MessageUtil::hash(socket_match), config_hash_);
     const auto& socket_config = socket_match.transport_socket();
     auto& config_factory = Config::Utility::getAndCheckFactory<
         Server::Configuration::UpstreamTransportSocketConfigFactory>(socket_config);
@@ -26,7 +26,8 @@ public:
       const Protobuf::RepeatedPtrField<envoy::config::cluster::v3::Cluster::TransportSocketMatch>&
           socket_matches,
       Server::Configuration::TransportSocketFactoryContext& factory_context,
-      Network::UpstreamTransportSocketFactoryPtr& default_factory, Stats::Scope& stats_scope);
+      Network::UpstreamTransportSocketFactoryPtr& default_factory,
+      const envoy::config::core::v3::TransportSocket& default_config, Stats::Scope& stats_scope);
 
   struct FactoryMatch {
     FactoryMatch(std::string match_name, Network::UpstreamTransportSocketFactoryPtr socket_factory,
@@ -53,18 +54,22 @@ public:
     return true;
   }
 
+  uint64_t configHash() const override { return config_hash_; }
+
 protected:
   TransportSocketMatcherImpl(
       const Protobuf::RepeatedPtrField<envoy::config::cluster::v3::Cluster::TransportSocketMatch>&
           socket_matches,
       Server::Configuration::TransportSocketFactoryContext& factory_context,
-      Network::UpstreamTransportSocketFactoryPtr& default_factory, Stats::Scope& stats_scope,
+      Network::UpstreamTransportSocketFactoryPtr& default_factory,
+      const envoy::config::core::v3::TransportSocket& default_config, Stats::Scope& stats_scope,
       absl::Status& creation_status);
 
   TransportSocketMatchStats generateStats(const std::string& prefix);
   Stats::Scope& stats_scope_;
   FactoryMatch default_match_;
   std::vector<FactoryMatch> matches_;
+  uint64_t config_hash_;
 };
 
 } // namespace Upstream
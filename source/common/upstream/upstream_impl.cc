@@ -1598,7 +1598,7 @@ ClusterImplBase::ClusterImplBase(const envoy::config::cluster::v3::Cluster& clus
 
   auto socket_matcher_or_error = TransportSocketMatcherImpl::create(
       cluster.transport_socket_matches(), *transport_factory_context_,
-      socket_factory_or_error.value(), *stats_scope);
+      socket_factory_or_error.value(), cluster.transport_socket(), *stats_scope);
   SET_AND_RETURN_IF_NOT_OK(socket_matcher_or_error.status(), creation_status);
   auto socket_matcher = std::move(*socket_matcher_or_error);
   const bool matcher_supports_alpn = socket_matcher->allMatchesSupportAlpn();
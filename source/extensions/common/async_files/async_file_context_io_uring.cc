@@ -0,0 +1,137 @@
+#include "source/extensions/common/async_files/async_file_context_io_uring.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "source/extensions/common/async_files/async_file_context_thread_pool.h"
+#include "source/extensions/common/async_files/async_file_manager_io_uring.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+AsyncFileContextIoUring::AsyncFileContextIoUring(AsyncFileManagerIoUring& manager,
+                                                 AsyncFileHandle file,
+                                                 Event::Dispatcher* dispatcher)
+    : manager_(manager), file_(std::move(file)) {
+  IoUringFileRing* ring = manager_.ringFor(dispatcher);
+  if (ring == nullptr) {
+    return;
+  }
+  file_index_ = ring->registerFile(fileDescriptor());
+  if (file_index_.has_value()) {
+    registered_dispatcher_ = dispatcher;
+    registered_ring_ptr_ = ring;
+    registered_ring_ = ring->weak_from_this();
+  }
+}
+
+int& AsyncFileContextIoUring::fileDescriptor() {
+  return static_cast<AsyncFileContextThreadPool&>(*file_).fileDescriptor();
+}
+
+absl::optional<uint32_t> AsyncFileContextIoUring::fileIndexOn(const IoUringFileRing& ring) const {
+  return &ring == registered_ring_ptr_ ? file_index_ : absl::nullopt;
+}
+
+void AsyncFileContextIoUring::unregister() {
+  if (!file_index_.has_value() || registered_ring_.expired()) {
+    return;
+  }
+  auto unregister_file = [ring = registered_ring_, index = *file_index_]() {
+    if (IoUringFileRingSharedPtr locked = ring.lock()) {
+      locked->unregisterFile(index);
+    }
+  };
+  file_index_.reset();
+  if (registered_dispatcher_->isThreadSafe()) {
+    unregister_file();
+  } else {
+    registered_dispatcher_->post(std::move(unregister_file));
+  }
+}
+
+absl::StatusOr<CancelFunction> AsyncFileContextIoUring::stat(
+    Event::Dispatcher* dispatcher,
+    absl::AnyInvocable<void(absl::StatusOr<struct stat>)> on_complete) {
+  return file_->stat(dispatcher, std::move(on_complete));
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::createHardLink(Event::Dispatcher* dispatcher, absl::string_view filename,
+                                        absl::AnyInvocable<void(absl::Status)> on_complete) {
+  return file_->createHardLink(dispatcher, filename, std::move(on_complete));
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::close(Event::Dispatcher* dispatcher,
+                               absl::AnyInvocable<void(absl::Status)> on_complete) {
+  if (fileDescriptor() == -1) {
+    return absl::FailedPreconditionError("file was already closed");
+  }
+  // The registration holds a reference to the file, which would keep it open.
+  unregister();
+  IoUringFileRing* ring = manager_.ringFor(dispatcher);
+  if (ring == nullptr) {
+    return file_->close(dispatcher, std::move(on_complete));
+  }
+  const int fd = std::exchange(fileDescriptor(), -1);
+  return ring->close(fd, shared_from_this(), std::move(on_complete));
+}
+
+absl::StatusOr<CancelFunction> AsyncFileContextIoUring::read(
+    Event::Dispatcher* dispatcher, off_t offset, size_t length,
+    absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) {
+  IoUringFileRing* ring = manager_.ringFor(dispatcher);
+  if (ring == nullptr) {
+    return file_->read(dispatcher, offset, length, std::move(on_complete));
+  }
+  if (fileDescriptor() == -1) {
+    return absl::FailedPreconditionError("file was already closed");
+  }
+  return ring->read(fileDescriptor(), fileIndexOn(*ring), offset, length, shared_from_this(),
+                    std::move(on_complete));
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::write(Event::Dispatcher* dispatcher, Buffer::Instance& contents,
+                               off_t offset,
+                               absl::AnyInvocable<void(absl::StatusOr<size_t>)> on_complete) {
+  IoUringFileRing* ring = manager_.ringFor(dispatcher);
+  if (ring == nullptr) {
+    return file_->write(dispatcher, contents, offset, std::move(on_complete));
+  }
+  if (fileDescriptor() == -1) {
+    return absl::FailedPreconditionError("file was already closed");
+  }
+  return ring->write(fileDescriptor(), fileIndexOn(*ring), contents, offset, shared_from_this(),
+                     std::move(on_complete));
+}
+
+absl::StatusOr<CancelFunction> AsyncFileContextIoUring::duplicate(
+    Event::Dispatcher* dispatcher,
+    absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete) {
+  return file_->duplicate(
+      dispatcher, [&manager = manager_, dispatcher, on_complete = std::move(on_complete)](
+                      absl::StatusOr<AsyncFileHandle> result) mutable {
+        if (!result.ok()) {
+          std::move(on_complete)(std::move(result));
+          return;
+        }
+        std::move(on_complete)(std::make_shared<AsyncFileContextIoUring>(
+            manager, std::move(result.value()), dispatcher));
+      });
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::truncate(Event::Dispatcher* dispatcher, size_t length,
+                                  absl::AnyInvocable<void(absl::Status)> on_complete) {
+  return file_->truncate(dispatcher, length, std::move(on_complete));
+}
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/common/async_files/async_file_handle.h"
+#include "source/extensions/common/async_files/io_uring_file_ring.h"
+
+#include "absl/status/statusor.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+class AsyncFileManagerIoUring;
+
+// The io_uring implementation of an AsyncFileContext. It wraps the context of the file opened by
+// the thread pool of the manager: reads, writes and closes requested from a thread with a ring
+// are submitted to that ring, and everything else is passed to the wrapped context.
+//
+// The file is registered with the ring of the thread which opened it, if it has one.
+class AsyncFileContextIoUring final : public AsyncFileContext {
+public:
+  AsyncFileContextIoUring(AsyncFileManagerIoUring& manager, AsyncFileHandle file,
+                          Event::Dispatcher* dispatcher);
+
+  // CancelFunction should only be called from the same thread that created the action, before
+  // the callback.
+  // The callback is called on the thread of the dispatcher.
+  absl::StatusOr<CancelFunction>
+  stat(Event::Dispatcher* dispatcher,
+       absl::AnyInvocable<void(absl::StatusOr<struct stat>)> on_complete) override;
+  absl::StatusOr<CancelFunction>
+  createHardLink(Event::Dispatcher* dispatcher, absl::string_view filename,
+                 absl::AnyInvocable<void(absl::Status)> on_complete) override;
+  absl::StatusOr<CancelFunction> close(Event::Dispatcher* dispatcher,
+                                       absl::AnyInvocable<void(absl::Status)> on_complete) override;
+  absl::StatusOr<CancelFunction>
+  read(Event::Dispatcher* dispatcher, off_t offset, size_t length,
+       absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) override;
+  absl::StatusOr<CancelFunction>
+  write(Event::Dispatcher* dispatcher, Buffer::Instance& contents, off_t offset,
+        absl::AnyInvocable<void(absl::StatusOr<size_t>)> on_complete) override;
+  absl::StatusOr<CancelFunction>
+  duplicate(Event::Dispatcher* dispatcher,
+            absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete) override;
+  absl::StatusOr<CancelFunction>
+  truncate(Event::Dispatcher* dispatcher, size_t length,
+           absl::AnyInvocable<void(absl::Status)> on_complete) override;
+
+  // @return whether the file is registered with the ring of the thread which opened it.
+  bool registered() const { return file_index_.has_value(); }
+
+private:
+  int& fileDescriptor();
+  // @return the index of the file among the files registered with ring, if it is registered.
+  absl::optional<uint32_t> fileIndexOn(const IoUringFileRing& ring) const;
+  // Unregisters the file from the ring of the thread which opened it, on that thread.
+  void unregister();
+
+  AsyncFileManagerIoUring& manager_;
+  const AsyncFileHandle file_;
+
+  Event::Dispatcher* registered_dispatcher_{};
+  const IoUringFileRing* registered_ring_ptr_{};
+  std::weak_ptr<IoUringFileRing> registered_ring_;
+  absl::optional<uint32_t> file_index_;
+};
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
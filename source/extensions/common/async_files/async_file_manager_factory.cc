@@ -7,6 +7,10 @@
 #include "source/common/protobuf/utility.h"
 #include "source/extensions/common/async_files/async_file_manager_thread_pool.h"
 
+#if defined(__linux__)
+#include "source/extensions/common/async_files/async_file_manager_io_uring.h"
+#endif
+
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 
@@ -26,7 +30,8 @@ SINGLETON_MANAGER_REGISTRATION(async_file_manager_factory_singleton);
 
 class AsyncFileManagerFactoryImpl : public AsyncFileManagerFactory {
 public:
-  static std::shared_ptr<AsyncFileManagerFactory> singleton(Singleton::Manager* singleton_manager);
+  explicit AsyncFileManagerFactoryImpl(ThreadLocal::SlotAllocator* thread_local_slots)
+      : thread_local_slots_(thread_local_slots) {}
   std::shared_ptr<AsyncFileManager> getAsyncFileManager(
       const envoy::extensions::common::async_files::v3::AsyncFileManagerConfig& config,
       Api::OsSysCalls* substitute_posix_file_operations = nullptr)
@@ -34,14 +39,18 @@ public:
 
 private:
   absl::Mutex mu_;
+  ThreadLocal::SlotAllocator* const thread_local_slots_;
   absl::flat_hash_map<std::string, ManagerAndConfig> managers_ ABSL_GUARDED_BY(mu_);
 };
 
 std::shared_ptr<AsyncFileManagerFactory>
-AsyncFileManagerFactory::singleton(Singleton::Manager* singleton_manager) {
+AsyncFileManagerFactory::singleton(Singleton::Manager* singleton_manager,
+                                   ThreadLocal::SlotAllocator* thread_local_slots) {
   return singleton_manager->getTyped<AsyncFileManagerFactory>(
       SINGLETON_MANAGER_REGISTERED_NAME(async_file_manager_factory_singleton),
-      [] { return std::make_shared<AsyncFileManagerFactoryImpl>(); });
+      [thread_local_slots] {
+        return std::make_shared<AsyncFileManagerFactoryImpl>(thread_local_slots);
+      });
 }
 
 std::shared_ptr<AsyncFileManager> AsyncFileManagerFactoryImpl::getAsyncFileManager(
@@ -61,6 +70,21 @@ std::shared_ptr<AsyncFileManager> AsyncFileManagerFactoryImpl::getAsyncFileManag
                             std::make_shared<AsyncFileManagerThreadPool>(config, posix), config}})
                .first;
       break;
+    case envoy::extensions::common::async_files::v3::AsyncFileManagerConfig::kIoUring:
+#if defined(__linux__)
+      if (thread_local_slots_ == nullptr) {
+        throw EnvoyException("AsyncFileManager io_uring requires thread local slots");
+      }
+      it = managers_
+               .insert({config.id(),
+                        ManagerAndConfig{std::make_shared<AsyncFileManagerIoUring>(
+                                             config, posix, *thread_local_slots_),
+                                         config}})
+               .first;
+      break;
+#else
+      throw EnvoyException("AsyncFileManager io_uring is only supported on Linux");
+#endif
     case envoy::extensions::common::async_files::v3::AsyncFileManagerConfig::MANAGER_TYPE_NOT_SET:
       // This is theoretically unreachable due to proto validation 'required', but it's possible
       // for code to have modified the proto post-validation.
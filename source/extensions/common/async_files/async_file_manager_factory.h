@@ -3,6 +3,7 @@
 #include "envoy/extensions/common/async_files/v3/async_file_manager.pb.h"
 #include "envoy/singleton/instance.h"
 #include "envoy/singleton/manager.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "source/extensions/common/async_files/async_file_manager.h"
 
@@ -25,7 +26,13 @@ public:
   //
   // Specifically, the singleton manager *does not* keep a reference to the returned singleton
   // - the factory persists only as long as there is a live reference to it.
-  static std::shared_ptr<AsyncFileManagerFactory> singleton(Singleton::Manager* singleton_manager);
+  //
+  // thread_local_slots is required to instantiate managers which keep state on each worker,
+  // such as the io_uring manager. Only the slots given by the caller which creates the factory
+  // are used.
+  static std::shared_ptr<AsyncFileManagerFactory>
+  singleton(Singleton::Manager* singleton_manager,
+            ThreadLocal::SlotAllocator* thread_local_slots = nullptr);
   virtual std::shared_ptr<AsyncFileManager> getAsyncFileManager(
       const envoy::extensions::common::async_files::v3::AsyncFileManagerConfig& config,
       Api::OsSysCalls* substitute_posix_file_operations = nullptr) PURE;
@@ -0,0 +1,133 @@
+#include "source/extensions/common/async_files/async_file_manager_io_uring.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "source/common/io/io_uring_impl.h"
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/common/async_files/async_file_context_io_uring.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+namespace {
+
+constexpr uint32_t DefaultIoUringSize = 256;
+constexpr uint32_t DefaultRegisteredFileCount = 256;
+constexpr uint32_t DefaultRegisteredBufferCount = 64;
+constexpr uint32_t DefaultRegisteredBufferSize = 64 * 1024;
+
+envoy::extensions::common::async_files::v3::AsyncFileManagerConfig
+threadPoolConfig(const envoy::extensions::common::async_files::v3::AsyncFileManagerConfig& config) {
+  envoy::extensions::common::async_files::v3::AsyncFileManagerConfig thread_pool_config;
+  thread_pool_config.set_id(config.id());
+  *thread_pool_config.mutable_thread_pool() = config.io_uring().thread_pool();
+  return thread_pool_config;
+}
+
+IoUringFileRingConfig
+ringConfig(const envoy::extensions::common::async_files::v3::AsyncFileManagerConfig& config) {
+  const auto& io_uring = config.io_uring();
+  return {
+      io_uring.io_uring_size() == 0 ? DefaultIoUringSize : io_uring.io_uring_size(),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(io_uring, registered_file_count, DefaultRegisteredFileCount),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(io_uring, registered_buffer_count,
+                                      DefaultRegisteredBufferCount),
+      io_uring.registered_buffer_size() == 0 ? DefaultRegisteredBufferSize
+                                             : io_uring.registered_buffer_size(),
+  };
+}
+
+} // namespace
+
+AsyncFileManagerIoUring::AsyncFileManagerIoUring(
+    const envoy::extensions::common::async_files::v3::AsyncFileManagerConfig& config,
+    Api::OsSysCalls& posix, ThreadLocal::SlotAllocator& thread_local_slots)
+    : thread_pool_(std::make_shared<AsyncFileManagerThreadPool>(threadPoolConfig(config), posix)),
+      ring_config_(ringConfig(config)) {
+  if (!Io::isIoUringSupported()) {
+    throw EnvoyException("AsyncFileManagerIoUring not supported");
+  }
+  ENVOY_LOG(info, "AsyncFileManagerIoUring created with id '{}', with rings of {} entries",
+            config.id(), ring_config_.io_uring_size);
+  rings_ = ThreadLocal::TypedSlot<IoUringFileRing>::makeUnique(thread_local_slots);
+  rings_->set([config = ring_config_](Event::Dispatcher& dispatcher) {
+    return std::make_shared<IoUringFileRing>(dispatcher, config);
+  });
+}
+
+std::string AsyncFileManagerIoUring::describe() const {
+  return absl::StrCat("io_uring_size = ", ring_config_.io_uring_size, ", ",
+                      thread_pool_->describe());
+}
+
+void AsyncFileManagerIoUring::waitForIdle() { thread_pool_->waitForIdle(); }
+
+IoUringFileRing* AsyncFileManagerIoUring::ringFor(Event::Dispatcher* dispatcher) {
+  if (dispatcher == nullptr || !rings_->currentThreadRegistered()) {
+    return nullptr;
+  }
+  OptRef<IoUringFileRing> ring = rings_->get();
+  // A dispatcher of another thread can't be called back from the ring of this one.
+  if (!ring.has_value() || &ring->dispatcher() != dispatcher) {
+    return nullptr;
+  }
+  return ring.ptr();
+}
+
+absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> AsyncFileManagerIoUring::wrapHandle(
+    Event::Dispatcher* dispatcher,
+    absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete) {
+  return [this, dispatcher, on_complete = std::move(on_complete)](
+             absl::StatusOr<AsyncFileHandle> result) mutable {
+    if (!result.ok()) {
+      std::move(on_complete)(std::move(result));
+      return;
+    }
+    std::move(on_complete)(
+        std::make_shared<AsyncFileContextIoUring>(*this, std::move(result.value()), dispatcher));
+  };
+}
+
+CancelFunction AsyncFileManagerIoUring::createAnonymousFile(
+    Event::Dispatcher* dispatcher, absl::string_view path,
+    absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete) {
+  return thread_pool_->createAnonymousFile(dispatcher, path,
+                                           wrapHandle(dispatcher, std::move(on_complete)));
+}
+
+CancelFunction AsyncFileManagerIoUring::openExistingFile(
+    Event::Dispatcher* dispatcher, absl::string_view filename, Mode mode,
+    absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete) {
+  return thread_pool_->openExistingFile(dispatcher, filename, mode,
+                                        wrapHandle(dispatcher, std::move(on_complete)));
+}
+
+CancelFunction
+AsyncFileManagerIoUring::stat(Event::Dispatcher* dispatcher, absl::string_view filename,
+                              absl::AnyInvocable<void(absl::StatusOr<struct stat>)> on_complete) {
+  return thread_pool_->stat(dispatcher, filename, std::move(on_complete));
+}
+
+CancelFunction AsyncFileManagerIoUring::unlink(Event::Dispatcher* dispatcher,
+                                               absl::string_view filename,
+                                               absl::AnyInvocable<void(absl::Status)> on_complete) {
+  return thread_pool_->unlink(dispatcher, filename, std::move(on_complete));
+}
+
+CancelFunction AsyncFileManagerIoUring::enqueue(Event::Dispatcher*,
+                                                std::unique_ptr<AsyncFileAction>) {
+  PANIC("not reached");
+}
+
+void AsyncFileManagerIoUring::postCancelledActionForCleanup(std::unique_ptr<AsyncFileAction>) {
+  PANIC("not reached");
+}
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
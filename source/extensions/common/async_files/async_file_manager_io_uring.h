@@ -0,0 +1,73 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/common/async_files/v3/async_file_manager.pb.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/common/common/logger.h"
+#include "source/extensions/common/async_files/async_file_handle.h"
+#include "source/extensions/common/async_files/async_file_manager.h"
+#include "source/extensions/common/async_files/async_file_manager_thread_pool.h"
+#include "source/extensions/common/async_files/io_uring_file_ring.h"
+
+#include "absl/status/statusor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+// An AsyncFileManager which reads, writes and closes files with an io_uring on each thread which
+// has a dispatcher, so that those operations complete on the thread which requested them without
+// being handed to another thread and back. The operations which io_uring doesn't perform for it,
+// and operations requested without a dispatcher or from a thread without a ring, are performed by
+// an embedded AsyncFileManagerThreadPool.
+class AsyncFileManagerIoUring : public AsyncFileManager,
+                                public std::enable_shared_from_this<AsyncFileManagerIoUring>,
+                                protected Logger::Loggable<Logger::Id::main> {
+public:
+  AsyncFileManagerIoUring(
+      const envoy::extensions::common::async_files::v3::AsyncFileManagerConfig& config,
+      Api::OsSysCalls& posix, ThreadLocal::SlotAllocator& thread_local_slots);
+
+  CancelFunction createAnonymousFile(
+      Event::Dispatcher* dispatcher, absl::string_view path,
+      absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete) override;
+  CancelFunction
+  openExistingFile(Event::Dispatcher* dispatcher, absl::string_view filename, Mode mode,
+                   absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete) override;
+  CancelFunction stat(Event::Dispatcher* dispatcher, absl::string_view filename,
+                      absl::AnyInvocable<void(absl::StatusOr<struct stat>)> on_complete) override;
+  CancelFunction unlink(Event::Dispatcher* dispatcher, absl::string_view filename,
+                        absl::AnyInvocable<void(absl::Status)> on_complete) override;
+  std::string describe() const override;
+  // Only waits for the operations of the thread pool. The operations submitted to the io_uring
+  // rings of threads complete on the dispatchers of those threads, which have to be run until
+  // their callbacks arrive.
+  void waitForIdle() override;
+
+  // @return the ring of the calling thread if the thread runs the dispatcher, or nullptr if the
+  // operation has to be performed by the thread pool.
+  IoUringFileRing* ringFor(Event::Dispatcher* dispatcher);
+
+private:
+  // Every operation is either submitted to a ring or passed to the thread pool, so nothing is
+  // queued with this manager itself.
+  CancelFunction enqueue(Event::Dispatcher*, std::unique_ptr<AsyncFileAction>) override;
+  void postCancelledActionForCleanup(std::unique_ptr<AsyncFileAction>) override;
+
+  absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)>
+  wrapHandle(Event::Dispatcher* dispatcher,
+             absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete);
+
+  const std::shared_ptr<AsyncFileManagerThreadPool> thread_pool_;
+  const IoUringFileRingConfig ring_config_;
+  ThreadLocal::TypedSlotPtr<IoUringFileRing> rings_;
+};
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
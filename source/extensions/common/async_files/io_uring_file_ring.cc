@@ -0,0 +1,389 @@
+#include "source/extensions/common/async_files/io_uring_file_ring.h"
+
+#include <sys/uio.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/io/io_uring_impl.h"
+#include "source/extensions/common/async_files/status_after_file_error.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+namespace {
+
+// The most slices a write is submitted with at a time. The rest of the slices are written by
+// resubmitting the write.
+constexpr size_t MaxWriteSlices = 64;
+
+absl::Status statusFromResult(int32_t result) { return statusAfterFileError(-result); }
+
+class ReadRequest : public IoUringFileRequest {
+public:
+  ReadRequest(IoUringFileRing& ring, os_fd_t fd, absl::optional<uint32_t> file_index, off_t offset,
+              size_t length, std::shared_ptr<void> keep_alive,
+              absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete)
+      : IoUringFileRequest(RequestType::Read, ring, std::move(keep_alive)), fd_(fd),
+        file_index_(file_index), offset_(offset), length_(length),
+        on_complete_(std::move(on_complete)), registered_buffer_(ring.acquireBuffer(length)) {
+    if (!registered_buffer_.has_value()) {
+      // Too large for a registered buffer, or none is free, so read straight into the result.
+      result_ = std::make_unique<Buffer::OwnedImpl>();
+      reservation_.emplace(result_->reserveSingleSlice(length_));
+    }
+  }
+
+  ~ReadRequest() override {
+    if (registered_buffer_.has_value()) {
+      ring_.releaseBuffer(*registered_buffer_);
+    }
+  }
+
+  Io::IoUringResult prepare(Io::IoUring& io_uring) override {
+    void* buf =
+        registered_buffer_.has_value() ? registered_buffer_->data_ : reservation_->slice().mem_;
+    return io_uring.prepareRead(file_index_.value_or(fd_), file_index_.has_value(), buf, length_,
+                                offset_,
+                                registered_buffer_.has_value() ? registered_buffer_->index_ : -1,
+                                this);
+  }
+
+  bool onResult(int32_t result) override {
+    if (cancelled()) {
+      return true;
+    }
+    if (result < 0) {
+      std::move(on_complete_)(statusFromResult(result));
+      return true;
+    }
+    if (registered_buffer_.has_value()) {
+      result_ = std::make_unique<Buffer::OwnedImpl>(registered_buffer_->data_, result);
+    } else {
+      reservation_->commit(result);
+      reservation_.reset();
+    }
+    std::move(on_complete_)(std::move(result_));
+    return true;
+  }
+
+  void onAbort(absl::Status status) override {
+    if (!cancelled()) {
+      std::move(on_complete_)(status);
+    }
+  }
+
+private:
+  const os_fd_t fd_;
+  const absl::optional<uint32_t> file_index_;
+  const off_t offset_;
+  const size_t length_;
+  absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete_;
+  const absl::optional<IoUringFileRing::RegisteredBuffer> registered_buffer_;
+  Buffer::InstancePtr result_;
+  absl::optional<Buffer::ReservationSingleSlice> reservation_;
+};
+
+class WriteRequest : public IoUringFileRequest {
+public:
+  WriteRequest(IoUringFileRing& ring, os_fd_t fd, absl::optional<uint32_t> file_index,
+               Buffer::Instance& contents, off_t offset, std::shared_ptr<void> keep_alive,
+               absl::AnyInvocable<void(absl::StatusOr<size_t>)> on_complete)
+      : IoUringFileRequest(RequestType::Write, ring, std::move(keep_alive)), fd_(fd),
+        file_index_(file_index), offset_(offset), length_(contents.length()),
+        on_complete_(std::move(on_complete)), registered_buffer_(ring.acquireBuffer(length_)) {
+    if (registered_buffer_.has_value()) {
+      contents.copyOut(0, length_, registered_buffer_->data_);
+      contents.drain(length_);
+    } else {
+      contents_.move(contents);
+    }
+  }
+
+  ~WriteRequest() override {
+    if (registered_buffer_.has_value()) {
+      ring_.releaseBuffer(*registered_buffer_);
+    }
+  }
+
+  Io::IoUringResult prepare(Io::IoUring& io_uring) override {
+    const off_t offset = offset_ + written_;
+    if (registered_buffer_.has_value()) {
+      return io_uring.prepareWrite(file_index_.value_or(fd_), file_index_.has_value(),
+                                   registered_buffer_->data_ + written_, length_ - written_,
+                                   offset, registered_buffer_->index_, this);
+    }
+    // Vectored writes can't go through the registration of the file.
+    Buffer::RawSliceVector slices = contents_.getRawSlices(MaxWriteSlices);
+    iovecs_.resize(slices.size());
+    for (size_t i = 0; i < slices.size(); i++) {
+      iovecs_[i].iov_base = slices[i].mem_;
+      iovecs_[i].iov_len = slices[i].len_;
+    }
+    return io_uring.prepareWritev(fd_, iovecs_.data(), iovecs_.size(), offset, this);
+  }
+
+  bool onResult(int32_t result) override {
+    if (result < 0) {
+      if (!cancelled()) {
+        std::move(on_complete_)(statusFromResult(result));
+      }
+      return true;
+    }
+    written_ += result;
+    if (!registered_buffer_.has_value()) {
+      contents_.drain(result);
+    }
+    if (written_ < length_ && result > 0 && !cancelled()) {
+      // A short write; write the rest.
+      return false;
+    }
+    if (!cancelled()) {
+      if (written_ < length_) {
+        std::move(on_complete_)(absl::DataLossError("file write made no progress"));
+      } else {
+        std::move(on_complete_)(written_);
+      }
+    }
+    return true;
+  }
+
+  void onAbort(absl::Status status) override {
+    if (!cancelled()) {
+      std::move(on_complete_)(status);
+    }
+  }
+
+private:
+  const os_fd_t fd_;
+  const absl::optional<uint32_t> file_index_;
+  const off_t offset_;
+  const size_t length_;
+  absl::AnyInvocable<void(absl::StatusOr<size_t>)> on_complete_;
+  const absl::optional<IoUringFileRing::RegisteredBuffer> registered_buffer_;
+  Buffer::OwnedImpl contents_;
+  std::vector<struct iovec> iovecs_;
+  size_t written_{};
+};
+
+class CloseRequest : public IoUringFileRequest {
+public:
+  CloseRequest(IoUringFileRing& ring, os_fd_t fd, std::shared_ptr<void> keep_alive,
+               absl::AnyInvocable<void(absl::Status)> on_complete)
+      : IoUringFileRequest(RequestType::Close, ring, std::move(keep_alive)), fd_(fd),
+        on_complete_(std::move(on_complete)) {}
+
+  Io::IoUringResult prepare(Io::IoUring& io_uring) override {
+    return io_uring.prepareClose(fd_, this);
+  }
+
+  bool onResult(int32_t result) override {
+    if (!cancelled()) {
+      std::move(on_complete_)(result < 0 ? statusFromResult(result) : absl::OkStatus());
+    }
+    return true;
+  }
+
+  void onAbort(absl::Status) override {
+    // The file must be closed even if the ring can't do it.
+    Api::SysCallIntResult result = Api::OsSysCallsSingleton::get().close(fd_);
+    if (!cancelled()) {
+      std::move(on_complete_)(result.return_value_ == -1 ? statusAfterFileError(result)
+                                                         : absl::OkStatus());
+    }
+  }
+
+private:
+  const os_fd_t fd_;
+  absl::AnyInvocable<void(absl::Status)> on_complete_;
+};
+
+} // namespace
+
+IoUringFileRing::IoUringFileRing(Event::Dispatcher& dispatcher,
+                                 const IoUringFileRingConfig& config)
+    : IoUringFileRing(std::make_unique<Io::IoUringImpl>(config.io_uring_size, false), dispatcher,
+                      config) {}
+
+IoUringFileRing::IoUringFileRing(Io::IoUringPtr&& io_uring, Event::Dispatcher& dispatcher,
+                                 const IoUringFileRingConfig& config)
+    : dispatcher_(dispatcher), config_(config), io_uring_(std::move(io_uring)) {
+  const os_fd_t event_fd = io_uring_->registerEventfd();
+  file_event_ = dispatcher_.createFileEvent(
+      event_fd,
+      [this](uint32_t) {
+        onCompletions();
+        return absl::OkStatus();
+      },
+      Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
+  submit_cb_ = dispatcher_.createSchedulableCallback([this]() {
+    if (io_uring_->submit() == Io::IoUringResult::Busy) {
+      // The kernel is short of resources until some completions are consumed.
+      submit_cb_->scheduleCallbackNextIteration();
+    }
+  });
+
+  if (config_.registered_file_count > 0 &&
+      io_uring_->registerFiles(config_.registered_file_count) == Io::IoUringResult::Ok) {
+    free_file_indexes_.reserve(config_.registered_file_count);
+    for (uint32_t i = config_.registered_file_count; i > 0; i--) {
+      free_file_indexes_.push_back(i - 1);
+    }
+  }
+
+  if (config_.registered_buffer_count > 0 && config_.registered_buffer_size > 0) {
+    const size_t buffer_size = config_.registered_buffer_size;
+    buffer_memory_ = std::make_unique<uint8_t[]>(config_.registered_buffer_count * buffer_size);
+    std::vector<struct iovec> iovecs(config_.registered_buffer_count);
+    for (uint32_t i = 0; i < config_.registered_buffer_count; i++) {
+      iovecs[i].iov_base = buffer_memory_.get() + i * buffer_size;
+      iovecs[i].iov_len = config_.registered_buffer_size;
+    }
+    if (io_uring_->registerBuffers(iovecs.data(), iovecs.size()) == Io::IoUringResult::Ok) {
+      free_buffers_.reserve(config_.registered_buffer_count);
+      for (uint32_t i = config_.registered_buffer_count; i > 0; i--) {
+        free_buffers_.push_back(i - 1);
+      }
+    } else {
+      ENVOY_LOG(warn, "unable to register {} buffers of {} bytes with io_uring; file operations "
+                      "will use unregistered memory",
+                config_.registered_buffer_count, config_.registered_buffer_size);
+      buffer_memory_.reset();
+    }
+  }
+}
+
+IoUringFileRing::~IoUringFileRing() {
+  ENVOY_LOG(trace, "destruct io_uring file ring, pending operations = {}", pendingOperations());
+  // Nobody is waiting for the results anymore.
+  for (auto& [user_data, request] : requests_) {
+    request->cancelFunction()();
+  }
+  for (IoUringFileRequest* request : queued_) {
+    request->onAbort(absl::CancelledError("io_uring file ring destroyed"));
+    requests_.erase(request);
+  }
+  queued_.clear();
+  // The kernel may still be reading into or writing from the buffers of the operations in flight,
+  // so they have to complete before the buffers are freed.
+  if (in_flight_ > 0) {
+    io_uring_->submit();
+  }
+  while (in_flight_ > 0) {
+    RELEASE_ASSERT(io_uring_->waitForCompletion() == Io::IoUringResult::Ok,
+                   "unable to wait for the io_uring file operations in flight");
+    io_uring_->forEveryCompletion([this](Io::Request* user_data, int32_t result, bool) {
+      in_flight_--;
+      auto it = requests_.find(user_data);
+      ASSERT(it != requests_.end());
+      it->second->onResult(result);
+      requests_.erase(it);
+    });
+  }
+  requests_.clear();
+  file_event_.reset();
+  io_uring_->unregisterEventfd();
+}
+
+absl::optional<uint32_t> IoUringFileRing::registerFile(os_fd_t fd) {
+  if (free_file_indexes_.empty()) {
+    return absl::nullopt;
+  }
+  const uint32_t index = free_file_indexes_.back();
+  if (io_uring_->updateRegisteredFile(index, fd) != Io::IoUringResult::Ok) {
+    return absl::nullopt;
+  }
+  free_file_indexes_.pop_back();
+  return index;
+}
+
+void IoUringFileRing::unregisterFile(uint32_t index) {
+  // Removing the file from the table releases the reference the ring holds to it.
+  io_uring_->updateRegisteredFile(index, -1);
+  free_file_indexes_.push_back(index);
+}
+
+absl::optional<IoUringFileRing::RegisteredBuffer> IoUringFileRing::acquireBuffer(size_t size) {
+  if (free_buffers_.empty() || size > config_.registered_buffer_size) {
+    return absl::nullopt;
+  }
+  const int index = free_buffers_.back();
+  free_buffers_.pop_back();
+  return RegisteredBuffer{
+      buffer_memory_.get() + static_cast<size_t>(index) * config_.registered_buffer_size, index};
+}
+
+void IoUringFileRing::releaseBuffer(const RegisteredBuffer& buffer) {
+  free_buffers_.push_back(buffer.index_);
+}
+
+CancelFunction
+IoUringFileRing::read(os_fd_t fd, absl::optional<uint32_t> file_index, off_t offset, size_t length,
+                      std::shared_ptr<void> keep_alive,
+                      absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) {
+  return submit(std::make_unique<ReadRequest>(*this, fd, file_index, offset, length,
+                                              std::move(keep_alive), std::move(on_complete)));
+}
+
+CancelFunction
+IoUringFileRing::write(os_fd_t fd, absl::optional<uint32_t> file_index, Buffer::Instance& contents,
+                       off_t offset, std::shared_ptr<void> keep_alive,
+                       absl::AnyInvocable<void(absl::StatusOr<size_t>)> on_complete) {
+  return submit(std::make_unique<WriteRequest>(*this, fd, file_index, contents, offset,
+                                               std::move(keep_alive), std::move(on_complete)));
+}
+
+CancelFunction IoUringFileRing::close(os_fd_t fd, std::shared_ptr<void> keep_alive,
+                                      absl::AnyInvocable<void(absl::Status)> on_complete) {
+  return submit(
+      std::make_unique<CloseRequest>(*this, fd, std::move(keep_alive), std::move(on_complete)));
+}
+
+CancelFunction IoUringFileRing::submit(std::unique_ptr<IoUringFileRequest> request) {
+  IoUringFileRequest* raw_request = request.get();
+  CancelFunction cancel = raw_request->cancelFunction();
+  requests_.emplace(raw_request, std::move(request));
+  queued_.push_back(raw_request);
+  prepareQueued();
+  return cancel;
+}
+
+void IoUringFileRing::prepareQueued() {
+  while (!queued_.empty() && in_flight_ < config_.io_uring_size) {
+    if (queued_.front()->prepare(*io_uring_) != Io::IoUringResult::Ok) {
+      // Retried when an operation completes.
+      break;
+    }
+    queued_.pop_front();
+    in_flight_++;
+    if (!submit_cb_->enabled()) {
+      submit_cb_->scheduleCallbackCurrentIteration();
+    }
+  }
+}
+
+void IoUringFileRing::onCompletions() {
+  io_uring_->forEveryCompletion([this](Io::Request* user_data, int32_t result, bool) {
+    in_flight_--;
+    auto it = requests_.find(user_data);
+    ASSERT(it != requests_.end());
+    // The request is taken out of the map before its callback, which may submit more requests.
+    std::unique_ptr<IoUringFileRequest> request = std::move(it->second);
+    requests_.erase(it);
+    if (!request->onResult(result)) {
+      IoUringFileRequest* raw_request = request.get();
+      requests_.emplace(raw_request, std::move(request));
+      queued_.push_front(raw_request);
+    }
+  });
+  prepareQueued();
+}
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "envoy/common/io/io_uring.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/file_event.h"
+#include "envoy/event/schedulable_cb.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/logger.h"
+#include "source/extensions/common/async_files/async_file_action.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+struct IoUringFileRingConfig {
+  uint32_t io_uring_size;
+  uint32_t registered_file_count;
+  uint32_t registered_buffer_count;
+  uint32_t registered_buffer_size;
+};
+
+class IoUringFileRing;
+
+// A file operation submitted to an IoUringFileRing.
+class IoUringFileRequest : public Io::Request {
+public:
+  IoUringFileRequest(RequestType type, IoUringFileRing& ring, std::shared_ptr<void> keep_alive)
+      : Request(type), ring_(ring), keep_alive_(std::move(keep_alive)),
+        cancelled_(std::make_shared<bool>(false)) {}
+
+  // Puts the operation in the submission queue of the ring.
+  virtual Io::IoUringResult prepare(Io::IoUring& io_uring) PURE;
+
+  // Handles the result of the operation, and calls back unless the operation was cancelled.
+  // @return false if the operation is incomplete and has to be prepared again.
+  virtual bool onResult(int32_t result) PURE;
+
+  // Called instead of onResult if the operation couldn't be submitted, or the ring is destroyed.
+  virtual void onAbort(absl::Status status) PURE;
+
+  bool cancelled() const { return *cancelled_; }
+  CancelFunction cancelFunction() const {
+    return [cancelled = cancelled_]() { *cancelled = true; };
+  }
+
+protected:
+  IoUringFileRing& ring_;
+
+private:
+  // Keeps the file the operation is on open.
+  const std::shared_ptr<void> keep_alive_;
+  // Shared with the cancel function, which may outlive the request.
+  const std::shared_ptr<bool> cancelled_;
+};
+
+// The io_uring of one thread, which reads, writes and closes files for an
+// AsyncFileManagerIoUring on the dispatcher of the thread, without handing them to another thread.
+// Submissions are batched: the operations requested during an iteration of the event loop are
+// submitted with a single system call at the end of the iteration.
+//
+// Files can be registered with the ring, so that the kernel doesn't look up their file descriptors
+// for each operation, and the ring registers a pool of buffers which small reads and writes are
+// performed through, so that their memory doesn't have to be mapped into the kernel each time.
+class IoUringFileRing : public ThreadLocal::ThreadLocalObject,
+                        public std::enable_shared_from_this<IoUringFileRing>,
+                        protected Logger::Loggable<Logger::Id::main> {
+public:
+  IoUringFileRing(Event::Dispatcher& dispatcher, const IoUringFileRingConfig& config);
+  IoUringFileRing(Io::IoUringPtr&& io_uring, Event::Dispatcher& dispatcher,
+                  const IoUringFileRingConfig& config);
+  ~IoUringFileRing() override;
+
+  Event::Dispatcher& dispatcher() const { return dispatcher_; }
+
+  // Registers a file with the ring.
+  // @return the index of the file among the registered files, or nullopt if none is free.
+  absl::optional<uint32_t> registerFile(os_fd_t fd);
+  void unregisterFile(uint32_t index);
+
+  // Reads up to length bytes at offset from a file. If file_index is set, the file is read
+  // through its registration rather than fd.
+  CancelFunction read(os_fd_t fd, absl::optional<uint32_t> file_index, off_t offset, size_t length,
+                      std::shared_ptr<void> keep_alive,
+                      absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete);
+
+  // Writes contents at offset to a file, consuming the contents immediately.
+  CancelFunction write(os_fd_t fd, absl::optional<uint32_t> file_index, Buffer::Instance& contents,
+                       off_t offset, std::shared_ptr<void> keep_alive,
+                       absl::AnyInvocable<void(absl::StatusOr<size_t>)> on_complete);
+
+  // Closes a file. The file is closed even if the operation is cancelled.
+  CancelFunction close(os_fd_t fd, std::shared_ptr<void> keep_alive,
+                       absl::AnyInvocable<void(absl::Status)> on_complete);
+
+  // A buffer registered with the ring, which is lent to one operation at a time.
+  struct RegisteredBuffer {
+    uint8_t* data_;
+    int index_;
+  };
+  // @return a free registered buffer of at least size bytes, or nullopt if there is none.
+  absl::optional<RegisteredBuffer> acquireBuffer(size_t size);
+  void releaseBuffer(const RegisteredBuffer& buffer);
+
+  // @return the number of operations which are submitted or waiting to be.
+  size_t pendingOperations() const { return in_flight_ + queued_.size(); }
+
+private:
+  CancelFunction submit(std::unique_ptr<IoUringFileRequest> request);
+  // Prepares queued requests while there is room in the completion queue.
+  void prepareQueued();
+  void onCompletions();
+
+  Event::Dispatcher& dispatcher_;
+  const IoUringFileRingConfig config_;
+  Io::IoUringPtr io_uring_;
+  Event::FileEventPtr file_event_;
+  Event::SchedulableCallbackPtr submit_cb_;
+
+  // The requests owned by the ring until they complete, by their user data.
+  absl::flat_hash_map<Io::Request*, std::unique_ptr<IoUringFileRequest>> requests_;
+  // The requests waiting for room in the ring, in the order they were submitted.
+  std::deque<IoUringFileRequest*> queued_;
+  // The number of requests in the submission or completion queues, which is kept under the size
+  // of the ring so that the completion queue can't overflow.
+  uint32_t in_flight_{};
+
+  std::vector<uint32_t> free_file_indexes_;
+
+  std::unique_ptr<uint8_t[]> buffer_memory_;
+  std::vector<int> free_buffers_;
+};
+
+using IoUringFileRingSharedPtr = std::shared_ptr<IoUringFileRing>;
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <vector>
 
 #include "envoy/event/deferred_deletable.h"
 #include "envoy/extensions/wasm/v3/wasm.pb.h"
@@ -64,6 +65,242 @@ inline Wasm* getWasm(WasmHandleSharedPtr& base_wasm_handle) {
   return static_cast<Wasm*>(base_wasm_handle->wasm().get());
 }
 
+// Helpers reading the Wasm binary format, which consume what they read from the front of data.
+bool readByte(absl::string_view& data, uint8_t& value) {
+  if (data.empty()) {
+    return false;
+  }
+  value = data.front();
+  data.remove_prefix(1);
+  return true;
+}
+
+bool readVarUint32(absl::string_view& data, uint32_t& value) {
+  value = 0;
+  for (uint32_t shift = 0; shift < 35; shift += 7) {
+    uint8_t byte;
+    if (!readByte(data, byte)) {
+      return false;
+    }
+    value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Skips a LEB128 value of up to 64 bits, signed or not.
+bool skipVarInt(absl::string_view& data) {
+  for (int i = 0; i < 10; i++) {
+    uint8_t byte;
+    if (!readByte(data, byte)) {
+      return false;
+    }
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool readBytes(absl::string_view& data, uint64_t size, absl::string_view& bytes) {
+  if (data.size() < size) {
+    return false;
+  }
+  bytes = data.substr(0, size);
+  data.remove_prefix(size);
+  return true;
+}
+
+bool readName(absl::string_view& data, absl::string_view& name) {
+  uint32_t size;
+  return readVarUint32(data, size) && readBytes(data, size, name);
+}
+
+bool skipLimits(absl::string_view& data) {
+  uint8_t flags;
+  if (!readByte(data, flags) || !skipVarInt(data)) {
+    return false;
+  }
+  return (flags & 0x1) == 0 || skipVarInt(data);
+}
+
+// Only the value types which are encoded in a single byte are supported.
+bool readValueType(absl::string_view& data, uint8_t& type) {
+  if (!readByte(data, type)) {
+    return false;
+  }
+  switch (type) {
+  case 0x7f: // i32
+  case 0x7e: // i64
+  case 0x7d: // f32
+  case 0x7c: // f64
+  case 0x7b: // v128
+  case 0x70: // funcref
+  case 0x6f: // externref
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Skips a constant expression, such as the initial value of a global.
+bool skipConstantExpression(absl::string_view& data) {
+  absl::string_view bytes;
+  uint32_t index;
+  while (true) {
+    uint8_t opcode;
+    if (!readByte(data, opcode)) {
+      return false;
+    }
+    switch (opcode) {
+    case 0x0b: // end
+      return true;
+    case 0x41: // i32.const
+    case 0x42: // i64.const
+      if (!skipVarInt(data)) {
+        return false;
+      }
+      break;
+    case 0x43: // f32.const
+      if (!readBytes(data, 4, bytes)) {
+        return false;
+      }
+      break;
+    case 0x44: // f64.const
+      if (!readBytes(data, 8, bytes)) {
+        return false;
+      }
+      break;
+    case 0x23: // global.get
+    case 0xd2: // ref.func
+      if (!readVarUint32(data, index)) {
+        return false;
+      }
+      break;
+    case 0xd0: // ref.null
+      if (!readBytes(data, 1, bytes)) {
+        return false;
+      }
+      break;
+    case 0x6a: // i32.add
+    case 0x6b: // i32.sub
+    case 0x6c: // i32.mul
+    case 0x7c: // i64.add
+    case 0x7d: // i64.sub
+    case 0x7e: // i64.mul
+      break;
+    case 0xfd: // v128.const
+      if (!readVarUint32(data, index) || index != 12 || !readBytes(data, 16, bytes)) {
+        return false;
+      }
+      break;
+    default:
+      return false;
+    }
+  }
+}
+
+// Skips the import section, and counts the imported globals, which must all be immutable.
+bool readImports(absl::string_view data, uint32_t& imported_globals) {
+  uint32_t count;
+  if (!readVarUint32(data, count)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    absl::string_view module, field;
+    uint8_t kind, byte;
+    uint32_t index;
+    if (!readName(data, module) || !readName(data, field) || !readByte(data, kind)) {
+      return false;
+    }
+    switch (kind) {
+    case 0x00: // function
+      if (!readVarUint32(data, index)) {
+        return false;
+      }
+      break;
+    case 0x01: // table
+      if (!readValueType(data, byte) || !skipLimits(data)) {
+        return false;
+      }
+      break;
+    case 0x02: // memory
+      if (!skipLimits(data)) {
+        return false;
+      }
+      break;
+    case 0x03: // global
+      if (!readValueType(data, byte) || !readByte(data, byte) || byte != 0x00) {
+        return false;
+      }
+      imported_globals++;
+      break;
+    case 0x04: // tag
+      if (!readByte(data, byte) || !readVarUint32(data, index)) {
+        return false;
+      }
+      break;
+    default:
+      return false;
+    }
+  }
+  return true;
+}
+
+// The index and type of a global which the module defines as mutable.
+struct MutableGlobal {
+  uint32_t index;
+  uint8_t type;
+};
+
+bool readMutableGlobals(absl::string_view data, uint32_t imported_globals,
+                        std::vector<MutableGlobal>& mutable_globals) {
+  uint32_t count;
+  if (!readVarUint32(data, count)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    uint8_t type, mutability;
+    if (!readValueType(data, type) || !readByte(data, mutability) ||
+        !skipConstantExpression(data)) {
+      return false;
+    }
+    if (mutability != 0x00) {
+      mutable_globals.push_back({imported_globals + i, type});
+    }
+  }
+  return true;
+}
+
+// Reads the names of the globals from the "name" custom section, which is optional.
+bool readGlobalNames(absl::string_view data, absl::flat_hash_map<uint32_t, std::string>& names) {
+  while (!data.empty()) {
+    uint8_t id;
+    absl::string_view subsection;
+    if (!readByte(data, id) || !readName(data, subsection)) {
+      return false;
+    }
+    if (id != 7) {
+      continue;
+    }
+    uint32_t count;
+    if (!readVarUint32(subsection, count)) {
+      return false;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+      uint32_t index;
+      absl::string_view name;
+      if (!readVarUint32(subsection, index) || !readName(subsection, name)) {
+        return false;
+      }
+      names[index] = std::string(name);
+    }
+  }
+  return true;
+}
+
 } // namespace
 
 Wasm::Wasm(WasmConfig& config, absl::string_view vm_key, const Stats::ScopeSharedPtr& scope,
@@ -76,8 +313,10 @@ Wasm::Wasm(WasmConfig& config, absl::string_view vm_key, const Stats::ScopeShare
       scope_(scope), api_(api), stat_name_pool_(scope_->symbolTable()),
       custom_stat_namespace_(stat_name_pool_.add(CustomStatNamespace)),
       cluster_manager_(cluster_manager), dispatcher_(dispatcher),
-      time_source_(dispatcher.timeSource()), lifecycle_stats_handler_(LifecycleStatsHandler(
-                                                 scope, config.config().vm_config().runtime())) {
+      time_source_(dispatcher.timeSource()),
+      lifecycle_stats_handler_(
+          LifecycleStatsHandler(scope, config.config().vm_config().runtime())),
+      snapshot_initialized_memory_(config.config().vm_config().snapshot_initialized_memory()) {
   lifecycle_stats_handler_.onEvent(WasmEvent::VmCreated);
   ENVOY_LOG(debug, "Base Wasm created {} now active", lifecycle_stats_handler_.getActiveVmCount());
 }
@@ -94,7 +333,9 @@ Wasm::Wasm(WasmHandleSharedPtr base_wasm_handle, Event::Dispatcher& dispatcher)
       custom_stat_namespace_(stat_name_pool_.add(CustomStatNamespace)),
       cluster_manager_(getWasm(base_wasm_handle)->clusterManager()), dispatcher_(dispatcher),
       time_source_(dispatcher.timeSource()),
-      lifecycle_stats_handler_(getWasm(base_wasm_handle)->lifecycle_stats_handler_) {
+      lifecycle_stats_handler_(getWasm(base_wasm_handle)->lifecycle_stats_handler_),
+      snapshot_initialized_memory_(false),
+      memory_snapshot_(getWasm(base_wasm_handle)->memory_snapshot_) {
   lifecycle_stats_handler_.onEvent(WasmEvent::VmCreated);
   ENVOY_LOG(debug, "Thread-Local Wasm created {} now active",
             lifecycle_stats_handler_.getActiveVmCount());
@@ -196,6 +437,53 @@ void Wasm::getFunctions() {
   _GET(on_resolve_dns)
   _GET(on_stats_update)
 #undef _GET
+  if (memory_snapshot_ == nullptr) {
+    return;
+  }
+  // The copy has just been linked, and is about to be initialized.
+  if (restoreMemorySnapshot()) {
+    // The base VM ran the initialization before the snapshot was captured.
+    _initialize_ = nullptr;
+    main_ = nullptr;
+    _start_ = nullptr;
+  } else {
+    ENVOY_LOG(warn, "Unable to restore the Wasm memory snapshot, initializing the VM instead");
+  }
+}
+
+void Wasm::captureMemorySnapshot(absl::string_view code) {
+  // The Null VM runs natively, and has no linear memory.
+  if (!snapshot_initialized_memory_ || memory_snapshot_ != nullptr || isFailed() ||
+      wasm_vm()->cloneable() == proxy_wasm::Cloneable::InstantiatedModule ||
+      !Runtime::runtimeFeatureEnabled("envoy.reloadable_features.wasm_memory_snapshots")) {
+    return;
+  }
+  // Only the linear memory can be restored, as the runtimes don't expose the globals of the VM.
+  if (!onlyStackPointerIsMutable(code)) {
+    ENVOY_LOG(warn, "Not capturing a Wasm memory snapshot, as the module has mutable globals "
+                    "other than its stack pointer");
+    return;
+  }
+  auto memory = wasm_vm()->getMemory(0, wasm_vm()->getMemorySize());
+  if (!memory) {
+    ENVOY_LOG(warn, "Unable to capture the Wasm memory snapshot");
+    return;
+  }
+  memory_snapshot_ = std::make_shared<const std::string>(memory.value());
+  ENVOY_LOG(debug, "Captured a Wasm memory snapshot of {} bytes", memory_snapshot_->size());
+}
+
+bool Wasm::restoreMemorySnapshot() {
+  const uint64_t snapshot_size = memory_snapshot_->size();
+  // The copy starts with the initial memory of the module, which the initialization may have
+  // grown. Only the module can grow its memory, and running code of the module before the snapshot
+  // is restored could trap, so the copy is initialized instead.
+  if (wasm_vm()->getMemorySize() < snapshot_size) {
+    ENVOY_LOG(debug, "The Wasm memory snapshot of {} bytes exceeds the initial memory of {} bytes",
+              snapshot_size, wasm_vm()->getMemorySize());
+    return false;
+  }
+  return wasm_vm()->setMemory(0, snapshot_size, memory_snapshot_->data());
 }
 
 proxy_wasm::CallOnThreadFunction Wasm::callOnThreadFunction() {
@@ -230,6 +518,49 @@ void Wasm::onStatsUpdate(const PluginSharedPtr& plugin, Envoy::Stats::MetricSnap
   context->onStatsUpdate(snapshot);
 }
 
+bool onlyStackPointerIsMutable(absl::string_view code) {
+  absl::string_view header;
+  if (!readBytes(code, 8, header) || header != absl::string_view("\0asm\x01\0\0\0", 8)) {
+    return false;
+  }
+  uint32_t imported_globals = 0;
+  std::vector<MutableGlobal> mutable_globals;
+  absl::flat_hash_map<uint32_t, std::string> global_names;
+  while (!code.empty()) {
+    uint8_t id;
+    absl::string_view section;
+    if (!readByte(code, id) || !readName(code, section)) {
+      return false;
+    }
+    absl::string_view custom_section_name;
+    if (id == 2 && !readImports(section, imported_globals)) {
+      return false;
+    }
+    if (id == 6 && !readMutableGlobals(section, imported_globals, mutable_globals)) {
+      return false;
+    }
+    // The names are only used to identify the stack pointer, and are ignored if malformed.
+    if (id == 0 && readName(section, custom_section_name) && custom_section_name == "name" &&
+        !readGlobalNames(section, global_names)) {
+      global_names.clear();
+    }
+  }
+  if (mutable_globals.empty()) {
+    return true;
+  }
+  if (mutable_globals.size() > 1) {
+    return false;
+  }
+  // The stack pointer is named by the toolchains which emit a name section. Without one, it is the
+  // only mutable global of an address type.
+  const MutableGlobal& global = mutable_globals.front();
+  auto name = global_names.find(global.index);
+  if (name != global_names.end()) {
+    return name->second == "__stack_pointer";
+  }
+  return global.type == 0x7f || global.type == 0x7e;
+}
+
 void clearCodeCacheForTesting() {
   std::lock_guard<std::mutex> guard(code_cache_mutex);
   if (code_cache) {
@@ -397,7 +728,10 @@ bool createWasm(const PluginSharedPtr& plugin, const Stats::ScopeSharedPtr& scop
       cb(nullptr);
       return false;
     }
-    cb(std::static_pointer_cast<WasmHandle>(wasm));
+    auto wasm_handle = std::static_pointer_cast<WasmHandle>(wasm);
+    // Before any thread-local copy of the base VM is created from it.
+    getWasm(wasm_handle)->captureMemorySnapshot(code);
+    cb(wasm_handle);
     return true;
   };
 
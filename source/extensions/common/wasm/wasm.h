@@ -4,6 +4,7 @@
 #include <chrono>
 #include <map>
 #include <memory>
+#include <string>
 
 #include "envoy/common/exception.h"
 #include "envoy/extensions/wasm/v3/wasm.pb.h"
@@ -90,10 +91,22 @@ public:
   }
   void setFailStateForTesting(proxy_wasm::FailState fail_state) { failed_ = fail_state; }
 
+  /**
+   * Captures the linear memory of this base VM, once the module has been initialized, for the
+   * thread-local copies of the VM to be restored from instead of initializing the module again.
+   * Does nothing unless enabled in the VM config, if the runtime has no linear memory, or if the
+   * module keeps state in mutable globals, which the snapshot can't include.
+   * @param code the bytecode of the module.
+   */
+  void captureMemorySnapshot(absl::string_view code);
+  bool hasMemorySnapshot() const { return memory_snapshot_ != nullptr; }
+
 protected:
   friend class Context;
 
   void initializeStats();
+  // Restores the memory snapshot of the base VM into this copy of it.
+  bool restoreMemorySnapshot();
   // Calls into the VM.
   proxy_wasm::WasmCallVoid<3> on_resolve_dns_;
   proxy_wasm::WasmCallVoid<2> on_stats_update_;
@@ -119,6 +132,11 @@ protected:
   CreateContextFn create_root_context_for_testing_;
   Network::DnsResolverSharedPtr dns_resolver_;
   uint32_t dns_token_ = 1;
+
+  const bool snapshot_initialized_memory_;
+  // The memory of the base VM after initialization, shared by all its thread-local copies. Set on
+  // the main thread before the base VM is handed to the workers.
+  std::shared_ptr<const std::string> memory_snapshot_;
 };
 using WasmSharedPtr = std::shared_ptr<Wasm>;
 
@@ -180,6 +198,14 @@ getOrCreateThreadLocalPlugin(const WasmHandleSharedPtr& base_wasm, const PluginS
                              Event::Dispatcher& dispatcher,
                              CreateContextFn create_root_context_for_testing = nullptr);
 
+/**
+ * @param code the bytecode of a Wasm module.
+ * @return whether the module has no mutable globals other than its stack pointer, which is back to
+ *         its initial value once the initialization of the module has returned. False if the
+ *         bytecode can't be parsed.
+ */
+bool onlyStackPointerIsMutable(absl::string_view code);
+
 void clearCodeCacheForTesting();
 void setTimeOffsetForCodeCacheForTesting(MonotonicTime::duration d);
 WasmEvent toWasmEvent(const std::shared_ptr<WasmHandleBase>& wasm);
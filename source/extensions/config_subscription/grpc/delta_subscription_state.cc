@@ -157,6 +157,17 @@ UpdateAck DeltaSubscriptionState::handleResponse(
   return ack;
 }
 
+absl::Status DeltaSubscriptionState::handlePersistedResources(
+    envoy::service::discovery::v3::DeltaDiscoveryResponse& message) {
+  TRY_ASSERT_MAIN_THREAD { handleGoodResponse(message); }
+  END_TRY
+  catch (const EnvoyException& e) {
+    ENVOY_LOG(warn, "persisted delta config for {} rejected: {}", type_url_, e.what());
+    return absl::InvalidArgumentError(e.what());
+  }
+  return absl::OkStatus();
+}
+
 bool DeltaSubscriptionState::isHeartbeatResponse(
     const envoy::service::discovery::v3::Resource& resource) const {
   if (!supports_heartbeats_) {
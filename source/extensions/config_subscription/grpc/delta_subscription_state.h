@@ -98,6 +98,12 @@ public:
   // May modify the order of resources to put all the non-heartbeat resources first.
   UpdateAck handleResponse(envoy::service::discovery::v3::DeltaDiscoveryResponse& message);
 
+  // Applies resources that were not received from the server (e.g. the ones persisted by an xDS
+  // resources delegate) as if they had been. Unlike handleResponse(), nothing is ACKed and a
+  // rejection is not reported to the watches.
+  absl::Status
+  handlePersistedResources(envoy::service::discovery::v3::DeltaDiscoveryResponse& message);
+
   void handleEstablishmentFailure();
 
   // Returns the next gRPC request proto to be sent off to the server, based on this object's
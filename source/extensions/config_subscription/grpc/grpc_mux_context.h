@@ -9,6 +9,7 @@
 #include "envoy/grpc/async_client.h"
 #include "envoy/local_info/local_info.h"
 #include "envoy/stats/scope.h"
+#include "envoy/thread/thread.h"
 
 #include "source/common/config/utility.h"
 
@@ -31,6 +32,11 @@ struct GrpcMuxContext {
   BackOffStrategyPtr backoff_strategy_;
   const std::string& target_xds_authority_;
   EdsResourcesCachePtr eds_resources_cache_;
+  // The number of threads decoding resources off the main thread, or zero to decode them on the
+  // main thread. Only supported by the state-of-the-world GrpcMuxImpl.
+  uint32_t resource_decode_threads_;
+  // Creates the resource decoding threads.
+  Thread::ThreadFactory& thread_factory_;
 };
 
 } // namespace Config
@@ -72,6 +72,11 @@ GrpcMuxImpl::GrpcMuxImpl(GrpcMuxContext& grpc_mux_context, bool skip_subsequent_
       xds_resources_delegate_(grpc_mux_context.xds_resources_delegate_),
       eds_resources_cache_(std::move(grpc_mux_context.eds_resources_cache_)),
       target_xds_authority_(grpc_mux_context.target_xds_authority_),
+      resource_decode_pool_(grpc_mux_context.resource_decode_threads_ > 0
+                                ? std::make_unique<ResourceDecodePool>(
+                                      grpc_mux_context.thread_factory_,
+                                      grpc_mux_context.resource_decode_threads_)
+                                : nullptr),
       dynamic_update_callback_handle_(
           grpc_mux_context.local_info_.contextProvider().addDynamicContextUpdateCallback(
               [this](absl::string_view resource_type_url) {
@@ -144,7 +149,15 @@ GrpcMuxImpl::createGrpcStreamObject(Grpc::RawAsyncClientPtr&& async_client,
           envoy::service::discovery::v3::DiscoveryResponse>::ConnectedStateValue::FIRST_ENTRY);
 }
 
-GrpcMuxImpl::~GrpcMuxImpl() { AllMuxes::get().erase(this); }
+GrpcMuxImpl::~GrpcMuxImpl() {
+  AllMuxes::get().erase(this);
+  // Stop any in-flight decoding before the rest of the mux goes away. Its pending resume must not
+  // run, as it would send a discovery request on behalf of a mux that is being destroyed.
+  resource_decode_pool_.reset();
+  if (decode_in_flight_resume_ != nullptr) {
+    decode_in_flight_resume_->cancel();
+  }
+}
 
 void GrpcMuxImpl::shutdownAll() { AllMuxes::get().shutdownAll(); }
 
@@ -357,7 +370,7 @@ ScopedResume GrpcMuxImpl::pause(const std::vector<std::string> type_urls) {
 void GrpcMuxImpl::onDiscoveryResponse(
     std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& message,
     ControlPlaneStats& control_plane_stats) {
-  const std::string type_url = message->type_url();
+  const std::string& type_url = message->type_url();
   ENVOY_LOG(debug, "Received gRPC message for {} at version {}", type_url, message->version_info());
 
   if (api_state_.count(type_url) == 0) {
@@ -380,6 +393,20 @@ void GrpcMuxImpl::onDiscoveryResponse(
     }
   }
 
+  if (decode_in_flight_resume_ != nullptr) {
+    // Responses are processed in the order in which they were received, so anything that arrives
+    // while the resources of an earlier response are being decoded has to wait for it.
+    pending_responses_.push(std::move(message));
+    return;
+  }
+  handleDiscoveryResponse(std::move(message));
+}
+
+void GrpcMuxImpl::handleDiscoveryResponse(
+    std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& message) {
+  const std::string type_url = message->type_url();
+  ApiState& api_state = apiStateFor(type_url);
+
   if (api_state.watches_.empty()) {
     // update the nonce as we are processing this response.
     api_state.request_.set_response_nonce(message->nonce());
@@ -404,10 +431,8 @@ void GrpcMuxImpl::onDiscoveryResponse(
   // the delta state. The proper fix for this is to converge these implementations,
   // see https://github.com/envoyproxy/envoy/issues/11477.
   same_type_resume = pause(type_url);
+  OpaqueResourceDecoderSharedPtr resource_decoder = api_state.watches_.front()->resource_decoder_;
   TRY_ASSERT_MAIN_THREAD {
-    std::vector<DecodedResourcePtr> resources;
-    OpaqueResourceDecoder& resource_decoder = *api_state.watches_.front()->resource_decoder_;
-
     for (const auto& resource : message->resources()) {
       // TODO(snowp): Check the underlying type when the resource is a Resource.
       if (!resource.Is<envoy::service::discovery::v3::Resource>() &&
@@ -416,38 +441,74 @@ void GrpcMuxImpl::onDiscoveryResponse(
             fmt::format("{} does not match the message-wide type URL {} in DiscoveryResponse {}",
                         resource.type_url(), type_url, message->DebugString()));
       }
-
-      auto decoded_resource = THROW_OR_RETURN_VALUE(
-          DecodedResourceImpl::fromResource(resource_decoder, resource, message->version_info()),
-          DecodedResourceImplPtr);
-
-      if (!isHeartbeatResource(type_url, *decoded_resource)) {
-        resources.emplace_back(std::move(decoded_resource));
-      }
     }
 
-    processDiscoveryResources(resources, api_state, type_url, message->version_info(),
-                              /*call_delegate=*/true);
+    if (resource_decode_pool_ != nullptr && resource_decoder->supportsConcurrentDecoding()) {
+      // The resources are decoded off the main thread. The type stays paused until they have been
+      // applied, so that the ACK/NACK for this response is only sent afterwards.
+      decode_in_flight_resume_ = std::move(same_type_resume);
+      resource_decode_pool_->decode(
+          dispatcher_, resource_decoder, std::move(message),
+          [this, resource_decoder, stream_generation = stream_generation_](
+              std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& message,
+              absl::StatusOr<std::vector<DecodedResourcePtr>>&& resources_or_error) {
+            if (stream_generation == stream_generation_) {
+              onResourcesDecoded(std::move(message), *resource_decoder,
+                                 std::move(resources_or_error));
+            } else {
+              // The stream was re-established while decoding; the server will send the current
+              // state of the resources on the new stream, and the nonce of this response is no
+              // longer valid.
+              ENVOY_LOG(debug, "Dropping decoded gRPC message for {} from a previous stream",
+                        message->type_url());
+            }
+            decode_in_flight_resume_.reset();
+            while (decode_in_flight_resume_ == nullptr && !pending_responses_.empty()) {
+              auto pending_message = std::move(pending_responses_.front());
+              pending_responses_.pop();
+              handleDiscoveryResponse(std::move(pending_message));
+            }
+          });
+      return;
+    }
 
-    // Processing point when resources are successfully ingested.
-    if (xds_config_tracker_.has_value()) {
-      xds_config_tracker_->onConfigAccepted(type_url, resources);
+    std::vector<DecodedResourcePtr> resources;
+    for (const auto& resource : message->resources()) {
+      resources.emplace_back(THROW_OR_RETURN_VALUE(
+          DecodedResourceImpl::fromResource(*resource_decoder, resource, message->version_info()),
+          DecodedResourceImplPtr));
     }
+    applyDecodedResources(api_state, type_url, message->version_info(), std::move(resources));
   }
   END_TRY
   catch (const EnvoyException& e) {
-    for (auto watch : api_state.watches_) {
-      watch->callbacks_.onConfigUpdateFailed(
-          Envoy::Config::ConfigUpdateFailureReason::UpdateRejected, &e);
-    }
-    ::google::rpc::Status* error_detail = api_state.request_.mutable_error_detail();
-    error_detail->set_code(Grpc::Status::WellKnownGrpcStatus::Internal);
-    error_detail->set_message(Config::Utility::truncateGrpcStatusMessage(e.what()));
+    onDiscoveryResponseRejected(api_state, *message, e);
+  }
+  api_state.previously_fetched_data_ = true;
+  api_state.request_.set_response_nonce(message->nonce());
+  ASSERT(api_state.paused());
+  queueDiscoveryRequest(type_url);
+}
 
-    // Processing point when there is any exception during the parse and ingestion process.
-    if (xds_config_tracker_.has_value()) {
-      xds_config_tracker_->onConfigRejected(*message, error_detail->message());
+void GrpcMuxImpl::onResourcesDecoded(
+    std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& message,
+    OpaqueResourceDecoder& resource_decoder,
+    absl::StatusOr<std::vector<DecodedResourcePtr>>&& resources_or_error) {
+  const std::string& type_url = message->type_url();
+  ApiState& api_state = apiStateFor(type_url);
+  TRY_ASSERT_MAIN_THREAD {
+    THROW_IF_NOT_OK_REF(resources_or_error.status());
+    for (const auto& resource : resources_or_error.value()) {
+      if (resource->hasResource()) {
+        resource_decoder.validateDecodedResource(resource->resource());
+      }
     }
+    applyDecodedResources(api_state, type_url, message->version_info(),
+                          std::move(resources_or_error.value()));
+  }
+  END_TRY
+  catch (const EnvoyException& e) {
+    onDiscoveryResponseRejected(api_state, *message, e);
   }
   api_state.previously_fetched_data_ = true;
   api_state.request_.set_response_nonce(message->nonce());
@@ -455,6 +516,43 @@ void GrpcMuxImpl::onDiscoveryResponse(
   queueDiscoveryRequest(type_url);
 }
 
+void GrpcMuxImpl::applyDecodedResources(ApiState& api_state, const std::string& type_url,
+                                        const std::string& version_info,
+                                        std::vector<DecodedResourcePtr>&& decoded_resources) {
+  std::vector<DecodedResourcePtr> resources;
+  resources.reserve(decoded_resources.size());
+  for (auto& decoded_resource : decoded_resources) {
+    if (!isHeartbeatResource(type_url, *decoded_resource)) {
+      resources.emplace_back(std::move(decoded_resource));
+    }
+  }
+
+  processDiscoveryResources(resources, api_state, type_url, version_info,
+                            /*call_delegate=*/true);
+
+  // Processing point when resources are successfully ingested.
+  if (xds_config_tracker_.has_value()) {
+    xds_config_tracker_->onConfigAccepted(type_url, resources);
+  }
+}
+
+void GrpcMuxImpl::onDiscoveryResponseRejected(
+    ApiState& api_state, const envoy::service::discovery::v3::DiscoveryResponse& message,
+    const EnvoyException& e) {
+  for (auto watch : api_state.watches_) {
+    watch->callbacks_.onConfigUpdateFailed(
+        Envoy::Config::ConfigUpdateFailureReason::UpdateRejected, &e);
+  }
+  ::google::rpc::Status* error_detail = api_state.request_.mutable_error_detail();
+  error_detail->set_code(Grpc::Status::WellKnownGrpcStatus::Internal);
+  error_detail->set_message(Config::Utility::truncateGrpcStatusMessage(e.what()));
+
+  // Processing point when there is any exception during the parse and ingestion process.
+  if (xds_config_tracker_.has_value()) {
+    xds_config_tracker_->onConfigRejected(message, error_detail->message());
+  }
+}
+
 void GrpcMuxImpl::processDiscoveryResources(const std::vector<DecodedResourcePtr>& resources,
                                             ApiState& api_state, const std::string& type_url,
                                             const std::string& version_info,
@@ -562,6 +660,10 @@ void GrpcMuxImpl::processDiscoveryResources(const std::vector<DecodedResourcePtr
 void GrpcMuxImpl::onWriteable() { drainRequests(); }
 
 void GrpcMuxImpl::onStreamEstablished() {
+  // Responses received on the previous stream that have not been processed yet are dropped, as
+  // their nonces are not valid on the new stream.
+  ++stream_generation_;
+  pending_responses_ = {};
   first_stream_request_ = true;
   grpc_stream_->maybeUpdateQueueSizeStat(0);
   clearNonce();
@@ -660,7 +762,8 @@ public:
   void shutdownAll() override { return GrpcMuxImpl::shutdownAll(); }
   std::shared_ptr<GrpcMux>
   create(Grpc::RawAsyncClientPtr&& async_client, Grpc::RawAsyncClientPtr&& failover_async_client,
-         Event::Dispatcher& dispatcher, Random::RandomGenerator&, Stats::Scope& scope,
+         Event::Dispatcher& dispatcher, Api::Api& api, Random::RandomGenerator&,
+         Stats::Scope& scope,
          const envoy::config::core::v3::ApiConfigSource& ads_config,
          const LocalInfo::LocalInfo& local_info, CustomConfigValidatorsPtr&& config_validators,
          BackOffStrategyPtr&& backoff_strategy, XdsConfigTrackerOptRef xds_config_tracker,
@@ -687,7 +790,9 @@ public:
         (use_eds_resources_cache &&
          Runtime::runtimeFeatureEnabled("envoy.restart_features.use_eds_cache_for_ads"))
             ? std::make_unique<EdsResourcesCacheImpl>(dispatcher)
-            : nullptr};
+            : nullptr,
+        /*resource_decode_threads_=*/ads_config.resource_decode_threads(),
+        /*thread_factory_=*/api.threadFactory()};
     return std::make_shared<Config::GrpcMuxImpl>(grpc_mux_context,
                                                  ads_config.set_node_on_first_message_only());
   }
@@ -28,6 +28,7 @@
 #include "source/common/config/xds_resource.h"
 #include "source/extensions/config_subscription/grpc/grpc_mux_context.h"
 #include "source/extensions/config_subscription/grpc/grpc_mux_failover.h"
+#include "source/extensions/config_subscription/grpc/resource_decode_pool.h"
 
 #include "absl/container/node_hash_map.h"
 #include "xds/core/v3/resource_name.pb.h"
@@ -79,6 +80,7 @@ public:
                   BackOffStrategyPtr&& backoff_strategy,
                   const envoy::config::core::v3::ApiConfigSource& ads_config_source) override;
 
+  // Processes a discovery response, once all previously received responses have been processed.
   void handleDiscoveryResponse(
       std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& message);
 
@@ -104,6 +106,8 @@ public:
     return *grpc_stream_.get();
   }
 
+  ResourceDecodePool* resourceDecodePoolForTest() { return resource_decode_pool_.get(); }
+
 private:
   // Helper function to create the grpc_stream_ object.
   std::unique_ptr<GrpcStreamInterface<envoy::service::discovery::v3::DiscoveryRequest,
@@ -279,6 +283,17 @@ private:
   void processDiscoveryResources(const std::vector<DecodedResourcePtr>& resources,
                                  ApiState& api_state, const std::string& type_url,
                                  const std::string& version_info, bool call_delegate);
+  // Invoked on the main thread once the resource decode pool decoded the resources of a response.
+  void onResourcesDecoded(std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& message,
+                          OpaqueResourceDecoder& resource_decoder,
+                          absl::StatusOr<std::vector<DecodedResourcePtr>>&& resources_or_error);
+  // Drops heartbeats and applies the decoded resources of a response to the watches.
+  void applyDecodedResources(ApiState& api_state, const std::string& type_url,
+                             const std::string& version_info,
+                             std::vector<DecodedResourcePtr>&& decoded_resources);
+  void onDiscoveryResponseRejected(ApiState& api_state,
+                                   const envoy::service::discovery::v3::DiscoveryResponse& message,
+                                   const EnvoyException& e);
 
   Event::Dispatcher& dispatcher_;
   // Multiplexes the stream to the primary and failover sources.
@@ -294,6 +309,8 @@ private:
   XdsResourcesDelegateOptRef xds_resources_delegate_;
   EdsResourcesCachePtr eds_resources_cache_;
   const std::string target_xds_authority_;
+  // If set, the resources of discovery responses are decoded off the main thread.
+  ResourceDecodePoolPtr resource_decode_pool_;
   bool first_stream_request_{true};
 
   // Helper function for looking up and potentially allocating a new ApiState.
@@ -316,6 +333,14 @@ private:
   // True iff Envoy is shutting down; no messages should be sent on the `grpc_stream_` when this is
   // true because it may contain dangling pointers.
   std::atomic<bool> shutdown_{false};
+
+  // Holds the pause of the type whose resources are being decoded by resource_decode_pool_, if
+  // any. Responses received in the meantime are queued in pending_responses_.
+  ScopedResume decode_in_flight_resume_;
+  std::queue<std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>> pending_responses_;
+  // Incremented whenever a new stream is established, to discard the decoding results of
+  // responses received on a previous stream.
+  uint64_t stream_generation_{0};
 };
 
 using GrpcMuxImplPtr = std::unique_ptr<GrpcMuxImpl>;
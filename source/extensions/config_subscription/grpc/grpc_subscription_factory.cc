@@ -47,8 +47,9 @@ GrpcConfigSubscriptionFactory::create(ConfigSubscriptionFactory::SubscriptionDat
       /*xds_config_tracker_=*/data.xds_config_tracker_,
       /*backoff_strategy_=*/std::move(backoff_strategy),
       /*target_xds_authority_=*/control_plane_id,
-      /*eds_resources_cache_=*/nullptr // EDS cache is only used for ADS.
-  };
+      /*eds_resources_cache_=*/nullptr, // EDS cache is only used for ADS.
+      /*resource_decode_threads_=*/api_config_source.resource_decode_threads(),
+      /*thread_factory_=*/data.api_.threadFactory()};
 
   if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.unified_mux")) {
     mux = std::make_shared<Config::XdsMux::GrpcMuxSotw>(
@@ -70,6 +71,7 @@ DeltaGrpcConfigSubscriptionFactory::create(ConfigSubscriptionFactory::Subscripti
       data.config_.api_config_source();
   CustomConfigValidatorsPtr custom_config_validators = std::make_unique<CustomConfigValidatorsImpl>(
       data.validation_visitor_, data.server_, api_config_source.config_validators());
+  const std::string control_plane_id = Utility::getGrpcControlPlane(api_config_source).value_or("");
 
   auto strategy_or_error = Utility::prepareJitteredExponentialBackOffStrategy(
       api_config_source, data.api_.randomGenerator(), SubscriptionFactory::RetryInitialDelayMs,
@@ -94,12 +96,13 @@ DeltaGrpcConfigSubscriptionFactory::create(ConfigSubscriptionFactory::Subscripti
       /*rate_limit_settings_=*/rate_limit_settings_or_error.value(),
       /*scope_=*/data.scope_,
       /*config_validators_=*/std::move(custom_config_validators),
-      /*xds_resources_delegate_=*/{},
+      /*xds_resources_delegate_=*/data.xds_resources_delegate_,
       /*xds_config_tracker_=*/data.xds_config_tracker_,
       /*backoff_strategy_=*/std::move(backoff_strategy),
-      /*target_xds_authority_=*/"",
-      /*eds_resources_cache_=*/nullptr // EDS cache is only used for ADS.
-  };
+      /*target_xds_authority_=*/control_plane_id,
+      /*eds_resources_cache_=*/nullptr, // EDS cache is only used for ADS.
+      /*resource_decode_threads_=*/0,
+      /*thread_factory_=*/data.api_.threadFactory()};
 
   if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.unified_mux")) {
     mux = std::make_shared<Config::XdsMux::GrpcMuxDelta>(
@@ -12,6 +12,7 @@
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/protobuf/utility.h"
 #include "source/extensions/config_subscription/grpc/eds_resources_cache_impl.h"
+#include "source/extensions/config_subscription/grpc/xds_source_id.h"
 
 namespace Envoy {
 namespace Config {
@@ -51,7 +52,13 @@ NewGrpcMuxImpl::NewGrpcMuxImpl(GrpcMuxContext& grpc_mux_context)
                 return absl::OkStatus();
               })),
       xds_config_tracker_(grpc_mux_context.xds_config_tracker_),
+      xds_resources_delegate_(grpc_mux_context.xds_resources_delegate_),
+      target_xds_authority_(grpc_mux_context.target_xds_authority_),
       eds_resources_cache_(std::move(grpc_mux_context.eds_resources_cache_)) {
+  if (xds_resources_delegate_.has_value()) {
+    delegate_load_cb_ =
+        dispatcher_.createSchedulableCallback([this]() { loadPendingFromDelegate(); });
+  }
   AllMuxes::get().insert(this);
 }
 
@@ -183,11 +190,24 @@ void NewGrpcMuxImpl::onDiscoveryResponse(
       ack.error_detail_.code() != Grpc::Status::WellKnownGrpcStatus::Ok) {
     xds_config_tracker_->onConfigRejected(*message, ack.error_detail_.message());
   }
+  // The update has been applied, so hand it to the xDS resources delegate, if any.
+  if (xds_resources_delegate_.has_value() &&
+      ack.error_detail_.code() == Grpc::Status::WellKnownGrpcStatus::Ok) {
+    xds_resources_delegate_->onDeltaConfigUpdated(
+        XdsConfigSourceId{target_xds_authority_, message->type_url()}, message->resources(),
+        message->removed_resources());
+  }
   kickOffAck(ack);
   Memory::Utils::tryShrinkHeap();
 }
 
 void NewGrpcMuxImpl::onStreamEstablished() {
+  // Apply the persisted resources before the first requests on the stream are built, so that they
+  // carry the versions of these resources as initial_resource_versions.
+  if (!pending_delegate_loads_.empty()) {
+    delegate_load_cb_->cancel();
+    loadPendingFromDelegate();
+  }
   for (auto& [type_url, subscription] : subscriptions_) {
     UNREFERENCED_PARAMETER(type_url);
     subscription->sub_state_.markStreamFresh(should_send_initial_resource_versions_);
@@ -363,6 +383,47 @@ void NewGrpcMuxImpl::addSubscription(const std::string& type_url,
                                                     dispatcher_, config_validators_.get(),
                                                     xds_config_tracker_, resources_cache));
   subscription_ordering_.emplace_back(type_url);
+  if (xds_resources_delegate_.has_value()) {
+    // The persisted resources are loaded once the watch that caused this subscription to be added
+    // is in place.
+    pending_delegate_loads_.insert(type_url);
+    delegate_load_cb_->scheduleCallbackCurrentIteration();
+  }
+}
+
+void NewGrpcMuxImpl::loadPendingFromDelegate() {
+  // Loading may add subscriptions (e.g. CDS adding EDS watches), which are loaded in turn.
+  while (!pending_delegate_loads_.empty()) {
+    const std::string type_url = *pending_delegate_loads_.begin();
+    pending_delegate_loads_.erase(pending_delegate_loads_.begin());
+    auto sub = subscriptions_.find(type_url);
+    if (sub != subscriptions_.end()) {
+      loadFromDelegate(type_url, *sub->second);
+    }
+  }
+  trySendDiscoveryRequests();
+}
+
+void NewGrpcMuxImpl::loadFromDelegate(const std::string& type_url, SubscriptionStuff& sub) {
+  const XdsConfigSourceId source_id{target_xds_authority_, type_url};
+  std::vector<envoy::service::discovery::v3::Resource> resources =
+      xds_resources_delegate_->getResources(source_id, {});
+  if (resources.empty()) {
+    return;
+  }
+  ENVOY_LOG(debug, "Loading {} persisted resources for {}", resources.size(), type_url);
+  envoy::service::discovery::v3::DeltaDiscoveryResponse message;
+  message.set_type_url(type_url);
+  for (auto& resource : resources) {
+    *message.add_resources() = std::move(resource);
+  }
+  const absl::Status status = sub.sub_state_.handlePersistedResources(message);
+  if (!status.ok()) {
+    const EnvoyException e(std::string(status.message()));
+    for (const auto& resource : message.resources()) {
+      xds_resources_delegate_->onResourceLoadFailed(source_id, resource.name(), e);
+    }
+  }
 }
 
 void NewGrpcMuxImpl::trySendDiscoveryRequests() {
@@ -438,7 +499,7 @@ absl::optional<std::string> NewGrpcMuxImpl::whoWantsToSendDiscoveryRequest() {
   for (const auto& sub_type : subscription_ordering_) {
     auto sub = subscriptions_.find(sub_type);
     if (sub != subscriptions_.end() && sub->second->sub_state_.subscriptionUpdatePending() &&
-        !pausable_ack_queue_.paused(sub_type)) {
+        !pausable_ack_queue_.paused(sub_type) && !pending_delegate_loads_.contains(sub_type)) {
       return sub->first;
     }
   }
@@ -453,11 +514,12 @@ public:
   void shutdownAll() override { return NewGrpcMuxImpl::shutdownAll(); }
   std::shared_ptr<GrpcMux>
   create(Grpc::RawAsyncClientPtr&& async_client, Grpc::RawAsyncClientPtr&& failover_async_client,
-         Event::Dispatcher& dispatcher, Random::RandomGenerator&, Stats::Scope& scope,
+         Event::Dispatcher& dispatcher, Api::Api& api, Random::RandomGenerator&,
+         Stats::Scope& scope,
          const envoy::config::core::v3::ApiConfigSource& ads_config,
          const LocalInfo::LocalInfo& local_info, CustomConfigValidatorsPtr&& config_validators,
          BackOffStrategyPtr&& backoff_strategy, XdsConfigTrackerOptRef xds_config_tracker,
-         OptRef<XdsResourcesDelegate>, bool use_eds_resources_cache) override {
+         XdsResourcesDelegateOptRef xds_resources_delegate, bool use_eds_resources_cache) override {
     absl::StatusOr<RateLimitSettings> rate_limit_settings_or_error =
         Utility::parseRateLimitSettings(ads_config);
     THROW_IF_NOT_OK_REF(rate_limit_settings_or_error.status());
@@ -472,7 +534,7 @@ public:
         /*rate_limit_settings_=*/rate_limit_settings_or_error.value(),
         /*scope_=*/scope,
         /*config_validators_=*/std::move(config_validators),
-        /*xds_resources_delegate_=*/absl::nullopt,
+        /*xds_resources_delegate_=*/xds_resources_delegate,
         /*xds_config_tracker_=*/xds_config_tracker,
         /*backoff_strategy_=*/std::move(backoff_strategy),
         /*target_xds_authority_=*/"",
@@ -480,7 +542,9 @@ public:
         (use_eds_resources_cache &&
          Runtime::runtimeFeatureEnabled("envoy.restart_features.use_eds_cache_for_ads"))
             ? std::make_unique<EdsResourcesCacheImpl>(dispatcher)
-            : nullptr};
+            : nullptr,
+        /*resource_decode_threads_=*/0,
+        /*thread_factory_=*/api.threadFactory()};
     return std::make_shared<Config::NewGrpcMuxImpl>(grpc_mux_context);
   }
 };
@@ -8,6 +8,7 @@
 #include "envoy/config/grpc_mux.h"
 #include "envoy/config/subscription.h"
 #include "envoy/config/xds_config_tracker.h"
+#include "envoy/config/xds_resources_delegate.h"
 #include "envoy/service/discovery/v3/discovery.pb.h"
 
 #include "source/common/common/logger.h"
@@ -175,6 +176,14 @@ private:
   // Adds a subscription for the type_url to the subscriptions map and order list.
   void addSubscription(const std::string& type_url, bool use_namespace_matching);
 
+  // Loads the resources persisted by the xDS resources delegate for all subscriptions that have
+  // not been loaded yet, and sends the discovery requests that were held back until then.
+  void loadPendingFromDelegate();
+
+  // Applies the resources persisted by the xDS resources delegate for the type_url to its
+  // subscription, as if they had been received from the server.
+  void loadFromDelegate(const std::string& type_url, SubscriptionStuff& sub);
+
   void trySendDiscoveryRequests();
 
   // Checks whether external conditions allow sending a DeltaDiscoveryRequest. (Does not check
@@ -216,7 +225,14 @@ private:
   CustomConfigValidatorsPtr config_validators_;
   Common::CallbackHandlePtr dynamic_update_callback_handle_;
   XdsConfigTrackerOptRef xds_config_tracker_;
+  XdsResourcesDelegateOptRef xds_resources_delegate_;
+  const std::string target_xds_authority_;
   EdsResourcesCachePtr eds_resources_cache_;
+  // Type URLs of the subscriptions whose persisted resources have not been loaded from the xDS
+  // resources delegate yet. No discovery requests are sent for them until then, so that their
+  // first request carries the versions of the persisted resources.
+  absl::flat_hash_set<std::string> pending_delegate_loads_;
+  Event::SchedulableCallbackPtr delegate_load_cb_;
 
   // Used to track whether initial_resource_versions should be populated on the
   // next reconnection.
@@ -0,0 +1,206 @@
+#include "source/extensions/config_subscription/grpc/resource_decode_pool.h"
+
+#include <algorithm>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/thread.h"
+#include "source/common/config/decoded_resource_impl.h"
+
+namespace Envoy {
+namespace Config {
+
+namespace {
+
+// Each thread is handed a few chunks of a response so that uneven resource sizes (e.g. one huge
+// ClusterLoadAssignment among many small ones) do not leave the other threads idle.
+constexpr uint32_t ChunksPerThread = 4;
+
+// Adapts a decoder supporting concurrent decoding so that DecodedResourceImpl, which decodes in
+// its constructor, uses the thread-safe decoding path.
+class ConcurrentResourceDecoder : public OpaqueResourceDecoder {
+public:
+  explicit ConcurrentResourceDecoder(OpaqueResourceDecoder& parent) : parent_(parent) {}
+
+  // Config::OpaqueResourceDecoder
+  ProtobufTypes::MessagePtr decodeResource(const ProtobufWkt::Any& resource) override {
+    return parent_.decodeResourceConcurrently(resource);
+  }
+  std::string resourceName(const Protobuf::Message& resource) override {
+    return parent_.resourceName(resource);
+  }
+
+private:
+  OpaqueResourceDecoder& parent_;
+};
+
+} // namespace
+
+struct ResourceDecodePool::DecodeBatch {
+  DecodeBatch(Event::Dispatcher& dispatcher, OpaqueResourceDecoderSharedPtr resource_decoder,
+              std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& message,
+              DecodeCompleteCb on_complete)
+      : dispatcher_(dispatcher), resource_decoder_(std::move(resource_decoder)),
+        message_(std::move(message)), on_complete_(std::move(on_complete)),
+        resources_(message_->resources_size()) {}
+
+  // Records the failure of the resource at the given index, keeping the first one in response
+  // order so that the reported error does not depend on thread scheduling.
+  void onError(int index, absl::Status status) ABSL_LOCKS_EXCLUDED(error_mutex_) {
+    absl::MutexLock lock(&error_mutex_);
+    if (error_index_ < 0 || index < error_index_) {
+      error_index_ = index;
+      error_ = std::move(status);
+    }
+  }
+
+  // @return whether a resource preceding the given index already failed to decode, in which case
+  // decoding the resource is pointless.
+  bool failedBefore(int index) ABSL_LOCKS_EXCLUDED(error_mutex_) {
+    absl::MutexLock lock(&error_mutex_);
+    return error_index_ >= 0 && error_index_ < index;
+  }
+
+  Event::Dispatcher& dispatcher_;
+  OpaqueResourceDecoderSharedPtr resource_decoder_;
+  std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse> message_;
+  DecodeCompleteCb on_complete_;
+  // Indexed as message_->resources(), each entry is only written by the thread decoding it.
+  std::vector<DecodedResourcePtr> resources_;
+  std::atomic<uint32_t> pending_chunks_{0};
+  absl::Mutex error_mutex_;
+  int error_index_ ABSL_GUARDED_BY(error_mutex_) = -1;
+  absl::Status error_ ABSL_GUARDED_BY(error_mutex_);
+};
+
+ResourceDecodePool::ResourceDecodePool(Thread::ThreadFactory& thread_factory,
+                                       uint32_t concurrency) {
+  ASSERT(concurrency > 0);
+  ENVOY_LOG(debug, "xDS resource decode pool created with {} threads", concurrency);
+  const Thread::Options options{"xds_decode"};
+  thread_pool_.reserve(concurrency);
+  while (thread_pool_.size() < concurrency) {
+    thread_pool_.push_back(thread_factory.createThread([this]() { worker(); }, options));
+  }
+}
+
+ResourceDecodePool::~ResourceDecodePool() ABSL_LOCKS_EXCLUDED(queue_mutex_) {
+  {
+    absl::MutexLock lock(&queue_mutex_);
+    terminate_ = true;
+    // Outstanding work would never be delivered, so there is no point in performing it.
+    queue_ = {};
+  }
+  while (!thread_pool_.empty()) {
+    thread_pool_.back()->join();
+    thread_pool_.pop_back();
+  }
+  // Only reset once the threads are gone, as they copy it when posting completions.
+  alive_.reset();
+}
+
+void ResourceDecodePool::decode(
+    Event::Dispatcher& dispatcher, OpaqueResourceDecoderSharedPtr resource_decoder,
+    std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& message,
+    DecodeCompleteCb on_complete) {
+  ASSERT(resource_decoder->supportsConcurrentDecoding());
+  auto batch = std::make_shared<DecodeBatch>(dispatcher, std::move(resource_decoder),
+                                             std::move(message), std::move(on_complete));
+  const int num_resources = batch->message_->resources_size();
+  if (num_resources == 0) {
+    completeBatch(std::move(batch));
+    return;
+  }
+
+  const int num_chunks = std::min<int>(num_resources, thread_pool_.size() * ChunksPerThread);
+  const int chunk_size = (num_resources + num_chunks - 1) / num_chunks;
+  std::vector<DecodeChunk> chunks;
+  for (int begin = 0; begin < num_resources; begin += chunk_size) {
+    chunks.push_back({batch, begin, std::min(begin + chunk_size, num_resources)});
+  }
+  batch->pending_chunks_ = chunks.size();
+
+  absl::MutexLock lock(&queue_mutex_);
+  for (auto& chunk : chunks) {
+    queue_.push(std::move(chunk));
+  }
+}
+
+void ResourceDecodePool::waitForIdle() {
+  const auto condition = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(queue_mutex_) {
+    return active_workers_ == 0 && queue_.empty();
+  };
+  absl::MutexLock lock(&queue_mutex_);
+  queue_mutex_.Await(absl::Condition(&condition));
+}
+
+void ResourceDecodePool::worker() {
+  const auto condition = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(queue_mutex_) {
+    return !queue_.empty() || terminate_;
+  };
+  while (true) {
+    DecodeChunk chunk;
+    {
+      absl::MutexLock lock(&queue_mutex_);
+      queue_mutex_.Await(absl::Condition(&condition));
+      if (terminate_) {
+        return;
+      }
+      chunk = std::move(queue_.front());
+      queue_.pop();
+      ++active_workers_;
+    }
+    decodeChunk(chunk);
+    if (--chunk.batch_->pending_chunks_ == 0) {
+      completeBatch(std::move(chunk.batch_));
+    }
+    {
+      absl::MutexLock lock(&queue_mutex_);
+      --active_workers_;
+    }
+  }
+}
+
+void ResourceDecodePool::decodeChunk(const DecodeChunk& chunk) {
+  DecodeBatch& batch = *chunk.batch_;
+  ConcurrentResourceDecoder resource_decoder(*batch.resource_decoder_);
+  for (int i = chunk.begin_; i < chunk.end_; ++i) {
+    if (batch.failedBefore(i)) {
+      return;
+    }
+    TRY_NEEDS_AUDIT {
+      absl::StatusOr<DecodedResourceImplPtr> resource_or_error = DecodedResourceImpl::fromResource(
+          resource_decoder, batch.message_->resources(i), batch.message_->version_info());
+      if (!resource_or_error.ok()) {
+        batch.onError(i, resource_or_error.status());
+        return;
+      }
+      batch.resources_[i] = std::move(resource_or_error.value());
+    }
+    END_TRY
+    CATCH(const EnvoyException& e, {
+      batch.onError(i, absl::InvalidArgumentError(e.what()));
+      return;
+    });
+  }
+}
+
+void ResourceDecodePool::completeBatch(DecodeBatchSharedPtr batch) {
+  batch->dispatcher_.post([alive = std::weak_ptr<bool>(alive_), batch = std::move(batch)]() {
+    if (alive.expired()) {
+      return;
+    }
+    absl::StatusOr<std::vector<DecodedResourcePtr>> resources_or_error;
+    {
+      absl::MutexLock lock(&batch->error_mutex_);
+      if (batch->error_index_ >= 0) {
+        resources_or_error = batch->error_;
+      } else {
+        resources_or_error = std::move(batch->resources_);
+      }
+    }
+    batch->on_complete_(std::move(batch->message_), std::move(resources_or_error));
+  });
+}
+
+} // namespace Config
+} // namespace Envoy
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <queue>
+#include <vector>
+
+#include "envoy/config/subscription.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/service/discovery/v3/discovery.pb.h"
+#include "envoy/thread/thread.h"
+
+#include "source/common/common/logger.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Config {
+
+/**
+ * A bounded pool of threads which decodes and validates the resources of a state-of-the-world
+ * DiscoveryResponse off the main thread. The resources of a response are split into chunks that
+ * are decoded in parallel; once all of them are done the decoded resources, in the order in which
+ * they appear in the response, are handed back to the dispatcher that requested the decoding.
+ *
+ * Only the validation that is safe to perform off the main thread is done by the pool (see
+ * OpaqueResourceDecoder::decodeResourceConcurrently()); the caller is responsible for invoking
+ * OpaqueResourceDecoder::validateDecodedResource() once the resources are back on the main thread.
+ */
+class ResourceDecodePool : public Logger::Loggable<Logger::Id::config> {
+public:
+  using DecodeCompleteCb = absl::AnyInvocable<void(
+      std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& message,
+      absl::StatusOr<std::vector<DecodedResourcePtr>>&& resources_or_error)>;
+
+  /**
+   * @param thread_factory the factory creating the decoding threads.
+   * @param concurrency the number of decoding threads. Must be greater than zero.
+   */
+  ResourceDecodePool(Thread::ThreadFactory& thread_factory, uint32_t concurrency);
+  ~ResourceDecodePool() ABSL_LOCKS_EXCLUDED(queue_mutex_);
+
+  /**
+   * Decodes the resources of a DiscoveryResponse on the pool's threads.
+   * @param dispatcher the dispatcher on which on_complete is invoked.
+   * @param resource_decoder the decoder used for all of the response's resources. It must support
+   *        concurrent decoding.
+   * @param message the DiscoveryResponse whose resources are decoded. It is handed back to
+   *        on_complete once the decoding is done.
+   * @param on_complete invoked on the dispatcher's thread with the decoded resources, or with the
+   *        error of the first (in response order) resource that failed to decode. It is not
+   *        invoked if the pool is destroyed before the decoding completes.
+   */
+  void decode(Event::Dispatcher& dispatcher, OpaqueResourceDecoderSharedPtr resource_decoder,
+              std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& message,
+              DecodeCompleteCb on_complete) ABSL_LOCKS_EXCLUDED(queue_mutex_);
+
+  /**
+   * Blocks until all queued decoding work has been performed. Intended for tests.
+   */
+  void waitForIdle() ABSL_LOCKS_EXCLUDED(queue_mutex_);
+
+  uint32_t concurrency() const { return thread_pool_.size(); }
+
+private:
+  struct DecodeBatch;
+  using DecodeBatchSharedPtr = std::shared_ptr<DecodeBatch>;
+
+  // A contiguous range of a batch's resources, decoded by a single thread.
+  struct DecodeChunk {
+    DecodeBatchSharedPtr batch_;
+    int begin_;
+    int end_;
+  };
+
+  void worker() ABSL_LOCKS_EXCLUDED(queue_mutex_);
+  void decodeChunk(const DecodeChunk& chunk);
+  void completeBatch(DecodeBatchSharedPtr batch);
+
+  absl::Mutex queue_mutex_;
+  std::queue<DecodeChunk> queue_ ABSL_GUARDED_BY(queue_mutex_);
+  int active_workers_ ABSL_GUARDED_BY(queue_mutex_) = 0;
+  bool terminate_ ABSL_GUARDED_BY(queue_mutex_) = false;
+
+  std::vector<Thread::ThreadPtr> thread_pool_;
+  // Completions posted to a dispatcher after the pool has been destroyed are dropped, as their
+  // callbacks may refer to the pool's owner.
+  std::shared_ptr<bool> alive_{std::make_shared<bool>(true)};
+};
+
+using ResourceDecodePoolPtr = std::unique_ptr<ResourceDecodePool>;
+
+} // namespace Config
+} // namespace Envoy
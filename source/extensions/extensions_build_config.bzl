@@ -331,6 +331,7 @@ EXTENSIONS = {
     # CacheFilter plugins
     #
     "envoy.extensions.http.cache.file_system_http_cache": "//source/extensions/http/cache/file_system_http_cache:config",
+    "envoy.extensions.http.cache.memory":               "//source/extensions/http/cache/memory_http_cache:config",
     "envoy.extensions.http.cache.simple":               "//source/extensions/http/cache/simple_http_cache:config",
 
     #
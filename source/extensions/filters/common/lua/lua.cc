@@ -42,8 +42,45 @@ void LuaLoggable::scriptLog(spdlog::level::level_enum level, absl::string_view m
   }
 }
 
-Coroutine::Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state)
-    : coroutine_state_(new_thread_state, false) {}
+namespace {
+
+// Enough for the coroutines which finish on a worker while others start, without holding on to
+// the threads of a burst of concurrent requests.
+constexpr size_t MaxPooledCoroutines = 256;
+
+} // namespace
+
+LuaRef<lua_State> CoroutinePool::acquire() {
+  ASSERT(!threads_.empty());
+  LuaRef<lua_State> thread(std::move(threads_.back()));
+  threads_.pop_back();
+  return thread;
+}
+
+void CoroutinePool::release(LuaRef<lua_State>&& thread) {
+  if (threads_.size() < MaxPooledCoroutines) {
+    threads_.push_back(std::move(thread));
+  }
+}
+
+Coroutine::Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state,
+                     std::weak_ptr<CoroutinePool> pool)
+    : coroutine_state_(new_thread_state, false), pool_(std::move(pool)) {}
+
+Coroutine::Coroutine(LuaRef<lua_State>&& thread, std::weak_ptr<CoroutinePool> pool)
+    : coroutine_state_(std::move(thread)), pool_(std::move(pool)) {}
+
+Coroutine::~Coroutine() {
+  if (!finished_without_error_) {
+    return;
+  }
+  CoroutinePoolSharedPtr pool = pool_.lock();
+  if (pool != nullptr) {
+    // Drop the return values so that the thread is like a new one.
+    lua_settop(coroutine_state_.get(), 0);
+    pool->release(std::move(coroutine_state_));
+  }
+}
 
 void Coroutine::start(int function_ref, int num_args, const std::function<void()>& yield_callback) {
   ASSERT(state_ == State::NotStarted);
@@ -64,6 +101,7 @@ void Coroutine::resume(int num_args, const std::function<void()>& yield_callback
 
   if (0 == rc) {
     state_ = State::Finished;
+    finished_without_error_ = true;
     ENVOY_LOG(debug, "coroutine finished");
   } else if (LUA_YIELD == rc) {
     state_ = State::Yielded;
@@ -121,8 +159,13 @@ uint64_t ThreadLocalState::registerGlobal(const std::string& global,
 }
 
 CoroutinePtr ThreadLocalState::createCoroutine() {
-  lua_State* state = tlsState().get();
-  return std::make_unique<Coroutine>(std::make_pair(lua_newthread(state), state));
+  LuaThreadLocal& tls = **tls_slot_;
+  if (!tls.coroutine_pool_->empty()) {
+    return std::make_unique<Coroutine>(tls.coroutine_pool_->acquire(), tls.coroutine_pool_);
+  }
+  lua_State* state = tls.state_.get();
+  return std::make_unique<Coroutine>(std::make_pair(lua_newthread(state), state),
+                                     tls.coroutine_pool_);
 }
 
 ThreadLocalState::LuaThreadLocal::LuaThreadLocal(const std::string& code)
@@ -423,6 +423,32 @@ public:
   }
 };
 
+/**
+ * The Lua threads of coroutines which finished without an error. A finished thread is in the same
+ * state as a new one once its stack is cleared, so later coroutines of the same Lua state reuse
+ * them rather than each creating, and eventually garbage collecting, a new thread.
+ */
+class CoroutinePool {
+public:
+  bool empty() const { return threads_.empty(); }
+
+  /**
+   * @return a pooled thread. The pool must not be empty.
+   */
+  LuaRef<lua_State> acquire();
+
+  /**
+   * Returns the thread of a coroutine which finished without an error to the pool, unless it is
+   * full.
+   */
+  void release(LuaRef<lua_State>&& thread);
+
+private:
+  std::vector<LuaRef<lua_State>> threads_;
+};
+
+using CoroutinePoolSharedPtr = std::shared_ptr<CoroutinePool>;
+
 /**
  * This is a wrapper for a Lua coroutine. Lua intermixes coroutine and "thread." Lua does not have
  * real threads, only cooperatively scheduled coroutines.
@@ -431,7 +457,16 @@ class Coroutine : Logger::Loggable<Logger::Id::lua> {
 public:
   enum class State { NotStarted, Yielded, Finished };
 
-  Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state);
+  /**
+   * @param new_thread_state supplies the new thread and the state which owns it.
+   * @param pool supplies the pool to return the thread to if the coroutine finishes without an
+   *        error, if any.
+   */
+  Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state,
+            std::weak_ptr<CoroutinePool> pool = {});
+  Coroutine(LuaRef<lua_State>&& thread, std::weak_ptr<CoroutinePool> pool);
+  ~Coroutine();
+
   lua_State* luaState() { return coroutine_state_.get(); }
   State state() { return state_; }
 
@@ -456,6 +491,8 @@ public:
 private:
   LuaRef<lua_State> coroutine_state_;
   State state_{State::NotStarted};
+  bool finished_without_error_{};
+  std::weak_ptr<CoroutinePool> pool_;
 };
 
 using CoroutinePtr = std::unique_ptr<Coroutine>;
@@ -472,7 +509,8 @@ public:
   ThreadLocalState(const std::string& code, ThreadLocal::SlotAllocator& tls);
 
   /**
-   * @return CoroutinePtr a new coroutine.
+   * @return CoroutinePtr a new coroutine, whose thread may be reused from a coroutine which has
+   *         finished.
    */
   CoroutinePtr createCoroutine();
 
@@ -520,6 +558,8 @@ private:
 
     CSmartPtr<lua_State, lua_close> state_;
     std::vector<int> global_slots_;
+    // Declared after the state so that the pooled threads are unreferenced before it is closed.
+    CoroutinePoolSharedPtr coroutine_pool_{std::make_shared<CoroutinePool>()};
   };
 
   CSmartPtr<lua_State, lua_close>& tlsState() { return (*tls_slot_)->state_; }
@@ -57,7 +57,20 @@ int BufferWrapper::luaGetBytes(lua_State* state) {
     luaL_error(state, "index/length must be >= 0 and (index + length) must be <= buffer size");
   }
 
-  // TODO(mattklein123): Reduce copies here by using Lua direct buffer builds.
+  // Bytes within a single slice, as most are, are pushed straight from it. Otherwise they are
+  // first copied out of the slices to be contiguous.
+  uint64_t slice_start = 0;
+  for (const Buffer::RawSlice& slice : data_.getRawSlices()) {
+    if (static_cast<uint64_t>(index) < slice_start + slice.len_) {
+      if (static_cast<uint64_t>(index) + length <= slice_start + slice.len_) {
+        lua_pushlstring(state, static_cast<const char*>(slice.mem_) + (index - slice_start),
+                        length);
+        return 1;
+      }
+      break;
+    }
+    slice_start += slice.len_;
+  }
   std::unique_ptr<char[]> data(new char[length]);
   data_.copyOut(index, length, data.get());
   lua_pushlstring(state, data.get(), length);
@@ -2,13 +2,16 @@
 
 #include "envoy/http/header_map.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/enum_to_int.h"
 #include "source/common/http/headers.h"
 #include "source/common/http/utility.h"
+#include "source/common/protobuf/utility.h"
 #include "source/extensions/filters/http/cache/cache_custom_headers.h"
 #include "source/extensions/filters/http/cache/cache_entry_utils.h"
 #include "source/extensions/filters/http/cache/cache_filter_logging_info.h"
 #include "source/extensions/filters/http/cache/cacheability_utils.h"
+#include "source/extensions/filters/http/cache/range_utils.h"
 #include "source/extensions/filters/http/cache/upstream_request.h"
 
 #include "absl/memory/memory.h"
@@ -30,20 +33,47 @@ namespace {
 //
 // And everyone knows 64MB should be enough for anyone.
 static const size_t MAX_BYTES_TO_FETCH_FROM_CACHE_PER_REQUEST = 64 * 1024 * 1024;
+
+constexpr uint64_t DefaultRequestCollapsingTimeoutMs = 5000;
+
+CacheFilterStats generateStats(const std::string& prefix, Stats::Scope& scope) {
+  return {ALL_CACHE_FILTER_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                 POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
+// Adds a body chunk of a collapsed response to a buffer without copying it.
+void addSharedChunk(Buffer::Instance& buffer, std::shared_ptr<const std::string> chunk) {
+  if (chunk->empty()) {
+    return;
+  }
+  const absl::string_view data = *chunk;
+  buffer.addBufferFragment(*new Buffer::BufferFragmentImpl(
+      data.data(), data.size(),
+      [chunk = std::move(chunk)](const void*, size_t, const Buffer::BufferFragmentImpl* fragment) {
+        delete fragment;
+      }));
+}
 } // namespace
 
 struct CacheResponseCodeDetailValues {
   const absl::string_view ResponseFromCacheFilter = "cache.response_from_cache_filter";
+  const absl::string_view ResponseFromCollapsedRequest = "cache.response_from_collapsed_request";
 };
 
 using CacheResponseCodeDetails = ConstSingleton<CacheResponseCodeDetailValues>;
 
 CacheFilterConfig::CacheFilterConfig(
     const envoy::extensions::filters::http::cache::v3::CacheConfig& config,
+    const std::string& stats_prefix, Stats::Scope& scope,
     Server::Configuration::CommonFactoryContext& context)
     : vary_allow_list_(config.allowed_vary_headers(), context), time_source_(context.timeSource()),
       ignore_request_cache_control_header_(config.ignore_request_cache_control_header()),
-      cluster_manager_(context.clusterManager()) {}
+      cluster_manager_(context.clusterManager()),
+      request_collapser_(config.has_request_collapsing() ? std::make_shared<RequestCollapser>()
+                                                         : nullptr),
+      request_collapsing_timeout_(PROTOBUF_GET_MS_OR_DEFAULT(
+          config.request_collapsing(), timeout, DefaultRequestCollapsingTimeoutMs)),
+      stats_(generateStats(stats_prefix + "cache.", scope)) {}
 
 CacheFilter::CacheFilter(std::shared_ptr<const CacheFilterConfig> config,
                          std::shared_ptr<HttpCache> http_cache)
@@ -51,6 +81,7 @@ CacheFilter::CacheFilter(std::shared_ptr<const CacheFilterConfig> config,
 
 void CacheFilter::onDestroy() {
   filter_state_ = FilterState::Destroyed;
+  stopFollowingCollapsedResponse();
   if (lookup_ != nullptr) {
     lookup_->onDestroy();
   }
@@ -60,20 +91,28 @@ void CacheFilter::onDestroy() {
   }
 }
 
-void CacheFilter::sendUpstreamRequest(Http::RequestHeaderMap& request_headers) {
+void CacheFilter::sendUpstreamRequest(Http::RequestHeaderMap& request_headers,
+                                      CollapsedResponseSharedPtr collapsed_response) {
   Router::RouteConstSharedPtr route = decoder_callbacks_->route();
   const Router::RouteEntry* route_entry = (route == nullptr) ? nullptr : route->routeEntry();
-  if (route_entry == nullptr) {
-    return sendNoRouteResponse();
-  }
   Upstream::ThreadLocalCluster* thread_local_cluster =
-      config_->clusterManager().getThreadLocalCluster(route_entry->clusterName());
+      route_entry == nullptr
+          ? nullptr
+          : config_->clusterManager().getThreadLocalCluster(route_entry->clusterName());
   if (thread_local_cluster == nullptr) {
+    if (collapsed_response != nullptr) {
+      // Let the requests collapsed into this one try for themselves.
+      collapsed_response->close();
+    }
+    if (route_entry == nullptr) {
+      return sendNoRouteResponse();
+    }
     return sendNoClusterResponse(route_entry->clusterName());
   }
-  upstream_request_ =
-      UpstreamRequest::create(this, std::move(lookup_), std::move(lookup_result_), cache_,
-                              thread_local_cluster->httpAsyncClient(), config_->upstreamOptions());
+  upstream_request_ = UpstreamRequest::create(
+      this, std::move(lookup_), std::move(lookup_result_), cache_,
+      thread_local_cluster->httpAsyncClient(), config_->upstreamOptions(),
+      std::move(collapsed_response));
   upstream_request_->sendHeaders(request_headers);
 }
 
@@ -127,6 +166,9 @@ Http::FilterHeadersStatus CacheFilter::decodeHeaders(Http::RequestHeaderMap& hea
                                config_->ignoreRequestCacheControlHeader());
   request_allows_inserts_ = !lookup_request.requestCacheControl().no_store_;
   is_head_request_ = headers.getMethodValue() == Http::Headers::get().MethodValues.Head;
+  if (config_->requestCollapser() != nullptr) {
+    key_ = lookup_request.key();
+  }
   lookup_ = cache_->makeLookupContext(std::move(lookup_request), *decoder_callbacks_);
 
   ASSERT(lookup_);
@@ -157,6 +199,14 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
     return Http::FilterHeadersStatus::Continue;
   }
 
+  if (waiting_for_collapsed_response_) {
+    // A local reply was generated while waiting for the response of the request this one is
+    // collapsed into, e.g. because the request stream timed out.
+    filter_state_ = FilterState::NotServingFromCache;
+    stopFollowingCollapsedResponse();
+    return Http::FilterHeadersStatus::Continue;
+  }
+
   if (lookup_result_ == nullptr) {
     // Filter chain iteration is paused while a lookup is outstanding, but the filter chain manager
     // can still generate a local reply. One case where this can happen is when a downstream idle
@@ -327,7 +377,7 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
     handleCacheHit(/* end_stream_after_headers = */ end_stream);
     return;
   case CacheEntryStatus::Unusable:
-    sendUpstreamRequest(request_headers);
+    onCacheMiss(request_headers);
     return;
   case CacheEntryStatus::LookupError:
     filter_state_ = FilterState::NotServingFromCache;
@@ -341,6 +391,125 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
   sendUpstreamRequest(request_headers);
 }
 
+void CacheFilter::onCacheMiss(Http::RequestHeaderMap& request_headers) {
+  const std::shared_ptr<RequestCollapser>& collapser = config_->requestCollapser();
+  // HEAD and range requests would need only part of the response they would be collapsed into,
+  // and requests which don't allow their response to be cached can't lead an insert.
+  if (collapser == nullptr || is_head_request_ || !request_allows_inserts_ ||
+      RangeUtils::getRangeHeader(request_headers).has_value()) {
+    sendUpstreamRequest(request_headers);
+    return;
+  }
+  bool leader;
+  CollapsedResponseSharedPtr collapsed_response =
+      collapser->join(key_.value(), cache_->cacheInfo().max_entry_size_bytes_, leader);
+  if (leader) {
+    config_->stats().collapsed_leader_.inc();
+    sendUpstreamRequest(request_headers, std::move(collapsed_response));
+    return;
+  }
+  ENVOY_STREAM_LOG(debug, "CacheFilter::onCacheMiss collapsing request", *decoder_callbacks_);
+  config_->stats().collapsed_follower_.inc();
+  config_->stats().collapsed_waiting_.inc();
+  request_headers_ = &request_headers;
+  collapsed_response_ = std::move(collapsed_response);
+  waiting_for_collapsed_response_ = true;
+  collapsed_reader_ = collapsed_response_->subscribe(
+      decoder_callbacks_->dispatcher(), [weak_self = weak_from_this()]() {
+        if (CacheFilterSharedPtr self = weak_self.lock()) {
+          self->onCollapsedResponseUpdate();
+        }
+      });
+  collapsing_timer_ = decoder_callbacks_->dispatcher().createTimer(
+      [this]() { onCollapsedResponseUnavailable(config_->stats().collapsed_timeout_); });
+  collapsing_timer_->enableTimer(config_->requestCollapsingTimeout());
+  // The response may have arrived already.
+  onCollapsedResponseUpdate();
+}
+
+void CacheFilter::onCollapsedResponseUpdate() {
+  if (filter_state_ == FilterState::Destroyed || collapsed_response_ == nullptr) {
+    return;
+  }
+  CollapsedResponse::Update update = collapsed_response_->read(collapsed_reader_);
+  if (update.aborted_) {
+    if (waiting_for_collapsed_response_) {
+      onCollapsedResponseUnavailable(config_->stats().collapsed_aborted_);
+    } else {
+      // Part of the response has been served already, so there is no way to recover.
+      stopFollowingCollapsedResponse();
+      decoder_callbacks_->resetStream();
+    }
+    return;
+  }
+  if (update.headers_ != nullptr) {
+    ENVOY_STREAM_LOG(debug, "CacheFilter::onCollapsedResponseUpdate serving collapsed response",
+                     *decoder_callbacks_);
+    waiting_for_collapsed_response_ = false;
+    collapsing_timer_->disableTimer();
+    config_->stats().collapsed_waiting_.dec();
+    config_->stats().collapsed_served_.inc();
+    filter_state_ = FilterState::ServingFromCache;
+    insert_status_ = InsertStatus::NoInsertRequestCollapsed;
+    decoder_callbacks_->streamInfo().setResponseFlag(
+        StreamInfo::CoreResponseFlag::ResponseFromCacheFilter);
+    const bool end_stream =
+        update.end_stream_ && update.body_.empty() && update.trailers_ == nullptr;
+    decoder_callbacks_->encodeHeaders(std::move(update.headers_), end_stream,
+                                      CacheResponseCodeDetails::get().ResponseFromCollapsedRequest);
+    if (filter_state_ == FilterState::Destroyed) {
+      return;
+    }
+    if (end_stream) {
+      stopFollowingCollapsedResponse();
+      finalizeEncodingCachedResponse();
+      return;
+    }
+  }
+  if (!update.body_.empty() || (update.end_stream_ && update.trailers_ == nullptr)) {
+    Buffer::OwnedImpl body;
+    for (std::shared_ptr<const std::string>& chunk : update.body_) {
+      addSharedChunk(body, std::move(chunk));
+    }
+    decoder_callbacks_->encodeData(body, update.end_stream_ && update.trailers_ == nullptr);
+    if (filter_state_ == FilterState::Destroyed) {
+      return;
+    }
+  }
+  if (update.trailers_ != nullptr) {
+    decoder_callbacks_->encodeTrailers(std::move(update.trailers_));
+    if (filter_state_ == FilterState::Destroyed) {
+      return;
+    }
+  }
+  if (update.end_stream_) {
+    stopFollowingCollapsedResponse();
+    finalizeEncodingCachedResponse();
+  }
+}
+
+void CacheFilter::onCollapsedResponseUnavailable(Stats::Counter& reason) {
+  ENVOY_STREAM_LOG(debug, "CacheFilter::onCollapsedResponseUnavailable sending request upstream",
+                   *decoder_callbacks_);
+  reason.inc();
+  stopFollowingCollapsedResponse();
+  sendUpstreamRequest(*request_headers_);
+}
+
+void CacheFilter::stopFollowingCollapsedResponse() {
+  if (collapsed_response_ == nullptr) {
+    return;
+  }
+  collapsed_response_->unsubscribe(collapsed_reader_);
+  collapsed_response_ = nullptr;
+  // The timer is only disabled, as this may be called by its callback.
+  collapsing_timer_->disableTimer();
+  if (waiting_for_collapsed_response_) {
+    waiting_for_collapsed_response_ = false;
+    config_->stats().collapsed_waiting_.dec();
+  }
+}
+
 // TODO(toddmgreer): Handle downstream backpressure.
 void CacheFilter::onBody(Buffer::InstancePtr&& body, bool end_stream) {
   // Can be called during decoding if a valid cache hit is found,
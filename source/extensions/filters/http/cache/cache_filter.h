@@ -4,12 +4,15 @@
 #include <vector>
 
 #include "envoy/extensions/filters/http/cache/v3/cache.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 
 #include "source/common/common/logger.h"
 #include "source/extensions/filters/http/cache/cache_filter_logging_info.h"
 #include "source/extensions/filters/http/cache/cache_headers_utils.h"
 #include "source/extensions/filters/http/cache/filter_state.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/filters/http/cache/request_collapser.h"
 #include "source/extensions/filters/http/common/pass_through_filter.h"
 
 namespace Envoy {
@@ -19,9 +22,28 @@ namespace Cache {
 
 class UpstreamRequest;
 
+/**
+ * All cache filter stats. @see stats_macros.h
+ */
+#define ALL_CACHE_FILTER_STATS(COUNTER, GAUGE)                                                     \
+  COUNTER(collapsed_leader)                                                                        \
+  COUNTER(collapsed_follower)                                                                      \
+  COUNTER(collapsed_served)                                                                        \
+  COUNTER(collapsed_timeout)                                                                       \
+  COUNTER(collapsed_aborted)                                                                       \
+  GAUGE(collapsed_waiting, Accumulate)
+
+/**
+ * Struct definition for all cache filter stats. @see stats_macros.h
+ */
+struct CacheFilterStats {
+  ALL_CACHE_FILTER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
 class CacheFilterConfig {
 public:
   CacheFilterConfig(const envoy::extensions::filters::http::cache::v3::CacheConfig& config,
+                    const std::string& stats_prefix, Stats::Scope& scope,
                     Server::Configuration::CommonFactoryContext& context);
 
   // The allow list rules that decide if a header can be varied upon.
@@ -30,6 +52,10 @@ public:
   const Http::AsyncClient::StreamOptions& upstreamOptions() const { return upstream_options_; }
   Upstream::ClusterManager& clusterManager() const { return cluster_manager_; }
   bool ignoreRequestCacheControlHeader() const { return ignore_request_cache_control_header_; }
+  // Null unless request collapsing is configured.
+  const std::shared_ptr<RequestCollapser>& requestCollapser() const { return request_collapser_; }
+  std::chrono::milliseconds requestCollapsingTimeout() const { return request_collapsing_timeout_; }
+  CacheFilterStats& stats() const { return stats_; }
 
 private:
   const VaryAllowList vary_allow_list_;
@@ -37,6 +63,9 @@ private:
   const bool ignore_request_cache_control_header_;
   Upstream::ClusterManager& cluster_manager_;
   Http::AsyncClient::StreamOptions upstream_options_;
+  const std::shared_ptr<RequestCollapser> request_collapser_;
+  const std::chrono::milliseconds request_collapsing_timeout_;
+  mutable CacheFilterStats stats_;
 };
 
 /**
@@ -64,7 +93,24 @@ public:
 private:
   // For a cache miss that may be cacheable, the upstream request is sent outside of the usual
   // filter chain so that the request can continue even if the downstream client disconnects.
-  void sendUpstreamRequest(Http::RequestHeaderMap& request_headers);
+  // If collapsed_response is set, the requests collapsed into this one are served the response.
+  void sendUpstreamRequest(Http::RequestHeaderMap& request_headers,
+                           CollapsedResponseSharedPtr collapsed_response = nullptr);
+
+  // Handles a cache miss, by collapsing the request into a request for the same response which is
+  // already being sent upstream if request collapsing is configured, or by sending it upstream.
+  void onCacheMiss(Http::RequestHeaderMap& request_headers);
+
+  // Precondition: collapsed_response_ is the response of the request this one is collapsed into.
+  // Serves the parts of the response which have arrived since the last call.
+  void onCollapsedResponseUpdate();
+
+  // Called if the headers of the response this request is collapsed into don't arrive in time,
+  // or if it is aborted before they do. Sends the request upstream itself.
+  void onCollapsedResponseUnavailable(Stats::Counter& reason);
+
+  // Stops waiting for or serving the response this request is collapsed into.
+  void stopFollowingCollapsedResponse();
 
   // In the event that there is no matching route when attempting to sendUpstreamRequest,
   // send a 404 locally.
@@ -148,6 +194,17 @@ private:
   // onHeaders for Range Responses, otherwise initialized by encodeCachedResponse.
   std::vector<AdjustedByteRange> remaining_ranges_;
 
+  // The headers of the request, for collapsed requests which may have to be sent upstream later.
+  Http::RequestHeaderMap* request_headers_ = nullptr;
+  // The cache key of the request, if request collapsing is configured.
+  absl::optional<Key> key_;
+  // The response of the request this one is collapsed into, while waiting for or serving it.
+  CollapsedResponseSharedPtr collapsed_response_;
+  CollapsedResponse::Reader collapsed_reader_;
+  Event::TimerPtr collapsing_timer_;
+  // True until the headers of the response this request is collapsed into arrive.
+  bool waiting_for_collapsed_response_ = false;
+
   const std::shared_ptr<const CacheFilterConfig> config_;
 
   // True if a request allows cache inserts according to:
@@ -64,6 +64,8 @@ absl::string_view insertStatusToString(InsertStatus status) {
     return "NoInsertResponseVaryDisallowed";
   case InsertStatus::NoInsertLookupError:
     return "NoInsertLookupError";
+  case InsertStatus::NoInsertRequestCollapsed:
+    return "NoInsertRequestCollapsed";
   }
   IS_ENVOY_BUG(absl::StrCat("Unexpected InsertStatus: ", status));
   return "UnexpectedInsertStatus";
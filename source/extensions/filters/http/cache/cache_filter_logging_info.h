@@ -83,6 +83,9 @@ enum class InsertStatus {
   // The CacheFilter couldn't determine whether the request was in cache and
   // didn't try to insert it.
   NoInsertLookupError,
+  // The CacheFilter served the response of a concurrent request for the same
+  // response, which was inserting it, and didn't insert it itself.
+  NoInsertRequestCollapsed,
 };
 
 absl::string_view insertStatusToString(InsertStatus status);
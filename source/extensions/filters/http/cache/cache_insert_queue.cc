@@ -69,11 +69,12 @@ private:
 
 CacheInsertQueue::CacheInsertQueue(std::shared_ptr<HttpCache> cache,
                                    Http::StreamEncoderFilterCallbacks& encoder_callbacks,
-                                   InsertContextPtr insert_context, InsertQueueCallbacks& callbacks)
+                                   InsertContextPtr insert_context, InsertQueueCallbacks& callbacks,
+                                   CollapsedResponseSharedPtr collapsed_response)
     : dispatcher_(encoder_callbacks.dispatcher()), insert_context_(std::move(insert_context)),
       low_watermark_bytes_(encoder_callbacks.encoderBufferLimit() / 2),
       high_watermark_bytes_(encoder_callbacks.encoderBufferLimit()), callbacks_(callbacks),
-      cache_(cache) {}
+      cache_(cache), collapsed_response_(std::move(collapsed_response)) {}
 
 void CacheInsertQueue::insertHeaders(const Http::ResponseHeaderMap& response_headers,
                                      const ResponseMetadata& metadata, bool end_stream) {
@@ -227,6 +228,9 @@ CacheInsertQueue::~CacheInsertQueue() {
   ASSERT(!watermarked_, "should not have a watermarked status when the queue is destroyed");
   ASSERT(fragments_.empty(), "queue should be empty by the time the destructor is run");
   insert_context_->onDestroy();
+  if (collapsed_response_ != nullptr) {
+    collapsed_response_->stopCollapsing();
+  }
 }
 
 } // namespace Cache
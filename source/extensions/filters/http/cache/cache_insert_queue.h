@@ -4,6 +4,7 @@
 #include <functional>
 
 #include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/filters/http/cache/request_collapser.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -36,11 +37,16 @@ class CacheInsertFragment;
 // receives data one piece at a time - no more data will be delivered until the
 // cache implementation calls the provided callback indicating that it is ready
 // to receive more data.
+//
+// If the response is shared with collapsed requests, their CollapsedResponse
+// stops collapsing requests when the queue is destroyed, by which time the
+// response has been inserted or never will be.
 class CacheInsertQueue {
 public:
   CacheInsertQueue(std::shared_ptr<HttpCache> cache,
                    Http::StreamEncoderFilterCallbacks& encoder_callbacks,
-                   InsertContextPtr insert_context, InsertQueueCallbacks& callbacks);
+                   InsertContextPtr insert_context, InsertQueueCallbacks& callbacks,
+                   CollapsedResponseSharedPtr collapsed_response = nullptr);
   void insertHeaders(const Http::ResponseHeaderMap& response_headers,
                      const ResponseMetadata& metadata, bool end_stream);
   void insertBody(const Buffer::Instance& fragment, bool end_stream);
@@ -81,6 +87,9 @@ private:
   // while a cache action is still in flight, which can cause the cache to be
   // deleted prematurely.
   std::shared_ptr<HttpCache> cache_;
+  // The response served to the requests collapsed into this one, if any. It is
+  // fed by the UpstreamRequest, which outlives a failed insert.
+  const CollapsedResponseSharedPtr collapsed_response_;
 };
 
 } // namespace Cache
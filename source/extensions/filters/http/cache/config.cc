@@ -9,7 +9,7 @@ namespace Cache {
 
 Http::FilterFactoryCb CacheFilterFactory::createFilterFactoryFromProtoTyped(
     const envoy::extensions::filters::http::cache::v3::CacheConfig& config,
-    const std::string& /*stats_prefix*/, Server::Configuration::FactoryContext& context) {
+    const std::string& stats_prefix, Server::Configuration::FactoryContext& context) {
   std::shared_ptr<HttpCache> cache;
   if (!config.disabled().value()) {
     if (!config.has_typed_config()) {
@@ -26,7 +26,8 @@ Http::FilterFactoryCb CacheFilterFactory::createFilterFactoryFromProtoTyped(
     cache = http_cache_factory->getCache(config, context);
   }
 
-  return [config = std::make_shared<CacheFilterConfig>(config, context.serverFactoryContext()),
+  return [config = std::make_shared<CacheFilterConfig>(config, stats_prefix, context.scope(),
+                                                       context.serverFactoryContext()),
           cache](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamFilter(std::make_shared<CacheFilter>(config, cache));
   };
@@ -120,6 +120,8 @@ private:
 struct CacheInfo {
   absl::string_view name_;
   bool supports_range_requests_ = false;
+  // The size of the largest response body which the cache stores.
+  uint64_t max_entry_size_bytes_ = UINT64_MAX;
 };
 
 using LookupBodyCallback = absl::AnyInvocable<void(Buffer::InstancePtr&&, bool end_stream)>;
@@ -0,0 +1,197 @@
+#include "source/extensions/filters/http/cache/request_collapser.h"
+
+#include "source/common/http/header_map_impl.h"
+
+#include "absl/strings/numbers.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+CollapsedResponse::CollapsedResponse(std::shared_ptr<RequestCollapser> collapser, const Key& key,
+                                     uint64_t max_body_bytes)
+    : collapser_(std::move(collapser)), key_(key), max_body_bytes_(max_body_bytes) {}
+
+void CollapsedResponse::setHeaders(const Http::ResponseHeaderMap& headers, bool end_stream) {
+  absl::MutexLock lock(&mutex_);
+  if (state_ != State::Pending) {
+    return;
+  }
+  uint64_t content_length;
+  if (headers.ContentLength() != nullptr &&
+      absl::SimpleAtoi(headers.getContentLengthValue(), &content_length) &&
+      content_length > max_body_bytes_) {
+    // No follower has been served anything yet, so they can all send their own requests.
+    abort();
+    return;
+  }
+  headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(headers);
+  state_ = end_stream ? State::Complete : State::Streaming;
+  notify();
+}
+
+void CollapsedResponse::appendBody(const Buffer::Instance& data, bool end_stream) {
+  absl::MutexLock lock(&mutex_);
+  if (state_ != State::Streaming) {
+    return;
+  }
+  body_bytes_ += data.length();
+  if (body_bytes_ > max_body_bytes_) {
+    abort();
+    return;
+  }
+  if (data.length() > 0) {
+    body_.push_back(std::make_shared<const std::string>(data.toString()));
+  }
+  if (end_stream) {
+    state_ = State::Complete;
+  }
+  notify();
+}
+
+void CollapsedResponse::setTrailers(const Http::ResponseTrailerMap& trailers) {
+  absl::MutexLock lock(&mutex_);
+  if (state_ != State::Streaming) {
+    return;
+  }
+  trailers_ = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(trailers);
+  state_ = State::Complete;
+  notify();
+}
+
+void CollapsedResponse::stopCollapsing() {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (state_ == State::Pending) {
+      abort();
+    } else if (state_ == State::Streaming) {
+      collapsing_stopped_ = true;
+      // Followers which haven't read the headers yet are told to send their own requests.
+      notify();
+    }
+  }
+  // The collapser is locked after the response is unlocked, as RequestCollapser::join locks them
+  // in the opposite order.
+  collapser_->remove(key_, this);
+}
+
+void CollapsedResponse::close() {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (state_ == State::Complete) {
+      // The response is forgotten by stopCollapsing() once it is in the cache.
+      return;
+    }
+    if (state_ != State::Aborted) {
+      abort();
+    }
+  }
+  collapser_->remove(key_, this);
+}
+
+CollapsedResponse::Reader CollapsedResponse::subscribe(Event::Dispatcher& dispatcher,
+                                                       std::function<void()> on_update) {
+  absl::MutexLock lock(&mutex_);
+  Reader reader;
+  reader.id_ = next_subscriber_id_++;
+  subscribers_.emplace(reader.id_, Subscriber{&dispatcher, std::move(on_update)});
+  return reader;
+}
+
+void CollapsedResponse::unsubscribe(const Reader& reader) {
+  absl::MutexLock lock(&mutex_);
+  subscribers_.erase(reader.id_);
+}
+
+CollapsedResponse::Update CollapsedResponse::read(Reader& reader) {
+  absl::MutexLock lock(&mutex_);
+  auto it = subscribers_.find(reader.id_);
+  if (it != subscribers_.end()) {
+    it->second.notified_ = false;
+  }
+  Update update;
+  if (state_ == State::Aborted || (collapsing_stopped_ && !reader.headers_read_)) {
+    update.aborted_ = true;
+    return update;
+  }
+  if (headers_ == nullptr) {
+    return update;
+  }
+  if (!reader.headers_read_) {
+    update.headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*headers_);
+    reader.headers_read_ = true;
+  }
+  update.body_.assign(body_.begin() + reader.body_chunks_read_, body_.end());
+  reader.body_chunks_read_ = body_.size();
+  if (state_ == State::Complete) {
+    if (trailers_ != nullptr) {
+      update.trailers_ = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*trailers_);
+    }
+    update.end_stream_ = true;
+  }
+  return update;
+}
+
+bool CollapsedResponse::aborted() const {
+  absl::MutexLock lock(&mutex_);
+  return state_ == State::Aborted || collapsing_stopped_;
+}
+
+void CollapsedResponse::abort() {
+  state_ = State::Aborted;
+  // Followers don't read the response once it is aborted.
+  headers_.reset();
+  body_.clear();
+  trailers_.reset();
+  notify();
+}
+
+// Each follower is posted at most one notification until it has read the response, however many
+// updates arrive in the meantime. Followers unsubscribe before their dispatchers can be destroyed,
+// and they are notified with the response locked, so the dispatchers are alive when posted to.
+void CollapsedResponse::notify() {
+  for (auto& [id, subscriber] : subscribers_) {
+    if (!subscriber.notified_) {
+      subscriber.notified_ = true;
+      subscriber.dispatcher_->post(subscriber.on_update_);
+    }
+  }
+}
+
+CollapsedResponseSharedPtr RequestCollapser::join(const Key& key, uint64_t max_body_bytes,
+                                                  bool& leader) {
+  absl::MutexLock lock(&mutex_);
+  std::weak_ptr<CollapsedResponse>& weak_response = responses_[key];
+  CollapsedResponseSharedPtr response = weak_response.lock();
+  if (response != nullptr && !response->aborted()) {
+    leader = false;
+    return response;
+  }
+  response = std::make_shared<CollapsedResponse>(shared_from_this(), key, max_body_bytes);
+  weak_response = response;
+  leader = true;
+  return response;
+}
+
+size_t RequestCollapser::size() const {
+  absl::MutexLock lock(&mutex_);
+  return responses_.size();
+}
+
+void RequestCollapser::remove(const Key& key, const CollapsedResponse* response) {
+  absl::MutexLock lock(&mutex_);
+  auto it = responses_.find(key);
+  if (it == responses_.end()) {
+    return;
+  }
+  CollapsedResponseSharedPtr current = it->second.lock();
+  if (current == nullptr || current.get() == response) {
+    responses_.erase(it);
+  }
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
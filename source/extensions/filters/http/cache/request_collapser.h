@@ -0,0 +1,160 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/header_map.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/http/cache/key.pb.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+class RequestCollapser;
+
+/**
+ * A response which is being fetched from upstream and inserted into the cache for the first of
+ * concurrent requests for a key, the leader, and which the other requests for the key, the
+ * followers, are served as it arrives, rather than each fetching it from upstream. The leader and
+ * the followers may be on different workers, so it is thread safe.
+ */
+class CollapsedResponse {
+public:
+  CollapsedResponse(std::shared_ptr<RequestCollapser> collapser, const Key& key,
+                    uint64_t max_body_bytes);
+
+  // Called by the leader as the response arrives from upstream. A response whose body is larger
+  // than the max body size is aborted as soon as that is known, so that it isn't held in memory
+  // for the followers.
+  void setHeaders(const Http::ResponseHeaderMap& headers, bool end_stream);
+  void appendBody(const Buffer::Instance& data, bool end_stream);
+  void setTrailers(const Http::ResponseTrailerMap& trailers);
+
+  /**
+   * Called by the leader once the response is in the cache, or won't be. Later requests for the
+   * key look it up in the cache again. If the response is still streaming, the followers which
+   * haven't been sent its headers yet send their own requests upstream, and the others keep being
+   * served the rest of the response until it is closed.
+   */
+  void stopCollapsing();
+
+  /**
+   * Called by the leader once its upstream stream is over. If the response is not complete by
+   * then, it is aborted: followers which haven't been sent its headers yet send their own requests
+   * upstream, and the others are reset.
+   */
+  void close();
+
+  // How far a follower has read the response.
+  struct Reader {
+    uint64_t id_{};
+    bool headers_read_{};
+    size_t body_chunks_read_{};
+  };
+
+  // The part of the response which arrived since the previous read of a follower.
+  struct Update {
+    Http::ResponseHeaderMapPtr headers_;
+    std::vector<std::shared_ptr<const std::string>> body_;
+    Http::ResponseTrailerMapPtr trailers_;
+    // True if the update holds the end of the response.
+    bool end_stream_{};
+    bool aborted_{};
+  };
+
+  /**
+   * Adds a follower, which is notified of each update to the response on its own dispatcher.
+   * @param on_update called through dispatcher when more of the response has arrived. It is not
+   *        called again until the follower has read the update.
+   * @return the reader of the follower.
+   */
+  Reader subscribe(Event::Dispatcher& dispatcher, std::function<void()> on_update);
+  void unsubscribe(const Reader& reader);
+
+  /**
+   * @return the part of the response which the follower hasn't read yet. The body chunks are
+   *         shared with the other followers, and must not be modified.
+   */
+  Update read(Reader& reader);
+
+  // @return true if the response was aborted or stopped collapsing requests, so that no more
+  //         followers should be added.
+  bool aborted() const;
+
+private:
+  enum class State { Pending, Streaming, Complete, Aborted };
+
+  struct Subscriber {
+    Event::Dispatcher* dispatcher_;
+    std::function<void()> on_update_;
+    bool notified_{};
+  };
+
+  void abort() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void notify() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const std::shared_ptr<RequestCollapser> collapser_;
+  const Key key_;
+  const uint64_t max_body_bytes_;
+
+  mutable absl::Mutex mutex_;
+  State state_ ABSL_GUARDED_BY(mutex_) = State::Pending;
+  // Set by stopCollapsing() while the response is streaming.
+  bool collapsing_stopped_ ABSL_GUARDED_BY(mutex_) = false;
+  Http::ResponseHeaderMapPtr headers_ ABSL_GUARDED_BY(mutex_);
+  std::vector<std::shared_ptr<const std::string>> body_ ABSL_GUARDED_BY(mutex_);
+  uint64_t body_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  Http::ResponseTrailerMapPtr trailers_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<uint64_t, Subscriber> subscribers_ ABSL_GUARDED_BY(mutex_);
+  uint64_t next_subscriber_id_ ABSL_GUARDED_BY(mutex_) = 1;
+};
+
+using CollapsedResponseSharedPtr = std::shared_ptr<CollapsedResponse>;
+
+/**
+ * The responses being fetched from upstream by the leaders of collapsed requests, by key. It is
+ * shared by the filters of all workers for a filter configuration.
+ */
+class RequestCollapser : public std::enable_shared_from_this<RequestCollapser> {
+public:
+  /**
+   * Collapses a cache miss into the response of the key being fetched, if there is one.
+   * Otherwise, the request becomes the leader of the key, and is expected to fetch the response
+   * and close it.
+   * @param key the key of the request.
+   * @param max_body_bytes the largest body of a response which the cache stores, above which the
+   *        response is not served to followers.
+   * @param leader set to whether the request is the leader.
+   * @return the response the request leads or follows.
+   */
+  CollapsedResponseSharedPtr join(const Key& key, uint64_t max_body_bytes, bool& leader);
+
+  // @return the number of keys being fetched.
+  size_t size() const;
+
+private:
+  friend class CollapsedResponse;
+
+  // Forgets the response of a key, if it still is the one being fetched.
+  void remove(const Key& key, const CollapsedResponse* response);
+
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<Key, std::weak_ptr<CollapsedResponse>, MessageUtil, MessageUtil>
+      responses_ ABSL_GUARDED_BY(mutex_);
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
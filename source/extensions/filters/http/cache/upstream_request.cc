@@ -116,20 +116,23 @@ UpstreamRequest* UpstreamRequest::create(CacheFilter* filter, LookupContextPtr l
                                          LookupResultPtr lookup_result,
                                          std::shared_ptr<HttpCache> cache,
                                          Http::AsyncClient& async_client,
-                                         const Http::AsyncClient::StreamOptions& options) {
+                                         const Http::AsyncClient::StreamOptions& options,
+                                         CollapsedResponseSharedPtr collapsed_response) {
   return new UpstreamRequest(filter, std::move(lookup), std::move(lookup_result), std::move(cache),
-                             async_client, options);
+                             async_client, options, std::move(collapsed_response));
 }
 
 UpstreamRequest::UpstreamRequest(CacheFilter* filter, LookupContextPtr lookup,
                                  LookupResultPtr lookup_result, std::shared_ptr<HttpCache> cache,
                                  Http::AsyncClient& async_client,
-                                 const Http::AsyncClient::StreamOptions& options)
+                                 const Http::AsyncClient::StreamOptions& options,
+                                 CollapsedResponseSharedPtr collapsed_response)
     : filter_(filter), lookup_(std::move(lookup)), lookup_result_(std::move(lookup_result)),
       is_head_request_(filter->is_head_request_),
       request_allows_inserts_(filter->request_allows_inserts_), config_(filter->config_),
       filter_state_(filter->filter_state_), cache_(std::move(cache)),
-      stream_(async_client.start(*this, options)) {
+      stream_(async_client.start(*this, options)),
+      collapsed_response_(std::move(collapsed_response)) {
   ASSERT(stream_ != nullptr);
 }
 
@@ -145,7 +148,8 @@ void UpstreamRequest::insertQueueAborted() {
   insert_queue_ = nullptr;
   ENVOY_LOG(debug, "cache aborted insert operation");
   setInsertStatus(InsertStatus::InsertAbortedByCache);
-  if (filter_ == nullptr) {
+  // The requests collapsed into this one are still served the rest of the response.
+  if (filter_ == nullptr && !serving_collapsed_response_) {
     abort();
   }
 }
@@ -174,6 +178,9 @@ UpstreamRequest::~UpstreamRequest() {
     // to drain itself before destruction.
     insert_queue_->setSelfOwned(std::move(insert_queue_));
   }
+  if (collapsed_response_ != nullptr) {
+    collapsed_response_->close();
+  }
 }
 
 void UpstreamRequest::onReset() { delete this; }
@@ -189,7 +196,7 @@ void UpstreamRequest::onComplete() {
 }
 void UpstreamRequest::disconnectFilter() {
   filter_ = nullptr;
-  if (insert_queue_ == nullptr) {
+  if (insert_queue_ == nullptr && !serving_collapsed_response_) {
     abort();
   }
 }
@@ -210,11 +217,22 @@ void UpstreamRequest::onHeaders(Http::ResponseHeaderMapPtr&& headers, bool end_s
         cache_->makeInsertContext(std::move(lookup_), *filter_->encoder_callbacks_);
     lookup_ = nullptr;
     if (insert_context != nullptr) {
+      // The requests collapsed into this one can only be served a response which doesn't
+      // depend on their headers. They are served it as it arrives, even if the insert fails.
+      if (collapsed_response_ != nullptr && VaryHeaderUtils::hasVary(*headers)) {
+        collapsed_response_->close();
+        collapsed_response_ = nullptr;
+      }
+      if (collapsed_response_ != nullptr) {
+        collapsed_response_->setHeaders(*headers, end_stream);
+        serving_collapsed_response_ = true;
+      }
       // The callbacks passed to CacheInsertQueue are all called through the dispatcher,
       // so they're thread-safe. During CacheFilter::onDestroy the queue is given ownership
       // of itself and all the callbacks are cancelled, so they are also filter-destruction-safe.
       insert_queue_ = std::make_unique<CacheInsertQueue>(cache_, *filter_->encoder_callbacks_,
-                                                         std::move(insert_context), *this);
+                                                         std::move(insert_context), *this,
+                                                         collapsed_response_);
       // Add metadata associated with the cached response. Right now this is only response_time;
       const ResponseMetadata metadata = {config_->timeSource().systemTime()};
       insert_queue_->insertHeaders(*headers, metadata, end_stream);
@@ -227,6 +245,12 @@ void UpstreamRequest::onHeaders(Http::ResponseHeaderMapPtr&& headers, bool end_s
   } else {
     setInsertStatus(InsertStatus::NoInsertResponseNotCacheable);
   }
+  if (collapsed_response_ != nullptr && insert_queue_ == nullptr) {
+    // The response won't be inserted, so the requests collapsed into this one have to be sent
+    // upstream themselves.
+    collapsed_response_->close();
+    collapsed_response_ = nullptr;
+  }
   setFilterState(FilterState::NotServingFromCache);
   if (filter_) {
     filter_->decoder_callbacks_->encodeHeaders(std::move(headers), is_head_request_ || end_stream,
@@ -235,6 +259,9 @@ void UpstreamRequest::onHeaders(Http::ResponseHeaderMapPtr&& headers, bool end_s
 }
 
 void UpstreamRequest::onData(Buffer::Instance& body, bool end_stream) {
+  if (collapsed_response_ != nullptr) {
+    collapsed_response_->appendBody(body, end_stream);
+  }
   if (insert_queue_ != nullptr) {
     insert_queue_->insertBody(body, end_stream);
   }
@@ -253,6 +280,9 @@ void UpstreamRequest::onData(Buffer::Instance& body, bool end_stream) {
 }
 
 void UpstreamRequest::onTrailers(Http::ResponseTrailerMapPtr&& trailers) {
+  if (collapsed_response_ != nullptr) {
+    collapsed_response_->setTrailers(*trailers);
+  }
   if (insert_queue_ != nullptr) {
     insert_queue_->insertTrailers(*trailers);
   }
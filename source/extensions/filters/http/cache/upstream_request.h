@@ -35,13 +35,18 @@ public:
   void insertQueueUnderLowWatermark() override;
   void insertQueueAborted() override;
 
+  // If collapsed_response is set, it is served the response if the response is inserted into the
+  // cache, and closed otherwise. Once it is served the response, it keeps being served the rest of
+  // it even if the insert fails.
   static UpstreamRequest* create(CacheFilter* filter, LookupContextPtr lookup,
                                  LookupResultPtr lookup_result, std::shared_ptr<HttpCache> cache,
                                  Http::AsyncClient& async_client,
-                                 const Http::AsyncClient::StreamOptions& options);
+                                 const Http::AsyncClient::StreamOptions& options,
+                                 CollapsedResponseSharedPtr collapsed_response = nullptr);
   UpstreamRequest(CacheFilter* filter, LookupContextPtr lookup, LookupResultPtr lookup_result,
                   std::shared_ptr<HttpCache> cache, Http::AsyncClient& async_client,
-                  const Http::AsyncClient::StreamOptions& options);
+                  const Http::AsyncClient::StreamOptions& options,
+                  CollapsedResponseSharedPtr collapsed_response);
   ~UpstreamRequest() override;
 
 private:
@@ -76,6 +81,11 @@ private:
   std::shared_ptr<HttpCache> cache_;
   Http::AsyncClient::Stream* stream_ = nullptr;
   std::unique_ptr<CacheInsertQueue> insert_queue_;
+  // The response of the requests collapsed into this one, which is closed once the stream is over.
+  CollapsedResponseSharedPtr collapsed_response_;
+  // True once collapsed_response_ is served the response, so that the stream goes on for it even
+  // without the filter or the insert.
+  bool serving_collapsed_response_ = false;
 };
 
 } // namespace Cache
@@ -22,8 +22,9 @@ Http::FilterFactoryCb FileSystemBufferFilterFactory::createFilterFactoryFromProt
     const ProtoFileSystemBufferFilterConfig& config,
     const std::string& stats_prefix ABSL_ATTRIBUTE_UNUSED,
     Server::Configuration::FactoryContext& context) {
-  auto factory =
-      AsyncFileManagerFactory::singleton(&context.serverFactoryContext().singletonManager());
+  auto factory = AsyncFileManagerFactory::singleton(
+      &context.serverFactoryContext().singletonManager(),
+      &context.serverFactoryContext().threadLocal());
   auto manager = config.has_manager_config() ? factory->getAsyncFileManager(config.manager_config())
                                              : std::shared_ptr<AsyncFileManager>();
   auto filter_config = std::make_shared<FileSystemBufferFilterConfig>(std::move(factory),
@@ -38,7 +39,8 @@ absl::StatusOr<Router::RouteSpecificFilterConfigConstSharedPtr>
 FileSystemBufferFilterFactory::createRouteSpecificFilterConfigTyped(
     const ProtoFileSystemBufferFilterConfig& config,
     Server::Configuration::ServerFactoryContext& context, ProtobufMessage::ValidationVisitor&) {
-  auto factory = AsyncFileManagerFactory::singleton(&context.singletonManager());
+  auto factory =
+      AsyncFileManagerFactory::singleton(&context.singletonManager(), &context.threadLocal());
   auto manager = config.has_manager_config() ? factory->getAsyncFileManager(config.manager_config())
                                              : std::shared_ptr<AsyncFileManager>();
   return std::make_shared<FileSystemBufferFilterConfig>(std::move(factory), std::move(manager),
@@ -1,5 +1,7 @@
 #include "source/extensions/health_checkers/common/health_checker_base_impl.h"
 
+#include <algorithm>
+
 #include "envoy/config/core/v3/address.pb.h"
 #include "envoy/config/core/v3/health_check.pb.h"
 #include "envoy/data/core/v3/health_check_event.pb.h"
@@ -8,9 +10,13 @@
 #include "source/common/network/utility.h"
 #include "source/common/router/router.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Upstream {
 
+SINGLETON_MANAGER_REGISTRATION(shared_health_check_probes);
+
 HealthCheckerImplBase::HealthCheckerImplBase(const Cluster& cluster,
                                              const envoy::config::core::v3::HealthCheck& config,
                                              Event::Dispatcher& dispatcher,
@@ -39,6 +45,8 @@ HealthCheckerImplBase::HealthCheckerImplBase(const Cluster& cluster,
           PROTOBUF_GET_MS_OR_DEFAULT(config, healthy_edge_interval, interval_.count())),
       transport_socket_options_(initTransportSocketOptions(config)),
       transport_socket_match_metadata_(initTransportSocketMatchMetadata(config)),
+      share_probes_(config.share_probes()),
+      config_hash_(share_probes_ ? MessageUtil::hash(config) : 0),
       member_update_cb_{cluster_.prioritySet().addMemberUpdateCb(
           [this](const HostVector& hosts_added, const HostVector& hosts_removed) -> absl::Status {
             onClusterMemberUpdate(hosts_added, hosts_removed);
@@ -84,6 +92,21 @@ HealthCheckerImplBase::~HealthCheckerImplBase() {
   }
 }
 
+void HealthCheckerImplBase::initSharedProbes(Singleton::Manager& singleton_manager) {
+  if (!share_probes_) {
+    return;
+  }
+  shared_probes_ = singleton_manager.getTyped<SharedProbes>(
+      SINGLETON_MANAGER_REGISTERED_NAME(shared_health_check_probes),
+      [] { return std::make_shared<SharedProbes>(); });
+}
+
+std::string HealthCheckerImplBase::sharedProbeKey(const HostSharedPtr& host) const {
+  // Clusters with different transport sockets, e.g. TLS contexts, must probe the host separately.
+  return absl::StrCat(config_hash_, "|", cluster_.info()->transportSocketMatcher().configHash(),
+                      "|", host->healthCheckAddress()->asString());
+}
+
 void HealthCheckerImplBase::decHealthy() { stats_.healthy_.sub(1); }
 
 void HealthCheckerImplBase::decDegraded() { stats_.degraded_.sub(1); }
@@ -167,6 +190,9 @@ void HealthCheckerImplBase::addHosts(const HostVector& hosts) {
     active_sessions_[host] = makeSession(host);
     host->setHealthChecker(
         HealthCheckHostMonitorPtr{new HealthCheckHostMonitorImpl(shared_from_this(), host)});
+    if (shared_probes_ != nullptr) {
+      active_sessions_[host]->joinSharedProbe(*shared_probes_, sharedProbeKey(host));
+    }
     active_sessions_[host]->start();
   }
 }
@@ -259,12 +285,26 @@ HealthCheckerImplBase::ActiveHealthCheckSession::~ActiveHealthCheckSession() {
   ASSERT(interval_timer_ == nullptr && timeout_timer_ == nullptr);
 }
 
+void HealthCheckerImplBase::ActiveHealthCheckSession::start() {
+  if (probing_) {
+    onInitialInterval();
+  } else if (shared_probe_->last_result_.has_value()) {
+    // Hand the session the result of the latest probe of its group, rather than having it wait
+    // for the next one.
+    interval_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+}
+
 void HealthCheckerImplBase::ActiveHealthCheckSession::onDeferredDeleteBase() {
   HealthState state = HealthState::Unhealthy;
   // The session is about to be deferred deleted. Make sure all timers are gone and any
   // implementation specific state is destroyed.
   interval_timer_.reset();
   timeout_timer_.reset();
+  if (shared_probe_ != nullptr) {
+    parent_.shared_probes_->leave(shared_probe_key_, *this);
+    shared_probe_.reset();
+  }
   if (!host_->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)) {
     parent_.decHealthy();
     state = HealthState::Healthy;
@@ -280,7 +320,56 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::onDeferredDeleteBase() {
   }
 }
 
+void HealthCheckerImplBase::ActiveHealthCheckSession::joinSharedProbe(SharedProbes& shared_probes,
+                                                                     std::string key) {
+  shared_probe_key_ = std::move(key);
+  shared_probe_ = shared_probes.join(shared_probe_key_, *this);
+  probing_ = shared_probe_->sessions_.front() == this;
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::startProbing() {
+  probing_ = true;
+  if (interval_timer_ != nullptr) {
+    interval_timer_->enableTimer(
+        first_check_ ? std::chrono::milliseconds(0)
+                     : parent_.interval(host_->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)
+                                            ? HealthState::Unhealthy
+                                            : HealthState::Healthy,
+                                        HealthTransition::Unchanged));
+  }
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::shareResult(const ProbeResult& result) {
+  if (shared_probe_ == nullptr) {
+    return;
+  }
+  // Handing a session the result may remove sessions from the group, or even the group itself
+  // once it is empty, so go through a copy of the sessions which holds on to the group.
+  const SharedProbeGroupSharedPtr group = shared_probe_;
+  group->last_result_ = result;
+  const std::vector<ActiveHealthCheckSession*> sessions = group->sessions_;
+  for (ActiveHealthCheckSession* session : sessions) {
+    if (session != this && std::find(group->sessions_.begin(), group->sessions_.end(), session) !=
+                               group->sessions_.end()) {
+      session->recordResult(result);
+    }
+  }
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::recordResult(const ProbeResult& result) {
+  if (result.healthy_) {
+    recordSuccess(result.degraded_);
+  } else {
+    recordFailure(result.failure_type_, result.retriable_);
+  }
+}
+
 void HealthCheckerImplBase::ActiveHealthCheckSession::handleSuccess(bool degraded) {
+  shareResult({true, degraded, envoy::data::core::v3::ACTIVE, false});
+  recordSuccess(degraded);
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::recordSuccess(bool degraded) {
   // If we are healthy, reset the # of unhealthy to zero.
   num_unhealthy_ = 0;
 
@@ -342,8 +431,14 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::handleSuccess(bool degrade
   first_check_ = false;
   parent_.runCallbacks(host_, changed_state, HealthState::Healthy);
 
-  timeout_timer_->disableTimer();
-  interval_timer_->enableTimer(parent_.interval(HealthState::Healthy, changed_state));
+  // It's possible that a session of the same group caused this session to be deferred deleted.
+  if (timeout_timer_ != nullptr) {
+    timeout_timer_->disableTimer();
+  }
+
+  if (probing_ && interval_timer_ != nullptr) {
+    interval_timer_->enableTimer(parent_.interval(HealthState::Healthy, changed_state));
+  }
 }
 
 namespace {
@@ -404,13 +499,19 @@ HealthTransition HealthCheckerImplBase::ActiveHealthCheckSession::setUnhealthy(
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::handleFailure(
     envoy::data::core::v3::HealthCheckFailureType type, bool retriable) {
+  shareResult({false, false, type, retriable});
+  recordFailure(type, retriable);
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::recordFailure(
+    envoy::data::core::v3::HealthCheckFailureType type, bool retriable) {
   HealthTransition changed_state = setUnhealthy(type, retriable);
   // It's possible that the previous call caused this session to be deferred deleted.
   if (timeout_timer_ != nullptr) {
     timeout_timer_->disableTimer();
   }
 
-  if (interval_timer_ != nullptr) {
+  if (probing_ && interval_timer_ != nullptr) {
     interval_timer_->enableTimer(parent_.interval(HealthState::Unhealthy, changed_state));
   }
 }
@@ -428,6 +529,12 @@ HealthCheckerImplBase::ActiveHealthCheckSession::clearPendingFlag(HealthTransiti
 }
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::onIntervalBase() {
+  if (!probing_) {
+    // The session was just added to a group, whose latest result it is handed.
+    ASSERT(shared_probe_ != nullptr && shared_probe_->last_result_.has_value());
+    recordResult(*shared_probe_->last_result_);
+    return;
+  }
   onInterval();
   timeout_timer_->enableTimer(parent_.timeout_);
   parent_.stats_.attempt_.inc();
@@ -447,5 +554,32 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::onInitialInterval() {
   }
 }
 
+HealthCheckerImplBase::SharedProbeGroupSharedPtr
+HealthCheckerImplBase::SharedProbes::join(const std::string& key,
+                                          ActiveHealthCheckSession& session) {
+  SharedProbeGroupSharedPtr& group = groups_[key];
+  if (group == nullptr) {
+    group = std::make_shared<SharedProbeGroup>();
+  }
+  group->sessions_.push_back(&session);
+  return group;
+}
+
+void HealthCheckerImplBase::SharedProbes::leave(const std::string& key,
+                                                ActiveHealthCheckSession& session) {
+  auto it = groups_.find(key);
+  ASSERT(it != groups_.end());
+  SharedProbeGroupSharedPtr group = it->second;
+  auto session_it = std::find(group->sessions_.begin(), group->sessions_.end(), &session);
+  ASSERT(session_it != group->sessions_.end());
+  const bool was_probing = session_it == group->sessions_.begin();
+  group->sessions_.erase(session_it);
+  if (group->sessions_.empty()) {
+    groups_.erase(it);
+  } else if (was_probing) {
+    group->sessions_.front()->startProbing();
+  }
+}
+
 } // namespace Upstream
 } // namespace Envoy
@@ -7,6 +7,7 @@
 #include "envoy/data/core/v3/health_check_event.pb.h"
 #include "envoy/event/timer.h"
 #include "envoy/runtime/runtime.h"
+#include "envoy/singleton/manager.h"
 #include "envoy/stats/scope.h"
 #include "envoy/type/matcher/string.pb.h"
 #include "envoy/upstream/health_checker.h"
@@ -15,6 +16,9 @@
 #include "source/common/common/matchers.h"
 #include "source/common/network/transport_socket_options_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -55,14 +59,32 @@ public:
     return transport_socket_match_metadata_;
   }
 
+  /**
+   * Shares the probes of the health checker with the other health checkers of the server, if its
+   * config enables share_probes. Must be called before start().
+   */
+  void initSharedProbes(Singleton::Manager& singleton_manager);
+
 protected:
+  class SharedProbes;
+  struct SharedProbeGroup;
+  using SharedProbeGroupSharedPtr = std::shared_ptr<SharedProbeGroup>;
+
+  // The outcome of a probe, as handed to the sessions which share it.
+  struct ProbeResult {
+    bool healthy_;
+    bool degraded_;
+    envoy::data::core::v3::HealthCheckFailureType failure_type_;
+    bool retriable_;
+  };
+
   class ActiveHealthCheckSession : public Event::DeferredDeletable {
   public:
     ~ActiveHealthCheckSession() override;
     HealthTransition setUnhealthy(envoy::data::core::v3::HealthCheckFailureType type,
                                   bool retriable);
     void onDeferredDeleteBase();
-    void start() { onInitialInterval(); }
+    void start();
 
   protected:
     ActiveHealthCheckSession(HealthCheckerImplBase& parent, HostSharedPtr host);
@@ -73,6 +95,18 @@ protected:
     HostSharedPtr host_;
 
   private:
+    friend class SharedProbes;
+
+    // Joins the sessions of other health checkers which probe the host the same way. Only the
+    // first session of the group probes the host, and hands the results to the others.
+    void joinSharedProbe(SharedProbes& shared_probes, std::string key);
+    // Called when the session becomes the first of its group, and so has to probe the host.
+    void startProbing();
+    // Hands the result of a probe of this session to the other sessions of its group.
+    void shareResult(const ProbeResult& result);
+    void recordResult(const ProbeResult& result);
+    void recordSuccess(bool degraded);
+    void recordFailure(envoy::data::core::v3::HealthCheckFailureType type, bool retriable);
     // Clears the pending flag if it is set. By clearing this flag we're marking the host as having
     // been health checked.
     // Returns the changed state to use following the flag update.
@@ -90,7 +124,30 @@ protected:
     uint32_t num_unhealthy_{};
     uint32_t num_healthy_{};
     bool first_check_{true};
+    // False while the session is handed the results of another session of its group.
+    bool probing_{true};
     TimeSource& time_source_;
+    std::string shared_probe_key_;
+    SharedProbeGroupSharedPtr shared_probe_;
+  };
+
+  // The sessions which share the probes of a host, of which the first one probes it.
+  struct SharedProbeGroup {
+    std::vector<ActiveHealthCheckSession*> sessions_;
+    absl::optional<ProbeResult> last_result_;
+  };
+
+  /**
+   * The groups of sessions which share their probes, across all of the health checkers of the
+   * server. Main thread only.
+   */
+  class SharedProbes : public Singleton::Instance {
+  public:
+    SharedProbeGroupSharedPtr join(const std::string& key, ActiveHealthCheckSession& session);
+    void leave(const std::string& key, ActiveHealthCheckSession& session);
+
+  private:
+    absl::flat_hash_map<std::string, SharedProbeGroupSharedPtr> groups_;
   };
 
   using ActiveHealthCheckSessionPtr = std::unique_ptr<ActiveHealthCheckSession>;
@@ -102,6 +159,10 @@ protected:
 
   virtual ActiveHealthCheckSessionPtr makeSession(HostSharedPtr host) PURE;
   virtual envoy::data::core::v3::HealthCheckerType healthCheckerType() const PURE;
+  // Identifies the probes of the host which are identical across health checkers with the same
+  // config and cluster transport sockets. Health checkers which send a host name or authority that
+  // depends on the cluster add it.
+  virtual std::string sharedProbeKey(const HostSharedPtr& host) const;
 
   const bool always_log_health_check_failures_;
   const bool always_log_health_check_success_;
@@ -161,6 +222,9 @@ private:
   absl::node_hash_map<HostSharedPtr, ActiveHealthCheckSessionPtr> active_sessions_;
   const std::shared_ptr<const Network::TransportSocketOptionsImpl> transport_socket_options_;
   const MetadataConstSharedPtr transport_socket_match_metadata_;
+  const bool share_probes_;
+  const uint64_t config_hash_;
+  std::shared_ptr<SharedProbes> shared_probes_;
   const Common::CallbackHandlePtr member_update_cb_;
 };
 
@@ -45,9 +45,11 @@ const std::string& getHostname(const HostSharedPtr& host,
 Upstream::HealthCheckerSharedPtr GrpcHealthCheckerFactory::createCustomHealthChecker(
     const envoy::config::core::v3::HealthCheck& config,
     Server::Configuration::HealthCheckerFactoryContext& context) {
-  return std::make_shared<ProdGrpcHealthCheckerImpl>(
+  auto health_checker = std::make_shared<ProdGrpcHealthCheckerImpl>(
       context.cluster(), config, context.mainThreadDispatcher(), context.runtime(),
       context.api().randomGenerator(), context.eventLogger());
+  health_checker->initSharedProbes(context.serverFactoryContext().singletonManager());
+  return health_checker;
 }
 
 REGISTER_FACTORY(GrpcHealthCheckerFactory, Server::Configuration::CustomHealthCheckerFactory);
@@ -74,6 +76,11 @@ GrpcHealthCheckerImpl::GrpcHealthCheckerImpl(const Cluster& cluster,
   }
 }
 
+std::string GrpcHealthCheckerImpl::sharedProbeKey(const HostSharedPtr& host) const {
+  return absl::StrCat(HealthCheckerImplBase::sharedProbeKey(host), "|",
+                      getHostname(host, authority_value_, cluster_.info()));
+}
+
 GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::GrpcActiveHealthCheckSession(
     GrpcHealthCheckerImpl& parent, const HostSharedPtr& host)
     : ActiveHealthCheckSession(parent, host), parent_(parent),
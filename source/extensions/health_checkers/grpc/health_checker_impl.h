@@ -138,6 +138,7 @@ private:
   envoy::data::core::v3::HealthCheckerType healthCheckerType() const override {
     return envoy::data::core::v3::GRPC;
   }
+  std::string sharedProbeKey(const HostSharedPtr& host) const override;
 
 protected:
   Random::RandomGenerator& random_generator_;
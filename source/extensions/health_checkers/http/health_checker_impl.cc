@@ -48,8 +48,10 @@ getMethod(const envoy::config::core::v3::RequestMethod config_method) {
 Upstream::HealthCheckerSharedPtr HttpHealthCheckerFactory::createCustomHealthChecker(
     const envoy::config::core::v3::HealthCheck& config,
     Server::Configuration::HealthCheckerFactoryContext& context) {
-  return std::make_shared<ProdHttpHealthCheckerImpl>(context.cluster(), config, context,
-                                                     context.eventLogger());
+  auto health_checker = std::make_shared<ProdHttpHealthCheckerImpl>(context.cluster(), config,
+                                                                    context, context.eventLogger());
+  health_checker->initSharedProbes(context.serverFactoryContext().singletonManager());
+  return health_checker;
 }
 
 REGISTER_FACTORY(HttpHealthCheckerFactory, Server::Configuration::CustomHealthCheckerFactory);
@@ -179,6 +181,11 @@ Http::Protocol HttpHealthCheckerImpl::protocol() const {
   return codecClientTypeToProtocol(codec_client_type_);
 }
 
+std::string HttpHealthCheckerImpl::sharedProbeKey(const HostSharedPtr& host) const {
+  return absl::StrCat(HealthCheckerImplBase::sharedProbeKey(host), "|",
+                      HealthCheckerFactory::getHostname(host, host_value_, cluster_.info()));
+}
+
 HttpHealthCheckerImpl::HttpActiveHealthCheckSession::HttpActiveHealthCheckSession(
     HttpHealthCheckerImpl& parent, const HostSharedPtr& host)
     : ActiveHealthCheckSession(parent, host), parent_(parent),
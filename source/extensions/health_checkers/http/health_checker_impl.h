@@ -161,6 +161,7 @@ private:
   envoy::data::core::v3::HealthCheckerType healthCheckerType() const override {
     return envoy::data::core::v3::HTTP;
   }
+  std::string sharedProbeKey(const HostSharedPtr& host) const override;
 
   Http::CodecType codecClientType(const envoy::type::v3::CodecClientType& type);
 
@@ -8,6 +8,9 @@
 #include "source/common/filesystem/directory.h"
 #include "source/extensions/http/cache/file_system_http_cache/file_system_http_cache.h"
 
+#include "absl/strings/numbers.h"
+#include "absl/strings/strip.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
@@ -18,6 +21,15 @@ namespace {
 bool isCacheFile(const Filesystem::DirectoryEntry& entry) {
   return entry.type_ == Filesystem::FileType::Regular && absl::StartsWith(entry.name_, "cache-");
 }
+
+// The inverse of FileSystemHttpCache::generateFilename.
+absl::optional<uint64_t> hashFromFilename(absl::string_view filename) {
+  uint64_t hash;
+  if (!absl::SimpleAtoi(absl::StripPrefix(filename, "cache-"), &hash)) {
+    return absl::nullopt;
+  }
+  return hash;
+}
 } // namespace
 
 CacheEvictionThread::CacheEvictionThread(Thread::ThreadFactory& thread_factory)
@@ -96,9 +108,14 @@ void CacheShared::evict() {
   struct CacheFile {
     std::string name_;
     uint64_t size_;
+    // Entries served from the hot tier don't touch their files, so they are treated as the
+    // youngest regardless of their timestamps.
+    bool hot_;
     Envoy::SystemTime last_touch_;
   };
   std::vector<CacheFile> cache_files;
+  const absl::flat_hash_set<uint64_t> hot_hashes =
+      hot_tier_ ? hot_tier_->hashes() : absl::flat_hash_set<uint64_t>{};
 
   // TODO(ravenblack): Add support for directory tree structure.
   for (const Filesystem::DirectoryEntry& entry : Filesystem::Directory(std::string{cachePath()})) {
@@ -117,12 +134,16 @@ void CacheShared::evict() {
           std::max(timespecToChrono(s.st_atim), timespecToChrono(s.st_ctim));
 #endif
 
-      cache_files.push_back(CacheFile{entry.name_, entry.size_bytes_.value_or(0), last_touch});
+      const absl::optional<uint64_t> hash = hashFromFilename(entry.name_);
+      const bool hot = hash.has_value() && hot_hashes.contains(*hash);
+      cache_files.push_back(
+          CacheFile{entry.name_, entry.size_bytes_.value_or(0), hot, last_touch});
     }
   }
-  // Sort the vector by last-touch timestamp, highest (i.e. youngest) first.
+  // Sort the vector by hot tier membership and then by last-touch timestamp, highest
+  // (i.e. youngest) first.
   std::sort(cache_files.begin(), cache_files.end(), [](CacheFile& a, CacheFile& b) {
-    return std::tie(a.last_touch_, a.name_) > std::tie(b.last_touch_, b.name_);
+    return std::tie(a.hot_, a.last_touch_, a.name_) > std::tie(b.hot_, b.last_touch_, b.name_);
   });
   size_bytes_ = size;
   size_count_ = count;
@@ -154,6 +175,9 @@ void CacheShared::evict() {
       // and the eviction thread will be churning, trying and failing to remove a file, which would
       // be worth logging a warning, versus if the file is already gone then there's no problem.
       trackFileRemoved(it->size_);
+      if (it->hot_) {
+        hot_tier_->remove(*hashFromFilename(it->name_));
+      }
     }
     ++it;
   }
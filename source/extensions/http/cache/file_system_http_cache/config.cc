@@ -105,7 +105,8 @@ public:
             SINGLETON_MANAGER_REGISTERED_NAME(file_system_http_cache_singleton), [&context] {
               return std::make_shared<CacheSingleton>(
                   Common::AsyncFiles::AsyncFileManagerFactory::singleton(
-                      &context.serverFactoryContext().singletonManager()),
+                      &context.serverFactoryContext().singletonManager(),
+                      &context.serverFactoryContext().threadLocal()),
                   context.serverFactoryContext().api().threadFactory());
             });
     return caches->get(caches, config, context.scope());
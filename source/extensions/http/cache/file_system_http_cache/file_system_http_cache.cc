@@ -36,8 +36,8 @@ void FileSystemHttpCache::writeVaryNodeToDisk(Event::Dispatcher& dispatcher, con
   std::string filename = absl::StrCat(cachePath(), generateFilename(key));
   async_file_manager_->createAnonymousFile(
       &dispatcher, cachePath(),
-      [headers, filename = std::move(filename), cleanup,
-       dispatcher = &dispatcher](absl::StatusOr<AsyncFileHandle> open_result) {
+      [headers, filename = std::move(filename), cleanup, dispatcher = &dispatcher,
+       cache = shared_from_this(), key](absl::StatusOr<AsyncFileHandle> open_result) {
         if (!open_result.ok()) {
           ENVOY_LOG(warn, "writing vary node, failed to createAnonymousFile: {}",
                     open_result.status());
@@ -53,17 +53,20 @@ void FileSystemHttpCache::writeVaryNodeToDisk(Event::Dispatcher& dispatcher, con
         size_t sz = buf2.length();
         auto queued = file_handle->write(
             dispatcher, buf2, 0,
-            [dispatcher, file_handle, cleanup, sz,
-             filename = std::move(filename)](absl::StatusOr<size_t> write_result) {
+            [dispatcher, file_handle, cleanup, sz, filename = std::move(filename), cache,
+             key](absl::StatusOr<size_t> write_result) {
               if (!write_result.ok() || write_result.value() != sz) {
                 ENVOY_LOG(warn, "writing vary node, failed to write: {}", write_result.status());
                 file_handle->close(nullptr, [](absl::Status) {}).IgnoreError();
                 return;
               }
               auto queued = file_handle->createHardLink(
-                  dispatcher, filename, [cleanup, file_handle](absl::Status link_result) {
+                  dispatcher, filename,
+                  [cleanup, file_handle, cache, key](absl::Status link_result) {
                     if (!link_result.ok()) {
                       ENVOY_LOG(warn, "writing vary node, failed to link: {}", link_result);
+                    } else {
+                      cache->removeFromHotTier(key);
                     }
                     file_handle->close(nullptr, [](absl::Status) {}).IgnoreError();
                   });
@@ -89,7 +92,11 @@ FileSystemHttpCache::FileSystemHttpCache(
 
 CacheShared::CacheShared(ConfigProto config, Stats::Scope& stats_scope)
     : config_(config), stat_names_(stats_scope.symbolTable()),
-      stats_(generateStats(stat_names_, stats_scope, cachePath())) {}
+      stats_(generateStats(stat_names_, stats_scope, cachePath())) {
+  if (config_.has_hot_tier()) {
+    hot_tier_ = std::make_unique<HotTier>(config_.hot_tier(), stats_);
+  }
+}
 
 FileSystemHttpCache::~FileSystemHttpCache() { cache_eviction_thread_.removeCache(shared_); }
 
@@ -123,14 +130,14 @@ LookupContextPtr FileSystemHttpCache::makeLookupContext(LookupRequest&& lookup,
 // Helper class to reduce the lambda depth of updateHeaders.
 class HeaderUpdateContext : public Logger::Loggable<Logger::Id::cache_filter> {
 public:
-  HeaderUpdateContext(Event::Dispatcher& dispatcher, const FileSystemHttpCache& cache,
+  HeaderUpdateContext(Event::Dispatcher& dispatcher, std::shared_ptr<FileSystemHttpCache> cache,
                       const Key& key, std::shared_ptr<Cleanup> cleanup,
                       const Http::ResponseHeaderMap& response_headers,
                       const ResponseMetadata& metadata, UpdateHeadersCallback on_complete)
-      : dispatcher_(dispatcher),
-        filepath_(absl::StrCat(cache.cachePath(), cache.generateFilename(key))),
-        cache_path_(cache.cachePath()), cleanup_(cleanup),
-        async_file_manager_(cache.asyncFileManager()),
+      : dispatcher_(dispatcher), cache_(std::move(cache)), key_(key),
+        filepath_(absl::StrCat(cache_->cachePath(), cache_->generateFilename(key))),
+        cache_path_(cache_->cachePath()), cleanup_(cleanup),
+        async_file_manager_(cache_->asyncFileManager()),
         response_headers_(Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers)),
         response_metadata_(metadata), on_complete_(std::move(on_complete)) {}
 
@@ -148,6 +155,9 @@ public:
   }
 
   ~HeaderUpdateContext() {
+    // The original file was unlinked, so whether or not it was replaced the hot tier must
+    // stop serving it.
+    cache_->removeFromHotTier(key_);
     // For chaining the close actions in a file thread, the closes must be chained sequentially.
     // write_handle_ can only be set if read_handle_ is set, so this ordering is safe.
     if (read_handle_) {
@@ -288,6 +298,8 @@ private:
   }
   Event::Dispatcher* dispatcher() { return &dispatcher_; }
   Event::Dispatcher& dispatcher_;
+  std::shared_ptr<FileSystemHttpCache> cache_;
+  const Key key_;
   std::string filepath_;
   std::string cache_path_;
   std::shared_ptr<Cleanup> cleanup_;
@@ -314,8 +326,9 @@ void FileSystemHttpCache::updateHeaders(const LookupContext& base_lookup_context
     return;
   }
   auto ctx =
-      std::make_shared<HeaderUpdateContext>(*lookup_context.dispatcher(), *this, key, cleanup,
-                                            response_headers, metadata, std::move(on_complete));
+      std::make_shared<HeaderUpdateContext>(*lookup_context.dispatcher(), shared_from_this(),
+                                            key, cleanup, response_headers, metadata,
+                                            std::move(on_complete));
   ctx->begin(ctx);
 }
 
@@ -363,6 +376,14 @@ InsertContextPtr FileSystemHttpCache::makeInsertContext(LookupContextPtr&& looku
   return std::make_unique<FileInsertContext>(shared_from_this(), std::move(file_lookup_context));
 }
 
+HotTier* FileSystemHttpCache::hotTier() const { return shared_->hot_tier_.get(); }
+
+void FileSystemHttpCache::removeFromHotTier(const Key& key) {
+  if (shared_->hot_tier_) {
+    shared_->hot_tier_->remove(stableHashKey(key));
+  }
+}
+
 void FileSystemHttpCache::trackFileAdded(uint64_t file_size) {
   shared_->trackFileAdded(file_size);
   if (shared_->needsEviction()) {
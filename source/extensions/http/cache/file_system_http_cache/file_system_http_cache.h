@@ -7,6 +7,7 @@
 #include "source/common/common/logger.h"
 #include "source/extensions/common/async_files/async_file_manager.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/http/cache/file_system_http_cache/hot_tier.h"
 #include "source/extensions/http/cache/file_system_http_cache/stats.h"
 
 #include "absl/base/thread_annotations.h"
@@ -179,6 +180,19 @@ public:
    */
   void trackFileRemoved(uint64_t file_size);
 
+  /**
+   * Returns the in-memory tier of this instance.
+   * @return the hot tier, or nullptr if none is configured.
+   */
+  HotTier* hotTier() const;
+
+  /**
+   * Stops holding the entry with the given key in the hot tier, if any. Must be called
+   * whenever the cache file of the key is replaced or removed.
+   * @param key the key of the entry.
+   */
+  void removeFromHotTier(const Key& key);
+
   // UpdateHeaders copies an existing cache entry to a new file. This value is
   // the size of a copy-chunk. It's public for unit tests only, as the chunk size
   // is totally irrelevant to the outward-facing API.
@@ -251,6 +265,8 @@ struct CacheShared {
   std::atomic<uint64_t> size_count_ = 0;
   std::atomic<uint64_t> size_bytes_ = 0;
   bool needs_init_ = true;
+  // Null if the config has no hot tier.
+  std::unique_ptr<HotTier> hot_tier_;
 
   /**
    * @return true if the eviction thread should do a pass over this cache.
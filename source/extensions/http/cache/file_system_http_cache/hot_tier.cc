@@ -0,0 +1,109 @@
+#include "source/extensions/http/cache/file_system_http_cache/hot_tier.h"
+
+#include <algorithm>
+
+#include "source/common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace FileSystemHttpCache {
+
+namespace {
+
+constexpr uint64_t DefaultMaxEntrySizeBytes = 64 * 1024;
+constexpr uint32_t DefaultMinLookupsToPromote = 2;
+// As in MemoryHttpCache, the sketch is sized for the number of entries of this size which would
+// fit, so that it also estimates the frequencies of entries which are not held.
+constexpr uint64_t EstimatedEntrySize = 4096;
+
+} // namespace
+
+HotTier::HotTier(const ConfigProto::HotTier& config, CacheStats& stats)
+    : max_size_bytes_(config.max_size_bytes()),
+      max_entry_size_bytes_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_entry_size_bytes, DefaultMaxEntrySizeBytes)),
+      min_lookups_to_promote_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, min_lookups_to_promote,
+                                                              DefaultMinLookupsToPromote)),
+      stats_(stats), sketch_(static_cast<uint32_t>(std::min<uint64_t>(
+                         std::max<uint64_t>(max_size_bytes_ / EstimatedEntrySize, 1),
+                         UINT32_MAX))) {}
+
+HotTierEntrySharedPtr HotTier::lookup(uint64_t hash, uint64_t& generation) {
+  absl::MutexLock lock(&mu_);
+  sketch_.increment(hash);
+  auto it = entries_.find(hash);
+  if (it == entries_.end()) {
+    generation = generationOf(hash);
+    return nullptr;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second);
+  stats_.hot_tier_hits_.inc();
+  return it->second->entry_;
+}
+
+void HotTier::offer(uint64_t hash, uint64_t generation, HotTierEntrySharedPtr entry) {
+  const uint64_t size = entry->contents_.size();
+  if (size > max_entry_size_bytes_ || size > max_size_bytes_) {
+    return;
+  }
+  absl::MutexLock lock(&mu_);
+  // Another lookup may have already promoted the same contents, or the file may have been
+  // replaced since it was read.
+  if (entries_.contains(hash) || generationOf(hash) != generation) {
+    return;
+  }
+  const uint32_t frequency = sketch_.frequency(hash);
+  if (frequency < min_lookups_to_promote_) {
+    return;
+  }
+  while (size_bytes_ + size > max_size_bytes_) {
+    const EntryList::iterator victim = std::prev(lru_.end());
+    if (sketch_.frequency(victim->hash_) >= frequency) {
+      return;
+    }
+    removeLocked(victim);
+    stats_.hot_tier_evictions_.inc();
+  }
+  lru_.push_front(Entry{hash, std::move(entry)});
+  entries_.emplace(hash, lru_.begin());
+  size_bytes_ += size;
+  stats_.hot_tier_promotions_.inc();
+  stats_.hot_tier_size_bytes_.add(size);
+  stats_.hot_tier_size_count_.inc();
+}
+
+void HotTier::remove(uint64_t hash) {
+  absl::MutexLock lock(&mu_);
+  generationOf(hash)++;
+  auto it = entries_.find(hash);
+  if (it != entries_.end()) {
+    removeLocked(it->second);
+  }
+}
+
+void HotTier::removeLocked(EntryList::iterator it) {
+  const uint64_t size = it->entry_->contents_.size();
+  size_bytes_ -= size;
+  stats_.hot_tier_size_bytes_.sub(size);
+  stats_.hot_tier_size_count_.dec();
+  entries_.erase(it->hash_);
+  lru_.erase(it);
+}
+
+absl::flat_hash_set<uint64_t> HotTier::hashes() const {
+  absl::MutexLock lock(&mu_);
+  absl::flat_hash_set<uint64_t> result;
+  result.reserve(entries_.size());
+  for (const Entry& entry : lru_) {
+    result.insert(entry.hash_);
+  }
+  return result;
+}
+
+} // namespace FileSystemHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <array>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "envoy/extensions/http/cache/file_system_http_cache/v3/file_system_http_cache.pb.h"
+
+#include "source/extensions/http/cache/file_system_http_cache/cache_file_fixed_block.h"
+#include "source/extensions/http/cache/file_system_http_cache/stats.h"
+#include "source/extensions/http/cache/memory_http_cache/frequency_sketch.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace FileSystemHttpCache {
+
+/**
+ * The contents of a cache file held in memory: the fixed block, and everything that follows it
+ * in the file.
+ */
+struct HotTierEntry {
+  HotTierEntry(const CacheFileFixedBlock& header_block, std::string contents)
+      : header_block_(header_block), contents_(std::move(contents)) {}
+
+  absl::string_view headers() const {
+    return absl::string_view(contents_).substr(0, header_block_.headerSize());
+  }
+  absl::string_view body() const {
+    return absl::string_view(contents_).substr(header_block_.headerSize(),
+                                               header_block_.bodySize());
+  }
+  absl::string_view trailers() const {
+    return absl::string_view(contents_).substr(
+        header_block_.headerSize() + header_block_.bodySize(), header_block_.trailerSize());
+  }
+
+  const CacheFileFixedBlock header_block_;
+  // The headers, body and trailers, serialized as they are in the file.
+  const std::string contents_;
+};
+
+using HotTierEntrySharedPtr = std::shared_ptr<const HotTierEntry>;
+
+/**
+ * An in-memory tier in front of the files of a FileSystemHttpCache, holding the most frequently
+ * looked up small entries.
+ *
+ * Entries are only ever added from the contents of a cache file which a lookup has read, and
+ * are keyed by the same hash as the file name. An entry which would displace others is only
+ * admitted if it has been looked up more often than each of them, estimated with a
+ * FrequencySketch as in W-TinyLFU.
+ *
+ * Writers of a cache file must call remove() once the new file is in place. Since a lookup can
+ * still be reading the previous file at that point, each removal also advances a generation,
+ * and contents read before the removal are not admitted.
+ *
+ * The tier is thread safe; it is shared by all the workers and the eviction thread.
+ */
+class HotTier {
+public:
+  using ConfigProto =
+      envoy::extensions::http::cache::file_system_http_cache::v3::FileSystemHttpCacheConfig;
+
+  HotTier(const ConfigProto::HotTier& config, CacheStats& stats);
+
+  /**
+   * Records a lookup of an entry.
+   * @param hash the stable hash of the key of the entry.
+   * @param generation set to the generation to pass to offer(), if the entry is not held and
+   *     the lookup reads the cache file instead.
+   * @return the entry, or nullptr if it is not held.
+   */
+  HotTierEntrySharedPtr lookup(uint64_t hash, uint64_t& generation) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * @param file_size the size of a cache file.
+   * @return true if the contents of a cache file of that size may be held.
+   */
+  bool mayHold(uint64_t file_size) const { return file_size <= max_entry_size_bytes_; }
+
+  /**
+   * Offers the contents of a cache file which a lookup has read. The entry is held if it has
+   * been looked up often enough, and more often than the entries which it would displace.
+   * @param hash the stable hash of the key of the entry.
+   * @param generation the generation from the lookup() which preceded reading the file.
+   * @param entry the contents of the file.
+   */
+  void offer(uint64_t hash, uint64_t generation, HotTierEntrySharedPtr entry)
+      ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Stops holding an entry, because its cache file has been replaced or removed.
+   * @param hash the stable hash of the key of the entry.
+   */
+  void remove(uint64_t hash) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * @return the hashes of all the entries held, for the eviction thread to keep their files.
+   */
+  absl::flat_hash_set<uint64_t> hashes() const ABSL_LOCKS_EXCLUDED(mu_);
+
+private:
+  struct Entry {
+    uint64_t hash_;
+    HotTierEntrySharedPtr entry_;
+  };
+  using EntryList = std::list<Entry>;
+
+  // Removals are counted in stripes of hashes rather than per hash so that the generations
+  // take a fixed amount of memory; a removal only prevents the admission of contents read
+  // concurrently with the same stripe.
+  static constexpr size_t GenerationStripes = 256;
+  uint64_t& generationOf(uint64_t hash) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return generations_[hash % GenerationStripes];
+  }
+  void removeLocked(EntryList::iterator it) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const uint64_t max_size_bytes_;
+  const uint64_t max_entry_size_bytes_;
+  const uint32_t min_lookups_to_promote_;
+  CacheStats& stats_;
+
+  mutable absl::Mutex mu_;
+  // Most recently used first.
+  EntryList lru_ ABSL_GUARDED_BY(mu_);
+  absl::flat_hash_map<uint64_t, EntryList::iterator> entries_ ABSL_GUARDED_BY(mu_);
+  FrequencySketch sketch_ ABSL_GUARDED_BY(mu_);
+  std::array<uint64_t, GenerationStripes> generations_ ABSL_GUARDED_BY(mu_){};
+  uint64_t size_bytes_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
+} // namespace FileSystemHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
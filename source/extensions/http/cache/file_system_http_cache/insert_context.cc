@@ -265,6 +265,7 @@ void FileInsertContext::commitCreateHardLink() {
         succeedCurrentAction();
         uint64_t file_size = header_block_.offsetToTrailers() + header_block_.trailerSize();
         cache_->trackFileAdded(file_size);
+        cache_->removeFromHotTier(key_);
         // By clearing cleanup before destructor, we prevent logging an error.
         cleanup_ = nullptr;
       });
@@ -1,5 +1,6 @@
 #include "source/extensions/http/cache/file_system_http_cache/lookup_context.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/extensions/http/cache/file_system_http_cache/cache_file_fixed_block.h"
 #include "source/extensions/http/cache/file_system_http_cache/cache_file_header.pb.h"
 #include "source/extensions/http/cache/file_system_http_cache/cache_file_header_proto_util.h"
@@ -23,6 +24,18 @@ void FileLookupContext::getHeaders(LookupHeadersCallback&& cb) {
 }
 
 void FileLookupContext::tryOpenCacheFile() {
+  if (HotTier* hot_tier = cache_.hotTier()) {
+    hot_entry_ = hot_tier->lookup(stableHashKey(key_), hot_tier_generation_);
+    if (hot_entry_) {
+      header_block_ = hot_entry_->header_block_;
+      return post([this]() {
+        CacheFileHeader header_proto;
+        const absl::string_view headers = hot_entry_->headers();
+        header_proto.ParseFromArray(headers.data(), headers.size());
+        onHeaders(header_proto);
+      });
+    }
+  }
   cancel_action_in_flight_ = cache_.asyncFileManager()->openExistingFile(
       dispatcher(), filepath(), Common::AsyncFiles::AsyncFileManager::Mode::ReadOnly,
       [this](absl::StatusOr<AsyncFileHandle> open_result) {
@@ -61,6 +74,10 @@ void FileLookupContext::getHeaderBlockFromFile() {
         if (!header_block_.isValid()) {
           return doCacheEntryInvalid();
         }
+        HotTier* hot_tier = cache_.hotTier();
+        if (hot_tier != nullptr && hot_tier->mayHold(header_block_.offsetToEnd())) {
+          return getEntryFromFile();
+        }
         getHeadersFromFile();
       });
   ASSERT(queued.ok(), queued.status().ToString());
@@ -77,28 +94,58 @@ void FileLookupContext::getHeadersFromFile() {
         if (!read_result.ok() || read_result.value()->length() != header_block_.headerSize()) {
           return doCacheEntryInvalid();
         }
-        auto header_proto = makeCacheFileHeaderProto(*read_result.value());
-        if (header_proto.headers_size() == 1 && header_proto.headers().at(0).key() == "vary") {
-          auto maybe_vary_key = cache_.makeVaryKey(
-              key_, lookup().varyAllowList(),
-              absl::StrSplit(header_proto.headers().at(0).value(), ','), lookup().requestHeaders());
-          if (!maybe_vary_key.has_value()) {
-            return doCacheMiss();
-          }
-          key_ = maybe_vary_key.value();
-          return closeFileAndGetHeadersAgainWithNewVaryKey();
+        onHeaders(makeCacheFileHeaderProto(*read_result.value()));
+      });
+  ASSERT(queued.ok(), queued.status().ToString());
+  cancel_action_in_flight_ = std::move(queued.value());
+}
+
+void FileLookupContext::getEntryFromFile() {
+  ASSERT(dispatcher()->isThreadSafe());
+  const uint64_t length = header_block_.offsetToEnd() - header_block_.offsetToHeaders();
+  auto queued = file_handle_->read(
+      dispatcher(), header_block_.offsetToHeaders(), length,
+      [this, length](absl::StatusOr<Buffer::InstancePtr> read_result) {
+        ASSERT(dispatcher()->isThreadSafe());
+        cancel_action_in_flight_ = nullptr;
+        if (!read_result.ok() || read_result.value()->length() != length) {
+          return doCacheEntryInvalid();
         }
-        cache_.stats().cache_hit_.inc();
-        std::move(lookup_headers_callback_)(
-            lookup().makeLookupResult(headersFromHeaderProto(header_proto),
-                                      metadataFromHeaderProto(header_proto),
-                                      header_block_.bodySize()),
-            /* end_stream = */ header_block_.trailerSize() == 0 && header_block_.bodySize() == 0);
+        hot_entry_ =
+            std::make_shared<const HotTierEntry>(header_block_, read_result.value()->toString());
+        cache_.hotTier()->offer(stableHashKey(key_), hot_tier_generation_, hot_entry_);
+        CacheFileHeader header_proto;
+        const absl::string_view headers = hot_entry_->headers();
+        header_proto.ParseFromArray(headers.data(), headers.size());
+        onHeaders(header_proto);
       });
   ASSERT(queued.ok(), queued.status().ToString());
   cancel_action_in_flight_ = std::move(queued.value());
 }
 
+void FileLookupContext::onHeaders(const CacheFileHeader& header_proto) {
+  if (header_proto.headers_size() == 1 && header_proto.headers().at(0).key() == "vary") {
+    auto maybe_vary_key = cache_.makeVaryKey(
+        key_, lookup().varyAllowList(), absl::StrSplit(header_proto.headers().at(0).value(), ','),
+        lookup().requestHeaders());
+    if (!maybe_vary_key.has_value()) {
+      return doCacheMiss();
+    }
+    key_ = maybe_vary_key.value();
+    hot_entry_ = nullptr;
+    if (!file_handle_) {
+      // The vary entry was served from the hot tier.
+      return tryOpenCacheFile();
+    }
+    return closeFileAndGetHeadersAgainWithNewVaryKey();
+  }
+  cache_.stats().cache_hit_.inc();
+  std::move(lookup_headers_callback_)(
+      lookup().makeLookupResult(headersFromHeaderProto(header_proto),
+                                metadataFromHeaderProto(header_proto), header_block_.bodySize()),
+      /* end_stream = */ header_block_.trailerSize() == 0 && header_block_.bodySize() == 0);
+}
+
 void FileLookupContext::closeFileAndGetHeadersAgainWithNewVaryKey() {
   ASSERT(dispatcher()->isThreadSafe());
   auto queued = file_handle_->close(dispatcher(), [this](absl::Status) {
@@ -117,19 +164,20 @@ void FileLookupContext::invalidateCacheEntry() {
   // if the filter was destroyed in the meantime. For the same reason, we must not capture 'this'.
   cache_.asyncFileManager()->stat(
       dispatcher(), filepath(),
-      [file = filepath(), cache = cache_.shared_from_this(),
-       dispatcher = dispatcher()](absl::StatusOr<struct stat> stat_result) {
+      [file = filepath(), cache = cache_.shared_from_this(), dispatcher = dispatcher(),
+       key = key_](absl::StatusOr<struct stat> stat_result) {
         ASSERT(dispatcher->isThreadSafe());
         size_t file_size = 0;
         if (stat_result.ok()) {
           file_size = stat_result.value().st_size;
         }
-        cache->asyncFileManager()->unlink(dispatcher, file,
-                                          [cache, file_size](absl::Status unlink_result) {
-                                            if (unlink_result.ok()) {
-                                              cache->trackFileRemoved(file_size);
-                                            }
-                                          });
+        cache->asyncFileManager()->unlink(
+            dispatcher, file, [cache, file_size, key](absl::Status unlink_result) {
+              if (unlink_result.ok()) {
+                cache->trackFileRemoved(file_size);
+                cache->removeFromHotTier(key);
+              }
+            });
       });
 }
 
@@ -137,6 +185,14 @@ void FileLookupContext::getBody(const AdjustedByteRange& range, LookupBodyCallba
   ASSERT(dispatcher()->isThreadSafe());
   ASSERT(cb);
   ASSERT(!cancel_action_in_flight_);
+  if (hot_entry_) {
+    return post([this, cb = std::move(cb), range]() mutable {
+      const absl::string_view body = hot_entry_->body().substr(range.begin(), range.length());
+      std::move(cb)(std::make_unique<Buffer::OwnedImpl>(body),
+                    /* end_stream = */ range.end() == header_block_.bodySize() &&
+                        header_block_.trailerSize() == 0);
+    });
+  }
   ASSERT(file_handle_);
   auto queued = file_handle_->read(
       dispatcher(), header_block_.offsetToBody() + range.begin(), range.length(),
@@ -161,6 +217,14 @@ void FileLookupContext::getTrailers(LookupTrailersCallback&& cb) {
   ASSERT(dispatcher()->isThreadSafe());
   ASSERT(cb);
   ASSERT(!cancel_action_in_flight_);
+  if (hot_entry_) {
+    return post([this, cb = std::move(cb)]() mutable {
+      CacheFileTrailer trailer;
+      const absl::string_view trailers = hot_entry_->trailers();
+      trailer.ParseFromArray(trailers.data(), trailers.size());
+      std::move(cb)(trailersFromTrailerProto(trailer));
+    });
+  }
   ASSERT(file_handle_);
   auto queued = file_handle_->read(
       dispatcher(), header_block_.offsetToTrailers(), header_block_.trailerSize(),
@@ -182,6 +246,18 @@ void FileLookupContext::getTrailers(LookupTrailersCallback&& cb) {
   cancel_action_in_flight_ = std::move(queued.value());
 }
 
+void FileLookupContext::post(absl::AnyInvocable<void()> callback) {
+  auto cancelled = std::make_shared<bool>(false);
+  dispatcher_.post([this, cancelled, callback = std::move(callback)]() mutable {
+    if (*cancelled) {
+      return;
+    }
+    cancel_action_in_flight_ = nullptr;
+    std::move(callback)();
+  });
+  cancel_action_in_flight_ = [cancelled]() { *cancelled = true; };
+}
+
 void FileLookupContext::onDestroy() {
   if (cancel_action_in_flight_) {
     std::move(cancel_action_in_flight_)();
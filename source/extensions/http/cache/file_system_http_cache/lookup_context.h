@@ -5,6 +5,8 @@
 #include "source/extensions/common/async_files/async_file_handle.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
 #include "source/extensions/http/cache/file_system_http_cache/cache_file_fixed_block.h"
+#include "source/extensions/http/cache/file_system_http_cache/cache_file_header.pb.h"
+#include "source/extensions/http/cache/file_system_http_cache/hot_tier.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -43,8 +45,16 @@ private:
   void doCacheEntryInvalid();
   void getHeaderBlockFromFile();
   void getHeadersFromFile();
+  // Reads the headers, body and trailers of a small enough entry at once, so that the entry can
+  // be offered to the hot tier and its body and trailers served without further reads.
+  void getEntryFromFile();
+  void onHeaders(const CacheFileHeader& header_proto);
   void closeFileAndGetHeadersAgainWithNewVaryKey();
 
+  // Calls back with contents held in memory from the dispatcher, as reads from the file do,
+  // unless the lookup is destroyed first.
+  void post(absl::AnyInvocable<void()> callback);
+
   // In the event that the cache failed to retrieve, remove the cache entry from the
   // cache so we don't keep repeating the same failure.
   void invalidateCacheEntry();
@@ -60,6 +70,11 @@ private:
   AsyncFileHandle file_handle_;
   CancelFunction cancel_action_in_flight_;
   CacheFileFixedBlock header_block_;
+  // Set if the contents of the entry are held in memory, either by the hot tier or because the
+  // whole entry was read from the file at once.
+  HotTierEntrySharedPtr hot_entry_;
+  // The hot tier generation at the time of the lookup, for offering what the file contained.
+  uint64_t hot_tier_generation_ = 0;
   Key key_;
 
   LookupHeadersCallback lookup_headers_callback_;
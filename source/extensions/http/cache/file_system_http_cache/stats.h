@@ -25,6 +25,11 @@ namespace FileSystemHttpCache {
 
 #define ALL_CACHE_STATS(COUNTER, GAUGE, HISTOGRAM, TEXT_READOUT, STATNAME)                         \
   COUNTER(eviction_runs)                                                                           \
+  COUNTER(hot_tier_evictions)                                                                      \
+  COUNTER(hot_tier_hits)                                                                           \
+  COUNTER(hot_tier_promotions)                                                                     \
+  GAUGE(hot_tier_size_bytes, NeverImport)                                                          \
+  GAUGE(hot_tier_size_count, NeverImport)                                                          \
   GAUGE(size_bytes, NeverImport)                                                                   \
   GAUGE(size_count, NeverImport)                                                                   \
   GAUGE(size_limit_bytes, NeverImport)                                                             \
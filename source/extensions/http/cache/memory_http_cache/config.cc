@@ -0,0 +1,80 @@
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/http/cache/memory_http_cache/v3/memory_http_cache.pb.h"
+#include "envoy/extensions/http/cache/memory_http_cache/v3/memory_http_cache.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/http/cache/memory_http_cache/memory_http_cache.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+/**
+ * A singleton that acts as a factory for generating and looking up MemoryHttpCaches. Equivalent
+ * configs share the same cache, and different configs get different caches.
+ */
+class CacheSingleton : public Envoy::Singleton::Instance {
+public:
+  std::shared_ptr<MemoryHttpCache> get(const MemoryHttpCacheConfig& config, Stats::Scope& scope) {
+    absl::MutexLock lock(&mu_);
+    std::weak_ptr<MemoryHttpCache>& weak_cache = caches_[config];
+    std::shared_ptr<MemoryHttpCache> cache = weak_cache.lock();
+    if (cache == nullptr) {
+      cache = std::make_shared<MemoryHttpCache>(config, scope);
+      weak_cache = cache;
+    }
+    return cache;
+  }
+
+private:
+  absl::Mutex mu_;
+  // We keep weak_ptr here so the caches are destroyed, and their memory released, once no filter
+  // configuration uses them.
+  absl::flat_hash_map<MemoryHttpCacheConfig, std::weak_ptr<MemoryHttpCache>, MessageUtil,
+                      MessageUtil>
+      caches_ ABSL_GUARDED_BY(mu_);
+};
+
+SINGLETON_MANAGER_REGISTRATION(memory_http_cache_singleton);
+
+class MemoryHttpCacheFactory : public HttpCacheFactory {
+public:
+  // From UntypedFactory
+  std::string name() const override { return "envoy.extensions.http.cache.memory"; }
+  // From TypedFactory
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<MemoryHttpCacheConfig>();
+  }
+  // From HttpCacheFactory
+  std::shared_ptr<HttpCache>
+  getCache(const envoy::extensions::filters::http::cache::v3::CacheConfig& filter_config,
+           Server::Configuration::FactoryContext& context) override {
+    MemoryHttpCacheConfig config;
+    THROW_IF_NOT_OK(MessageUtil::unpackTo(filter_config.typed_config(), config));
+    MessageUtil::validate(config, context.messageValidationVisitor());
+    std::shared_ptr<CacheSingleton> caches =
+        context.serverFactoryContext().singletonManager().getTyped<CacheSingleton>(
+            SINGLETON_MANAGER_REGISTERED_NAME(memory_http_cache_singleton),
+            [] { return std::make_shared<CacheSingleton>(); });
+    // The cache outlives the listener which first configures it, so its stats are not scoped to
+    // the listener.
+    return caches->get(config, context.serverFactoryContext().scope());
+  }
+};
+
+static Registry::RegisterFactory<MemoryHttpCacheFactory, HttpCacheFactory> register_;
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
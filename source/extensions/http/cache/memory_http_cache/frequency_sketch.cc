@@ -0,0 +1,86 @@
+#include "source/extensions/http/cache/memory_http_cache/frequency_sketch.h"
+
+#include <algorithm>
+
+#include "absl/numeric/bits.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+namespace {
+
+constexpr uint64_t Seeds[] = {0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL,
+                              0xcbf29ce484222325ULL};
+// The lowest bit of each 4 bit counter.
+constexpr uint64_t OneMask = 0x1111111111111111ULL;
+// All but the highest bit of each 4 bit counter, to halve the counters after shifting them.
+constexpr uint64_t ResetMask = 0x7777777777777777ULL;
+// Bounds the table to 64MiB.
+constexpr uint32_t MaxTableSize = 1 << 23;
+
+} // namespace
+
+FrequencySketch::FrequencySketch(uint32_t max_items) {
+  const uint32_t items = std::clamp<uint32_t>(max_items, 16, MaxTableSize);
+  const uint32_t table_size = absl::bit_ceil(items);
+  table_.resize(table_size);
+  table_mask_ = table_size - 1;
+  sample_size_ = 10 * items;
+}
+
+uint32_t FrequencySketch::indexOf(uint64_t hash, uint32_t row) const {
+  uint64_t h = (hash + Seeds[row]) * Seeds[row];
+  h += h >> 32;
+  return static_cast<uint32_t>(h) & table_mask_;
+}
+
+bool FrequencySketch::incrementAt(uint32_t index, uint32_t counter) {
+  const uint32_t offset = counter << 2;
+  const uint64_t mask = uint64_t(0xf) << offset;
+  if ((table_[index] & mask) != mask) {
+    table_[index] += uint64_t(1) << offset;
+    return true;
+  }
+  return false;
+}
+
+void FrequencySketch::increment(uint64_t hash) {
+  // Each row uses a different group of four of the sixteen counters of a word.
+  const uint32_t start = (hash & 3) << 2;
+  bool added = false;
+  for (uint32_t row = 0; row < 4; ++row) {
+    added |= incrementAt(indexOf(hash, row), start + row);
+  }
+  if (added && ++size_ >= sample_size_) {
+    reset();
+  }
+}
+
+uint32_t FrequencySketch::frequency(uint64_t hash) const {
+  const uint32_t start = (hash & 3) << 2;
+  uint32_t frequency = 15;
+  for (uint32_t row = 0; row < 4; ++row) {
+    const uint32_t offset = (start + row) << 2;
+    frequency = std::min<uint32_t>(frequency, (table_[indexOf(hash, row)] >> offset) & 0xf);
+  }
+  return frequency;
+}
+
+// Halves all of the counters. The counters which were odd lose half an occurrence each, which is
+// accounted for in the size, so that the next reset happens after a full sample again.
+void FrequencySketch::reset() {
+  uint32_t odd_counters = 0;
+  for (uint64_t& word : table_) {
+    odd_counters += absl::popcount(word & OneMask);
+    word = (word >> 1) & ResetMask;
+  }
+  const uint32_t lost = odd_counters >> 2;
+  size_ = size_ > lost ? (size_ - lost) >> 1 : 0;
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
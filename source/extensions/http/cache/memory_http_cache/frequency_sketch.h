@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * An estimate of how often each of a set of items has been seen recently, used by TinyLFU
+ * admission policies to decide whether a new item is worth the items it would displace.
+ *
+ * This is a count-min sketch of four rows of 4 bit counters, which saturate at 15, packed sixteen
+ * to a 64 bit word. Once the number of increments reaches ten times the number of items the
+ * sketch is sized for, all of the counters are halved, so that the estimates favor recent
+ * popularity over historic popularity.
+ *
+ * The sketch is not thread safe.
+ */
+class FrequencySketch {
+public:
+  /**
+   * @param max_items the number of distinct items that the sketch should estimate well.
+   */
+  explicit FrequencySketch(uint32_t max_items);
+
+  /**
+   * Records an occurrence of an item.
+   * @param hash a well distributed hash of the item.
+   */
+  void increment(uint64_t hash);
+
+  /**
+   * @param hash a well distributed hash of the item.
+   * @return the estimated number of occurrences of the item, from 0 to 15.
+   */
+  uint32_t frequency(uint64_t hash) const;
+
+  /**
+   * @return the number of increments after which the counters are halved.
+   */
+  uint32_t sampleSize() const { return sample_size_; }
+
+private:
+  // The index in table_ of the word holding the counter of an item in a row.
+  uint32_t indexOf(uint64_t hash, uint32_t row) const;
+  // Increments the counter at a position of a word, unless it is saturated.
+  bool incrementAt(uint32_t index, uint32_t counter);
+  void reset();
+
+  std::vector<uint64_t> table_;
+  uint32_t table_mask_;
+  uint32_t sample_size_;
+  uint32_t size_{};
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
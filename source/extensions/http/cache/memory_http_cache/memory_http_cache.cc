@@ -0,0 +1,496 @@
+#include "source/extensions/http/cache/memory_http_cache/memory_http_cache.h"
+
+#include <algorithm>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/http/cache/cache_custom_headers.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+// The assumed average size of a cached response, which the frequency sketches are sized by.
+constexpr uint64_t EstimatedEntrySize = 4096;
+
+MemoryHttpCacheStats generateStats(const MemoryHttpCacheConfig& config, Stats::Scope& scope) {
+  const std::string prefix = config.stat_prefix().empty()
+                                 ? "http_cache.memory"
+                                 : absl::StrCat("http_cache.memory.", config.stat_prefix());
+  return {ALL_MEMORY_HTTP_CACHE_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                      POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
+// Returns the key of the response varied on the request headers named by vary_values, or nullopt
+// if the vary headers are not compatible with the allow list.
+absl::optional<Key> variedRequestKey(const Key& key, const VaryAllowList& vary_allow_list,
+                                     const Http::RequestHeaderMap& request_headers,
+                                     const absl::btree_set<absl::string_view>& vary_values) {
+  ASSERT(!vary_values.empty());
+  const absl::optional<std::string> vary_identifier =
+      VaryHeaderUtils::createVaryIdentifier(vary_allow_list, vary_values, request_headers);
+  if (!vary_identifier.has_value()) {
+    return absl::nullopt;
+  }
+  Key varied_request_key = key;
+  varied_request_key.add_custom_fields(vary_identifier.value());
+  return varied_request_key;
+}
+
+// Looks up the response of a request, following the vary entry of the key of the request to the
+// response varied on the headers of the request, if the key has one.
+CachedResponseConstSharedPtr lookupRequest(MemoryHttpCache& cache, const LookupRequest& request) {
+  CachedResponseConstSharedPtr response = cache.lookup(request.key());
+  if (response == nullptr || response->vary_values_.empty()) {
+    return response;
+  }
+  const absl::optional<Key> varied_key =
+      variedRequestKey(request.key(), request.varyAllowList(), request.requestHeaders(),
+                       response->vary_values_);
+  return varied_key.has_value() ? cache.lookup(varied_key.value()) : nullptr;
+}
+
+class MemoryLookupContext : public LookupContext {
+public:
+  MemoryLookupContext(Event::Dispatcher& dispatcher, MemoryHttpCache& cache,
+                      LookupRequest&& request)
+      : dispatcher_(dispatcher), cache_(cache), request_(std::move(request)) {}
+
+  void getHeaders(LookupHeadersCallback&& cb) override {
+    response_ = lookupRequest(cache_, request_);
+    LookupResult result;
+    bool end_stream = true;
+    if (response_ != nullptr) {
+      cache_.stats().lookup_hit_.inc();
+      result = request_.makeLookupResult(
+          Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*response_->response_headers_),
+          ResponseMetadata(response_->metadata_), response_->body_->size());
+      end_stream = response_->body_->empty() && response_->trailers_ == nullptr;
+    } else {
+      cache_.stats().lookup_miss_.inc();
+    }
+    dispatcher_.post([result = std::move(result), cb = std::move(cb), end_stream,
+                      cancelled = cancelled_]() mutable {
+      if (!*cancelled) {
+        std::move(cb)(std::move(result), end_stream);
+      }
+    });
+  }
+
+  // Serves the body from the cached response, without copying it: the buffer references the
+  // cached body, which it keeps alive until the buffer is drained, even if the response is evicted.
+  void getBody(const AdjustedByteRange& range, LookupBodyCallback&& cb) override {
+    ASSERT(response_ != nullptr);
+    const std::shared_ptr<const std::string>& body = response_->body_;
+    ASSERT(range.end() <= body->length(), "Attempt to read past end of body.");
+    auto result = std::make_unique<Buffer::OwnedImpl>();
+    if (range.length() > 0) {
+      auto* fragment = new Buffer::BufferFragmentImpl(
+          body->data() + range.begin(), range.length(),
+          [body](const void*, size_t, const Buffer::BufferFragmentImpl* this_fragment) {
+            delete this_fragment;
+          });
+      result->addBufferFragment(*fragment);
+    }
+    const bool end_stream = response_->trailers_ == nullptr && range.end() == body->length();
+    dispatcher_.post([result = std::move(result), cb = std::move(cb), end_stream,
+                      cancelled = cancelled_]() mutable {
+      if (!*cancelled) {
+        std::move(cb)(std::move(result), end_stream);
+      }
+    });
+  }
+
+  void getTrailers(LookupTrailersCallback&& cb) override {
+    ASSERT(response_ != nullptr && response_->trailers_ != nullptr);
+    dispatcher_.post([cb = std::move(cb),
+                      trailers = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(
+                          *response_->trailers_),
+                      cancelled = cancelled_]() mutable {
+      if (!*cancelled) {
+        std::move(cb)(std::move(trailers));
+      }
+    });
+  }
+
+  const LookupRequest& request() const { return request_; }
+  void onDestroy() override { *cancelled_ = true; }
+  Event::Dispatcher& dispatcher() const { return dispatcher_; }
+
+private:
+  Event::Dispatcher& dispatcher_;
+  std::shared_ptr<bool> cancelled_ = std::make_shared<bool>(false);
+  MemoryHttpCache& cache_;
+  const LookupRequest request_;
+  CachedResponseConstSharedPtr response_;
+};
+
+class MemoryInsertContext : public InsertContext {
+public:
+  MemoryInsertContext(MemoryLookupContext& lookup_context, MemoryHttpCache& cache)
+      : dispatcher_(lookup_context.dispatcher()), key_(lookup_context.request().key()),
+        request_headers_(lookup_context.request().requestHeaders()),
+        vary_allow_list_(lookup_context.request().varyAllowList()), cache_(cache) {}
+
+  void post(InsertCallback cb, bool result) {
+    dispatcher_.post([cb = std::move(cb), result = result, cancelled = cancelled_]() mutable {
+      if (!*cancelled) {
+        std::move(cb)(result);
+      }
+    });
+  }
+
+  void insertHeaders(const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata, InsertCallback insert_success,
+                     bool end_stream) override {
+    ASSERT(!committed_);
+    response_->response_headers_ =
+        Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers);
+    response_->metadata_ = metadata;
+    if (end_stream) {
+      post(std::move(insert_success), commit());
+    } else {
+      post(std::move(insert_success), true);
+    }
+  }
+
+  void insertBody(const Buffer::Instance& chunk, InsertCallback ready_for_next_chunk,
+                  bool end_stream) override {
+    ASSERT(!committed_);
+    ASSERT(ready_for_next_chunk || end_stream);
+
+    body_.add(chunk);
+    if (body_.length() > cache_.maxEntrySize()) {
+      // Stops buffering a response which could not be cached anyway.
+      cache_.stats().insert_too_large_.inc();
+      committed_ = true;
+      post(std::move(ready_for_next_chunk), false);
+      return;
+    }
+    if (end_stream) {
+      post(std::move(ready_for_next_chunk), commit());
+    } else {
+      post(std::move(ready_for_next_chunk), true);
+    }
+  }
+
+  void insertTrailers(const Http::ResponseTrailerMap& trailers,
+                      InsertCallback insert_complete) override {
+    ASSERT(!committed_);
+    response_->trailers_ = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(trailers);
+    post(std::move(insert_complete), commit());
+  }
+
+  void onDestroy() override { *cancelled_ = true; }
+
+private:
+  bool commit() {
+    committed_ = true;
+    response_->body_ = std::make_shared<const std::string>(body_.toString());
+    body_.drain(body_.length());
+    response_->vary_values_ = VaryHeaderUtils::getVaryValues(*response_->response_headers_);
+    if (response_->vary_values_.empty()) {
+      return cache_.insert(key_, std::move(response_));
+    }
+
+    const absl::optional<Key> varied_key =
+        variedRequestKey(key_, vary_allow_list_, request_headers_, response_->vary_values_);
+    if (!varied_key.has_value()) {
+      // Skip the insert if we are unable to create a vary key.
+      return false;
+    }
+    // The key of the request gets an entry which only holds the vary header, to flag that the
+    // responses to it are varied.
+    CachedResponseConstSharedPtr vary_entry = cache_.lookup(key_);
+    if (vary_entry == nullptr || vary_entry->vary_values_ != response_->vary_values_) {
+      auto new_vary_entry = std::make_shared<CachedResponse>();
+      new_vary_entry->response_headers_ =
+          Http::createHeaderMap<Http::ResponseHeaderMapImpl>({});
+      new_vary_entry->response_headers_->setCopy(Http::CustomHeaders::get().Vary,
+                                                 absl::StrJoin(response_->vary_values_, ","));
+      new_vary_entry->body_ = std::make_shared<const std::string>();
+      new_vary_entry->vary_values_ =
+          VaryHeaderUtils::getVaryValues(*new_vary_entry->response_headers_);
+      cache_.insert(key_, std::move(new_vary_entry));
+    }
+    return cache_.insert(varied_key.value(), std::move(response_));
+  }
+
+  Event::Dispatcher& dispatcher_;
+  std::shared_ptr<bool> cancelled_ = std::make_shared<bool>(false);
+  Key key_;
+  const Http::RequestHeaderMap& request_headers_;
+  const VaryAllowList& vary_allow_list_;
+  MemoryHttpCache& cache_;
+  std::shared_ptr<CachedResponse> response_ = std::make_shared<CachedResponse>();
+  Buffer::OwnedImpl body_;
+  bool committed_ = false;
+};
+
+} // namespace
+
+MemoryHttpCache::Shard::Shard(uint64_t capacity, MemoryHttpCacheStats& stats)
+    : window_capacity_(std::max<uint64_t>(capacity / 100, 1)),
+      main_capacity_(capacity - window_capacity_), protected_capacity_(main_capacity_ / 5 * 4),
+      stats_(stats),
+      sketch_(static_cast<uint32_t>(
+          std::min<uint64_t>(capacity / EstimatedEntrySize, UINT32_MAX))) {}
+
+MemoryHttpCache::EntryList& MemoryHttpCache::Shard::list(Segment segment) {
+  switch (segment) {
+  case Segment::Window:
+    return window_;
+  case Segment::Probation:
+    return probation_;
+  case Segment::Protected:
+    return protected_;
+  }
+  PANIC_DUE_TO_CORRUPT_ENUM;
+}
+
+uint64_t& MemoryHttpCache::Shard::bytes(Segment segment) {
+  switch (segment) {
+  case Segment::Window:
+    return window_bytes_;
+  case Segment::Probation:
+    return probation_bytes_;
+  case Segment::Protected:
+    return protected_bytes_;
+  }
+  PANIC_DUE_TO_CORRUPT_ENUM;
+}
+
+// Moves an entry to the most recently used end of a segment.
+void MemoryHttpCache::Shard::move(EntryList::iterator entry, Segment segment) {
+  bytes(entry->segment_) -= entry->size_;
+  bytes(segment) += entry->size_;
+  list(segment).splice(list(segment).begin(), list(entry->segment_), entry);
+  entry->segment_ = segment;
+}
+
+void MemoryHttpCache::Shard::onAccess(EntryList::iterator entry) {
+  switch (entry->segment_) {
+  case Segment::Window:
+  case Segment::Protected:
+    move(entry, entry->segment_);
+    return;
+  case Segment::Probation:
+    move(entry, Segment::Protected);
+    while (protected_bytes_ > protected_capacity_) {
+      move(std::prev(protected_.end()), Segment::Probation);
+    }
+    return;
+  }
+}
+
+void MemoryHttpCache::Shard::evictFromWindow() {
+  while (window_bytes_ > window_capacity_) {
+    const EntryList::iterator candidate = std::prev(window_.end());
+    move(candidate, Segment::Probation);
+    admit(candidate);
+  }
+}
+
+// Keeps a candidate from the window in the main space only if it is requested more often than each
+// of the entries which have to be evicted to make room for it. Those are the least recently used
+// entries of probation, and then of the protected segment.
+void MemoryHttpCache::Shard::admit(EntryList::iterator candidate) {
+  const uint32_t candidate_frequency = sketch_.frequency(candidate->hash_);
+  while (probation_bytes_ + protected_bytes_ > main_capacity_) {
+    EntryList::iterator victim = std::prev(probation_.end());
+    if (victim == candidate && !protected_.empty()) {
+      victim = std::prev(protected_.end());
+    }
+    if (victim == candidate || sketch_.frequency(victim->hash_) >= candidate_frequency) {
+      remove(candidate, true);
+      return;
+    }
+    remove(victim, true);
+  }
+}
+
+void MemoryHttpCache::Shard::evictFromMain() {
+  while (probation_bytes_ + protected_bytes_ > main_capacity_) {
+    remove(std::prev(probation_.empty() ? protected_.end() : probation_.end()), true);
+  }
+}
+
+void MemoryHttpCache::Shard::remove(EntryList::iterator entry, bool evicted) {
+  stats_.size_bytes_.sub(entry->size_);
+  stats_.size_count_.dec();
+  if (evicted) {
+    stats_.eviction_.inc();
+    stats_.eviction_bytes_.add(entry->size_);
+  }
+  bytes(entry->segment_) -= entry->size_;
+  entries_.erase(entry->hash_);
+  list(entry->segment_).erase(entry);
+}
+
+CachedResponseConstSharedPtr MemoryHttpCache::Shard::lookup(const Key& key, uint64_t hash) {
+  absl::MutexLock lock(&mutex_);
+  sketch_.increment(hash);
+  const auto it = entries_.find(hash);
+  if (it == entries_.end() || !MessageUtil()(it->second->key_, key)) {
+    return nullptr;
+  }
+  onAccess(it->second);
+  return it->second->response_;
+}
+
+void MemoryHttpCache::Shard::insert(const Key& key, uint64_t hash, uint64_t size,
+                                    CachedResponseConstSharedPtr response) {
+  absl::MutexLock lock(&mutex_);
+  sketch_.increment(hash);
+  const auto it = entries_.find(hash);
+  if (it != entries_.end()) {
+    remove(it->second, false);
+  }
+  window_.push_front(Entry{key, hash, size, Segment::Window, std::move(response)});
+  window_bytes_ += size;
+  entries_.emplace(hash, window_.begin());
+  stats_.size_bytes_.add(size);
+  stats_.size_count_.inc();
+  evictFromWindow();
+}
+
+bool MemoryHttpCache::Shard::replace(const Key& key, uint64_t hash, uint64_t size,
+                                     const CachedResponse& expected,
+                                     CachedResponseConstSharedPtr response) {
+  absl::MutexLock lock(&mutex_);
+  const auto it = entries_.find(hash);
+  if (it == entries_.end() || it->second->response_.get() != &expected ||
+      !MessageUtil()(it->second->key_, key)) {
+    return false;
+  }
+  Entry& entry = *it->second;
+  stats_.size_bytes_.add(size);
+  stats_.size_bytes_.sub(entry.size_);
+  bytes(entry.segment_) += size;
+  bytes(entry.segment_) -= entry.size_;
+  entry.size_ = size;
+  entry.response_ = std::move(response);
+  evictFromWindow();
+  evictFromMain();
+  return true;
+}
+
+MemoryHttpCache::MemoryHttpCache(const MemoryHttpCacheConfig& config, Stats::Scope& scope)
+    : config_(config), stats_(generateStats(config, scope)) {
+  const uint32_t shard_count =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, shard_count, DefaultShardCount);
+  const uint64_t shard_capacity =
+      std::max<uint64_t>(config.max_cache_size_bytes() / shard_count, 1);
+  shards_.reserve(shard_count);
+  for (uint32_t i = 0; i < shard_count; ++i) {
+    shards_.push_back(std::make_unique<Shard>(shard_capacity, stats_));
+  }
+  max_entry_size_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_individual_cache_entry_size_bytes,
+                                                    UINT64_MAX);
+  max_entry_size_ = std::min(max_entry_size_, shards_.front()->mainCapacity());
+  stats_.size_limit_bytes_.set(config.max_cache_size_bytes());
+}
+
+uint64_t MemoryHttpCache::entrySize(const Key& key, const CachedResponse& response) {
+  return key.ByteSizeLong() + response.response_headers_->byteSize() + response.body_->size() +
+         (response.trailers_ != nullptr ? response.trailers_->byteSize() : 0);
+}
+
+CachedResponseConstSharedPtr MemoryHttpCache::lookup(const Key& key) {
+  const uint64_t hash = stableHashKey(key);
+  return shard(hash).lookup(key, hash);
+}
+
+bool MemoryHttpCache::insert(const Key& key, CachedResponseConstSharedPtr response) {
+  const uint64_t size = entrySize(key, *response);
+  if (size > max_entry_size_) {
+    stats_.insert_too_large_.inc();
+    return false;
+  }
+  stats_.insert_.inc();
+  const uint64_t hash = stableHashKey(key);
+  shard(hash).insert(key, hash, size, std::move(response));
+  return true;
+}
+
+bool MemoryHttpCache::replace(const Key& key, const CachedResponse& expected,
+                              CachedResponseConstSharedPtr response) {
+  const uint64_t size = entrySize(key, *response);
+  if (size > max_entry_size_) {
+    return false;
+  }
+  const uint64_t hash = stableHashKey(key);
+  return shard(hash).replace(key, hash, size, expected, std::move(response));
+}
+
+LookupContextPtr MemoryHttpCache::makeLookupContext(LookupRequest&& request,
+                                                    Http::StreamFilterCallbacks& callbacks) {
+  return std::make_unique<MemoryLookupContext>(callbacks.dispatcher(), *this, std::move(request));
+}
+
+InsertContextPtr MemoryHttpCache::makeInsertContext(LookupContextPtr&& lookup_context,
+                                                    Http::StreamFilterCallbacks&) {
+  ASSERT(lookup_context != nullptr);
+  auto ret = std::make_unique<MemoryInsertContext>(
+      dynamic_cast<MemoryLookupContext&>(*lookup_context), *this);
+  lookup_context->onDestroy();
+  return ret;
+}
+
+// Replaces the cached response with one which has the updated headers, and shares the body of the
+// cached response.
+void MemoryHttpCache::updateHeaders(const LookupContext& lookup_context,
+                                    const Http::ResponseHeaderMap& response_headers,
+                                    const ResponseMetadata& metadata,
+                                    UpdateHeadersCallback on_complete) {
+  const auto& memory_lookup_context = static_cast<const MemoryLookupContext&>(lookup_context);
+  const LookupRequest& request = memory_lookup_context.request();
+  bool updated = false;
+  CachedResponseConstSharedPtr response = lookup(request.key());
+  absl::optional<Key> varied_key;
+  if (response != nullptr && !response->vary_values_.empty()) {
+    varied_key = variedRequestKey(request.key(), request.varyAllowList(), request.requestHeaders(),
+                                  response->vary_values_);
+    response = varied_key.has_value() ? lookup(varied_key.value()) : nullptr;
+  }
+  if (response != nullptr) {
+    auto updated_response = std::make_shared<CachedResponse>();
+    updated_response->response_headers_ =
+        Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*response->response_headers_);
+    applyHeaderUpdate(response_headers, *updated_response->response_headers_);
+    updated_response->metadata_ = metadata;
+    updated_response->body_ = response->body_;
+    if (response->trailers_ != nullptr) {
+      updated_response->trailers_ =
+          Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*response->trailers_);
+    }
+    updated_response->vary_values_ =
+        VaryHeaderUtils::getVaryValues(*updated_response->response_headers_);
+    updated = replace(varied_key.has_value() ? varied_key.value() : request.key(), *response,
+                      std::move(updated_response));
+  }
+  memory_lookup_context.dispatcher().post(
+      [on_complete = std::move(on_complete), updated]() mutable {
+        std::move(on_complete)(updated);
+      });
+}
+
+constexpr absl::string_view Name = "envoy.extensions.http.cache.memory";
+
+CacheInfo MemoryHttpCache::cacheInfo() const {
+  CacheInfo cache_info;
+  cache_info.name_ = Name;
+  cache_info.max_entry_size_bytes_ = max_entry_size_;
+  return cache_info;
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/http/cache/memory_http_cache/v3/memory_http_cache.pb.h"
+#include "envoy/stats/scope.h"
+
+#include "source/common/common/logger.h"
+#include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/http/cache/memory_http_cache/frequency_sketch.h"
+#include "source/extensions/http/cache/memory_http_cache/stats.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/btree_set.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+using MemoryHttpCacheConfig =
+    envoy::extensions::http::cache::memory_http_cache::v3::MemoryHttpCacheConfig;
+
+/**
+ * A response held by the cache. It is never modified once it is cached, so that the lookups of
+ * all workers can share it without holding a lock; an update of its headers replaces it.
+ */
+struct CachedResponse {
+  Http::ResponseHeaderMapPtr response_headers_;
+  ResponseMetadata metadata_;
+  // Shared with the buffers the body is being served in, and with the responses which replace
+  // this one when its headers are updated.
+  std::shared_ptr<const std::string> body_;
+  Http::ResponseTrailerMapPtr trailers_;
+  // The header names in the vary header of the response, pointing into response_headers_.
+  absl::btree_set<absl::string_view> vary_values_;
+};
+using CachedResponseConstSharedPtr = std::shared_ptr<const CachedResponse>;
+
+/**
+ * A cache which holds responses in memory, up to a maximum number of bytes. The cache is divided
+ * into shards by the hash of the key, each with its own lock and share of the capacity, which
+ * evict with the W-TinyLFU policy:
+ * - New entries enter a window which is 1% of the shard, and is evicted in LRU order.
+ * - An entry evicted from the window is admitted to the main space of the shard if it has been
+ *   requested more often than the entries it would displace, as estimated by a FrequencySketch.
+ * - The main space is a segmented LRU: entries are admitted to its probation segment, move to its
+ *   protected segment, which is 80% of the main space, when they are requested again, and move
+ *   back to probation when they are the least recently used entries of a full protected segment.
+ */
+class MemoryHttpCache : public HttpCache, public Logger::Loggable<Logger::Id::cache_filter> {
+public:
+  MemoryHttpCache(const MemoryHttpCacheConfig& config, Stats::Scope& scope);
+
+  // HttpCache
+  LookupContextPtr makeLookupContext(LookupRequest&& request,
+                                     Http::StreamFilterCallbacks& callbacks) override;
+  InsertContextPtr makeInsertContext(LookupContextPtr&& lookup_context,
+                                     Http::StreamFilterCallbacks& callbacks) override;
+  void updateHeaders(const LookupContext& lookup_context,
+                     const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata, UpdateHeadersCallback on_complete) override;
+  CacheInfo cacheInfo() const override;
+
+  /**
+   * Looks up the response of a key, which counts as a use of the response by the eviction policy.
+   * @return the response, or nullptr if none is cached.
+   */
+  CachedResponseConstSharedPtr lookup(const Key& key);
+
+  /**
+   * Caches a response, replacing any response of the key. The response may be evicted right away
+   * if it is requested less often than the responses it would displace.
+   * @return false if the response is too large to be cached.
+   */
+  bool insert(const Key& key, CachedResponseConstSharedPtr response);
+
+  /**
+   * Replaces the cached response of a key, if it still is the expected response.
+   * @return whether the response was replaced.
+   */
+  bool replace(const Key& key, const CachedResponse& expected,
+               CachedResponseConstSharedPtr response);
+
+  /**
+   * @return the size of the largest response which can be cached.
+   */
+  uint64_t maxEntrySize() const { return max_entry_size_; }
+  const MemoryHttpCacheConfig& config() const { return config_; }
+  MemoryHttpCacheStats& stats() { return stats_; }
+
+  static constexpr uint32_t DefaultShardCount = 16;
+
+private:
+  enum class Segment : uint8_t { Window, Probation, Protected };
+
+  struct Entry {
+    Key key_;
+    uint64_t hash_;
+    uint64_t size_;
+    Segment segment_;
+    CachedResponseConstSharedPtr response_;
+  };
+  // Entries move between the lists of the segments by splicing, which keeps their iterators valid.
+  using EntryList = std::list<Entry>;
+
+  class Shard {
+  public:
+    Shard(uint64_t capacity, MemoryHttpCacheStats& stats);
+
+    CachedResponseConstSharedPtr lookup(const Key& key, uint64_t hash);
+    void insert(const Key& key, uint64_t hash, uint64_t size,
+                CachedResponseConstSharedPtr response);
+    bool replace(const Key& key, uint64_t hash, uint64_t size, const CachedResponse& expected,
+                 CachedResponseConstSharedPtr response);
+    uint64_t mainCapacity() const { return main_capacity_; }
+
+  private:
+    EntryList& list(Segment segment) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+    uint64_t& bytes(Segment segment) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+    void move(EntryList::iterator entry, Segment segment) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+    void onAccess(EntryList::iterator entry) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+    void evictFromWindow() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+    void admit(EntryList::iterator candidate) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+    void evictFromMain() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+    void remove(EntryList::iterator entry, bool evicted) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+    const uint64_t window_capacity_;
+    const uint64_t main_capacity_;
+    const uint64_t protected_capacity_;
+    MemoryHttpCacheStats& stats_;
+
+    absl::Mutex mutex_;
+    // Keyed by the hash of the cache key. Of two keys with the same hash, only the last inserted
+    // one is cached.
+    absl::flat_hash_map<uint64_t, EntryList::iterator> entries_ ABSL_GUARDED_BY(mutex_);
+    EntryList window_ ABSL_GUARDED_BY(mutex_);
+    EntryList probation_ ABSL_GUARDED_BY(mutex_);
+    EntryList protected_ ABSL_GUARDED_BY(mutex_);
+    uint64_t window_bytes_ ABSL_GUARDED_BY(mutex_){};
+    uint64_t probation_bytes_ ABSL_GUARDED_BY(mutex_){};
+    uint64_t protected_bytes_ ABSL_GUARDED_BY(mutex_){};
+    FrequencySketch sketch_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  static uint64_t entrySize(const Key& key, const CachedResponse& response);
+  // The shard is chosen by the high bits of the hash, as the sketch of the shard uses its low bits.
+  Shard& shard(uint64_t hash) { return *shards_[(hash >> 32) % shards_.size()]; }
+
+  const MemoryHttpCacheConfig config_;
+  MemoryHttpCacheStats stats_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  uint64_t max_entry_size_;
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
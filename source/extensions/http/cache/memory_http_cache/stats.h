@@ -0,0 +1,34 @@
+#pragma once
+
+#include "envoy/stats/stats_macros.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * All memory cache stats. @see stats_macros.h
+ *
+ * The hit ratio of the cache is lookup_hit / (lookup_hit + lookup_miss). Entries which are not
+ * admitted from the window of a shard into its main space are counted as evictions.
+ **/
+#define ALL_MEMORY_HTTP_CACHE_STATS(COUNTER, GAUGE)                                                \
+  COUNTER(eviction)                                                                                \
+  COUNTER(eviction_bytes)                                                                          \
+  COUNTER(insert)                                                                                  \
+  COUNTER(insert_too_large)                                                                        \
+  COUNTER(lookup_hit)                                                                              \
+  COUNTER(lookup_miss)                                                                             \
+  GAUGE(size_bytes, NeverImport)                                                                   \
+  GAUGE(size_count, NeverImport)                                                                   \
+  GAUGE(size_limit_bytes, NeverImport)
+
+struct MemoryHttpCacheStats {
+  ALL_MEMORY_HTTP_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -223,6 +223,11 @@ Api::IoCallUint64Result IoHandleImpl::sendmsg(const Buffer::RawSlice*, uint64_t,
   return Network::IoSocketError::ioResultSocketInvalidAddress();
 }
 
+Api::IoCallUint64Result IoHandleImpl::sendmmsg(const Buffer::RawSlice*, uint64_t, int,
+                                               const Network::Address::Instance&) {
+  return Network::IoSocketError::ioResultSocketInvalidAddress();
+}
+
 Api::IoCallUint64Result IoHandleImpl::recvmsg(Buffer::RawSlice*, const uint64_t, uint32_t,
                                               const Network::IoHandle::UdpSaveCmsgConfig&,
                                               RecvMsgOutput&) {
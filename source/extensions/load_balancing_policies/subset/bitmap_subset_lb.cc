@@ -0,0 +1,384 @@
+#include "source/extensions/load_balancing_policies/subset/bitmap_subset_lb.h"
+
+#include <algorithm>
+#include <map>
+
+#include "source/common/common/assert.h"
+#include "source/common/config/well_known_names.h"
+
+#include "absl/hash/hash.h"
+#include "absl/numeric/bits.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Upstream {
+
+void HostBitmap::set(uint32_t index) {
+  const uint32_t position = index / 64;
+  ASSERT(positions_.empty() || positions_.back() <= position);
+  if (positions_.empty() || positions_.back() != position) {
+    positions_.push_back(position);
+    words_.push_back(0);
+  }
+  words_.back() |= uint64_t(1) << (index % 64);
+}
+
+HostBitmap HostBitmap::intersect(const HostBitmap& a, const HostBitmap& b) {
+  HostBitmap result;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a.words_.size() && j < b.words_.size()) {
+    if (a.positions_[i] < b.positions_[j]) {
+      ++i;
+    } else if (a.positions_[i] > b.positions_[j]) {
+      ++j;
+    } else {
+      const uint64_t word = a.words_[i] & b.words_[j];
+      if (word != 0) {
+        result.positions_.push_back(a.positions_[i]);
+        result.words_.push_back(word);
+      }
+      ++i;
+      ++j;
+    }
+  }
+  return result;
+}
+
+uint32_t HostBitmap::count() const {
+  uint32_t count = 0;
+  for (const uint64_t word : words_) {
+    count += absl::popcount(word);
+  }
+  return count;
+}
+
+BitmapSubsetLoadBalancer::BitmapSubsetLoadBalancer(const SubsetLoadBalancerConfig& lb_config,
+                                                   const PrioritySet& priority_set,
+                                                   ClusterLbStats& stats,
+                                                   Random::RandomGenerator& random)
+    : priority_set_(priority_set), stats_(stats), random_(random),
+      subset_selectors_(lb_config.subsetInfo().subsetSelectors()),
+      fallback_policy_(lb_config.subsetInfo().fallbackPolicy()),
+      panic_mode_any_(lb_config.subsetInfo().panicModeAny()),
+      list_as_any_(lb_config.subsetInfo().listAsAny()),
+      allow_redundant_keys_(lb_config.subsetInfo().allowRedundantKeys()) {
+  ASSERT(lb_config.subsetInfo().isEnabled());
+  ASSERT(lb_config.subsetInfo().hostBitmapIndex());
+
+  for (const auto& selector : subset_selectors_) {
+    indexed_keys_.insert(selector->selectorKeys().begin(), selector->selectorKeys().end());
+  }
+  if (fallback_policy_ == envoy::config::cluster::v3::Cluster::LbSubsetConfig::DEFAULT_SUBSET) {
+    // Kept sorted by key, as the metadata match criteria of requests are.
+    std::map<std::string, ProtobufWkt::Value> fields(
+        lb_config.subsetInfo().defaultSubset().fields().begin(),
+        lb_config.subsetInfo().defaultSubset().fields().end());
+    for (const auto& [key, value] : fields) {
+      indexed_keys_.insert(key);
+      default_subset_.emplace_back(key, HashedValue(value));
+    }
+  }
+
+  for (const auto& host_set : priority_set_.hostSetsPerPriority()) {
+    indexHosts(host_set->priority());
+  }
+
+  priority_update_cb_ = priority_set_.addPriorityUpdateCb(
+      [this](uint32_t priority, const HostVector&, const HostVector&) {
+        indexHosts(priority);
+        clearSubsets();
+        return absl::OkStatus();
+      });
+}
+
+BitmapSubsetLoadBalancer::~BitmapSubsetLoadBalancer() { clearSubsets(); }
+
+// Rebuilds the bitmaps of a priority from its hosts. Both the membership and the health of the
+// hosts are captured, so this runs on every update of the priority.
+void BitmapSubsetLoadBalancer::indexHosts(uint32_t priority) {
+  const auto& host_sets = priority_set_.hostSetsPerPriority();
+  ASSERT(priority < host_sets.size());
+  if (priorities_.size() < host_sets.size()) {
+    priorities_.resize(host_sets.size());
+  }
+
+  PriorityIndex index;
+  index.hosts_ = host_sets[priority]->hostsPtr();
+  const HostVector& hosts = *index.hosts_;
+  for (uint32_t i = 0; i < hosts.size(); ++i) {
+    const Host& host = *hosts[i];
+    index.all_.set(i);
+    switch (host.coarseHealth()) {
+    case Host::Health::Healthy:
+      index.healthy_.set(i);
+      break;
+    case Host::Health::Degraded:
+      index.degraded_.set(i);
+      break;
+    case Host::Health::Unhealthy:
+      break;
+    }
+
+    if (host.metadata() == nullptr) {
+      continue;
+    }
+    const auto& filter_metadata = host.metadata()->filter_metadata();
+    const auto filter_it = filter_metadata.find(Config::MetadataFilters::get().ENVOY_LB);
+    if (filter_it == filter_metadata.end()) {
+      continue;
+    }
+    for (const auto& [key, value] : filter_it->second.fields()) {
+      if (!indexed_keys_.contains(key)) {
+        continue;
+      }
+      auto& values = index.values_[key];
+      if (list_as_any_ && value.kind_case() == ProtobufWkt::Value::kListValue) {
+        for (const auto& element : value.list_value().values()) {
+          values.try_emplace(HashedValue(element)).first->second.set(i);
+        }
+      } else {
+        values.try_emplace(HashedValue(value)).first->second.set(i);
+      }
+    }
+  }
+
+  ENVOY_LOG(debug, "subset lb: indexed {} hosts of priority {} by {} keys", hosts.size(),
+            priority, index.values_.size());
+  priorities_[priority] = std::move(index);
+}
+
+void BitmapSubsetLoadBalancer::clearSubsets() {
+  stats_.lb_subsets_removed_.add(subsets_.size());
+  stats_.lb_subsets_active_.sub(subsets_.size());
+  subsets_.clear();
+  any_subset_.reset();
+  default_subset_hosts_.reset();
+}
+
+HostSelectionResponse BitmapSubsetLoadBalancer::chooseHost(LoadBalancerContext* context) {
+  if (context != nullptr && context->metadataMatchCriteria() != nullptr) {
+    KeyValueRefs kvs;
+    if (selectKeyValues(*context->metadataMatchCriteria(), kvs)) {
+      SubsetPtr uncached;
+      const Subset& subset = findOrCreateSubset(kvs, uncached);
+      if (!subset.hosts_.empty()) {
+        stats_.lb_subsets_selected_.inc();
+        return pickHost(subset);
+      }
+    }
+  }
+
+  const Subset* fallback_subset = nullptr;
+  if (fallback_policy_ == envoy::config::cluster::v3::Cluster::LbSubsetConfig::ANY_ENDPOINT) {
+    if (any_subset_ == nullptr) {
+      any_subset_ = createSubset({});
+    }
+    fallback_subset = any_subset_.get();
+  } else if (fallback_policy_ ==
+             envoy::config::cluster::v3::Cluster::LbSubsetConfig::DEFAULT_SUBSET) {
+    if (default_subset_hosts_ == nullptr) {
+      KeyValueRefs kvs;
+      for (const auto& [key, value] : default_subset_) {
+        kvs.emplace_back(&key, &value);
+      }
+      default_subset_hosts_ = createSubset(kvs);
+    }
+    fallback_subset = default_subset_hosts_.get();
+  }
+  if (fallback_subset == nullptr) {
+    return {nullptr};
+  }
+
+  HostConstSharedPtr host = pickHost(*fallback_subset);
+  if (host != nullptr) {
+    stats_.lb_subsets_fallback_.inc();
+    return host;
+  }
+
+  if (panic_mode_any_) {
+    if (any_subset_ == nullptr) {
+      any_subset_ = createSubset({});
+    }
+    host = pickHost(*any_subset_);
+    if (host != nullptr) {
+      stats_.lb_subsets_fallback_panic_.inc();
+      return host;
+    }
+  }
+  return {nullptr};
+}
+
+// Finds the first selector whose keys the criteria have, which must be all of the keys of the
+// criteria unless redundant keys are allowed, and collects the criteria of its keys. Both the
+// criteria and the keys of the selectors are sorted by key.
+bool BitmapSubsetLoadBalancer::selectKeyValues(const Router::MetadataMatchCriteria& criteria,
+                                               KeyValueRefs& kvs) const {
+  const auto& matches = criteria.metadataMatchCriteria();
+  for (const auto& selector : subset_selectors_) {
+    const auto& keys = selector->selectorKeys();
+    if (allow_redundant_keys_ ? keys.size() > matches.size() : keys.size() != matches.size()) {
+      continue;
+    }
+    kvs.clear();
+    auto match = matches.begin();
+    for (const std::string& key : keys) {
+      while (match != matches.end() && (*match)->name() < key) {
+        ++match;
+      }
+      if (match == matches.end() || (*match)->name() != key) {
+        break;
+      }
+      kvs.emplace_back(&(*match)->name(), &(*match)->value());
+      ++match;
+    }
+    if (kvs.size() == keys.size()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+const BitmapSubsetLoadBalancer::Subset&
+BitmapSubsetLoadBalancer::findOrCreateSubset(const KeyValueRefs& kvs, SubsetPtr& uncached) {
+  uint64_t hash = 0;
+  for (const auto& [key, value] : kvs) {
+    hash = absl::HashOf(hash, *key, value->hash());
+  }
+
+  const auto it = subsets_.find(hash);
+  if (it != subsets_.end()) {
+    const Subset& subset = *it->second;
+    const bool same_key_values =
+        std::equal(subset.key_values_.begin(), subset.key_values_.end(), kvs.begin(), kvs.end(),
+                   [](const KeyValue& a, const auto& b) {
+                     return a.first == *b.first && a.second == *b.second;
+                   });
+    if (same_key_values) {
+      return subset;
+    }
+    // A hash collision of two subsets, which is too rare to be worth caching both.
+    uncached = createSubset(kvs);
+    return *uncached;
+  }
+
+  if (subsets_.size() >= MaxCachedSubsets) {
+    clearSubsets();
+  }
+  SubsetPtr subset = createSubset(kvs);
+  const Subset& result = *subset;
+  subsets_.emplace(hash, std::move(subset));
+  stats_.lb_subsets_created_.inc();
+  stats_.lb_subsets_active_.inc();
+  return result;
+}
+
+BitmapSubsetLoadBalancer::SubsetPtr
+BitmapSubsetLoadBalancer::createSubset(const KeyValueRefs& kvs) const {
+  auto subset = std::make_unique<Subset>();
+  for (const auto& [key, value] : kvs) {
+    subset->key_values_.emplace_back(*key, *value);
+  }
+
+  // The hosts of a priority which have all of the key values.
+  const auto subset_hosts = [&kvs](const PriorityIndex& index) -> HostBitmap {
+    if (kvs.empty()) {
+      return index.all_;
+    }
+    HostBitmap hosts;
+    for (size_t i = 0; i < kvs.size(); ++i) {
+      const auto key_it = index.values_.find(*kvs[i].first);
+      if (key_it == index.values_.end()) {
+        return {};
+      }
+      const auto value_it = key_it->second.find(*kvs[i].second);
+      if (value_it == key_it->second.end()) {
+        return {};
+      }
+      hosts = i == 0 ? value_it->second : HostBitmap::intersect(hosts, value_it->second);
+      if (hosts.empty()) {
+        return hosts;
+      }
+    }
+    return hosts;
+  };
+
+  // Picks from the healthy hosts of the first priority which has any, then from the degraded hosts
+  // of the first priority which has any, and otherwise from all of the hosts of the first priority
+  // which has hosts in the subset.
+  absl::optional<std::pair<uint32_t, HostBitmap>> degraded;
+  absl::optional<std::pair<uint32_t, HostBitmap>> panic;
+  absl::optional<std::pair<uint32_t, HostBitmap>> chosen;
+  for (uint32_t priority = 0; priority < priorities_.size(); ++priority) {
+    const PriorityIndex& index = priorities_[priority];
+    HostBitmap hosts = subset_hosts(index);
+    if (hosts.empty()) {
+      continue;
+    }
+    HostBitmap healthy = HostBitmap::intersect(hosts, index.healthy_);
+    if (!healthy.empty()) {
+      chosen.emplace(priority, std::move(healthy));
+      break;
+    }
+    if (!degraded.has_value()) {
+      HostBitmap degraded_hosts = HostBitmap::intersect(hosts, index.degraded_);
+      if (!degraded_hosts.empty()) {
+        degraded.emplace(priority, std::move(degraded_hosts));
+      }
+    }
+    if (!panic.has_value()) {
+      panic.emplace(priority, std::move(hosts));
+    }
+  }
+  if (!chosen.has_value()) {
+    chosen = degraded.has_value() ? std::move(degraded) : std::move(panic);
+  }
+  if (!chosen.has_value()) {
+    return subset;
+  }
+
+  subset->priority_ = chosen->first;
+  subset->hosts_ = std::move(chosen->second);
+  const HostVector& hosts = *priorities_[subset->priority_].hosts_;
+  subset->cumulative_weights_.reserve(subset->hosts_.wordCount());
+  uint64_t total_weight = 0;
+  for (size_t i = 0; i < subset->hosts_.wordCount(); ++i) {
+    const uint32_t base = subset->hosts_.wordPosition(i) * 64;
+    for (uint64_t word = subset->hosts_.word(i); word != 0; word &= word - 1) {
+      total_weight += hosts[base + absl::countr_zero(word)]->weight();
+    }
+    subset->cumulative_weights_.push_back(total_weight);
+  }
+  return subset;
+}
+
+// Picks a host in proportion to its weight: the word which holds the host is found by a binary
+// search of the cumulative weights of the words, and the host by walking the bits of the word.
+HostConstSharedPtr BitmapSubsetLoadBalancer::pickHost(const Subset& subset) {
+  if (subset.hosts_.empty() || subset.cumulative_weights_.back() == 0) {
+    return nullptr;
+  }
+  const auto& cumulative_weights = subset.cumulative_weights_;
+  uint64_t target = random_.random() % cumulative_weights.back();
+  const size_t i = std::upper_bound(cumulative_weights.begin(), cumulative_weights.end(), target) -
+                   cumulative_weights.begin();
+  if (i > 0) {
+    target -= cumulative_weights[i - 1];
+  }
+
+  const HostVector& hosts = *priorities_[subset.priority_].hosts_;
+  const uint32_t base = subset.hosts_.wordPosition(i) * 64;
+  HostConstSharedPtr host;
+  for (uint64_t word = subset.hosts_.word(i); word != 0; word &= word - 1) {
+    host = hosts[base + absl::countr_zero(word)];
+    const uint32_t weight = host->weight();
+    if (target < weight) {
+      break;
+    }
+    target -= weight;
+  }
+  return host;
+}
+
+} // namespace Upstream
+} // namespace Envoy
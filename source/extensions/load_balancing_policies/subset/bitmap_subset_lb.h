@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/common/optref.h"
+#include "envoy/common/random_generator.h"
+#include "envoy/upstream/load_balancer.h"
+#include "envoy/upstream/upstream.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/load_balancing_policies/subset/subset_lb_config.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/container/node_hash_map.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * A set of indices of the hosts of a host set. Only the non-zero 64 bit words of the bitmap are
+ * stored, along with their position, so that the hosts of a metadata value which few hosts have
+ * take little memory however many hosts the cluster has.
+ */
+class HostBitmap {
+public:
+  /**
+   * Adds a host to the set. The hosts must be added in ascending order.
+   */
+  void set(uint32_t index);
+
+  /**
+   * @return the hosts which are in both sets.
+   */
+  static HostBitmap intersect(const HostBitmap& a, const HostBitmap& b);
+
+  bool empty() const { return words_.empty(); }
+  uint32_t count() const;
+
+  /**
+   * @return the number of stored words, each of which holds up to 64 hosts.
+   */
+  size_t wordCount() const { return words_.size(); }
+  uint32_t wordPosition(size_t word) const { return positions_[word]; }
+  uint64_t word(size_t word) const { return words_[word]; }
+
+private:
+  std::vector<uint32_t> positions_;
+  std::vector<uint64_t> words_;
+};
+
+/**
+ * An alternative to the SubsetLoadBalancer which doesn't create a load balancer per subset. The
+ * hosts which have each value of each selector key are indexed as bitmaps, which are intersected
+ * to find the hosts of the subset of a request. Subsets are cached until the hosts or their health
+ * change, and a host is picked from the subset at random, in proportion to its weight.
+ */
+class BitmapSubsetLoadBalancer : public LoadBalancer, Logger::Loggable<Logger::Id::upstream> {
+public:
+  BitmapSubsetLoadBalancer(const SubsetLoadBalancerConfig& lb_config,
+                           const PrioritySet& priority_set, ClusterLbStats& stats,
+                           Random::RandomGenerator& random);
+  ~BitmapSubsetLoadBalancer() override;
+
+  // Upstream::LoadBalancer
+  HostSelectionResponse chooseHost(LoadBalancerContext* context) override;
+  HostConstSharedPtr peekAnotherHost(LoadBalancerContext*) override { return nullptr; }
+  absl::optional<Upstream::SelectedPoolAndConnection>
+  selectExistingConnection(Upstream::LoadBalancerContext*, const Upstream::Host&,
+                           std::vector<uint8_t>&) override {
+    return absl::nullopt;
+  }
+  OptRef<Envoy::Http::ConnectionPool::ConnectionLifetimeCallbacks> lifetimeCallbacks() override {
+    return {};
+  }
+
+  size_t cachedSubsets() const { return subsets_.size(); }
+
+  // Bounds the memory of the cached subsets. The cache is cleared when it is full.
+  static constexpr size_t MaxCachedSubsets = 16384;
+
+private:
+  using KeyValue = std::pair<std::string, HashedValue>;
+  using KeyValueRefs = absl::InlinedVector<std::pair<const std::string*, const HashedValue*>, 8>;
+
+  // The index of the hosts of a priority.
+  struct PriorityIndex {
+    HostVectorConstSharedPtr hosts_;
+    absl::node_hash_map<std::string, absl::node_hash_map<HashedValue, HostBitmap>> values_;
+    HostBitmap all_;
+    HostBitmap healthy_;
+    HostBitmap degraded_;
+  };
+
+  // The hosts of a subset which a host is picked from, which all belong to one priority.
+  struct Subset {
+    std::vector<KeyValue> key_values_;
+    uint32_t priority_{};
+    HostBitmap hosts_;
+    // The total weight of the hosts of each word of hosts_ and of the words before it.
+    std::vector<uint64_t> cumulative_weights_;
+  };
+  using SubsetPtr = std::unique_ptr<Subset>;
+
+  void indexHosts(uint32_t priority);
+  void clearSubsets();
+  bool selectKeyValues(const Router::MetadataMatchCriteria& criteria, KeyValueRefs& kvs) const;
+  const Subset& findOrCreateSubset(const KeyValueRefs& kvs, SubsetPtr& uncached);
+  SubsetPtr createSubset(const KeyValueRefs& kvs) const;
+  HostConstSharedPtr pickHost(const Subset& subset);
+
+  const PrioritySet& priority_set_;
+  ClusterLbStats& stats_;
+  Random::RandomGenerator& random_;
+  const std::vector<SubsetSelectorPtr>& subset_selectors_;
+  const envoy::config::cluster::v3::Cluster::LbSubsetConfig::LbSubsetFallbackPolicy
+      fallback_policy_;
+  std::vector<KeyValue> default_subset_;
+  absl::flat_hash_set<std::string> indexed_keys_;
+
+  std::vector<PriorityIndex> priorities_;
+  absl::flat_hash_map<uint64_t, SubsetPtr> subsets_;
+  SubsetPtr any_subset_;
+  SubsetPtr default_subset_hosts_;
+  Common::CallbackHandlePtr priority_update_cb_;
+
+  // Keep small members (bools and enums) at the end of class, to reduce alignment overhead.
+  const bool panic_mode_any_ : 1;
+  const bool list_as_any_ : 1;
+  const bool allow_redundant_keys_ : 1;
+};
+
+} // namespace Upstream
+} // namespace Envoy
@@ -2,6 +2,7 @@
 
 #include "source/common/upstream/upstream_impl.h"
 #include "source/extensions/load_balancing_policies/common/factory_base.h"
+#include "source/extensions/load_balancing_policies/subset/bitmap_subset_lb.h"
 #include "source/extensions/load_balancing_policies/subset/subset_lb.h"
 
 namespace Envoy {
@@ -21,6 +22,10 @@ public:
         random_(random), time_source_(time_source) {}
 
   Upstream::LoadBalancerPtr create(Upstream::LoadBalancerParams params) override {
+    if (subset_config_.subsetInfo().hostBitmapIndex()) {
+      return std::make_unique<Upstream::BitmapSubsetLoadBalancer>(
+          subset_config_, params.priority_set, cluster_info_.lbStats(), random_);
+    }
     return std::make_unique<Upstream::SubsetLoadBalancer>(
         subset_config_, cluster_info_, params.priority_set, params.local_priority_set,
         cluster_info_.lbStats(), cluster_info_.statsScope(), runtime_, random_, time_source_);
@@ -80,7 +80,42 @@ SubsetLoadBalancerConfig::SubsetLoadBalancerConfig(
         fmt::format("cluster: didn't find a registered load balancer factory implementation for "
                     "subset lb with names from [{}]",
                     absl::StrJoin(missing_policies, ", ")));
+    return;
+  }
+
+  if (subset_info_->hostBitmapIndex()) {
+    creation_status = validateHostBitmapIndex(config);
+  }
+}
+
+absl::Status
+SubsetLoadBalancerConfig::validateHostBitmapIndex(const SubsetLbConfigProto& config) const {
+  // The bitmap index picks hosts by weight itself, and only supports the features which don't
+  // need a load balancer or a host set per subset.
+  if (child_lb_factory_->name() != "envoy.load_balancing_policies.random") {
+    return absl::InvalidArgumentError(
+        fmt::format("subset lb: the HOST_BITMAPS subset index requires the random subset lb "
+                    "policy, not {}",
+                    child_lb_factory_->name()));
+  }
+  if (config.locality_weight_aware() || config.scale_locality_weight()) {
+    return absl::InvalidArgumentError(
+        "subset lb: the HOST_BITMAPS subset index does not support locality weights");
+  }
+  if (config.metadata_fallback_policy() == SubsetLbConfigProto::FALLBACK_LIST) {
+    return absl::InvalidArgumentError(
+        "subset lb: the HOST_BITMAPS subset index does not support the FALLBACK_LIST metadata "
+        "fallback policy");
+  }
+  for (const auto& selector : config.subset_selectors()) {
+    if (selector.single_host_per_subset() ||
+        selector.fallback_policy() != SubsetLbConfigProto::LbSubsetSelector::NOT_DEFINED) {
+      return absl::InvalidArgumentError(
+          "subset lb: the HOST_BITMAPS subset index does not support single host subsets or "
+          "selector fallback policies");
+    }
   }
+  return absl::OkStatus();
 }
 
 SubsetLoadBalancerConfig::SubsetLoadBalancerConfig(
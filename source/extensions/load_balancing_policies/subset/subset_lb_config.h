@@ -111,6 +111,12 @@ public:
    * @return bool whether redundant key/value pairs is allowed in the request metadata.
    */
   virtual bool allowRedundantKeys() const PURE;
+
+  /*
+   * @return bool whether the subsets are found by intersecting bitmaps of the hosts with each
+   * metadata value, rather than by a load balancer per subset.
+   */
+  virtual bool hostBitmapIndex() const PURE;
 };
 
 using LoadBalancerSubsetInfoPtr = std::unique_ptr<LoadBalancerSubsetInfo>;
@@ -136,7 +142,8 @@ public:
         locality_weight_aware_(subset_config.locality_weight_aware()),
         scale_locality_weight_(subset_config.scale_locality_weight()),
         panic_mode_any_(subset_config.panic_mode_any()), list_as_any_(subset_config.list_as_any()),
-        allow_redundant_keys_(subset_config.allow_redundant_keys()) {
+        allow_redundant_keys_(subset_config.allow_redundant_keys()),
+        host_bitmap_index_(subset_config.subset_index() == SubsetLbConfigProto::HOST_BITMAPS) {
     for (const auto& subset : subset_config.subset_selectors()) {
       if (!subset.keys().empty()) {
         subset_selectors_.emplace_back(std::make_shared<SubsetSelector>(
@@ -190,6 +197,7 @@ public:
   bool panicModeAny() const override { return panic_mode_any_; }
   bool listAsAny() const override { return list_as_any_; }
   bool allowRedundantKeys() const override { return allow_redundant_keys_; }
+  bool hostBitmapIndex() const override { return host_bitmap_index_; }
 
 private:
   const ProtobufWkt::Struct default_subset_;
@@ -203,6 +211,7 @@ private:
   const bool panic_mode_any_ : 1;
   const bool list_as_any_ : 1;
   const bool allow_redundant_keys_{};
+  const bool host_bitmap_index_{};
 };
 
 using DefaultLoadBalancerSubsetInfo = ConstSingleton<LoadBalancerSubsetInfoImpl>;
@@ -230,6 +239,8 @@ public:
   const LoadBalancerSubsetInfo& subsetInfo() const { return *subset_info_; }
 
 private:
+  absl::Status validateHostBitmapIndex(const SubsetLbConfigProto& config) const;
+
   LoadBalancerSubsetInfoPtr subset_info_;
   Upstream::TypedLoadBalancerFactory* child_lb_factory_{};
   Upstream::LoadBalancerConfigPtr child_lb_config_;
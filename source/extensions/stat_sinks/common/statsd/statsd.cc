@@ -20,6 +20,7 @@
 #include "source/common/network/utility.h"
 #include "source/common/stats/symbol_table.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 
 namespace Envoy {
@@ -43,75 +44,190 @@ void UdpStatsdSink::WriterImpl::writeBuffer(Buffer::Instance& data) {
   Network::Utility::writeToSocket(*io_handle_, data, nullptr, *parent_.server_address_);
 }
 
+void UdpStatsdSink::WriterImpl::writeDatagrams(const std::vector<std::string>& datagrams) {
+  if (!io_handle_->isOpen()) {
+    Writer::writeDatagrams(datagrams);
+    return;
+  }
+
+  std::vector<Buffer::RawSlice> slices;
+  slices.reserve(datagrams.size());
+  for (const std::string& datagram : datagrams) {
+    // TODO(mattklein123): We can avoid this const_cast pattern by having a constant variant of
+    // RawSlice. This can be fixed elsewhere as well.
+    slices.push_back({const_cast<char*>(datagram.data()), datagram.size()});
+  }
+
+  // Like other statsd writes, this is best effort: the datagrams which can't be sent right away
+  // are dropped.
+  uint64_t sent = 0;
+  while (sent < slices.size()) {
+    const Api::IoCallUint64Result result = io_handle_->sendmmsg(
+        slices.data() + sent, slices.size() - sent, 0, *parent_.server_address_);
+    if (!result.ok() || result.return_value_ == 0) {
+      break;
+    }
+    sent += result.return_value_;
+  }
+}
+
 UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
                              Network::Address::InstanceConstSharedPtr address, const bool use_tag,
                              const std::string& prefix, absl::optional<uint64_t> buffer_size,
-                             const Statsd::TagFormat& tag_format)
+                             const Statsd::TagFormat& tag_format,
+                             OptRef<Stats::SymbolTable> symbol_table,
+                             bool histograms_as_distributions)
     : tls_(tls.allocateSlot()), server_address_(std::move(address)), use_tag_(use_tag),
       prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix),
-      buffer_size_(buffer_size.value_or(0)), tag_format_(tag_format) {
+      buffer_size_(buffer_size.value_or(0)), tag_format_(tag_format),
+      symbol_table_(symbol_table) {
   tls_->set([this](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
     return std::make_shared<WriterImpl>(*this);
   });
+  initializeCaches(tls, histograms_as_distributions);
+}
+
+void UdpStatsdSink::initializeCaches(ThreadLocal::SlotAllocator& tls,
+                                     bool histograms_as_distributions) {
+  if (symbol_table_.has_value()) {
+    line_formats_.emplace(*symbol_table_);
+  }
+  if (!histograms_as_distributions) {
+    return;
+  }
+  ASSERT(symbol_table_.has_value());
+  distributions_ = ThreadLocal::TypedSlot<TlsDistributions>::makeUnique(tls);
+  distributions_->set(
+      [this](Event::Dispatcher&) { return std::make_shared<TlsDistributions>(*this); });
 }
 
 void UdpStatsdSink::flush(Stats::MetricSnapshot& snapshot) {
-  Writer& writer = tls_->getTyped<Writer>();
-  Buffer::OwnedImpl buffer;
+  DatagramBatch batch(*this, tls_->getTyped<Writer>());
 
   for (const auto& counter : snapshot.counters()) {
     if (counter.counter_.get().used()) {
-      const std::string counter_str = buildMessage(counter.counter_.get(), counter.delta_, "|c");
-      writeBuffer(buffer, writer, counter_str);
+      batch.add(lineFormat(counter.counter_.get()), counter.delta_, "|c");
     }
   }
 
   for (const auto& counter : snapshot.hostCounters()) {
-    const std::string counter_str = buildMessage(counter, counter.delta(), "|c");
-    writeBuffer(buffer, writer, counter_str);
+    batch.add(buildLineFormat(counter), counter.delta(), "|c");
   }
 
   for (const auto& gauge : snapshot.gauges()) {
     if (gauge.get().used()) {
-      const std::string gauge_str = buildMessage(gauge.get(), gauge.get().value(), "|g");
-      writeBuffer(buffer, writer, gauge_str);
+      batch.add(lineFormat(gauge.get()), gauge.get().value(), "|g");
     }
   }
 
   for (const auto& gauge : snapshot.hostGauges()) {
-    const std::string gauge_str = buildMessage(gauge, gauge.value(), "|g");
-    writeBuffer(buffer, writer, gauge_str);
+    batch.add(buildLineFormat(gauge), gauge.value(), "|g");
   }
 
-  flushBuffer(buffer, writer);
+  batch.flush();
   // TODO(efimki): Add support of text readouts stats.
+
+  // Stop caching the metrics which are no longer flushed, such as those which were deleted.
+  if (line_formats_.has_value()) {
+    line_formats_->evictUnused();
+  }
+
+  if (distributions_ != nullptr) {
+    distributions_->runOnAllThreads([](OptRef<TlsDistributions> distributions) {
+      if (distributions.has_value()) {
+        distributions->flush();
+      }
+    });
+  }
 }
 
-void UdpStatsdSink::writeBuffer(Buffer::OwnedImpl& buffer, Writer& writer,
-                                const std::string& statsd_metric) const {
-  if (statsd_metric.length() >= buffer_size_) {
-    // Our statsd_metric is too large to fit into the buffer, skip buffering and write directly
-    writer.write(statsd_metric);
-  } else {
-    if ((buffer.length() + statsd_metric.length() + 1) > buffer_size_) {
-      // If we add the new statsd_metric, we'll overflow our buffer. Flush the buffer to make
-      // room for the new statsd_metric.
-      flushBuffer(buffer, writer);
-    } else if (buffer.length() > 0) {
-      // We have room and have metrics already in the buffer, add a newline to separate
-      // metric entries.
-      buffer.add("\n");
-    }
-    buffer.add(statsd_metric);
+UdpStatsdSink::DatagramBatch::DatagramBatch(const UdpStatsdSink& parent, Writer& writer)
+    : parent_(parent), writer_(writer) {
+  datagram_.reserve(parent_.buffer_size_);
+}
+
+template <typename ValueType>
+void UdpStatsdSink::DatagramBatch::add(const LineFormat& format, ValueType value,
+                                       absl::string_view type) {
+  line_.clear();
+  absl::StrAppend(&line_, format.head_, ":", value, type, format.tail_);
+  addLine(line_);
+}
+
+void UdpStatsdSink::DatagramBatch::addLine(const std::string& line) {
+  if (line.length() >= parent_.buffer_size_) {
+    // Our line is too large to fit into a datagram with others, skip buffering and write directly.
+    writer_.write(line);
+    return;
+  }
+  if ((datagram_.length() + line.length() + 1) > parent_.buffer_size_) {
+    // If we add the new line, we'll overflow the datagram. Finish the datagram to make room for
+    // the new line.
+    finishDatagram();
+  } else if (!datagram_.empty()) {
+    // We have room and have lines already in the datagram, add a newline to separate them.
+    datagram_.push_back('\n');
   }
+  datagram_.append(line);
 }
 
-void UdpStatsdSink::flushBuffer(Buffer::OwnedImpl& buffer, Writer& writer) const {
-  if (buffer.length() == 0) {
+void UdpStatsdSink::DatagramBatch::finishDatagram() {
+  if (datagram_.empty()) {
     return;
   }
-  writer.writeBuffer(buffer);
-  buffer.drain(buffer.length());
+  datagrams_.push_back(std::move(datagram_));
+  datagram_ = std::string();
+  datagram_.reserve(parent_.buffer_size_);
+  if (datagrams_.size() == MAX_DATAGRAMS_PER_WRITE) {
+    writer_.writeDatagrams(datagrams_);
+    datagrams_.clear();
+  }
+}
+
+void UdpStatsdSink::DatagramBatch::flush() {
+  finishDatagram();
+  if (!datagrams_.empty()) {
+    writer_.writeDatagrams(datagrams_);
+    datagrams_.clear();
+  }
+}
+
+void UdpStatsdSink::TlsDistributions::record(const Stats::Histogram& histogram,
+                                             absl::string_view value) {
+  Distribution& distribution = distributions_.get(histogram.statName(), [this, &histogram]() {
+    return Distribution{parent_.buildLineFormat(histogram), ""};
+  });
+
+  const uint64_t max_line_bytes =
+      parent_.buffer_size_ > 0 ? parent_.buffer_size_ : MAX_DISTRIBUTION_LINE_BYTES;
+  // 3 > 1 (":" before the value) + 2 (type, "|d").
+  const uint64_t line_bytes = distribution.format_.head_.size() + distribution.values_.size() +
+                              value.size() + 3 + distribution.format_.tail_.size();
+  if (line_bytes > max_line_bytes && !distribution.values_.empty()) {
+    // Write the full line right away through the writer of this thread, so that the memory held
+    // between flushes is bounded by the number of histograms rather than by the rate of values.
+    parent_.tls_->getTyped<Writer>().write(line(distribution));
+    distribution.values_.clear();
+  }
+  absl::StrAppend(&distribution.values_, ":", value);
+}
+
+void UdpStatsdSink::TlsDistributions::flush() {
+  DatagramBatch batch(parent_, parent_.tls_->getTyped<Writer>());
+  distributions_.forEach([this, &batch](Distribution& distribution) {
+    if (!distribution.values_.empty()) {
+      batch.addLine(line(distribution));
+      distribution.values_.clear();
+    }
+  });
+  batch.flush();
+  // Forget the histograms which didn't record any value since the previous flush.
+  distributions_.evictUnused();
+}
+
+std::string UdpStatsdSink::TlsDistributions::line(const Distribution& distribution) const {
+  return absl::StrCat(distribution.format_.head_, distribution.values_, "|d",
+                      distribution.format_.tail_);
 }
 
 void UdpStatsdSink::onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) {
@@ -128,8 +244,16 @@ void UdpStatsdSink::onHistogramComplete(const Stats::Histogram& histogram, uint6
     constexpr float divisor = Stats::Histogram::PercentScale;
     const float float_value = value;
     const float scaled = float_value / divisor;
+    if (distributions_ != nullptr) {
+      (*distributions_)->record(histogram, absl::StrCat(scaled));
+      return;
+    }
     message = buildMessage(histogram, scaled, "|h");
   } else {
+    if (distributions_ != nullptr) {
+      (*distributions_)->record(histogram, absl::StrCat(value));
+      return;
+    }
     message = buildMessage(histogram, std::chrono::milliseconds(value).count(), "|ms");
   }
   tls_->getTyped<Writer>().write(message);
@@ -138,32 +262,31 @@ void UdpStatsdSink::onHistogramComplete(const Stats::Histogram& histogram, uint6
 template <class StatType, typename ValueType>
 const std::string UdpStatsdSink::buildMessage(const StatType& metric, ValueType value,
                                               const std::string& type) const {
+  const LineFormat format = buildLineFormat(metric);
+  return absl::StrCat(format.head_, ":", value, type, format.tail_);
+}
+
+template <class StatType>
+UdpStatsdSink::LineFormat UdpStatsdSink::buildLineFormat(const StatType& metric) const {
   switch (tag_format_.tag_position) {
-  case Statsd::TagPosition::TagAfterValue: {
-    const std::string message = absl::StrCat(
-        // metric name
-        prefix_, ".", getName(metric),
-        // value and type
-        ":", value, type,
-        // tags
-        buildTagStr(metric.tags()));
-    return message;
-  }
-
-  case Statsd::TagPosition::TagAfterName: {
-    const std::string message = absl::StrCat(
-        // metric name
-        prefix_, ".", getName(metric),
-        // tags
-        buildTagStr(metric.tags()),
-        // value and type
-        ":", value, type);
-    return message;
-  }
+  case Statsd::TagPosition::TagAfterValue:
+    return {absl::StrCat(prefix_, ".", getName(metric)), buildTagStr(metric.tags())};
+
+  case Statsd::TagPosition::TagAfterName:
+    return {absl::StrCat(prefix_, ".", getName(metric), buildTagStr(metric.tags())), ""};
   }
   PANIC_DUE_TO_CORRUPT_ENUM;
 }
 
+const UdpStatsdSink::LineFormat& UdpStatsdSink::lineFormat(const Stats::Metric& metric) {
+  if (!line_formats_.has_value()) {
+    uncached_line_format_ = buildLineFormat(metric);
+    return uncached_line_format_;
+  }
+  return line_formats_->get(metric.statName(),
+                            [this, &metric]() { return buildLineFormat(metric); });
+}
+
 template <class StatType> const std::string UdpStatsdSink::getName(const StatType& metric) const {
   if (use_tag_) {
     return metric.tagExtractedName();
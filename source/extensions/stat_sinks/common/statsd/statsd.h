@@ -1,6 +1,11 @@
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "envoy/buffer/buffer.h"
+#include "envoy/common/optref.h"
 #include "envoy/common/platform.h"
 #include "envoy/local_info/local_info.h"
 #include "envoy/network/connection.h"
@@ -15,6 +20,8 @@
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/macros.h"
 #include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/stats/stat_name_cache.h"
+#include "source/common/stats/symbol_table.h"
 #include "source/extensions/stat_sinks/common/statsd/tag_formats.h"
 
 #include "absl/types/optional.h"
@@ -29,6 +36,10 @@ static const std::string& getDefaultPrefix() { CONSTRUCT_ON_FIRST_USE(std::strin
 
 /**
  * Implementation of Sink that writes to a UDP statsd address.
+ *
+ * When given a symbol table, the sink caches the rendered name and tags of each metric for as long
+ * as the metric is flushed, and can aggregate the values of histograms on each worker into
+ * DogStatsD distributions, which are sent at every flush instead of one datagram per value.
  */
 class UdpStatsdSink : public Stats::Sink {
 public:
@@ -39,22 +50,39 @@ public:
   public:
     virtual void write(const std::string& message) PURE;
     virtual void writeBuffer(Buffer::Instance& data) PURE;
+
+    /**
+     * Writes a batch of datagrams, in as few system calls as the platform allows.
+     * @param datagrams supplies the datagrams to write.
+     */
+    virtual void writeDatagrams(const std::vector<std::string>& datagrams) {
+      for (const std::string& datagram : datagrams) {
+        Buffer::OwnedImpl buffer(datagram);
+        writeBuffer(buffer);
+      }
+    }
   };
 
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, Network::Address::InstanceConstSharedPtr address,
                 const bool use_tag, const std::string& prefix = getDefaultPrefix(),
                 absl::optional<uint64_t> buffer_size = absl::nullopt,
-                const Statsd::TagFormat& tag_format = Statsd::getDefaultTagFormat());
+                const Statsd::TagFormat& tag_format = Statsd::getDefaultTagFormat(),
+                OptRef<Stats::SymbolTable> symbol_table = {},
+                bool histograms_as_distributions = false);
   // For testing.
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, const std::shared_ptr<Writer>& writer,
                 const bool use_tag, const std::string& prefix = getDefaultPrefix(),
                 absl::optional<uint64_t> buffer_size = absl::nullopt,
-                const Statsd::TagFormat& tag_format = Statsd::getDefaultTagFormat())
+                const Statsd::TagFormat& tag_format = Statsd::getDefaultTagFormat(),
+                OptRef<Stats::SymbolTable> symbol_table = {},
+                bool histograms_as_distributions = false)
       : tls_(tls.allocateSlot()), use_tag_(use_tag),
         prefix_(prefix.empty() ? getDefaultPrefix() : prefix),
-        buffer_size_(buffer_size.value_or(0)), tag_format_(tag_format) {
+        buffer_size_(buffer_size.value_or(0)), tag_format_(tag_format),
+        symbol_table_(symbol_table) {
     tls_->set(
         [writer](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr { return writer; });
+    initializeCaches(tls, histograms_as_distributions);
   }
 
   // Stats::Sink
@@ -63,9 +91,75 @@ public:
 
   bool getUseTagForTest() { return use_tag_; }
   uint64_t getBufferSizeForTest() { return buffer_size_; }
+  bool getHistogramsAsDistributionsForTest() { return distributions_ != nullptr; }
+  size_t cachedMetricsForTest() const {
+    return line_formats_.has_value() ? line_formats_->size() : 0;
+  }
   const std::string& getPrefix() { return prefix_; }
 
+  // The number of datagrams which are written at once.
+  static constexpr uint32_t MAX_DATAGRAMS_PER_WRITE = 64;
+
+  // The maximum size of the lines of distributions, when datagrams aren't packed.
+  static constexpr uint64_t MAX_DISTRIBUTION_LINE_BYTES = 1432;
+
 private:
+  // The parts of the line of a metric which surround its value and type.
+  struct LineFormat {
+    // The prefixed name of the metric, followed by its tags if they come before the value.
+    std::string head_;
+    // The tags of the metric if they come after the value.
+    std::string tail_;
+  };
+
+  /**
+   * Packs lines into datagrams of at most buffer_size_ bytes, and writes them in batches.
+   */
+  class DatagramBatch {
+  public:
+    DatagramBatch(const UdpStatsdSink& parent, Writer& writer);
+
+    template <typename ValueType>
+    void add(const LineFormat& format, ValueType value, absl::string_view type);
+    void addLine(const std::string& line);
+    void flush();
+
+  private:
+    void finishDatagram();
+
+    const UdpStatsdSink& parent_;
+    Writer& writer_;
+    std::vector<std::string> datagrams_;
+    std::string datagram_;
+    std::string line_;
+  };
+
+  /**
+   * The values which the histograms recorded on a thread since the last flush.
+   */
+  class TlsDistributions : public ThreadLocal::ThreadLocalObject {
+  public:
+    explicit TlsDistributions(UdpStatsdSink& parent)
+        : parent_(parent), distributions_(*parent.symbol_table_) {}
+
+    void record(const Stats::Histogram& histogram, absl::string_view value);
+    // Writes the distributions, and forgets those of histograms which didn't record any value.
+    void flush();
+
+  private:
+    struct Distribution {
+      LineFormat format_;
+      // The values since the last flush, each preceded by a colon.
+      std::string values_;
+    };
+
+    std::string line(const Distribution& distribution) const;
+
+    UdpStatsdSink& parent_;
+    // The distributions of the histograms which recorded values since the previous flush.
+    Stats::StatNameCache<Distribution> distributions_;
+  };
+
   /**
    * This is a simple UDP localhost writer for statsd messages.
    */
@@ -76,18 +170,21 @@ private:
     // Writer
     void write(const std::string& message) override;
     void writeBuffer(Buffer::Instance& data) override;
+    void writeDatagrams(const std::vector<std::string>& datagrams) override;
 
   private:
     UdpStatsdSink& parent_;
     const Network::IoHandlePtr io_handle_;
   };
 
-  void flushBuffer(Buffer::OwnedImpl& buffer, Writer& writer) const;
-  void writeBuffer(Buffer::OwnedImpl& buffer, Writer& writer, const std::string& data) const;
+  void initializeCaches(ThreadLocal::SlotAllocator& tls, bool histograms_as_distributions);
 
   template <class StatType, typename ValueType>
   const std::string buildMessage(const StatType& metric, ValueType value,
                                  const std::string& type) const;
+  template <class StatType> LineFormat buildLineFormat(const StatType& metric) const;
+  // @return the line format of a metric, from the cache if there is a symbol table.
+  const LineFormat& lineFormat(const Stats::Metric& metric);
   template <class StatType> const std::string getName(const StatType& metric) const;
   const std::string buildTagStr(const std::vector<Stats::Tag>& tags) const;
 
@@ -98,6 +195,12 @@ private:
   const std::string prefix_;
   const uint64_t buffer_size_;
   const Statsd::TagFormat tag_format_;
+  const OptRef<Stats::SymbolTable> symbol_table_;
+  // Set if there is a symbol table. Only accessed by flush(), on the main thread.
+  absl::optional<Stats::StatNameCache<LineFormat>> line_formats_;
+  LineFormat uncached_line_format_;
+  // Set if histograms are sent as distributions.
+  ThreadLocal::TypedSlotPtr<TlsDistributions> distributions_;
 };
 
 /**
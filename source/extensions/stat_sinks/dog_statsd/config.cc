@@ -30,8 +30,10 @@ DogStatsdSinkFactory::createStatsSink(const Protobuf::Message& config,
   if (sink_config.has_max_bytes_per_datagram()) {
     max_bytes = sink_config.max_bytes_per_datagram().value();
   }
-  return std::make_unique<Common::Statsd::UdpStatsdSink>(server.threadLocal(), std::move(address),
-                                                         true, sink_config.prefix(), max_bytes);
+  return std::make_unique<Common::Statsd::UdpStatsdSink>(
+      server.threadLocal(), std::move(address), true, sink_config.prefix(), max_bytes,
+      Common::Statsd::getDefaultTagFormat(), server.scope().symbolTable(),
+      sink_config.histograms_as_distributions());
 }
 
 ProtobufTypes::MessagePtr DogStatsdSinkFactory::createEmptyConfigProto() {
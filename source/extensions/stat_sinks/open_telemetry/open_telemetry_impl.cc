@@ -1,5 +1,9 @@
 #include "source/extensions/stat_sinks/open_telemetry/open_telemetry_impl.h"
 
+#include <limits>
+
+#include "source/common/protobuf/utility.h"
+#include "source/common/runtime/runtime_features.h"
 #include "source/common/tracing/null_span_impl.h"
 
 namespace Envoy {
@@ -7,6 +11,74 @@ namespace Extensions {
 namespace StatSinks {
 namespace OpenTelemetry {
 
+namespace {
+
+constexpr uint32_t DefaultMaxExportRequestBytes = 4 * 1024 * 1024;
+
+// The bytes which a metric adds to the request which it is in, beyond its own: the tag and length
+// of the metrics field.
+uint64_t metricFieldSize(uint64_t metric_size) {
+  return 1 + Protobuf::io::CodedOutputStream::VarintSize64(metric_size) + metric_size;
+}
+
+// The bytes of the resource and scope metrics which enclose the metrics of a request.
+constexpr uint64_t RequestEnvelopeBytes = 12;
+
+/**
+ * Accumulates the metrics of a flush into export requests of a bounded size.
+ */
+class ExportRequestBuilder {
+public:
+  explicit ExportRequestBuilder(uint64_t max_request_bytes)
+      : max_request_bytes_(max_request_bytes) {}
+
+  /**
+   * @return a new metric to fill in, which must then be passed to commit().
+   */
+  opentelemetry::proto::metrics::v1::Metric& startMetric() {
+    if (scope_metrics_ == nullptr) {
+      startRequest();
+    }
+    return *scope_metrics_->add_metrics();
+  }
+
+  /**
+   * Accounts for the metric returned by the last startMetric(), moving it to a new request if it
+   * doesn't fit in the current one.
+   */
+  void commit() {
+    const uint64_t size = metricFieldSize(scope_metrics_->metrics().rbegin()->ByteSizeLong());
+    if (request_bytes_ + size > max_request_bytes_ && scope_metrics_->metrics_size() > 1) {
+      opentelemetry::proto::metrics::v1::Metric* metric =
+          scope_metrics_->mutable_metrics()->ReleaseLast();
+      startRequest();
+      scope_metrics_->mutable_metrics()->AddAllocated(metric);
+    }
+    request_bytes_ += size;
+  }
+
+  std::vector<MetricsExportRequestPtr> finish() {
+    if (requests_.empty()) {
+      startRequest();
+    }
+    return std::move(requests_);
+  }
+
+private:
+  void startRequest() {
+    requests_.push_back(std::make_unique<MetricsExportRequest>());
+    scope_metrics_ = requests_.back()->add_resource_metrics()->add_scope_metrics();
+    request_bytes_ = RequestEnvelopeBytes;
+  }
+
+  const uint64_t max_request_bytes_;
+  std::vector<MetricsExportRequestPtr> requests_;
+  opentelemetry::proto::metrics::v1::ScopeMetrics* scope_metrics_{};
+  uint64_t request_bytes_{};
+};
+
+} // namespace
+
 OtlpOptions::OtlpOptions(const SinkConfig& sink_config)
     : report_counters_as_deltas_(sink_config.report_counters_as_deltas()),
       report_histograms_as_deltas_(sink_config.report_histograms_as_deltas()),
@@ -14,7 +86,26 @@ OtlpOptions::OtlpOptions(const SinkConfig& sink_config)
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(sink_config, emit_tags_as_attributes, true)),
       use_tag_extracted_name_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(sink_config, use_tag_extracted_name, true)),
-      stat_prefix_(!sink_config.prefix().empty() ? sink_config.prefix() + "." : "") {}
+      stat_prefix_(!sink_config.prefix().empty() ? sink_config.prefix() + "." : ""),
+      max_export_request_bytes_(
+          sink_config.has_max_export_request_bytes()
+              ? absl::make_optional(sink_config.max_export_request_bytes().value())
+              : absl::nullopt) {}
+
+bool OtlpOptions::skipUnchangedDeltas() {
+  return Runtime::runtimeFeatureEnabled(
+      "envoy.reloadable_features.otlp_stats_skip_unchanged_deltas");
+}
+
+uint64_t OtlpOptions::maxExportRequestBytes() {
+  if (max_export_request_bytes_.has_value()) {
+    return max_export_request_bytes_.value();
+  }
+  return Runtime::runtimeFeatureEnabled(
+             "envoy.reloadable_features.otlp_stats_split_export_requests")
+             ? DefaultMaxExportRequestBytes
+             : std::numeric_limits<uint64_t>::max();
+}
 
 OpenTelemetryGrpcMetricsExporterImpl::OpenTelemetryGrpcMetricsExporterImpl(
     const OtlpOptionsSharedPtr config, Grpc::RawAsyncClientSharedPtr raw_async_client)
@@ -42,10 +133,9 @@ void OpenTelemetryGrpcMetricsExporterImpl::onFailure(Grpc::Status::GrpcStatus re
   ENVOY_LOG(debug, "export failure; status: {}, message: {}", response_status, response_message);
 }
 
-MetricsExportRequestPtr OtlpMetricsFlusherImpl::flush(Stats::MetricSnapshot& snapshot) const {
-  auto request = std::make_unique<MetricsExportRequest>();
-  auto* resource_metrics = request->add_resource_metrics();
-  auto* scope_metrics = resource_metrics->add_scope_metrics();
+std::vector<MetricsExportRequestPtr>
+OtlpMetricsFlusherImpl::flush(Stats::MetricSnapshot& snapshot) {
+  ExportRequestBuilder builder(config_->maxExportRequestBytes());
 
   int64_t snapshot_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
                                  snapshot.snapshotTime().time_since_epoch())
@@ -53,39 +143,74 @@ MetricsExportRequestPtr OtlpMetricsFlusherImpl::flush(Stats::MetricSnapshot& sna
 
   for (const auto& gauge : snapshot.gauges()) {
     if (predicate_(gauge)) {
-      flushGauge(*scope_metrics->add_metrics(), gauge.get(), snapshot_time_ns);
+      flushGauge(builder.startMetric(), gauge.get(), snapshot_time_ns);
+      builder.commit();
     }
   }
 
   for (const auto& gauge : snapshot.hostGauges()) {
-    flushGauge(*scope_metrics->add_metrics(), gauge, snapshot_time_ns);
+    flushGauge(builder.startMetric(), gauge, snapshot_time_ns);
+    builder.commit();
   }
 
+  // With delta temporality, a counter which hasn't changed would only report a zero.
+  const bool skip_unchanged_deltas = config_->skipUnchangedDeltas();
+  const bool skip_unchanged_counters = skip_unchanged_deltas && config_->reportCountersAsDeltas();
   for (const auto& counter : snapshot.counters()) {
-    if (predicate_(counter.counter_)) {
-      flushCounter(*scope_metrics->add_metrics(), counter.counter_.get(),
-                   counter.counter_.get().value(), counter.delta_, snapshot_time_ns);
+    if (predicate_(counter.counter_) && !(skip_unchanged_counters && counter.delta_ == 0)) {
+      flushCounter(builder.startMetric(), counter.counter_.get(), counter.counter_.get().value(),
+                   counter.delta_, snapshot_time_ns);
+      builder.commit();
     }
   }
 
   for (const auto& counter : snapshot.hostCounters()) {
-    flushCounter(*scope_metrics->add_metrics(), counter, counter.value(), counter.delta(),
-                 snapshot_time_ns);
+    if (!(skip_unchanged_counters && counter.delta() == 0)) {
+      flushCounter(builder.startMetric(), counter, counter.value(), counter.delta(),
+                   snapshot_time_ns);
+      builder.commit();
+    }
   }
 
+  const bool skip_unchanged_histograms =
+      skip_unchanged_deltas && config_->reportHistogramsAsDeltas();
   for (const auto& histogram : snapshot.histograms()) {
-    if (predicate_(histogram)) {
-      flushHistogram(*scope_metrics->add_metrics(), histogram, snapshot_time_ns);
+    if (predicate_(histogram) &&
+        !(skip_unchanged_histograms &&
+          histogram.get().intervalStatistics().sampleCount() == 0)) {
+      flushHistogram(builder.startMetric(), histogram, snapshot_time_ns);
+      builder.commit();
     }
   }
 
-  return request;
+  // Stop caching the metrics which are no longer flushed, such as those which were deleted.
+  metric_identities_.evictUnused();
+
+  return builder.finish();
+}
+
+const OtlpMetricsFlusherImpl::MetricIdentity&
+OtlpMetricsFlusherImpl::identityOf(const Stats::Metric& stat) {
+  return metric_identities_.get(stat.statName(), [this, &stat]() {
+    MetricIdentity identity;
+    identity.name_ = absl::StrCat(config_->statPrefix(), config_->useTagExtractedName()
+                                                             ? stat.tagExtractedName()
+                                                             : stat.name());
+    if (config_->emitTagsAsAttributes()) {
+      for (const auto& tag : stat.tags()) {
+        auto* attribute = identity.attributes_.Add();
+        attribute->set_key(tag.name_);
+        attribute->mutable_value()->set_string_value(tag.value_);
+      }
+    }
+    return identity;
+  });
 }
 
 template <class GaugeType>
 void OtlpMetricsFlusherImpl::flushGauge(opentelemetry::proto::metrics::v1::Metric& metric,
                                         const GaugeType& gauge_stat,
-                                        int64_t snapshot_time_ns) const {
+                                        int64_t snapshot_time_ns) {
   auto* data_point = metric.mutable_gauge()->add_data_points();
   data_point->set_time_unix_nano(snapshot_time_ns);
   setMetricCommon(metric, *data_point, snapshot_time_ns, gauge_stat);
@@ -96,7 +221,7 @@ void OtlpMetricsFlusherImpl::flushGauge(opentelemetry::proto::metrics::v1::Metri
 template <class CounterType>
 void OtlpMetricsFlusherImpl::flushCounter(opentelemetry::proto::metrics::v1::Metric& metric,
                                           const CounterType& counter, uint64_t value,
-                                          uint64_t delta, int64_t snapshot_time_ns) const {
+                                          uint64_t delta, int64_t snapshot_time_ns) {
   auto* sum = metric.mutable_sum();
   sum->set_is_monotonic(true);
   auto* data_point = sum->add_data_points();
@@ -113,7 +238,7 @@ void OtlpMetricsFlusherImpl::flushCounter(opentelemetry::proto::metrics::v1::Met
 
 void OtlpMetricsFlusherImpl::flushHistogram(opentelemetry::proto::metrics::v1::Metric& metric,
                                             const Stats::ParentHistogram& parent_histogram,
-                                            int64_t snapshot_time_ns) const {
+                                            int64_t snapshot_time_ns) {
   auto* histogram = metric.mutable_histogram();
   auto* data_point = histogram->add_data_points();
   setMetricCommon(metric, *data_point, snapshot_time_ns, parent_histogram);
@@ -143,32 +268,22 @@ void OtlpMetricsFlusherImpl::flushHistogram(opentelemetry::proto::metrics::v1::M
   data_point->add_bucket_counts(histogram_stats.outOfBoundCount());
 }
 
-template <class StatType>
-void OtlpMetricsFlusherImpl::setMetricCommon(
-    opentelemetry::proto::metrics::v1::Metric& metric,
-    opentelemetry::proto::metrics::v1::NumberDataPoint& data_point, int64_t snapshot_time_ns,
-    const StatType& stat) const {
+template <class DataPoint>
+void OtlpMetricsFlusherImpl::setMetricCommon(opentelemetry::proto::metrics::v1::Metric& metric,
+                                             DataPoint& data_point, int64_t snapshot_time_ns,
+                                             const Stats::Metric& stat) {
   data_point.set_time_unix_nano(snapshot_time_ns);
   // TODO(ohadvano): support ``start_time_unix_nano`` optional field
-  metric.set_name(absl::StrCat(config_->statPrefix(), config_->useTagExtractedName()
-                                                          ? stat.tagExtractedName()
-                                                          : stat.name()));
-
-  if (config_->emitTagsAsAttributes()) {
-    for (const auto& tag : stat.tags()) {
-      auto* attribute = data_point.add_attributes();
-      attribute->set_key(tag.name_);
-      attribute->mutable_value()->set_string_value(tag.value_);
-    }
-  }
+  const MetricIdentity& identity = identityOf(stat);
+  metric.set_name(identity.name_);
+  *data_point.mutable_attributes() = identity.attributes_;
 }
 
-void OtlpMetricsFlusherImpl::setMetricCommon(
-    opentelemetry::proto::metrics::v1::Metric& metric,
-    opentelemetry::proto::metrics::v1::HistogramDataPoint& data_point, int64_t snapshot_time_ns,
-    const Stats::Metric& stat) const {
+template <class DataPoint>
+void OtlpMetricsFlusherImpl::setMetricCommon(opentelemetry::proto::metrics::v1::Metric& metric,
+                                             DataPoint& data_point, int64_t snapshot_time_ns,
+                                             const Stats::PrimitiveMetricMetadata& stat) const {
   data_point.set_time_unix_nano(snapshot_time_ns);
-  // TODO(ohadvano): support ``start_time_unix_nano optional`` field
   metric.set_name(absl::StrCat(config_->statPrefix(), config_->useTagExtractedName()
                                                           ? stat.tagExtractedName()
                                                           : stat.name()));
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "envoy/extensions/stat_sinks/open_telemetry/v3/open_telemetry.pb.h"
 #include "envoy/extensions/stat_sinks/open_telemetry/v3/open_telemetry.pb.validate.h"
@@ -8,10 +9,15 @@
 #include "envoy/local_info/local_info.h"
 #include "envoy/singleton/instance.h"
 #include "envoy/stats/histogram.h"
+#include "envoy/stats/primitive_stats.h"
 #include "envoy/stats/sink.h"
 #include "envoy/stats/stats.h"
 
 #include "source/common/grpc/typed_async_client.h"
+#include "source/common/stats/stat_name_cache.h"
+#include "source/common/stats/symbol_table.h"
+
+#include "absl/types/optional.h"
 
 #include "opentelemetry/proto/collector/metrics/v1/metrics_service.pb.h"
 #include "opentelemetry/proto/common/v1/common.pb.h"
@@ -42,6 +48,8 @@ public:
   bool emitTagsAsAttributes() { return emit_tags_as_attributes_; }
   bool useTagExtractedName() { return use_tag_extracted_name_; }
   const std::string& statPrefix() { return stat_prefix_; }
+  bool skipUnchangedDeltas();
+  uint64_t maxExportRequestBytes();
 
 private:
   const bool report_counters_as_deltas_;
@@ -49,6 +57,7 @@ private:
   const bool emit_tags_as_attributes_;
   const bool use_tag_extracted_name_;
   const std::string stat_prefix_;
+  const absl::optional<uint32_t> max_export_request_bytes_;
 };
 
 using OtlpOptionsSharedPtr = std::shared_ptr<OtlpOptions>;
@@ -58,50 +67,67 @@ public:
   virtual ~OtlpMetricsFlusher() = default;
 
   /**
-   * Creates an OTLP export request from metric snapshot.
+   * Creates OTLP export requests from metric snapshot.
    * @param snapshot supplies the metrics snapshot to send.
+   * @return the export requests, each within the configured maximum size.
    */
-  virtual MetricsExportRequestPtr flush(Stats::MetricSnapshot& snapshot) const PURE;
+  virtual std::vector<MetricsExportRequestPtr> flush(Stats::MetricSnapshot& snapshot) PURE;
 };
 
 using OtlpMetricsFlusherSharedPtr = std::shared_ptr<OtlpMetricsFlusher>;
 
 /**
- * Production implementation of OtlpMetricsFlusher
+ * Production implementation of OtlpMetricsFlusher. The name and attributes of each metric are
+ * computed once, and reused by the following flushes for as long as the metric is flushed.
  */
 class OtlpMetricsFlusherImpl : public OtlpMetricsFlusher {
 public:
   OtlpMetricsFlusherImpl(
-      const OtlpOptionsSharedPtr config, std::function<bool(const Stats::Metric&)> predicate =
-                                             [](const auto& metric) { return metric.used(); })
-      : config_(config), predicate_(predicate) {}
+      const OtlpOptionsSharedPtr config, Stats::SymbolTable& symbol_table,
+      std::function<bool(const Stats::Metric&)> predicate =
+          [](const auto& metric) { return metric.used(); })
+      : config_(config), predicate_(predicate), metric_identities_(symbol_table) {}
+
+  std::vector<MetricsExportRequestPtr> flush(Stats::MetricSnapshot& snapshot) override;
 
-  MetricsExportRequestPtr flush(Stats::MetricSnapshot& snapshot) const override;
+  /**
+   * @return the number of metrics of which the name and attributes are cached.
+   */
+  size_t cachedMetricsForTest() const { return metric_identities_.size(); }
 
 private:
+  // The name and attributes of a metric, which only depend on its StatName.
+  struct MetricIdentity {
+    std::string name_;
+    Protobuf::RepeatedPtrField<KeyValue> attributes_;
+  };
+
+  const MetricIdentity& identityOf(const Stats::Metric& stat);
+
   template <class GaugeType>
   void flushGauge(opentelemetry::proto::metrics::v1::Metric& metric, const GaugeType& gauge,
-                  int64_t snapshot_time_ns) const;
+                  int64_t snapshot_time_ns);
 
   template <class CounterType>
   void flushCounter(opentelemetry::proto::metrics::v1::Metric& metric, const CounterType& counter,
-                    uint64_t value, uint64_t delta, int64_t snapshot_time_ns) const;
+                    uint64_t value, uint64_t delta, int64_t snapshot_time_ns);
 
   void flushHistogram(opentelemetry::proto::metrics::v1::Metric& metric,
                       const Stats::ParentHistogram& parent_histogram,
-                      int64_t snapshot_time_ns) const;
+                      int64_t snapshot_time_ns);
 
-  template <class StatType>
-  void setMetricCommon(opentelemetry::proto::metrics::v1::Metric& metric,
-                       opentelemetry::proto::metrics::v1::NumberDataPoint& data_point,
-                       int64_t snapshot_time_ns, const StatType& stat) const;
+  template <class DataPoint>
+  void setMetricCommon(opentelemetry::proto::metrics::v1::Metric& metric, DataPoint& data_point,
+                       int64_t snapshot_time_ns, const Stats::Metric& stat);
 
-  void setMetricCommon(opentelemetry::proto::metrics::v1::Metric& metric,
-                       opentelemetry::proto::metrics::v1::HistogramDataPoint& data_point,
-                       int64_t snapshot_time_ns, const Stats::Metric& stat) const;
+  // Host stats have no StatName, so their names and attributes are computed at every flush.
+  template <class DataPoint>
+  void setMetricCommon(opentelemetry::proto::metrics::v1::Metric& metric, DataPoint& data_point,
+                       int64_t snapshot_time_ns, const Stats::PrimitiveMetricMetadata& stat) const;
 
   const OtlpOptionsSharedPtr config_;
   const std::function<bool(const Stats::Metric&)> predicate_;
+  Stats::StatNameCache<MetricIdentity> metric_identities_;
 };
 
 class OpenTelemetryGrpcMetricsExporter : public Grpc::AsyncRequestCallbacks<MetricsExportResponse> {
@@ -154,7 +180,9 @@ public:
 
   // Stats::Sink
   void flush(Stats::MetricSnapshot& snapshot) override {
-    metrics_exporter_->send(metrics_flusher_->flush(snapshot));
+    for (MetricsExportRequestPtr& request : metrics_flusher_->flush(snapshot)) {
+      metrics_exporter_->send(std::move(request));
+    }
   }
 
   void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
@@ -27,8 +27,13 @@ StatsdSinkFactory::createStatsSink(const Protobuf::Message& config,
     RETURN_IF_NOT_OK_REF(address_or_error.status());
     Network::Address::InstanceConstSharedPtr address = address_or_error.value();
     ENVOY_LOG(debug, "statsd UDP ip address: {}", address->asString());
-    return std::make_unique<Common::Statsd::UdpStatsdSink>(server.threadLocal(), std::move(address),
-                                                           false, statsd_sink.prefix());
+    absl::optional<uint64_t> max_bytes;
+    if (statsd_sink.has_max_bytes_per_datagram()) {
+      max_bytes = statsd_sink.max_bytes_per_datagram().value();
+    }
+    return std::make_unique<Common::Statsd::UdpStatsdSink>(
+        server.threadLocal(), std::move(address), false, statsd_sink.prefix(), max_bytes,
+        Common::Statsd::getDefaultTagFormat(), server.scope().symbolTable());
   }
   case envoy::config::metrics::v3::StatsdSink::StatsdSpecifierCase::kTcpClusterName:
     ENVOY_LOG(debug, "statsd TCP cluster: {}", statsd_sink.tcp_cluster_name());
@@ -8,6 +8,7 @@
 #include "source/common/common/enum_to_int.h"
 #include "source/common/common/logger.h"
 #include "source/common/protobuf/protobuf.h"
+#include "source/extensions/compression/gzip/compressor/zlib_compressor_impl.h"
 #include "source/extensions/tracers/opentelemetry/otlp_utils.h"
 
 namespace Envoy {
@@ -15,10 +16,20 @@ namespace Extensions {
 namespace Tracers {
 namespace OpenTelemetry {
 
+namespace {
+
+using Compression::Gzip::Compressor::ZlibCompressorImpl;
+
+// The largest window, with a gzip header and trailer rather than a zlib one.
+constexpr int64_t GzipWindowBits = 15 | 16;
+constexpr uint64_t GzipMemoryLevel = 8;
+
+} // namespace
+
 OpenTelemetryHttpTraceExporter::OpenTelemetryHttpTraceExporter(
     Upstream::ClusterManager& cluster_manager,
-    const envoy::config::core::v3::HttpService& http_service)
-    : cluster_manager_(cluster_manager), http_service_(http_service) {
+    const envoy::config::core::v3::HttpService& http_service, bool compress)
+    : cluster_manager_(cluster_manager), http_service_(http_service), compress_(compress) {
 
   // Prepare and store headers to be used later on each export request
   for (const auto& header_value_option : http_service_.request_headers_to_add()) {
@@ -60,6 +71,16 @@ bool OpenTelemetryHttpTraceExporter::log(const ExportTraceServiceRequest& reques
     message->headers().setReference(header_pair.first, header_pair.second);
   }
   message->body().add(request_body);
+  if (compress_) {
+    // Spans compress well, as most of their attributes repeat from span to span.
+    ZlibCompressorImpl compressor;
+    compressor.init(ZlibCompressorImpl::CompressionLevel::Speed,
+                    ZlibCompressorImpl::CompressionStrategy::Standard, GzipWindowBits,
+                    GzipMemoryLevel);
+    compressor.compress(message->body(), Envoy::Compression::Compressor::State::Finish);
+    message->headers().setReference(Http::CustomHeaders::get().ContentEncoding,
+                                    Http::CustomHeaders::get().ContentEncodingValues.Gzip);
+  }
 
   const auto options =
       Http::AsyncClient::RequestOptions()
@@ -24,8 +24,14 @@ namespace OpenTelemetry {
 class OpenTelemetryHttpTraceExporter : public OpenTelemetryTraceExporter,
                                        public Http::AsyncClient::Callbacks {
 public:
+  /**
+   * @param cluster_manager the cluster manager of the cluster of the collector.
+   * @param http_service the collector.
+   * @param compress whether to gzip compress the bodies of the export requests.
+   */
   OpenTelemetryHttpTraceExporter(Upstream::ClusterManager& cluster_manager,
-                                 const envoy::config::core::v3::HttpService& http_service);
+                                 const envoy::config::core::v3::HttpService& http_service,
+                                 bool compress = false);
 
   bool log(const ExportTraceServiceRequest& request) override;
 
@@ -37,6 +43,7 @@ public:
 private:
   Upstream::ClusterManager& cluster_manager_;
   envoy::config::core::v3::HttpService http_service_;
+  const bool compress_;
   // Track active HTTP requests to be able to cancel them on destruction.
   Http::AsyncClientRequestTracker active_requests_;
   std::vector<std::pair<const Http::LowerCaseString, const std::string>> parsed_headers_to_add_;
@@ -84,6 +84,12 @@ Driver::Driver(const envoy::config::trace::v3::OpenTelemetryConfig& opentelemetr
   // Create the sampler if configured
   SamplerSharedPtr sampler = tryCreateSamper(opentelemetry_config, context);
 
+  if (opentelemetry_config.has_tail_sampling()) {
+    tail_sampling_stats_.emplace(TailSamplingStats{TAIL_SAMPLING_STATS(
+        POOL_COUNTER_PREFIX(factory_context.scope(), "tracing.opentelemetry.tail_sampling"),
+        POOL_GAUGE_PREFIX(factory_context.scope(), "tracing.opentelemetry.tail_sampling"))});
+  }
+
   // Create the tracer in Thread Local Storage.
   tls_slot_ptr_->set([opentelemetry_config, &factory_context, this, resource_ptr,
                       sampler](Event::Dispatcher& dispatcher) {
@@ -99,11 +105,19 @@ Driver::Driver(const envoy::config::trace::v3::OpenTelemetryConfig& opentelemetr
       exporter = std::make_unique<OpenTelemetryGrpcTraceExporter>(async_client_shared_ptr);
     } else if (opentelemetry_config.has_http_service()) {
       exporter = std::make_unique<OpenTelemetryHttpTraceExporter>(
-          factory_context.clusterManager(), opentelemetry_config.http_service());
+          factory_context.clusterManager(), opentelemetry_config.http_service(),
+          opentelemetry_config.compress_http_export());
+    }
+    TailSamplerPtr tail_sampler;
+    if (opentelemetry_config.has_tail_sampling()) {
+      tail_sampler = std::make_unique<TailSampler>(opentelemetry_config.tail_sampling(),
+                                                   factory_context.timeSource(),
+                                                   *tail_sampling_stats_);
     }
     TracerPtr tracer = std::make_unique<Tracer>(
         std::move(exporter), factory_context.timeSource(), factory_context.api().randomGenerator(),
-        factory_context.runtime(), dispatcher, tracing_stats_, resource_ptr, sampler);
+        factory_context.runtime(), dispatcher, tracing_stats_, resource_ptr, sampler,
+        std::move(tail_sampler));
     return std::make_shared<TlsTracer>(std::move(tracer));
   });
 }
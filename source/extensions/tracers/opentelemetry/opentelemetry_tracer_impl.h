@@ -49,6 +49,7 @@ private:
   const envoy::config::trace::v3::OpenTelemetryConfig opentelemetry_config_;
   ThreadLocal::SlotPtr tls_slot_ptr_;
   OpenTelemetryTracerStats tracing_stats_;
+  absl::optional<TailSamplingStats> tail_sampling_stats_;
 };
 
 } // namespace OpenTelemetry
@@ -0,0 +1,129 @@
+#include "source/extensions/tracers/opentelemetry/tail_sampler.h"
+
+#include <chrono>
+
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/escaping.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace OpenTelemetry {
+
+namespace {
+
+constexpr uint32_t DefaultMaxBufferedSpans = 10000;
+constexpr uint64_t DefaultMaxBufferedBytes = 4 * 1024 * 1024;
+
+bool hasError(const TailSampler::SpanProto& span) {
+  return span.status().code() == ::opentelemetry::proto::trace::v1::Status::STATUS_CODE_ERROR;
+}
+
+absl::optional<std::chrono::milliseconds>
+latencyThreshold(const TailSampler::ConfigProto& config) {
+  if (!config.has_latency_threshold()) {
+    return absl::nullopt;
+  }
+  return std::chrono::milliseconds(
+      DurationUtil::durationToMilliseconds(config.latency_threshold()));
+}
+
+} // namespace
+
+TailSampler::TailSampler(const ConfigProto& config, TimeSource& time_source,
+                         TailSamplingStats stats)
+    : keep_errors_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, keep_errors, true)),
+      latency_threshold_(latencyThreshold(config)),
+      max_buffered_spans_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_buffered_spans, DefaultMaxBufferedSpans)),
+      max_buffered_bytes_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_buffered_bytes, DefaultMaxBufferedBytes)),
+      stats_(stats) {
+  if (config.traces_per_second() > 0) {
+    rate_limiter_.emplace(config.traces_per_second(), time_source, config.traces_per_second());
+  }
+}
+
+TailSampler::~TailSampler() {
+  stats_.buffered_spans_.sub(buffered_spans_);
+  stats_.buffered_bytes_.sub(buffered_bytes_);
+}
+
+std::vector<TailSampler::SpanProto> TailSampler::onSpanFinished(SpanProto&& span,
+                                                                bool local_root) {
+  auto it = traces_by_id_.find(span.trace_id());
+  if (local_root) {
+    // The local root span is usually the last of its trace to finish, so the decision is made
+    // without buffering it.
+    std::vector<SpanProto> spans;
+    bool has_error = hasError(span);
+    if (it != traces_by_id_.end()) {
+      PendingTrace trace = take(it->second);
+      has_error = has_error || trace.has_error_;
+      spans = std::move(trace.spans_);
+    }
+    if (!keep(span, has_error)) {
+      return {};
+    }
+    spans.push_back(std::move(span));
+    return spans;
+  }
+
+  if (it == traces_by_id_.end()) {
+    traces_.push_back(PendingTrace{span.trace_id(), {}, 0, false});
+    it = traces_by_id_.emplace(span.trace_id(), std::prev(traces_.end())).first;
+  }
+  PendingTrace& trace = *it->second;
+  const uint64_t bytes = span.ByteSizeLong();
+  trace.has_error_ = trace.has_error_ || hasError(span);
+  trace.spans_.push_back(std::move(span));
+  trace.bytes_ += bytes;
+  buffered_spans_++;
+  buffered_bytes_ += bytes;
+  stats_.buffered_spans_.inc();
+  stats_.buffered_bytes_.add(bytes);
+
+  while (buffered_spans_ > max_buffered_spans_ || buffered_bytes_ > max_buffered_bytes_) {
+    PendingTrace evicted = take(traces_.begin());
+    ENVOY_LOG(debug, "evicting {} buffered spans of trace {} before its local root span ended",
+              evicted.spans_.size(), absl::BytesToHexString(evicted.trace_id_));
+    stats_.spans_evicted_.add(evicted.spans_.size());
+  }
+  return {};
+}
+
+bool TailSampler::keep(const SpanProto& local_root, bool has_error) {
+  if (has_error && keep_errors_) {
+    stats_.traces_kept_error_.inc();
+    return true;
+  }
+  if (latency_threshold_.has_value() &&
+      std::chrono::nanoseconds(local_root.end_time_unix_nano() -
+                               local_root.start_time_unix_nano()) >= *latency_threshold_) {
+    stats_.traces_kept_latency_.inc();
+    return true;
+  }
+  if (rate_limiter_.has_value() && rate_limiter_->consume(1, false) == 1) {
+    stats_.traces_kept_rate_.inc();
+    return true;
+  }
+  stats_.traces_dropped_.inc();
+  return false;
+}
+
+TailSampler::PendingTrace TailSampler::take(PendingTraceList::iterator it) {
+  PendingTrace trace = std::move(*it);
+  buffered_spans_ -= trace.spans_.size();
+  buffered_bytes_ -= trace.bytes_;
+  stats_.buffered_spans_.sub(trace.spans_.size());
+  stats_.buffered_bytes_.sub(trace.bytes_);
+  traces_by_id_.erase(trace.trace_id_);
+  traces_.erase(it);
+  return trace;
+}
+
+} // namespace OpenTelemetry
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
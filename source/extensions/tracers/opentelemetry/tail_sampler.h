@@ -0,0 +1,99 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/config/trace/v3/opentelemetry.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/common/token_bucket_impl.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/optional.h"
+#include "opentelemetry/proto/trace/v1/trace.pb.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace OpenTelemetry {
+
+#define TAIL_SAMPLING_STATS(COUNTER, GAUGE)                                                        \
+  COUNTER(traces_kept_error)                                                                       \
+  COUNTER(traces_kept_latency)                                                                     \
+  COUNTER(traces_kept_rate)                                                                        \
+  COUNTER(traces_dropped)                                                                          \
+  COUNTER(spans_evicted)                                                                           \
+  GAUGE(buffered_spans, Accumulate)                                                                \
+  GAUGE(buffered_bytes, Accumulate)
+
+struct TailSamplingStats {
+  TAIL_SAMPLING_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * Tail-based sampling of the spans of one worker which weren't sampled when they started.
+ *
+ * Finished spans are buffered by trace id until the local root span of their trace finishes,
+ * at which point the whole trace is either kept or dropped. The buffer is bounded in spans and
+ * bytes; when it is full, the traces which were buffered first are evicted.
+ */
+class TailSampler : Logger::Loggable<Logger::Id::tracing> {
+public:
+  using ConfigProto = envoy::config::trace::v3::OpenTelemetryConfig::TailSampling;
+  using SpanProto = ::opentelemetry::proto::trace::v1::Span;
+
+  TailSampler(const ConfigProto& config, TimeSource& time_source, TailSamplingStats stats);
+  ~TailSampler();
+
+  /**
+   * Buffers a finished span which wasn't sampled, and decides whether to keep its trace if it is
+   * the local root span.
+   * @param span the finished span.
+   * @param local_root whether the span is the first one which Envoy started for the request.
+   * @return the spans to export: either nothing, or all the buffered spans of the trace of a
+   *     local root span which is kept, including it.
+   */
+  std::vector<SpanProto> onSpanFinished(SpanProto&& span, bool local_root);
+
+private:
+  struct PendingTrace {
+    std::string trace_id_;
+    std::vector<SpanProto> spans_;
+    uint64_t bytes_{};
+    bool has_error_{};
+  };
+  using PendingTraceList = std::list<PendingTrace>;
+
+  // @return whether to keep a trace of which the local root span has finished.
+  bool keep(const SpanProto& local_root, bool has_error);
+  // Stops buffering a trace.
+  // @return the trace, with its spans.
+  PendingTrace take(PendingTraceList::iterator it);
+
+  const bool keep_errors_;
+  const absl::optional<std::chrono::milliseconds> latency_threshold_;
+  const uint64_t max_buffered_spans_;
+  const uint64_t max_buffered_bytes_;
+  TailSamplingStats stats_;
+  absl::optional<TokenBucketImpl> rate_limiter_;
+
+  // In the order in which the traces were first buffered.
+  PendingTraceList traces_;
+  absl::flat_hash_map<std::string, PendingTraceList::iterator> traces_by_id_;
+  uint64_t buffered_spans_{};
+  uint64_t buffered_bytes_{};
+};
+
+using TailSamplerPtr = std::unique_ptr<TailSampler>;
+
+} // namespace OpenTelemetry
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
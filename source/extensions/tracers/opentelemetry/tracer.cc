@@ -71,8 +71,11 @@ Tracing::SpanPtr Span::spawnChild(const Tracing::Config&, const std::string& nam
                                   SystemTime start_time) {
   // Build span_context from the current span, then generate the child span from that context.
   SpanContext span_context(kDefaultVersion, getTraceId(), spanId(), sampled(), tracestate());
-  return parent_tracer_.startSpan(name, start_time, span_context, {},
-                                  ::opentelemetry::proto::trace::v1::Span::SPAN_KIND_CLIENT);
+  Tracing::SpanPtr child =
+      parent_tracer_.startSpan(name, start_time, span_context, {},
+                               ::opentelemetry::proto::trace::v1::Span::SPAN_KIND_CLIENT);
+  static_cast<Span&>(*child).local_root_ = false;
+  return child;
 }
 
 void Span::finishSpan() {
@@ -81,6 +84,10 @@ void Span::finishSpan() {
       std::chrono::nanoseconds(time_source_.systemTime().time_since_epoch()).count());
   if (sampled()) {
     parent_tracer_.sendSpan(span_);
+  } else if (parent_tracer_.tailSampling()) {
+    // The tail sampler gets a copy, as the ids of the span remain readable once it has finished,
+    // e.g. by the %TRACE_ID% access log command.
+    parent_tracer_.sendUnsampledSpan(::opentelemetry::proto::trace::v1::Span(span_), local_root_);
   }
 }
 
@@ -181,9 +188,11 @@ void Span::setTag(absl::string_view name, absl::string_view value) {
 Tracer::Tracer(OpenTelemetryTraceExporterPtr exporter, Envoy::TimeSource& time_source,
                Random::RandomGenerator& random, Runtime::Loader& runtime,
                Event::Dispatcher& dispatcher, OpenTelemetryTracerStats tracing_stats,
-               const ResourceConstSharedPtr resource, SamplerSharedPtr sampler)
+               const ResourceConstSharedPtr resource, SamplerSharedPtr sampler,
+               TailSamplerPtr tail_sampler)
     : exporter_(std::move(exporter)), time_source_(time_source), random_(random), runtime_(runtime),
-      tracing_stats_(tracing_stats), resource_(resource), sampler_(sampler) {
+      tracing_stats_(tracing_stats), resource_(resource), sampler_(sampler),
+      tail_sampler_(std::move(tail_sampler)) {
   flush_timer_ = dispatcher.createTimer([this]() -> void {
     tracing_stats_.timer_flushed_.inc();
     flushSpans();
@@ -243,6 +252,23 @@ void Tracer::flushSpans() {
 
 void Tracer::sendSpan(::opentelemetry::proto::trace::v1::Span& span) {
   span_buffer_.push_back(span);
+  maybeFlushSpans();
+}
+
+void Tracer::sendUnsampledSpan(::opentelemetry::proto::trace::v1::Span&& span, bool local_root) {
+  ASSERT(tail_sampler_ != nullptr);
+  std::vector<::opentelemetry::proto::trace::v1::Span> kept =
+      tail_sampler_->onSpanFinished(std::move(span), local_root);
+  if (kept.empty()) {
+    return;
+  }
+  for (auto& kept_span : kept) {
+    span_buffer_.push_back(std::move(kept_span));
+  }
+  maybeFlushSpans();
+}
+
+void Tracer::maybeFlushSpans() {
   const uint64_t min_flush_spans =
       runtime_.snapshot().getInteger("tracing.opentelemetry.min_flush_spans", 5U);
   if (span_buffer_.size() >= min_flush_spans) {
@@ -15,6 +15,7 @@
 #include "source/extensions/tracers/opentelemetry/resource_detectors/resource_detector.h"
 #include "source/extensions/tracers/opentelemetry/samplers/sampler.h"
 #include "source/extensions/tracers/opentelemetry/span_context.h"
+#include "source/extensions/tracers/opentelemetry/tail_sampler.h"
 
 #include "absl/strings/escaping.h"
 
@@ -39,10 +40,23 @@ public:
   Tracer(OpenTelemetryTraceExporterPtr exporter, Envoy::TimeSource& time_source,
          Random::RandomGenerator& random, Runtime::Loader& runtime, Event::Dispatcher& dispatcher,
          OpenTelemetryTracerStats tracing_stats, const ResourceConstSharedPtr resource,
-         SamplerSharedPtr sampler);
+         SamplerSharedPtr sampler, TailSamplerPtr tail_sampler = nullptr);
 
   void sendSpan(::opentelemetry::proto::trace::v1::Span& span);
 
+  /**
+   * @return whether finished spans which weren't sampled are handed to a tail sampler.
+   */
+  bool tailSampling() const { return tail_sampler_ != nullptr; }
+
+  /**
+   * Hands a finished span which wasn't sampled to the tail sampler. The spans of its trace are
+   * sent if the tail sampler keeps it.
+   * @param span the finished span.
+   * @param local_root whether the span is the first one which Envoy started for the request.
+   */
+  void sendUnsampledSpan(::opentelemetry::proto::trace::v1::Span&& span, bool local_root);
+
   Tracing::SpanPtr startSpan(const std::string& operation_name, SystemTime start_time,
 
                              Tracing::Decision tracing_decision,
@@ -59,6 +73,10 @@ private:
    * Enables the span-flushing timer.
    */
   void enableTimer();
+  /**
+   * Flushes the span buffer if it holds enough spans.
+   */
+  void maybeFlushSpans();
   /*
    * Removes all spans from the span buffer and sends them to the collector.
    */
@@ -73,6 +91,7 @@ private:
   OpenTelemetryTracerStats tracing_stats_;
   const ResourceConstSharedPtr resource_;
   SamplerSharedPtr sampler_;
+  TailSamplerPtr tail_sampler_;
 };
 
 /**
@@ -168,6 +187,8 @@ private:
   Tracer& parent_tracer_;
   Envoy::TimeSource& time_source_;
   bool sampled_;
+  // Whether this is the first span which Envoy started for the request, rather than a child.
+  bool local_root_{true};
 };
 
 using TracerPtr = std::unique_ptr<Tracer>;
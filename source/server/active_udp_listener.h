@@ -15,7 +15,10 @@
 namespace Envoy {
 namespace Server {
 
-#define ALL_UDP_LISTENER_STATS(COUNTER) COUNTER(downstream_rx_datagram_dropped)
+#define ALL_UDP_LISTENER_STATS(COUNTER)                                                            \
+  COUNTER(downstream_rx_datagram_dropped)                                                          \
+  COUNTER(downstream_rx_datagram_forwarded)                                                        \
+  COUNTER(downstream_rx_datagram_misrouted)
 
 /**
  * Wrapper struct for UDP listener stats. @see stats_macros.h
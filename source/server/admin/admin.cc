@@ -127,11 +127,11 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server,
           makeHandler("/", "Admin home page", MAKE_ADMIN_HANDLER(handlerAdminHome), false, false),
           makeHandler("/certs", "print certs on machine",
                       MAKE_ADMIN_HANDLER(server_info_handler_.handlerCerts), false, false),
-          makeHandler("/clusters", "upstream cluster status",
-                      MAKE_ADMIN_HANDLER(clusters_handler_.handlerClusters), false, false),
-          makeHandler(
-              "/config_dump", "dump current Envoy configs (experimental)",
-              MAKE_ADMIN_HANDLER(config_dump_handler_.handlerConfigDump), false, false,
+          makeStreamingHandler("/clusters", "upstream cluster status", clusters_handler_, false,
+                               false),
+          makeStreamingHandler(
+              "/config_dump", "dump current Envoy configs (experimental)", config_dump_handler_,
+              false, false,
               {{Admin::ParamDescriptor::Type::String, "resource", "The resource to dump"},
                {Admin::ParamDescriptor::Type::String, "mask",
                 "The mask to apply. When both resource and mask are specified, "
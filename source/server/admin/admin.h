@@ -266,16 +266,21 @@ private:
    * @param removeable indicates whether the handler can be removed after being added
    * @param mutates_state indicates whether the handler will mutate state and therefore
    *                      must be accessed via HTTP POST rather than GET.
+   * @param params the query parameters accepted by the handler.
    * @return the UrlHandler.
    */
   template <class Handler>
   UrlHandler makeStreamingHandler(const std::string& prefix, const std::string& help_text,
-                                  Handler& handler, bool removable, bool mutates_state) {
-    return {prefix, help_text,
+                                  Handler& handler, bool removable, bool mutates_state,
+                                  const ParamDescriptorVec& params = {}) {
+    return {prefix,
+            help_text,
             [&handler](AdminStream& admin_stream) -> Admin::RequestPtr {
               return handler.makeRequest(admin_stream);
             },
-            removable, mutates_state};
+            removable,
+            mutates_state,
+            params};
   }
 
   /**
@@ -37,6 +37,8 @@ Http::FilterTrailersStatus AdminFilter::decodeTrailers(Http::RequestTrailerMap&)
 }
 
 void AdminFilter::onDestroy() {
+  next_chunk_cb_.reset();
+  request_.reset();
   for (const auto& callback : on_destroy_callbacks_) {
     callback();
   }
@@ -86,24 +88,34 @@ void AdminFilter::onComplete() {
 
   auto header_map = Http::ResponseHeaderMapImpl::create();
   RELEASE_ASSERT(request_headers_, "");
-  Admin::RequestPtr handler = admin_.makeRequest(*this);
-  Http::Code code = handler->start(*header_map);
+  request_ = admin_.makeRequest(*this);
+  Http::Code code = request_->start(*header_map);
   Utility::populateFallbackResponseHeaders(code, *header_map);
   decoder_callbacks_->encodeHeaders(std::move(header_map), false,
                                     StreamInfo::ResponseCodeDetails::get().AdminFilterResponse);
+  nextChunk();
+}
 
+void AdminFilter::nextChunk() {
   // TODO(#31087): use high/lower watermarks to apply flow-control to the admin http port.
-  bool more_data;
-  do {
-    Buffer::OwnedImpl response;
-    more_data = handler->nextChunk(response);
-    bool end_stream = end_stream_on_complete_ && !more_data;
-    ENVOY_LOG_MISC(debug, "nextChunk: response.length={} more_data={} end_stream={}",
-                   response.length(), more_data, end_stream);
-    if (response.length() > 0 || end_stream) {
-      decoder_callbacks_->encodeData(response, end_stream);
-    }
-  } while (more_data);
+  Buffer::OwnedImpl response;
+  const bool more_data = request_->nextChunk(response);
+  const bool end_stream = end_stream_on_complete_ && !more_data;
+  ENVOY_LOG_MISC(debug, "nextChunk: response.length={} more_data={} end_stream={}",
+                 response.length(), more_data, end_stream);
+  if (response.length() > 0 || end_stream) {
+    decoder_callbacks_->encodeData(response, end_stream);
+  }
+  if (!more_data || request_ == nullptr) {
+    // The stream may have been destroyed while the data was encoded.
+    request_.reset();
+    return;
+  }
+  if (next_chunk_cb_ == nullptr) {
+    next_chunk_cb_ =
+        decoder_callbacks_->dispatcher().createSchedulableCallback([this]() { nextChunk(); });
+  }
+  next_chunk_cb_->scheduleCallbackNextIteration();
 }
 
 } // namespace Server
@@ -3,6 +3,7 @@
 #include <functional>
 #include <list>
 
+#include "envoy/event/schedulable_cb.h"
 #include "envoy/http/filter.h"
 #include "envoy/server/admin.h"
 
@@ -64,7 +65,17 @@ private:
    * Called when an admin request has been completely received.
    */
   void onComplete();
+
+  /**
+   * Encodes the next chunk of the response. If there is more data, the following chunk is
+   * encoded in the next dispatcher iteration, so that the response of large handlers is written
+   * to the connection as it is produced, rather than all at once.
+   */
+  void nextChunk();
+
   const Admin& admin_;
+  Admin::RequestPtr request_;
+  Event::SchedulableCallbackPtr next_chunk_cb_;
   Http::RequestHeaderMap* request_headers_{};
   std::list<std::function<void()>> on_destroy_callbacks_;
   bool end_stream_on_complete_ = true;
@@ -5,6 +5,7 @@
 #include "source/common/http/headers.h"
 #include "source/common/http/utility.h"
 #include "source/common/network/utility.h"
+#include "source/common/runtime/runtime_features.h"
 #include "source/common/upstream/host_utility.h"
 #include "source/server/admin/utils.h"
 
@@ -27,9 +28,24 @@ void addCircuitBreakerSettingsAsText(const std::string& cluster_name,
                            resource_manager.retries().max()));
 }
 
-void addCircuitBreakerSettingsAsJson(const envoy::config::core::v3::RoutingPriority& priority,
+void addCircuitBreakerSettingsAsJson(absl::string_view priority,
                                      Upstream::ResourceManager& resource_manager,
-                                     envoy::admin::v3::ClusterStatus& cluster_status) {
+                                     Json::BufferStreamer::Array& thresholds) {
+  Json::BufferStreamer::MapPtr threshold = thresholds.addMap();
+  // The default priority is omitted, as it would be for the proto.
+  if (!priority.empty()) {
+    threshold->addEntries({{"priority", priority}});
+  }
+  threshold->addEntries(
+      {{"max_connections", resource_manager.connections().max()},
+       {"max_pending_requests", resource_manager.pendingRequests().max()},
+       {"max_requests", resource_manager.requests().max()},
+       {"max_retries", resource_manager.retries().max()}});
+}
+
+void addCircuitBreakerSettingsAsProto(const envoy::config::core::v3::RoutingPriority& priority,
+                                      Upstream::ResourceManager& resource_manager,
+                                      envoy::admin::v3::ClusterStatus& cluster_status) {
   auto& thresholds = *cluster_status.mutable_circuit_breakers()->add_thresholds();
   thresholds.set_priority(priority);
   thresholds.mutable_max_connections()->set_value(resource_manager.connections().max());
@@ -38,22 +54,105 @@ void addCircuitBreakerSettingsAsJson(const envoy::config::core::v3::RoutingPrior
   thresholds.mutable_max_retries()->set_value(resource_manager.retries().max());
 }
 
+// The pretty-printed JSON rendering of /clusters, which is built as a whole before the request
+// starts.
+class ClustersPrettyJsonRequest : public Admin::Request {
+public:
+  explicit ClustersPrettyJsonRequest(Buffer::Instance& response) { response_.move(response); }
+
+  // Admin::Request
+  Http::Code start(Http::ResponseHeaderMap& response_headers) override {
+    response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
+    return Http::Code::OK;
+  }
+  bool nextChunk(Buffer::Instance& response) override {
+    response.move(response_);
+    return false;
+  }
+
+private:
+  Buffer::OwnedImpl response_;
+};
+
+// Adds an envoy.type.v3.Percent.
+void addPercentAsJson(absl::string_view key, double value, Json::BufferStreamer::Map& map) {
+  map.addKey(key);
+  map.addMap()->addEntries({{"value", value}});
+}
+
+// Adds an envoy.config.core.v3.Address, matching Network::Utility::addressToProtobufAddress().
+void addAddressAsJson(const Network::Address::Instance& address, Json::BufferStreamer::Map& map) {
+  map.addKey("address");
+  Json::BufferStreamer::MapPtr address_map = map.addMap();
+  switch (address.type()) {
+  case Network::Address::Type::Pipe:
+    address_map->addKey("pipe");
+    address_map->addMap()->addEntries({{"path", address.asStringView()}});
+    break;
+  case Network::Address::Type::Ip: {
+    address_map->addKey("socket_address");
+    Json::BufferStreamer::MapPtr socket_address = address_map->addMap();
+    socket_address->addEntries({{"address", address.ip()->addressAsString()}});
+    if (address.ip()->port() != 0) {
+      socket_address->addEntries({{"port_value", static_cast<uint64_t>(address.ip()->port())}});
+    }
+    break;
+  }
+  case Network::Address::Type::EnvoyInternal: {
+    address_map->addKey("envoy_internal_address");
+    Json::BufferStreamer::MapPtr internal_address = address_map->addMap();
+    internal_address->addEntries(
+        {{"server_listener_name", address.envoyInternalAddress()->addressId()}});
+    // Like the proto JSON rendering, an empty endpoint id is omitted.
+    if (!address.envoyInternalAddress()->endpointId().empty()) {
+      internal_address->addEntries({{"endpoint_id", address.envoyInternalAddress()->endpointId()}});
+    }
+    break;
+  }
+  }
+}
+
+// Adds an envoy.admin.v3.HostHealthStatus, omitting the fields that are not set.
+void addHealthStatusAsJson(const envoy::admin::v3::HostHealthStatus& health_status,
+                           Json::BufferStreamer::Map& map) {
+  map.addKey("health_status");
+  Json::BufferStreamer::MapPtr health_map = map.addMap();
+  const auto add_flag = [&health_map](absl::string_view name, bool value) {
+    if (value) {
+      health_map->addEntries({{name, true}});
+    }
+  };
+  add_flag("failed_active_health_check", health_status.failed_active_health_check());
+  add_flag("failed_outlier_check", health_status.failed_outlier_check());
+  if (health_status.eds_health_status() != envoy::config::core::v3::UNKNOWN) {
+    health_map->addEntries(
+        {{"eds_health_status",
+          envoy::config::core::v3::HealthStatus_Name(health_status.eds_health_status())}});
+  }
+  add_flag("failed_active_degraded_check", health_status.failed_active_degraded_check());
+  add_flag("pending_dynamic_removal", health_status.pending_dynamic_removal());
+  add_flag("pending_active_hc", health_status.pending_active_hc());
+  add_flag("excluded_via_immediate_hc_fail", health_status.excluded_via_immediate_hc_fail());
+  add_flag("active_hc_timeout", health_status.active_hc_timeout());
+}
+
 } // namespace
 
 ClustersHandler::ClustersHandler(Server::Instance& server) : HandlerContextBase(server) {}
 
-Http::Code ClustersHandler::handlerClusters(Http::ResponseHeaderMap& response_headers,
-                                            Buffer::Instance& response, AdminStream& admin_stream) {
+Admin::RequestPtr ClustersHandler::makeRequest(AdminStream& admin_stream) {
   const auto format_value = Utility::formatParam(admin_stream.queryParams());
 
+  Buffer::OwnedImpl response;
   if (format_value.has_value() && format_value.value() == "json") {
+    if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.admin_stream_clusters_json")) {
+      return std::make_unique<ClustersJsonRequest>(server_.clusterManager());
+    }
     writeClustersAsJson(response);
-    response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
-  } else {
-    writeClustersAsText(response);
+    return std::make_unique<ClustersPrettyJsonRequest>(response);
   }
-
-  return Http::Code::OK;
+  writeClustersAsText(response);
+  return Admin::makeStaticTextRequest(response, Http::Code::OK);
 }
 
 // Helper method that ensures that we've setting flags based on all the health flag values on the
@@ -107,6 +206,179 @@ void setHealthFlag(Upstream::Host::HealthFlag flag, const Upstream::Host& host,
   }
 }
 
+ClustersJsonRequest::ClustersJsonRequest(const Upstream::ClusterManager& cluster_manager)
+    : cluster_manager_(cluster_manager) {}
+
+Http::Code ClustersJsonRequest::start(Http::ResponseHeaderMap& response_headers) {
+  response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
+
+  // TODO(mattklein123): Add ability to see warming clusters in admin output.
+  const Upstream::ClusterManager::ClusterInfoMaps all_clusters = cluster_manager_.clusters();
+  cluster_names_.reserve(all_clusters.active_clusters_.size());
+  for (const auto& [name, cluster_ref] : all_clusters.active_clusters_) {
+    UNREFERENCED_PARAMETER(cluster_ref);
+    cluster_names_.push_back(name);
+  }
+
+  // Like the JSON rendering of the proto, an empty list of clusters is omitted.
+  clusters_map_ = streamer_.makeRootMap();
+  if (!cluster_names_.empty()) {
+    clusters_map_->addKey("cluster_statuses");
+    cluster_statuses_ = clusters_map_->addArray();
+  }
+  return Http::Code::OK;
+}
+
+bool ClustersJsonRequest::nextChunk(Buffer::Instance& response) {
+  while (response_.length() < chunk_size_ && next_cluster_ < cluster_names_.size()) {
+    const Upstream::ClusterConstOptRef cluster =
+        cluster_manager_.getActiveCluster(cluster_names_[next_cluster_++]);
+    if (cluster.has_value()) {
+      addCluster(cluster->get());
+    }
+  }
+
+  const bool more_data = next_cluster_ < cluster_names_.size();
+  if (!more_data) {
+    // Close the array and the map, in that order.
+    cluster_statuses_.reset();
+    clusters_map_.reset();
+  }
+  response.move(response_);
+  return more_data;
+}
+
+// TODO(efimki): Add support of text readouts stats.
+void ClustersJsonRequest::addCluster(const Upstream::Cluster& cluster) {
+  Upstream::ClusterInfoConstSharedPtr cluster_info = cluster.info();
+  Json::BufferStreamer::MapPtr cluster_map = cluster_statuses_->addMap();
+
+  // Fields are rendered in the order of the ClusterStatus proto, and fields
+  // with default values are omitted.
+  cluster_map->addEntries({{"name", cluster_info->name()}});
+  if (cluster_info->addedViaApi()) {
+    cluster_map->addEntries({{"added_via_api", true}});
+  }
+
+  const Upstream::Outlier::Detector* outlier_detector = cluster.outlierDetector();
+  if (outlier_detector != nullptr &&
+      outlier_detector->successRateEjectionThreshold(
+          Upstream::Outlier::DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin) > 0.0) {
+    addPercentAsJson("success_rate_ejection_threshold",
+                     outlier_detector->successRateEjectionThreshold(
+                         Upstream::Outlier::DetectorHostMonitor::SuccessRateMonitorType::
+                             ExternalOrigin),
+                     *cluster_map);
+  }
+
+  bool has_hosts = false;
+  for (auto& host_set : cluster.prioritySet().hostSetsPerPriority()) {
+    has_hosts = has_hosts || !host_set->hosts().empty();
+  }
+  if (has_hosts) {
+    cluster_map->addKey("host_statuses");
+    Json::BufferStreamer::ArrayPtr host_statuses = cluster_map->addArray();
+    for (auto& host_set : cluster.prioritySet().hostSetsPerPriority()) {
+      for (auto& host : host_set->hosts()) {
+        addHost(*host, *host_statuses->addMap());
+      }
+    }
+  }
+
+  if (outlier_detector != nullptr &&
+      outlier_detector->successRateEjectionThreshold(
+          Upstream::Outlier::DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin) > 0.0) {
+    addPercentAsJson(
+        "local_origin_success_rate_ejection_threshold",
+        outlier_detector->successRateEjectionThreshold(
+            Upstream::Outlier::DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin),
+        *cluster_map);
+  }
+
+  cluster_map->addKey("circuit_breakers");
+  {
+    Json::BufferStreamer::MapPtr circuit_breakers = cluster_map->addMap();
+    circuit_breakers->addKey("thresholds");
+    Json::BufferStreamer::ArrayPtr thresholds = circuit_breakers->addArray();
+    addCircuitBreakerSettingsAsJson(
+        "", cluster_info->resourceManager(Upstream::ResourcePriority::Default), *thresholds);
+    addCircuitBreakerSettingsAsJson(
+        "HIGH", cluster_info->resourceManager(Upstream::ResourcePriority::High), *thresholds);
+  }
+
+  if (const auto& name = cluster_info->observabilityName(); !name.empty()) {
+    cluster_map->addEntries({{"observability_name", name}});
+  }
+  if (const auto& name = cluster_info->edsServiceName(); !name.empty()) {
+    cluster_map->addEntries({{"eds_service_name", name}});
+  }
+}
+
+void ClustersJsonRequest::addHost(const Upstream::Host& host,
+                                  Json::BufferStreamer::Map& host_map) {
+  addAddressAsJson(*host.address(), host_map);
+
+  const auto counters = host.counters();
+  const auto gauges = host.gauges();
+  if (!counters.empty() || !gauges.empty()) {
+    host_map.addKey("stats");
+    Json::BufferStreamer::ArrayPtr stats = host_map.addArray();
+    // As in the JSON rendering of SimpleMetric, the uint64 values are strings.
+    for (const auto& [counter_name, counter] : counters) {
+      stats->addMap()->addEntries({{"name", counter_name},
+                                   {"value", absl::StrCat(counter.get().value())},
+                                   {"type", absl::string_view("COUNTER")}});
+    }
+    for (const auto& [gauge_name, gauge] : gauges) {
+      stats->addMap()->addEntries({{"name", gauge_name},
+                                   {"value", absl::StrCat(gauge.get().value())},
+                                   {"type", absl::string_view("GAUGE")}});
+    }
+  }
+
+  envoy::admin::v3::HostHealthStatus health_status;
+
+// Invokes setHealthFlag for each health flag.
+#define SET_HEALTH_FLAG(name, notused)                                                             \
+  setHealthFlag(Upstream::Host::HealthFlag::name, host, health_status);
+  HEALTH_FLAG_ENUM_VALUES(SET_HEALTH_FLAG)
+#undef SET_HEALTH_FLAG
+  addHealthStatusAsJson(health_status, host_map);
+
+  double success_rate = host.outlierDetector().successRate(
+      Upstream::Outlier::DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin);
+  if (success_rate >= 0.0) {
+    addPercentAsJson("success_rate", success_rate, host_map);
+  }
+  if (host.weight() != 0) {
+    host_map.addEntries({{"weight", static_cast<uint64_t>(host.weight())}});
+  }
+  if (!host.hostname().empty()) {
+    host_map.addEntries({{"hostname", host.hostname()}});
+  }
+  if (host.priority() != 0) {
+    host_map.addEntries({{"priority", static_cast<uint64_t>(host.priority())}});
+  }
+  success_rate = host.outlierDetector().successRate(
+      Upstream::Outlier::DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin);
+  if (success_rate >= 0.0) {
+    addPercentAsJson("local_origin_success_rate", success_rate, host_map);
+  }
+
+  const envoy::config::core::v3::Locality& locality = host.locality();
+  host_map.addKey("locality");
+  Json::BufferStreamer::MapPtr locality_map = host_map.addMap();
+  const auto add_locality_field = [&locality_map](absl::string_view name,
+                                                  const std::string& value) {
+    if (!value.empty()) {
+      locality_map->addEntries({{name, value}});
+    }
+  };
+  add_locality_field("region", locality.region());
+  add_locality_field("zone", locality.zone());
+  add_locality_field("sub_zone", locality.sub_zone());
+}
+
 // TODO(efimki): Add support of text readouts stats.
 void ClustersHandler::writeClustersAsJson(Buffer::Instance& response) {
   envoy::admin::v3::Clusters clusters;
@@ -123,10 +395,10 @@ void ClustersHandler::writeClustersAsJson(Buffer::Instance& response) {
     if (const auto& name = cluster_info->edsServiceName(); !name.empty()) {
       cluster_status.set_eds_service_name(name);
     }
-    addCircuitBreakerSettingsAsJson(
+    addCircuitBreakerSettingsAsProto(
         envoy::config::core::v3::RoutingPriority::DEFAULT,
         cluster.info()->resourceManager(Upstream::ResourcePriority::Default), cluster_status);
-    addCircuitBreakerSettingsAsJson(
+    addCircuitBreakerSettingsAsProto(
         envoy::config::core::v3::RoutingPriority::HIGH,
         cluster.info()->resourceManager(Upstream::ResourcePriority::High), cluster_status);
 
@@ -7,6 +7,8 @@
 #include "envoy/server/admin.h"
 #include "envoy/server/instance.h"
 
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/json/json_streamer.h"
 #include "source/server/admin/handler_ctx.h"
 
 #include "absl/strings/string_view.h"
@@ -24,18 +26,52 @@ namespace Server {
 void setHealthFlag(Upstream::Host::HealthFlag flag, const Upstream::Host& host,
                    envoy::admin::v3::HostHealthStatus& health_status);
 
+// Streams the JSON rendering of /clusters, which has the structure of an
+// envoy::admin::v3::Clusters message, a bounded number of bytes at a time. The
+// JSON is written directly from the clusters, so neither the proto nor the
+// complete JSON string for all clusters is held in memory.
+class ClustersJsonRequest : public Admin::Request {
+public:
+  static constexpr uint64_t DefaultChunkSize = 2 * 1000 * 1000;
+
+  ClustersJsonRequest(const Upstream::ClusterManager& cluster_manager);
+
+  // Admin::Request
+  Http::Code start(Http::ResponseHeaderMap& response_headers) override;
+  bool nextChunk(Buffer::Instance& response) override;
+
+  // Sets the chunk size.
+  void setChunkSize(uint64_t chunk_size) { chunk_size_ = chunk_size; }
+
+private:
+  void addCluster(const Upstream::Cluster& cluster);
+  void addHost(const Upstream::Host& host, Json::BufferStreamer::Map& host_map);
+
+  const Upstream::ClusterManager& cluster_manager_;
+  // The names of the clusters to render, captured at the start of the request.
+  // Each cluster is looked up by name when it is rendered, as it may have been
+  // removed in the meantime.
+  std::vector<std::string> cluster_names_;
+  size_t next_cluster_{0};
+  Buffer::OwnedImpl response_;
+  Json::BufferStreamer streamer_{response_};
+  Json::BufferStreamer::MapPtr clusters_map_;
+  Json::BufferStreamer::ArrayPtr cluster_statuses_;
+  uint64_t chunk_size_{DefaultChunkSize};
+};
+
 class ClustersHandler : public HandlerContextBase {
 
 public:
   ClustersHandler(Server::Instance& server);
 
-  Http::Code handlerClusters(Http::ResponseHeaderMap& response_headers, Buffer::Instance& response,
-                             AdminStream&);
+  Admin::RequestPtr makeRequest(AdminStream& admin_stream);
 
 private:
   void addOutlierInfo(const std::string& cluster_name,
                       const Upstream::Outlier::Detector* outlier_detector,
                       Buffer::Instance& response);
+  // Renders the pretty-printed JSON output of /clusters, when it isn't streamed.
   void writeClustersAsJson(Buffer::Instance& response);
   void writeClustersAsText(Buffer::Instance& response);
 };
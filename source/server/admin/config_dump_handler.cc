@@ -1,5 +1,7 @@
 #include "source/server/admin/config_dump_handler.h"
 
+#include <algorithm>
+
 #include "envoy/config/core/v3/health_check.pb.h"
 #include "envoy/config/endpoint/v3/endpoint.pb.h"
 
@@ -11,6 +13,9 @@
 #include "source/common/network/utility.h"
 #include "source/server/admin/utils.h"
 
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -146,51 +151,114 @@ buildNameMatcher(const Http::Utility::QueryParamsMulti& params, Regex::Engine& e
 
 } // namespace
 
-ConfigDumpHandler::ConfigDumpHandler(ConfigTracker& config_tracker, Server::Instance& server)
-    : HandlerContextBase(server), config_tracker_(config_tracker) {}
+ConfigDumpRequest::ConfigDumpRequest(const ConfigDumpHandler& handler,
+                                     Http::Utility::QueryParamsMulti&& query_params)
+    : handler_(handler), query_params_(std::move(query_params)) {}
 
-Http::Code ConfigDumpHandler::handlerConfigDump(Http::ResponseHeaderMap& response_headers,
-                                                Buffer::Instance& response,
-                                                AdminStream& admin_stream) const {
-  Http::Utility::QueryParamsMulti query_params = admin_stream.queryParams();
+Http::Code ConfigDumpRequest::start(Http::ResponseHeaderMap& response_headers) {
   const absl::optional<std::string> resource =
-      Utility::nonEmptyQueryParam(query_params, "resource");
-  const absl::optional<std::string> mask = Utility::nonEmptyQueryParam(query_params, "mask");
-  const bool include_eds = shouldIncludeEdsInDump(query_params);
-  const absl::StatusOr<Matchers::StringMatcherPtr> name_matcher =
-      buildNameMatcher(query_params, server_.regexEngine());
+      Utility::nonEmptyQueryParam(query_params_, "resource");
+  const absl::optional<std::string> mask = Utility::nonEmptyQueryParam(query_params_, "mask");
+  include_eds_ = shouldIncludeEdsInDump(query_params_);
+  absl::StatusOr<Matchers::StringMatcherPtr> name_matcher =
+      buildNameMatcher(query_params_, handler_.server_.regexEngine());
   if (!name_matcher.ok()) {
-    response.add(name_matcher.status().ToString());
+    error_response_.add(name_matcher.status().ToString());
     response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Text);
     return Http::Code::BadRequest;
   }
+  name_matcher_ = std::move(*name_matcher);
 
-  envoy::admin::v3::ConfigDump dump;
-
+  // Resources and masks are applied to all configs before the response is started, so that
+  // errors can still be reported in the response code.
   absl::optional<std::pair<Http::Code, std::string>> err;
   if (resource.has_value()) {
-    err = addResourceToDump(dump, mask, resource.value(), **name_matcher, include_eds);
+    err = handler_.addResourceToDump(configs_, mask, resource.value(), *name_matcher_,
+                                     include_eds_);
+  } else if (mask.has_value()) {
+    err = handler_.addMaskedConfigsToDump(configs_, mask.value(), *name_matcher_, include_eds_);
   } else {
-    err = addAllConfigToDump(dump, mask, **name_matcher, include_eds);
+    for (const auto& [name, callback] : handler_.callbacksMap(include_eds_)) {
+      UNREFERENCED_PARAMETER(callback);
+      callback_names_.push_back(name);
+    }
   }
   if (err.has_value()) {
     response_headers.addReference(Http::Headers::get().XContentTypeOptions,
                                   Http::Headers::get().XContentTypeOptionValues.Nosniff);
     response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Text);
-    response.add(err.value().second);
+    error_response_.add(err.value().second);
     return err.value().first;
   }
-  MessageUtil::redact(dump);
 
   response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
-  response.add(MessageUtil::getJsonStringFromMessageOrError(dump, true)); // pretty-print
   return Http::Code::OK;
 }
 
-absl::optional<std::pair<Http::Code, std::string>> ConfigDumpHandler::addResourceToDump(
-    envoy::admin::v3::ConfigDump& dump, const absl::optional<std::string>& mask,
-    const std::string& resource, const Matchers::StringMatcher& name_matcher,
-    bool include_eds) const {
+bool ConfigDumpRequest::nextChunk(Buffer::Instance& response) {
+  if (name_matcher_ == nullptr || error_response_.length() > 0) {
+    response.move(error_response_);
+    return false;
+  }
+  while (response.length() < chunk_size_) {
+    ProtobufTypes::MessagePtr config = nextConfig();
+    if (config == nullptr) {
+      // Matches the pretty-printed JSON of an empty or non-empty ConfigDump.
+      response.add(has_configs_ ? "\n ]\n}\n" : "{}\n");
+      return false;
+    }
+    addConfig(*config, response);
+  }
+  return true;
+}
+
+ProtobufTypes::MessagePtr ConfigDumpRequest::nextConfig() {
+  if (next_config_ < configs_.size()) {
+    return std::move(configs_[next_config_++]);
+  }
+  // The callbacks are looked up again for each config, as their owners may have been removed
+  // while the response was streamed.
+  while (next_callback_ < callback_names_.size()) {
+    const ConfigTracker::CbsMap callbacks_map = handler_.callbacksMap(include_eds_);
+    auto iter = callbacks_map.find(callback_names_[next_callback_++]);
+    if (iter != callbacks_map.end()) {
+      ProtobufTypes::MessagePtr message = iter->second(*name_matcher_);
+      ASSERT(message);
+      return message;
+    }
+  }
+  return nullptr;
+}
+
+void ConfigDumpRequest::addConfig(Protobuf::Message& config, Buffer::Instance& response) {
+  MessageUtil::redact(config);
+  ProtobufWkt::Any any;
+  any.PackFrom(config);
+  response.add(has_configs_ ? ",\n" : "{\n \"configs\": [\n");
+  has_configs_ = true;
+
+  // The pretty-printed JSON of the config is nested two levels deeper in the dump. Line breaks
+  // within JSON strings are escaped, so every line break starts a new line of the config.
+  std::string json = MessageUtil::getJsonStringFromMessageOrError(any, true);
+  absl::string_view lines(json);
+  lines = absl::StripSuffix(lines, "\n");
+  for (absl::string_view line : absl::StrSplit(lines, '\n')) {
+    if (line.data() != lines.data()) {
+      response.add("\n");
+    }
+    response.add("  ");
+    response.add(line);
+  }
+}
+
+ConfigDumpHandler::ConfigDumpHandler(ConfigTracker& config_tracker, Server::Instance& server)
+    : HandlerContextBase(server), config_tracker_(config_tracker) {}
+
+Admin::RequestPtr ConfigDumpHandler::makeRequest(AdminStream& admin_stream) const {
+  return std::make_unique<ConfigDumpRequest>(*this, admin_stream.queryParams());
+}
+
+ConfigTracker::CbsMap ConfigDumpHandler::callbacksMap(bool include_eds) const {
   Envoy::Server::ConfigTracker::CbsMap callbacks_map = config_tracker_.getCallbacksMap();
   if (include_eds) {
     // TODO(mattklein123): Add ability to see warming clusters in admin output.
@@ -201,8 +269,14 @@ absl::optional<std::pair<Http::Code, std::string>> ConfigDumpHandler::addResourc
       });
     }
   }
+  return callbacks_map;
+}
 
-  for (const auto& [name, callback] : callbacks_map) {
+absl::optional<std::pair<Http::Code, std::string>> ConfigDumpHandler::addResourceToDump(
+    std::vector<ProtobufTypes::MessagePtr>& configs, const absl::optional<std::string>& mask,
+    const std::string& resource, const Matchers::StringMatcher& name_matcher,
+    bool include_eds) const {
+  for (const auto& [name, callback] : callbacksMap(include_eds)) {
     UNREFERENCED_PARAMETER(name);
     ProtobufTypes::MessagePtr message = callback(name_matcher);
     ASSERT(message);
@@ -218,19 +292,22 @@ absl::optional<std::pair<Http::Code, std::string>> ConfigDumpHandler::addResourc
                       field_descriptor->name(), field_descriptor->name()))};
     }
 
-    auto repeated = reflection->GetRepeatedPtrField<Protobuf::Message>(*message, field_descriptor);
-    for (Protobuf::Message& msg : repeated) {
-      if (mask.has_value()) {
-        Protobuf::FieldMask field_mask;
-        ProtobufUtil::FieldMaskUtil::FromString(mask.value(), &field_mask);
-        if (!trimResourceMessage(field_mask, msg)) {
+    // Take ownership of the resources rather than copying them; they are released from the back.
+    const size_t first = configs.size();
+    while (reflection->FieldSize(*message, field_descriptor) > 0) {
+      configs.emplace_back(reflection->ReleaseLast(message.get(), field_descriptor));
+    }
+    std::reverse(configs.begin() + first, configs.end());
+    if (mask.has_value()) {
+      Protobuf::FieldMask field_mask;
+      ProtobufUtil::FieldMaskUtil::FromString(mask.value(), &field_mask);
+      for (auto it = configs.begin() + first; it != configs.end(); ++it) {
+        if (!trimResourceMessage(field_mask, **it)) {
           return absl::optional<std::pair<Http::Code, std::string>>{std::make_pair(
               Http::Code::BadRequest, absl::StrCat("FieldMask ", field_mask.DebugString(),
                                                    " could not be successfully used."))};
         }
       }
-      auto* config = dump.add_configs();
-      config->PackFrom(msg);
     }
 
     // We found the desired resource so there is no need to continue iterating over
@@ -242,44 +319,29 @@ absl::optional<std::pair<Http::Code, std::string>> ConfigDumpHandler::addResourc
       std::make_pair(Http::Code::NotFound, fmt::format("{} not found in config dump", resource))};
 }
 
-absl::optional<std::pair<Http::Code, std::string>> ConfigDumpHandler::addAllConfigToDump(
-    envoy::admin::v3::ConfigDump& dump, const absl::optional<std::string>& mask,
+absl::optional<std::pair<Http::Code, std::string>> ConfigDumpHandler::addMaskedConfigsToDump(
+    std::vector<ProtobufTypes::MessagePtr>& configs, const std::string& mask,
     const Matchers::StringMatcher& name_matcher, bool include_eds) const {
-  Envoy::Server::ConfigTracker::CbsMap callbacks_map = config_tracker_.getCallbacksMap();
-  if (include_eds) {
-    // TODO(mattklein123): Add ability to see warming clusters in admin output.
-    auto all_clusters = server_.clusterManager().clusters();
-    if (!all_clusters.active_clusters_.empty()) {
-      callbacks_map.emplace("endpoint", [this](const Matchers::StringMatcher& name_matcher) {
-        return dumpEndpointConfigs(name_matcher);
-      });
-    }
-  }
-
-  for (const auto& [name, callback] : callbacks_map) {
+  Protobuf::FieldMask field_mask;
+  ProtobufUtil::FieldMaskUtil::FromString(mask, &field_mask);
+  for (const auto& [name, callback] : callbacksMap(include_eds)) {
     UNREFERENCED_PARAMETER(name);
     ProtobufTypes::MessagePtr message = callback(name_matcher);
     ASSERT(message);
 
-    if (mask.has_value()) {
-      Protobuf::FieldMask field_mask;
-      ProtobufUtil::FieldMaskUtil::FromString(mask.value(), &field_mask);
-      // We don't use trimMessage() above here since masks don't support
-      // indexing through repeated fields. We don't return error on failure
-      // because different callback return types will have different valid
-      // field masks.
-      if (!checkFieldMaskAndTrimMessage(field_mask, *message)) {
-        continue;
-      }
+    // We don't use trimMessage() above here since masks don't support
+    // indexing through repeated fields. We don't return error on failure
+    // because different callback return types will have different valid
+    // field masks.
+    if (!checkFieldMaskAndTrimMessage(field_mask, *message)) {
+      continue;
     }
-
-    auto* config = dump.add_configs();
-    config->PackFrom(*message);
+    configs.push_back(std::move(message));
   }
-  if (dump.configs().empty() && mask.has_value()) {
+  if (configs.empty()) {
     return absl::optional<std::pair<Http::Code, std::string>>{std::make_pair(
         Http::Code::BadRequest,
-        absl::StrCat("FieldMask ", *mask, " could not be successfully applied to any configs."))};
+        absl::StrCat("FieldMask ", mask, " could not be successfully applied to any configs."))};
   }
   return absl::nullopt;
 }
@@ -8,6 +8,9 @@
 #include "envoy/server/admin.h"
 #include "envoy/server/instance.h"
 
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/matchers.h"
+#include "source/common/http/utility.h"
 #include "source/server/admin/config_tracker_impl.h"
 #include "source/server/admin/handler_ctx.h"
 
@@ -16,27 +19,84 @@
 namespace Envoy {
 namespace Server {
 
+class ConfigDumpHandler;
+
+// Streams /config_dump, which has the structure of an envoy::admin::v3::ConfigDump
+// message, one config at a time. Unless a resource or a mask is requested, the
+// config tracker callbacks are only invoked when their config is about to be
+// rendered, so at most one of the configs is held in memory, rather than all
+// of them plus the JSON string of the complete dump. The output is the same as
+// the pretty-printed JSON of the complete ConfigDump message.
+class ConfigDumpRequest : public Admin::Request {
+public:
+  static constexpr uint64_t DefaultChunkSize = 2 * 1000 * 1000;
+
+  ConfigDumpRequest(const ConfigDumpHandler& handler,
+                    Http::Utility::QueryParamsMulti&& query_params);
+
+  // Admin::Request
+  Http::Code start(Http::ResponseHeaderMap& response_headers) override;
+  bool nextChunk(Buffer::Instance& response) override;
+
+  // Sets the chunk size. At least one config is added to each chunk.
+  void setChunkSize(uint64_t chunk_size) { chunk_size_ = chunk_size; }
+
+private:
+  // @return the next config to render, or nullptr if all of them were rendered.
+  ProtobufTypes::MessagePtr nextConfig();
+  void addConfig(Protobuf::Message& config, Buffer::Instance& response);
+
+  const ConfigDumpHandler& handler_;
+  const Http::Utility::QueryParamsMulti query_params_;
+  Matchers::StringMatcherPtr name_matcher_;
+  bool include_eds_{};
+  // The names of the config tracker callbacks to invoke, in order.
+  std::vector<std::string> callback_names_;
+  size_t next_callback_{0};
+  // The configs which had to be produced in start(), in order.
+  std::vector<ProtobufTypes::MessagePtr> configs_;
+  size_t next_config_{0};
+  bool has_configs_{false};
+  // The body of an error response.
+  Buffer::OwnedImpl error_response_;
+  uint64_t chunk_size_{DefaultChunkSize};
+};
+
 class ConfigDumpHandler : public HandlerContextBase {
 
 public:
   ConfigDumpHandler(ConfigTracker& config_tracker, Server::Instance& server);
 
-  Http::Code handlerConfigDump(Http::ResponseHeaderMap& response_headers,
-                               Buffer::Instance& response, AdminStream&) const;
+  Admin::RequestPtr makeRequest(AdminStream& admin_stream) const;
 
-private:
+  /**
+   * @return the config tracker callbacks, plus the one for the endpoints of all
+   * clusters if include_eds is set.
+   */
+  ConfigTracker::CbsMap callbacksMap(bool include_eds) const;
+
+  /**
+   * Add the configs of the passed resource to the passed configs.
+   * @return absl::nullopt on success, else the Http::Code and an error message that should be added
+   * to the admin response.
+   */
   absl::optional<std::pair<Http::Code, std::string>>
-  addAllConfigToDump(envoy::admin::v3::ConfigDump& dump, const absl::optional<std::string>& mask,
-                     const Matchers::StringMatcher& name_matcher, bool include_eds) const;
+  addResourceToDump(std::vector<ProtobufTypes::MessagePtr>& configs,
+                    const absl::optional<std::string>& mask, const std::string& resource,
+                    const Matchers::StringMatcher& name_matcher, bool include_eds) const;
+
   /**
-   * Add the config matching the passed resource to the passed config dump.
+   * Add all configs which the passed mask can be applied to, trimmed by the mask, to the
+   * passed configs.
    * @return absl::nullopt on success, else the Http::Code and an error message that should be added
    * to the admin response.
    */
   absl::optional<std::pair<Http::Code, std::string>>
-  addResourceToDump(envoy::admin::v3::ConfigDump& dump, const absl::optional<std::string>& mask,
-                    const std::string& resource, const Matchers::StringMatcher& name_matcher,
-                    bool include_eds) const;
+  addMaskedConfigsToDump(std::vector<ProtobufTypes::MessagePtr>& configs, const std::string& mask,
+                         const Matchers::StringMatcher& name_matcher, bool include_eds) const;
+
+private:
+  friend class ConfigDumpRequest;
 
   /**
    * Helper methods to add endpoints config
@@ -143,15 +143,32 @@ void HotRestartImpl::sendParentTerminateRequest() { as_child_.sendParentTerminat
 
 HotRestart::ServerStatsFromParent
 HotRestartImpl::mergeParentStatsIfAny(Stats::StoreRoot& stats_store) {
-  std::unique_ptr<envoy::HotRestartMessage> wrapper_msg = as_child_.getParentStats();
-  ServerStatsFromParent response;
-  // getParentStats() will happily and cleanly return nullptr if we have no parent.
-  if (wrapper_msg) {
-    as_child_.mergeParentStats(stats_store, wrapper_msg->reply().stats());
-    response.parent_memory_allocated_ = wrapper_msg->reply().stats().memory_allocated();
-    response.parent_connections_ = wrapper_msg->reply().stats().num_connections();
+  // Does nothing and returns 0s if we have no parent.
+  return as_child_.mergeParentStatsInChunks(stats_store);
+}
+
+absl::optional<HotRestart::TlsSessionStateFromParent> HotRestartImpl::getParentTlsSessionState() {
+  std::unique_ptr<envoy::HotRestartMessage> wrapper_msg = as_child_.getParentTlsSessionState();
+  if (!wrapper_msg) {
+    return absl::nullopt;
+  }
+  const auto& state_proto = wrapper_msg->reply().tls_session_state();
+  TlsSessionStateFromParent state;
+  for (const auto& key_proto : state_proto.ticket_keys()) {
+    Ssl::ServerContextConfig::SessionTicketKey key;
+    if (key_proto.name().size() != key.name_.size() ||
+        key_proto.hmac_key().size() != key.hmac_key_.size() ||
+        key_proto.aes_key().size() != key.aes_key_.size()) {
+      continue;
+    }
+    std::copy(key_proto.name().begin(), key_proto.name().end(), key.name_.begin());
+    std::copy(key_proto.hmac_key().begin(), key_proto.hmac_key().end(), key.hmac_key_.begin());
+    std::copy(key_proto.aes_key().begin(), key_proto.aes_key().end(), key.aes_key_.begin());
+    state.ticket_keys_.emplace_back(
+        key, SystemTime(std::chrono::microseconds(key_proto.created_epoch_microseconds())));
   }
-  return response;
+  state.sessions_.assign(state_proto.sessions().begin(), state_proto.sessions().end());
+  return state;
 }
 
 void HotRestartImpl::shutdown() {
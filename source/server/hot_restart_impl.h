@@ -111,6 +111,7 @@ public:
   absl::optional<AdminShutdownResponse> sendParentAdminShutdownRequest() override;
   void sendParentTerminateRequest() override;
   ServerStatsFromParent mergeParentStatsIfAny(Stats::StoreRoot& stats_store) override;
+  absl::optional<TlsSessionStateFromParent> getParentTlsSessionState() override;
   void shutdown() override;
   uint32_t baseId() override;
   std::string version() override;
@@ -29,6 +29,9 @@ public:
   }
   void sendParentTerminateRequest() override {}
   ServerStatsFromParent mergeParentStatsIfAny(Stats::StoreRoot&) override { return {}; }
+  absl::optional<TlsSessionStateFromParent> getParentTlsSessionState() override {
+    return absl::nullopt;
+  }
   void shutdown() override {}
   uint32_t baseId() override { return 0; }
   std::string version() override { return "disabled"; }
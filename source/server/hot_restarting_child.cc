@@ -50,11 +50,12 @@ HotRestartingChild::UdpForwardingContext::getListenerForDestination(
 // drained and terminated.
 HotRestartingChild::HotRestartingChild(int base_id, int restart_epoch,
                                        const std::string& socket_path, mode_t socket_mode,
-                                       bool skip_hot_restart_on_no_parent, bool skip_parent_stats)
+                                       bool skip_hot_restart_on_no_parent, bool skip_parent_stats,
+                                       uint32_t stats_chunk_size)
     : HotRestartingBase(base_id), restart_epoch_(restart_epoch),
       parent_terminated_(restart_epoch == 0), parent_drained_(restart_epoch == 0),
       skip_hot_restart_on_no_parent_(skip_hot_restart_on_no_parent),
-      skip_parent_stats_(skip_parent_stats) {
+      skip_parent_stats_(skip_parent_stats), stats_chunk_size_(stats_chunk_size) {
   main_rpc_stream_.initDomainSocketAddress(&parent_address_);
   std::string socket_path_udp = socket_path + "_udp";
   udp_forwarding_rpc_stream_.initDomainSocketAddress(&parent_address_udp_forwarding_);
@@ -95,9 +96,13 @@ void HotRestartingChild::initialize(Event::Dispatcher& dispatcher) {
         return onSocketEventUdpForwarding();
       },
       Event::FileTriggerType::Edge, Event::FileReadyType::Read);
+  dispatcher_ = dispatcher;
 }
 
-void HotRestartingChild::shutdown() { socket_event_udp_forwarding_.reset(); }
+void HotRestartingChild::shutdown() {
+  socket_event_udp_forwarding_.reset();
+  stats_chunk_callback_.reset();
+}
 
 void HotRestartingChild::onForwardedUdpPacket(uint32_t worker_index, Network::UdpRecvData&& data) {
   auto addr_and_listener =
@@ -144,13 +149,13 @@ int HotRestartingChild::duplicateParentListenSocket(const std::string& address,
   return wrapped_reply->reply().pass_listen_socket().fd();
 }
 
-std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentStats() {
+std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentStats(uint32_t max_stats) {
   if (parent_terminated_ || skip_parent_stats_) {
     return nullptr;
   }
 
   HotRestartMessage wrapped_request;
-  wrapped_request.mutable_request()->mutable_stats();
+  wrapped_request.mutable_request()->mutable_stats()->set_max_stats(max_stats);
   main_rpc_stream_.sendHotRestartMessage(parent_address_, wrapped_request);
 
   std::unique_ptr<HotRestartMessage> wrapped_reply =
@@ -161,6 +166,25 @@ std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentStats() {
   return wrapped_reply;
 }
 
+std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentTlsSessionState() {
+  if (parent_terminated_) {
+    return nullptr;
+  }
+
+  HotRestartMessage wrapped_request;
+  wrapped_request.mutable_request()->mutable_tls_session_state();
+  main_rpc_stream_.sendHotRestartMessage(parent_address_, wrapped_request);
+
+  std::unique_ptr<HotRestartMessage> wrapped_reply =
+      main_rpc_stream_.receiveHotRestartMessage(RpcStream::Blocking::Yes);
+  // A parent from before TLS session state was handed over doesn't recognize the request.
+  if (!main_rpc_stream_.replyIsExpectedType(wrapped_reply.get(),
+                                            HotRestartMessage::Reply::kTlsSessionState)) {
+    return nullptr;
+  }
+  return wrapped_reply;
+}
+
 void HotRestartingChild::drainParentListeners() {
   if (parent_terminated_) {
     return;
@@ -229,6 +253,8 @@ void HotRestartingChild::sendParentTerminateRequest() {
   wrapped_request.mutable_request()->mutable_terminate();
   main_rpc_stream_.sendHotRestartMessage(parent_address_, wrapped_request);
   parent_terminated_ = true;
+  stats_chunk_callback_.reset();
+  stats_chunk_store_ = nullptr;
 
   // Note that the 'generation' counter needs to retain the contribution from
   // the parent.
@@ -265,6 +291,46 @@ void HotRestartingChild::mergeParentStats(Stats::Store& stats_store,
   stat_merger_->mergeStats(stats_proto.counter_deltas(), stats_proto.gauges(), dynamics);
 }
 
+HotRestart::ServerStatsFromParent
+HotRestartingChild::mergeParentStatsInChunks(Stats::Store& stats_store) {
+  if (parent_terminated_ || skip_parent_stats_) {
+    return {};
+  }
+  // While a round is in progress, the server stats of its latest chunk are reported.
+  if (stats_chunk_store_ == nullptr) {
+    stats_chunk_store_ = &stats_store;
+    mergeParentStatsChunks();
+  }
+  return parent_server_stats_;
+}
+
+void HotRestartingChild::mergeParentStatsChunks() {
+  bool more;
+  do {
+    std::unique_ptr<HotRestartMessage> wrapped_reply = getParentStats(stats_chunk_size_);
+    if (wrapped_reply == nullptr) {
+      stats_chunk_store_ = nullptr;
+      return;
+    }
+    const HotRestartMessage::Reply::Stats& stats_proto = wrapped_reply->reply().stats();
+    mergeParentStats(*stats_chunk_store_, stats_proto);
+    parent_server_stats_.parent_memory_allocated_ = stats_proto.memory_allocated();
+    parent_server_stats_.parent_connections_ = stats_proto.num_connections();
+    more = stats_proto.more();
+    // Without a dispatcher to pace the round, all of its chunks are merged now.
+  } while (more && !dispatcher_.has_value());
+
+  if (!more) {
+    stats_chunk_store_ = nullptr;
+    return;
+  }
+  if (stats_chunk_callback_ == nullptr) {
+    stats_chunk_callback_ =
+        dispatcher_->createSchedulableCallback([this]() { mergeParentStatsChunks(); });
+  }
+  stats_chunk_callback_->scheduleCallbackNextIteration();
+}
+
 absl::Status HotRestartingChild::onSocketEventUdpForwarding() {
   std::unique_ptr<HotRestartMessage> wrapped_request;
   while ((wrapped_request =
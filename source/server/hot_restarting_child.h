@@ -42,9 +42,12 @@ public:
     absl::flat_hash_map<std::string, ForwardEntry> listener_map_;
   };
 
+  // The number of stats the parent is asked to export per reply when merging its stats.
+  static constexpr uint32_t DefaultStatsChunkSize = 10000;
+
   HotRestartingChild(int base_id, int restart_epoch, const std::string& socket_path,
                      mode_t socket_mode, bool skip_hot_restart_on_no_parent,
-                     bool skip_parent_stats);
+                     bool skip_parent_stats, uint32_t stats_chunk_size = DefaultStatsChunkSize);
   ~HotRestartingChild() override = default;
 
   void initialize(Event::Dispatcher& dispatcher);
@@ -56,12 +59,20 @@ public:
   // From Network::ParentDrainedCallbackRegistrar.
   void registerParentDrainedCallback(const Network::Address::InstanceConstSharedPtr& addr,
                                      absl::AnyInvocable<void()> action) override;
-  std::unique_ptr<envoy::HotRestartMessage> getParentStats();
+  // Requests a reply with at most max_stats stats, or all of them if max_stats is 0.
+  std::unique_ptr<envoy::HotRestartMessage> getParentStats(uint32_t max_stats = 0);
+  std::unique_ptr<envoy::HotRestartMessage> getParentTlsSessionState();
   void drainParentListeners();
   absl::optional<HotRestart::AdminShutdownResponse> sendParentAdminShutdownRequest();
   void sendParentTerminateRequest();
   void mergeParentStats(Stats::Store& stats_store,
                         const envoy::HotRestartMessage::Reply::Stats& stats_proto);
+  // Starts a round of merging the stats of the parent into stats_store, unless one is in
+  // progress. The stats are requested in chunks of stats_chunk_size; the first chunk is merged
+  // before returning and the others one per dispatcher iteration, so that neither process holds
+  // all of the stats in one message and the dispatcher isn't stalled while they are merged.
+  // @return the server stats of the parent as of the last chunk, or 0s if there is no parent.
+  HotRestart::ServerStatsFromParent mergeParentStatsInChunks(Stats::Store& stats_store);
 
 protected:
   absl::Status onSocketEventUdpForwarding();
@@ -71,6 +82,7 @@ protected:
 
 private:
   bool abortDueToFailedParentConnection();
+  void mergeParentStatsChunks();
   friend class HotRestartUdpForwardingTestHelper;
   absl::Mutex registry_mu_;
   const int restart_epoch_;
@@ -78,10 +90,16 @@ private:
   bool parent_drained_ ABSL_GUARDED_BY(registry_mu_);
   const bool skip_hot_restart_on_no_parent_;
   const bool skip_parent_stats_;
+  const uint32_t stats_chunk_size_;
   sockaddr_un parent_address_;
   sockaddr_un parent_address_udp_forwarding_;
   std::unique_ptr<Stats::StatMerger> stat_merger_{};
   Stats::StatName hot_restart_generation_stat_name_;
+  // Set while a round of merging the stats of the parent is in progress.
+  Stats::Store* stats_chunk_store_{};
+  HotRestart::ServerStatsFromParent parent_server_stats_;
+  Event::SchedulableCallbackPtr stats_chunk_callback_;
+  OptRef<Event::Dispatcher> dispatcher_;
   // There are multiple listener instances per address that must all be reactivated
   // when the parent is drained, so a multimap is used to contain them.
   std::unordered_multimap<std::string, absl::AnyInvocable<void()>>
@@ -7,6 +7,7 @@
 #include "source/common/stats/stat_merger.h"
 #include "source/common/stats/symbol_table.h"
 #include "source/common/stats/utility.h"
+#include "source/common/tls/session_resumption_manager.h"
 
 namespace Envoy {
 namespace Server {
@@ -85,7 +86,16 @@ void HotRestartingParent::onSocketEvent() {
 
     case HotRestartMessage::Request::kStats: {
       HotRestartMessage wrapped_reply;
-      internal_->exportStatsToChild(wrapped_reply.mutable_reply()->mutable_stats());
+      internal_->exportStatsToChild(wrapped_reply.mutable_reply()->mutable_stats(),
+                                    wrapped_request->request().stats().max_stats());
+      main_rpc_stream_.sendHotRestartMessage(child_address_, wrapped_reply);
+      break;
+    }
+
+    case HotRestartMessage::Request::kTlsSessionState: {
+      HotRestartMessage wrapped_reply;
+      internal_->exportTlsSessionStateToChild(
+          wrapped_reply.mutable_reply()->mutable_tls_session_state());
       main_rpc_stream_.sendHotRestartMessage(child_address_, wrapped_reply);
       break;
     }
@@ -168,35 +178,78 @@ HotRestartingParent::Internal::getListenSocketsForChild(const HotRestartMessage:
   return wrapped_reply;
 }
 
-// TODO(fredlas) if there are enough stats for stat name length to become an issue, this current
-// implementation can negate the benefit of symbolized stat names by periodically reaching the
-// magnitude of memory usage that they are meant to avoid, since this map holds full-string
-// names. The problem can be solved by splitting the export up over many chunks.
-void HotRestartingParent::Internal::exportStatsToChild(HotRestartMessage::Reply::Stats* stats) {
-  server_->stats().forEachSinkedGauge(nullptr, [this, stats](Stats::Gauge& gauge) mutable {
-    if (gauge.used()) {
-      const std::string name = gauge.name();
-      (*stats->mutable_gauges())[name] = gauge.value();
-      recordDynamics(stats, name, gauge.statName());
-    }
-  });
-
-  server_->stats().forEachSinkedCounter(nullptr, [this, stats](Stats::Counter& counter) mutable {
-    if (counter.used()) {
-      // The hot restart parent is expected to have stopped its normal stat exporting (and so
-      // latching) by the time it begins exporting to the hot restart child.
-      uint64_t latched_value = counter.latch();
-      if (latched_value > 0) {
-        const std::string name = counter.name();
-        (*stats->mutable_counter_deltas())[name] = latched_value;
-        recordDynamics(stats, name, counter.statName());
-      }
-    }
-  });
+// Exporting every stat in one reply can negate the benefit of symbolized stat names by
+// periodically reaching the magnitude of memory usage that they are meant to avoid, since the
+// reply holds full-string names. Children therefore ask for the stats in chunks of max_stats.
+void HotRestartingParent::Internal::exportStatsToChild(HotRestartMessage::Reply::Stats* stats,
+                                                       uint32_t max_stats) {
+  if (max_stats == 0) {
+    server_->stats().forEachSinkedGauge(
+        nullptr, [this, stats](Stats::Gauge& gauge) mutable { exportGauge(stats, gauge); });
+    server_->stats().forEachSinkedCounter(
+        nullptr, [this, stats](Stats::Counter& counter) mutable { exportCounter(stats, counter); });
+  } else {
+    exportStatsChunkToChild(stats, max_stats);
+  }
   stats->set_memory_allocated(Memory::Stats::totalCurrentlyAllocated());
   stats->set_num_connections(server_->listenerManager().numConnections());
 }
 
+void HotRestartingParent::Internal::exportStatsChunkToChild(HotRestartMessage::Reply::Stats* stats,
+                                                            uint32_t max_stats) {
+  if (pending_gauges_.empty() && pending_counters_.empty()) {
+    // Holding references to the stats is much cheaper than holding their names and values, and
+    // keeps stats which are removed during the round valid until they are exported.
+    server_->stats().forEachSinkedGauge(
+        [this](std::size_t size) { pending_gauges_.reserve(size); },
+        [this](Stats::Gauge& gauge) { pending_gauges_.emplace_back(&gauge); });
+    server_->stats().forEachSinkedCounter(
+        [this](std::size_t size) { pending_counters_.reserve(size); },
+        [this](Stats::Counter& counter) { pending_counters_.emplace_back(&counter); });
+  }
+
+  uint32_t exported = 0;
+  for (; exported < max_stats && !pending_gauges_.empty(); ++exported) {
+    exportGauge(stats, *pending_gauges_.back());
+    pending_gauges_.pop_back();
+  }
+  for (; exported < max_stats && !pending_counters_.empty(); ++exported) {
+    exportCounter(stats, *pending_counters_.back());
+    pending_counters_.pop_back();
+  }
+
+  if (pending_gauges_.empty() && pending_counters_.empty()) {
+    // Release the memory of the round rather than keeping it until the next one.
+    pending_gauges_ = {};
+    pending_counters_ = {};
+  } else {
+    stats->set_more(true);
+  }
+}
+
+void HotRestartingParent::Internal::exportGauge(HotRestartMessage::Reply::Stats* stats,
+                                                Stats::Gauge& gauge) {
+  if (gauge.used()) {
+    const std::string name = gauge.name();
+    (*stats->mutable_gauges())[name] = gauge.value();
+    recordDynamics(stats, name, gauge.statName());
+  }
+}
+
+void HotRestartingParent::Internal::exportCounter(HotRestartMessage::Reply::Stats* stats,
+                                                  Stats::Counter& counter) {
+  if (counter.used()) {
+    // The hot restart parent is expected to have stopped its normal stat exporting (and so
+    // latching) by the time it begins exporting to the hot restart child.
+    uint64_t latched_value = counter.latch();
+    if (latched_value > 0) {
+      const std::string name = counter.name();
+      (*stats->mutable_counter_deltas())[name] = latched_value;
+      recordDynamics(stats, name, counter.statName());
+    }
+  }
+}
+
 void HotRestartingParent::Internal::recordDynamics(HotRestartMessage::Reply::Stats* stats,
                                                    const std::string& name,
                                                    Stats::StatName stat_name) {
@@ -221,6 +274,23 @@ void HotRestartingParent::Internal::recordDynamics(HotRestartMessage::Reply::Sta
   }
 }
 
+void HotRestartingParent::Internal::exportTlsSessionStateToChild(
+    HotRestartMessage::Reply::TlsSessionState* state) {
+  auto manager = Extensions::TransportSockets::Tls::SessionResumptionManager::singleton(
+      server_->singletonManager(), server_->timeSource(), *server_->stats().rootScope());
+  for (const auto& [key, created] : manager->ticketKeys()) {
+    auto* key_proto = state->add_ticket_keys();
+    key_proto->set_name(key.name_.data(), key.name_.size());
+    key_proto->set_hmac_key(key.hmac_key_.data(), key.hmac_key_.size());
+    key_proto->set_aes_key(key.aes_key_.data(), key.aes_key_.size());
+    key_proto->set_created_epoch_microseconds(
+        std::chrono::duration_cast<std::chrono::microseconds>(created.time_since_epoch()).count());
+  }
+  for (std::string& session : manager->serializedSessions()) {
+    state->add_sessions(std::move(session));
+  }
+}
+
 void HotRestartingParent::Internal::drainListeners() {
   Network::ExtraShutdownListenerOptions options;
   options.non_dispatched_udp_packet_handler_ = *this;
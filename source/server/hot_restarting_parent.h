@@ -36,17 +36,32 @@ public:
     envoy::HotRestartMessage
     getListenSocketsForChild(const envoy::HotRestartMessage::Request& request);
     // 'stats' is a field in the reply protobuf to be sent to the child, which we should populate.
-    void exportStatsToChild(envoy::HotRestartMessage::Reply::Stats* stats);
+    // If max_stats is non-zero, at most max_stats stats are exported, and the next call continues
+    // with the stats which are left of the same round.
+    void exportStatsToChild(envoy::HotRestartMessage::Reply::Stats* stats, uint32_t max_stats = 0);
     void recordDynamics(envoy::HotRestartMessage::Reply::Stats* stats, const std::string& name,
                         Stats::StatName stat_name);
     void drainListeners();
+    // 'tls_session_state' is a field in the reply protobuf to be sent to the child, which we should
+    // populate.
+    void exportTlsSessionStateToChild(envoy::HotRestartMessage::Reply::TlsSessionState* state);
 
     // Network::NonDispatchedUdpPacketHandler
     void handle(uint32_t worker_index, const Network::UdpRecvData& packet) override;
 
   private:
+    void exportStatsChunkToChild(envoy::HotRestartMessage::Reply::Stats* stats,
+                                 uint32_t max_stats);
+    void exportGauge(envoy::HotRestartMessage::Reply::Stats* stats, Stats::Gauge& gauge);
+    void exportCounter(envoy::HotRestartMessage::Reply::Stats* stats, Stats::Counter& counter);
+
     Server::Instance* const server_{};
     HotRestartMessageSender& udp_sender_;
+    // The stats which are left to export in the current round of a chunked export. A round
+    // covers the stats which existed when it started; stats created since are exported by the
+    // next round.
+    std::vector<Stats::GaugeSharedPtr> pending_gauges_;
+    std::vector<Stats::CounterSharedPtr> pending_counters_;
   };
 
 private:
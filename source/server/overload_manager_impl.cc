@@ -1,6 +1,7 @@
 #include "source/server/overload_manager_impl.h"
 
 #include <chrono>
+#include <cmath>
 
 #include "envoy/common/exception.h"
 #include "envoy/config/overload/v3/overload.pb.h"
@@ -30,8 +31,7 @@ public:
 
   bool updateValue(double value) override {
     const OverloadActionState state = actionState();
-    state_ =
-        value >= threshold_ ? OverloadActionState::saturated() : OverloadActionState::inactive();
+    state_ = actionStateForValue(value);
     // This is a floating point comparison, though state_ is always either
     // saturated or inactive so there's no risk due to floating point precision.
     return state.value() != actionState().value();
@@ -39,6 +39,10 @@ public:
 
   OverloadActionState actionState() const override { return state_; }
 
+  OverloadActionState actionStateForValue(double value) const override {
+    return value >= threshold_ ? OverloadActionState::saturated() : OverloadActionState::inactive();
+  }
+
 private:
   const double threshold_;
   OverloadActionState state_;
@@ -56,14 +60,7 @@ public:
 
   bool updateValue(double value) override {
     const OverloadActionState old_state = actionState();
-    if (value <= scaling_threshold_) {
-      state_ = OverloadActionState::inactive();
-    } else if (value >= saturated_threshold_) {
-      state_ = OverloadActionState::saturated();
-    } else {
-      state_ = OverloadActionState(
-          UnitFloat((value - scaling_threshold_) / (saturated_threshold_ - scaling_threshold_)));
-    }
+    state_ = actionStateForValue(value);
     // All values of state_ are produced via this same code path. Even if
     // old_state and state_ should be approximately equal, there's no harm in
     // signaling for a small change if they're not float::operator== equal.
@@ -72,6 +69,17 @@ public:
 
   OverloadActionState actionState() const override { return state_; }
 
+  OverloadActionState actionStateForValue(double value) const override {
+    if (value <= scaling_threshold_) {
+      return OverloadActionState::inactive();
+    }
+    if (value >= saturated_threshold_) {
+      return OverloadActionState::saturated();
+    }
+    return OverloadActionState(
+        UnitFloat((value - scaling_threshold_) / (saturated_threshold_ - scaling_threshold_)));
+  }
+
 private:
   ScaledTriggerImpl(const envoy::config::overload::v3::ScaledTrigger& config)
       : scaling_threshold_(config.scaling_threshold()),
@@ -232,6 +240,11 @@ public:
     return proactive_resource != proactive_resources_->end();
   }
 
+  void setEventLoopLatencyMonitor(EventLoopLatencyMonitorSharedPtr monitor) {
+    event_loop_latency_monitor_ = std::move(monitor);
+  }
+  EventLoopLatencyMonitor* eventLoopLatencyMonitor() { return event_loop_latency_monitor_.get(); }
+
   ProactiveResourceMonitorOptRef
   getProactiveResourceMonitorForTest(OverloadProactiveResourceName resource_name) override {
     const auto proactive_resource = proactive_resources_->find(resource_name);
@@ -248,6 +261,7 @@ private:
   std::vector<OverloadActionState> actions_;
   std::shared_ptr<absl::node_hash_map<OverloadProactiveResourceName, ProactiveResource>>
       proactive_resources_;
+  EventLoopLatencyMonitorSharedPtr event_loop_latency_monitor_;
 };
 
 const OverloadActionState ThreadLocalOverloadStateImpl::always_inactive_{UnitFloat::min()};
@@ -338,26 +352,77 @@ bool OverloadAction::updateResourcePressure(const std::string& name, double pres
 
 OverloadActionState OverloadAction::getState() const { return state_; }
 
+EventLoopLatencyMonitor::EventLoopLatencyMonitor(Event::Dispatcher& dispatcher,
+                                                 std::chrono::microseconds max_loop_duration)
+    : dispatcher_(dispatcher), time_source_(dispatcher.timeSource()),
+      max_loop_duration_us_(max_loop_duration.count()),
+      iteration_start_(dispatcher.iterationStartTime()), last_checked_(iteration_start_) {}
+
+double EventLoopLatencyMonitor::pressure() {
+  ASSERT(dispatcher_.isThreadSafe());
+  const MonotonicTime now = time_source_.monotonicTime();
+  // Not the approximate time, which may be updated in the middle of an iteration, e.g. by QUIC.
+  const MonotonicTime iteration_start = dispatcher_.iterationStartTime();
+  if (iteration_start != iteration_start_) {
+    // The previous iteration the monitor was checked during took at least until the last check.
+    const double previous_loop_duration_us =
+        std::chrono::duration<double, std::micro>(last_checked_ - iteration_start_).count();
+    // The loop may have been idle since then, or run iterations which no load shed point checked.
+    const double elapsed_us =
+        std::chrono::duration<double, std::micro>(iteration_start - last_checked_).count();
+    recent_loop_duration_us_ = std::max(previous_loop_duration_us, recent_loop_duration_us_ / 2) *
+                               std::exp2(-elapsed_us / max_loop_duration_us_);
+    iteration_start_ = iteration_start;
+  }
+  last_checked_ = now;
+
+  const double current_loop_duration_us =
+      std::chrono::duration<double, std::micro>(now - iteration_start).count();
+  const double pressure =
+      std::max(current_loop_duration_us, recent_loop_duration_us_) / max_loop_duration_us_;
+  double peak_pressure = peak_pressure_.load();
+  while (pressure > peak_pressure &&
+         !peak_pressure_.compare_exchange_weak(peak_pressure, pressure)) {
+  }
+  return pressure;
+}
+
+double EventLoopLatencyMonitor::takePeakPressure() { return peak_pressure_.exchange(0); }
+
 absl::StatusOr<std::unique_ptr<LoadShedPointImpl>>
 LoadShedPointImpl::create(const envoy::config::overload::v3::LoadShedPoint& config,
-                          Stats::Scope& stats_scope, Random::RandomGenerator& random_generator) {
+                          Stats::Scope& stats_scope, Random::RandomGenerator& random_generator,
+                          EventLoopLatencyMonitorGetter event_loop_latency_monitor) {
   absl::Status creation_status = absl::OkStatus();
   auto ret = std::unique_ptr<LoadShedPointImpl>(
-      new LoadShedPointImpl(config, stats_scope, random_generator, creation_status));
+      new LoadShedPointImpl(config, stats_scope, random_generator,
+                            std::move(event_loop_latency_monitor), creation_status));
   RETURN_IF_NOT_OK(creation_status);
   return ret;
 }
 LoadShedPointImpl::LoadShedPointImpl(const envoy::config::overload::v3::LoadShedPoint& config,
                                      Stats::Scope& stats_scope,
                                      Random::RandomGenerator& random_generator,
+                                     EventLoopLatencyMonitorGetter event_loop_latency_monitor,
                                      absl::Status& creation_status)
-    : scale_percent_(makeGauge(stats_scope, config.name(), "scale_percent",
+    : event_loop_latency_monitor_(std::move(event_loop_latency_monitor)),
+      scale_percent_(makeGauge(stats_scope, config.name(), "scale_percent",
                                Stats::Gauge::ImportMode::NeverImport)),
       shed_load_counter_(makeCounter(stats_scope, config.name(), "shed_load_count")),
       random_generator_(random_generator) {
   for (const auto& trigger_config : config.triggers()) {
     auto trigger_or_error = createTriggerFromConfig(trigger_config);
     SET_AND_RETURN_IF_NOT_OK(trigger_or_error.status(), creation_status);
+    if (trigger_config.name() == EventLoopLatencyMonitor::ResourceName &&
+        event_loop_latency_monitor_ != nullptr) {
+      if (event_loop_latency_trigger_ != nullptr) {
+        creation_status = absl::InvalidArgumentError(
+            absl::StrCat("Duplicate trigger resource for LoadShedPoint ", config.name()));
+        return;
+      }
+      event_loop_latency_trigger_ = std::move(*trigger_or_error);
+      continue;
+    }
     if (!triggers_.try_emplace(trigger_config.name(), std::move(*trigger_or_error)).second) {
       creation_status = absl::InvalidArgumentError(
           absl::StrCat("Duplicate trigger resource for LoadShedPoint ", config.name()));
@@ -391,6 +456,13 @@ void LoadShedPointImpl::updateProbabilityShedLoad() {
 
 bool LoadShedPointImpl::shouldShedLoad() {
   float unit_float_probability_shed_load = probability_shed_load_.load();
+  if (event_loop_latency_trigger_ != nullptr && unit_float_probability_shed_load < 1.0f) {
+    if (EventLoopLatencyMonitor* monitor = event_loop_latency_monitor_(); monitor != nullptr) {
+      unit_float_probability_shed_load = std::max(
+          unit_float_probability_shed_load,
+          event_loop_latency_trigger_->actionStateForValue(monitor->pressure()).value().value());
+    }
+  }
   // This should be ok as we're using unit float which saturates at 1.0f.
   if (unit_float_probability_shed_load == 1.0f) {
     shed_load_counter_.inc();
@@ -431,6 +503,13 @@ OverloadManagerImpl::OverloadManagerImpl(Event::Dispatcher& dispatcher, Stats::S
       proactive_resources_(
           std::make_unique<
               absl::node_hash_map<OverloadProactiveResourceName, ProactiveResource>>()) {
+  if (config.has_event_loop_latency_monitor()) {
+    max_loop_duration_ = std::chrono::microseconds(Protobuf::util::TimeUtil::DurationToMicroseconds(
+        config.event_loop_latency_monitor().max_loop_duration()));
+    event_loop_latency_pressure_gauge_ =
+        &makeGauge(stats_scope, EventLoopLatencyMonitor::ResourceName, "pressure",
+                   Stats::Gauge::ImportMode::NeverImport);
+  }
   Configuration::ResourceMonitorFactoryContextImpl context(dispatcher, options, api,
                                                            validation_visitor);
   // We should hide impl details from users, for them there should be no distinction between
@@ -539,15 +618,23 @@ OverloadManagerImpl::OverloadManagerImpl(Event::Dispatcher& dispatcher, Stats::S
   // Validate the trigger resources for Load shedPoints.
   for (const auto& point : config.loadshed_points()) {
     for (const auto& trigger : point.triggers()) {
-      if (!resources_.contains(trigger.name())) {
+      if (!resources_.contains(trigger.name()) &&
+          !(max_loop_duration_.has_value() &&
+            trigger.name() == EventLoopLatencyMonitor::ResourceName)) {
         creation_status = absl::InvalidArgumentError(fmt::format(
             "Unknown trigger resource {} for loadshed point {}", trigger.name(), point.name()));
         return;
       }
     }
 
-    auto load_shed_or_error =
-        LoadShedPointImpl::create(point, api.rootScope(), api.randomGenerator());
+    auto load_shed_or_error = LoadShedPointImpl::create(
+        point, api.rootScope(), api.randomGenerator(), [this]() -> EventLoopLatencyMonitor* {
+          if (!tls_.currentThreadRegistered()) {
+            return nullptr;
+          }
+          auto state = tls_.get();
+          return state.has_value() ? state->eventLoopLatencyMonitor() : nullptr;
+        });
     SET_AND_RETURN_IF_NOT_OK(load_shed_or_error.status(), creation_status);
     const auto result = loadshed_points_.try_emplace(point.name(), *std::move(load_shed_or_error));
 
@@ -563,12 +650,21 @@ void OverloadManagerImpl::start() {
   ASSERT(!started_);
   started_ = true;
 
-  tls_.set([this](Event::Dispatcher&) {
-    return std::make_shared<ThreadLocalOverloadStateImpl>(action_symbol_table_,
-                                                          proactive_resources_);
+  tls_.set([this](Event::Dispatcher& dispatcher) {
+    auto state = std::make_shared<ThreadLocalOverloadStateImpl>(action_symbol_table_,
+                                                                proactive_resources_);
+    if (max_loop_duration_.has_value()) {
+      auto monitor = std::make_shared<EventLoopLatencyMonitor>(dispatcher, *max_loop_duration_);
+      {
+        absl::MutexLock lock(&event_loop_latency_monitors_mutex_);
+        event_loop_latency_monitors_.push_back(monitor);
+      }
+      state->setEventLoopLatencyMonitor(std::move(monitor));
+    }
+    return state;
   });
 
-  if (resources_.empty()) {
+  if (resources_.empty() && !max_loop_duration_.has_value()) {
     return;
   }
 
@@ -584,6 +680,7 @@ void OverloadManagerImpl::start() {
     for (auto& resource : resources_) {
       resource.second.update(flush_epoch_);
     }
+    updateEventLoopLatencyPressure();
 
     // Record delay.
     auto now = time_source_.monotonicTime();
@@ -599,6 +696,20 @@ void OverloadManagerImpl::start() {
   timer_->enableTimer(refresh_interval_);
 }
 
+void OverloadManagerImpl::updateEventLoopLatencyPressure() {
+  if (event_loop_latency_pressure_gauge_ == nullptr) {
+    return;
+  }
+  double pressure = 0;
+  {
+    absl::MutexLock lock(&event_loop_latency_monitors_mutex_);
+    for (const auto& monitor : event_loop_latency_monitors_) {
+      pressure = std::max(pressure, monitor->takePeakPressure());
+    }
+  }
+  event_loop_latency_pressure_gauge_->set(pressure * 100);
+}
+
 void OverloadManagerImpl::stop() {
   // Disable any pending timeouts.
   if (timer_) {
@@ -20,6 +20,7 @@
 
 #include "absl/container/node_hash_map.h"
 #include "absl/container/node_hash_set.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Server {
@@ -37,6 +38,9 @@ public:
 
   // Returns the action state for the trigger.
   virtual OverloadActionState actionState() const PURE;
+
+  // Returns the action state the trigger would have for the given value, without updating it.
+  virtual OverloadActionState actionStateForValue(double value) const PURE;
 };
 
 class OverloadAction {
@@ -62,15 +66,62 @@ private:
   Stats::Gauge& scale_percent_gauge_;
 };
 
+/**
+ * Measures the latency of the event loop of a thread from the time it spends on its iterations.
+ * It is evaluated by the thread itself whenever a load shed point checks it, so that the thread
+ * sheds load while it is still working through a burst, rather than once the resource monitors
+ * have next been refreshed and their pressure has been propagated to it.
+ */
+class EventLoopLatencyMonitor {
+public:
+  // The name by which load shed point triggers refer to the monitor of their thread.
+  static constexpr absl::string_view ResourceName = "envoy.resource_monitors.event_loop_latency";
+
+  EventLoopLatencyMonitor(Event::Dispatcher& dispatcher,
+                          std::chrono::microseconds max_loop_duration);
+
+  /**
+   * Must be called on the thread of the dispatcher.
+   * @return the time the event loop has spent on its current iteration so far, or the duration
+   *  of its recent iterations, whichever is larger, as a ratio of the max loop duration.
+   */
+  double pressure();
+
+  /**
+   * May be called on any thread.
+   * @return the highest pressure computed since the previous call.
+   */
+  double takePeakPressure();
+
+private:
+  Event::Dispatcher& dispatcher_;
+  TimeSource& time_source_;
+  const double max_loop_duration_us_;
+  // When the current iteration started, and when the monitor was last checked during it.
+  MonotonicTime iteration_start_;
+  MonotonicTime last_checked_;
+  // The longest recent iteration, halved with each iteration the monitor was checked in since, and
+  // with each max loop duration elapsed between those iterations, whether the loop was idle or ran
+  // iterations in which it wasn't checked.
+  double recent_loop_duration_us_{};
+  std::atomic<double> peak_pressure_{};
+};
+
+using EventLoopLatencyMonitorSharedPtr = std::shared_ptr<EventLoopLatencyMonitor>;
+
 /**
  * Implement a LoadShedPoint which is a particular point in the connection /
  * request lifecycle where we can either abort or continue the given work.
  */
 class LoadShedPointImpl : public LoadShedPoint {
 public:
+  // Returns the event loop latency monitor of the calling thread, or nullptr if it has none.
+  using EventLoopLatencyMonitorGetter = std::function<EventLoopLatencyMonitor*()>;
+
   static absl::StatusOr<std::unique_ptr<LoadShedPointImpl>>
   create(const envoy::config::overload::v3::LoadShedPoint& config, Stats::Scope& stats_scope,
-         Random::RandomGenerator& random_generator);
+         Random::RandomGenerator& random_generator,
+         EventLoopLatencyMonitorGetter event_loop_latency_monitor = nullptr);
   LoadShedPointImpl(const LoadShedPointImpl&) = delete;
   LoadShedPointImpl& operator=(const LoadShedPointImpl&) = delete;
 
@@ -88,6 +139,7 @@ public:
 private:
   LoadShedPointImpl(const envoy::config::overload::v3::LoadShedPoint& config,
                     Stats::Scope& stats_scope, Random::RandomGenerator& random_generator,
+                    EventLoopLatencyMonitorGetter event_loop_latency_monitor,
                     absl::Status& creation_status);
   using TriggerPtr = std::unique_ptr<Trigger>;
 
@@ -95,6 +147,10 @@ private:
   void updateProbabilityShedLoad();
 
   absl::flat_hash_map<std::string, TriggerPtr> triggers_;
+  // Evaluated by each thread against the latency of its own event loop. It is never updated, so it
+  // is safe to share between threads.
+  TriggerPtr event_loop_latency_trigger_;
+  EventLoopLatencyMonitorGetter event_loop_latency_monitor_;
   std::atomic<float> probability_shed_load_{0};
   Stats::Gauge& scale_percent_;
   Stats::Counter& shed_load_counter_;
@@ -215,6 +271,8 @@ private:
                               FlushEpochId flush_epoch);
   // Flushes any enqueued action state updates to all worker threads.
   void flushResourceUpdates();
+  // Reports the highest event loop latency pressure of any thread since the previous refresh.
+  void updateEventLoopLatencyPressure();
 
   bool started_{false};
   Event::Dispatcher& dispatcher_;
@@ -239,6 +297,12 @@ private:
 
   Event::ScaledTimerTypeMapConstSharedPtr timer_minimums_;
 
+  absl::optional<std::chrono::microseconds> max_loop_duration_;
+  Stats::Gauge* event_loop_latency_pressure_gauge_{};
+  absl::Mutex event_loop_latency_monitors_mutex_;
+  std::vector<EventLoopLatencyMonitorSharedPtr>
+      event_loop_latency_monitors_ ABSL_GUARDED_BY(event_loop_latency_monitors_mutex_);
+
   absl::flat_hash_map<NamedOverloadActionSymbolTable::Symbol, OverloadActionState>
       state_updates_to_flush_;
   absl::flat_hash_map<ActionCallback*, OverloadActionState> callbacks_to_flush_;
@@ -49,6 +49,7 @@
 #include "source/common/stats/thread_local_store.h"
 #include "source/common/stats/timespan_impl.h"
 #include "source/common/tls/context_manager_impl.h"
+#include "source/common/tls/session_resumption_manager.h"
 #include "source/common/upstream/cluster_manager_impl.h"
 #include "source/common/version/version.h"
 #include "source/server/configuration_impl.h"
@@ -611,6 +612,18 @@ absl::Status InstanceBase::initializeOrThrow(Network::Address::InstanceConstShar
         parent_admin_shutdown_response.value().enable_reuse_port_default_ ? true : false;
   }
 
+  // Take over the TLS session cache and session ticket keys of the parent, so that its clients can
+  // resume their sessions with this process.
+  auto parent_tls_session_state = restarter_.getParentTlsSessionState();
+  if (parent_tls_session_state.has_value() &&
+      (!parent_tls_session_state->ticket_keys_.empty() ||
+       !parent_tls_session_state->sessions_.empty())) {
+    Extensions::TransportSockets::Tls::SessionResumptionManager::singleton(
+        singletonManager(), timeSource(), *stats().rootScope())
+        ->importState(std::move(parent_tls_session_state->ticket_keys_),
+                      std::move(parent_tls_session_state->sessions_));
+  }
+
   OptRef<Server::ConfigTracker> config_tracker;
 #ifdef ENVOY_ADMIN_FUNCTIONALITY
   admin_ = std::make_shared<AdminImpl>(initial_config.admin().profilePath(), *this,
@@ -118,6 +118,29 @@ TEST(JsonEscapeTest, Escape) {
   expect_json_escape("\x1f", "\\u001f");
 }
 
+// The escapes are found wherever they are relative to the blocks which are scanned at once.
+TEST(JsonEscapeTest, LongStrings) {
+  const std::string clean(40, 'a');
+  for (size_t position = 0; position <= clean.size(); ++position) {
+    std::string to_be_escaped = clean;
+    to_be_escaped.insert(position, "\n");
+    const std::string escaped =
+        JsonEscaper::escapeString(to_be_escaped, JsonEscaper::extraSpace(to_be_escaped));
+    EXPECT_EQ(absl::StrCat(clean.substr(0, position), "\\n", clean.substr(position)), escaped);
+    EXPECT_EQ(position, JsonEscaper::findFirstEscape(to_be_escaped));
+    EXPECT_EQ(position, JsonEscaper::findFirstEscapeOrNonAscii(to_be_escaped));
+  }
+  EXPECT_EQ(clean.size(), JsonEscaper::findFirstEscape(clean));
+  EXPECT_EQ(clean.size(), JsonEscaper::findFirstEscapeOrNonAscii(clean));
+
+  // UTF-8 and DEL are passed through, but stop the non-ascii scan.
+  const std::string utf8 = absl::StrCat(clean, "\177κόσμε\"");
+  EXPECT_EQ(utf8.size() - 1, JsonEscaper::findFirstEscape(utf8));
+  EXPECT_EQ(clean.size(), JsonEscaper::findFirstEscapeOrNonAscii(utf8));
+  EXPECT_EQ(absl::StrCat(clean, "\177κόσμε\\\""),
+            JsonEscaper::escapeString(utf8, JsonEscaper::extraSpace(utf8)));
+}
+
 class LoggerCustomFlagsTest : public testing::TestWithParam<spdlog::logger*> {
 public:
   LoggerCustomFlagsTest() : logger_(GetParam()) {}
@@ -0,0 +1,62 @@
+#include <string>
+#include <vector>
+
+#include "source/common/common/sharded_lru_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+
+TEST(ShardedLruCache, InsertLookupRemove) {
+  ShardedLruCache<int> cache(100);
+  EXPECT_TRUE(cache.insert("a", 1).inserted_);
+  EXPECT_FALSE(cache.insert("a", 2).inserted_);
+  EXPECT_EQ(1U, cache.size());
+
+  int value = 0;
+  EXPECT_TRUE(cache.lookup("a", [&value](int cached) {
+    value = cached;
+    return true;
+  }));
+  EXPECT_EQ(2, value);
+  EXPECT_FALSE(cache.lookup("b", [](int) { return true; }));
+
+  EXPECT_TRUE(cache.remove("a"));
+  EXPECT_FALSE(cache.remove("a"));
+  EXPECT_EQ(0U, cache.size());
+}
+
+// An entry which the lookup finds invalid is removed.
+TEST(ShardedLruCache, InvalidEntryRemoved) {
+  ShardedLruCache<int> cache(100);
+  cache.insert("a", 1);
+  EXPECT_FALSE(cache.lookup("a", [](int) { return false; }));
+  EXPECT_EQ(0U, cache.size());
+}
+
+// With a single shard, the least recently used entry is evicted first.
+TEST(ShardedLruCache, EvictsLeastRecentlyUsed) {
+  ShardedLruCache<int, 1> cache(2);
+  cache.insert("a", 1);
+  cache.insert("b", 2);
+  EXPECT_TRUE(cache.lookup("a", [](int) { return true; }));
+  const auto result = cache.insert("c", 3);
+  EXPECT_TRUE(result.inserted_);
+  EXPECT_TRUE(result.evicted_);
+
+  std::vector<std::string> keys;
+  cache.forEach([&keys](absl::string_view key, int) { keys.emplace_back(key); });
+  EXPECT_EQ((std::vector<std::string>{"a", "c"}), keys);
+}
+
+// Every shard holds at least one entry, however small the cache is.
+TEST(ShardedLruCache, AtLeastOneEntryPerShard) {
+  ShardedLruCache<int> cache(0);
+  for (uint32_t i = 0; i < 4 * cache.numShards(); ++i) {
+    cache.insert(std::to_string(i), i);
+  }
+  EXPECT_GE(cache.size(), 1U);
+  EXPECT_LE(cache.size(), cache.numShards());
+}
+
+} // namespace Envoy
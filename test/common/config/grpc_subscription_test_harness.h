@@ -23,6 +23,7 @@
 #include "test/mocks/local_info/mocks.h"
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/test_common/resources.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -72,7 +73,9 @@ public:
         /*xds_config_tracker_=*/XdsConfigTrackerOptRef(),
         /*backoff_strategy_=*/std::move(backoff_strategy),
         /*target_xds_authority_=*/"",
-        /*eds_resources_cache_=*/nullptr};
+        /*eds_resources_cache_=*/nullptr,
+        /*resource_decode_threads_=*/0,
+        /*thread_factory_=*/Thread::threadFactoryForTest()};
 
     if (should_use_unified_) {
       mux_ = std::make_shared<Config::XdsMux::GrpcMuxSotw>(grpc_mux_context, true);
@@ -865,6 +865,25 @@ TEST_P(DispatcherMonotonicTimeTest, ApproximateMonotonicTime) {
   dispatcher_->run(Dispatcher::RunType::Block);
 }
 
+TEST_P(DispatcherMonotonicTimeTest, IterationStartTime) {
+  // The iteration start time is not changed by updates of the approximate time within the
+  // iteration.
+  dispatcher_->post([this]() {
+    time_ = dispatcher_->iterationStartTime();
+    absl::SleepFor(absl::Milliseconds(1));
+    dispatcher_->updateApproximateMonotonicTime();
+    EXPECT_LT(time_, dispatcher_->approximateMonotonicTime());
+    EXPECT_EQ(time_, dispatcher_->iterationStartTime());
+  });
+
+  dispatcher_->run(Dispatcher::RunType::Block);
+
+  // The iteration start time is increasing between event loop runs.
+  dispatcher_->post([this]() { EXPECT_LT(time_, dispatcher_->iterationStartTime()); });
+
+  dispatcher_->run(Dispatcher::RunType::Block);
+}
+
 class TimerImplTest : public testing::Test {
 protected:
   TimerImplTest() {
@@ -304,7 +304,7 @@ TEST_F(IoUringImplTest, PrepareReadvAllDataFitsOneChunk) {
       [this, &completions_nr, d = dispatcher.get()](uint32_t) {
         io_uring_->forEveryCompletion([&completions_nr](Request*, int32_t res, bool) {
           completions_nr++;
-          EXPECT_EQ(res, strlen("test text"));
+          EXPECT_EQ(res, static_cast<int32_t>(strlen("test text")));
         });
         d->exit();
         return absl::OkStatus();
@@ -401,6 +401,105 @@ TEST_F(IoUringImplTest, PrepareReadvQueueOverflow) {
   EXPECT_EQ(static_cast<char*>(iov3.iov_base)[1], 'f');
 }
 
+TEST_F(IoUringImplTest, WaitForCompletion) {
+  std::string test_file =
+      TestEnvironment::writeStringToFileForTest("wait_for_completion", "test text", true);
+  os_fd_t fd = open(test_file.c_str(), O_RDONLY);
+  ASSERT_TRUE(fd >= 0);
+
+  uint8_t buffer[16]{};
+  EXPECT_EQ(io_uring_->prepareRead(fd, false, buffer, sizeof(buffer), 0, 0, nullptr),
+            IoUringResult::Ok);
+  EXPECT_EQ(io_uring_->submit(), IoUringResult::Ok);
+
+  // The completion can be consumed without an event loop once the wait returns.
+  EXPECT_EQ(io_uring_->waitForCompletion(), IoUringResult::Ok);
+  int32_t completions_nr = 0;
+  io_uring_->forEveryCompletion([&completions_nr](Request*, int32_t res, bool) {
+    completions_nr++;
+    EXPECT_EQ(res, static_cast<int32_t>(strlen("test text")));
+  });
+  EXPECT_EQ(completions_nr, 1);
+  close(fd);
+}
+
+TEST_F(IoUringImplTest, PrepareReadFromRegisteredFileIntoRegisteredBuffer) {
+  std::string test_file =
+      TestEnvironment::writeStringToFileForTest("prepare_read_fixed", "test text", true);
+  os_fd_t fd = open(test_file.c_str(), O_RDONLY);
+  ASSERT_TRUE(fd >= 0);
+  if (io_uring_->registerFiles(1) != IoUringResult::Ok) {
+    close(fd);
+    GTEST_SKIP() << "registering files is not supported by the kernel";
+  }
+  EXPECT_EQ(io_uring_->updateRegisteredFile(0, fd), IoUringResult::Ok);
+
+  auto dispatcher = api_->allocateDispatcher("test_thread");
+
+  uint8_t buffer[4096]{};
+  struct iovec iov;
+  iov.iov_base = buffer;
+  iov.iov_len = sizeof(buffer);
+  EXPECT_EQ(io_uring_->registerBuffers(&iov, 1), IoUringResult::Ok);
+
+  os_fd_t event_fd = io_uring_->registerEventfd();
+  int32_t completions_nr = 0;
+  auto file_event = dispatcher->createFileEvent(
+      event_fd,
+      [this, &completions_nr](uint32_t) {
+        io_uring_->forEveryCompletion([&completions_nr](Request*, int32_t res, bool) {
+          completions_nr++;
+          EXPECT_EQ(res, static_cast<int32_t>(strlen("test text")));
+        });
+        return absl::OkStatus();
+      },
+      Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
+
+  // The file is read through its index among the registered files rather than its descriptor.
+  EXPECT_EQ(io_uring_->prepareRead(0, true, buffer, sizeof(buffer), 0, 0, nullptr),
+            IoUringResult::Ok);
+  EXPECT_EQ(io_uring_->submit(), IoUringResult::Ok);
+
+  waitForCondition(*dispatcher, [&completions_nr]() { return completions_nr == 1; });
+  EXPECT_STREQ(reinterpret_cast<char*>(buffer), "test text");
+
+  // Removing the file from the table makes its index invalid.
+  EXPECT_EQ(io_uring_->updateRegisteredFile(0, -1), IoUringResult::Ok);
+  close(fd);
+}
+
+TEST_F(IoUringImplTest, PrepareWrite) {
+  std::string test_file =
+      TestEnvironment::writeStringToFileForTest("prepare_write", "0123456789", true);
+  os_fd_t fd = open(test_file.c_str(), O_RDWR);
+  ASSERT_TRUE(fd >= 0);
+
+  auto dispatcher = api_->allocateDispatcher("test_thread");
+
+  os_fd_t event_fd = io_uring_->registerEventfd();
+  int32_t completions_nr = 0;
+  auto file_event = dispatcher->createFileEvent(
+      event_fd,
+      [this, &completions_nr](uint32_t) {
+        io_uring_->forEveryCompletion([&completions_nr](Request*, int32_t res, bool) {
+          completions_nr++;
+          EXPECT_EQ(res, 3);
+        });
+        return absl::OkStatus();
+      },
+      Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
+
+  const char contents[] = "abc";
+  EXPECT_EQ(io_uring_->prepareWrite(fd, false, contents, 3, 4, -1, nullptr), IoUringResult::Ok);
+  EXPECT_EQ(io_uring_->submit(), IoUringResult::Ok);
+
+  waitForCondition(*dispatcher, [&completions_nr]() { return completions_nr == 1; });
+  char written[11]{};
+  EXPECT_EQ(pread(fd, written, 10, 0), 10);
+  EXPECT_STREQ(written, "0123abc789");
+  close(fd);
+}
+
 } // namespace
 } // namespace Io
 } // namespace Envoy
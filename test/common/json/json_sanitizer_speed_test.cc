@@ -1,3 +1,4 @@
+#include "source/common/common/json_escape_string.h"
 #include "source/common/json/json_internal.h"
 #include "source/common/json/json_sanitizer.h"
 #include "source/common/protobuf/utility.h"
@@ -50,3 +51,84 @@ static void BM_NlohmannWithEscape(benchmark::State& state) {
   }
 }
 BENCHMARK(BM_NlohmannWithEscape);
+
+// A typical JSON access log value, e.g. a user agent, of a little over 100 bytes.
+constexpr absl::string_view long_pass_through_encoding =
+    "Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/537.36 (KHTML, like Gecko) "
+    "Chrome/120.0.0.0 Safari/537.36";
+constexpr absl::string_view long_escaped_encoding =
+    "Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/537.36 (KHTML, like Gecko) "
+    "Chrome/120.0.0.0 Safari/537.36 \"quoted\"\n";
+constexpr absl::string_view long_utf8_encoding =
+    "Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/537.36 (KHTML, like Gecko) "
+    "Chrome/120.0.0.0 Safari/537.36 Καλημέρα κόσμε";
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_SanitizeLongNoEscape(benchmark::State& state) {
+  std::string buffer;
+
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(Envoy::Json::sanitize(buffer, long_pass_through_encoding));
+  }
+}
+BENCHMARK(BM_SanitizeLongNoEscape);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_SanitizeLongWithEscape(benchmark::State& state) {
+  std::string buffer;
+
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(Envoy::Json::sanitize(buffer, long_escaped_encoding));
+  }
+}
+BENCHMARK(BM_SanitizeLongWithEscape);
+
+// The previous implementation of the escaping path, for comparison.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_NlohmannSerializeLongWithEscape(benchmark::State& state) {
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(Envoy::Json::Nlohmann::Factory::serialize(long_escaped_encoding));
+  }
+}
+BENCHMARK(BM_NlohmannSerializeLongWithEscape);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_SanitizeLongUtf8(benchmark::State& state) {
+  std::string buffer;
+
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(Envoy::Json::sanitize(buffer, long_utf8_encoding));
+  }
+}
+BENCHMARK(BM_SanitizeLongUtf8);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_SanitizeLongInvalidUtf8(benchmark::State& state) {
+  const std::string str = absl::StrCat(long_pass_through_encoding, "\xf0\x9d\x84");
+  std::string buffer;
+
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(Envoy::Json::sanitize(buffer, str));
+  }
+}
+BENCHMARK(BM_SanitizeLongInvalidUtf8);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_JsonEscaperLongWithEscape(benchmark::State& state) {
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(Envoy::JsonEscaper::escapeString(
+        long_escaped_encoding, Envoy::JsonEscaper::extraSpace(long_escaped_encoding)));
+  }
+}
+BENCHMARK(BM_JsonEscaperLongWithEscape);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_FindFirstEscapeOrNonAscii(benchmark::State& state) {
+  const std::string str(state.range(0), 'x');
+
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(Envoy::JsonEscaper::findFirstEscapeOrNonAscii(str));
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+}
+BENCHMARK(BM_FindFirstEscapeOrNonAscii)->Arg(8)->Arg(64)->Arg(1024);
@@ -133,6 +133,23 @@ TEST_F(JsonSanitizerTest, Interspersed) {
   EXPECT_EQ("\\ra\\f", sanitizeAndCheckAgainstProtobufJson("\ra\f"));
 }
 
+TEST_F(JsonSanitizerTest, LongInterspersed) {
+  // Strings longer than the blocks the fast path scans at once, with the
+  // characters needing escapes or utf-8 validation at every offset.
+  const std::string clean(40, 'a');
+  for (absl::string_view special : {absl::string_view("\b"), absl::string_view("\""),
+                                    absl::string_view("\177"), LambdaUtf8}) {
+    for (size_t position = 0; position <= clean.size(); ++position) {
+      std::string str = clean;
+      str.insert(position, special);
+      sanitizeAndCheckAgainstProtobufJson(str);
+    }
+  }
+  expectUnchanged(clean);
+  EXPECT_EQ(absl::StrCat(clean, "\\u00ce", clean),
+            sanitizeInvalidAndCheckEscapes(absl::StrCat(clean, truncate(LambdaUtf8), clean)));
+}
+
 TEST_F(JsonSanitizerTest, AllTwoByteUtf8) {
   char buf[2];
   absl::string_view utf8(buf, 2);
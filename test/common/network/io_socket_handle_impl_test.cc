@@ -5,6 +5,7 @@
 #include "source/common/network/listen_socket_impl.h"
 
 #include "test/mocks/api/mocks.h"
+#include "test/mocks/network/mocks.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/network_utility.h"
 #include "test/test_common/threadsafe_singleton_injector.h"
@@ -101,6 +102,78 @@ TEST(IoSocketHandleImpl, LastRoundTripTimeReturnsRttIfSuccessful) {
               Eq(std::chrono::duration_cast<std::chrono::milliseconds>(rtt)));
 }
 
+TEST(IoSocketHandleImpl, SendmmsgSendsAllMessagesInOneCall) {
+  NiceMock<Envoy::Api::MockOsSysCalls> os_sys_calls;
+  auto os_calls =
+      std::make_unique<Envoy::TestThreadsafeSingletonInjector<Envoy::Api::OsSysCallsImpl>>(
+          &os_sys_calls);
+  std::string first = "first";
+  std::string second = "second";
+  Buffer::RawSlice messages[] = {{first.data(), first.size()}, {second.data(), second.size()}};
+  Address::Ipv4Instance peer_address("127.0.0.1", 8125);
+
+  EXPECT_CALL(os_sys_calls, supportsMmsg()).WillOnce(Return(true));
+  EXPECT_CALL(os_sys_calls, sendmmsg(_, _, 2, 0))
+      .WillOnce(Invoke([](os_fd_t, mmsghdr* msgvec, unsigned int, int) {
+        EXPECT_EQ(1, msgvec[0].msg_hdr.msg_iovlen);
+        EXPECT_EQ("first",
+                  absl::string_view(static_cast<char*>(msgvec[0].msg_hdr.msg_iov->iov_base),
+                                    msgvec[0].msg_hdr.msg_iov->iov_len));
+        EXPECT_EQ("second",
+                  absl::string_view(static_cast<char*>(msgvec[1].msg_hdr.msg_iov->iov_base),
+                                    msgvec[1].msg_hdr.msg_iov->iov_len));
+        return Api::SysCallIntResult{2, 0};
+      }));
+  EXPECT_CALL(os_sys_calls, sendmsg(_, _, _)).Times(0);
+
+  IoSocketHandleImpl io_handle;
+  Api::IoCallUint64Result result = io_handle.sendmmsg(messages, 2, 0, peer_address);
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(2, result.return_value_);
+}
+
+TEST(IoSocketHandleImpl, SendmmsgFallsBackToSendmsg) {
+  NiceMock<Envoy::Api::MockOsSysCalls> os_sys_calls;
+  auto os_calls =
+      std::make_unique<Envoy::TestThreadsafeSingletonInjector<Envoy::Api::OsSysCallsImpl>>(
+          &os_sys_calls);
+  std::string first = "first";
+  std::string second = "second";
+  Buffer::RawSlice messages[] = {{first.data(), first.size()}, {second.data(), second.size()}};
+  Address::Ipv4Instance peer_address("127.0.0.1", 8125);
+
+  EXPECT_CALL(os_sys_calls, supportsMmsg()).WillRepeatedly(Return(false));
+  EXPECT_CALL(os_sys_calls, sendmmsg(_, _, _, _)).Times(0);
+  // The messages which follow the first one which can't be sent aren't attempted.
+  EXPECT_CALL(os_sys_calls, sendmsg(_, _, 0))
+      .WillOnce(Return(Api::SysCallSizeResult{5, 0}))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, SOCKET_ERROR_AGAIN}));
+
+  IoSocketHandleImpl io_handle;
+  Api::IoCallUint64Result result = io_handle.sendmmsg(messages, 2, 0, peer_address);
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(1, result.return_value_);
+}
+
+// Peer addresses which don't provide a sockaddr are rejected instead of being dereferenced.
+TEST(IoSocketHandleImpl, SendmmsgInvalidPeerAddress) {
+  NiceMock<Envoy::Api::MockOsSysCalls> os_sys_calls;
+  auto os_calls =
+      std::make_unique<Envoy::TestThreadsafeSingletonInjector<Envoy::Api::OsSysCallsImpl>>(
+          &os_sys_calls);
+  std::string first = "first";
+  Buffer::RawSlice messages[] = {{first.data(), first.size()}};
+  NiceMock<MockResolvedAddress> peer_address("127.0.0.1:8125", "127.0.0.1:8125");
+
+  EXPECT_CALL(os_sys_calls, supportsMmsg()).WillOnce(Return(true));
+  EXPECT_CALL(os_sys_calls, sendmmsg(_, _, _, _)).Times(0);
+
+  IoSocketHandleImpl io_handle;
+  Api::IoCallUint64Result result = io_handle.sendmmsg(messages, 1, 0, peer_address);
+  ASSERT_FALSE(result.ok());
+  EXPECT_EQ(Api::IoError::IoErrorCode::NoSupport, result.err_->getErrorCode());
+}
+
 TEST(IoSocketHandleImpl, InterfaceNameWithPipe) {
   std::string path = TestEnvironment::unixDomainSocketPath("foo.sock");
 
@@ -10,12 +10,16 @@
 #include "source/common/quic/envoy_quic_packet_writer.h"
 
 #include "test/mocks/api/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/stats/mocks.h"
 #include "test/test_common/threadsafe_singleton_injector.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "quiche/quic/test_tools/quic_test_utils.h"
 
 using testing::_;
+using testing::NiceMock;
 using testing::Return;
 
 namespace Envoy {
@@ -141,5 +145,99 @@ TEST_F(EnvoyQuicWriterTest, SendFailureMessageTooBig) {
   EXPECT_FALSE(envoy_quic_writer_.IsWriteBlocked());
 }
 
+class EnvoyQuicDeferredFlushWriterTest : public ::testing::Test {
+public:
+  EnvoyQuicDeferredFlushWriterTest()
+      : flush_cb_(new NiceMock<Event::MockSchedulableCallback>(&dispatcher_)) {
+    auto writer = std::make_unique<NiceMock<quic::test::MockPacketWriter>>();
+    inner_writer_ = writer.get();
+    ON_CALL(*inner_writer_, IsBatchMode()).WillByDefault(Return(true));
+    writer_ = std::make_unique<EnvoyQuicDeferredFlushWriter>(std::move(writer), dispatcher_,
+                                                             *store_.rootScope());
+    self_address_.FromString("::");
+    quic::QuicIpAddress peer_ip;
+    peer_ip.FromString("::1");
+    peer_address_ = quic::QuicSocketAddress(peer_ip, /*port=*/123);
+  }
+
+protected:
+  Stats::TestUtil::TestStore store_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Event::MockSchedulableCallback>* flush_cb_;
+  NiceMock<quic::test::MockPacketWriter>* inner_writer_;
+  std::unique_ptr<EnvoyQuicDeferredFlushWriter> writer_;
+  quic::QuicIpAddress self_address_;
+  quic::QuicSocketAddress peer_address_;
+};
+
+// Flushes requested by connections are deferred to the end of the event loop iteration, where
+// the packets of all of them are flushed at once.
+TEST_F(EnvoyQuicDeferredFlushWriterTest, FlushDeferredToEndOfIteration) {
+  std::string str("Hello World!");
+  quic::QuicPacketWriterParams params;
+  EXPECT_CALL(*inner_writer_, WritePacket(_, str.length(), _, _, _, _))
+      .Times(2)
+      .WillRepeatedly(Return(quic::WriteResult(quic::WRITE_STATUS_OK, 0)));
+  EXPECT_CALL(*inner_writer_, Flush()).Times(0);
+  EXPECT_CALL(*flush_cb_, scheduleCallbackCurrentIteration()).Times(4);
+  EXPECT_EQ(quic::WRITE_STATUS_OK, writer_
+                                       ->WritePacket(str.data(), str.length(), self_address_,
+                                                     peer_address_, nullptr, params)
+                                       .status);
+  EXPECT_EQ(quic::WRITE_STATUS_OK, writer_->Flush().status);
+  EXPECT_EQ(quic::WRITE_STATUS_OK, writer_
+                                       ->WritePacket(str.data(), str.length(), self_address_,
+                                                     peer_address_, nullptr, params)
+                                       .status);
+  EXPECT_EQ(quic::WRITE_STATUS_OK, writer_->Flush().status);
+  EXPECT_TRUE(writer_->IsBatchMode());
+
+  EXPECT_CALL(*inner_writer_, Flush())
+      .WillOnce(Return(quic::WriteResult(quic::WRITE_STATUS_OK, 2 * str.length())));
+  flush_cb_->invokeCallback();
+}
+
+// A failing write doesn't buffer anything, so there is nothing to flush.
+TEST_F(EnvoyQuicDeferredFlushWriterTest, WriteErrorNotFlushed) {
+  std::string str("Hello World!");
+  quic::QuicPacketWriterParams params;
+  EXPECT_CALL(*inner_writer_, WritePacket(_, _, _, _, _, _))
+      .WillOnce(Return(quic::WriteResult(quic::WRITE_STATUS_ERROR, SOCKET_ERROR_NOT_SUP)));
+  EXPECT_CALL(*flush_cb_, scheduleCallbackCurrentIteration()).Times(0);
+  const quic::WriteResult result = writer_->WritePacket(str.data(), str.length(), self_address_,
+                                                        peer_address_, nullptr, params);
+  EXPECT_EQ(quic::WRITE_STATUS_ERROR, result.status);
+  EXPECT_EQ(SOCKET_ERROR_NOT_SUP, result.error_code);
+}
+
+// Packets buffered while the socket was blocked are flushed once it is writable again, and a
+// failed flush leaves the inner writer blocked.
+TEST_F(EnvoyQuicDeferredFlushWriterTest, FlushAfterWritable) {
+  EXPECT_CALL(*inner_writer_, IsWriteBlocked()).WillOnce(Return(true));
+  EXPECT_TRUE(writer_->IsWriteBlocked());
+  EXPECT_CALL(*inner_writer_, SetWritable());
+  EXPECT_CALL(*flush_cb_, scheduleCallbackCurrentIteration());
+  writer_->SetWritable();
+
+  EXPECT_CALL(*inner_writer_, Flush())
+      .WillOnce(Return(quic::WriteResult(quic::WRITE_STATUS_BLOCKED, SOCKET_ERROR_AGAIN)));
+  flush_cb_->invokeCallback();
+  EXPECT_EQ(0U, store_.counter("deferred_flush_errors").value());
+}
+
+// The error of a failed deferred flush is counted, but not returned to the connections which
+// flush the writer next, as it can't be attributed to any of them.
+TEST_F(EnvoyQuicDeferredFlushWriterTest, FlushErrorCountedNotReturned) {
+  EXPECT_CALL(*flush_cb_, scheduleCallbackCurrentIteration()).Times(2);
+  EXPECT_EQ(quic::WRITE_STATUS_OK, writer_->Flush().status);
+
+  EXPECT_CALL(*inner_writer_, Flush())
+      .WillOnce(Return(quic::WriteResult(quic::WRITE_STATUS_ERROR, SOCKET_ERROR_NOT_SUP)));
+  flush_cb_->invokeCallback();
+  EXPECT_EQ(1U, store_.counter("deferred_flush_errors").value());
+
+  EXPECT_EQ(quic::WRITE_STATUS_OK, writer_->Flush().status);
+}
+
 } // namespace Quic
 } // namespace Envoy
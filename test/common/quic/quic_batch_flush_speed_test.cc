@@ -0,0 +1,117 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "source/common/api/api_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/network/listen_socket_impl.h"
+#include "source/common/network/utility.h"
+#include "source/common/quic/envoy_quic_packet_writer.h"
+#include "source/common/quic/envoy_quic_utils.h"
+#include "source/common/quic/udp_gso_batch_writer.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+#if UDP_GSO_BATCH_WRITER_COMPILETIME_SUPPORT
+#include "quiche/quic/core/quic_syscall_wrapper.h"
+#endif
+
+using ::benchmark::State;
+using Envoy::benchmark::skipExpensiveBenchmarks;
+
+#if UDP_GSO_BATCH_WRITER_COMPILETIME_SUPPORT
+
+namespace Envoy {
+namespace Quic {
+namespace {
+
+// Counts the sendmsg() calls of the GSO batch writer, each of which sends one batch.
+class CountingSyscallWrapper : public quic::QuicSyscallWrapper {
+public:
+  ssize_t Sendmsg(int sockfd, const msghdr* msg, int flags) override {
+    ++sendmsg_calls_;
+    return quic::QuicSyscallWrapper::Sendmsg(sockfd, msg, flags);
+  }
+
+  uint64_t sendmsg_calls_{};
+};
+
+// Sends the packets of a connection which writes several bursts per event loop iteration, as it
+// does when it processes several received packets in one read, to a loopback socket through a
+// GSO batch writer. Like QUICHE connections, the connection flushes its writer after each burst.
+class QuicBatchFlushSpeedTest {
+public:
+  QuicBatchFlushSpeedTest(bool flush_per_event_loop)
+      : api_(Api::createApiForTest(store_)), dispatcher_(api_->allocateDispatcher("test_thread")),
+        server_socket_(Network::Utility::getCanonicalIpv4LoopbackAddress(), nullptr, true),
+        client_socket_(Network::Utility::getCanonicalIpv4LoopbackAddress(), nullptr, true),
+        self_address_(quic::QuicIpAddress::Loopback4()),
+        peer_address_(envoyIpAddressToQuicSocketAddress(
+            client_socket_.connectionInfoProvider().localAddress()->ip())) {
+    writer_ = std::make_unique<UdpGsoBatchWriter>(server_socket_.ioHandle(), *store_.rootScope());
+    if (flush_per_event_loop) {
+      writer_ = std::make_unique<EnvoyQuicDeferredFlushWriter>(std::move(writer_), *dispatcher_,
+                                                               *store_.rootScope());
+    }
+  }
+
+  void sendBursts(uint64_t bursts, uint64_t packets_per_burst) {
+    quic::QuicPacketWriterParams params;
+    for (uint64_t burst = 0; burst < bursts; ++burst) {
+      for (uint64_t packet = 0; packet < packets_per_burst; ++packet) {
+        const quic::WriteResult result = writer_->WritePacket(
+            packet_.data(), packet_.size(), self_address_, peer_address_, nullptr, params);
+        // Nothing reads the client socket, so the kernel drops what doesn't fit into its buffer
+        // instead of blocking the writer.
+        RELEASE_ASSERT(!quic::IsWriteError(result.status) &&
+                           result.status != quic::WRITE_STATUS_BLOCKED,
+                       "");
+      }
+      writer_->Flush();
+    }
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  Network::UdpListenSocket server_socket_;
+  Network::UdpListenSocket client_socket_;
+  quic::QuicIpAddress self_address_;
+  quic::QuicSocketAddress peer_address_;
+  std::unique_ptr<quic::QuicPacketWriter> writer_;
+  const std::string packet_ = std::string(1200, 'x');
+};
+
+} // namespace
+} // namespace Quic
+} // namespace Envoy
+
+// Measures the cost of sending the packets of an event loop iteration, and the number of
+// sendmsg() calls it takes, when the writer is flushed after each burst of a connection, and when
+// the flushes are deferred to the end of the iteration.
+static void batchFlush(State& state) {
+  const bool flush_per_event_loop = state.range(0);
+  // if we've been instructed to skip tests, only run once no matter the argument:
+  const uint64_t bursts = skipExpensiveBenchmarks() ? 1 : state.range(1);
+  const uint64_t packets_per_burst = 2;
+  Envoy::Quic::QuicBatchFlushSpeedTest speed_test(flush_per_event_loop);
+  Envoy::Quic::CountingSyscallWrapper syscalls;
+  quic::ScopedGlobalSyscallWrapperOverride syscall_override(&syscalls);
+
+  uint64_t packets = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    speed_test.sendBursts(bursts, packets_per_burst);
+    packets += bursts * packets_per_burst;
+  }
+  state.counters["packets_per_sendmsg"] =
+      static_cast<double>(packets) / std::max<uint64_t>(syscalls.sendmsg_calls_, 1);
+  state.SetItemsProcessed(packets);
+}
+
+BENCHMARK(batchFlush)->ArgsProduct({{0, 1}, {1, 4, 16}});
+
+#endif // UDP_GSO_BATCH_WRITER_COMPILETIME_SUPPORT
@@ -0,0 +1,74 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/quic/envoy_deterministic_connection_id_generator.h"
+
+#include "test/benchmark/main.h"
+
+#include "absl/hash/hash.h"
+#include "benchmark/benchmark.h"
+
+using ::benchmark::State;
+
+namespace Envoy {
+namespace Quic {
+namespace {
+
+// A client connection of the benchmark, which has a connection ID and, as the client may be
+// behind a NAT which rebinds its port, a sequence of source ports.
+struct Client {
+  Buffer::OwnedImpl short_header_packet;
+  uint16_t source_port;
+};
+
+// Builds a 1-RTT (short header) packet of a typical size for the given connection ID.
+void buildShortHeaderPacket(uint64_t connection_id, Buffer::Instance& packet) {
+  packet.writeByte<uint8_t>(0x40);
+  packet.writeBEInt<uint64_t>(connection_id);
+  packet.add(std::string(1200, 'x'));
+}
+
+std::vector<Client> makeClients(size_t num_clients) {
+  std::vector<Client> clients(num_clients);
+  for (size_t i = 0; i < num_clients; ++i) {
+    // Spread the connection IDs like the deterministic generator does for random client CIDs.
+    buildShortHeaderPacket(absl::HashOf(i, "cid"), clients[i].short_header_packet);
+    clients[i].source_port = 1024 + i;
+  }
+  return clients;
+}
+
+} // namespace
+} // namespace Quic
+} // namespace Envoy
+
+// Measures the per-packet cost of selecting the worker of a packet by its connection ID, which
+// the listeners of all workers do for every packet, and reports the share of packets which would
+// have to be forwarded to another worker if the kernel distributed them by their 4-tuple hash,
+// as SO_REUSEPORT does without the BPF program, after every client rebound its NAT port.
+static void workerSelection(State& state) {
+  const uint32_t concurrency = state.range(0);
+  Envoy::Quic::EnvoyDeterministicConnectionIdGeneratorFactory factory;
+  const Envoy::Quic::QuicConnectionIdWorkerSelector selector =
+      factory.getCompatibleConnectionIdWorkerSelector(concurrency);
+  std::vector<Envoy::Quic::Client> clients = Envoy::Quic::makeClients(1000);
+
+  uint64_t packets = 0;
+  uint64_t forwarded = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    for (auto& client : clients) {
+      // The kernel's choice without BPF, after the client's port changed.
+      const uint32_t hashed_worker = absl::HashOf(++client.source_port) % concurrency;
+      const uint32_t worker = selector(client.short_header_packet, hashed_worker);
+      RELEASE_ASSERT(worker < concurrency, "");
+      forwarded += worker != hashed_worker;
+      ++packets;
+    }
+  }
+  state.counters["forwarded_without_bpf"] = static_cast<double>(forwarded) / packets;
+  state.SetItemsProcessed(packets);
+}
+
+BENCHMARK(workerSelection)->Arg(2)->Arg(8)->Arg(32);
@@ -0,0 +1,114 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures the memory held by per-cluster histograms which every worker has recorded, and how much
+// of it remains once they have been idle for a few stats flushes. Memory is only reported when
+// Envoy is built with tcmalloc.
+
+#include <cstdint>
+#include <vector>
+
+#include "source/common/memory/stats.h"
+#include "source/common/stats/thread_local_store.h"
+#include "source/exe/process_wide.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/stats/real_thread_test_base.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+class HistogramMemoryTest : public ThreadLocalRealThreadsMixin {
+public:
+  HistogramMemoryTest(uint32_t num_workers) : ThreadLocalRealThreadsMixin(num_workers) {}
+
+  ~HistogramMemoryTest() {
+    shutdownThreading();
+    // First, wait for the main-dispatcher to initiate the cross-thread TLS cleanup.
+    mainDispatchBlock();
+
+    // Next, wait for all the worker threads to complete their TLS cleanup.
+    tlsBlock();
+
+    // Finally, wait for the final central-cache cleanup, which occurs on the main thread.
+    mainDispatchBlock();
+  }
+
+  // Creates two histograms per cluster, as upstream clusters do for their request and connection
+  // times.
+  void createHistograms(uint32_t num_clusters) {
+    runOnMainBlocking([this, num_clusters]() {
+      for (uint32_t i = 0; i < num_clusters; ++i) {
+        ScopeSharedPtr scope = store_->createScope(absl::StrCat("cluster.cluster_", i, "."));
+        histograms_.push_back(
+            &scope->histogramFromString("upstream_rq_time", Histogram::Unit::Milliseconds));
+        histograms_.push_back(
+            &scope->histogramFromString("upstream_cx_connect_ms", Histogram::Unit::Milliseconds));
+        scopes_.push_back(scope);
+      }
+    });
+  }
+
+  void recordOnAllWorkers() {
+    runOnAllWorkersBlocking([this]() {
+      for (Histogram* histogram : histograms_) {
+        histogram->recordValue(42);
+      }
+    });
+  }
+
+  void mergeHistograms() {
+    BlockingBarrier blocking_barrier(1);
+    runOnMainBlocking([this, &blocking_barrier]() {
+      store_->mergeHistograms(blocking_barrier.decrementCountFn());
+    });
+  }
+
+private:
+  std::vector<ScopeSharedPtr> scopes_;
+  std::vector<Histogram*> histograms_;
+};
+
+// Reports the bytes allocated by the histograms of all the workers, while they are recorded and
+// once they have been idle for enough merges to release their buffers.
+void histogramMemory(::benchmark::State& state) {
+  const uint32_t num_clusters = state.range(0);
+  const uint32_t num_workers = state.range(1);
+  if (benchmark::skipExpensiveBenchmarks() && num_clusters > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  ProcessWide process_wide; // Process-wide state setup/teardown (excluding grpc).
+  for (auto _ : state) {    // NOLINT: Silences warning about dead store
+    HistogramMemoryTest test(num_workers);
+    test.createHistograms(num_clusters);
+    const int64_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+
+    test.recordOnAllWorkers();
+    test.mergeHistograms();
+    const int64_t active_mem = Memory::Stats::totalCurrentlyAllocated();
+
+    for (uint32_t i = 0; i <= ThreadLocalHistogramImpl::MaxEmptyMerges; ++i) {
+      test.mergeHistograms();
+    }
+    const int64_t idle_mem = Memory::Stats::totalCurrentlyAllocated();
+
+    state.counters["active_bytes"] = active_mem - start_mem;
+    state.counters["idle_bytes"] = idle_mem - start_mem;
+  }
+}
+
+BENCHMARK(histogramMemory)
+    ->ArgsProduct({{100, 1000, 10000}, {1, 4, 16, 64}})
+    ->ArgNames({"clusters", "workers"})
+    ->Iterations(1)
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "source/common/stats/stat_name_cache.h"
+#include "source/common/stats/symbol_table.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+class StatNameCacheTest : public testing::Test {
+protected:
+  // Looks up a name, and counts the values which the cache computes.
+  std::string& get(const std::string& name) {
+    StatNameManagedStorage stat_name(name, symbol_table_);
+    return cache_.get(stat_name.statName(), [this, &name]() {
+      ++computed_;
+      return name + "-value";
+    });
+  }
+
+  SymbolTable symbol_table_;
+  StatNameCache<std::string> cache_{symbol_table_};
+  uint32_t computed_{};
+};
+
+TEST_F(StatNameCacheTest, ValuesAreComputedOnce) {
+  EXPECT_EQ("a.b-value", get("a.b"));
+  EXPECT_EQ("a.b-value", get("a.b"));
+  EXPECT_EQ("a.c-value", get("a.c"));
+  EXPECT_EQ(2U, computed_);
+  EXPECT_EQ(2U, cache_.size());
+
+  // Values can be updated in place.
+  get("a.b") = "updated";
+  EXPECT_EQ("updated", get("a.b"));
+}
+
+TEST_F(StatNameCacheTest, UnusedEntriesAreEvicted) {
+  get("a.b");
+  get("a.c");
+  cache_.evictUnused();
+  EXPECT_EQ(2U, cache_.size());
+
+  get("a.b");
+  cache_.evictUnused();
+  EXPECT_EQ(1U, cache_.size());
+  EXPECT_EQ("a.b-value", get("a.b"));
+  EXPECT_EQ(2U, computed_);
+
+  cache_.evictUnused();
+  cache_.evictUnused();
+  EXPECT_EQ(0U, cache_.size());
+}
+
+// The cache holds the symbols of its entries, which are released once they are evicted.
+TEST_F(StatNameCacheTest, EntriesHoldTheirSymbols) {
+  get("x.y");
+  EXPECT_EQ(2U, symbol_table_.numSymbols());
+  cache_.evictUnused();
+  cache_.evictUnused();
+  EXPECT_EQ(0U, symbol_table_.numSymbols());
+}
+
+TEST_F(StatNameCacheTest, ForEach) {
+  get("a");
+  get("b");
+  std::vector<std::string> values;
+  cache_.forEach([&values](std::string& value) { values.push_back(value); });
+  std::sort(values.begin(), values.end());
+  EXPECT_EQ((std::vector<std::string>{"a-value", "b-value"}), values);
+}
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
@@ -36,6 +36,7 @@
 using testing::_;
 using testing::HasSubstr;
 using testing::InSequence;
+using testing::IsEmpty;
 using testing::NiceMock;
 using testing::Ref;
 using testing::Return;
@@ -67,6 +68,20 @@ public:
         },
         [num_tls_hist_cb, num_tls_histograms]() { num_tls_hist_cb(*num_tls_histograms); });
   }
+
+  // Calculates the number of circllhist buffers allocated by the TLS histograms across all
+  // threads. Like numTlsHistograms(), this must be called from the "main thread".
+  static void numTlsHistogramBuffers(ThreadLocalStoreImpl& thread_local_store_impl,
+                                     const std::function<void(uint32_t)>& num_buffers_cb) {
+    auto num_buffers = std::make_shared<std::atomic<uint32_t>>(0);
+    thread_local_store_impl.tls_cache_->runOnAllThreads(
+        [num_buffers](OptRef<ThreadLocalStoreImpl::TlsCache> tls_cache) {
+          for (const auto& id_hist : tls_cache->tls_histogram_cache_) {
+            *num_buffers += id_hist.second->numAllocatedBuffers();
+          }
+        },
+        [num_buffers_cb, num_buffers]() { num_buffers_cb(*num_buffers); });
+  }
 };
 
 class StatsThreadLocalStoreTest : public testing::Test {
@@ -224,6 +239,13 @@ public:
     }
   }
 
+  uint32_t numTlsHistogramBuffers() {
+    uint32_t num = 0;
+    ThreadLocalStoreTestingPeer::numTlsHistogramBuffers(
+        *store_, [&num](uint32_t num_buffers) { num = num_buffers; });
+    return num;
+  }
+
   TestUtil::TestSinkPredicates& testSinkPredicatesOrDie() {
     auto predicates = dynamic_cast<TestUtil::TestSinkPredicates*>(store_->sinkPredicates().ptr());
     ASSERT(predicates != nullptr);
@@ -1819,6 +1841,61 @@ TEST_F(HistogramTest, ParentHistogramBucketSummaryAndDetail) {
   EXPECT_THAT(parent_histogram->detailedIntervalBuckets(), UnorderedElementsAre(Bucket{10, 1, 1}));
 }
 
+TEST_F(HistogramTest, TlsBuffersAreAllocatedOnRecordAndReleasedWhenIdle) {
+  Histogram& h1 = scope_.histogramFromString("h1", Histogram::Unit::Unspecified);
+  store_->mergeHistograms([]() -> void {});
+  EXPECT_EQ(0U, numTlsHistogramBuffers());
+
+  expectCallAndAccumulate(h1, 1);
+  EXPECT_EQ(1U, numTlsHistogramBuffers());
+  EXPECT_EQ(1U, validateMerge());
+  expectCallAndAccumulate(h1, 2);
+  EXPECT_EQ(2U, numTlsHistogramBuffers());
+  EXPECT_EQ(1U, validateMerge());
+
+  // Both buffers are released by consecutive merges once the histogram is idle.
+  for (uint32_t i = 1; i < ThreadLocalHistogramImpl::MaxEmptyMerges; ++i) {
+    EXPECT_EQ(1U, validateMerge());
+    EXPECT_EQ(2U, numTlsHistogramBuffers());
+  }
+  EXPECT_EQ(1U, validateMerge());
+  EXPECT_EQ(1U, numTlsHistogramBuffers());
+  EXPECT_EQ(1U, validateMerge());
+  EXPECT_EQ(0U, numTlsHistogramBuffers());
+
+  // Recording again allocates a buffer, and the values are merged as usual.
+  expectCallAndAccumulate(h1, 3);
+  EXPECT_EQ(1U, numTlsHistogramBuffers());
+  EXPECT_EQ(1U, validateMerge());
+}
+
+TEST_F(HistogramTest, MergedHistogramsAreCompacted) {
+  Histogram& histogram = scope_.histogramFromString("histogram", Histogram::Unit::Unspecified);
+  // Record enough distinct values for the merged histograms to grow past their initial bin.
+  for (uint64_t value = 1; value <= 200; ++value) {
+    EXPECT_CALL(sink_, onHistogramComplete(Ref(histogram), value * 10));
+    histogram.recordValue(value * 10);
+  }
+  store_->mergeHistograms([]() -> void {});
+  ParentHistogramSharedPtr parent_histogram = store_->histograms()[0];
+  const std::vector<Bucket> total_buckets = parent_histogram->detailedTotalBuckets();
+  EXPECT_EQ(total_buckets, parent_histogram->detailedIntervalBuckets());
+  EXPECT_GT(total_buckets.size(), 100U);
+
+  for (uint32_t i = 0; i < ThreadLocalHistogramImpl::MaxEmptyMerges; ++i) {
+    store_->mergeHistograms([]() -> void {});
+  }
+  EXPECT_THAT(parent_histogram->detailedIntervalBuckets(), IsEmpty());
+  EXPECT_EQ(total_buckets, parent_histogram->detailedTotalBuckets());
+  EXPECT_EQ(200U, parent_histogram->cumulativeStatistics().sampleCount());
+
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(histogram), 10));
+  histogram.recordValue(10);
+  store_->mergeHistograms([]() -> void {});
+  EXPECT_THAT(parent_histogram->detailedIntervalBuckets(), UnorderedElementsAre(Bucket{10, 1, 1}));
+  EXPECT_EQ(201U, parent_histogram->cumulativeStatistics().sampleCount());
+}
+
 TEST_F(HistogramTest, ForEachHistogram) {
   std::vector<std::reference_wrapper<Histogram>> histograms;
 
@@ -0,0 +1,111 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+#include <vector>
+
+#include "source/common/common/assert.h"
+#include "source/common/tls/cert_validator/default_validator.h"
+#include "source/common/tls/cert_validator/san_matcher.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/common/tls/cert_validator/test_common.h"
+#include "test/common/tls/ssl_test_utility.h"
+#include "test/mocks/server/server_factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "openssl/ssl.h"
+#include "tools/cpp/runfiles/runfiles.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+constexpr uint32_t SanMatcherCount = 1000;
+
+void setRunfiles() {
+  static std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles = []() {
+    std::string error;
+    std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
+        bazel::tools::cpp::runfiles::Runfiles::Create("default_validator_benchmark", &error));
+    Envoy::TestEnvironment::setRunfiles(runfiles.get());
+    return runfiles;
+  }();
+}
+
+// A mesh peer allowing a thousand DNS names, where the name of the peer is the last one.
+std::vector<envoy::extensions::transport_sockets::tls::v3::SubjectAltNameMatcher> sanMatchers() {
+  std::vector<envoy::extensions::transport_sockets::tls::v3::SubjectAltNameMatcher> matchers;
+  for (uint32_t i = 0; i < SanMatcherCount; ++i) {
+    envoy::extensions::transport_sockets::tls::v3::SubjectAltNameMatcher matcher;
+    matcher.set_san_type(envoy::extensions::transport_sockets::tls::v3::SubjectAltNameMatcher::DNS);
+    *matcher.mutable_matcher() = TestUtility::createExactMatcher(
+        i + 1 == SanMatcherCount ? "server1.example.com" : absl::StrCat("host", i, ".example.org"));
+    matchers.push_back(matcher);
+  }
+  return matchers;
+}
+
+// Measures matching the SANs of a certificate against a thousand exact DNS matchers, evaluated
+// one by one or compiled.
+static void sanMatching(benchmark::State& state) {
+  setRunfiles();
+  NiceMock<Server::Configuration::MockServerFactoryContext> context;
+  const bool compiled = state.range(0) != 0;
+  std::vector<SanMatcherPtr> matchers;
+  if (compiled) {
+    auto matcher = CompiledSanMatcher::create(sanMatchers(), context);
+    RELEASE_ASSERT(matcher.ok(), "");
+    matchers.push_back(std::move(*matcher));
+  } else {
+    for (const auto& matcher : sanMatchers()) {
+      matchers.push_back(createStringSanMatcher(matcher, context));
+    }
+  }
+  bssl::UniquePtr<X509> cert = readCertFromFile(
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_cert.pem"));
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    RELEASE_ASSERT(DefaultCertValidator::matchSubjectAltName(cert.get(), matchers), "");
+  }
+}
+
+BENCHMARK(sanMatching)->Arg(0)->Arg(1)->Unit(::benchmark::kMicrosecond);
+
+// Measures the validation of the certificate chain a peer presents in each handshake, with a
+// thousand SAN matchers, with and without the verification cache.
+static void certChainValidation(benchmark::State& state) {
+  setRunfiles();
+  NiceMock<Server::Configuration::MockServerFactoryContext> context;
+  Stats::TestUtil::TestStore store;
+  SslStats stats = generateSslStats(*store.rootScope());
+  envoy::config::core::v3::TypedExtensionConfig typed_conf;
+  TestCertificateValidationContextConfig config(
+      typed_conf, false, sanMatchers(),
+      TestEnvironment::readFileToStringForTest(
+          TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/ca_cert.pem")),
+      absl::nullopt, state.range(0));
+  DefaultCertValidator validator(&config, stats, context);
+  bssl::UniquePtr<SSL_CTX> ssl_ctx(SSL_CTX_new(TLS_method()));
+  RELEASE_ASSERT(validator.initializeSslContexts({ssl_ctx.get()}, false).ok(), "");
+  bssl::UniquePtr<STACK_OF(X509)> cert_chain = readCertChainFromFile(
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_cert.pem"));
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    const ValidationResults results =
+        validator.doVerifyCertChain(*cert_chain, /*callback=*/nullptr,
+                                    /*transport_socket_options=*/nullptr, *ssl_ctx, {}, false, "");
+    RELEASE_ASSERT(results.status == ValidationResults::ValidationStatus::Successful, "");
+  }
+  state.counters["cache_hits"] = stats.verify_cache_hit_.value();
+}
+
+// Verification cache size.
+BENCHMARK(certChainValidation)->Arg(0)->Arg(1024)->Unit(::benchmark::kMicrosecond);
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
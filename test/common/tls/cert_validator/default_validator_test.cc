@@ -8,6 +8,7 @@
 #include "test/common/tls/ssl_test_utility.h"
 #include "test/mocks/server/server_factory_context.h"
 #include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
@@ -20,6 +21,7 @@ namespace Extensions {
 namespace TransportSockets {
 namespace Tls {
 
+using testing::ReturnRef;
 using TestCertificateValidationContextConfigPtr =
     std::unique_ptr<TestCertificateValidationContextConfig>;
 using X509StoreContextPtr = CSmartPtr<X509_STORE_CTX, X509_STORE_CTX_free>;
@@ -705,6 +707,7 @@ public:
   bool onlyVerifyLeafCertificateCrl() const override { return false; }
   absl::optional<uint32_t> maxVerifyDepth() const override { return absl::nullopt; }
   bool autoSniSanMatch() const override { return false; }
+  uint32_t verificationCacheSize() const override { return 0; }
 
 private:
   std::string s_;
@@ -712,6 +715,83 @@ private:
   std::vector<envoy::extensions::transport_sockets::tls::v3::SubjectAltNameMatcher> matchers_;
 };
 
+// Verified chains are not verified again until the first certificate of the chain expires.
+TEST(DefaultCertValidatorTest, VerificationCache) {
+  NiceMock<Server::Configuration::MockServerFactoryContext> context;
+  Event::SimulatedTimeSystem time_system;
+  ON_CALL(context, timeSource()).WillByDefault(ReturnRef(time_system));
+  Stats::TestUtil::TestStore test_store;
+  SslStats stats = generateSslStats(*test_store.rootScope());
+  envoy::config::core::v3::TypedExtensionConfig typed_conf;
+  std::vector<envoy::extensions::transport_sockets::tls::v3::SubjectAltNameMatcher> san_matchers{};
+  auto test_config = std::make_unique<TestCertificateValidationContextConfig>(
+      typed_conf, false, san_matchers,
+      TestEnvironment::readFileToStringForTest(
+          TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/ca_cert.pem")),
+      absl::nullopt, 16);
+  DefaultCertValidator validator(test_config.get(), stats, context);
+  SSLContextPtr ssl_ctx = SSL_CTX_new(TLS_method());
+  ASSERT_TRUE(validator.initializeSslContexts({ssl_ctx.get()}, false).ok());
+
+  auto verify = [&](const std::string& cert_file) {
+    bssl::UniquePtr<STACK_OF(X509)> cert_chain = readCertChainFromFile(
+        TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/" + cert_file));
+    return validator
+        .doVerifyCertChain(*cert_chain, /*callback=*/nullptr,
+                           /*transport_socket_options=*/nullptr, *ssl_ctx, {}, false, "")
+        .status;
+  };
+
+  EXPECT_EQ(ValidationResults::ValidationStatus::Successful, verify("san_dns_cert.pem"));
+  EXPECT_EQ(1, stats.verify_cache_miss_.value());
+  EXPECT_EQ(ValidationResults::ValidationStatus::Successful, verify("san_dns_cert.pem"));
+  EXPECT_EQ(1, stats.verify_cache_hit_.value());
+  EXPECT_EQ(ValidationResults::ValidationStatus::Successful, verify("san_uri_cert.pem"));
+  EXPECT_EQ(2, stats.verify_cache_miss_.value());
+
+  // Failed verifications are not cached.
+  EXPECT_EQ(ValidationResults::ValidationStatus::Failed, verify("selfsigned_cert.pem"));
+  EXPECT_EQ(ValidationResults::ValidationStatus::Failed, verify("selfsigned_cert.pem"));
+  EXPECT_EQ(4, stats.verify_cache_miss_.value());
+  EXPECT_EQ(2, stats.fail_verify_error_.value());
+
+  // The result expires with the certificate.
+  bssl::UniquePtr<X509> cert = readCertFromFile(
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_cert.pem"));
+  time_system.setSystemTime(Utility::getExpirationTime(*cert));
+  EXPECT_EQ(ValidationResults::ValidationStatus::Successful, verify("san_dns_cert.pem"));
+  EXPECT_EQ(5, stats.verify_cache_miss_.value());
+  EXPECT_EQ(1, stats.verify_cache_hit_.value());
+}
+
+TEST(DefaultCertValidatorTest, VerificationCacheEviction) {
+  Event::SimulatedTimeSystem time_system;
+  Stats::TestUtil::TestStore test_store;
+  SslStats stats = generateSslStats(*test_store.rootScope());
+  // One entry per shard.
+  CertVerificationCache cache(1, time_system, stats);
+  bssl::UniquePtr<STACK_OF(X509)> cert_chain = readCertChainFromFile(
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_cert.pem"));
+
+  const uint32_t entries = 4 * CertVerificationCache::NumShards;
+  for (uint32_t i = 0; i < entries; ++i) {
+    cache.insert(absl::StrCat("key", i), *cert_chain, SystemTime::max());
+  }
+  EXPECT_LE(cache.size(), CertVerificationCache::NumShards);
+
+  // Nothing is cached past the given expiration, e.g. the next update of a CRL.
+  const std::string key = CertVerificationCache::key(*cert_chain, false);
+  EXPECT_EQ(SHA256_DIGEST_LENGTH, key.size());
+  cache.insert(key, *cert_chain, time_system.systemTime());
+  EXPECT_FALSE(cache.lookup(key));
+  cache.insert(key, *cert_chain, time_system.systemTime() + std::chrono::hours(1));
+  EXPECT_TRUE(cache.lookup(key));
+  time_system.advanceTimeWait(std::chrono::hours(1));
+  EXPECT_FALSE(cache.lookup(key));
+  // The key depends on the side which verifies the chain.
+  EXPECT_NE(key, CertVerificationCache::key(*cert_chain, true));
+}
+
 TEST(DefaultCertValidatorTest, TestUnexpectedSanMatcherType) {
   NiceMock<Server::Configuration::MockServerFactoryContext> context;
 
@@ -15,6 +15,25 @@ namespace Extensions {
 namespace TransportSockets {
 namespace Tls {
 
+using envoy::extensions::transport_sockets::tls::v3::SubjectAltNameMatcher;
+
+bssl::UniquePtr<GENERAL_NAME> makeGeneralName(int type, absl::string_view value) {
+  bssl::UniquePtr<GENERAL_NAME> general_name(GENERAL_NAME_new());
+  ASN1_STRING* string =
+      ASN1_STRING_type_new(type == GEN_IPADD ? V_ASN1_OCTET_STRING : V_ASN1_IA5STRING);
+  ASN1_STRING_set(string, value.data(), value.size());
+  GENERAL_NAME_set0_value(general_name.get(), type, string);
+  return general_name;
+}
+
+SubjectAltNameMatcher makeSanMatcher(SubjectAltNameMatcher::SanType san_type,
+                                     const envoy::type::matcher::v3::StringMatcher& matcher) {
+  SubjectAltNameMatcher san_matcher;
+  san_matcher.set_san_type(san_type);
+  *san_matcher.mutable_matcher() = matcher;
+  return san_matcher;
+}
+
 // Verify that we get a valid string san matcher for all valid san types.
 TEST(SanMatcherConfigTest, TestValidSanType) {
   NiceMock<Server::Configuration::MockServerFactoryContext> context;
@@ -76,6 +95,86 @@ TEST(SanMatcherConfigTest, UnspecifiedSanType) {
   EXPECT_EQ(createStringSanMatcher(san_matcher, context), nullptr);
 }
 
+TEST(CompiledSanMatcherTest, ExactNames) {
+  NiceMock<Server::Configuration::MockServerFactoryContext> context;
+  envoy::type::matcher::v3::StringMatcher uri_ignore_case =
+      TestUtility::createExactMatcher("spiffe://Cluster.local/ns/b");
+  uri_ignore_case.set_ignore_case(true);
+  auto matcher = CompiledSanMatcher::create(
+      {makeSanMatcher(SubjectAltNameMatcher::DNS,
+                      TestUtility::createExactMatcher("Server1.Example.com")),
+       makeSanMatcher(SubjectAltNameMatcher::URI,
+                      TestUtility::createExactMatcher("spiffe://cluster.local/ns/a")),
+       makeSanMatcher(SubjectAltNameMatcher::URI, uri_ignore_case),
+       makeSanMatcher(SubjectAltNameMatcher::EMAIL,
+                      TestUtility::createExactMatcher("admin@example.com"))},
+      context);
+  ASSERT_TRUE(matcher.ok());
+
+  // DNS names are matched with DNS semantics, ignoring case and honoring wildcard SANs.
+  EXPECT_TRUE((*matcher)->match(makeGeneralName(GEN_DNS, "server1.example.com").get()));
+  EXPECT_TRUE((*matcher)->match(makeGeneralName(GEN_DNS, "SERVER1.example.com").get()));
+  EXPECT_TRUE((*matcher)->match(makeGeneralName(GEN_DNS, "*.example.com").get()));
+  EXPECT_TRUE((*matcher)->match(makeGeneralName(GEN_DNS, "server*.example.com").get()));
+  EXPECT_FALSE((*matcher)->match(makeGeneralName(GEN_DNS, "*.server1.example.com").get()));
+  EXPECT_FALSE((*matcher)->match(makeGeneralName(GEN_DNS, "*.com").get()));
+  EXPECT_FALSE((*matcher)->match(makeGeneralName(GEN_DNS, "server2.example.com").get()));
+
+  EXPECT_TRUE((*matcher)->match(makeGeneralName(GEN_URI, "spiffe://cluster.local/ns/a").get()));
+  EXPECT_FALSE((*matcher)->match(makeGeneralName(GEN_URI, "spiffe://cluster.local/NS/a").get()));
+  EXPECT_TRUE((*matcher)->match(makeGeneralName(GEN_URI, "SPIFFE://cluster.local/ns/B").get()));
+  EXPECT_TRUE((*matcher)->match(makeGeneralName(GEN_EMAIL, "admin@example.com").get()));
+  // The type of the name has to match.
+  EXPECT_FALSE((*matcher)->match(makeGeneralName(GEN_DNS, "admin@example.com").get()));
+  EXPECT_FALSE((*matcher)->match(makeGeneralName(GEN_EMAIL, "server1.example.com").get()));
+}
+
+// The compiled matcher matches exactly the names which one of its matchers matches.
+TEST(CompiledSanMatcherTest, SameResultsAsMatchers) {
+  NiceMock<Server::Configuration::MockServerFactoryContext> context;
+  const std::vector<SubjectAltNameMatcher> san_matchers = {
+      makeSanMatcher(SubjectAltNameMatcher::DNS, TestUtility::createExactMatcher("a.example.com")),
+      makeSanMatcher(SubjectAltNameMatcher::DNS,
+                     TestUtility::createExactMatcher("xn--a.example.net")),
+      makeSanMatcher(SubjectAltNameMatcher::DNS, TestUtility::createPrefixMatcher("api.")),
+      makeSanMatcher(SubjectAltNameMatcher::URI,
+                     TestUtility::createRegexMatcher(R"raw(spiffe://[^/]*/ns/c)raw")),
+      makeSanMatcher(SubjectAltNameMatcher::IP_ADDRESS, TestUtility::createExactMatcher("1.2.3.4")),
+  };
+  auto compiled = CompiledSanMatcher::create(san_matchers, context);
+  ASSERT_TRUE(compiled.ok());
+  std::vector<SanMatcherPtr> matchers;
+  for (const SubjectAltNameMatcher& san_matcher : san_matchers) {
+    matchers.push_back(createStringSanMatcher(san_matcher, context));
+  }
+
+  const std::vector<std::pair<int, std::string>> names = {
+      {GEN_DNS, "a.example.com"},     {GEN_DNS, "*.example.com"},
+      {GEN_DNS, "b*.example.com"},    {GEN_DNS, "*.example.net"},
+      {GEN_DNS, "xn--*.example.net"}, {GEN_DNS, "api.example.org"},
+      {GEN_DNS, "*.*.example.com"},   {GEN_URI, "spiffe://cluster.local/ns/c"},
+      {GEN_URI, "a.example.com"},     {GEN_IPADD, std::string("\x01\x02\x03\x04", 4)},
+      {GEN_IPADD, std::string("\x01\x02\x03\x05", 4)},
+  };
+  for (const auto& [type, value] : names) {
+    bssl::UniquePtr<GENERAL_NAME> general_name = makeGeneralName(type, value);
+    bool expected = false;
+    for (const SanMatcherPtr& matcher : matchers) {
+      expected |= matcher->match(general_name.get());
+    }
+    EXPECT_EQ(expected, (*compiled)->match(general_name.get())) << value;
+  }
+}
+
+TEST(CompiledSanMatcherTest, InvalidMatcher) {
+  NiceMock<Server::Configuration::MockServerFactoryContext> context;
+  SubjectAltNameMatcher san_matcher = makeSanMatcher(
+      SubjectAltNameMatcher::OTHER_NAME, TestUtility::createExactMatcher("foo.example"));
+  san_matcher.set_oid("1.3.6.1.4.1.311.20.2.ffff");
+  EXPECT_EQ(CompiledSanMatcher::create({san_matcher}, context).status().message(),
+            "Failed to create string SAN matcher of type 5");
+}
+
 } // namespace Tls
 } // namespace TransportSockets
 } // namespace Extensions
@@ -62,10 +62,11 @@ public:
       bool allow_expired_certificate = false,
       std::vector<envoy::extensions::transport_sockets::tls::v3::SubjectAltNameMatcher>
           san_matchers = {},
-      std::string ca_cert = "", absl::optional<uint32_t> verify_depth = absl::nullopt)
+      std::string ca_cert = "", absl::optional<uint32_t> verify_depth = absl::nullopt,
+      uint32_t verification_cache_size = 0)
       : allow_expired_certificate_(allow_expired_certificate), api_(Api::createApiForTest()),
         custom_validator_config_(custom_config), san_matchers_(san_matchers), ca_cert_(ca_cert),
-        max_verify_depth_(verify_depth){};
+        max_verify_depth_(verify_depth), verification_cache_size_(verification_cache_size){};
   TestCertificateValidationContextConfig()
       : api_(Api::createApiForTest()), custom_validator_config_(absl::nullopt){};
 
@@ -106,6 +107,7 @@ public:
 
   absl::optional<uint32_t> maxVerifyDepth() const override { return max_verify_depth_; }
   bool autoSniSanMatch() const override { return auto_sni_san_match_; }
+  uint32_t verificationCacheSize() const override { return verification_cache_size_; }
 
 private:
   bool allow_expired_certificate_{false};
@@ -117,6 +119,7 @@ private:
   const std::string ca_cert_path_{"TEST_CA_CERT_PATH"};
   const absl::optional<uint32_t> max_verify_depth_{absl::nullopt};
   const bool auto_sni_san_match_{false};
+  const uint32_t verification_cache_size_{0};
 };
 
 } // namespace Tls
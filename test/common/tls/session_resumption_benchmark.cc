@@ -0,0 +1,124 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <array>
+
+#include "source/common/common/assert.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/common/tls/session_resumption_manager.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "benchmark/benchmark.h"
+#include "openssl/ssl.h"
+#include "tools/cpp/runfiles/runfiles.h"
+
+namespace Envoy {
+namespace Extensions::TransportSockets::Tls {
+
+enum class Resumption { None, SessionCache, SessionTicket };
+
+// Two server contexts, as two workers or the contexts before and after a listener update would
+// have, which share their session resumption state.
+class SessionResumptionBenchmark {
+public:
+  SessionResumptionBenchmark(Resumption resumption)
+      : manager_(time_system_, *store_.rootScope()), client_ctx_(SSL_CTX_new(TLS_method())) {
+    // The shared cache only applies to TLS 1.2 and below.
+    SSL_CTX_set_max_proto_version(client_ctx_.get(), TLS1_2_VERSION);
+    const SessionResumptionManager::Config config{20480, std::chrono::hours(1),
+                                                  std::chrono::hours(2)};
+    RELEASE_ASSERT(manager_.configure(config).ok(), "");
+    for (auto& server_ctx : server_ctxs_) {
+      server_ctx.reset(SSL_CTX_new(TLS_method()));
+      const std::string cert_path = TestEnvironment::substitute(
+          "{{ test_rundir }}/test/common/tls/test_data/san_dns_cert.pem");
+      const std::string key_path = TestEnvironment::substitute(
+          "{{ test_rundir }}/test/common/tls/test_data/san_dns_key.pem");
+      RELEASE_ASSERT(
+          SSL_CTX_use_certificate_file(server_ctx.get(), cert_path.c_str(), SSL_FILETYPE_PEM) > 0,
+          "SSL_CTX_use_certificate_file");
+      RELEASE_ASSERT(
+          SSL_CTX_use_PrivateKey_file(server_ctx.get(), key_path.c_str(), SSL_FILETYPE_PEM) > 0,
+          "SSL_CTX_use_PrivateKey_file");
+      const uint8_t session_id_context[] = "benchmark";
+      SSL_CTX_set_session_id_context(server_ctx.get(), session_id_context,
+                                     sizeof(session_id_context));
+      switch (resumption) {
+      case Resumption::None:
+        SSL_CTX_set_options(server_ctx.get(), SSL_OP_NO_TICKET);
+        SSL_CTX_set_session_cache_mode(server_ctx.get(), SSL_SESS_CACHE_OFF);
+        break;
+      case Resumption::SessionCache:
+        SSL_CTX_set_options(server_ctx.get(), SSL_OP_NO_TICKET);
+        manager_.installSessionCache(server_ctx.get());
+        break;
+      case Resumption::SessionTicket:
+        manager_.installTicketKeys(server_ctx.get());
+        break;
+      }
+    }
+  }
+
+  // Performs a handshake with the given server context, offering the given session, and returns
+  // the session of the client.
+  bssl::UniquePtr<SSL_SESSION> handshake(size_t server_index, SSL_SESSION* session,
+                                         uint64_t& resumed) {
+    bssl::UniquePtr<SSL> client(SSL_new(client_ctx_.get()));
+    bssl::UniquePtr<SSL> server(SSL_new(server_ctxs_[server_index].get()));
+    SSL_set_connect_state(client.get());
+    SSL_set_accept_state(server.get());
+    if (session != nullptr) {
+      SSL_set_session(client.get(), session);
+    }
+    BIO* client_bio;
+    BIO* server_bio;
+    RELEASE_ASSERT(BIO_new_bio_pair(&client_bio, 0, &server_bio, 0) == 1, "");
+    SSL_set_bio(client.get(), client_bio, client_bio);
+    SSL_set_bio(server.get(), server_bio, server_bio);
+    for (int i = 0; i < 20; ++i) {
+      const int client_rc = SSL_do_handshake(client.get());
+      const int server_rc = SSL_do_handshake(server.get());
+      if (client_rc == 1 && server_rc == 1) {
+        resumed += SSL_session_reused(client.get());
+        return bssl::UniquePtr<SSL_SESSION>(SSL_get1_session(client.get()));
+      }
+    }
+    PANIC("handshake did not complete");
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl store_;
+  SessionResumptionManager manager_;
+  bssl::UniquePtr<SSL_CTX> client_ctx_;
+  std::array<bssl::UniquePtr<SSL_CTX>, 2> server_ctxs_;
+};
+
+// Measures the cost of the handshakes of a client which reconnects, alternately to either server
+// context, with the session of its previous connection.
+static void sessionResumption(benchmark::State& state) {
+  std::string error;
+  std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
+      bazel::tools::cpp::runfiles::Runfiles::Create("session_resumption_benchmark", &error));
+  Envoy::TestEnvironment::setRunfiles(runfiles.get());
+
+  SessionResumptionBenchmark speed_test(static_cast<Resumption>(state.range(0)));
+  uint64_t handshakes = 0;
+  uint64_t resumed = 0;
+  bssl::UniquePtr<SSL_SESSION> session = speed_test.handshake(0, nullptr, resumed);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    session = speed_test.handshake(++handshakes % 2, session.get(), resumed);
+  }
+  state.counters["resumption_rate"] = static_cast<double>(resumed) / (handshakes + 1);
+  state.SetItemsProcessed(handshakes);
+}
+
+BENCHMARK(sessionResumption)
+    ->Arg(static_cast<int>(Resumption::None))
+    ->Arg(static_cast<int>(Resumption::SessionCache))
+    ->Arg(static_cast<int>(Resumption::SessionTicket))
+    ->Unit(::benchmark::kMicrosecond);
+
+} // namespace Extensions::TransportSockets::Tls
+} // namespace Envoy
@@ -0,0 +1,199 @@
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/common/tls/session_resumption_manager.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+class SessionResumptionManagerTest : public testing::Test {
+protected:
+  SessionResumptionManagerTest()
+      : manager_(time_system_, *store_.rootScope()), client_ctx_(SSL_CTX_new(TLS_method())) {
+    // The shared cache only applies to TLS 1.2 and below.
+    SSL_CTX_set_max_proto_version(client_ctx_.get(), TLS1_2_VERSION);
+    config_.max_cached_sessions_ = 1024;
+    config_.ticket_key_rotation_interval_ = std::chrono::hours(1);
+    config_.ticket_key_overlap_ = std::chrono::hours(2);
+  }
+
+  bssl::UniquePtr<SSL_CTX> makeServerCtx(SessionResumptionManager& manager, bool tickets) {
+    bssl::UniquePtr<SSL_CTX> ctx(SSL_CTX_new(TLS_method()));
+    EXPECT_EQ(1, SSL_CTX_use_certificate_file(
+                     ctx.get(),
+                     TestEnvironment::substitute(
+                         "{{ test_rundir }}/test/common/tls/test_data/san_dns_cert.pem")
+                         .c_str(),
+                     SSL_FILETYPE_PEM));
+    EXPECT_EQ(1, SSL_CTX_use_PrivateKey_file(
+                     ctx.get(),
+                     TestEnvironment::substitute(
+                         "{{ test_rundir }}/test/common/tls/test_data/san_dns_key.pem")
+                         .c_str(),
+                     SSL_FILETYPE_PEM));
+    const uint8_t session_id_context[] = "test";
+    SSL_CTX_set_session_id_context(ctx.get(), session_id_context, sizeof(session_id_context));
+    if (tickets) {
+      manager.installTicketKeys(ctx.get());
+    } else {
+      SSL_CTX_set_options(ctx.get(), SSL_OP_NO_TICKET);
+      manager.installSessionCache(ctx.get());
+    }
+    return ctx;
+  }
+
+  // Performs a handshake with the given server context, offering the given session.
+  // @return the session the client got, which is null if the handshake failed.
+  bssl::UniquePtr<SSL_SESSION> handshake(SSL_CTX* server_ctx, SSL_SESSION* session,
+                                         bool& resumed) {
+    bssl::UniquePtr<SSL> client(SSL_new(client_ctx_.get()));
+    bssl::UniquePtr<SSL> server(SSL_new(server_ctx));
+    SSL_set_connect_state(client.get());
+    SSL_set_accept_state(server.get());
+    if (session != nullptr) {
+      SSL_set_session(client.get(), session);
+    }
+    BIO* client_bio;
+    BIO* server_bio;
+    RELEASE_ASSERT(BIO_new_bio_pair(&client_bio, 0, &server_bio, 0) == 1, "");
+    SSL_set_bio(client.get(), client_bio, client_bio);
+    SSL_set_bio(server.get(), server_bio, server_bio);
+
+    for (int i = 0; i < 20; ++i) {
+      const int client_rc = SSL_do_handshake(client.get());
+      const int server_rc = SSL_do_handshake(server.get());
+      if (client_rc == 1 && server_rc == 1) {
+        resumed = SSL_session_reused(client.get());
+        return bssl::UniquePtr<SSL_SESSION>(SSL_get1_session(client.get()));
+      }
+    }
+    return nullptr;
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl store_;
+  SessionResumptionManager manager_;
+  SessionResumptionManager::Config config_;
+  bssl::UniquePtr<SSL_CTX> client_ctx_;
+};
+
+TEST_F(SessionResumptionManagerTest, ConfigureMismatch) {
+  EXPECT_TRUE(manager_.configure(config_).ok());
+  EXPECT_TRUE(manager_.configure(config_).ok());
+  config_.max_cached_sessions_ = 10;
+  EXPECT_EQ(manager_.configure(config_).message(),
+            "all TLS contexts with shared_session_resumption must use the same settings");
+}
+
+// Sessions established with one context are resumed with another one, as they would be on another
+// worker or after a listener update.
+TEST_F(SessionResumptionManagerTest, SessionCacheSharedAcrossContexts) {
+  ASSERT_TRUE(manager_.configure(config_).ok());
+  auto first_ctx = makeServerCtx(manager_, false);
+  auto second_ctx = makeServerCtx(manager_, false);
+
+  bool resumed;
+  auto session = handshake(first_ctx.get(), nullptr, resumed);
+  ASSERT_NE(session, nullptr);
+  EXPECT_FALSE(resumed);
+  EXPECT_EQ(1, manager_.stats().cache_insert_.value());
+  EXPECT_EQ(1, manager_.stats().cache_size_.value());
+
+  EXPECT_NE(handshake(second_ctx.get(), session.get(), resumed), nullptr);
+  EXPECT_TRUE(resumed);
+  EXPECT_EQ(1, manager_.stats().cache_hit_.value());
+  EXPECT_EQ(0, manager_.stats().cache_miss_.value());
+}
+
+TEST_F(SessionResumptionManagerTest, SessionCacheEvictsLeastRecentlyUsed) {
+  // One session per shard.
+  config_.max_cached_sessions_ = 1;
+  ASSERT_TRUE(manager_.configure(config_).ok());
+  auto ctx = makeServerCtx(manager_, false);
+
+  bool resumed;
+  const uint32_t sessions = 4 * ShardedSessionCache::NumShards;
+  for (uint32_t i = 0; i < sessions; ++i) {
+    ASSERT_NE(handshake(ctx.get(), nullptr, resumed), nullptr);
+  }
+  EXPECT_EQ(sessions, manager_.stats().cache_insert_.value());
+  EXPECT_LE(manager_.stats().cache_size_.value(), ShardedSessionCache::NumShards);
+  EXPECT_EQ(sessions,
+            manager_.stats().cache_evicted_.value() + manager_.stats().cache_size_.value());
+}
+
+// Tickets are renewed once their key has been rotated, and rejected once the key is past its
+// overlap.
+TEST_F(SessionResumptionManagerTest, TicketKeyRotation) {
+  ASSERT_TRUE(manager_.configure(config_).ok());
+  auto first_ctx = makeServerCtx(manager_, true);
+  auto second_ctx = makeServerCtx(manager_, true);
+
+  bool resumed;
+  auto session = handshake(first_ctx.get(), nullptr, resumed);
+  ASSERT_NE(session, nullptr);
+  EXPECT_FALSE(resumed);
+  EXPECT_EQ(1, manager_.stats().ticket_key_rotated_.value());
+
+  EXPECT_NE(handshake(second_ctx.get(), session.get(), resumed), nullptr);
+  EXPECT_TRUE(resumed);
+  EXPECT_EQ(1, manager_.stats().ticket_decrypted_.value());
+
+  // The key is rotated by the next ticket, and the old ticket is still accepted but renewed.
+  time_system_.advanceTimeWait(std::chrono::minutes(90));
+  ASSERT_NE(handshake(first_ctx.get(), nullptr, resumed), nullptr);
+  EXPECT_EQ(2, manager_.stats().ticket_key_rotated_.value());
+  EXPECT_EQ(2, manager_.ticketKeys().size());
+  auto renewed = handshake(second_ctx.get(), session.get(), resumed);
+  ASSERT_NE(renewed, nullptr);
+  EXPECT_TRUE(resumed);
+  EXPECT_EQ(1, manager_.stats().ticket_decrypted_with_previous_key_.value());
+
+  // Two hours after the rotation, the old key is no longer accepted.
+  time_system_.advanceTimeWait(std::chrono::hours(2));
+  EXPECT_NE(handshake(second_ctx.get(), session.get(), resumed), nullptr);
+  EXPECT_FALSE(resumed);
+  EXPECT_EQ(1, manager_.stats().ticket_key_not_found_.value());
+}
+
+// The state handed over during a hot restart resumes the sessions of the parent.
+TEST_F(SessionResumptionManagerTest, ImportState) {
+  ASSERT_TRUE(manager_.configure(config_).ok());
+  auto cache_ctx = makeServerCtx(manager_, false);
+  auto ticket_ctx = makeServerCtx(manager_, true);
+  bool resumed;
+  auto cached_session = handshake(cache_ctx.get(), nullptr, resumed);
+  auto ticket_session = handshake(ticket_ctx.get(), nullptr, resumed);
+  ASSERT_NE(cached_session, nullptr);
+  ASSERT_NE(ticket_session, nullptr);
+
+  Stats::IsolatedStoreImpl child_store;
+  SessionResumptionManager child(time_system_, *child_store.rootScope());
+  // The state is imported before the child's contexts are configured.
+  child.importState(manager_.ticketKeys(), manager_.serializedSessions());
+  ASSERT_TRUE(child.configure(config_).ok());
+  EXPECT_EQ(1, child.stats().imported_ticket_keys_.value());
+  EXPECT_EQ(1, child.stats().imported_sessions_.value());
+
+  auto child_cache_ctx = makeServerCtx(child, false);
+  auto child_ticket_ctx = makeServerCtx(child, true);
+  EXPECT_NE(handshake(child_cache_ctx.get(), cached_session.get(), resumed), nullptr);
+  EXPECT_TRUE(resumed);
+  EXPECT_NE(handshake(child_ticket_ctx.get(), ticket_session.get(), resumed), nullptr);
+  EXPECT_TRUE(resumed);
+  // The imported key was still current, so no new key was needed.
+  EXPECT_EQ(0, child.stats().ticket_key_rotated_.value());
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
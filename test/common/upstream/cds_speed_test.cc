@@ -0,0 +1,184 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/config/core/v3/config_source.pb.h"
+#include "envoy/service/discovery/v3/discovery.pb.h"
+
+#include "source/common/config/opaque_resource_decoder_impl.h"
+#include "source/common/config/utility.h"
+#include "source/common/upstream/cds_api_impl.h"
+#include "source/extensions/config_subscription/grpc/grpc_mux_impl.h"
+#include "source/extensions/config_subscription/grpc/grpc_subscription_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/common.h"
+#include "test/mocks/config/custom_config_validators.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/grpc/mocks.h"
+#include "test/mocks/local_info/mocks.h"
+#include "test/mocks/protobuf/mocks.h"
+#include "test/mocks/upstream/cluster_manager.h"
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using ::benchmark::State;
+using Envoy::benchmark::skipExpensiveBenchmarks;
+
+namespace Envoy {
+namespace Upstream {
+
+// Drives CdsApiImpl through a state-of-the-world GrpcMuxImpl, so that the cost of decoding and
+// validating the clusters of a large CDS response is measured, optionally with the decoding
+// happening on the mux's resource decode threads.
+class CdsSpeedTest {
+public:
+  CdsSpeedTest(State& state, uint32_t resource_decode_threads)
+      : state_(state), type_url_("type.googleapis.com/envoy.config.cluster.v3.Cluster"),
+        subscription_stats_(Config::Utility::generateStats(*store_.rootScope())),
+        async_client_(new Grpc::MockAsyncClient()) {
+    Config::GrpcMuxContext grpc_mux_context{
+        /*async_client_=*/std::unique_ptr<Grpc::MockAsyncClient>(async_client_),
+        /*failover_async_client_=*/nullptr,
+        /*dispatcher_=*/dispatcher_,
+        /*service_method_=*/
+        *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
+            "envoy.service.cluster.v3.ClusterDiscoveryService.StreamClusters"),
+        /*local_info_=*/local_info_,
+        /*rate_limit_settings_=*/{},
+        /*scope_=*/*store_.rootScope(),
+        /*config_validators_=*/std::make_unique<NiceMock<Config::MockCustomConfigValidators>>(),
+        /*xds_resources_delegate_=*/Config::XdsResourcesDelegateOptRef(),
+        /*xds_config_tracker_=*/Config::XdsConfigTrackerOptRef(),
+        /*backoff_strategy_=*/
+        std::make_unique<JitteredExponentialBackOffStrategy>(
+            Config::SubscriptionFactory::RetryInitialDelayMs,
+            Config::SubscriptionFactory::RetryMaxDelayMs, random_),
+        /*target_xds_authority_=*/"",
+        /*eds_resources_cache_=*/nullptr,
+        /*resource_decode_threads_=*/resource_decode_threads,
+        /*thread_factory_=*/Thread::threadFactoryForTest()};
+    // Decoded resources are posted back from the decoding threads, which the mock dispatcher does
+    // not allow; collect them and run them in deliverResponse() instead.
+    ON_CALL(dispatcher_, post(_)).WillByDefault([this](Event::PostCb callback) {
+      absl::MutexLock lock(&posted_mutex_);
+      posted_callbacks_.push_back(std::move(callback));
+    });
+    grpc_mux_ = std::make_shared<Config::GrpcMuxImpl>(grpc_mux_context, true);
+
+    ON_CALL(cm_, addOrUpdateCluster(_, _, _))
+        .WillByDefault([this](const envoy::config::cluster::v3::Cluster&, const std::string&,
+                              const bool) -> absl::StatusOr<bool> {
+          ++clusters_added_;
+          return true;
+        });
+    envoy::config::core::v3::ConfigSource cds_config;
+    cds_ = *CdsApiImpl::create(cds_config, nullptr, cm_, *store_.rootScope(), validation_visitor_);
+    EXPECT_CALL(*cm_.subscription_factory_.subscription_, start(_));
+    cds_->initialize();
+
+    subscription_ = std::make_unique<Config::GrpcSubscriptionImpl>(
+        grpc_mux_, *cm_.subscription_factory_.callbacks_, resource_decoder_, subscription_stats_,
+        type_url_, dispatcher_, std::chrono::milliseconds(), false, Config::SubscriptionOptions());
+    EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(testing::Return(&async_stream_));
+    subscription_->start({});
+  }
+
+  // Push a single response with num_clusters static clusters of hosts_per_cluster hosts each.
+  void clustersHelper(size_t num_clusters, size_t hosts_per_cluster) {
+    state_.PauseTiming();
+    auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+    response->set_type_url(type_url_);
+    response->set_version_info(fmt::format("version-{}", version_++));
+    for (size_t i = 0; i < num_clusters; ++i) {
+      envoy::config::cluster::v3::Cluster cluster;
+      cluster.set_name(absl::StrCat("cluster_", i));
+      cluster.set_type(envoy::config::cluster::v3::Cluster::STATIC);
+      cluster.mutable_connect_timeout()->set_seconds(1);
+      auto* load_assignment = cluster.mutable_load_assignment();
+      load_assignment->set_cluster_name(cluster.name());
+      auto* endpoints = load_assignment->add_endpoints();
+      for (size_t j = 0; j < hosts_per_cluster; ++j) {
+        auto* socket_address = endpoints->add_lb_endpoints()
+                                   ->mutable_endpoint()
+                                   ->mutable_address()
+                                   ->mutable_socket_address();
+        socket_address->set_address("10.0.1.1");
+        socket_address->set_port_value(1000 + j);
+      }
+      response->mutable_resources()->Add()->PackFrom(cluster);
+    }
+    clusters_added_ = 0;
+    state_.ResumeTiming();
+    deliverResponse(std::move(response));
+    RELEASE_ASSERT(clusters_added_ == num_clusters, "");
+  }
+
+  void
+  deliverResponse(std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& response) {
+    auto& grpc_mux = dynamic_cast<Config::GrpcMuxImpl&>(*grpc_mux_);
+    grpc_mux.grpcStreamForTest().onReceiveMessage(std::move(response));
+    Config::ResourceDecodePool* pool = grpc_mux.resourceDecodePoolForTest();
+    if (pool == nullptr) {
+      return;
+    }
+    while (true) {
+      pool->waitForIdle();
+      std::vector<Event::PostCb> callbacks;
+      {
+        absl::MutexLock lock(&posted_mutex_);
+        callbacks.swap(posted_callbacks_);
+      }
+      if (callbacks.empty()) {
+        return;
+      }
+      for (auto& callback : callbacks) {
+        callback();
+      }
+    }
+  }
+
+  State& state_;
+  const std::string type_url_;
+  uint64_t version_{};
+  size_t clusters_added_{};
+  Stats::IsolatedStoreImpl store_;
+  Config::SubscriptionStats subscription_stats_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Random::MockRandomGenerator> random_;
+  NiceMock<LocalInfo::MockLocalInfo> local_info_;
+  NiceMock<ProtobufMessage::MockValidationVisitor> validation_visitor_;
+  NiceMock<MockClusterManager> cm_;
+  CdsApiPtr cds_;
+  Config::OpaqueResourceDecoderSharedPtr resource_decoder_{
+      std::make_shared<Config::OpaqueResourceDecoderImpl<envoy::config::cluster::v3::Cluster>>(
+          validation_visitor_, "name")};
+  Grpc::MockAsyncClient* async_client_;
+  NiceMock<Grpc::MockAsyncStream> async_stream_;
+  Config::GrpcMuxSharedPtr grpc_mux_;
+  Config::GrpcSubscriptionImplPtr subscription_;
+  absl::Mutex posted_mutex_;
+  std::vector<Event::PostCb> posted_callbacks_ ABSL_GUARDED_BY(posted_mutex_);
+};
+
+} // namespace Upstream
+} // namespace Envoy
+
+static void manyClusters(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    Envoy::Upstream::CdsSpeedTest speed_test(state, state.range(1));
+    // if we've been instructed to skip tests, only run once no matter the argument:
+    uint32_t clusters = skipExpensiveBenchmarks() ? 1 : state.range(0);
+
+    speed_test.clustersHelper(clusters, 4);
+  }
+}
+
+BENCHMARK(manyClusters)
+    ->ArgsProduct({{1000, 50000}, {0, 1, 4, 8}})
+    ->Unit(benchmark::kMillisecond);
@@ -148,10 +148,10 @@ protected:
 class MockGrpcMuxFactory : public Config::MuxFactory {
 public:
   MockGrpcMuxFactory() {
-    ON_CALL(*this, create(_, _, _, _, _, _, _, _, _, _, _, _))
+    ON_CALL(*this, create(_, _, _, _, _, _, _, _, _, _, _, _, _))
         .WillByDefault(Invoke(
             [](std::unique_ptr<Grpc::RawAsyncClient>&&, std::unique_ptr<Grpc::RawAsyncClient>&&,
-               Event::Dispatcher&, Random::RandomGenerator&, Stats::Scope&,
+               Event::Dispatcher&, Api::Api&, Random::RandomGenerator&, Stats::Scope&,
                const envoy::config::core::v3::ApiConfigSource&, const LocalInfo::LocalInfo&,
                std::unique_ptr<Config::CustomConfigValidators>&&, BackOffStrategyPtr&&,
                OptRef<Config::XdsConfigTracker>, OptRef<Config::XdsResourcesDelegate>,
@@ -165,7 +165,7 @@ public:
 
   MOCK_METHOD(std::shared_ptr<Config::GrpcMux>, create,
               (std::unique_ptr<Grpc::RawAsyncClient>&&, std::unique_ptr<Grpc::RawAsyncClient>&&,
-               Event::Dispatcher&, Random::RandomGenerator&, Stats::Scope&,
+               Event::Dispatcher&, Api::Api&, Random::RandomGenerator&, Stats::Scope&,
                const envoy::config::core::v3::ApiConfigSource&, const LocalInfo::LocalInfo&,
                std::unique_ptr<Config::CustomConfigValidators>&&, BackOffStrategyPtr&&,
                OptRef<Config::XdsConfigTracker>, OptRef<Config::XdsResourcesDelegate>, bool));
@@ -4984,11 +4984,11 @@ TEST_F(ClusterManagerImplTest, AdsReplacementPrimaryOnly) {
   std::shared_ptr<NiceMock<Config::MockGrpcMux>> ads_mux_shared(
       std::make_shared<NiceMock<Config::MockGrpcMux>>());
   NiceMock<Config::MockGrpcMux>& ads_mux(*ads_mux_shared.get());
-  EXPECT_CALL(factory, create(_, _, _, _, _, _, _, _, _, _, _, _))
+  EXPECT_CALL(factory, create(_, _, _, _, _, _, _, _, _, _, _, _, _))
       .WillOnce(Invoke(
           [&ads_mux_shared](std::unique_ptr<Grpc::RawAsyncClient>&& primary_async_client,
                             std::unique_ptr<Grpc::RawAsyncClient>&& failover_async_client,
-                            Event::Dispatcher&, Random::RandomGenerator&, Stats::Scope&,
+                            Event::Dispatcher&, Api::Api&, Random::RandomGenerator&, Stats::Scope&,
                             const envoy::config::core::v3::ApiConfigSource&,
                             const LocalInfo::LocalInfo&,
                             std::unique_ptr<Config::CustomConfigValidators>&&, BackOffStrategyPtr&&,
@@ -5075,11 +5075,11 @@ TEST_F(ClusterManagerImplTest, AdsReplacementPrimaryAndFailover) {
   std::shared_ptr<NiceMock<Config::MockGrpcMux>> ads_mux_shared(
       std::make_shared<NiceMock<Config::MockGrpcMux>>());
   NiceMock<Config::MockGrpcMux>& ads_mux(*ads_mux_shared.get());
-  EXPECT_CALL(factory, create(_, _, _, _, _, _, _, _, _, _, _, _))
+  EXPECT_CALL(factory, create(_, _, _, _, _, _, _, _, _, _, _, _, _))
       .WillOnce(Invoke(
           [&ads_mux_shared](std::unique_ptr<Grpc::RawAsyncClient>&& primary_async_client,
                             std::unique_ptr<Grpc::RawAsyncClient>&& failover_async_client,
-                            Event::Dispatcher&, Random::RandomGenerator&, Stats::Scope&,
+                            Event::Dispatcher&, Api::Api&, Random::RandomGenerator&, Stats::Scope&,
                             const envoy::config::core::v3::ApiConfigSource&,
                             const LocalInfo::LocalInfo&,
                             std::unique_ptr<Config::CustomConfigValidators>&&, BackOffStrategyPtr&&,
@@ -5216,11 +5216,11 @@ TEST_F(ClusterManagerImplTest, AdsReplacementUnknownFailoverCluster) {
   NiceMock<MockGrpcMuxFactory> factory;
   Registry::InjectFactory<Config::MuxFactory> registry(factory);
   // Replace the created GrpcMux mock.
-  EXPECT_CALL(factory, create(_, _, _, _, _, _, _, _, _, _, _, _))
+  EXPECT_CALL(factory, create(_, _, _, _, _, _, _, _, _, _, _, _, _))
       .WillOnce(
           Invoke([](std::unique_ptr<Grpc::RawAsyncClient>&& primary_async_client,
                     std::unique_ptr<Grpc::RawAsyncClient>&& failover_async_client,
-                    Event::Dispatcher&, Random::RandomGenerator&, Stats::Scope&,
+                    Event::Dispatcher&, Api::Api&, Random::RandomGenerator&, Stats::Scope&,
                     const envoy::config::core::v3::ApiConfigSource&, const LocalInfo::LocalInfo&,
                     std::unique_ptr<Config::CustomConfigValidators>&&, BackOffStrategyPtr&&,
                     OptRef<Config::XdsConfigTracker>, OptRef<Config::XdsResourcesDelegate>,
@@ -5295,7 +5295,7 @@ TEST_F(ClusterManagerImplTest, AdsReplacementDifferentAdsTypeRejection) {
   NiceMock<MockGrpcMuxFactory> factory;
   Registry::InjectFactory<Config::MuxFactory> registry(factory);
   // Replace the created GrpcMux mock.
-  EXPECT_CALL(factory, create(_, _, _, _, _, _, _, _, _, _, _, _))
+  EXPECT_CALL(factory, create(_, _, _, _, _, _, _, _, _, _, _, _, _))
       .WillOnce(Invoke(
           [](std::unique_ptr<Grpc::RawAsyncClient>&&, std::unique_ptr<Grpc::RawAsyncClient>&&,
              Event::Dispatcher&, Random::RandomGenerator&, Stats::Scope&,
@@ -5354,7 +5354,7 @@ TEST_F(ClusterManagerImplTest, AdsReplacementInvalidBackoffRejection) {
   NiceMock<MockGrpcMuxFactory> factory;
   Registry::InjectFactory<Config::MuxFactory> registry(factory);
   // Replace the created GrpcMux mock.
-  EXPECT_CALL(factory, create(_, _, _, _, _, _, _, _, _, _, _, _))
+  EXPECT_CALL(factory, create(_, _, _, _, _, _, _, _, _, _, _, _, _))
       .WillOnce(Invoke(
           [](std::unique_ptr<Grpc::RawAsyncClient>&&, std::unique_ptr<Grpc::RawAsyncClient>&&,
              Event::Dispatcher&, Random::RandomGenerator&, Stats::Scope&,
@@ -5415,7 +5415,7 @@ TEST_F(ClusterManagerImplTest, AdsReplacementUnsupportedTypeRejection) {
   NiceMock<MockGrpcMuxFactory> factory;
   Registry::InjectFactory<Config::MuxFactory> registry(factory);
   // Replace the created GrpcMux mock.
-  EXPECT_CALL(factory, create(_, _, _, _, _, _, _, _, _, _, _, _))
+  EXPECT_CALL(factory, create(_, _, _, _, _, _, _, _, _, _, _, _, _))
       .WillOnce(Invoke(
           [](std::unique_ptr<Grpc::RawAsyncClient>&&, std::unique_ptr<Grpc::RawAsyncClient>&&,
              Event::Dispatcher&, Random::RandomGenerator&, Stats::Scope&,
@@ -5479,7 +5479,7 @@ TEST_F(ClusterManagerImplTest, AdsReplacementNumberOfCustomValidatorsRejection)
   FakeConfigValidatorFactory fake_config_validator_factory;
   Registry::InjectFactory<Config::ConfigValidatorFactory> registry2(fake_config_validator_factory);
   // Replace the created GrpcMux mock.
-  EXPECT_CALL(factory, create(_, _, _, _, _, _, _, _, _, _, _, _))
+  EXPECT_CALL(factory, create(_, _, _, _, _, _, _, _, _, _, _, _, _))
       .WillOnce(Invoke(
           [](std::unique_ptr<Grpc::RawAsyncClient>&&, std::unique_ptr<Grpc::RawAsyncClient>&&,
              Event::Dispatcher&, Random::RandomGenerator&, Stats::Scope&,
@@ -5544,7 +5544,7 @@ TEST_F(ClusterManagerImplTest, AdsReplacementContentsOfCustomValidatorsRejection
   FakeConfigValidatorFactory fake_config_validator_factory;
   Registry::InjectFactory<Config::ConfigValidatorFactory> registry2(fake_config_validator_factory);
   // Replace the created GrpcMux mock.
-  EXPECT_CALL(factory, create(_, _, _, _, _, _, _, _, _, _, _, _))
+  EXPECT_CALL(factory, create(_, _, _, _, _, _, _, _, _, _, _, _, _))
       .WillOnce(Invoke(
           [](std::unique_ptr<Grpc::RawAsyncClient>&&, std::unique_ptr<Grpc::RawAsyncClient>&&,
              Event::Dispatcher&, Random::RandomGenerator&, Stats::Scope&,
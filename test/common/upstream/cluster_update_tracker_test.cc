@@ -35,7 +35,7 @@ TEST_F(ClusterUpdateTrackerTest, ClusterDoesNotExistAtConstructionTime) {
 }
 
 TEST_F(ClusterUpdateTrackerTest, ClusterDoesExistAtConstructionTime) {
-  EXPECT_CALL(cm_, getThreadLocalCluster(cluster_name_)).WillOnce(Return(&expected_));
+  EXPECT_CALL(cm_, getThreadLocalCluster(cluster_name_)).WillRepeatedly(Return(&expected_));
 
   ClusterUpdateTracker cluster_tracker(cm_, cluster_name_);
 
@@ -44,7 +44,7 @@ TEST_F(ClusterUpdateTrackerTest, ClusterDoesExistAtConstructionTime) {
 }
 
 TEST_F(ClusterUpdateTrackerTest, ShouldProperlyHandleUpdateCallbacks) {
-  EXPECT_CALL(cm_, getThreadLocalCluster(cluster_name_)).WillOnce(Return(nullptr));
+  EXPECT_CALL(cm_, getThreadLocalCluster(cluster_name_)).WillRepeatedly(Return(nullptr));
 
   ClusterUpdateTracker cluster_tracker(cm_, cluster_name_);
 
@@ -83,6 +83,22 @@ TEST_F(ClusterUpdateTrackerTest, ShouldProperlyHandleUpdateCallbacks) {
   }
 }
 
+// A cluster which was looked up is not cached, as it may be reclaimed while idle, while a cluster
+// handed to the update callbacks is.
+TEST_F(ClusterUpdateTrackerTest, OnlyClusterFromCallbacksIsCached) {
+  EXPECT_CALL(cm_, getThreadLocalCluster(cluster_name_))
+      .WillOnce(Return(&irrelevant_))
+      .WillOnce(Return(&expected_));
+
+  ClusterUpdateTracker cluster_tracker(cm_, cluster_name_);
+  EXPECT_EQ(&cluster_tracker.threadLocalCluster()->get(), &irrelevant_);
+  EXPECT_EQ(&cluster_tracker.threadLocalCluster()->get(), &expected_);
+
+  ThreadLocalClusterCommand command = [this]() -> ThreadLocalCluster& { return expected_; };
+  cluster_tracker.onClusterAddOrUpdate(cluster_name_, command);
+  EXPECT_EQ(&cluster_tracker.threadLocalCluster()->get(), &expected_);
+}
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
@@ -6,6 +6,7 @@
 #include "envoy/config/endpoint/v3/endpoint_components.pb.h"
 #include "envoy/service/discovery/v3/discovery.pb.h"
 
+#include "source/common/upstream/cluster_update_tracker.h"
 #include "source/extensions/clusters/eds/eds.h"
 #include "source/extensions/clusters/static/static_cluster.h"
 
@@ -14,6 +15,7 @@
 #include "test/mocks/config/xds_manager.h"
 #include "test/mocks/protobuf/mocks.h"
 #include "test/mocks/server/instance.h"
+#include "test/mocks/upstream/cluster_update_callbacks.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
@@ -418,6 +420,97 @@ TEST_P(StaticClusterTest, RemoveDeferredCluster) {
   EXPECT_EQ(readGauge("thread_local_cluster_manager.test_thread.clusters_inflated"), 0);
 }
 
+class IdleClusterTest : public DeferredClusterInitializationTest {
+protected:
+  void createWithIdleTimeout() {
+    const std::string yaml = R"EOF(
+    static_resources:
+      clusters:
+      - name: cluster_1
+        connect_timeout: 0.250s
+        lb_policy: ROUND_ROBIN
+        load_assignment:
+          cluster_name: cluster_1
+          endpoints:
+          - lb_endpoints:
+            - endpoint:
+                address:
+                  socket_address:
+                    address: 127.0.0.1
+                    port_value: 11001
+            - endpoint:
+                address:
+                  socket_address:
+                    address: 127.0.0.1
+                    port_value: 11002
+    )EOF";
+    auto bootstrap = parseBootstrapFromV3YamlEnableDeferredCluster(yaml);
+    bootstrap.mutable_cluster_manager()->mutable_deferred_cluster_idle_timeout()->set_seconds(10);
+    // The thread local cluster manager of the test thread creates the idle cluster timer.
+    idle_cluster_timer_ = new NiceMock<Event::MockTimer>(&factory_.tls_.dispatcher_);
+    EXPECT_CALL(*idle_cluster_timer_, enableTimer(std::chrono::milliseconds(10000), _))
+        .Times(testing::AnyNumber());
+    create(bootstrap);
+  }
+
+  Event::MockTimer* idle_cluster_timer_;
+};
+
+INSTANTIATE_TEST_SUITE_P(UseCustomClusterType, IdleClusterTest, testing::Bool());
+
+// Test that clusters which are not used for a full idle period return to the deferred state.
+TEST_P(IdleClusterTest, IdleClusterIsReclaimed) {
+  createWithIdleTimeout();
+  EXPECT_EQ(readGauge("thread_local_cluster_manager.test_thread.clusters_deferred"), 1);
+  ASSERT_NE(cluster_manager_->getThreadLocalCluster("cluster_1"), nullptr);
+  EXPECT_EQ(readGauge("thread_local_cluster_manager.test_thread.clusters_inflated"), 1);
+  EXPECT_EQ(readGauge("thread_local_cluster_manager.test_thread.clusters_deferred"), 0);
+
+  // The cluster was used during the first period.
+  idle_cluster_timer_->invokeCallback();
+  EXPECT_EQ(readGauge("thread_local_cluster_manager.test_thread.clusters_inflated"), 1);
+
+  EXPECT_LOG_CONTAINS("debug", "reclaiming idle TLS cluster cluster_1",
+                      idle_cluster_timer_->invokeCallback());
+  EXPECT_EQ(readGauge("thread_local_cluster_manager.test_thread.clusters_inflated"), 0);
+  EXPECT_EQ(readGauge("thread_local_cluster_manager.test_thread.clusters_deferred"), 1);
+  EXPECT_EQ(factory_.stats_.counter("thread_local_cluster_manager.test_thread.clusters_reclaimed")
+                .value(),
+            1);
+
+  // The cluster is initialized again, with the same hosts, once it is used.
+  ThreadLocalCluster* cluster = nullptr;
+  EXPECT_LOG_CONTAINS("debug", "initializing TLS cluster cluster_1 inline",
+                      cluster = cluster_manager_->getThreadLocalCluster("cluster_1"));
+  ASSERT_NE(cluster, nullptr);
+  EXPECT_EQ(cluster->prioritySet().hostSetsPerPriority()[0]->hosts().size(), 2);
+  EXPECT_EQ(readGauge("thread_local_cluster_manager.test_thread.clusters_inflated"), 1);
+}
+
+// Test that reclaiming a cluster doesn't notify the cluster update callbacks, and that a
+// ClusterUpdateTracker looks the cluster up again once it was reclaimed.
+TEST_P(IdleClusterTest, ReclaimedClusterIsLookedUpAgainByTracker) {
+  createWithIdleTimeout();
+  NiceMock<MockClusterUpdateCallbacks> callbacks;
+  ClusterUpdateCallbacksHandlePtr callbacks_handle =
+      cluster_manager_->addThreadLocalClusterUpdateCallbacks(callbacks);
+  EXPECT_CALL(callbacks, onClusterAddOrUpdate(_, _)).Times(0);
+  ClusterUpdateTracker tracker(*cluster_manager_, "cluster_1");
+  ASSERT_TRUE(tracker.threadLocalCluster().has_value());
+
+  idle_cluster_timer_->invokeCallback();
+  idle_cluster_timer_->invokeCallback();
+  EXPECT_EQ(factory_.stats_.counter("thread_local_cluster_manager.test_thread.clusters_reclaimed")
+                .value(),
+            1);
+  EXPECT_EQ(readGauge("thread_local_cluster_manager.test_thread.clusters_inflated"), 0);
+
+  ASSERT_TRUE(tracker.threadLocalCluster().has_value());
+  EXPECT_EQ(&tracker.threadLocalCluster()->get(),
+            cluster_manager_->getThreadLocalCluster("cluster_1"));
+  EXPECT_EQ(readGauge("thread_local_cluster_manager.test_thread.clusters_inflated"), 1);
+}
+
 class MockConfigSubscriptionFactory : public Config::ConfigSubscriptionFactory {
 public:
   std::string name() const override { return "envoy.config_subscription.rest"; }
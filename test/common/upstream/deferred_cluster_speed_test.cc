@@ -0,0 +1,118 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+#include "envoy/config/cluster/v3/cluster.pb.h"
+
+#include "source/common/memory/stats.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/test_cluster_manager.h"
+#include "test/mocks/config/xds_manager.h"
+#include "test/mocks/protobuf/mocks.h"
+#include "test/mocks/server/instance.h"
+
+#include "benchmark/benchmark.h"
+
+using ::benchmark::State;
+using Envoy::benchmark::skipExpensiveBenchmarks;
+
+namespace Envoy {
+namespace Upstream {
+
+// How the thread local clusters of the benchmark's (single) worker are created.
+enum class WorkerClusters {
+  // All clusters are initialized when they are added.
+  Eager,
+  // Clusters are only initialized once they are used, and none are used.
+  Deferred,
+  // Clusters are only initialized once they are used, and all of them are used.
+  DeferredAllUsed,
+};
+
+// Measures the memory held by the cluster manager, including the thread local cluster manager of
+// its worker, and the time it takes to add the clusters, for a number of static clusters.
+class DeferredClusterSpeedTest {
+public:
+  DeferredClusterSpeedTest()
+      : http_context_(factory_.stats_.symbolTable()), grpc_context_(factory_.stats_.symbolTable()),
+        router_context_(factory_.stats_.symbolTable()) {}
+
+  void clustersHelper(State& state, size_t num_clusters, size_t hosts_per_cluster,
+                      WorkerClusters worker_clusters) {
+    state.PauseTiming();
+    envoy::config::bootstrap::v3::Bootstrap bootstrap;
+    bootstrap.mutable_cluster_manager()->set_enable_deferred_cluster_creation(
+        worker_clusters != WorkerClusters::Eager);
+    for (size_t i = 0; i < num_clusters; ++i) {
+      auto* cluster = bootstrap.mutable_static_resources()->add_clusters();
+      cluster->set_name(absl::StrCat("cluster_", i));
+      cluster->set_type(envoy::config::cluster::v3::Cluster::STATIC);
+      cluster->mutable_connect_timeout()->set_seconds(1);
+      auto* load_assignment = cluster->mutable_load_assignment();
+      load_assignment->set_cluster_name(cluster->name());
+      auto* endpoints = load_assignment->add_endpoints();
+      for (size_t j = 0; j < hosts_per_cluster; ++j) {
+        auto* socket_address = endpoints->add_lb_endpoints()
+                                   ->mutable_endpoint()
+                                   ->mutable_address()
+                                   ->mutable_socket_address();
+        socket_address->set_address("10.0.1.1");
+        socket_address->set_port_value(1000 + j);
+      }
+    }
+    const uint64_t memory_before = Memory::Stats::totalCurrentlyAllocated();
+    state.ResumeTiming();
+
+    cluster_manager_ = TestClusterManagerImpl::createAndInit(
+        bootstrap, factory_, factory_.server_context_, factory_.stats_, factory_.tls_,
+        factory_.runtime_, factory_.local_info_, log_manager_, factory_.dispatcher_, admin_,
+        validation_context_, *factory_.api_, http_context_, grpc_context_, router_context_, server_,
+        xds_manager_);
+    if (worker_clusters == WorkerClusters::DeferredAllUsed) {
+      for (size_t i = 0; i < num_clusters; ++i) {
+        RELEASE_ASSERT(cluster_manager_->getThreadLocalCluster(absl::StrCat("cluster_", i)) !=
+                           nullptr,
+                       "");
+      }
+    }
+
+    state.PauseTiming();
+    const uint64_t memory_after = Memory::Stats::totalCurrentlyAllocated();
+    state.counters["bytes_per_cluster"] =
+        static_cast<double>(memory_after - memory_before) / num_clusters;
+    state.ResumeTiming();
+  }
+
+  NiceMock<TestClusterManagerFactory> factory_;
+  NiceMock<ProtobufMessage::MockValidationContext> validation_context_;
+  NiceMock<Config::MockXdsManager> xds_manager_;
+  AccessLog::MockAccessLogManager log_manager_;
+  NiceMock<Server::MockAdmin> admin_;
+  Http::ContextImpl http_context_;
+  Grpc::ContextImpl grpc_context_;
+  Router::ContextImpl router_context_;
+  NiceMock<Server::MockInstance> server_;
+  std::unique_ptr<TestClusterManagerImpl> cluster_manager_;
+};
+
+} // namespace Upstream
+} // namespace Envoy
+
+static void workerClusterMemory(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    Envoy::Upstream::DeferredClusterSpeedTest speed_test;
+    // if we've been instructed to skip tests, only run once no matter the argument:
+    const size_t clusters = skipExpensiveBenchmarks() ? 1 : state.range(0);
+
+    speed_test.clustersHelper(state, clusters, 4,
+                              static_cast<Envoy::Upstream::WorkerClusters>(state.range(1)));
+  }
+}
+
+BENCHMARK(workerClusterMemory)
+    ->ArgsProduct({{1000, 10000, 60000}, {0, 1, 2}})
+    ->Unit(benchmark::kMillisecond);
@@ -633,7 +633,8 @@ TEST_F(HdsTest, TestSocketContext) {
         // set socket_matcher object in test scope.
         socket_matcher =
             Envoy::Upstream::TransportSocketMatcherImpl::create(
-                params.cluster_.transport_socket_matches(), factory_context, socket_factory, *scope)
+                params.cluster_.transport_socket_matches(), factory_context, socket_factory,
+                params.cluster_.transport_socket(), *scope)
                 .value();
 
         // But still use the fake cluster_info_.
@@ -1124,7 +1125,8 @@ TEST_F(HdsTest, TestUpdateSocketContext) {
         // set socket_matcher object in test scope.
         socket_matchers.push_back(
             Envoy::Upstream::TransportSocketMatcherImpl::create(
-                params.cluster_.transport_socket_matches(), factory_context, socket_factory, *scope)
+                params.cluster_.transport_socket_matches(), factory_context, socket_factory,
+                params.cluster_.transport_socket(), *scope)
                 .value());
 
         // But still use the fake cluster_info_.
@@ -0,0 +1,147 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/common/random_generator.h"
+#include "source/common/singleton/manager_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/health_checkers/common/health_checker_base_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/utility.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/cluster_priority_set.h"
+#include "test/mocks/upstream/host_set.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Upstream {
+
+// A health checker whose probes succeed on the next iteration of the event loop, so that only the
+// cost of scheduling the probes and of recording their results is measured.
+class BenchmarkHealthChecker : public HealthCheckerImplBase {
+public:
+  BenchmarkHealthChecker(const Cluster& cluster, const envoy::config::core::v3::HealthCheck& config,
+                         Event::Dispatcher& dispatcher, Runtime::Loader& runtime,
+                         Random::RandomGenerator& random)
+      : HealthCheckerImplBase(cluster, config, dispatcher, runtime, random, nullptr) {}
+
+private:
+  struct Session : public ActiveHealthCheckSession {
+    Session(BenchmarkHealthChecker& health_checker, HostSharedPtr host)
+        : ActiveHealthCheckSession(health_checker, host), health_checker_(health_checker) {}
+
+    void onInterval() override {
+      health_checker_.dispatcher_.post([this]() { handleSuccess(); });
+    }
+    void onTimeout() override {}
+    void onDeferredDelete() override {}
+
+    BenchmarkHealthChecker& health_checker_;
+  };
+
+  // HealthCheckerImplBase
+  ActiveHealthCheckSessionPtr makeSession(HostSharedPtr host) override {
+    return std::make_unique<Session>(*this, host);
+  }
+  envoy::data::core::v3::HealthCheckerType healthCheckerType() const override {
+    return envoy::data::core::v3::TCP;
+  }
+};
+
+// Clusters which all have the same endpoints, each of which is health checked by every cluster.
+class HealthCheckerBenchmark {
+public:
+  HealthCheckerBenchmark(uint32_t num_clusters, uint32_t num_endpoints, bool share_probes)
+      : api_(Api::createApiForTest(store_, time_system_)),
+        dispatcher_(api_->allocateDispatcher("main_thread")) {
+    envoy::config::core::v3::HealthCheck config = parseHealthCheckFromV3Yaml(R"EOF(
+      timeout: 1s
+      interval: 5s
+      unhealthy_threshold: 2
+      healthy_threshold: 2
+      tcp_health_check: {}
+    )EOF");
+    config.set_share_probes(share_probes);
+    for (uint32_t i = 0; i < num_clusters; ++i) {
+      auto cluster = std::make_shared<testing::NiceMock<MockClusterMockPrioritySet>>();
+      HostVector hosts;
+      hosts.reserve(num_endpoints);
+      for (uint32_t j = 0; j < num_endpoints; ++j) {
+        hosts.push_back(makeTestHost(cluster->info_,
+                                     absl::StrCat("tcp://10.", (j >> 16) & 0xff, ".",
+                                                  (j >> 8) & 0xff, ".", j & 0xff, ":80"),
+                                     time_system_));
+      }
+      cluster->prioritySet().getMockHostSet(0)->hosts_ = std::move(hosts);
+      auto health_checker = std::make_shared<BenchmarkHealthChecker>(
+          *cluster, config, *dispatcher_, runtime_, random_);
+      health_checker->initSharedProbes(singleton_manager_);
+      clusters_.push_back(std::move(cluster));
+      health_checkers_.push_back(std::move(health_checker));
+    }
+  }
+
+  void start() {
+    for (auto& health_checker : health_checkers_) {
+      health_checker->start();
+    }
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+
+  // Runs the main thread through one health check interval.
+  void runInterval() {
+    time_system_.advanceTimeAndRun(std::chrono::seconds(5), *dispatcher_,
+                                   Event::Dispatcher::RunType::NonBlock);
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+
+  uint64_t attempts() const {
+    uint64_t attempts = 0;
+    for (const auto& cluster : clusters_) {
+      attempts += cluster->info_->stats_store_.counter("health_check.attempt").value();
+    }
+    return attempts;
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl store_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  testing::NiceMock<Runtime::MockLoader> runtime_;
+  Random::RandomGeneratorImpl random_;
+  Singleton::ManagerImpl singleton_manager_;
+  std::vector<std::shared_ptr<MockClusterMockPrioritySet>> clusters_;
+  std::vector<std::shared_ptr<BenchmarkHealthChecker>> health_checkers_;
+};
+
+// Measures the main thread time of a health check interval of clusters with overlapping
+// endpoints, with and without sharing their probes.
+static void healthCheckInterval(::benchmark::State& state) {
+  const uint32_t num_clusters = state.range(0);
+  const uint32_t num_endpoints = benchmark::skipExpensiveBenchmarks() ? 1000 : state.range(1);
+  const bool share_probes = state.range(2);
+  HealthCheckerBenchmark speed_test(num_clusters, num_endpoints, share_probes);
+  speed_test.start();
+  const uint64_t initial_attempts = speed_test.attempts();
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    speed_test.runInterval();
+  }
+  state.counters["probes_per_interval"] =
+      static_cast<double>(speed_test.attempts() - initial_attempts) / state.iterations();
+  state.SetItemsProcessed(state.iterations() * num_endpoints);
+}
+
+BENCHMARK(healthCheckInterval)
+    ->ArgsProduct({{4}, {1000, 10000, 30000}, {false, true}})
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace Upstream
+} // namespace Envoy
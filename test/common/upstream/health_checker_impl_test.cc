@@ -19,6 +19,7 @@
 #include "source/common/json/json_loader.h"
 #include "source/common/network/utility.h"
 #include "source/common/protobuf/utility.h"
+#include "source/common/singleton/manager_impl.h"
 #include "source/common/upstream/health_checker_impl.h"
 #include "source/common/upstream/upstream_impl.h"
 #include "source/extensions/health_checkers/grpc/health_checker_impl.h"
@@ -4818,6 +4819,167 @@ TEST_F(TcpHealthCheckerImplTest, SuccessProxyProtocol) {
   read_filter_->onData(response, false);
 }
 
+// Health checkers of two clusters which share the probes of their hosts.
+class SharedProbesHealthCheckerImplTest : public testing::Test,
+                                          public HealthCheckerTestBase,
+                                          public Event::TestUsingSimulatedTime {
+public:
+  struct TestSession {
+    Event::MockTimer* interval_timer_{};
+    Event::MockTimer* timeout_timer_{};
+  };
+
+  SharedProbesHealthCheckerImplTest() {
+    const std::string yaml = R"EOF(
+    timeout: 1s
+    interval: 1s
+    unhealthy_threshold: 2
+    healthy_threshold: 2
+    share_probes: true
+    tcp_health_check: {}
+    )EOF";
+    for (auto& cluster : {cluster_, other_cluster_}) {
+      auto health_checker = std::make_shared<TcpHealthCheckerImpl>(
+          *cluster, parseHealthCheckFromV3Yaml(yaml), dispatcher_, runtime_, random_, nullptr);
+      health_checker->initSharedProbes(singleton_manager_);
+      health_checkers_.push_back(health_checker);
+      cluster->prioritySet().getMockHostSet(0)->hosts_ = {
+          makeTestHost(cluster->info_, "tcp://127.0.0.1:80", simTime())};
+    }
+  }
+
+  TestSession expectSessionCreate() {
+    // Expectations are in LIFO order, and the interval timer is created first.
+    TestSession session;
+    session.timeout_timer_ = new Event::MockTimer(&dispatcher_);
+    session.interval_timer_ = new Event::MockTimer(&dispatcher_);
+    return session;
+  }
+
+  void expectClientCreate() {
+    connection_ = new NiceMock<Network::MockClientConnection>();
+    EXPECT_CALL(dispatcher_, createClientConnection_(_, _, _, _)).WillOnce(Return(connection_));
+  }
+
+  uint64_t counter(MockClusterMockPrioritySet& cluster, const std::string& name) {
+    return cluster.info_->stats_store_.counter(name).value();
+  }
+
+  std::shared_ptr<MockClusterMockPrioritySet> other_cluster_{
+      std::make_shared<NiceMock<MockClusterMockPrioritySet>>()};
+  Singleton::ManagerImpl singleton_manager_;
+  std::vector<std::shared_ptr<TcpHealthCheckerImpl>> health_checkers_;
+  Network::MockClientConnection* connection_{};
+};
+
+// Only the session of the first cluster probes the host, and the result is recorded by both.
+TEST_F(SharedProbesHealthCheckerImplTest, ProbesOncePerHost) {
+  // Sessions are created in reverse order of their expectations.
+  TestSession other_session = expectSessionCreate();
+  TestSession session = expectSessionCreate();
+  expectClientCreate();
+  EXPECT_CALL(*session.timeout_timer_, enableTimer(_, _));
+  health_checkers_[0]->start();
+  EXPECT_CALL(*other_session.interval_timer_, enableTimer(_, _)).Times(0);
+  health_checkers_[1]->start();
+
+  EXPECT_CALL(*session.interval_timer_, enableTimer(_, _));
+  connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  EXPECT_EQ(1UL, counter(*cluster_, "health_check.attempt"));
+  EXPECT_EQ(1UL, counter(*cluster_, "health_check.success"));
+  EXPECT_EQ(0UL, counter(*other_cluster_, "health_check.attempt"));
+  EXPECT_EQ(1UL, counter(*other_cluster_, "health_check.success"));
+}
+
+// A session which joins a group is handed the result of its latest probe right away.
+TEST_F(SharedProbesHealthCheckerImplTest, JoiningSessionGetsLatestResult) {
+  TestSession session = expectSessionCreate();
+  expectClientCreate();
+  health_checkers_[0]->start();
+  connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  TestSession other_session = expectSessionCreate();
+  EXPECT_CALL(*other_session.interval_timer_, enableTimer(std::chrono::milliseconds(0), _));
+  health_checkers_[1]->start();
+
+  EXPECT_CALL(*other_session.interval_timer_, enableTimer(_, _)).Times(0);
+  other_session.interval_timer_->invokeCallback();
+  EXPECT_EQ(0UL, counter(*other_cluster_, "health_check.attempt"));
+  EXPECT_EQ(1UL, counter(*other_cluster_, "health_check.success"));
+}
+
+// Once the host of the probing session is removed, the next session of the group probes it.
+TEST_F(SharedProbesHealthCheckerImplTest, NextSessionProbesOnceFirstIsRemoved) {
+  TestSession other_session = expectSessionCreate();
+  TestSession session = expectSessionCreate();
+  expectClientCreate();
+  health_checkers_[0]->start();
+  health_checkers_[1]->start();
+
+  EXPECT_CALL(*other_session.interval_timer_, enableTimer(std::chrono::milliseconds(0), _));
+  cluster_->prioritySet().getMockHostSet(0)->runCallbacks(
+      {}, {cluster_->prioritySet().getMockHostSet(0)->hosts_.back()});
+
+  expectClientCreate();
+  EXPECT_CALL(*other_session.timeout_timer_, enableTimer(_, _));
+  other_session.interval_timer_->invokeCallback();
+  EXPECT_CALL(*other_session.interval_timer_, enableTimer(_, _));
+  connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  EXPECT_EQ(1UL, counter(*other_cluster_, "health_check.attempt"));
+  EXPECT_EQ(1UL, counter(*other_cluster_, "health_check.success"));
+  EXPECT_EQ(0UL, counter(*cluster_, "health_check.success"));
+}
+
+// Health checkers with different configs do not share their probes.
+TEST_F(SharedProbesHealthCheckerImplTest, DifferentConfigsDoNotShare) {
+  const std::string yaml = R"EOF(
+    timeout: 2s
+    interval: 1s
+    unhealthy_threshold: 2
+    healthy_threshold: 2
+    share_probes: true
+    tcp_health_check: {}
+    )EOF";
+  health_checkers_[1] = std::make_shared<TcpHealthCheckerImpl>(
+      *other_cluster_, parseHealthCheckFromV3Yaml(yaml), dispatcher_, runtime_, random_, nullptr);
+  health_checkers_[1]->initSharedProbes(singleton_manager_);
+
+  expectSessionCreate();
+  expectSessionCreate();
+  EXPECT_CALL(dispatcher_, createClientConnection_(_, _, _, _))
+      .Times(2)
+      .WillRepeatedly(Invoke([](Network::Address::InstanceConstSharedPtr,
+                                Network::Address::InstanceConstSharedPtr,
+                                Network::TransportSocketPtr&,
+                                const Network::ConnectionSocket::OptionsSharedPtr&) {
+        return new NiceMock<Network::MockClientConnection>();
+      }));
+  health_checkers_[0]->start();
+  health_checkers_[1]->start();
+}
+
+// Health checkers of clusters with different transport socket configs do not share their probes.
+TEST_F(SharedProbesHealthCheckerImplTest, DifferentTransportSocketsDoNotShare) {
+  auto& matcher = dynamic_cast<MockTransportSocketMatcher&>(
+      *other_cluster_->info_->transport_socket_matcher_);
+  ON_CALL(matcher, configHash()).WillByDefault(Return(1));
+
+  expectSessionCreate();
+  expectSessionCreate();
+  EXPECT_CALL(dispatcher_, createClientConnection_(_, _, _, _))
+      .Times(2)
+      .WillRepeatedly(Invoke([](Network::Address::InstanceConstSharedPtr,
+                                Network::Address::InstanceConstSharedPtr,
+                                Network::TransportSocketPtr&,
+                                const Network::ConnectionSocket::OptionsSharedPtr&) {
+        return new NiceMock<Network::MockClientConnection>();
+      }));
+  health_checkers_[0]->start();
+  health_checkers_[1]->start();
+}
+
 class TestGrpcHealthCheckerImpl : public GrpcHealthCheckerImpl {
 public:
   using GrpcHealthCheckerImpl::GrpcHealthCheckerImpl;
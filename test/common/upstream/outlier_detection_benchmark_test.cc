@@ -0,0 +1,98 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <chrono>
+#include <memory>
+
+#include "source/common/common/random_generator.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/common/upstream/outlier_detection_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/utility.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/cluster_priority_set.h"
+#include "test/mocks/upstream/host_set.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace Outlier {
+
+// A cluster with success rate and failure percentage outlier detection, in which one host out of a
+// hundred fails half of its requests.
+class OutlierDetectionBenchmark {
+public:
+  explicit OutlierDetectionBenchmark(uint32_t num_hosts)
+      : api_(Api::createApiForTest(store_, time_system_)),
+        dispatcher_(api_->allocateDispatcher("main_thread")) {
+    HostVector hosts;
+    hosts.reserve(num_hosts);
+    for (uint32_t i = 0; i < num_hosts; ++i) {
+      hosts.push_back(makeTestHost(cluster_.info_,
+                                   absl::StrCat("tcp://10.", (i >> 16) & 0xff, ".",
+                                                (i >> 8) & 0xff, ".", i & 0xff, ":80"),
+                                   time_system_));
+    }
+    cluster_.prioritySet().getMockHostSet(0)->hosts_ = std::move(hosts);
+    envoy::config::cluster::v3::OutlierDetection config;
+    config.mutable_enforcing_failure_percentage()->set_value(100);
+    detector_ = DetectorImpl::create(cluster_, config, *dispatcher_, runtime_, time_system_,
+                                     nullptr, random_)
+                    .value();
+  }
+
+  // Reports the requests of an interval to the monitor of each host.
+  void loadRequests() {
+    const auto& hosts = cluster_.prioritySet().getMockHostSet(0)->hosts_;
+    for (uint32_t i = 0; i < hosts.size(); ++i) {
+      for (uint32_t j = 0; j < RequestsPerInterval; ++j) {
+        hosts[i]->outlierDetector().putHttpResponseCode(i % 100 == 0 && j % 2 == 0 ? 503 : 200);
+      }
+    }
+  }
+
+  // Runs the main thread through one outlier detection interval.
+  void runInterval() {
+    time_system_.advanceTimeAndRun(std::chrono::seconds(10), *dispatcher_,
+                                   Event::Dispatcher::RunType::NonBlock);
+  }
+
+  static constexpr uint32_t RequestsPerInterval = 100;
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl store_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  testing::NiceMock<Runtime::MockLoader> runtime_;
+  Random::RandomGeneratorImpl random_;
+  testing::NiceMock<MockClusterMockPrioritySet> cluster_;
+  std::shared_ptr<DetectorImpl> detector_;
+};
+
+// Measures the main thread time of an outlier detection interval of a large cluster.
+static void outlierDetectionInterval(::benchmark::State& state) {
+  const uint32_t num_hosts = benchmark::skipExpensiveBenchmarks() ? 1000 : state.range(0);
+  OutlierDetectionBenchmark speed_test(num_hosts);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    speed_test.loadRequests();
+    state.ResumeTiming();
+    speed_test.runInterval();
+  }
+  state.SetItemsProcessed(state.iterations() * num_hosts);
+}
+
+BENCHMARK(outlierDetectionInterval)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(50000)
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace Outlier
+} // namespace Upstream
+} // namespace Envoy
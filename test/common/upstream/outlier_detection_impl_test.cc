@@ -1,4 +1,5 @@
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -30,6 +31,7 @@
 #include "gtest/gtest.h"
 
 using testing::_;
+using testing::AnyNumber;
 using testing::NiceMock;
 using testing::Return;
 using testing::ReturnRef;
@@ -1274,6 +1276,76 @@ TEST_F(OutlierDetectorImplTest, BasicFlowSuccessRateExternalOrigin) {
                     DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin));
 }
 
+// Hosts which join or leave the cluster between intervals are taken into account by the success
+// rate statistics of the next interval.
+TEST_F(OutlierDetectorImplTest, SuccessRateAfterMembershipChange) {
+  ON_CALL(runtime_.snapshot_, getInteger(MaxEjectionPercentRuntime, _)).WillByDefault(Return(100));
+  ON_CALL(runtime_.snapshot_, getInteger(SuccessRateStdevFactorRuntime, 1900))
+      .WillByDefault(Return(1900));
+  EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
+  addHosts({
+      "tcp://127.0.0.1:80",
+      "tcp://127.0.0.1:81",
+      "tcp://127.0.0.1:82",
+      "tcp://127.0.0.1:83",
+  });
+
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  std::shared_ptr<DetectorImpl> detector(DetectorImpl::create(cluster_, empty_outlier_detection_,
+                                                              dispatcher_, runtime_, time_system_,
+                                                              event_logger_, random_)
+                                             .value());
+  detector->addChangedStateCb([&](HostSharedPtr host) -> void { checker_.check(host); });
+  ON_CALL(runtime_.snapshot_, featureEnabled(EnforcingConsecutive5xxRuntime, 100))
+      .WillByDefault(Return(false));
+  ON_CALL(runtime_.snapshot_, featureEnabled(EnforcingConsecutiveGatewayFailureRuntime, 100))
+      .WillByDefault(Return(false));
+  EXPECT_CALL(*event_logger_, logEject(_, _, envoy::data::cluster::v3::CONSECUTIVE_5XX, false))
+      .Times(AnyNumber());
+  EXPECT_CALL(*event_logger_,
+              logEject(_, _, envoy::data::cluster::v3::CONSECUTIVE_GATEWAY_FAILURE, false))
+      .Times(AnyNumber());
+
+  // Four hosts are fewer than the minimum number of hosts for success rate ejection.
+  loadRq(hosts_, 200, 200);
+  time_system_.setMonotonicTime(std::chrono::milliseconds(10000));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  interval_timer_->invokeCallback();
+  EXPECT_EQ(-1, detector->successRateAverage(
+                    DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin));
+
+  // A fifth host joins and fails its requests, and is ejected by the next interval.
+  addHosts({"tcp://127.0.0.1:84"});
+  cluster_.prioritySet().getMockHostSet(0)->runCallbacks({hosts_[4]}, {});
+  loadRq(hosts_, 200, 200);
+  loadRq(hosts_[4], 200, 503);
+  time_system_.setMonotonicTime(std::chrono::milliseconds(20000));
+  EXPECT_CALL(checker_, check(hosts_[4]));
+  EXPECT_CALL(*event_logger_, logEject(std::static_pointer_cast<const HostDescription>(hosts_[4]),
+                                       _, envoy::data::cluster::v3::SUCCESS_RATE, true));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  interval_timer_->invokeCallback();
+  EXPECT_EQ(90, detector->successRateAverage(
+                    DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin));
+  EXPECT_EQ(52, detector->successRateEjectionThreshold(
+                    DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin));
+  EXPECT_TRUE(hosts_[4]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+  EXPECT_EQ(1UL, outlier_detection_ejections_active_.value());
+
+  // Once the ejected host leaves, the remaining hosts are too few again.
+  HostSharedPtr removed_host = hosts_[4];
+  hosts_.pop_back();
+  cluster_.prioritySet().getMockHostSet(0)->runCallbacks({}, {removed_host});
+  EXPECT_EQ(0UL, outlier_detection_ejections_active_.value());
+  loadRq(hosts_, 200, 200);
+  time_system_.setMonotonicTime(std::chrono::milliseconds(30000));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  interval_timer_->invokeCallback();
+  EXPECT_EQ(-1, detector->successRateAverage(
+                    DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin));
+  EXPECT_EQ(4UL, detector->getHostMonitors().size());
+}
+
 // Test verifies that EXT_ORIGIN_REQUEST_FAILED and EXT_ORIGIN_REQUEST_SUCCESS cancel
 // each other in split mode.
 TEST_F(OutlierDetectorImplTest, ExternalOriginEventsWithSplit) {
@@ -2745,19 +2817,38 @@ TEST(OutlierDetectionEventLoggerImplTest, All) {
 }
 
 TEST(OutlierUtility, SRThreshold) {
-  std::vector<HostSuccessRatePair> data = {
-      HostSuccessRatePair(nullptr, 50),  HostSuccessRatePair(nullptr, 100),
-      HostSuccessRatePair(nullptr, 100), HostSuccessRatePair(nullptr, 100),
-      HostSuccessRatePair(nullptr, 100),
-  };
-  double sum = 450;
+  const std::vector<double> data = {50, 100, 100, 100, 100};
 
   DetectorImpl::EjectionPair success_rate_nums =
-      DetectorImpl::successRateEjectionThreshold(sum, data, 1.9);
+      DetectorImpl::successRateEjectionThreshold(data, 1.9);
   EXPECT_EQ(90.0, success_rate_nums.success_rate_average_); // average success rate
   EXPECT_EQ(52.0, success_rate_nums.ejection_threshold_);   //  ejection threshold
 }
 
+TEST(OutlierUtility, SRThresholdColumn) {
+  // Enough data points to fill the partial sums of the column passes several times over, and a
+  // remainder which does not.
+  std::vector<double> data;
+  for (uint32_t i = 0; i < 1003; ++i) {
+    data.push_back(i % 10 == 0 ? 40.0 : 100.0 - (i % 7));
+  }
+  double sum = 0;
+  for (double success_rate : data) {
+    sum += success_rate;
+  }
+  const double mean = sum / data.size();
+  double variance = 0;
+  for (double success_rate : data) {
+    variance += (success_rate - mean) * (success_rate - mean);
+  }
+  const double stdev = std::sqrt(variance / data.size());
+
+  DetectorImpl::EjectionPair success_rate_nums =
+      DetectorImpl::successRateEjectionThreshold(data, 1.9);
+  EXPECT_DOUBLE_EQ(mean, success_rate_nums.success_rate_average_);
+  EXPECT_DOUBLE_EQ(mean - 1.9 * stdev, success_rate_nums.ejection_threshold_);
+}
+
 } // namespace
 } // namespace Outlier
 } // namespace Upstream
@@ -19,6 +19,7 @@
 #include "test/test_common/registry.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_replace.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -97,7 +98,8 @@ public:
       TestUtility::loadFromYaml(yaml, *transport_socket_match);
     }
     matcher_ = TransportSocketMatcherImpl::create(matches, mock_factory_context_,
-                                                  mock_default_factory_, *stats_scope_)
+                                                  mock_default_factory_, default_config_,
+                                                  *stats_scope_)
                    .value();
   }
 
@@ -117,6 +119,7 @@ protected:
   TransportSocketMatcherPtr matcher_;
   NiceMock<Server::Configuration::MockTransportSocketFactoryContext> mock_factory_context_;
   Network::UpstreamTransportSocketFactoryPtr mock_default_factory_;
+  envoy::config::core::v3::TransportSocket default_config_;
   Stats::IsolatedStoreImpl stats_store_;
   Stats::ScopeSharedPtr stats_scope_;
 };
@@ -387,5 +390,33 @@ filter_metadata:
 }
 
 } // namespace
+// The config hash of a matcher covers the default transport socket and the matches.
+TEST_F(TransportSocketMatcherTest, ConfigHash) {
+  const std::string match_yaml = R"EOF(
+name: "enableFooSocket"
+match:
+  hasSidecar: "true"
+transport_socket:
+  name: "foo"
+  typed_config:
+    "@type": type.googleapis.com/envoy.config.core.v3.Node
+    id: "abc"
+ )EOF";
+  const auto config_hash = [this](const std::vector<std::string>& match_yaml) {
+    mock_default_factory_ =
+        std::make_unique<NiceMock<FakeTransportSocketFactory>>("default", false);
+    init(match_yaml);
+    return matcher_->configHash();
+  };
+
+  const uint64_t hash = config_hash({match_yaml});
+  EXPECT_EQ(hash, config_hash({match_yaml}));
+  EXPECT_NE(hash, config_hash({}));
+  EXPECT_NE(hash, config_hash({absl::StrReplaceAll(match_yaml, {{"abc", "def"}})}));
+
+  default_config_.set_name("bar");
+  EXPECT_NE(hash, config_hash({match_yaml}));
+}
+
 } // namespace Upstream
 } // namespace Envoy
@@ -31,6 +31,7 @@
 #include "test/mocks/ssl/mocks.h"
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/test_common/test_runtime.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
 #include "benchmark/benchmark.h"
@@ -43,7 +44,7 @@ namespace Upstream {
 
 class EdsSpeedTest {
 public:
-  EdsSpeedTest(State& state, bool use_unified_mux)
+  EdsSpeedTest(State& state, bool use_unified_mux, uint32_t resource_decode_threads = 0)
       : state_(state), use_unified_mux_(use_unified_mux),
         type_url_("type.googleapis.com/envoy.config.endpoint.v3.ClusterLoadAssignment"),
         subscription_stats_(Config::Utility::generateStats(scope_)),
@@ -67,7 +68,18 @@ public:
         /*xds_config_tracker_=*/Config::XdsConfigTrackerOptRef(),
         /*backoff_strategy_=*/std::move(backoff_strategy),
         /*target_xds_authority_=*/"",
-        /*eds_resources_cache_=*/nullptr};
+        /*eds_resources_cache_=*/nullptr,
+        /*resource_decode_threads_=*/resource_decode_threads,
+        /*thread_factory_=*/Thread::threadFactoryForTest()};
+    if (resource_decode_threads > 0) {
+      // Decoded resources are posted back from the decoding threads, which the mock dispatcher
+      // does not allow; collect them and run them in deliverResponse() instead.
+      ON_CALL(server_context_.dispatcher_, post(_))
+          .WillByDefault([this](Event::PostCb callback) {
+            absl::MutexLock lock(&posted_mutex_);
+            posted_callbacks_.push_back(std::move(callback));
+          });
+    }
     if (use_unified_mux_) {
       grpc_mux_ = std::make_shared<Config::XdsMux::GrpcMuxSotw>(grpc_mux_context, true);
     } else {
@@ -154,17 +166,69 @@ public:
     auto* resource = response->mutable_resources()->Add();
     resource->PackFrom(cluster_load_assignment);
     state_.ResumeTiming();
+    deliverResponse(std::move(response));
+    ASSERT(cluster_->prioritySet().hostSetsPerPriority()[1]->hostsPerLocality().get()[0].size() ==
+           num_hosts);
+  }
+
+  // Push a single response carrying the watched assignment along with num_assignments other
+  // assignments of hosts_per_assignment hosts each, so that the cost of decoding the resources
+  // dominates.
+  void manyLoadAssignmentsHelper(size_t num_assignments, size_t hosts_per_assignment) {
+    state_.PauseTiming();
+    validation_visitor_.setSkipValidation(false);
+
+    auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+    response->set_type_url(type_url_);
+    response->set_version_info(fmt::format("version-{}", version_++));
+    for (size_t i = 0; i <= num_assignments; ++i) {
+      envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
+      cluster_load_assignment.set_cluster_name(i == 0 ? "fare" : absl::StrCat("cluster_", i));
+      auto* endpoints = cluster_load_assignment.add_endpoints();
+      for (size_t j = 0; j < hosts_per_assignment; ++j) {
+        auto* socket_address = endpoints->add_lb_endpoints()
+                                   ->mutable_endpoint()
+                                   ->mutable_address()
+                                   ->mutable_socket_address();
+        socket_address->set_address("10.0.1.1");
+        socket_address->set_port_value(1000 + j);
+      }
+      response->mutable_resources()->Add()->PackFrom(cluster_load_assignment);
+    }
+    state_.ResumeTiming();
+    deliverResponse(std::move(response));
+    ASSERT(cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size() ==
+           hosts_per_assignment);
+  }
+
+  void
+  deliverResponse(std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& response) {
     if (use_unified_mux_) {
       dynamic_cast<Config::XdsMux::GrpcMuxSotw&>(*grpc_mux_)
           .grpcStreamForTest()
           .onReceiveMessage(std::move(response));
-    } else {
-      dynamic_cast<Config::GrpcMuxImpl&>(*grpc_mux_)
-          .grpcStreamForTest()
-          .onReceiveMessage(std::move(response));
+      return;
+    }
+    auto& grpc_mux = dynamic_cast<Config::GrpcMuxImpl&>(*grpc_mux_);
+    grpc_mux.grpcStreamForTest().onReceiveMessage(std::move(response));
+    Config::ResourceDecodePool* pool = grpc_mux.resourceDecodePoolForTest();
+    if (pool == nullptr) {
+      return;
+    }
+    while (true) {
+      pool->waitForIdle();
+      std::vector<Event::PostCb> callbacks;
+      {
+        absl::MutexLock lock(&posted_mutex_);
+        callbacks.swap(posted_callbacks_);
+      }
+      if (callbacks.empty()) {
+        return;
+      }
+      for (auto& callback : callbacks) {
+        callback();
+      }
     }
-    ASSERT(cluster_->prioritySet().hostSetsPerPriority()[1]->hostsPerLocality().get()[0].size() ==
-           num_hosts);
   }
 
   NiceMock<Server::Configuration::MockServerFactoryContext> server_context_;
@@ -193,6 +257,8 @@ public:
   Config::GrpcMuxSharedPtr grpc_mux_;
   Config::GrpcSubscriptionImplPtr subscription_;
   NiceMock<AccessLog::MockAccessLogManager> access_log_manager_;
+  absl::Mutex posted_mutex_;
+  std::vector<Event::PostCb> posted_callbacks_ ABSL_GUARDED_BY(posted_mutex_);
 };
 
 } // namespace Upstream
@@ -245,3 +311,19 @@ static void healthOnlyUpdate(State& state) {
 }
 
 BENCHMARK(healthOnlyUpdate)->Ranges({{1, 100000}, {false, true}})->Unit(benchmark::kMillisecond);
+
+static void manyLoadAssignments(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    Envoy::Upstream::EdsSpeedTest speed_test(state, false, state.range(1));
+    uint32_t assignments = skipExpensiveBenchmarks() ? 1 : state.range(0);
+
+    speed_test.manyLoadAssignmentsHelper(assignments, 10);
+  }
+}
+
+BENCHMARK(manyLoadAssignments)
+    ->ArgsProduct({{100, 10000}, {0, 1, 4, 8}})
+    ->Unit(benchmark::kMillisecond);
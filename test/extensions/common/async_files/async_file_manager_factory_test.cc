@@ -57,6 +57,20 @@ TEST_F(AsyncFileManagerFactoryTest, ExceptionIfThreadPoolSelectedAndUnsupported)
                             EnvoyException, "AsyncFileManagerThreadPool not supported");
 }
 
+TEST_F(AsyncFileManagerFactoryTest, ExceptionIfIoUringSelectedWithoutThreadLocalSlots) {
+  envoy::extensions::common::async_files::v3::AsyncFileManagerConfig config;
+  config.mutable_io_uring()->mutable_thread_pool()->set_thread_count(1);
+#if defined(__linux__)
+  EXPECT_THROW_WITH_MESSAGE(factory_->getAsyncFileManager(config, &mock_posix_file_operations_),
+                            EnvoyException,
+                            "AsyncFileManager io_uring requires thread local slots");
+#else
+  EXPECT_THROW_WITH_MESSAGE(factory_->getAsyncFileManager(config, &mock_posix_file_operations_),
+                            EnvoyException,
+                            "AsyncFileManager io_uring is only supported on Linux");
+#endif
+}
+
 TEST_F(AsyncFileManagerFactoryTest, ExceptionIfGivenInconsistentConfigForSameManagerId) {
   envoy::extensions::common::async_files::v3::AsyncFileManagerConfig config;
   config.mutable_thread_pool()->set_thread_count(1);
@@ -0,0 +1,223 @@
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "envoy/extensions/common/async_files/v3/async_file_manager.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/io/io_uring_impl.h"
+#include "source/common/thread_local/thread_local_impl.h"
+#include "source/extensions/common/async_files/async_file_context_io_uring.h"
+#include "source/extensions/common/async_files/async_file_handle.h"
+#include "source/extensions/common/async_files/async_file_manager.h"
+#include "source/extensions/common/async_files/async_file_manager_factory.h"
+#include "source/extensions/common/async_files/async_file_manager_io_uring.h"
+
+#include "test/test_common/status_utility.h"
+#include "test/test_common/utility.h"
+
+#include "absl/status/statusor.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+using StatusHelpers::IsOkAndHolds;
+using StatusHelpers::StatusIs;
+
+class AsyncFileManagerIoUringTest : public testing::Test {
+public:
+  AsyncFileManagerIoUringTest() : should_skip_(!Io::isIoUringSupported()) {}
+
+  void SetUp() override {
+    if (should_skip_) {
+      GTEST_SKIP();
+    }
+    tls_.registerThread(*dispatcher_, true);
+    envoy::extensions::common::async_files::v3::AsyncFileManagerConfig config;
+    config.set_id("io_uring");
+    // Small enough that some of the reads and writes of the tests don't fit.
+    config.mutable_io_uring()->set_registered_buffer_size(16);
+    config.mutable_io_uring()->mutable_thread_pool()->set_thread_count(1);
+    factory_ = AsyncFileManagerFactory::singleton(singleton_manager_.get(), &tls_);
+    manager_ = factory_->getAsyncFileManager(config);
+  }
+
+  void TearDown() override {
+    if (should_skip_) {
+      return;
+    }
+    manager_.reset();
+    factory_.reset();
+    tls_.shutdownGlobalThreading();
+    tls_.shutdownThread();
+  }
+
+  // The ring keeps a file event registered with the dispatcher, so the dispatcher is run until
+  // the condition holds rather than until it has nothing to do.
+  void runUntil(const std::function<bool()>& condition) {
+    Event::TestTimeSystem::RealTimeBound bound(TestUtility::DefaultTimeout);
+    while (!condition()) {
+      RELEASE_ASSERT(bound.withinBound(), "Timed out waiting for the condition.");
+      manager_->waitForIdle();
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+
+  IoUringFileRing& ring() {
+    return *static_cast<AsyncFileManagerIoUring&>(*manager_).ringFor(dispatcher_.get());
+  }
+
+  AsyncFileHandle createAnonymousFile() {
+    AsyncFileHandle create_result;
+    manager_->createAnonymousFile(
+        dispatcher_.get(), tmpdir_,
+        [&](absl::StatusOr<AsyncFileHandle> result) { create_result = result.value(); });
+    runUntil([&]() { return create_result != nullptr; });
+    return create_result;
+  }
+
+  absl::StatusOr<size_t> write(AsyncFileHandle& handle, absl::string_view contents, off_t offset,
+                               Event::Dispatcher* dispatcher) {
+    absl::optional<absl::StatusOr<size_t>> write_result;
+    Buffer::OwnedImpl buffer(contents);
+    EXPECT_OK(handle->write(dispatcher, buffer, offset, [&](absl::StatusOr<size_t> result) {
+      write_result = std::move(result);
+    }));
+    EXPECT_EQ(buffer.length(), 0);
+    runUntil([&]() { return write_result.has_value(); });
+    return *write_result;
+  }
+
+  std::string read(AsyncFileHandle& handle, off_t offset, size_t length,
+                   Event::Dispatcher* dispatcher) {
+    absl::optional<absl::StatusOr<Buffer::InstancePtr>> read_result;
+    EXPECT_OK(handle->read(dispatcher, offset, length,
+                           [&](absl::StatusOr<Buffer::InstancePtr> result) {
+                             read_result = std::move(result);
+                           }));
+    runUntil([&]() { return read_result.has_value(); });
+    EXPECT_OK(*read_result);
+    return read_result->ok() ? read_result->value()->toString() : "";
+  }
+
+  void close(AsyncFileHandle& handle) {
+    absl::optional<absl::Status> close_result;
+    EXPECT_OK(handle->close(dispatcher_.get(),
+                            [&](absl::Status status) { close_result = std::move(status); }));
+    runUntil([&]() { return close_result.has_value(); });
+    EXPECT_OK(*close_result);
+  }
+
+  const bool should_skip_;
+  const char* test_tmpdir = std::getenv("TEST_TMPDIR");
+  std::string tmpdir_ = test_tmpdir ? test_tmpdir : "/tmp";
+
+  Api::ApiPtr api_ = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher_ = api_->allocateDispatcher("test_thread");
+  ThreadLocal::InstanceImpl tls_;
+  std::unique_ptr<Singleton::ManagerImpl> singleton_manager_ =
+      std::make_unique<Singleton::ManagerImpl>();
+  std::shared_ptr<AsyncFileManagerFactory> factory_;
+  std::shared_ptr<AsyncFileManager> manager_;
+};
+
+TEST_F(AsyncFileManagerIoUringTest, Describe) {
+  EXPECT_EQ(manager_->describe(), "io_uring_size = 256, thread_pool_size = 1");
+}
+
+TEST_F(AsyncFileManagerIoUringTest, WriteReadCloseThroughRing) {
+  AsyncFileHandle handle = createAnonymousFile();
+  EXPECT_THAT(write(handle, "hello", 0, dispatcher_.get()), IsOkAndHolds(5U));
+  EXPECT_THAT(write(handle, "p!", 3, dispatcher_.get()), IsOkAndHolds(2U));
+  EXPECT_EQ(read(handle, 0, 5, dispatcher_.get()), "help!");
+  // Past the end of the file.
+  EXPECT_EQ(read(handle, 2, 10, dispatcher_.get()), "lp!");
+  EXPECT_EQ(ring().pendingOperations(), 0);
+  close(handle);
+}
+
+TEST_F(AsyncFileManagerIoUringTest, ReadAndWriteLargerThanRegisteredBuffers) {
+  AsyncFileHandle handle = createAnonymousFile();
+  // Written from several slices.
+  std::string contents(100000, 'a');
+  contents.replace(50000, 5, "hello");
+  EXPECT_THAT(write(handle, contents, 0, dispatcher_.get()), IsOkAndHolds(contents.size()));
+  EXPECT_EQ(read(handle, 0, contents.size(), dispatcher_.get()), contents);
+  EXPECT_EQ(read(handle, 50000, 5, dispatcher_.get()), "hello");
+  close(handle);
+}
+
+TEST_F(AsyncFileManagerIoUringTest, ManyConcurrentReads) {
+  AsyncFileHandle handle = createAnonymousFile();
+  EXPECT_THAT(write(handle, "0123456789", 0, dispatcher_.get()), IsOkAndHolds(10U));
+  // More reads than there are registered buffers.
+  constexpr int Reads = 100;
+  int completed = 0;
+  for (int i = 0; i < Reads; i++) {
+    EXPECT_OK(handle->read(dispatcher_.get(), i % 10, 1,
+                           [&completed, i](absl::StatusOr<Buffer::InstancePtr> result) {
+                             ASSERT_OK(result);
+                             EXPECT_EQ(result.value()->toString(), std::to_string(i % 10));
+                             completed++;
+                           }));
+  }
+  runUntil([&]() { return completed == Reads; });
+  close(handle);
+}
+
+TEST_F(AsyncFileManagerIoUringTest, OperationsWithoutDispatcherUseThreadPool) {
+  AsyncFileHandle handle = createAnonymousFile();
+  EXPECT_THAT(write(handle, "hello", 0, nullptr), IsOkAndHolds(5U));
+  EXPECT_EQ(read(handle, 1, 3, nullptr), "ell");
+  // The ring of this thread can still read what the thread pool wrote.
+  EXPECT_EQ(read(handle, 0, 5, dispatcher_.get()), "hello");
+  close(handle);
+}
+
+TEST_F(AsyncFileManagerIoUringTest, CancelledReadDoesNotCallBack) {
+  AsyncFileHandle handle = createAnonymousFile();
+  EXPECT_THAT(write(handle, "hello", 0, dispatcher_.get()), IsOkAndHolds(5U));
+  bool called = false;
+  absl::StatusOr<CancelFunction> cancel = handle->read(
+      dispatcher_.get(), 0, 5, [&called](absl::StatusOr<Buffer::InstancePtr>) { called = true; });
+  ASSERT_OK(cancel);
+  cancel.value()();
+  runUntil([&]() { return ring().pendingOperations() == 0; });
+  EXPECT_FALSE(called);
+  close(handle);
+}
+
+TEST_F(AsyncFileManagerIoUringTest, UseAfterCloseFails) {
+  AsyncFileHandle handle = createAnonymousFile();
+  close(handle);
+  Buffer::OwnedImpl contents("hello");
+  EXPECT_THAT(handle->write(dispatcher_.get(), contents, 0, [](absl::StatusOr<size_t>) {}),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+  EXPECT_THAT(handle->read(dispatcher_.get(), 0, 5, [](absl::StatusOr<Buffer::InstancePtr>) {}),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+  EXPECT_THAT(handle->close(dispatcher_.get(), [](absl::Status) {}),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST_F(AsyncFileManagerIoUringTest, DuplicateIsReadThroughRing) {
+  AsyncFileHandle handle = createAnonymousFile();
+  EXPECT_THAT(write(handle, "hello", 0, dispatcher_.get()), IsOkAndHolds(5U));
+  AsyncFileHandle duplicate;
+  EXPECT_OK(handle->duplicate(dispatcher_.get(), [&](absl::StatusOr<AsyncFileHandle> result) {
+    duplicate = result.value();
+  }));
+  runUntil([&]() { return duplicate != nullptr; });
+  EXPECT_EQ(read(duplicate, 0, 5, dispatcher_.get()), "hello");
+  close(duplicate);
+  close(handle);
+}
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
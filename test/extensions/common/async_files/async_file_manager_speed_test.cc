@@ -0,0 +1,143 @@
+// Compares the thread pool and io_uring AsyncFileManagers reading a file from the thread of a
+// dispatcher, as a worker does: each iteration issues a batch of concurrent reads and runs the
+// dispatcher until all of them have called back.
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/common/async_files/v3/async_file_manager.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/io/io_uring_impl.h"
+#include "source/common/singleton/manager_impl.h"
+#include "source/common/thread_local/thread_local_impl.h"
+#include "source/extensions/common/async_files/async_file_handle.h"
+#include "source/extensions/common/async_files/async_file_manager.h"
+#include "source/extensions/common/async_files/async_file_manager_factory.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+namespace {
+
+constexpr size_t FileSize = 4 * 1024 * 1024;
+constexpr int ConcurrentReads = 64;
+
+enum class ManagerType { ThreadPool, IoUring };
+
+class ReadBenchmark {
+public:
+  explicit ReadBenchmark(ManagerType type) {
+    tls_.registerThread(*dispatcher_, true);
+    envoy::extensions::common::async_files::v3::AsyncFileManagerConfig config;
+    if (type == ManagerType::ThreadPool) {
+      config.mutable_thread_pool()->set_thread_count(4);
+    } else {
+      config.mutable_io_uring()->mutable_thread_pool()->set_thread_count(4);
+    }
+    factory_ = AsyncFileManagerFactory::singleton(&singleton_manager_, &tls_);
+    manager_ = factory_->getAsyncFileManager(config);
+
+    manager_->createAnonymousFile(dispatcher_.get(), "/tmp",
+                                  [this](absl::StatusOr<AsyncFileHandle> result) {
+                                    RELEASE_ASSERT(result.ok(), "");
+                                    handle_ = std::move(result.value());
+                                  });
+    runUntil([this]() { return handle_ != nullptr; });
+    Buffer::OwnedImpl contents(std::string(FileSize, 'a'));
+    bool written = false;
+    RELEASE_ASSERT(handle_
+                       ->write(dispatcher_.get(), contents, 0,
+                               [&written](absl::StatusOr<size_t> result) {
+                                 RELEASE_ASSERT(result.ok(), "");
+                                 written = true;
+                               })
+                       .ok(),
+                   "");
+    runUntil([&written]() { return written; });
+  }
+
+  ~ReadBenchmark() {
+    bool closed = false;
+    RELEASE_ASSERT(
+        handle_->close(dispatcher_.get(), [&closed](absl::Status) { closed = true; }).ok(), "");
+    runUntil([&closed]() { return closed; });
+    manager_.reset();
+    factory_.reset();
+    tls_.shutdownGlobalThreading();
+    tls_.shutdownThread();
+  }
+
+  // Issues ConcurrentReads reads of length bytes spread over the file, and waits for all of them.
+  // @return the number of bytes read.
+  size_t readBatch(size_t length) {
+    int completed = 0;
+    size_t bytes_read = 0;
+    for (int i = 0; i < ConcurrentReads; i++) {
+      const off_t offset = (i * length) % (FileSize - length);
+      RELEASE_ASSERT(handle_
+                         ->read(dispatcher_.get(), offset, length,
+                                [&](absl::StatusOr<Buffer::InstancePtr> result) {
+                                  RELEASE_ASSERT(result.ok(), "");
+                                  bytes_read += result.value()->length();
+                                  completed++;
+                                })
+                         .ok(),
+                     "");
+    }
+    runUntil([&completed]() { return completed == ConcurrentReads; });
+    return bytes_read;
+  }
+
+private:
+  void runUntil(const std::function<bool()>& condition) {
+    while (!condition()) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+
+  Api::ApiPtr api_ = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher_ = api_->allocateDispatcher("bench_thread");
+  ThreadLocal::InstanceImpl tls_;
+  Singleton::ManagerImpl singleton_manager_;
+  std::shared_ptr<AsyncFileManagerFactory> factory_;
+  std::shared_ptr<AsyncFileManager> manager_;
+  AsyncFileHandle handle_;
+};
+
+void readFile(benchmark::State& state, ManagerType type) {
+  if (type == ManagerType::IoUring && !Io::isIoUringSupported()) {
+    state.SkipWithError("io_uring is not supported");
+    return;
+  }
+  ReadBenchmark bench(type);
+  const size_t length = state.range(0);
+  size_t bytes_read = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    bytes_read += bench.readBatch(length);
+  }
+  state.SetBytesProcessed(bytes_read);
+  state.SetItemsProcessed(state.iterations() * ConcurrentReads);
+}
+
+void threadPoolRead(benchmark::State& state) { readFile(state, ManagerType::ThreadPool); }
+BENCHMARK(threadPoolRead)->Arg(4096)->Arg(65536)->Arg(1024 * 1024)->UseRealTime();
+
+void ioUringRead(benchmark::State& state) { readFile(state, ManagerType::IoUring); }
+BENCHMARK(ioUringRead)->Arg(4096)->Arg(65536)->Arg(1024 * 1024)->UseRealTime();
+
+} // namespace
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
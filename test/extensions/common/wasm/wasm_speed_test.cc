@@ -1,7 +1,12 @@
+#include <unistd.h>
+
+#include <fstream>
+
 #include "source/common/common/thread.h"
 #include "source/common/common/thread_synchronizer.h"
 #include "source/extensions/common/wasm/wasm.h"
 
+#include "test/mocks/local_info/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 #include "test/test_common/environment.h"
@@ -63,6 +68,73 @@ void bmWasmSpeedTest(benchmark::State& state) {
 
 BENCHMARK(bmWasmSpeedTest);
 
+// @return the resident set size of the process, in bytes.
+static int64_t residentSetSize() {
+  std::ifstream statm("/proc/self/statm");
+  int64_t size = 0, resident = 0;
+  statm >> size >> resident;
+  return resident * sysconf(_SC_PAGESIZE);
+}
+
+// Creates and initializes the thread-local copies of a base VM for a number of workers, with
+// (snapshot:1) and without (snapshot:0) restoring them from a memory snapshot of the base VM, and
+// reports the resident memory which each copy adds.
+void bmWasmThreadLocalCopies(benchmark::State& state) {
+  const std::string runtime(Envoy::Extensions::Common::Wasm::getFirstAvailableWasmEngineName());
+  const std::string path = Envoy::TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/common/wasm/test_data/test_cpp.wasm");
+  if (runtime.empty() || !std::ifstream(path).good()) {
+    state.SkipWithError("No Wasm runtime or test module available");
+    return;
+  }
+  Envoy::Logger::Registry::getLog(Envoy::Logger::Id::wasm).set_level(spdlog::level::off);
+  Envoy::Stats::IsolatedStoreImpl stats_store;
+  Envoy::Api::ApiPtr api = Envoy::Api::createApiForTest(stats_store);
+  Envoy::Upstream::MockClusterManager cluster_manager;
+  Envoy::Event::DispatcherPtr dispatcher(api->allocateDispatcher("wasm_test"));
+  auto scope = Envoy::Stats::ScopeSharedPtr(stats_store.createScope("wasm."));
+  testing::NiceMock<Envoy::LocalInfo::MockLocalInfo> local_info;
+
+  envoy::extensions::wasm::v3::PluginConfig plugin_config;
+  plugin_config.mutable_vm_config()->set_runtime(runtime);
+  plugin_config.mutable_vm_config()->set_snapshot_initialized_memory(state.range(0) != 0);
+  auto plugin = std::make_shared<Envoy::Extensions::Common::Wasm::Plugin>(
+      plugin_config, envoy::config::core::v3::TrafficDirection::UNSPECIFIED, local_info, nullptr);
+  const std::string code = Envoy::TestEnvironment::readFileToStringForTest(path);
+  auto wasm = std::make_shared<Envoy::Extensions::Common::Wasm::Wasm>(
+      plugin->wasmConfig(), proxy_wasm::makeVmKey("", "", code), scope, *api, cluster_manager,
+      *dispatcher);
+  RELEASE_ASSERT(wasm->load(code, false) && wasm->initialize(), "");
+  wasm->captureMemorySnapshot(code);
+  auto base_wasm_handle =
+      std::make_shared<Envoy::Extensions::Common::Wasm::WasmHandle>(std::move(wasm));
+
+  constexpr int Workers = 8;
+  int64_t resident_bytes_added = 0;
+  for (__attribute__((unused)) auto _ : state) {
+    std::vector<Envoy::Extensions::Common::Wasm::WasmSharedPtr> copies;
+    const int64_t resident_bytes_before = residentSetSize();
+    for (int i = 0; i < Workers; i++) {
+      copies.push_back(
+          std::make_shared<Envoy::Extensions::Common::Wasm::Wasm>(base_wasm_handle, *dispatcher));
+      RELEASE_ASSERT(copies.back()->initialize(), "");
+    }
+    state.PauseTiming();
+    resident_bytes_added += residentSetSize() - resident_bytes_before;
+    copies.clear();
+    state.ResumeTiming();
+  }
+  state.counters["resident_bytes_per_vm"] =
+      static_cast<double>(resident_bytes_added) / (state.iterations() * Workers);
+  state.SetItemsProcessed(state.iterations() * Workers);
+}
+
+BENCHMARK(bmWasmThreadLocalCopies)
+    ->Arg(0)
+    ->Arg(1)
+    ->ArgNames({"snapshot"})
+    ->Unit(::benchmark::kMillisecond);
+
 } // namespace Envoy
 
 int main(int argc, char** argv) {
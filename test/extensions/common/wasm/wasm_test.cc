@@ -1165,6 +1165,132 @@ TEST_P(WasmCommonTest, ThreadLocalCopyRetainsEnforcement) {
   thread_local_wasm->start(plugin);
 }
 
+class WasmMemorySnapshotTest : public WasmCommonTest {
+public:
+  // Creates a base VM as createWasm() does, marks its memory past anything used by the
+  // initialization, and returns a thread-local copy of it.
+  std::shared_ptr<Wasm> createThreadLocalCopy(bool snapshot_initialized_memory) {
+    auto vm_configuration = "snapshot";
+    envoy::extensions::wasm::v3::PluginConfig plugin_config;
+    *plugin_config.mutable_vm_config()->mutable_runtime() =
+        absl::StrCat("envoy.wasm.runtime.", std::get<0>(GetParam()));
+    plugin_config.mutable_vm_config()->mutable_configuration()->set_value(vm_configuration);
+    plugin_config.mutable_vm_config()->set_snapshot_initialized_memory(
+        snapshot_initialized_memory);
+    const auto code = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/common/wasm/test_data/test_cpp.wasm"));
+    EXPECT_FALSE(code.empty());
+    plugin_ = std::make_shared<Extensions::Common::Wasm::Plugin>(
+        plugin_config, envoy::config::core::v3::TrafficDirection::UNSPECIFIED, local_info_,
+        nullptr);
+    auto vm_key = proxy_wasm::makeVmKey("", vm_configuration, code);
+    auto wasm = std::make_shared<Extensions::Common::Wasm::Wasm>(
+        plugin_->wasmConfig(), vm_key, scope_, *api_, cluster_manager_, *dispatcher_);
+    EXPECT_TRUE(wasm->load(code, false));
+    EXPECT_TRUE(wasm->initialize());
+
+    marker_offset_ = wasm->wasm_vm()->getMemorySize() - marker_.size();
+    EXPECT_TRUE(wasm->wasm_vm()->setMemory(marker_offset_, marker_.size(), marker_.data()));
+    wasm->captureMemorySnapshot(code);
+    captured_snapshot_ = wasm->hasMemorySnapshot();
+
+    base_wasm_handle_ = std::make_shared<Extensions::Common::Wasm::WasmHandle>(std::move(wasm));
+    auto thread_local_wasm = std::make_shared<Wasm>(base_wasm_handle_, *dispatcher_);
+    EXPECT_TRUE(thread_local_wasm->initialize());
+    return thread_local_wasm;
+  }
+
+  bool hasMarker(Wasm& wasm) {
+    auto memory = wasm.wasm_vm()->getMemory(marker_offset_, marker_.size());
+    return memory.has_value() && memory.value() == marker_;
+  }
+
+  const std::string marker_{"initialized"};
+  uint64_t marker_offset_{};
+  bool captured_snapshot_{};
+  PluginSharedPtr plugin_;
+  WasmHandleSharedPtr base_wasm_handle_;
+};
+
+INSTANTIATE_TEST_SUITE_P(Runtimes, WasmMemorySnapshotTest,
+                         Envoy::Extensions::Common::Wasm::sandbox_runtime_and_cpp_values,
+                         Envoy::Extensions::Common::Wasm::wasmTestParamsToString);
+
+TEST_P(WasmMemorySnapshotTest, ThreadLocalCopyIsRestoredFromSnapshot) {
+  auto thread_local_wasm = createThreadLocalCopy(true);
+  EXPECT_TRUE(captured_snapshot_);
+  EXPECT_TRUE(hasMarker(*thread_local_wasm));
+  EXPECT_EQ(thread_local_wasm->wasm_vm()->getMemorySize(),
+            base_wasm_handle_->wasm()->wasm_vm()->getMemorySize());
+
+  // The restored copy runs as usual.
+  thread_local_wasm->setCreateContextForTesting(
+      nullptr, [](Wasm* wasm, const std::shared_ptr<Plugin>& plugin) -> ContextBase* {
+        auto root_context = new TestContext(wasm, plugin);
+        EXPECT_CALL(*root_context, log_(spdlog::level::info, Eq("on_vm_start snapshot")));
+        return root_context;
+      });
+  EXPECT_NE(thread_local_wasm->start(plugin_), nullptr);
+}
+
+TEST_P(WasmMemorySnapshotTest, ThreadLocalCopyIsInitializedWithoutSnapshot) {
+  auto thread_local_wasm = createThreadLocalCopy(false);
+  EXPECT_FALSE(captured_snapshot_);
+  EXPECT_FALSE(hasMarker(*thread_local_wasm));
+}
+
+TEST_P(WasmMemorySnapshotTest, SnapshotsDisabledByRuntime) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.wasm_memory_snapshots", "false"}});
+  auto thread_local_wasm = createThreadLocalCopy(true);
+  EXPECT_FALSE(captured_snapshot_);
+  EXPECT_FALSE(hasMarker(*thread_local_wasm));
+}
+
+// Returns a Wasm module made of the given sections, whose contents are under 128 bytes.
+std::string wasmModule(const std::vector<std::pair<uint8_t, std::string>>& sections) {
+  std::string module("\0asm\x01\0\0\0", 8);
+  for (const auto& [id, contents] : sections) {
+    module.push_back(id);
+    module.push_back(contents.size());
+    module.append(contents);
+  }
+  return module;
+}
+
+TEST(WasmMutableGlobalsTest, OnlyStackPointerIsMutable) {
+  const std::string mutable_i32("\x7f\x01\x41\x80\x80\x04\x0b", 7);
+  const std::string const_i64("\x7e\x00\x42\x2a\x0b", 5);
+  const std::string mutable_f64("\x7c\x01\x44\0\0\0\0\0\0\0\0\x0b", 12);
+  const auto names = [](const std::string& name) {
+    const std::string globals =
+        absl::StrCat(std::string("\x01\x00", 2), std::string(1, name.size()), name);
+    return absl::StrCat("\x04name\x07", std::string(1, globals.size()), globals);
+  };
+
+  EXPECT_TRUE(onlyStackPointerIsMutable(wasmModule({})));
+  EXPECT_TRUE(onlyStackPointerIsMutable(wasmModule({{6, absl::StrCat("\x01", const_i64)}})));
+  // Without names, the only mutable global of an address type is the stack pointer.
+  EXPECT_TRUE(onlyStackPointerIsMutable(
+      wasmModule({{6, absl::StrCat("\x02", const_i64, mutable_i32)}})));
+  EXPECT_FALSE(onlyStackPointerIsMutable(wasmModule({{6, absl::StrCat("\x01", mutable_f64)}})));
+  EXPECT_FALSE(onlyStackPointerIsMutable(
+      wasmModule({{6, absl::StrCat("\x02", mutable_i32, mutable_i32)}})));
+  // With names, the stack pointer is identified by its name.
+  EXPECT_TRUE(onlyStackPointerIsMutable(
+      wasmModule({{6, absl::StrCat("\x01", mutable_i32)}, {0, names("__stack_pointer")}})));
+  EXPECT_FALSE(onlyStackPointerIsMutable(
+      wasmModule({{6, absl::StrCat("\x01", mutable_i32)}, {0, names("counter")}})));
+  // Imported mutable globals are shared with the host.
+  EXPECT_FALSE(onlyStackPointerIsMutable(
+      wasmModule({{2, std::string("\x01\x03" "env\x01g\x03\x7f\x01", 10)}})));
+  EXPECT_TRUE(onlyStackPointerIsMutable(
+      wasmModule({{2, std::string("\x01\x03" "env\x01g\x03\x7f\x00", 10)}})));
+  // Malformed modules.
+  EXPECT_FALSE(onlyStackPointerIsMutable(""));
+  EXPECT_FALSE(onlyStackPointerIsMutable(wasmModule({{6, "\x01\x7f\x01\x41"}})));
+}
+
 class WasmCommonContextTest : public Common::Wasm::WasmHttpFilterTestBase<
                                   testing::TestWithParam<std::tuple<std::string, std::string>>> {
 public:
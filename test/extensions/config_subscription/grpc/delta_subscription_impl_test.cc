@@ -7,6 +7,7 @@
 #include "source/common/config/api_version.h"
 
 #include "test/extensions/config_subscription/grpc/delta_subscription_test_harness.h"
+#include "test/test_common/thread_factory_for_test.h"
 
 namespace Envoy {
 namespace Config {
@@ -167,7 +168,9 @@ TEST_P(DeltaSubscriptionNoGrpcStreamTest, NoGrpcStream) {
       /*xds_config_tracker_=*/XdsConfigTrackerOptRef(),
       /*backoff_strategy_=*/std::move(backoff_strategy),
       /*target_xds_authority_=*/"",
-      /*eds_resources_cache_=*/nullptr};
+      /*eds_resources_cache_=*/nullptr,
+      /*resource_decode_threads_=*/0,
+      /*thread_factory_=*/Thread::threadFactoryForTest()};
   if (GetParam() == LegacyOrUnified::Unified) {
     xds_context = std::make_shared<Config::XdsMux::GrpcMuxDelta>(grpc_mux_context, false);
   } else {
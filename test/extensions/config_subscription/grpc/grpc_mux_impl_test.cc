@@ -30,6 +30,7 @@
 #include "test/test_common/status_utility.h"
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/test_time.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -88,7 +89,9 @@ public:
             SubscriptionFactory::RetryInitialDelayMs, SubscriptionFactory::RetryMaxDelayMs,
             random_),
         /*target_xds_authority_=*/"",
-        /*eds_resources_cache_=*/std::unique_ptr<MockEdsResourcesCache>(eds_resources_cache_)};
+        /*eds_resources_cache_=*/std::unique_ptr<MockEdsResourcesCache>(eds_resources_cache_),
+        /*resource_decode_threads_=*/resource_decode_threads_,
+        /*thread_factory_=*/Thread::threadFactoryForTest()};
     grpc_mux_ = std::make_unique<GrpcMuxImpl>(grpc_mux_context, true);
   }
 
@@ -137,6 +140,7 @@ public:
   Stats::Gauge& control_plane_connected_state_;
   Stats::Gauge& control_plane_pending_requests_;
   MockEdsResourcesCache* eds_resources_cache_{nullptr};
+  uint32_t resource_decode_threads_{0};
 };
 
 class GrpcMuxImplTest : public GrpcMuxImplTestBase {
@@ -673,6 +677,81 @@ TEST_P(GrpcMuxImplTest, WildcardWatch) {
   }
 }
 
+// Validate that resources decoded off the main thread are applied and ACKed in the order in which
+// their responses were received.
+TEST_P(GrpcMuxImplTest, ConcurrentResourceDecoding) {
+  resource_decode_threads_ = 2;
+  setup();
+  ASSERT_NE(nullptr, grpc_mux_->resourceDecodePoolForTest());
+
+  // Completions are posted from the decoding threads; collect them and run them on this thread.
+  absl::Mutex posted_mutex;
+  std::vector<Event::PostCb> posted_callbacks;
+  ON_CALL(dispatcher_, post(_)).WillByDefault(Invoke([&](Event::PostCb callback) {
+    absl::MutexLock lock(&posted_mutex);
+    posted_callbacks.push_back(std::move(callback));
+  }));
+  const auto run_posted_callbacks = [&]() {
+    while (true) {
+      grpc_mux_->resourceDecodePoolForTest()->waitForIdle();
+      std::vector<Event::PostCb> callbacks;
+      {
+        absl::MutexLock lock(&posted_mutex);
+        callbacks.swap(posted_callbacks);
+      }
+      if (callbacks.empty()) {
+        return;
+      }
+      for (auto& callback : callbacks) {
+        callback();
+      }
+    }
+  };
+
+  InSequence s;
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  OpaqueResourceDecoderSharedPtr resource_decoder(
+      std::make_shared<TestUtility::TestOpaqueResourceDecoderImpl<
+          envoy::config::endpoint::v3::ClusterLoadAssignment>>("cluster_name"));
+  auto foo_sub = grpc_mux_->addWatch(type_url, {"x", "y"}, callbacks_, resource_decoder, {});
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {"x", "y"}, "", true);
+  grpc_mux_->start();
+
+  const auto make_response = [&type_url](const std::string& version,
+                                         const std::vector<std::string>& cluster_names) {
+    auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+    response->set_type_url(type_url);
+    response->set_version_info(version);
+    for (const auto& cluster_name : cluster_names) {
+      envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+      load_assignment.set_cluster_name(cluster_name);
+      response->add_resources()->PackFrom(load_assignment);
+    }
+    return response;
+  };
+  // The second response arrives while the resources of the first one are being decoded.
+  grpc_mux_->grpcStreamForTest().onReceiveMessage(make_response("1", {"x"}));
+  grpc_mux_->grpcStreamForTest().onReceiveMessage(make_response("2", {"x", "y"}));
+
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, "1"))
+      .WillOnce(Invoke([](const std::vector<DecodedResourceRef>& resources, const std::string&) {
+        EXPECT_EQ(1, resources.size());
+        EXPECT_EQ("x", resources[0].get().name());
+        return absl::OkStatus();
+      }));
+  expectSendMessage(type_url, {"x", "y"}, "1");
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, "2"))
+      .WillOnce(Invoke([](const std::vector<DecodedResourceRef>& resources, const std::string&) {
+        EXPECT_EQ(2, resources.size());
+        EXPECT_EQ("x", resources[0].get().name());
+        EXPECT_EQ("y", resources[1].get().name());
+        return absl::OkStatus();
+      }));
+  expectSendMessage(type_url, {"x", "y"}, "2");
+  run_posted_callbacks();
+}
+
 // Validate behavior when watches specify resources (potentially overlapping).
 TEST_P(GrpcMuxImplTest, WatchDemux) {
   setup();
@@ -1052,7 +1131,9 @@ TEST_P(GrpcMuxImplTest, BadLocalInfoEmptyClusterName) {
       std::make_unique<JitteredExponentialBackOffStrategy>(
           SubscriptionFactory::RetryInitialDelayMs, SubscriptionFactory::RetryMaxDelayMs, random_),
       /*target_xds_authority_=*/"",
-      /*eds_resources_cache_=*/nullptr};
+      /*eds_resources_cache_=*/nullptr,
+      /*resource_decode_threads_=*/0,
+      /*thread_factory_=*/Thread::threadFactoryForTest()};
   EXPECT_THROW_WITH_MESSAGE(
       GrpcMuxImpl(grpc_mux_context, true), EnvoyException,
       "ads: node 'id' and 'cluster' are required. Set it either in 'node' config or via "
@@ -1078,7 +1159,9 @@ TEST_P(GrpcMuxImplTest, BadLocalInfoEmptyNodeName) {
       std::make_unique<JitteredExponentialBackOffStrategy>(
           SubscriptionFactory::RetryInitialDelayMs, SubscriptionFactory::RetryMaxDelayMs, random_),
       /*target_xds_authority_=*/"",
-      /*eds_resources_cache_=*/nullptr};
+      /*eds_resources_cache_=*/nullptr,
+      /*resource_decode_threads_=*/0,
+      /*thread_factory_=*/Thread::threadFactoryForTest()};
   EXPECT_THROW_WITH_MESSAGE(
       GrpcMuxImpl(grpc_mux_context, true), EnvoyException,
       "ads: node 'id' and 'cluster' are required. Set it either in 'node' config or via "
@@ -1580,6 +1663,7 @@ TEST(GrpcMuxFactoryTest, InvalidRateLimit) {
   auto* factory =
       Config::Utility::getFactoryByName<Config::MuxFactory>("envoy.config_mux.grpc_mux_factory");
   NiceMock<Event::MockDispatcher> dispatcher;
+  Api::ApiPtr api = Api::createApiForTest();
   NiceMock<Random::MockRandomGenerator> random;
   NiceMock<Stats::MockStore> store;
   Stats::MockScope& scope{store.mockScope()};
@@ -1589,7 +1673,7 @@ TEST(GrpcMuxFactoryTest, InvalidRateLimit) {
   ads_config.mutable_rate_limit_settings()->mutable_fill_rate()->set_value(
       std::numeric_limits<double>::quiet_NaN());
   EXPECT_THROW(factory->create(std::make_unique<Grpc::MockAsyncClient>(), nullptr, dispatcher,
-                               random, scope, ads_config, local_info, nullptr, nullptr,
+                               *api, random, scope, ads_config, local_info, nullptr, nullptr,
                                absl::nullopt, absl::nullopt, false),
                EnvoyException);
 }
@@ -4,6 +4,7 @@
 #include "envoy/config/endpoint/v3/endpoint.pb.h"
 #include "envoy/config/endpoint/v3/endpoint.pb.validate.h"
 #include "envoy/config/xds_config_tracker.h"
+#include "envoy/config/xds_resources_delegate.h"
 #include "envoy/event/timer.h"
 #include "envoy/service/discovery/v3/discovery.pb.h"
 
@@ -13,6 +14,7 @@
 #include "source/common/protobuf/protobuf.h"
 #include "source/extensions/config_subscription/grpc/new_grpc_mux_impl.h"
 #include "source/extensions/config_subscription/grpc/xds_mux/grpc_mux_impl.h"
+#include "source/extensions/config_subscription/grpc/xds_source_id.h"
 
 #include "test/common/stats/stat_test_utility.h"
 #include "test/config/v2_link_hacks.h"
@@ -31,6 +33,7 @@
 #include "test/test_common/status_utility.h"
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/test_time.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -50,6 +53,24 @@ namespace {
 
 enum class LegacyOrUnified { Legacy, Unified };
 
+class MockXdsResourcesDelegate : public XdsResourcesDelegate {
+public:
+  MOCK_METHOD(std::vector<envoy::service::discovery::v3::Resource>, getResources,
+              (const XdsSourceId& source_id,
+               const absl::flat_hash_set<std::string>& resource_names),
+              (const));
+  MOCK_METHOD(void, onConfigUpdated,
+              (const XdsSourceId& source_id, const std::vector<DecodedResourceRef>& resources));
+  MOCK_METHOD(void, onDeltaConfigUpdated,
+              (const XdsSourceId& source_id,
+               const Protobuf::RepeatedPtrField<envoy::service::discovery::v3::Resource>&
+                   added_resources,
+               const Protobuf::RepeatedPtrField<std::string>& removed_resources));
+  MOCK_METHOD(void, onResourceLoadFailed,
+              (const XdsSourceId& source_id, const std::string& resource_name,
+               const absl::optional<EnvoyException>& exception));
+};
+
 // We test some mux specific stuff below, other unit test coverage for singleton use of
 // NewGrpcMuxImpl is provided in [grpc_]subscription_impl_test.cc.
 class NewGrpcMuxImplTestBase : public testing::TestWithParam<std::tuple<LegacyOrUnified, bool>> {
@@ -84,11 +105,13 @@ public:
         /*rate_limit_settings_=*/rate_limit_settings_,
         /*scope_=*/*stats_.rootScope(),
         /*config_validators_=*/std::move(config_validators_),
-        /*xds_resources_delegate_=*/XdsResourcesDelegateOptRef(),
+        /*xds_resources_delegate_=*/xds_resources_delegate_,
         /*xds_config_tracker_=*/XdsConfigTrackerOptRef(),
         /*backoff_strategy_=*/std::move(backoff_strategy),
         /*target_xds_authority_=*/"",
-        /*eds_resources_cache_=*/std::unique_ptr<MockEdsResourcesCache>(eds_resources_cache_)};
+        /*eds_resources_cache_=*/std::unique_ptr<MockEdsResourcesCache>(eds_resources_cache_),
+        /*resource_decode_threads_=*/0,
+        /*thread_factory_=*/Thread::threadFactoryForTest()};
     if (isUnifiedMuxTest()) {
       grpc_mux_ = std::make_unique<XdsMux::GrpcMuxDelta>(grpc_mux_context, false);
       return;
@@ -193,6 +216,7 @@ public:
   Stats::Gauge& control_plane_connected_state_;
   bool should_use_unified_;
   MockEdsResourcesCache* eds_resources_cache_{nullptr};
+  XdsResourcesDelegateOptRef xds_resources_delegate_;
   const bool using_xds_failover_;
 };
 
@@ -423,6 +447,105 @@ TEST_P(NewGrpcMuxImplTest, DiscoveryResponseNonexistentSub) {
   }
 }
 
+// Resources persisted by the xDS resources delegate are applied before the first request is sent,
+// which carries their versions, and accepted updates are handed to the delegate.
+TEST_P(NewGrpcMuxImplTest, LoadPersistedResources) {
+  if (isUnifiedMuxTest()) {
+    // The unified mux does not load persisted resources.
+    return;
+  }
+  NiceMock<MockXdsResourcesDelegate> xds_resources_delegate;
+  xds_resources_delegate_ = xds_resources_delegate;
+  auto* delegate_load_cb = new NiceMock<Event::MockSchedulableCallback>(&dispatcher_);
+  setup();
+
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  std::vector<envoy::service::discovery::v3::Resource> persisted_resources;
+  for (const std::string name : {"x", "y"}) {
+    envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+    load_assignment.set_cluster_name(name);
+    auto& resource = persisted_resources.emplace_back();
+    resource.set_name(name);
+    resource.set_version("1");
+    resource.mutable_resource()->PackFrom(load_assignment);
+  }
+  EXPECT_CALL(xds_resources_delegate, getResources(_, _))
+      .WillOnce(Invoke([&](const XdsSourceId& source_id, const absl::flat_hash_set<std::string>&) {
+        EXPECT_EQ(XdsConfigSourceId("", type_url).toKey(), source_id.toKey());
+        return persisted_resources;
+      }));
+
+  auto watch = grpc_mux_->addWatch(type_url, {"x", "y"}, callbacks_, resource_decoder_, {});
+  EXPECT_TRUE(delegate_load_cb->enabled());
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, _, _))
+      .WillOnce(Invoke([](const std::vector<DecodedResourceRef>& added_resources,
+                          const Protobuf::RepeatedPtrField<std::string>&, const std::string&) {
+        EXPECT_EQ(2, added_resources.size());
+        return absl::OkStatus();
+      }));
+  delegate_load_cb->invokeCallback();
+
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {"x", "y"}, {}, "", Grpc::Status::WellKnownGrpcStatus::Ok, "",
+                    {{"x", "1"}, {"y", "1"}});
+  grpc_mux_->start();
+
+  auto response = std::make_unique<envoy::service::discovery::v3::DeltaDiscoveryResponse>();
+  response->set_type_url(type_url);
+  response->set_system_version_info("2");
+  response->set_nonce("nonce");
+  envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+  load_assignment.set_cluster_name("x");
+  auto* resource = response->add_resources();
+  resource->set_name("x");
+  resource->set_version("2");
+  resource->mutable_resource()->PackFrom(load_assignment);
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, _, "2"));
+  EXPECT_CALL(xds_resources_delegate, onDeltaConfigUpdated(_, _, _))
+      .WillOnce(Invoke(
+          [](const XdsSourceId&,
+             const Protobuf::RepeatedPtrField<envoy::service::discovery::v3::Resource>& added,
+             const Protobuf::RepeatedPtrField<std::string>& removed) {
+            ASSERT_EQ(1, added.size());
+            EXPECT_EQ("2", added[0].version());
+            EXPECT_TRUE(removed.empty());
+          }));
+  expectSendMessage(type_url, {}, {}, "nonce");
+  onDiscoveryResponse(std::move(response));
+
+  expectSendMessage(type_url, {}, {"x", "y"});
+}
+
+// Persisted resources that are rejected are reported to the xDS resources delegate, and their
+// versions are not sent to the management server.
+TEST_P(NewGrpcMuxImplTest, RejectedPersistedResources) {
+  if (isUnifiedMuxTest()) {
+    // The unified mux does not load persisted resources.
+    return;
+  }
+  NiceMock<MockXdsResourcesDelegate> xds_resources_delegate;
+  xds_resources_delegate_ = xds_resources_delegate;
+  new NiceMock<Event::MockSchedulableCallback>(&dispatcher_);
+  setup();
+
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  std::vector<envoy::service::discovery::v3::Resource> persisted_resources(1);
+  persisted_resources[0].set_name("x");
+  persisted_resources[0].set_version("1");
+  // The type of the resource does not match the type of the subscription.
+  persisted_resources[0].mutable_resource()->PackFrom(envoy::config::route::v3::VirtualHost());
+  EXPECT_CALL(xds_resources_delegate, getResources(_, _)).WillOnce(Return(persisted_resources));
+  EXPECT_CALL(xds_resources_delegate, onResourceLoadFailed(_, "x", _));
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, _, _)).Times(0);
+
+  auto watch = grpc_mux_->addWatch(type_url, {"x"}, callbacks_, resource_decoder_, {});
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {"x"}, {});
+  grpc_mux_->start();
+
+  expectSendMessage(type_url, {}, {"x"});
+}
+
 // DeltaDiscoveryResponse that comes in response to an on-demand request updates the watch with
 // resource's name. The watch is initially created with an alias used in the on-demand request.
 TEST_P(NewGrpcMuxImplTest, ConfigUpdateWithAliases) {
@@ -971,6 +1094,7 @@ TEST(NewGrpcMuxFactoryTest, InvalidRateLimit) {
   auto* factory = Config::Utility::getFactoryByName<Config::MuxFactory>(
       "envoy.config_mux.new_grpc_mux_factory");
   NiceMock<Event::MockDispatcher> dispatcher;
+  Api::ApiPtr api = Api::createApiForTest();
   NiceMock<Random::MockRandomGenerator> random;
   NiceMock<Stats::MockStore> store;
   Stats::MockScope& scope{store.mockScope()};
@@ -980,7 +1104,7 @@ TEST(NewGrpcMuxFactoryTest, InvalidRateLimit) {
   ads_config.mutable_rate_limit_settings()->mutable_fill_rate()->set_value(
       std::numeric_limits<double>::quiet_NaN());
   EXPECT_THROW(factory->create(std::make_unique<Grpc::MockAsyncClient>(), nullptr, dispatcher,
-                               random, scope, ads_config, local_info, nullptr, nullptr,
+                               *api, random, scope, ads_config, local_info, nullptr, nullptr,
                                absl::nullopt, absl::nullopt, false),
                EnvoyException);
 }
@@ -0,0 +1,144 @@
+#include "envoy/config/endpoint/v3/endpoint.pb.h"
+#include "envoy/service/discovery/v3/discovery.pb.h"
+
+#include "source/common/config/opaque_resource_decoder_impl.h"
+#include "source/extensions/config_subscription/grpc/resource_decode_pool.h"
+
+#include "test/test_common/resources.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Config {
+namespace {
+
+using ClusterLoadAssignment = envoy::config::endpoint::v3::ClusterLoadAssignment;
+
+class ResourceDecodePoolTest : public testing::TestWithParam<uint32_t> {
+public:
+  ResourceDecodePoolTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")),
+        pool_(api_->threadFactory(), GetParam()) {}
+
+  std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>
+  makeResponse(uint32_t num_resources) {
+    auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+    response->set_type_url(Config::TypeUrl::get().ClusterLoadAssignment);
+    response->set_version_info("1");
+    for (uint32_t i = 0; i < num_resources; ++i) {
+      ClusterLoadAssignment load_assignment;
+      load_assignment.set_cluster_name(absl::StrCat("cluster_", i));
+      response->add_resources()->PackFrom(load_assignment);
+    }
+    return response;
+  }
+
+  // Decodes the response and runs the dispatcher until the completion callback was invoked.
+  absl::StatusOr<std::vector<DecodedResourcePtr>>
+  decode(std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& response) {
+    absl::StatusOr<std::vector<DecodedResourcePtr>> result;
+    bool done = false;
+    pool_.decode(*dispatcher_, resource_decoder_, std::move(response),
+                 [&](std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& message,
+                     absl::StatusOr<std::vector<DecodedResourcePtr>>&& resources_or_error) {
+                   EXPECT_NE(nullptr, message);
+                   result = std::move(resources_or_error);
+                   done = true;
+                 });
+    pool_.waitForIdle();
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    EXPECT_TRUE(done);
+    return result;
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  OpaqueResourceDecoderSharedPtr resource_decoder_{
+      std::make_shared<TestUtility::TestOpaqueResourceDecoderImpl<ClusterLoadAssignment>>(
+          "cluster_name")};
+  ResourceDecodePool pool_;
+};
+
+INSTANTIATE_TEST_SUITE_P(Concurrency, ResourceDecodePoolTest, testing::Values(1, 3, 8));
+
+// Resources are handed back in the order in which they appear in the response.
+TEST_P(ResourceDecodePoolTest, PreservesOrder) {
+  for (uint32_t num_resources : {1, 7, 100}) {
+    auto resources_or_error = decode(makeResponse(num_resources));
+    ASSERT_TRUE(resources_or_error.ok());
+    ASSERT_EQ(num_resources, resources_or_error->size());
+    for (uint32_t i = 0; i < num_resources; ++i) {
+      const auto& resource = (*resources_or_error)[i];
+      EXPECT_EQ(absl::StrCat("cluster_", i), resource->name());
+      EXPECT_EQ("1", resource->version());
+      EXPECT_EQ(absl::StrCat("cluster_", i),
+                dynamic_cast<const ClusterLoadAssignment&>(resource->resource()).cluster_name());
+    }
+  }
+}
+
+// A response without resources completes with an empty list.
+TEST_P(ResourceDecodePoolTest, EmptyResponse) {
+  auto resources_or_error = decode(makeResponse(0));
+  ASSERT_TRUE(resources_or_error.ok());
+  EXPECT_TRUE(resources_or_error->empty());
+}
+
+// Resources wrapped in a Resource message keep their name, TTL and removal state.
+TEST_P(ResourceDecodePoolTest, WrappedResources) {
+  auto response = makeResponse(0);
+  envoy::service::discovery::v3::Resource wrapped;
+  wrapped.set_name("wrapped");
+  wrapped.mutable_ttl()->set_seconds(1);
+  ClusterLoadAssignment load_assignment;
+  load_assignment.set_cluster_name("wrapped");
+  wrapped.mutable_resource()->PackFrom(load_assignment);
+  response->add_resources()->PackFrom(wrapped);
+  envoy::service::discovery::v3::Resource heartbeat;
+  heartbeat.set_name("heartbeat");
+  response->add_resources()->PackFrom(heartbeat);
+
+  auto resources_or_error = decode(std::move(response));
+  ASSERT_TRUE(resources_or_error.ok());
+  ASSERT_EQ(2, resources_or_error->size());
+  EXPECT_EQ("wrapped", (*resources_or_error)[0]->name());
+  EXPECT_TRUE((*resources_or_error)[0]->hasResource());
+  EXPECT_EQ(std::chrono::milliseconds(1000), (*resources_or_error)[0]->ttl());
+  EXPECT_EQ("heartbeat", (*resources_or_error)[1]->name());
+  EXPECT_FALSE((*resources_or_error)[1]->hasResource());
+}
+
+// The error of the first invalid resource, in response order, is reported.
+TEST_P(ResourceDecodePoolTest, ReportsFirstError) {
+  auto response = makeResponse(50);
+  for (int i : {10, 40}) {
+    ClusterLoadAssignment load_assignment;
+    load_assignment.set_cluster_name(absl::StrCat("invalid_", i));
+    // A zero overprovisioning factor violates the proto constraints.
+    load_assignment.mutable_policy()->mutable_overprovisioning_factor()->set_value(0);
+    response->mutable_resources(i)->PackFrom(load_assignment);
+  }
+
+  auto resources_or_error = decode(std::move(response));
+  ASSERT_FALSE(resources_or_error.ok());
+  EXPECT_THAT(std::string(resources_or_error.status().message()),
+              testing::HasSubstr("invalid_10"));
+}
+
+// Completions of a destroyed pool are dropped.
+TEST_P(ResourceDecodePoolTest, DestroyedPool) {
+  auto pool = std::make_unique<ResourceDecodePool>(api_->threadFactory(), GetParam());
+  bool done = false;
+  pool->decode(*dispatcher_, resource_decoder_, makeResponse(10),
+               [&](std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&&,
+                   absl::StatusOr<std::vector<DecodedResourcePtr>>&&) { done = true; });
+  pool->waitForIdle();
+  pool.reset();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_FALSE(done);
+}
+
+} // namespace
+} // namespace Config
+} // namespace Envoy
@@ -29,6 +29,7 @@
 #include "test/test_common/status_utility.h"
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/test_time.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -87,7 +88,9 @@ public:
             SubscriptionFactory::RetryInitialDelayMs, SubscriptionFactory::RetryMaxDelayMs,
             random_),
         /*target_xds_authority_=*/"",
-        /*eds_resources_cache_=*/std::unique_ptr<MockEdsResourcesCache>(eds_resources_cache_)};
+        /*eds_resources_cache_=*/std::unique_ptr<MockEdsResourcesCache>(eds_resources_cache_),
+        /*resource_decode_threads_=*/0,
+        /*thread_factory_=*/Thread::threadFactoryForTest()};
     grpc_mux_ = std::make_unique<XdsMux::GrpcMuxSotw>(grpc_mux_context, true);
   }
 
@@ -944,7 +947,9 @@ TEST_P(GrpcMuxImplTest, BadLocalInfoEmptyClusterName) {
       std::make_unique<JitteredExponentialBackOffStrategy>(
           SubscriptionFactory::RetryInitialDelayMs, SubscriptionFactory::RetryMaxDelayMs, random_),
       /*target_xds_authority_=*/"",
-      /*eds_resources_cache_=*/nullptr};
+      /*eds_resources_cache_=*/nullptr,
+      /*resource_decode_threads_=*/0,
+      /*thread_factory_=*/Thread::threadFactoryForTest()};
   EXPECT_THROW_WITH_MESSAGE(
       XdsMux::GrpcMuxSotw(grpc_mux_context, true), EnvoyException,
       "ads: node 'id' and 'cluster' are required. Set it either in 'node' config or via "
@@ -970,7 +975,9 @@ TEST_P(GrpcMuxImplTest, BadLocalInfoEmptyNodeName) {
       std::make_unique<JitteredExponentialBackOffStrategy>(
           SubscriptionFactory::RetryInitialDelayMs, SubscriptionFactory::RetryMaxDelayMs, random_),
       /*target_xds_authority_=*/"",
-      /*eds_resources_cache_=*/nullptr};
+      /*eds_resources_cache_=*/nullptr,
+      /*resource_decode_threads_=*/0,
+      /*thread_factory_=*/Thread::threadFactoryForTest()};
   EXPECT_THROW_WITH_MESSAGE(
       XdsMux::GrpcMuxSotw(grpc_mux_context, true), EnvoyException,
       "ads: node 'id' and 'cluster' are required. Set it either in 'node' config or via "
@@ -1097,7 +1104,9 @@ TEST_P(GrpcMuxImplTest, AllMuxesStateTest) {
       std::make_unique<JitteredExponentialBackOffStrategy>(
           SubscriptionFactory::RetryInitialDelayMs, SubscriptionFactory::RetryMaxDelayMs, random_),
       /*target_xds_authority_=*/"",
-      /*eds_resources_cache_=*/nullptr};
+      /*eds_resources_cache_=*/nullptr,
+      /*resource_decode_threads_=*/0,
+      /*thread_factory_=*/Thread::threadFactoryForTest()};
   auto grpc_mux_1 = std::make_unique<XdsMux::GrpcMuxSotw>(grpc_mux_context, true);
   Config::XdsMux::GrpcMuxSotw::shutdownAll();
 
@@ -1484,6 +1493,7 @@ TEST(UnifiedSotwGrpcMuxFactoryTest, InvalidRateLimit) {
   auto* factory = Config::Utility::getFactoryByName<Config::MuxFactory>(
       "envoy.config_mux.sotw_grpc_mux_factory");
   NiceMock<Event::MockDispatcher> dispatcher;
+  Api::ApiPtr api = Api::createApiForTest();
   NiceMock<Random::MockRandomGenerator> random;
   NiceMock<Stats::MockStore> store;
   Stats::MockScope& scope{store.mockScope()};
@@ -1493,7 +1503,7 @@ TEST(UnifiedSotwGrpcMuxFactoryTest, InvalidRateLimit) {
   ads_config.mutable_rate_limit_settings()->mutable_fill_rate()->set_value(
       std::numeric_limits<double>::quiet_NaN());
   EXPECT_THROW(factory->create(std::make_unique<Grpc::MockAsyncClient>(), nullptr, dispatcher,
-                               random, scope, ads_config, local_info, nullptr, nullptr,
+                               *api, random, scope, ads_config, local_info, nullptr, nullptr,
                                absl::nullopt, absl::nullopt, false),
                EnvoyException);
 }
@@ -1502,6 +1512,7 @@ TEST(UnifiedDeltaGrpcMuxFactoryTest, InvalidRateLimit) {
   auto* factory = Config::Utility::getFactoryByName<Config::MuxFactory>(
       "envoy.config_mux.delta_grpc_mux_factory");
   NiceMock<Event::MockDispatcher> dispatcher;
+  Api::ApiPtr api = Api::createApiForTest();
   NiceMock<Random::MockRandomGenerator> random;
   NiceMock<Stats::MockStore> store;
   Stats::MockScope& scope{store.mockScope()};
@@ -1511,7 +1522,7 @@ TEST(UnifiedDeltaGrpcMuxFactoryTest, InvalidRateLimit) {
   ads_config.mutable_rate_limit_settings()->mutable_fill_rate()->set_value(
       std::numeric_limits<double>::quiet_NaN());
   EXPECT_THROW(factory->create(std::make_unique<Grpc::MockAsyncClient>(), nullptr, dispatcher,
-                               random, scope, ads_config, local_info, nullptr, nullptr,
+                               *api, random, scope, ads_config, local_info, nullptr, nullptr,
                                absl::nullopt, absl::nullopt, false),
                EnvoyException);
 }
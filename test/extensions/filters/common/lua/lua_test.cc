@@ -178,6 +178,82 @@ TEST_F(LuaTest, MarkDead) {
   lua_gc(cr1->luaState(), LUA_GCCOLLECT, 0);
 }
 
+// The thread of a coroutine which finished without an error is reused by the next coroutine.
+TEST_F(LuaTest, FinishedCoroutineIsReused) {
+  const std::string SCRIPT{R"EOF(
+    function callMe(object)
+      object:testCall()
+      return "result"
+    end
+
+    function failMe()
+      error("failed")
+    end
+  )EOF"};
+
+  InSequence s;
+  setup(SCRIPT);
+  const int call_me_ref = state_->getGlobalRef(state_->registerGlobal("callMe", initializers_));
+  const int fail_me_ref = state_->getGlobalRef(state_->registerGlobal("failMe", initializers_));
+
+  CoroutinePtr cr1(state_->createCoroutine());
+  lua_State* thread = cr1->luaState();
+  LuaRef<TestObject> ref1(TestObject::create(cr1->luaState()), true);
+  EXPECT_CALL(*ref1.get(), doTestCall(_));
+  cr1->start(call_me_ref, 1, yield_callback_);
+  EXPECT_EQ(cr1->state(), Coroutine::State::Finished);
+  cr1.reset();
+
+  CoroutinePtr cr2(state_->createCoroutine());
+  EXPECT_EQ(cr2->luaState(), thread);
+  EXPECT_EQ(cr2->state(), Coroutine::State::NotStarted);
+  EXPECT_EQ(lua_gettop(cr2->luaState()), 0);
+  LuaRef<TestObject> ref2(TestObject::create(cr2->luaState()), true);
+  EXPECT_CALL(*ref2.get(), doTestCall(_));
+  cr2->start(call_me_ref, 1, yield_callback_);
+  EXPECT_EQ(cr2->state(), Coroutine::State::Finished);
+  EXPECT_STREQ(lua_tostring(cr2->luaState(), -1), "result");
+  cr2.reset();
+
+  // The thread of a coroutine which failed is not reused.
+  CoroutinePtr cr3(state_->createCoroutine());
+  EXPECT_EQ(cr3->luaState(), thread);
+  EXPECT_THROW_WITH_REGEX(cr3->start(fail_me_ref, 0, yield_callback_), LuaException, "failed");
+  cr3.reset();
+  CoroutinePtr cr4(state_->createCoroutine());
+  EXPECT_NE(cr4->luaState(), thread);
+
+  EXPECT_CALL(*ref1.get(), onDestroy());
+  ref1.reset();
+  lua_gc(cr4->luaState(), LUA_GCCOLLECT, 0);
+  EXPECT_CALL(*ref2.get(), onDestroy());
+  ref2.reset();
+  lua_gc(cr4->luaState(), LUA_GCCOLLECT, 0);
+}
+
+// A coroutine destroyed while it is yielded is not reused.
+TEST_F(LuaTest, YieldedCoroutineIsNotReused) {
+  const std::string SCRIPT{R"EOF(
+    function callMe()
+      coroutine.yield()
+    end
+  )EOF"};
+
+  InSequence s;
+  setup(SCRIPT);
+  const int call_me_ref = state_->getGlobalRef(state_->registerGlobal("callMe", initializers_));
+
+  CoroutinePtr cr1(state_->createCoroutine());
+  lua_State* thread = cr1->luaState();
+  EXPECT_CALL(on_yield_, ready());
+  cr1->start(call_me_ref, 0, yield_callback_);
+  EXPECT_EQ(cr1->state(), Coroutine::State::Yielded);
+  cr1.reset();
+
+  CoroutinePtr cr2(state_->createCoroutine());
+  EXPECT_NE(cr2->luaState(), thread);
+}
+
 class ThreadSafeTest : public testing::Test {
 public:
   ThreadSafeTest()
@@ -0,0 +1,158 @@
+#include <string>
+#include <vector>
+
+#include "source/common/common/perf_annotation.h"
+
+#include "test/integration/http_integration.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/network_utility.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+static const int DefaultTestIterations = 20;
+static const int DefaultConcurrentRequests = 50;
+
+/*
+ * This file contains tests that may be used to measure the effect of request collapsing in the
+ * cache filter. Each iteration sends a burst of concurrent requests for a resource which isn't
+ * cached to a slow origin, played by a fake upstream which only responds once all the requests
+ * which will reach it have arrived. Without collapsing, each request of the burst is sent to the
+ * origin; with it, only the first one is.
+ *
+ * To run, build the test with the bazel flag:
+ *
+ *    --define perf_annotation=enabled
+ *
+ * When built with this flag, the test will print out benchmark results
+ * when it exits.
+ *
+ * The environment variables CACHE_COLLAPSING_BENCHMARK_ITERATIONS and
+ * CACHE_COLLAPSING_BENCHMARK_CONCURRENCY override the number of bursts, and the number of
+ * requests in each burst.
+ */
+class CacheCollapsingBenchmarkTest : public HttpIntegrationTest, public testing::Test {
+protected:
+  CacheCollapsingBenchmarkTest() : HttpIntegrationTest(Http::CodecType::HTTP2, getIpVersion()) {}
+
+  static Network::Address::IpVersion getIpVersion() {
+    return Network::Test::supportsIpVersion(Network::Address::IpVersion::v4)
+               ? Network::Address::IpVersion::v4
+               : Network::Address::IpVersion::v6;
+  }
+
+  static void TearDownTestSuite() { PERF_DUMP(); }
+
+  void TearDown() override { cleanupUpstreamAndDownstream(); }
+
+  void initializeFilter(bool collapse) {
+    config_helper_.prependFilter(absl::StrCat(R"EOF(
+    name: "envoy.filters.http.cache"
+    typed_config:
+        "@type": "type.googleapis.com/envoy.extensions.filters.http.cache.v3.CacheConfig"
+        typed_config:
+           "@type": "type.googleapis.com/envoy.extensions.http.cache.simple_http_cache.v3.SimpleHttpCacheConfig"
+    )EOF",
+                                              collapse ? R"EOF(
+        request_collapsing: {}
+    )EOF"
+                                                       : ""));
+    setUpstreamProtocol(Http::CodecType::HTTP2);
+    setDownstreamProtocol(Http::CodecType::HTTP2);
+    initialize();
+  }
+
+  static int getEnvOrDefault(const std::string& name, int default_value) {
+    const auto env_value = TestEnvironment::getOptionalEnvVar(name);
+    int value;
+    if (env_value && absl::SimpleAtoi(*env_value, &value)) {
+      return value;
+    }
+    return default_value;
+  }
+
+  void measureBursts(absl::string_view test_name, bool collapse) {
+    // The PERF_RECORD macro is weird and we need to use this variable for something
+    // else or we will fail to compile.
+    EXPECT_FALSE(test_name.empty());
+    const int iterations =
+        getEnvOrDefault("CACHE_COLLAPSING_BENCHMARK_ITERATIONS", DefaultTestIterations);
+    const int concurrency =
+        getEnvOrDefault("CACHE_COLLAPSING_BENCHMARK_CONCURRENCY", DefaultConcurrentRequests);
+    const std::string response_body(16 * 1024, 'a');
+    const Http::TestResponseHeaderMapImpl response_headers{
+        {":status", "200"},
+        {"cache-control", "public,max-age=3600"},
+        {"content-length", std::to_string(response_body.size())}};
+    initializeFilter(collapse);
+
+    for (int iteration = 0; iteration < iterations; iteration++) {
+      const Http::TestRequestHeaderMapImpl request_headers{
+          {":method", "GET"},
+          {":path", absl::StrCat("/burst/", iteration)},
+          {":scheme", "http"},
+          {":authority", "origin"}};
+      codec_client_ = makeHttpConnection(lookupPort("http"));
+
+      PERF_OPERATION(op);
+      std::vector<IntegrationStreamDecoderPtr> responses;
+      std::vector<FakeStreamPtr> upstream_requests;
+      responses.push_back(codec_client_->makeHeaderOnlyRequest(request_headers));
+      waitForNextUpstreamRequest();
+      upstream_requests.push_back(std::move(upstream_request_));
+      for (int i = 1; i < concurrency; i++) {
+        responses.push_back(codec_client_->makeHeaderOnlyRequest(request_headers));
+      }
+      // The origin is slow: it only responds once the whole burst has been handled by Envoy.
+      if (collapse) {
+        test_server_->waitForCounterEq("http.config_test.cache.collapsed_follower",
+                                       (iteration + 1) * (concurrency - 1));
+      } else {
+        for (int i = 1; i < concurrency; i++) {
+          FakeStreamPtr upstream_request;
+          ASSERT_TRUE(fake_upstream_connection_->waitForNewStream(*dispatcher_, upstream_request));
+          upstream_requests.push_back(std::move(upstream_request));
+        }
+      }
+      for (FakeStreamPtr& upstream_request : upstream_requests) {
+        ASSERT_TRUE(upstream_request->waitForEndStream(*dispatcher_));
+        upstream_request->encodeHeaders(response_headers, false);
+        upstream_request->encodeData(response_body, true);
+      }
+      for (IntegrationStreamDecoderPtr& response : responses) {
+        ASSERT_TRUE(response->waitForEndStream());
+        EXPECT_TRUE(response->complete());
+        EXPECT_EQ(response->body().size(), response_body.size());
+      }
+      PERF_RECORD(op, "benchmark", test_name);
+
+      codec_client_->close();
+    }
+
+    EXPECT_EQ(test_server_->counter("cluster.cluster_0.upstream_rq_total")->value(),
+              collapse ? iterations : iterations * concurrency);
+  }
+};
+
+TEST_F(CacheCollapsingBenchmarkTest, BurstOfMissesWithoutCollapsing) {
+  measureBursts("burst-without-collapsing", false);
+}
+
+TEST_F(CacheCollapsingBenchmarkTest, BurstOfMissesWithCollapsing) {
+  measureBursts("burst-with-collapsing", true);
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
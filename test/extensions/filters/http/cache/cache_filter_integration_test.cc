@@ -109,6 +109,30 @@ public:
         typed_config:
            "@type": "type.googleapis.com/envoy.extensions.http.cache.simple_http_cache.v3.SimpleHttpCacheConfig"
     )EOF"};
+  std::string requestCollapsingConfig(const std::string& timeout = "5s") {
+    return fmt::format(R"EOF(
+    name: "envoy.filters.http.cache"
+    typed_config:
+        "@type": "type.googleapis.com/envoy.extensions.filters.http.cache.v3.CacheConfig"
+        request_collapsing:
+          timeout: {}
+        typed_config:
+           "@type": "type.googleapis.com/envoy.extensions.http.cache.simple_http_cache.v3.SimpleHttpCacheConfig"
+    )EOF",
+                       timeout);
+  }
+
+  // Sends a request on a connection of its own, and waits for it to be collapsed into the
+  // request being sent upstream.
+  IntegrationStreamDecoderPtr
+  sendCollapsedRequest(const Http::TestRequestHeaderMapImpl& headers, uint64_t followers,
+                       IntegrationCodecClientPtr& codec_client) {
+    codec_client = makeHttpConnection(makeClientConnection((lookupPort("http"))));
+    IntegrationStreamDecoderPtr response_decoder = codec_client->makeHeaderOnlyRequest(headers);
+    test_server_->waitForCounterEq("http.config_test.cache.collapsed_follower", followers);
+    return response_decoder;
+  }
+
   DateFormatter formatter_{"%a, %d %b %Y %H:%M:%S GMT"};
   OptRef<const std::string> empty_body_;
   OptRef<const Http::TestResponseTrailerMapImpl> empty_trailers_;
@@ -607,6 +631,132 @@ TEST_P(CacheIntegrationTest, ServeGetFollowedByHead200WithValidation) {
   }
 }
 
+TEST_P(CacheIntegrationTest, CollapsedRequestsShareUpstreamRequest) {
+  initializeFilter(requestCollapsingConfig());
+  const Http::TestRequestHeaderMapImpl request_headers =
+      httpRequestHeader("GET", /*authority=*/"CollapsedRequestsShareUpstreamRequest");
+  const std::string response_body(42, 'a');
+  Http::TestResponseHeaderMapImpl response_headers = httpResponseHeadersForBody(response_body);
+
+  IntegrationStreamDecoderPtr leader = codec_client_->makeHeaderOnlyRequest(request_headers);
+  waitForNextUpstreamRequest();
+  IntegrationCodecClientPtr follower_client_1;
+  IntegrationStreamDecoderPtr follower_1 =
+      sendCollapsedRequest(request_headers, 1, follower_client_1);
+  IntegrationCodecClientPtr follower_client_2;
+  IntegrationStreamDecoderPtr follower_2 =
+      sendCollapsedRequest(request_headers, 2, follower_client_2);
+  test_server_->waitForGaugeEq("http.config_test.cache.collapsed_waiting", 2);
+
+  upstream_request_->encodeHeaders(response_headers, /*end_stream=*/false);
+  upstream_request_->encodeData(response_body.substr(0, 20), /*end_stream=*/false);
+  upstream_request_->encodeData(response_body.substr(20), /*end_stream=*/true);
+
+  for (IntegrationStreamDecoder* response : {leader.get(), follower_1.get(), follower_2.get()}) {
+    ASSERT_TRUE(response->waitForEndStream());
+    EXPECT_TRUE(response->complete());
+    EXPECT_THAT(response->headers(), IsSupersetOfHeaders(response_headers));
+    EXPECT_EQ(response->body(), response_body);
+  }
+  EXPECT_EQ(test_server_->counter("cluster.cluster_0.upstream_rq_total")->value(), 1);
+  EXPECT_EQ(test_server_->counter("http.config_test.cache.collapsed_leader")->value(), 1);
+  EXPECT_EQ(test_server_->counter("http.config_test.cache.collapsed_served")->value(), 2);
+  test_server_->waitForGaugeEq("http.config_test.cache.collapsed_waiting", 0);
+  follower_client_1->close();
+  follower_client_2->close();
+}
+
+TEST_P(CacheIntegrationTest, CollapsedRequestSentUpstreamForUncacheableResponse) {
+  initializeFilter(requestCollapsingConfig());
+  const Http::TestRequestHeaderMapImpl request_headers =
+      httpRequestHeader("GET", /*authority=*/"CollapsedRequestSentUpstreamForUncacheableResponse");
+  const std::string response_body(42, 'a');
+  Http::TestResponseHeaderMapImpl response_headers =
+      httpResponseHeadersForBody(response_body, /*cache_control=*/"no-store");
+
+  IntegrationStreamDecoderPtr leader = codec_client_->makeHeaderOnlyRequest(request_headers);
+  waitForNextUpstreamRequest();
+  IntegrationCodecClientPtr follower_client;
+  IntegrationStreamDecoderPtr follower =
+      sendCollapsedRequest(request_headers, 1, follower_client);
+
+  upstream_request_->encodeHeaders(response_headers, /*end_stream=*/false);
+  upstream_request_->encodeData(response_body, /*end_stream=*/true);
+  ASSERT_TRUE(leader->waitForEndStream());
+  EXPECT_EQ(leader->body(), response_body);
+
+  // The response can't be shared, so the follower sends its own request upstream.
+  simulateUpstreamResponse(response_headers, makeOptRef(response_body), empty_trailers_)();
+  ASSERT_TRUE(follower->waitForEndStream());
+  EXPECT_TRUE(follower->complete());
+  EXPECT_EQ(follower->body(), response_body);
+  EXPECT_EQ(test_server_->counter("cluster.cluster_0.upstream_rq_total")->value(), 2);
+  EXPECT_EQ(test_server_->counter("http.config_test.cache.collapsed_aborted")->value(), 1);
+  EXPECT_EQ(test_server_->counter("http.config_test.cache.collapsed_served")->value(), 0);
+  follower_client->close();
+}
+
+TEST_P(CacheIntegrationTest, CollapsedRequestSentUpstreamAfterTimeout) {
+  initializeFilter(requestCollapsingConfig("1s"));
+  const Http::TestRequestHeaderMapImpl request_headers =
+      httpRequestHeader("GET", /*authority=*/"CollapsedRequestSentUpstreamAfterTimeout");
+  const std::string response_body(42, 'a');
+  Http::TestResponseHeaderMapImpl response_headers = httpResponseHeadersForBody(response_body);
+
+  IntegrationStreamDecoderPtr leader = codec_client_->makeHeaderOnlyRequest(request_headers);
+  waitForNextUpstreamRequest();
+  IntegrationCodecClientPtr follower_client;
+  IntegrationStreamDecoderPtr follower =
+      sendCollapsedRequest(request_headers, 1, follower_client);
+
+  // The leader's upstream is slow, so the follower gives up on it.
+  simTime().advanceTimeWait(Seconds(1));
+  test_server_->waitForCounterEq("http.config_test.cache.collapsed_timeout", 1);
+  FakeHttpConnectionPtr follower_upstream_connection;
+  FakeStreamPtr follower_upstream_request;
+  if (upstreamProtocol() == Http::CodecType::HTTP1) {
+    ASSERT_TRUE(
+        fake_upstreams_[0]->waitForHttpConnection(*dispatcher_, follower_upstream_connection));
+    ASSERT_TRUE(
+        follower_upstream_connection->waitForNewStream(*dispatcher_, follower_upstream_request));
+  } else {
+    ASSERT_TRUE(
+        fake_upstream_connection_->waitForNewStream(*dispatcher_, follower_upstream_request));
+  }
+  ASSERT_TRUE(follower_upstream_request->waitForEndStream(*dispatcher_));
+  follower_upstream_request->encodeHeaders(response_headers, /*end_stream=*/false);
+  follower_upstream_request->encodeData(response_body, /*end_stream=*/true);
+  ASSERT_TRUE(follower->waitForEndStream());
+  EXPECT_EQ(follower->body(), response_body);
+
+  upstream_request_->encodeHeaders(response_headers, /*end_stream=*/false);
+  upstream_request_->encodeData(response_body, /*end_stream=*/true);
+  ASSERT_TRUE(leader->waitForEndStream());
+  EXPECT_EQ(leader->body(), response_body);
+  EXPECT_EQ(test_server_->counter("http.config_test.cache.collapsed_served")->value(), 0);
+  test_server_->waitForGaugeEq("http.config_test.cache.collapsed_waiting", 0);
+
+  follower_client->close();
+  if (follower_upstream_connection != nullptr) {
+    ASSERT_TRUE(follower_upstream_connection->close());
+    ASSERT_TRUE(follower_upstream_connection->waitForDisconnect());
+  }
+}
+
+TEST_P(CacheIntegrationTest, RequestsNotCollapsedByDefault) {
+  initializeFilter(default_config);
+  const Http::TestRequestHeaderMapImpl request_headers =
+      httpRequestHeader("GET", /*authority=*/"RequestsNotCollapsedByDefault");
+  const std::string response_body(42, 'a');
+  Http::TestResponseHeaderMapImpl response_headers = httpResponseHeadersForBody(response_body);
+
+  IntegrationStreamDecoderPtr response_decoder = sendHeaderOnlyRequestAwaitResponse(
+      request_headers,
+      simulateUpstreamResponse(response_headers, makeOptRef(response_body), empty_trailers_));
+  EXPECT_EQ(response_decoder->body(), response_body);
+  EXPECT_EQ(test_server_->counter("http.config_test.cache.collapsed_leader")->value(), 0);
+}
+
 } // namespace
 } // namespace Cache
 } // namespace HttpFilters
@@ -34,7 +34,8 @@ protected:
   // The filter has to be created as a shared_ptr to enable shared_from_this() which is used in the
   // cache callbacks.
   CacheFilterSharedPtr makeFilter(std::shared_ptr<HttpCache> cache, bool auto_destroy = true) {
-    auto config = std::make_shared<CacheFilterConfig>(config_, context_.server_factory_context_);
+    auto config = std::make_shared<CacheFilterConfig>(config_, "", context_.scope(),
+                                                      context_.server_factory_context_);
     std::shared_ptr<CacheFilter> filter(new CacheFilter(config, cache),
                                         [auto_destroy](CacheFilter* f) {
                                           if (auto_destroy) {
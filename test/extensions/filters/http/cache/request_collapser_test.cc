@@ -0,0 +1,276 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/http/cache/request_collapser.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+class RequestCollapserTest : public ::testing::Test {
+protected:
+  RequestCollapserTest() {
+    key_.set_host("example.com");
+    key_.set_path("/resource");
+    // Posted callbacks are queued, to be run by the test when it chooses.
+    ON_CALL(dispatcher_, post(_)).WillByDefault(Invoke([this](Event::PostCb cb) {
+      posted_.push_back(std::move(cb));
+    }));
+  }
+
+  void runPosted() {
+    std::vector<Event::PostCb> posted = std::move(posted_);
+    posted_.clear();
+    for (auto& cb : posted) {
+      cb();
+    }
+  }
+
+  static std::string bodyOf(const CollapsedResponse::Update& update) {
+    std::string body;
+    for (const auto& chunk : update.body_) {
+      body += *chunk;
+    }
+    return body;
+  }
+
+  static constexpr uint64_t NoLimit = UINT64_MAX;
+
+  std::shared_ptr<RequestCollapser> collapser_ = std::make_shared<RequestCollapser>();
+  Key key_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  std::vector<Event::PostCb> posted_;
+  Http::TestResponseHeaderMapImpl response_headers_{{":status", "200"}};
+};
+
+TEST_F(RequestCollapserTest, FirstRequestLeadsAndLaterRequestsFollow) {
+  bool leader = false;
+  CollapsedResponseSharedPtr response = collapser_->join(key_, NoLimit, leader);
+  EXPECT_TRUE(leader);
+  CollapsedResponseSharedPtr followed = collapser_->join(key_, NoLimit, leader);
+  EXPECT_FALSE(leader);
+  EXPECT_EQ(response, followed);
+  EXPECT_EQ(collapser_->size(), 1);
+
+  Key other_key = key_;
+  other_key.set_path("/other");
+  CollapsedResponseSharedPtr other = collapser_->join(other_key, NoLimit, leader);
+  EXPECT_TRUE(leader);
+  EXPECT_NE(response, other);
+  EXPECT_EQ(collapser_->size(), 2);
+}
+
+TEST_F(RequestCollapserTest, FollowerReadsResponseAsItArrives) {
+  bool leader = false;
+  CollapsedResponseSharedPtr response = collapser_->join(key_, NoLimit, leader);
+  int updates = 0;
+  CollapsedResponse::Reader reader = response->subscribe(dispatcher_, [&updates]() { updates++; });
+
+  // Nothing has arrived yet.
+  CollapsedResponse::Update update = response->read(reader);
+  EXPECT_EQ(update.headers_, nullptr);
+  EXPECT_FALSE(update.end_stream_);
+  EXPECT_FALSE(update.aborted_);
+
+  response->setHeaders(response_headers_, false);
+  Buffer::OwnedImpl hello("hello");
+  response->appendBody(hello, false);
+  // A single notification is posted until the follower reads.
+  EXPECT_EQ(posted_.size(), 1);
+  runPosted();
+  EXPECT_EQ(updates, 1);
+  update = response->read(reader);
+  ASSERT_NE(update.headers_, nullptr);
+  EXPECT_THAT(*update.headers_, HeaderMapEqualRef(&response_headers_));
+  EXPECT_EQ(bodyOf(update), "hello");
+  EXPECT_FALSE(update.end_stream_);
+
+  Buffer::OwnedImpl world(" world");
+  response->appendBody(world, false);
+  Http::TestResponseTrailerMapImpl trailers{{"grpc-status", "0"}};
+  response->setTrailers(trailers);
+  runPosted();
+  EXPECT_EQ(updates, 2);
+  update = response->read(reader);
+  EXPECT_EQ(update.headers_, nullptr);
+  EXPECT_EQ(bodyOf(update), " world");
+  ASSERT_NE(update.trailers_, nullptr);
+  EXPECT_THAT(*update.trailers_, HeaderMapEqualRef(&trailers));
+  EXPECT_TRUE(update.end_stream_);
+
+  response->unsubscribe(reader);
+  // The leader's stream may end before the response is in the cache.
+  response->close();
+  EXPECT_FALSE(response->aborted());
+  EXPECT_EQ(collapser_->size(), 1);
+  response->stopCollapsing();
+  EXPECT_EQ(collapser_->size(), 0);
+}
+
+// If the insert fails while the response is streaming, the followers which were sent its headers
+// are served the rest of it, and the others send their own requests.
+TEST_F(RequestCollapserTest, StopCollapsingWhileStreaming) {
+  bool leader = false;
+  CollapsedResponseSharedPtr response = collapser_->join(key_, NoLimit, leader);
+  CollapsedResponse::Reader started = response->subscribe(dispatcher_, []() {});
+  CollapsedResponse::Reader waiting = response->subscribe(dispatcher_, []() {});
+  response->setHeaders(response_headers_, false);
+  Buffer::OwnedImpl hello("hello");
+  response->appendBody(hello, false);
+  ASSERT_NE(response->read(started).headers_, nullptr);
+
+  response->stopCollapsing();
+  EXPECT_TRUE(response->aborted());
+  EXPECT_EQ(collapser_->size(), 0);
+  CollapsedResponse::Update update = response->read(waiting);
+  EXPECT_TRUE(update.aborted_);
+  EXPECT_EQ(update.headers_, nullptr);
+  response->unsubscribe(waiting);
+
+  // Later requests lead a new response.
+  CollapsedResponseSharedPtr next = collapser_->join(key_, NoLimit, leader);
+  EXPECT_TRUE(leader);
+  EXPECT_NE(next, response);
+
+  Buffer::OwnedImpl world(" world");
+  response->appendBody(world, true);
+  update = response->read(started);
+  EXPECT_FALSE(update.aborted_);
+  EXPECT_EQ(bodyOf(update), " world");
+  EXPECT_TRUE(update.end_stream_);
+  response->unsubscribe(started);
+  response->close();
+  // Closing the response mustn't forget the new one.
+  EXPECT_EQ(collapser_->size(), 1);
+}
+
+// If the leader's stream ends before the response is complete, the followers which were sent its
+// headers are reset even after the insert failed.
+TEST_F(RequestCollapserTest, CloseAfterStopCollapsingAborts) {
+  bool leader = false;
+  CollapsedResponseSharedPtr response = collapser_->join(key_, NoLimit, leader);
+  CollapsedResponse::Reader reader = response->subscribe(dispatcher_, []() {});
+  response->setHeaders(response_headers_, false);
+  ASSERT_NE(response->read(reader).headers_, nullptr);
+  response->stopCollapsing();
+  EXPECT_FALSE(response->read(reader).aborted_);
+  response->close();
+  EXPECT_TRUE(response->read(reader).aborted_);
+  response->unsubscribe(reader);
+}
+
+TEST_F(RequestCollapserTest, LateFollowerReadsWholeResponse) {
+  bool leader = false;
+  CollapsedResponseSharedPtr response = collapser_->join(key_, NoLimit, leader);
+  response->setHeaders(response_headers_, false);
+  Buffer::OwnedImpl hello("hello");
+  response->appendBody(hello, true);
+
+  CollapsedResponseSharedPtr followed = collapser_->join(key_, NoLimit, leader);
+  EXPECT_FALSE(leader);
+  CollapsedResponse::Reader reader = followed->subscribe(dispatcher_, []() {});
+  CollapsedResponse::Update update = followed->read(reader);
+  ASSERT_NE(update.headers_, nullptr);
+  EXPECT_EQ(bodyOf(update), "hello");
+  EXPECT_TRUE(update.end_stream_);
+  followed->unsubscribe(reader);
+}
+
+TEST_F(RequestCollapserTest, CloseBeforeCompleteAborts) {
+  bool leader = false;
+  CollapsedResponseSharedPtr response = collapser_->join(key_, NoLimit, leader);
+  bool notified = false;
+  CollapsedResponse::Reader reader =
+      response->subscribe(dispatcher_, [&notified]() { notified = true; });
+  response->close();
+  runPosted();
+  EXPECT_TRUE(notified);
+  EXPECT_TRUE(response->aborted());
+  EXPECT_TRUE(response->read(reader).aborted_);
+  EXPECT_EQ(collapser_->size(), 0);
+
+  // Updates after the abort are ignored.
+  response->setHeaders(response_headers_, true);
+  EXPECT_TRUE(response->read(reader).aborted_);
+  response->unsubscribe(reader);
+
+  // The next request leads a new response.
+  CollapsedResponseSharedPtr next = collapser_->join(key_, NoLimit, leader);
+  EXPECT_TRUE(leader);
+  EXPECT_NE(next, response);
+}
+
+TEST_F(RequestCollapserTest, ClosingReplacedResponseKeepsNewOne) {
+  bool leader = false;
+  CollapsedResponseSharedPtr first = collapser_->join(key_, NoLimit, leader);
+  first->close();
+  CollapsedResponseSharedPtr second = collapser_->join(key_, NoLimit, leader);
+  EXPECT_TRUE(leader);
+  // Closing the first response again mustn't forget the second.
+  first->close();
+  EXPECT_EQ(collapser_->size(), 1);
+  CollapsedResponseSharedPtr followed = collapser_->join(key_, NoLimit, leader);
+  EXPECT_FALSE(leader);
+  EXPECT_EQ(followed, second);
+}
+
+TEST_F(RequestCollapserTest, UnsubscribedFollowerIsNotNotified) {
+  bool leader = false;
+  CollapsedResponseSharedPtr response = collapser_->join(key_, NoLimit, leader);
+  CollapsedResponse::Reader reader = response->subscribe(dispatcher_, []() {});
+  response->unsubscribe(reader);
+  response->setHeaders(response_headers_, true);
+  EXPECT_TRUE(posted_.empty());
+}
+
+// A response whose body turns out to be larger than the cache stores is aborted, and the body
+// received so far is released.
+TEST_F(RequestCollapserTest, BodyOverLimitAborts) {
+  bool leader = false;
+  CollapsedResponseSharedPtr response = collapser_->join(key_, 8, leader);
+  CollapsedResponse::Reader reader = response->subscribe(dispatcher_, []() {});
+  response->setHeaders(response_headers_, false);
+  Buffer::OwnedImpl hello("hello");
+  response->appendBody(hello, false);
+  EXPECT_FALSE(response->aborted());
+  response->appendBody(hello, false);
+  EXPECT_TRUE(response->aborted());
+  EXPECT_TRUE(response->read(reader).aborted_);
+  response->unsubscribe(reader);
+  response->close();
+  EXPECT_EQ(collapser_->size(), 0);
+}
+
+// A response whose content length is larger than the cache stores is aborted before any follower
+// is served its headers, so that they all send their own requests.
+TEST_F(RequestCollapserTest, ContentLengthOverLimitAbortsBeforeHeaders) {
+  bool leader = false;
+  CollapsedResponseSharedPtr response = collapser_->join(key_, 8, leader);
+  CollapsedResponse::Reader reader = response->subscribe(dispatcher_, []() {});
+  Http::TestResponseHeaderMapImpl headers{{":status", "200"}, {"content-length", "10"}};
+  response->setHeaders(headers, false);
+  EXPECT_TRUE(response->aborted());
+  CollapsedResponse::Update update = response->read(reader);
+  EXPECT_TRUE(update.aborted_);
+  EXPECT_EQ(update.headers_, nullptr);
+  response->unsubscribe(reader);
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,174 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/type/matcher/v3/string.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/random_generator.h"
+#include "source/common/common/utility.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/singleton/manager_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/common/async_files/async_file_manager_factory.h"
+#include "source/extensions/http/cache/file_system_http_cache/cache_eviction_thread.h"
+#include "source/extensions/http/cache/file_system_http_cache/cache_file_fixed_block.h"
+#include "source/extensions/http/cache/file_system_http_cache/cache_file_header_proto_util.h"
+#include "source/extensions/http/cache/file_system_http_cache/file_system_http_cache.h"
+#include "source/extensions/http/cache/file_system_http_cache/lookup_context.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/server/server_factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace FileSystemHttpCache {
+
+// A worker looking up the headers and bodies of a catalog of cached responses, of which the hot
+// tier, if enabled, can hold about a quarter.
+class FileSystemHttpCacheBenchmark {
+public:
+  FileSystemHttpCacheBenchmark(bool hot_tier, uint32_t num_keys, uint32_t num_requests)
+      : cache_path_(absl::StrCat(TestEnvironment::temporaryDirectory(), "/fs_cache_benchmark/")),
+        cache_eviction_thread_(Thread::threadFactoryForTest()) {
+    TestEnvironment::createPath(cache_path_);
+    ConfigProto config;
+    config.mutable_manager_config()->mutable_thread_pool()->set_thread_count(1);
+    config.set_cache_path(cache_path_);
+    if (hot_tier) {
+      config.mutable_hot_tier()->set_max_size_bytes(num_keys * BodySize / 4);
+    }
+    async_file_manager_factory_ =
+        Common::AsyncFiles::AsyncFileManagerFactory::singleton(&singleton_manager_);
+    cache_ = std::make_shared<FileSystemHttpCache>(
+        nullptr, cache_eviction_thread_, config,
+        async_file_manager_factory_->getAsyncFileManager(config.manager_config()),
+        *store_.rootScope());
+
+    const SystemTime now = api_->timeSource().systemTime();
+    Http::TestResponseHeaderMapImpl response_headers{
+        {":status", "200"},
+        {"date", DateFormatter("%a, %d %b %Y %H:%M:%S GMT").fromTime(now)},
+        {"cache-control", "public,max-age=3600"}};
+    request_headers_.reserve(num_keys);
+    for (uint32_t i = 0; i < num_keys; ++i) {
+      request_headers_.push_back(Http::TestRequestHeaderMapImpl{{":method", "GET"},
+                                                                {":scheme", "https"},
+                                                                {":authority", "example.com"},
+                                                                {":path", absl::StrCat("/", i)}});
+      const Key key = LookupRequest{request_headers_.back(), now, vary_allow_list_}.key();
+      writeCacheFile(key, response_headers, ResponseMetadata{now});
+    }
+    // The popularity of the keys is roughly Zipf distributed: the probability of the key of index i
+    // is proportional to 1 / (i + 1).
+    Random::RandomGeneratorImpl random;
+    requests_.reserve(num_requests);
+    const double log_keys = std::log(static_cast<double>(num_keys));
+    for (uint32_t i = 0; i < num_requests; ++i) {
+      const double u = static_cast<double>(random.random() % 1000000) / 1000000;
+      requests_.push_back(static_cast<uint32_t>(std::exp(u * log_keys)) - 1);
+    }
+  }
+
+  ~FileSystemHttpCacheBenchmark() {
+    cache_.reset();
+    TestEnvironment::removePath(cache_path_);
+  }
+
+  // Looks up the headers and then the body of each request in turn.
+  void run() {
+    const SystemTime now = api_->timeSource().systemTime();
+    for (uint32_t index : requests_) {
+      FileLookupContext lookup(*dispatcher_, *cache_,
+                               LookupRequest{request_headers_[index], now, vary_allow_list_});
+      bool done = false;
+      lookup.getHeaders([&](LookupResult&& result, bool) {
+        RELEASE_ASSERT(result.cache_entry_status_ == CacheEntryStatus::Ok, "");
+        lookup.getBody(AdjustedByteRange(0, BodySize), [&](Buffer::InstancePtr&& body, bool) {
+          RELEASE_ASSERT(body != nullptr && body->length() == BodySize, "");
+          done = true;
+        });
+      });
+      while (!done) {
+        dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+      }
+      lookup.onDestroy();
+    }
+  }
+
+  const CacheStats& stats() const { return cache_->stats(); }
+
+private:
+  static constexpr uint64_t BodySize = 4096;
+
+  void writeCacheFile(const Key& key, const Http::ResponseHeaderMap& response_headers,
+                      const ResponseMetadata& metadata) {
+    Buffer::OwnedImpl headers =
+        bufferFromProto(makeCacheFileHeaderProto(key, response_headers, metadata));
+    CacheFileFixedBlock block;
+    block.setHeadersSize(headers.length());
+    block.setBodySize(BodySize);
+    block.setTrailersSize(0);
+    Buffer::OwnedImpl contents;
+    block.serializeToBuffer(contents);
+    contents.move(headers);
+    contents.add(std::string(BodySize, 'x'));
+    TestEnvironment::writeStringToFileForTest(
+        absl::StrCat(cache_path_, cache_->generateFilename(key)), contents.toString(), true);
+  }
+
+  const std::string cache_path_;
+  Api::ApiPtr api_ = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher_ = api_->allocateDispatcher("bench_thread");
+  Stats::IsolatedStoreImpl store_;
+  Singleton::ManagerImpl singleton_manager_;
+  std::shared_ptr<Common::AsyncFiles::AsyncFileManagerFactory> async_file_manager_factory_;
+  CacheEvictionThread cache_eviction_thread_;
+  std::shared_ptr<FileSystemHttpCache> cache_;
+  testing::NiceMock<Server::Configuration::MockServerFactoryContext> factory_context_;
+  VaryAllowList vary_allow_list_{
+      Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher>{}, factory_context_};
+  std::vector<Http::TestRequestHeaderMapImpl> request_headers_;
+  std::vector<uint32_t> requests_;
+};
+
+// Measures the latency of cache hits with and without the hot tier, and how many of the lookups
+// didn't have to open, and read from, a cache file.
+static void fileSystemHttpCacheHits(::benchmark::State& state) {
+  const bool hot_tier = state.range(0) != 0;
+  const uint32_t num_requests = benchmark::skipExpensiveBenchmarks() ? 100 : 10000;
+  FileSystemHttpCacheBenchmark speed_test(hot_tier, 1000, num_requests);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    speed_test.run();
+  }
+  const double lookups = static_cast<double>(state.iterations()) * num_requests;
+  state.counters["hot_tier_hit_ratio"] = speed_test.stats().hot_tier_hits_.value() / lookups;
+  state.counters["files_opened_per_lookup"] =
+      (lookups - speed_test.stats().hot_tier_hits_.value()) / lookups;
+  state.SetItemsProcessed(state.iterations() * num_requests);
+}
+
+BENCHMARK(fileSystemHttpCacheHits)
+    ->Arg(0)
+    ->Arg(1)
+    ->ArgNames({"hot_tier"})
+    ->Unit(::benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace FileSystemHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -1367,6 +1367,101 @@ TEST_F(FileSystemHttpCacheTestWithMockFiles, UpdateHeadersAbortsEarlyIfCacheEntr
   EXPECT_OK(mock_async_file_handle_->close(nullptr, [](absl::Status) {}));
 }
 
+class FileSystemHttpCacheTestWithMockFilesAndHotTier : public FileSystemHttpCacheTestWithMockFiles {
+public:
+  void SetUp() override {
+    ConfigProto cfg = testConfig();
+    cfg.mutable_hot_tier()->set_max_size_bytes(1024 * 1024);
+    cfg.mutable_hot_tier()->mutable_min_lookups_to_promote()->set_value(1);
+    cache_ = std::dynamic_pointer_cast<FileSystemHttpCache>(
+        http_cache_factory_->getCache(cacheConfig(cfg), context_));
+  }
+
+  Buffer::InstancePtr testEntryBuffer(absl::string_view body) {
+    auto buffer = testHeaderBuffer();
+    buffer->add(body);
+    buffer->add(bufferFromProto(makeCacheFileTrailerProto(response_trailers_)));
+    return buffer;
+  }
+
+  // Gets the body and trailers of an entry with body "beepbeep", expecting no file reads.
+  void expectBodyAndTrailersFromMemory(LookupContext& lookup) {
+    EXPECT_CALL(*mock_async_file_handle_, read(_, _, _, _)).Times(0);
+    std::string body;
+    lookup.getBody(AdjustedByteRange(2, 8), [&](Buffer::InstancePtr b, bool end_stream) {
+      body = b->toString();
+      EXPECT_FALSE(end_stream);
+    });
+    pumpDispatcher();
+    EXPECT_EQ(body, "epbeep");
+    Http::ResponseTrailerMapPtr trailers;
+    lookup.getTrailers([&](Http::ResponseTrailerMapPtr t) { trailers = std::move(t); });
+    pumpDispatcher();
+    ASSERT_NE(trailers, nullptr);
+    EXPECT_THAT(*trailers, HeaderMapEqualRef(&response_trailers_));
+  }
+};
+
+TEST_F(FileSystemHttpCacheTestWithMockFilesAndHotTier,
+       SmallEntryIsReadAtOnceAndThenServedFromMemory) {
+  const size_t entry_size = headers_size_ + 8 + trailers_size_;
+  LookupResult result;
+  auto lookup = testLookupContext();
+  EXPECT_CALL(*mock_async_file_manager_, openExistingFile(_, _, _, _));
+  EXPECT_CALL(*mock_async_file_handle_, read(_, 0, CacheFileFixedBlock::size(), _));
+  // The headers, body and trailers are read together.
+  EXPECT_CALL(*mock_async_file_handle_,
+              read(_, CacheFileFixedBlock::offsetToHeaders(), entry_size, _));
+  lookup->getHeaders([&](LookupResult&& r, bool end_stream) {
+    result = std::move(r);
+    EXPECT_FALSE(end_stream);
+  });
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<AsyncFileHandle>(mock_async_file_handle_));
+  pumpDispatcher();
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<Buffer::InstancePtr>(testHeaderBlock(8)));
+  pumpDispatcher();
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<Buffer::InstancePtr>(testEntryBuffer("beepbeep")));
+  pumpDispatcher();
+  EXPECT_EQ(result.cache_entry_status_, CacheEntryStatus::Ok);
+  expectBodyAndTrailersFromMemory(*lookup);
+  lookup->onDestroy();
+  mock_async_file_manager_->nextActionCompletes(absl::OkStatus());
+  pumpDispatcher();
+  EXPECT_EQ(cache_->stats().hot_tier_promotions_.value(), 1);
+  EXPECT_EQ(cache_->stats().hot_tier_size_bytes_.value(), entry_size);
+
+  // The second lookup doesn't open the file at all.
+  result = LookupResult{};
+  lookup = testLookupContext();
+  EXPECT_CALL(*mock_async_file_manager_, openExistingFile(_, _, _, _)).Times(0);
+  lookup->getHeaders([&](LookupResult&& r, bool end_stream) {
+    result = std::move(r);
+    EXPECT_FALSE(end_stream);
+  });
+  pumpDispatcher();
+  EXPECT_EQ(result.cache_entry_status_, CacheEntryStatus::Ok);
+  expectBodyAndTrailersFromMemory(*lookup);
+  lookup->onDestroy();
+  EXPECT_EQ(cache_->stats().hot_tier_hits_.value(), 1);
+  EXPECT_EQ(cache_->stats().cache_hit_.value(), 2);
+}
+
+TEST_F(FileSystemHttpCacheTestWithMockFilesAndHotTier,
+       DestroyingALookupServedFromMemoryCancelsTheCallback) {
+  auto lookup = testLookupContext();
+  uint64_t generation;
+  ASSERT_EQ(cache_->hotTier()->lookup(stableHashKey(key_), generation), nullptr);
+  cache_->hotTier()->offer(stableHashKey(key_), generation,
+                           std::make_shared<const HotTierEntry>(
+                               CacheFileFixedBlock{}, testEntryBuffer("beepbeep")->toString()));
+  lookup->getHeaders([&](LookupResult&&, bool) { FAIL() << "callback after destruction"; });
+  lookup->onDestroy();
+  pumpDispatcher();
+}
+
 // For the standard cache tests from http_cache_implementation_test_common.cc
 // These will be run with the real file system, and therefore only cover the
 // "no file errors" paths.
@@ -1379,12 +1474,29 @@ public:
   void beforePumpingDispatcher() override { cache_->drainAsyncFileActionsForTest(); }
 };
 
+// Runs the standard cache tests with every entry promoted to the hot tier on its first lookup,
+// so that repeated lookups are served from memory.
+class FileSystemHttpCacheWithHotTierTestDelegate : public FileSystemHttpCacheTestDelegate {
+public:
+  FileSystemHttpCacheWithHotTierTestDelegate() {
+    ConfigProto cfg = testConfig();
+    cfg.mutable_hot_tier()->set_max_size_bytes(1024 * 1024);
+    cfg.mutable_hot_tier()->mutable_min_lookups_to_promote()->set_value(1);
+    // Release the default cache first, as caches with the same path must have the same config.
+    cache_.reset();
+    cache_ = std::dynamic_pointer_cast<FileSystemHttpCache>(
+        http_cache_factory_->getCache(cacheConfig(cfg), context_));
+  }
+};
+
 // For the standard cache tests from http_cache_implementation_test_common.cc
-INSTANTIATE_TEST_SUITE_P(FileSystemHttpCacheTest, HttpCacheImplementationTest,
-                         testing::Values(std::make_unique<FileSystemHttpCacheTestDelegate>),
-                         [](const testing::TestParamInfo<HttpCacheImplementationTest::ParamType>&) {
-                           return "FileSystemHttpCache";
-                         });
+INSTANTIATE_TEST_SUITE_P(
+    FileSystemHttpCacheTest, HttpCacheImplementationTest,
+    testing::Values(std::make_unique<FileSystemHttpCacheTestDelegate>,
+                    std::make_unique<FileSystemHttpCacheWithHotTierTestDelegate>),
+    [](const testing::TestParamInfo<HttpCacheImplementationTest::ParamType>& info) {
+      return info.index == 0 ? "FileSystemHttpCache" : "FileSystemHttpCacheWithHotTier";
+    });
 
 TEST(Registration, GetCacheFromFactory) {
   HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
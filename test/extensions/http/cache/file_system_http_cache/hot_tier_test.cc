@@ -0,0 +1,138 @@
+#include <memory>
+#include <string>
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/http/cache/file_system_http_cache/hot_tier.h"
+#include "source/extensions/http/cache/file_system_http_cache/stats.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace FileSystemHttpCache {
+namespace {
+
+using ::testing::UnorderedElementsAre;
+
+class HotTierTest : public ::testing::Test {
+public:
+  HotTierTest() { config_.set_max_size_bytes(100); }
+
+  HotTier& hotTier() {
+    if (!hot_tier_) {
+      hot_tier_ = std::make_unique<HotTier>(config_, stats_);
+    }
+    return *hot_tier_;
+  }
+
+  static HotTierEntrySharedPtr entry(size_t size) {
+    CacheFileFixedBlock block;
+    block.setBodySize(size);
+    return std::make_shared<const HotTierEntry>(block, std::string(size, 'x'));
+  }
+
+  // Looks up an entry and, if it isn't held, offers it as a lookup which read its file would.
+  HotTierEntrySharedPtr lookupAndOffer(uint64_t hash, size_t size) {
+    uint64_t generation;
+    HotTierEntrySharedPtr result = hotTier().lookup(hash, generation);
+    if (!result) {
+      hotTier().offer(hash, generation, entry(size));
+    }
+    return result;
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  CacheStatNames stat_names_{store_.symbolTable()};
+  CacheStats stats_{generateStats(stat_names_, *store_.rootScope(), "/cache/")};
+  HotTier::ConfigProto::HotTier config_;
+  std::unique_ptr<HotTier> hot_tier_;
+};
+
+TEST_F(HotTierTest, EntryIsPromotedOnSecondLookupByDefault) {
+  EXPECT_EQ(lookupAndOffer(1, 10), nullptr);
+  EXPECT_EQ(stats_.hot_tier_promotions_.value(), 0);
+  EXPECT_EQ(lookupAndOffer(1, 10), nullptr);
+  EXPECT_EQ(stats_.hot_tier_promotions_.value(), 1);
+  HotTierEntrySharedPtr held = lookupAndOffer(1, 10);
+  ASSERT_NE(held, nullptr);
+  EXPECT_EQ(held->body(), std::string(10, 'x'));
+  EXPECT_EQ(stats_.hot_tier_hits_.value(), 1);
+  EXPECT_EQ(stats_.hot_tier_size_bytes_.value(), 10);
+  EXPECT_EQ(stats_.hot_tier_size_count_.value(), 1);
+}
+
+TEST_F(HotTierTest, MinLookupsToPromoteIsConfigurable) {
+  config_.mutable_min_lookups_to_promote()->set_value(1);
+  EXPECT_EQ(lookupAndOffer(1, 10), nullptr);
+  EXPECT_NE(lookupAndOffer(1, 10), nullptr);
+}
+
+TEST_F(HotTierTest, EntriesLargerThanMaxEntrySizeAreNotHeld) {
+  config_.mutable_max_entry_size_bytes()->set_value(20);
+  EXPECT_TRUE(hotTier().mayHold(20));
+  EXPECT_FALSE(hotTier().mayHold(21));
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(lookupAndOffer(1, 21), nullptr);
+  }
+  EXPECT_EQ(stats_.hot_tier_promotions_.value(), 0);
+}
+
+TEST_F(HotTierTest, LessFrequentlyLookedUpEntryDoesNotDisplaceMoreFrequentOne) {
+  for (int i = 0; i < 5; i++) {
+    lookupAndOffer(1, 60);
+  }
+  // Looked up twice, so it is a candidate, but less often than the entry it would displace.
+  lookupAndOffer(2, 60);
+  lookupAndOffer(2, 60);
+  EXPECT_EQ(stats_.hot_tier_evictions_.value(), 0);
+  EXPECT_THAT(hotTier().hashes(), UnorderedElementsAre(1));
+}
+
+TEST_F(HotTierTest, MoreFrequentlyLookedUpEntryDisplacesLeastRecentlyUsedOnes) {
+  lookupAndOffer(1, 50);
+  lookupAndOffer(1, 50);
+  lookupAndOffer(2, 50);
+  lookupAndOffer(2, 50);
+  EXPECT_THAT(hotTier().hashes(), UnorderedElementsAre(1, 2));
+  for (int i = 0; i < 4; i++) {
+    lookupAndOffer(3, 60);
+  }
+  EXPECT_EQ(stats_.hot_tier_evictions_.value(), 2);
+  EXPECT_THAT(hotTier().hashes(), UnorderedElementsAre(3));
+  EXPECT_EQ(stats_.hot_tier_size_bytes_.value(), 60);
+  EXPECT_EQ(stats_.hot_tier_size_count_.value(), 1);
+}
+
+TEST_F(HotTierTest, RemoveStopsHoldingEntry) {
+  lookupAndOffer(1, 10);
+  lookupAndOffer(1, 10);
+  hotTier().remove(1);
+  EXPECT_TRUE(hotTier().hashes().empty());
+  EXPECT_EQ(stats_.hot_tier_size_bytes_.value(), 0);
+  EXPECT_EQ(stats_.hot_tier_size_count_.value(), 0);
+  // Removing an entry which isn't held is harmless.
+  hotTier().remove(1);
+}
+
+TEST_F(HotTierTest, ContentsReadBeforeRemovalAreNotAdmitted) {
+  lookupAndOffer(1, 10);
+  uint64_t generation;
+  EXPECT_EQ(hotTier().lookup(1, generation), nullptr);
+  // The file is replaced while the lookup reads it.
+  hotTier().remove(1);
+  hotTier().offer(1, generation, entry(10));
+  EXPECT_TRUE(hotTier().hashes().empty());
+  // A lookup after the removal reads the new file, which is admitted.
+  lookupAndOffer(1, 10);
+  EXPECT_THAT(hotTier().hashes(), UnorderedElementsAre(1));
+}
+
+} // namespace
+} // namespace FileSystemHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
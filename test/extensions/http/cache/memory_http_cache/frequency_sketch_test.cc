@@ -0,0 +1,82 @@
+#include <algorithm>
+
+#include "source/extensions/http/cache/memory_http_cache/frequency_sketch.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+// A well distributed hash of a small integer.
+uint64_t hashOf(uint64_t i) { return (i + 1) * 0x9e3779b97f4a7c15ULL; }
+
+TEST(FrequencySketchTest, CountsOccurrences) {
+  FrequencySketch sketch(1024);
+  EXPECT_EQ(sketch.frequency(hashOf(1)), 0);
+  for (uint32_t i = 0; i < 5; ++i) {
+    sketch.increment(hashOf(1));
+  }
+  sketch.increment(hashOf(2));
+  EXPECT_EQ(sketch.frequency(hashOf(1)), 5);
+  EXPECT_EQ(sketch.frequency(hashOf(2)), 1);
+  EXPECT_EQ(sketch.frequency(hashOf(3)), 0);
+}
+
+TEST(FrequencySketchTest, SaturatesAtFifteen) {
+  FrequencySketch sketch(1024);
+  for (uint32_t i = 0; i < 100; ++i) {
+    sketch.increment(hashOf(1));
+  }
+  EXPECT_EQ(sketch.frequency(hashOf(1)), 15);
+}
+
+TEST(FrequencySketchTest, HalvesCountersAfterSample) {
+  FrequencySketch sketch(16);
+  EXPECT_EQ(sketch.sampleSize(), 160);
+  for (uint32_t i = 0; i < 8; ++i) {
+    sketch.increment(hashOf(0));
+  }
+  // Increments of other items complete the sample, after which the counters are halved. The
+  // estimate of the first item may have grown through collisions before that.
+  uint32_t peak = sketch.frequency(hashOf(0));
+  EXPECT_GE(peak, 8);
+  bool halved = false;
+  for (uint64_t i = 1; i <= sketch.sampleSize() && !halved; ++i) {
+    sketch.increment(hashOf(i % 64 + 1));
+    const uint32_t frequency = sketch.frequency(hashOf(0));
+    if (frequency < peak) {
+      halved = true;
+      // The increment which completed the sample may have collided with the first item as well.
+      EXPECT_GE(frequency, peak / 2);
+      EXPECT_LE(frequency, (peak + 1) / 2);
+    }
+    peak = std::max(peak, frequency);
+  }
+  EXPECT_TRUE(halved);
+}
+
+TEST(FrequencySketchTest, EstimatesDistinctItems) {
+  FrequencySketch sketch(4096);
+  for (uint64_t i = 0; i < 4096; ++i) {
+    for (uint64_t j = 0; j < i % 4; ++j) {
+      sketch.increment(hashOf(i));
+    }
+  }
+  // A count-min sketch never underestimates, and with a table sized for the items it rarely
+  // overestimates.
+  uint32_t exact = 0;
+  for (uint64_t i = 0; i < 4096; ++i) {
+    EXPECT_GE(sketch.frequency(hashOf(i)), i % 4);
+    exact += sketch.frequency(hashOf(i)) == i % 4;
+  }
+  EXPECT_GT(exact, 4096 * 9 / 10);
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
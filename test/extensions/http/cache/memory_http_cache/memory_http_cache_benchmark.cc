@@ -0,0 +1,125 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/common/random_generator.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/http/cache/memory_http_cache/memory_http_cache.h"
+
+#include "test/benchmark/main.h"
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+// Workers looking up responses of a catalog of keys, which is many times larger than the cache,
+// in a shared cache, and inserting the responses they don't find.
+class MemoryHttpCacheBenchmark {
+public:
+  MemoryHttpCacheBenchmark(uint32_t shard_count, uint32_t num_keys, uint32_t num_requests)
+      : cache_(makeConfig(shard_count), *store_.rootScope()) {
+    keys_.reserve(num_keys);
+    for (uint32_t i = 0; i < num_keys; ++i) {
+      Key key;
+      key.set_host("example.com");
+      key.set_path(absl::StrCat("/static/", i));
+      keys_.push_back(std::move(key));
+    }
+    auto response = std::make_shared<CachedResponse>();
+    response->response_headers_ = Http::ResponseHeaderMapImpl::create();
+    response->response_headers_->setStatus(200);
+    response->body_ = std::make_shared<const std::string>(BodySize, 'x');
+    response_ = std::move(response);
+    // The popularity of the keys is roughly Zipf distributed: the probability of the key of index i
+    // is proportional to 1 / (i + 1).
+    Random::RandomGeneratorImpl random;
+    requests_.reserve(num_requests);
+    const double log_keys = std::log(static_cast<double>(num_keys));
+    for (uint32_t i = 0; i < num_requests; ++i) {
+      const double u = static_cast<double>(random.random() % 1000000) / 1000000;
+      requests_.push_back(static_cast<uint32_t>(std::exp(u * log_keys)) - 1);
+    }
+  }
+
+  // Runs the requests, divided among workers.
+  void run(uint32_t num_workers) {
+    std::vector<Thread::ThreadPtr> workers;
+    workers.reserve(num_workers);
+    const size_t requests_per_worker = requests_.size() / num_workers;
+    for (uint32_t w = 0; w < num_workers; ++w) {
+      workers.push_back(Thread::threadFactoryForTest().createThread(
+          [this, begin = w * requests_per_worker, end = (w + 1) * requests_per_worker]() {
+            uint64_t hits = 0;
+            for (size_t i = begin; i < end; ++i) {
+              const Key& key = keys_[requests_[i]];
+              if (cache_.lookup(key) != nullptr) {
+                ++hits;
+              } else {
+                cache_.insert(key, response_);
+              }
+            }
+            hits_ += hits;
+            lookups_ += end - begin;
+          }));
+    }
+    for (Thread::ThreadPtr& worker : workers) {
+      worker->join();
+    }
+  }
+
+  double hitRatio() const { return static_cast<double>(hits_) / lookups_; }
+
+private:
+  static constexpr uint64_t BodySize = 4096;
+  static constexpr uint64_t CacheSize = 64 * 1024 * 1024;
+
+  static MemoryHttpCacheConfig makeConfig(uint32_t shard_count) {
+    MemoryHttpCacheConfig config;
+    config.set_max_cache_size_bytes(CacheSize);
+    config.mutable_shard_count()->set_value(shard_count);
+    return config;
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  MemoryHttpCache cache_;
+  std::vector<Key> keys_;
+  CachedResponseConstSharedPtr response_;
+  std::vector<uint32_t> requests_;
+  std::atomic<uint64_t> hits_{};
+  std::atomic<uint64_t> lookups_{};
+};
+
+// Measures the throughput of lookups and inserts of concurrent workers, and the hit ratio of the
+// cache, which holds about a tenth of the catalog.
+static void memoryHttpCacheThroughput(::benchmark::State& state) {
+  const uint32_t num_workers = state.range(0);
+  const uint32_t shard_count = state.range(1);
+  const uint32_t num_requests = benchmark::skipExpensiveBenchmarks() ? 10000 : 1000000;
+  MemoryHttpCacheBenchmark speed_test(shard_count, 160000, num_requests);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    speed_test.run(num_workers);
+  }
+  state.counters["hit_ratio"] = speed_test.hitRatio();
+  state.SetItemsProcessed(state.iterations() * num_requests);
+}
+
+BENCHMARK(memoryHttpCacheThroughput)
+    ->ArgsProduct({{1, 4, 16}, {1, 16}})
+    ->Unit(::benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,171 @@
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/http/cache/memory_http_cache/v3/memory_http_cache.pb.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/http/header_map_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/http/cache/memory_http_cache/memory_http_cache.h"
+
+#include "test/extensions/filters/http/cache/http_cache_implementation_test_common.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+MemoryHttpCacheConfig makeConfig(uint64_t max_cache_size_bytes, uint32_t shard_count) {
+  MemoryHttpCacheConfig config;
+  config.set_max_cache_size_bytes(max_cache_size_bytes);
+  config.mutable_shard_count()->set_value(shard_count);
+  return config;
+}
+
+class MemoryHttpCacheTestDelegate : public HttpCacheTestDelegate {
+public:
+  std::shared_ptr<HttpCache> cache() override { return cache_; }
+  bool validationEnabled() const override { return true; }
+
+private:
+  Stats::IsolatedStoreImpl store_;
+  std::shared_ptr<MemoryHttpCache> cache_ =
+      std::make_shared<MemoryHttpCache>(makeConfig(1024 * 1024, 4), *store_.rootScope());
+};
+
+INSTANTIATE_TEST_SUITE_P(MemoryHttpCacheTest, HttpCacheImplementationTest,
+                         testing::Values(std::make_unique<MemoryHttpCacheTestDelegate>),
+                         [](const testing::TestParamInfo<HttpCacheImplementationTest::ParamType>&) {
+                           return "MemoryHttpCache";
+                         });
+
+TEST(Registration, GetFactory) {
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.extensions.http.cache.memory_http_cache.v3.MemoryHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  envoy::extensions::filters::http::cache::v3::CacheConfig config;
+  testing::NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  config.mutable_typed_config()->PackFrom(makeConfig(1024 * 1024, 4));
+  std::shared_ptr<HttpCache> cache = factory->getCache(config, factory_context);
+  EXPECT_EQ(cache->cacheInfo().name_, "envoy.extensions.http.cache.memory");
+  // Filters with the same configuration share the cache.
+  EXPECT_EQ(factory->getCache(config, factory_context), cache);
+}
+
+class MemoryHttpCacheEvictionTest : public testing::Test {
+protected:
+  void initialize(MemoryHttpCacheConfig config) {
+    cache_ = std::make_unique<MemoryHttpCache>(config, *store_.rootScope());
+  }
+
+  static Key makeKey(uint64_t i) {
+    Key key;
+    key.set_host("example.com");
+    key.set_path(absl::StrCat("/", i));
+    return key;
+  }
+
+  static CachedResponseConstSharedPtr makeResponse(size_t body_size) {
+    auto response = std::make_shared<CachedResponse>();
+    response->response_headers_ = Http::ResponseHeaderMapImpl::create();
+    response->response_headers_->setStatus(200);
+    response->body_ = std::make_shared<const std::string>(body_size, 'x');
+    return response;
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  std::unique_ptr<MemoryHttpCache> cache_;
+};
+
+TEST_F(MemoryHttpCacheEvictionTest, LookupReturnsInsertedResponse) {
+  initialize(makeConfig(1024 * 1024, 4));
+  CachedResponseConstSharedPtr response = makeResponse(100);
+  EXPECT_TRUE(cache_->insert(makeKey(1), response));
+  EXPECT_EQ(cache_->lookup(makeKey(1)), response);
+  EXPECT_EQ(cache_->lookup(makeKey(2)), nullptr);
+  EXPECT_EQ(cache_->stats().insert_.value(), 1);
+  EXPECT_EQ(cache_->stats().size_count_.value(), 1);
+  EXPECT_GT(cache_->stats().size_bytes_.value(), 100);
+  EXPECT_EQ(cache_->stats().size_limit_bytes_.value(), 1024 * 1024);
+}
+
+TEST_F(MemoryHttpCacheEvictionTest, InsertReplacesResponse) {
+  initialize(makeConfig(1024 * 1024, 4));
+  EXPECT_TRUE(cache_->insert(makeKey(1), makeResponse(100)));
+  CachedResponseConstSharedPtr response = makeResponse(200);
+  EXPECT_TRUE(cache_->insert(makeKey(1), response));
+  EXPECT_EQ(cache_->lookup(makeKey(1)), response);
+  EXPECT_EQ(cache_->stats().size_count_.value(), 1);
+  EXPECT_EQ(cache_->stats().eviction_.value(), 0);
+}
+
+TEST_F(MemoryHttpCacheEvictionTest, RejectsTooLargeResponses) {
+  MemoryHttpCacheConfig config = makeConfig(1024 * 1024, 4);
+  config.mutable_max_individual_cache_entry_size_bytes()->set_value(1000);
+  initialize(config);
+  EXPECT_EQ(cache_->maxEntrySize(), 1000);
+  EXPECT_FALSE(cache_->insert(makeKey(1), makeResponse(1000)));
+  EXPECT_EQ(cache_->lookup(makeKey(1)), nullptr);
+  EXPECT_EQ(cache_->stats().insert_too_large_.value(), 1);
+  EXPECT_EQ(cache_->stats().insert_.value(), 0);
+}
+
+TEST_F(MemoryHttpCacheEvictionTest, MaxEntrySizeIsBoundedByShard) {
+  initialize(makeConfig(1024 * 1024, 4));
+  EXPECT_LT(cache_->maxEntrySize(), 1024 * 1024 / 4);
+  EXPECT_FALSE(cache_->insert(makeKey(1), makeResponse(1024 * 1024 / 4)));
+}
+
+TEST_F(MemoryHttpCacheEvictionTest, RespectsByteLimit) {
+  initialize(makeConfig(256 * 1024, 4));
+  for (uint64_t i = 0; i < 2000; ++i) {
+    EXPECT_TRUE(cache_->insert(makeKey(i), makeResponse(1000)));
+    EXPECT_LE(cache_->stats().size_bytes_.value(), 256 * 1024);
+  }
+  EXPECT_GT(cache_->stats().eviction_.value(), 0);
+  EXPECT_EQ(cache_->stats().size_count_.value() + cache_->stats().eviction_.value(), 2000);
+}
+
+// A response which is requested regularly stays cached while many more responses than fit in the
+// cache are each requested once, which would evict it from an LRU cache.
+TEST_F(MemoryHttpCacheEvictionTest, FrequentResponseSurvivesScan) {
+  initialize(makeConfig(1024 * 1024, 1));
+  const Key hot_key = makeKey(0);
+  CachedResponseConstSharedPtr hot_response = makeResponse(1000);
+  EXPECT_TRUE(cache_->insert(hot_key, hot_response));
+  for (uint32_t i = 0; i < 8; ++i) {
+    EXPECT_EQ(cache_->lookup(hot_key), hot_response);
+  }
+  for (uint64_t i = 1; i <= 6000; ++i) {
+    cache_->insert(makeKey(i), makeResponse(1000));
+    if (i % 1500 == 0) {
+      EXPECT_EQ(cache_->lookup(hot_key), hot_response);
+    }
+  }
+  EXPECT_GT(cache_->stats().eviction_.value(), 0);
+}
+
+TEST_F(MemoryHttpCacheEvictionTest, ReplaceRequiresExpectedResponse) {
+  initialize(makeConfig(1024 * 1024, 4));
+  CachedResponseConstSharedPtr original = makeResponse(100);
+  EXPECT_TRUE(cache_->insert(makeKey(1), original));
+  CachedResponseConstSharedPtr other = makeResponse(100);
+  EXPECT_FALSE(cache_->replace(makeKey(1), *other, makeResponse(200)));
+  EXPECT_FALSE(cache_->replace(makeKey(2), *original, makeResponse(200)));
+  CachedResponseConstSharedPtr updated = makeResponse(200);
+  EXPECT_TRUE(cache_->replace(makeKey(1), *original, updated));
+  EXPECT_EQ(cache_->lookup(makeKey(1)), updated);
+  EXPECT_EQ(cache_->stats().size_count_.value(), 1);
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -9,7 +9,9 @@
 
 #include "source/common/common/random_generator.h"
 #include "source/common/memory/stats.h"
+#include "source/common/router/metadatamatchcriteria_impl.h"
 #include "source/common/upstream/upstream_impl.h"
+#include "source/extensions/load_balancing_policies/subset/bitmap_subset_lb.h"
 #include "source/extensions/load_balancing_policies/subset/subset_lb.h"
 
 #include "test/benchmark/main.h"
@@ -20,6 +22,7 @@
 #include "test/mocks/upstream/load_balancer.h"
 #include "test/test_common/simulated_time_system.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/types/optional.h"
 #include "benchmark/benchmark.h"
 
@@ -120,6 +123,181 @@ BENCHMARK(benchmarkSubsetLoadBalancerUpdate)
     ->Ranges({{false, true}, {50, 2500}})
     ->Unit(::benchmark::kMillisecond);
 
+// Hosts with ten metadata keys, where key i has i + 2 values, and a selector per key as well as
+// one for the first three keys together, as a cluster with many overlapping subsets would have.
+class MultiKeySubsetLbTester : public Event::TestUsingSimulatedTime {
+public:
+  static constexpr uint32_t NumKeys = 10;
+
+  MultiKeySubsetLbTester(uint32_t num_hosts, bool host_bitmap_index) {
+    Upstream::HostVector hosts;
+    hosts.reserve(num_hosts);
+    for (uint32_t i = 0; i < num_hosts; ++i) {
+      envoy::config::core::v3::Metadata metadata;
+      ProtobufWkt::Struct& fields =
+          (*metadata.mutable_filter_metadata())[Config::MetadataFilters::get().ENVOY_LB];
+      for (uint32_t key = 0; key < NumKeys; ++key) {
+        (*fields.mutable_fields())[keyName(key)].set_string_value(
+            absl::StrCat("value", (i / (key + 1)) % (key + 2)));
+      }
+      hosts.push_back(Upstream::makeTestHost(
+          info_, fmt::format("tcp://10.{}.{}.{}:80", i / 65536, (i / 256) % 256, i % 256),
+          metadata, simTime()));
+    }
+    orig_hosts_ = std::make_shared<Upstream::HostVector>(hosts);
+    smaller_hosts_ = std::make_shared<Upstream::HostVector>(hosts.begin() + 1, hosts.end());
+    host_moved_ = {hosts[0]};
+    priority_set_.updateHosts(0,
+                              Upstream::HostSetImpl::partitionHosts(
+                                  orig_hosts_, Upstream::HostsPerLocalityImpl::empty()),
+                              {}, hosts, {}, random_.random(), absl::nullopt);
+
+    envoy::extensions::load_balancing_policies::subset::v3::Subset subset_config_proto{};
+    subset_config_proto.set_fallback_policy(
+        envoy::extensions::load_balancing_policies::subset::v3::Subset::ANY_ENDPOINT);
+    if (host_bitmap_index) {
+      subset_config_proto.set_subset_index(
+          envoy::extensions::load_balancing_policies::subset::v3::Subset::HOST_BITMAPS);
+    }
+    for (uint32_t key = 0; key < NumKeys; ++key) {
+      subset_config_proto.add_subset_selectors()->add_keys(keyName(key));
+    }
+    auto* selector = subset_config_proto.add_subset_selectors();
+    for (uint32_t key = 0; key < 3; ++key) {
+      selector->add_keys(keyName(key));
+    }
+    auto* child_lb = subset_config_proto.mutable_subset_lb_policy()->mutable_policies()->Add();
+    child_lb->mutable_typed_extension_config()->set_name("envoy.load_balancing_policies.random");
+    envoy::extensions::load_balancing_policies::random::v3::Random random_lb_config;
+    child_lb->mutable_typed_extension_config()->mutable_typed_config()->PackFrom(random_lb_config);
+    NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+
+    absl::Status status = absl::OkStatus();
+    subset_config_ = std::make_unique<Upstream::SubsetLoadBalancerConfig>(
+        factory_context, subset_config_proto, status);
+    ASSERT(status.ok());
+
+    const int64_t memory_before = Memory::Stats::totalCurrentlyAllocated();
+    if (host_bitmap_index) {
+      lb_ = std::make_unique<Upstream::BitmapSubsetLoadBalancer>(*subset_config_, priority_set_,
+                                                                 stats_, random_);
+    } else {
+      lb_ = std::make_unique<Upstream::SubsetLoadBalancer>(*subset_config_, *info_, priority_set_,
+                                                           nullptr, stats_, stats_scope_,
+                                                           runtime_, random_, simTime());
+    }
+    lb_memory_ = Memory::Stats::totalCurrentlyAllocated() - memory_before;
+
+    // Requests for a single key, and for the first three keys together.
+    for (uint32_t i = 0; i < 64; ++i) {
+      ProtobufWkt::Struct matches;
+      if (i % 2 == 0) {
+        const uint32_t key = (i / 2) % NumKeys;
+        (*matches.mutable_fields())[keyName(key)].set_string_value(
+            absl::StrCat("value", i % (key + 2)));
+      } else {
+        for (uint32_t key = 0; key < 3; ++key) {
+          (*matches.mutable_fields())[keyName(key)].set_string_value(
+              absl::StrCat("value", (i / (key + 1)) % (key + 2)));
+        }
+      }
+      contexts_.push_back(std::make_unique<MetadataMatchContext>(matches));
+    }
+  }
+
+  static std::string keyName(uint32_t key) { return absl::StrCat("key", key); }
+
+  // Remove a host and add it back.
+  void update() {
+    priority_set_.updateHosts(0,
+                              Upstream::HostSetImpl::partitionHosts(
+                                  smaller_hosts_, Upstream::HostsPerLocalityImpl::empty()),
+                              nullptr, {}, host_moved_, random_.random(), absl::nullopt);
+    priority_set_.updateHosts(0,
+                              Upstream::HostSetImpl::partitionHosts(
+                                  orig_hosts_, Upstream::HostsPerLocalityImpl::empty()),
+                              nullptr, host_moved_, {}, random_.random(), absl::nullopt);
+  }
+
+  class MetadataMatchContext : public Upstream::LoadBalancerContextBase {
+  public:
+    explicit MetadataMatchContext(const ProtobufWkt::Struct& matches) : criteria_(matches) {}
+
+    // Upstream::LoadBalancerContext
+    const Router::MetadataMatchCriteria* metadataMatchCriteria() override { return &criteria_; }
+
+  private:
+    Router::MetadataMatchCriteriaImpl criteria_;
+  };
+
+  Envoy::Thread::MutexBasicLockable lock_;
+  Envoy::Logger::Context logging_context_{spdlog::level::warn,
+                                          Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock_, false};
+  Upstream::PrioritySetImpl priority_set_;
+  Stats::IsolatedStoreImpl stats_store_;
+  Stats::Scope& stats_scope_{*stats_store_.rootScope()};
+  Upstream::ClusterLbStatNames stat_names_{stats_store_.symbolTable()};
+  Upstream::ClusterLbStats stats_{stat_names_, stats_scope_};
+  NiceMock<Runtime::MockLoader> runtime_;
+  Random::RandomGeneratorImpl random_;
+  std::shared_ptr<Upstream::MockClusterInfo> info_{new NiceMock<Upstream::MockClusterInfo>()};
+  std::unique_ptr<Upstream::SubsetLoadBalancerConfig> subset_config_;
+  Upstream::LoadBalancerPtr lb_;
+  int64_t lb_memory_{};
+  Upstream::HostVectorConstSharedPtr orig_hosts_;
+  Upstream::HostVectorConstSharedPtr smaller_hosts_;
+  Upstream::HostVector host_moved_;
+  std::vector<std::unique_ptr<MetadataMatchContext>> contexts_;
+};
+
+// Measures the time it takes to create the load balancer, and the memory it takes, which is only
+// measured when built with tcmalloc.
+void benchmarkMultiKeySubsetLoadBalancerCreate(::benchmark::State& state) {
+  const bool host_bitmap_index = state.range(0);
+  const uint32_t num_hosts = benchmark::skipExpensiveBenchmarks() ? 100 : state.range(1);
+
+  int64_t lb_memory = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    MultiKeySubsetLbTester tester(num_hosts, host_bitmap_index);
+    lb_memory = tester.lb_memory_;
+  }
+  state.counters["lb_memory_bytes"] = lb_memory;
+}
+
+BENCHMARK(benchmarkMultiKeySubsetLoadBalancerCreate)
+    ->ArgsProduct({{false, true}, {1000, 10000}})
+    ->Unit(::benchmark::kMillisecond);
+
+void benchmarkMultiKeySubsetLoadBalancerUpdate(::benchmark::State& state) {
+  const bool host_bitmap_index = state.range(0);
+  const uint32_t num_hosts = benchmark::skipExpensiveBenchmarks() ? 100 : state.range(1);
+
+  MultiKeySubsetLbTester tester(num_hosts, host_bitmap_index);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    tester.update();
+  }
+}
+
+BENCHMARK(benchmarkMultiKeySubsetLoadBalancerUpdate)
+    ->ArgsProduct({{false, true}, {1000, 10000}})
+    ->Unit(::benchmark::kMillisecond);
+
+void benchmarkMultiKeySubsetLoadBalancerChooseHost(::benchmark::State& state) {
+  const bool host_bitmap_index = state.range(0);
+  const uint32_t num_hosts = benchmark::skipExpensiveBenchmarks() ? 100 : state.range(1);
+
+  MultiKeySubsetLbTester tester(num_hosts, host_bitmap_index);
+  size_t i = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    auto& context = *tester.contexts_[i++ % tester.contexts_.size()];
+    ::benchmark::DoNotOptimize(tester.lb_->chooseHost(&context).host);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(benchmarkMultiKeySubsetLoadBalancerChooseHost)
+    ->ArgsProduct({{false, true}, {1000, 10000}});
+
 } // namespace
 } // namespace Subset
 } // namespace LoadBalancingPolices
@@ -9,11 +9,13 @@
 #include "envoy/config/core/v3/base.pb.h"
 #include "envoy/extensions/load_balancing_policies/round_robin/v3/round_robin.pb.h"
 #include "envoy/extensions/load_balancing_policies/round_robin/v3/round_robin.pb.validate.h"
+#include "envoy/extensions/load_balancing_policies/subset/v3/subset.pb.h"
 
 #include "source/common/common/logger.h"
 #include "source/common/config/metadata.h"
 #include "source/common/router/metadatamatchcriteria_impl.h"
 #include "source/common/upstream/upstream_impl.h"
+#include "source/extensions/load_balancing_policies/subset/bitmap_subset_lb.h"
 #include "source/extensions/load_balancing_policies/subset/config.h"
 
 #include "test/common/upstream/utility.h"
@@ -60,6 +62,7 @@ public:
   MOCK_METHOD(bool, panicModeAny, (), (const));
   MOCK_METHOD(bool, listAsAny, (), (const));
   MOCK_METHOD(bool, allowRedundantKeys, (), (const));
+  MOCK_METHOD(bool, hostBitmapIndex, (), (const));
 
   std::vector<SubsetSelectorPtr> subset_selectors_;
 };
@@ -3281,6 +3284,277 @@ TEST_P(SubsetLoadBalancerSingleHostPerSubsetTest, Update) {
 INSTANTIATE_TEST_SUITE_P(UpdateOrderings, SubsetLoadBalancerSingleHostPerSubsetTest,
                          testing::ValuesIn({UpdateOrder::RemovesFirst, UpdateOrder::Simultaneous}));
 
+class BitmapSubsetLoadBalancerTest : public Event::TestUsingSimulatedTime, public testing::Test {
+public:
+  BitmapSubsetLoadBalancerTest()
+      : stat_names_(stats_store_.symbolTable()), stats_(stat_names_, *stats_store_.rootScope()) {}
+
+  absl::Status loadConfig(const std::string& yaml,
+                          const std::string& child_lb_name = "random.v3.Random") {
+    envoy::extensions::load_balancing_policies::subset::v3::Subset config;
+    TestUtility::loadFromYaml(fmt::format(R"EOF(
+{}
+subset_index: HOST_BITMAPS
+subset_lb_policy:
+  policies:
+  - typed_extension_config:
+      name: child
+      typed_config:
+        "@type": type.googleapis.com/envoy.extensions.load_balancing_policies.{}
+)EOF",
+                                          yaml, child_lb_name),
+                              config);
+    absl::Status status;
+    lb_config_ = std::make_unique<SubsetLoadBalancerConfig>(server_context_, config, status);
+    return status;
+  }
+
+  void init(const std::string& yaml) {
+    ASSERT_TRUE(loadConfig(yaml).ok());
+    ASSERT_TRUE(lb_config_->subsetInfo().hostBitmapIndex());
+    lb_ = std::make_unique<BitmapSubsetLoadBalancer>(*lb_config_, priority_set_, stats_, random_);
+  }
+
+  HostSharedPtr makeHost(const std::string& url,
+                         const std::map<std::string, std::string>& metadata, uint32_t weight = 1) {
+    envoy::config::core::v3::Metadata m;
+    for (const auto& [key, value] : metadata) {
+      Config::Metadata::mutableMetadataValue(m, Config::MetadataFilters::get().ENVOY_LB, key)
+          .set_string_value(value);
+    }
+    return makeTestHost(info_, url, m, simTime(), weight);
+  }
+
+  HostConstSharedPtr chooseHost(LoadBalancerContext* context, uint64_t random) {
+    EXPECT_CALL(random_, random()).WillOnce(Return(random));
+    return lb_->chooseHost(context).host;
+  }
+
+  NiceMock<Server::Configuration::MockServerFactoryContext> server_context_;
+  NiceMock<MockPrioritySet> priority_set_;
+  MockHostSet& host_set_ = *priority_set_.getMockHostSet(0);
+  std::shared_ptr<MockClusterInfo> info_{new NiceMock<MockClusterInfo>()};
+  NiceMock<Random::MockRandomGenerator> random_;
+  Stats::IsolatedStoreImpl stats_store_;
+  ClusterLbStatNames stat_names_;
+  ClusterLbStats stats_;
+  std::unique_ptr<SubsetLoadBalancerConfig> lb_config_;
+  std::unique_ptr<BitmapSubsetLoadBalancer> lb_;
+};
+
+TEST_F(BitmapSubsetLoadBalancerTest, SelectsSubsets) {
+  host_set_.hosts_ = {makeHost("tcp://127.0.0.1:80", {{"version", "1.0"}, {"stage", "prod"}}),
+                      makeHost("tcp://127.0.0.1:81", {{"version", "1.0"}, {"stage", "dev"}}),
+                      makeHost("tcp://127.0.0.1:82", {{"version", "1.1"}, {"stage", "prod"}})};
+  init(R"EOF(
+fallback_policy: ANY_ENDPOINT
+subset_selectors:
+- keys: ["version"]
+- keys: ["stage", "version"]
+)EOF");
+
+  TestLoadBalancerContext context_10({{"version", "1.0"}});
+  TestLoadBalancerContext context_11_prod({{"version", "1.1"}, {"stage", "prod"}});
+  EXPECT_EQ(host_set_.hosts_[0], chooseHost(&context_10, 0));
+  EXPECT_EQ(host_set_.hosts_[1], chooseHost(&context_10, 1));
+  EXPECT_EQ(host_set_.hosts_[2], chooseHost(&context_11_prod, 5));
+
+  EXPECT_EQ(3U, stats_.lb_subsets_selected_.value());
+  EXPECT_EQ(2U, stats_.lb_subsets_created_.value());
+  EXPECT_EQ(2U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(2U, lb_->cachedSubsets());
+}
+
+TEST_F(BitmapSubsetLoadBalancerTest, FallbackAnyEndpoint) {
+  host_set_.hosts_ = {makeHost("tcp://127.0.0.1:80", {{"version", "1.0"}}),
+                      makeHost("tcp://127.0.0.1:81", {{"version", "1.1"}})};
+  init(R"EOF(
+fallback_policy: ANY_ENDPOINT
+subset_selectors:
+- keys: ["version"]
+)EOF");
+
+  TestLoadBalancerContext context_12({{"version", "1.2"}});
+  TestLoadBalancerContext context_unknown_key({{"stage", "prod"}});
+  EXPECT_EQ(host_set_.hosts_[1], chooseHost(&context_12, 1));
+  EXPECT_EQ(host_set_.hosts_[0], chooseHost(&context_unknown_key, 0));
+  EXPECT_EQ(host_set_.hosts_[1], chooseHost(nullptr, 1));
+
+  EXPECT_EQ(3U, stats_.lb_subsets_fallback_.value());
+  EXPECT_EQ(0U, stats_.lb_subsets_selected_.value());
+}
+
+TEST_F(BitmapSubsetLoadBalancerTest, FallbackDefaultSubset) {
+  host_set_.hosts_ = {makeHost("tcp://127.0.0.1:80", {{"version", "1.0"}, {"stage", "prod"}}),
+                      makeHost("tcp://127.0.0.1:81", {{"version", "1.0"}, {"stage", "dev"}})};
+  init(R"EOF(
+fallback_policy: DEFAULT_SUBSET
+default_subset:
+  stage: dev
+subset_selectors:
+- keys: ["version"]
+)EOF");
+
+  TestLoadBalancerContext context_11({{"version", "1.1"}});
+  EXPECT_EQ(host_set_.hosts_[1], chooseHost(&context_11, 0));
+  EXPECT_EQ(1U, stats_.lb_subsets_fallback_.value());
+}
+
+TEST_F(BitmapSubsetLoadBalancerTest, NoFallback) {
+  host_set_.hosts_ = {makeHost("tcp://127.0.0.1:80", {{"version", "1.0"}})};
+  init(R"EOF(
+fallback_policy: NO_FALLBACK
+subset_selectors:
+- keys: ["version"]
+)EOF");
+
+  TestLoadBalancerContext context_11({{"version", "1.1"}});
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context_11).host);
+  EXPECT_EQ(nullptr, lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(0U, stats_.lb_subsets_fallback_.value());
+}
+
+// Picks hosts in proportion to their weights, across several words of the bitmap.
+TEST_F(BitmapSubsetLoadBalancerTest, WeightedPick) {
+  HostVector hosts;
+  for (uint32_t i = 0; i < 130; ++i) {
+    hosts.push_back(makeHost(fmt::format("tcp://127.0.0.1:{}", 1000 + i), {{"version", "1.0"}},
+                             i == 100 ? 10 : 1));
+  }
+  host_set_.hosts_ = hosts;
+  init(R"EOF(
+subset_selectors:
+- keys: ["version"]
+)EOF");
+
+  // The total weight is 139, so the random values wrap around at 139.
+  TestLoadBalancerContext context_10({{"version", "1.0"}});
+  EXPECT_EQ(hosts[0], chooseHost(&context_10, 139));
+  EXPECT_EQ(hosts[63], chooseHost(&context_10, 63));
+  EXPECT_EQ(hosts[64], chooseHost(&context_10, 64));
+  EXPECT_EQ(hosts[99], chooseHost(&context_10, 99));
+  EXPECT_EQ(hosts[100], chooseHost(&context_10, 100));
+  EXPECT_EQ(hosts[100], chooseHost(&context_10, 109));
+  EXPECT_EQ(hosts[101], chooseHost(&context_10, 110));
+  EXPECT_EQ(hosts[129], chooseHost(&context_10, 138));
+}
+
+TEST_F(BitmapSubsetLoadBalancerTest, HostUpdateClearsSubsets) {
+  host_set_.hosts_ = {makeHost("tcp://127.0.0.1:80", {{"version", "1.0"}})};
+  init(R"EOF(
+fallback_policy: ANY_ENDPOINT
+subset_selectors:
+- keys: ["version"]
+)EOF");
+
+  TestLoadBalancerContext context_11({{"version", "1.1"}});
+  EXPECT_EQ(host_set_.hosts_[0], chooseHost(&context_11, 0));
+  EXPECT_EQ(1U, stats_.lb_subsets_active_.value());
+
+  HostSharedPtr added = makeHost("tcp://127.0.0.1:81", {{"version", "1.1"}});
+  host_set_.hosts_.push_back(added);
+  host_set_.runCallbacks({added}, {});
+  EXPECT_EQ(1U, stats_.lb_subsets_removed_.value());
+  EXPECT_EQ(0U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(0U, lb_->cachedSubsets());
+
+  EXPECT_EQ(added, chooseHost(&context_11, 0));
+  EXPECT_EQ(1U, stats_.lb_subsets_selected_.value());
+  EXPECT_EQ(1U, stats_.lb_subsets_active_.value());
+}
+
+// Prefers the healthy hosts of a subset, then the first priority with healthy hosts in the subset,
+// and otherwise panics over all of the hosts of the subset in the first priority.
+TEST_F(BitmapSubsetLoadBalancerTest, PrefersHealthyHosts) {
+  MockHostSet& failover_host_set = *priority_set_.getMockHostSet(1);
+  host_set_.hosts_ = {makeHost("tcp://127.0.0.1:80", {{"version", "1.0"}}),
+                      makeHost("tcp://127.0.0.1:81", {{"version", "1.0"}}),
+                      makeHost("tcp://127.0.0.1:82", {{"version", "1.1"}})};
+  failover_host_set.hosts_ = {makeHost("tcp://127.0.0.1:83", {{"version", "1.1"}})};
+  host_set_.hosts_[0]->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+  host_set_.hosts_[2]->healthFlagSet(Host::HealthFlag::FAILED_OUTLIER_CHECK);
+  init(R"EOF(
+subset_selectors:
+- keys: ["version"]
+)EOF");
+
+  TestLoadBalancerContext context_10({{"version", "1.0"}});
+  TestLoadBalancerContext context_11({{"version", "1.1"}});
+  EXPECT_EQ(host_set_.hosts_[1], chooseHost(&context_10, 0));
+  EXPECT_EQ(failover_host_set.hosts_[0], chooseHost(&context_11, 0));
+
+  failover_host_set.hosts_[0]->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+  failover_host_set.runCallbacks({}, {});
+  EXPECT_EQ(host_set_.hosts_[2], chooseHost(&context_11, 0));
+}
+
+TEST_F(BitmapSubsetLoadBalancerTest, PanicModeAny) {
+  host_set_.hosts_ = {makeHost("tcp://127.0.0.1:80", {{"version", "1.0"}})};
+  init(R"EOF(
+fallback_policy: DEFAULT_SUBSET
+default_subset:
+  version: "1.1"
+panic_mode_any: true
+subset_selectors:
+- keys: ["version"]
+)EOF");
+
+  TestLoadBalancerContext context_12({{"version", "1.2"}});
+  EXPECT_EQ(host_set_.hosts_[0], chooseHost(&context_12, 0));
+  EXPECT_EQ(1U, stats_.lb_subsets_fallback_panic_.value());
+}
+
+TEST_F(BitmapSubsetLoadBalancerTest, AllowRedundantKeys) {
+  host_set_.hosts_ = {makeHost("tcp://127.0.0.1:80", {{"version", "1.0"}}),
+                      makeHost("tcp://127.0.0.1:81", {{"version", "1.1"}})};
+  init(R"EOF(
+allow_redundant_keys: true
+subset_selectors:
+- keys: ["version"]
+)EOF");
+
+  TestLoadBalancerContext context({{"version", "1.1"}, {"stage", "prod"}});
+  EXPECT_EQ(host_set_.hosts_[1], chooseHost(&context, 0));
+  EXPECT_EQ(1U, stats_.lb_subsets_selected_.value());
+}
+
+TEST_F(BitmapSubsetLoadBalancerTest, ListAsAny) {
+  envoy::config::core::v3::Metadata metadata;
+  auto& versions = Config::Metadata::mutableMetadataValue(
+      metadata, Config::MetadataFilters::get().ENVOY_LB, "version");
+  versions.mutable_list_value()->add_values()->set_string_value("1.0");
+  versions.mutable_list_value()->add_values()->set_string_value("1.1");
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", metadata, simTime()),
+                      makeHost("tcp://127.0.0.1:81", {{"version", "1.1"}})};
+  init(R"EOF(
+list_as_any: true
+subset_selectors:
+- keys: ["version"]
+)EOF");
+
+  TestLoadBalancerContext context_10({{"version", "1.0"}});
+  TestLoadBalancerContext context_11({{"version", "1.1"}});
+  EXPECT_EQ(host_set_.hosts_[0], chooseHost(&context_10, 1));
+  EXPECT_EQ(host_set_.hosts_[0], chooseHost(&context_11, 0));
+  EXPECT_EQ(host_set_.hosts_[1], chooseHost(&context_11, 1));
+}
+
+TEST_F(BitmapSubsetLoadBalancerTest, UnsupportedConfig) {
+  EXPECT_EQ("subset lb: the HOST_BITMAPS subset index requires the random subset lb policy, not "
+            "envoy.load_balancing_policies.round_robin",
+            loadConfig("subset_selectors: [{keys: [version]}]", "round_robin.v3.RoundRobin")
+                .message());
+  EXPECT_EQ("subset lb: the HOST_BITMAPS subset index does not support locality weights",
+            loadConfig("locality_weight_aware: true").message());
+  EXPECT_EQ("subset lb: the HOST_BITMAPS subset index does not support the FALLBACK_LIST metadata "
+            "fallback policy",
+            loadConfig("metadata_fallback_policy: FALLBACK_LIST").message());
+  EXPECT_EQ("subset lb: the HOST_BITMAPS subset index does not support single host subsets or "
+            "selector fallback policies",
+            loadConfig("subset_selectors: [{keys: [version], fallback_policy: ANY_ENDPOINT}]")
+                .message());
+}
+
 // Test to improve coverage of the SubsetLoadBalancerFactory.
 TEST(LoadBalancerContextWrapperTest, LoadBalancingContextWrapperTest) {
   testing::NiceMock<Upstream::MockLoadBalancerContext> mock_context;
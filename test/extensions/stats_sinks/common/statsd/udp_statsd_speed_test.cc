@@ -0,0 +1,105 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures the CPU time and the system calls of flushing many metrics through the UDP statsd sink,
+// with one metric per datagram or with lines packed into MTU sized datagrams.
+
+#include <memory>
+#include <vector>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/stat_sinks/common/statsd/statsd.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/network_utility.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace Common {
+namespace Statsd {
+namespace {
+
+// Counts the system calls which send datagrams.
+class CountingOsSysCalls : public Api::OsSysCallsImpl {
+public:
+  Api::SysCallSizeResult sendmsg(os_fd_t fd, const msghdr* message, int flags) override {
+    syscalls_++;
+    return Api::OsSysCallsImpl::sendmsg(fd, message, flags);
+  }
+  Api::SysCallIntResult sendmmsg(os_fd_t fd, struct mmsghdr* msgvec, unsigned int vlen,
+                                 int flags) override {
+    syscalls_++;
+    return Api::OsSysCallsImpl::sendmmsg(fd, msgvec, vlen, flags);
+  }
+
+  uint64_t syscalls_{};
+};
+
+class UdpStatsdSpeedTest {
+public:
+  UdpStatsdSpeedTest(uint32_t num_metrics, uint64_t max_bytes_per_datagram)
+      : server_(Network::Address::IpVersion::v4),
+        sink_(tls_, server_.localAddress(), true, getDefaultPrefix(),
+              max_bytes_per_datagram > 0 ? absl::make_optional(max_bytes_per_datagram)
+                                         : absl::nullopt,
+              getDefaultTagFormat(), store_.symbolTable()) {
+    // Half of the metrics are counters, and the other half gauges.
+    for (uint32_t i = 0; i < num_metrics / 2; ++i) {
+      Stats::Counter& counter =
+          store_.rootScope()->counterFromString(absl::StrCat("cluster.c", i, ".upstream_rq"));
+      counter.inc();
+      snapshot_.counters_.push_back({1, counter});
+      Stats::Gauge& gauge =
+          store_.rootScope()->gaugeFromString(absl::StrCat("cluster.c", i, ".upstream_cx_active"),
+                                              Stats::Gauge::ImportMode::Accumulate);
+      gauge.set(i);
+      snapshot_.gauges_.push_back(gauge);
+    }
+  }
+
+  ~UdpStatsdSpeedTest() { tls_.shutdownThread(); }
+
+  void flush() { sink_.flush(snapshot_); }
+
+private:
+  Stats::IsolatedStoreImpl store_;
+  testing::NiceMock<ThreadLocal::MockInstance> tls_;
+  testing::NiceMock<Stats::MockMetricSnapshot> snapshot_;
+  Network::Test::UdpSyncPeer server_;
+  UdpStatsdSink sink_;
+};
+
+static void udpStatsdFlush(::benchmark::State& state) {
+  CountingOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_injector(&os_sys_calls);
+
+  const uint32_t num_metrics = benchmark::skipExpensiveBenchmarks() ? 10000 : 500000;
+  UdpStatsdSpeedTest speed_test(num_metrics, state.range(0));
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    speed_test.flush();
+  }
+  state.counters["syscalls_per_flush"] =
+      static_cast<double>(os_sys_calls.syscalls_) / state.iterations();
+  state.SetItemsProcessed(state.iterations() * num_metrics);
+}
+
+BENCHMARK(udpStatsdFlush)
+    ->Arg(0)
+    ->Arg(1432)
+    ->ArgNames({"max_bytes_per_datagram"})
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace
+} // namespace Statsd
+} // namespace Common
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
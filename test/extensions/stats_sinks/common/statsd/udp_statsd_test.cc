@@ -10,17 +10,20 @@
 #include "source/extensions/stat_sinks/common/statsd/statsd.h"
 #include "source/extensions/stat_sinks/common/statsd/tag_formats.h"
 
+#include "test/common/stats/stat_test_utility.h"
 #include "test/mocks/stats/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/network_utility.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_split.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "spdlog/spdlog.h"
 
 using testing::NiceMock;
+using testing::UnorderedElementsAre;
 
 namespace Envoy {
 namespace Extensions {
@@ -143,6 +146,35 @@ TEST_P(UdpStatsdSinkTest, InitWithIpAddress) {
   tls_.shutdownThread();
 }
 
+TEST_P(UdpStatsdSinkTest, PackedDatagrams) {
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  Network::Test::UdpSyncPeer server(GetParam());
+  Stats::TestUtil::TestSymbolTable symbol_table;
+  UdpStatsdSink sink(tls_, server.localAddress(), false, getDefaultPrefix(), 50,
+                     getDefaultTagFormat(), *symbol_table);
+
+  std::vector<std::unique_ptr<NiceMock<Stats::MockCounter>>> counters;
+  for (int i = 0; i < 5; ++i) {
+    counters.push_back(std::make_unique<NiceMock<Stats::MockCounter>>());
+    counters.back()->name_ = absl::StrCat("test_counter_", i);
+    counters.back()->used_ = true;
+    snapshot.counters_.push_back({1, *counters.back()});
+  }
+
+  // Two lines fit in a datagram, and the three datagrams are written at once.
+  sink.flush(snapshot);
+  for (absl::string_view expected :
+       {"envoy.test_counter_0:1|c\nenvoy.test_counter_1:1|c",
+        "envoy.test_counter_2:1|c\nenvoy.test_counter_3:1|c", "envoy.test_counter_4:1|c"}) {
+    Network::UdpRecvData data;
+    server.recv(data);
+    EXPECT_EQ(expected, data.buffer_->toString());
+  }
+
+  tls_.shutdownThread();
+}
+
 class UdpStatsdSinkWithTagsTest : public testing::TestWithParam<Network::Address::IpVersion> {};
 INSTANTIATE_TEST_SUITE_P(IpVersions, UdpStatsdSinkWithTagsTest,
                          testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
@@ -435,6 +467,111 @@ TEST(UdpStatsdSinkTest, ScaledPercent) {
   tls_.shutdownThread();
 }
 
+TEST(UdpStatsdSinkTest, CachedLineFormats) {
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
+  writer_ptr->delegateBufferFake();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Stats::TestUtil::TestSymbolTable symbol_table;
+  UdpStatsdSink sink(tls_, writer_ptr, true, getDefaultPrefix(), 1024, getDefaultTagFormat(),
+                     *symbol_table);
+
+  NiceMock<Stats::MockCounter> counter;
+  counter.name_ = "test_counter";
+  counter.used_ = true;
+  counter.setTags({{"key", "value"}});
+  snapshot.counters_.push_back({1, counter});
+
+  NiceMock<Stats::MockGauge> gauge;
+  gauge.name_ = "test_gauge";
+  gauge.value_ = 1;
+  gauge.used_ = true;
+  snapshot.gauges_.push_back(gauge);
+
+  sink.flush(snapshot);
+  EXPECT_EQ(2U, sink.cachedMetricsForTest());
+  sink.flush(snapshot);
+  EXPECT_EQ(2U, sink.cachedMetricsForTest());
+  EXPECT_EQ(writer_ptr->buffer_writes.size(), 2);
+  EXPECT_EQ(writer_ptr->buffer_writes.at(1),
+            "envoy.test_counter:1|c|#key:value\nenvoy.test_gauge:1|g");
+
+  // Metrics which aren't flushed anymore are evicted.
+  gauge.used_ = false;
+  sink.flush(snapshot);
+  EXPECT_EQ(1U, sink.cachedMetricsForTest());
+  EXPECT_EQ(writer_ptr->buffer_writes.at(2), "envoy.test_counter:1|c|#key:value");
+
+  tls_.shutdownThread();
+}
+
+TEST(UdpStatsdSinkTest, HistogramsAsDistributions) {
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
+  writer_ptr->delegateBufferFake();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Stats::TestUtil::TestSymbolTable symbol_table;
+  UdpStatsdSink sink(tls_, writer_ptr, true, getDefaultPrefix(), 1024, getDefaultTagFormat(),
+                     *symbol_table, true);
+
+  NiceMock<Stats::MockHistogram> timer;
+  timer.name_ = "test_timer";
+  timer.setTags({{"key", "value"}});
+  NiceMock<Stats::MockHistogram> items;
+  items.name_ = "items";
+  items.unit_ = Stats::Histogram::Unit::Percent;
+
+  // The values are aggregated until the next flush.
+  EXPECT_CALL(*writer_ptr, write(_)).Times(0);
+  sink.onHistogramComplete(timer, 5);
+  sink.onHistogramComplete(items, Stats::Histogram::PercentScale / 2);
+  sink.onHistogramComplete(timer, 7);
+
+  sink.flush(snapshot);
+  ASSERT_EQ(writer_ptr->buffer_writes.size(), 1);
+  EXPECT_THAT(absl::StrSplit(writer_ptr->buffer_writes.at(0), '\n'),
+              UnorderedElementsAre("envoy.test_timer:5:7|d|#key:value", "envoy.items:0.5|d"));
+
+  // Histograms which didn't record any value aren't sent.
+  sink.onHistogramComplete(timer, 9);
+  sink.flush(snapshot);
+  ASSERT_EQ(writer_ptr->buffer_writes.size(), 2);
+  EXPECT_EQ(writer_ptr->buffer_writes.at(1), "envoy.test_timer:9|d|#key:value");
+
+  sink.flush(snapshot);
+  EXPECT_EQ(writer_ptr->buffer_writes.size(), 2);
+
+  tls_.shutdownThread();
+}
+
+TEST(UdpStatsdSinkTest, DistributionLinesAreSplitAtMaxSize) {
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
+  writer_ptr->delegateBufferFake();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Stats::TestUtil::TestSymbolTable symbol_table;
+  UdpStatsdSink sink(tls_, writer_ptr, false, getDefaultPrefix(), 24, getDefaultTagFormat(),
+                     *symbol_table, true);
+
+  NiceMock<Stats::MockHistogram> timer;
+  timer.name_ = "timer";
+  // Full lines are written as soon as they are full, rather than buffered until the next flush.
+  std::vector<std::string> full_lines;
+  EXPECT_CALL(*writer_ptr, write(_)).WillRepeatedly([&full_lines](const std::string& message) {
+    full_lines.push_back(message);
+  });
+  for (uint64_t value = 10; value < 20; ++value) {
+    sink.onHistogramComplete(timer, value);
+  }
+  EXPECT_THAT(full_lines, testing::ElementsAre("envoy.timer:10:11:12|d", "envoy.timer:13:14:15|d",
+                                               "envoy.timer:16:17:18|d"));
+
+  sink.flush(snapshot);
+  EXPECT_THAT(writer_ptr->buffer_writes, testing::ElementsAre("envoy.timer:19|d"));
+
+  tls_.shutdownThread();
+}
+
 TEST(UdpStatsdSinkWithTagsTest, CheckActualStats) {
   NiceMock<Stats::MockMetricSnapshot> snapshot;
   auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
@@ -113,6 +113,33 @@ TEST_P(DogStatsdConfigLoopbackTest, DefaultBufferSize) {
   ASSERT_NE(udp_sink, nullptr);
   // Expect default buffer size of 0 (no buffering)
   EXPECT_EQ(udp_sink->getBufferSizeForTest(), 0);
+  EXPECT_FALSE(udp_sink->getHistogramsAsDistributionsForTest());
+}
+
+TEST_P(DogStatsdConfigLoopbackTest, HistogramsAsDistributions) {
+  envoy::config::metrics::v3::DogStatsdSink sink_config;
+  sink_config.set_histograms_as_distributions(true);
+  envoy::config::core::v3::Address& address = *sink_config.mutable_address();
+  envoy::config::core::v3::SocketAddress& socket_address = *address.mutable_socket_address();
+  socket_address.set_protocol(envoy::config::core::v3::SocketAddress::UDP);
+  Network::Address::InstanceConstSharedPtr loopback_flavor =
+      Network::Test::getCanonicalLoopbackAddress(GetParam());
+  socket_address.set_address(loopback_flavor->ip()->addressAsString());
+  socket_address.set_port_value(8125);
+
+  Server::Configuration::StatsSinkFactory* factory =
+      Registry::FactoryRegistry<Server::Configuration::StatsSinkFactory>::getFactory(DogStatsdName);
+  ASSERT_NE(factory, nullptr);
+
+  ProtobufTypes::MessagePtr message = factory->createEmptyConfigProto();
+  TestUtility::jsonConvert(sink_config, *message);
+
+  NiceMock<Server::Configuration::MockServerFactoryContext> server;
+  Stats::SinkPtr sink = factory->createStatsSink(*message, server).value();
+  ASSERT_NE(sink, nullptr);
+  auto udp_sink = dynamic_cast<Common::Statsd::UdpStatsdSink*>(sink.get());
+  ASSERT_NE(udp_sink, nullptr);
+  EXPECT_TRUE(udp_sink->getHistogramsAsDistributionsForTest());
 }
 
 TEST_P(DogStatsdConfigLoopbackTest, WithCustomPrefix) {
@@ -0,0 +1,117 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures the cost of turning a snapshot of many counters, of which only some changed since the
+// previous flush, into OTLP export requests.
+
+#include <memory>
+#include <vector>
+
+#include "envoy/stats/sink.h"
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/stat_sinks/open_telemetry/open_telemetry_impl.h"
+
+#include "test/benchmark/main.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace OpenTelemetry {
+namespace {
+
+class BenchmarkSnapshot : public Stats::MetricSnapshot {
+public:
+  // Stats::MetricSnapshot
+  const std::vector<CounterSnapshot>& counters() override { return counters_; }
+  const std::vector<std::reference_wrapper<const Stats::Gauge>>& gauges() override {
+    return gauges_;
+  }
+  const std::vector<std::reference_wrapper<const Stats::ParentHistogram>>& histograms() override {
+    return histograms_;
+  }
+  const std::vector<std::reference_wrapper<const Stats::TextReadout>>& textReadouts() override {
+    return text_readouts_;
+  }
+  const std::vector<Stats::PrimitiveCounterSnapshot>& hostCounters() override {
+    return host_counters_;
+  }
+  const std::vector<Stats::PrimitiveGaugeSnapshot>& hostGauges() override {
+    return host_gauges_;
+  }
+  SystemTime snapshotTime() const override { return SystemTime(); }
+
+  std::vector<CounterSnapshot> counters_;
+
+private:
+  std::vector<std::reference_wrapper<const Stats::Gauge>> gauges_;
+  std::vector<std::reference_wrapper<const Stats::ParentHistogram>> histograms_;
+  std::vector<std::reference_wrapper<const Stats::TextReadout>> text_readouts_;
+  std::vector<Stats::PrimitiveCounterSnapshot> host_counters_;
+  std::vector<Stats::PrimitiveGaugeSnapshot> host_gauges_;
+};
+
+class OtlpFlushSpeedTest {
+public:
+  OtlpFlushSpeedTest(uint32_t num_counters, bool report_counters_as_deltas) {
+    envoy::extensions::stat_sinks::open_telemetry::v3::SinkConfig sink_config;
+    sink_config.set_report_counters_as_deltas(report_counters_as_deltas);
+    flusher_ = std::make_unique<OtlpMetricsFlusherImpl>(std::make_shared<OtlpOptions>(sink_config),
+                                                        store_.symbolTable(),
+                                                        [](const auto&) { return true; });
+    counters_.reserve(num_counters);
+    for (uint32_t i = 0; i < num_counters; ++i) {
+      counters_.push_back(
+          &store_.rootScope()->counterFromString(absl::StrCat("cluster.c", i, ".upstream_rq")));
+    }
+  }
+
+  // Increments one counter out of every ten, and latches the deltas of all of them.
+  void updateSnapshot() {
+    for (uint32_t i = 0; i < counters_.size(); i += 10) {
+      counters_[i]->inc();
+    }
+    snapshot_.counters_.clear();
+    for (Stats::Counter* counter : counters_) {
+      snapshot_.counters_.push_back({counter->latch(), *counter});
+    }
+  }
+
+  // @return the number of export requests.
+  size_t flush() { return flusher_->flush(snapshot_).size(); }
+
+private:
+  Stats::IsolatedStoreImpl store_;
+  std::vector<Stats::Counter*> counters_;
+  BenchmarkSnapshot snapshot_;
+  std::unique_ptr<OtlpMetricsFlusherImpl> flusher_;
+};
+
+static void otlpFlushCounters(::benchmark::State& state) {
+  const uint32_t num_counters = benchmark::skipExpensiveBenchmarks() ? 10000 : 1000000;
+  OtlpFlushSpeedTest speed_test(num_counters, state.range(0) != 0);
+  size_t requests = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    speed_test.updateSnapshot();
+    state.ResumeTiming();
+    requests += speed_test.flush();
+  }
+  state.counters["requests_per_flush"] = static_cast<double>(requests) / state.iterations();
+  state.SetItemsProcessed(state.iterations() * num_counters);
+}
+
+BENCHMARK(otlpFlushCounters)
+    ->Arg(0)
+    ->Arg(1)
+    ->ArgNames({"delta"})
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace
+} // namespace OpenTelemetry
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
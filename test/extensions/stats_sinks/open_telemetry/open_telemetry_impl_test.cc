@@ -3,10 +3,14 @@
 #include "source/common/tracing/null_span_impl.h"
 #include "source/extensions/stat_sinks/open_telemetry/open_telemetry_impl.h"
 
+#include "test/common/stats/stat_test_utility.h"
 #include "test/mocks/common.h"
 #include "test/mocks/grpc/mocks.h"
 #include "test/mocks/stats/mocks.h"
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/test_runtime.h"
+
+#include "absl/strings/str_cat.h"
 
 using testing::_;
 using testing::ByMove;
@@ -39,13 +43,17 @@ public:
                                          bool report_histograms_as_deltas = false,
                                          bool emit_tags_as_attributes = true,
                                          bool use_tag_extracted_name = true,
-                                         const std::string& stat_prefix = "") {
+                                         const std::string& stat_prefix = "",
+                                         uint32_t max_export_request_bytes = 0) {
     envoy::extensions::stat_sinks::open_telemetry::v3::SinkConfig sink_config;
     sink_config.set_report_counters_as_deltas(report_counters_as_deltas);
     sink_config.set_report_histograms_as_deltas(report_histograms_as_deltas);
     sink_config.mutable_emit_tags_as_attributes()->set_value(emit_tags_as_attributes);
     sink_config.mutable_use_tag_extracted_name()->set_value(use_tag_extracted_name);
     sink_config.set_prefix(stat_prefix);
+    if (max_export_request_bytes > 0) {
+      sink_config.mutable_max_export_request_bytes()->set_value(max_export_request_bytes);
+    }
 
     return std::make_shared<OtlpOptions>(sink_config);
   }
@@ -136,6 +144,7 @@ public:
     snapshot_.histograms_.push_back(*histogram_storage_.back());
   }
 
+  Stats::TestUtil::TestSymbolTable symbol_table_;
   long long int expected_time_ns_;
   std::vector<histogram_t*> histogram_ptrs_;
   std::vector<std::unique_ptr<Stats::HistogramStatisticsImpl>> hist_stats_;
@@ -169,6 +178,12 @@ TEST_F(OpenTelemetryGrpcMetricsExporterImplTest, PartialSuccess) {
 
 class OtlpMetricsFlusherTests : public OpenTelemetryStatsSinkTests {
 public:
+  MetricsExportRequestSharedPtr flushOne(OtlpMetricsFlusher& flusher) {
+    std::vector<MetricsExportRequestPtr> requests = flusher.flush(snapshot_);
+    EXPECT_EQ(1U, requests.size());
+    return std::move(requests[0]);
+  }
+
   void expectMetricsCount(MetricsExportRequestSharedPtr& request, int count) {
     EXPECT_EQ(1, request->resource_metrics().size());
     EXPECT_EQ(1, request->resource_metrics()[0].scope_metrics().size());
@@ -254,7 +269,7 @@ public:
 };
 
 TEST_F(OtlpMetricsFlusherTests, MetricsWithDefaultOptions) {
-  OtlpMetricsFlusherImpl flusher(otlpOptions());
+  OtlpMetricsFlusherImpl flusher(otlpOptions(), *symbol_table_);
 
   addCounterToSnapshot("test_counter", 1, 1);
   addHostCounterToSnapshot("test_host_counter", 2, 3);
@@ -262,7 +277,7 @@ TEST_F(OtlpMetricsFlusherTests, MetricsWithDefaultOptions) {
   addHostGaugeToSnapshot("test_host_gauge", 4);
   addHistogramToSnapshot("test_histogram");
 
-  MetricsExportRequestSharedPtr metrics = flusher.flush(snapshot_);
+  MetricsExportRequestSharedPtr metrics = flushOne(flusher);
   expectMetricsCount(metrics, 5);
 
   {
@@ -296,12 +311,12 @@ TEST_F(OtlpMetricsFlusherTests, MetricsWithDefaultOptions) {
   }
 
   gauge_storage_.back()->used_ = false;
-  metrics = flusher.flush(snapshot_);
+  metrics = flushOne(flusher);
   expectMetricsCount(metrics, 4);
 }
 
 TEST_F(OtlpMetricsFlusherTests, MetricsWithStatsPrefix) {
-  OtlpMetricsFlusherImpl flusher(otlpOptions(false, false, true, true, "prefix"));
+  OtlpMetricsFlusherImpl flusher(otlpOptions(false, false, true, true, "prefix"), *symbol_table_);
 
   addCounterToSnapshot("test_counter", 1, 1);
   addHostCounterToSnapshot("test_host_counter", 1, 1);
@@ -309,7 +324,7 @@ TEST_F(OtlpMetricsFlusherTests, MetricsWithStatsPrefix) {
   addGaugeToSnapshot("test_host_gauge", 1);
   addHistogramToSnapshot("test_histogram");
 
-  MetricsExportRequestSharedPtr metrics = flusher.flush(snapshot_);
+  MetricsExportRequestSharedPtr metrics = flushOne(flusher);
   expectMetricsCount(metrics, 5);
   expectGauge(metricAt(0, metrics), getTagExtractedName("prefix.test_gauge"), 1);
   expectGauge(metricAt(1, metrics), getTagExtractedName("prefix.test_host_gauge"), 1);
@@ -319,13 +334,13 @@ TEST_F(OtlpMetricsFlusherTests, MetricsWithStatsPrefix) {
 }
 
 TEST_F(OtlpMetricsFlusherTests, MetricsWithNoTaggedName) {
-  OtlpMetricsFlusherImpl flusher(otlpOptions(false, false, true, false));
+  OtlpMetricsFlusherImpl flusher(otlpOptions(false, false, true, false), *symbol_table_);
 
   addCounterToSnapshot("test_counter", 1, 1);
   addGaugeToSnapshot("test_gauge", 1);
   addHistogramToSnapshot("test_histogram");
 
-  MetricsExportRequestSharedPtr metrics = flusher.flush(snapshot_);
+  MetricsExportRequestSharedPtr metrics = flushOne(flusher);
   expectMetricsCount(metrics, 3);
   expectGauge(metricAt(0, metrics), "test_gauge", 1);
   expectSum(metricAt(1, metrics), "test_counter", 1, false);
@@ -333,13 +348,13 @@ TEST_F(OtlpMetricsFlusherTests, MetricsWithNoTaggedName) {
 }
 
 TEST_F(OtlpMetricsFlusherTests, MetricsWithNoAttributes) {
-  OtlpMetricsFlusherImpl flusher(otlpOptions(false, false, false, true));
+  OtlpMetricsFlusherImpl flusher(otlpOptions(false, false, false, true), *symbol_table_);
 
   addCounterToSnapshot("test_counter", 1, 1);
   addGaugeToSnapshot("test_gauge", 1);
   addHistogramToSnapshot("test_histogram");
 
-  MetricsExportRequestSharedPtr metrics = flusher.flush(snapshot_);
+  MetricsExportRequestSharedPtr metrics = flushOne(flusher);
   expectMetricsCount(metrics, 3);
 
   {
@@ -362,14 +377,14 @@ TEST_F(OtlpMetricsFlusherTests, MetricsWithNoAttributes) {
 }
 
 TEST_F(OtlpMetricsFlusherTests, GaugeMetric) {
-  OtlpMetricsFlusherImpl flusher(otlpOptions());
+  OtlpMetricsFlusherImpl flusher(otlpOptions(), *symbol_table_);
 
   addGaugeToSnapshot("test_gauge1", 1);
   addGaugeToSnapshot("test_gauge2", 2);
   addHostGaugeToSnapshot("test_host_gauge1", 3);
   addHostGaugeToSnapshot("test_host_gauge2", 4);
 
-  MetricsExportRequestSharedPtr metrics = flusher.flush(snapshot_);
+  MetricsExportRequestSharedPtr metrics = flushOne(flusher);
   expectMetricsCount(metrics, 4);
   expectGauge(metricAt(0, metrics), getTagExtractedName("test_gauge1"), 1);
   expectGauge(metricAt(1, metrics), getTagExtractedName("test_gauge2"), 2);
@@ -378,14 +393,14 @@ TEST_F(OtlpMetricsFlusherTests, GaugeMetric) {
 }
 
 TEST_F(OtlpMetricsFlusherTests, CumulativeCounterMetric) {
-  OtlpMetricsFlusherImpl flusher(otlpOptions());
+  OtlpMetricsFlusherImpl flusher(otlpOptions(), *symbol_table_);
 
   addCounterToSnapshot("test_counter1", 1, 1);
   addCounterToSnapshot("test_counter2", 2, 3);
   addHostCounterToSnapshot("test_host_counter1", 2, 4);
   addHostCounterToSnapshot("test_host_counter2", 5, 10);
 
-  MetricsExportRequestSharedPtr metrics = flusher.flush(snapshot_);
+  MetricsExportRequestSharedPtr metrics = flushOne(flusher);
   expectMetricsCount(metrics, 4);
   expectSum(metricAt(0, metrics), getTagExtractedName("test_counter1"), 1, false);
   expectSum(metricAt(1, metrics), getTagExtractedName("test_counter2"), 3, false);
@@ -394,14 +409,14 @@ TEST_F(OtlpMetricsFlusherTests, CumulativeCounterMetric) {
 }
 
 TEST_F(OtlpMetricsFlusherTests, DeltaCounterMetric) {
-  OtlpMetricsFlusherImpl flusher(otlpOptions(true, false, true, true));
+  OtlpMetricsFlusherImpl flusher(otlpOptions(true, false, true, true), *symbol_table_);
 
   addCounterToSnapshot("test_counter1", 1, 1);
   addCounterToSnapshot("test_counter2", 2, 3);
   addHostCounterToSnapshot("test_host_counter1", 2, 4);
   addHostCounterToSnapshot("test_host_counter2", 5, 10);
 
-  MetricsExportRequestSharedPtr metrics = flusher.flush(snapshot_);
+  MetricsExportRequestSharedPtr metrics = flushOne(flusher);
   expectMetricsCount(metrics, 4);
   expectSum(metricAt(0, metrics), getTagExtractedName("test_counter1"), 1, true);
   expectSum(metricAt(1, metrics), getTagExtractedName("test_counter2"), 2, true);
@@ -410,29 +425,164 @@ TEST_F(OtlpMetricsFlusherTests, DeltaCounterMetric) {
 }
 
 TEST_F(OtlpMetricsFlusherTests, CumulativeHistogramMetric) {
-  OtlpMetricsFlusherImpl flusher(otlpOptions());
+  OtlpMetricsFlusherImpl flusher(otlpOptions(), *symbol_table_);
 
   addHistogramToSnapshot("test_histogram1");
   addHistogramToSnapshot("test_histogram2");
 
-  MetricsExportRequestSharedPtr metrics = flusher.flush(snapshot_);
+  MetricsExportRequestSharedPtr metrics = flushOne(flusher);
   expectMetricsCount(metrics, 2);
   expectHistogram(metricAt(0, metrics), getTagExtractedName("test_histogram1"), false);
   expectHistogram(metricAt(1, metrics), getTagExtractedName("test_histogram2"), false);
 }
 
 TEST_F(OtlpMetricsFlusherTests, DeltaHistogramMetric) {
-  OtlpMetricsFlusherImpl flusher(otlpOptions(false, true, true, true));
+  OtlpMetricsFlusherImpl flusher(otlpOptions(false, true, true, true), *symbol_table_);
 
   addHistogramToSnapshot("test_histogram1", true);
   addHistogramToSnapshot("test_histogram2", true);
 
-  MetricsExportRequestSharedPtr metrics = flusher.flush(snapshot_);
+  MetricsExportRequestSharedPtr metrics = flushOne(flusher);
   expectMetricsCount(metrics, 2);
   expectHistogram(metricAt(0, metrics), getTagExtractedName("test_histogram1"), true);
   expectHistogram(metricAt(1, metrics), getTagExtractedName("test_histogram2"), true);
 }
 
+TEST_F(OtlpMetricsFlusherTests, DeltaMetricsSkipUnchangedStats) {
+  OtlpMetricsFlusherImpl flusher(otlpOptions(true, true, true, true), *symbol_table_);
+
+  addCounterToSnapshot("test_counter1", 0, 1);
+  addCounterToSnapshot("test_counter2", 2, 3);
+  addHostCounterToSnapshot("test_host_counter1", 0, 4);
+  addHostCounterToSnapshot("test_host_counter2", 5, 10);
+  addHistogramToSnapshot("test_histogram1", true);
+  // Has no samples in the interval.
+  addHistogramToSnapshot("test_histogram2", false);
+
+  MetricsExportRequestSharedPtr metrics = flushOne(flusher);
+  expectMetricsCount(metrics, 3);
+  expectSum(metricAt(0, metrics), getTagExtractedName("test_counter2"), 2, true);
+  expectSum(metricAt(1, metrics), getTagExtractedName("test_host_counter2"), 5, true);
+  expectHistogram(metricAt(2, metrics), getTagExtractedName("test_histogram1"), true);
+}
+
+TEST_F(OtlpMetricsFlusherTests, DeltaMetricsKeepUnchangedStatsWithRuntimeGuardDisabled) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.otlp_stats_skip_unchanged_deltas", "false"}});
+  OtlpMetricsFlusherImpl flusher(otlpOptions(true, true, true, true), *symbol_table_);
+
+  addCounterToSnapshot("test_counter", 0, 1);
+  addHostCounterToSnapshot("test_host_counter", 0, 4);
+  addHistogramToSnapshot("test_histogram", false);
+
+  MetricsExportRequestSharedPtr metrics = flushOne(flusher);
+  expectMetricsCount(metrics, 3);
+  expectSum(metricAt(0, metrics), getTagExtractedName("test_counter"), 0, true);
+  expectSum(metricAt(1, metrics), getTagExtractedName("test_host_counter"), 0, true);
+}
+
+TEST_F(OtlpMetricsFlusherTests, CumulativeMetricsKeepUnchangedStats) {
+  OtlpMetricsFlusherImpl flusher(otlpOptions(), *symbol_table_);
+
+  addCounterToSnapshot("test_counter", 0, 1);
+  addHostCounterToSnapshot("test_host_counter", 0, 4);
+
+  MetricsExportRequestSharedPtr metrics = flushOne(flusher);
+  expectMetricsCount(metrics, 2);
+  expectSum(metricAt(0, metrics), getTagExtractedName("test_counter"), 1, false);
+  expectSum(metricAt(1, metrics), getTagExtractedName("test_host_counter"), 4, false);
+}
+
+TEST_F(OtlpMetricsFlusherTests, ExportRequestsAreSplitAtMaxSize) {
+  for (int i = 0; i < 10; i++) {
+    addCounterToSnapshot(absl::StrCat("test_counter", i), 1, 1);
+  }
+  OtlpMetricsFlusherImpl unbounded_flusher(otlpOptions(), *symbol_table_);
+  const uint32_t single_request_bytes = flushOne(unbounded_flusher)->ByteSizeLong();
+
+  const uint32_t max_bytes = single_request_bytes / 3;
+  OtlpMetricsFlusherImpl flusher(otlpOptions(false, false, true, true, "", max_bytes),
+                                 *symbol_table_);
+  std::vector<MetricsExportRequestPtr> requests = flusher.flush(snapshot_);
+  EXPECT_LE(4U, requests.size());
+
+  int index = 0;
+  for (const MetricsExportRequestPtr& request : requests) {
+    EXPECT_GE(max_bytes, request->ByteSizeLong());
+    for (const auto& metric : request->resource_metrics()[0].scope_metrics()[0].metrics()) {
+      expectSum(metric, getTagExtractedName(absl::StrCat("test_counter", index++)), 1, false);
+    }
+  }
+  EXPECT_EQ(10, index);
+}
+
+TEST_F(OtlpMetricsFlusherTests, MetricLargerThanMaxSizeIsSentAlone) {
+  OtlpMetricsFlusherImpl flusher(otlpOptions(false, false, true, true, "", 1), *symbol_table_);
+
+  addCounterToSnapshot("test_counter1", 1, 1);
+  addCounterToSnapshot("test_counter2", 1, 1);
+
+  std::vector<MetricsExportRequestPtr> requests = flusher.flush(snapshot_);
+  ASSERT_EQ(2U, requests.size());
+  for (const MetricsExportRequestPtr& request : requests) {
+    EXPECT_EQ(1, request->resource_metrics()[0].scope_metrics()[0].metrics().size());
+  }
+}
+
+TEST_F(OtlpMetricsFlusherTests, ExportRequestsAreNotSplitByDefaultWithRuntimeGuardDisabled) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.otlp_stats_split_export_requests", "false"}});
+
+  addCounterToSnapshot("test_counter1", 1, 1);
+  addCounterToSnapshot("test_counter2", 1, 1);
+
+  OtlpMetricsFlusherImpl flusher(otlpOptions(), *symbol_table_);
+  EXPECT_EQ(std::numeric_limits<uint64_t>::max(), otlpOptions()->maxExportRequestBytes());
+  MetricsExportRequestSharedPtr metrics = flushOne(flusher);
+  expectMetricsCount(metrics, 2);
+
+  // An explicitly configured size still applies.
+  OtlpMetricsFlusherImpl bounded_flusher(otlpOptions(false, false, true, true, "", 1),
+                                         *symbol_table_);
+  EXPECT_EQ(2U, bounded_flusher.flush(snapshot_).size());
+}
+
+TEST_F(OtlpMetricsFlusherTests, NoMetrics) {
+  OtlpMetricsFlusherImpl flusher(otlpOptions(), *symbol_table_);
+
+  MetricsExportRequestSharedPtr metrics = flushOne(flusher);
+  expectMetricsCount(metrics, 0);
+}
+
+TEST_F(OtlpMetricsFlusherTests, MetricIdentitiesAreCachedWhileFlushed) {
+  OtlpMetricsFlusherImpl flusher(otlpOptions(), *symbol_table_);
+
+  addCounterToSnapshot("test_counter", 1, 1);
+  addGaugeToSnapshot("test_gauge", 1);
+  addHostGaugeToSnapshot("test_host_gauge", 1);
+
+  flushOne(flusher);
+  EXPECT_EQ(2U, flusher.cachedMetricsForTest());
+
+  // The cached name and attributes are reused.
+  MetricsExportRequestSharedPtr metrics = flushOne(flusher);
+  expectMetricsCount(metrics, 3);
+  expectGauge(metricAt(0, metrics), getTagExtractedName("test_gauge"), 1);
+  expectAttributes(metricAt(0, metrics).gauge().data_points()[0].attributes(), "gauge_key",
+                   "gauge_val");
+  expectSum(metricAt(2, metrics), getTagExtractedName("test_counter"), 1, false);
+  expectAttributes(metricAt(2, metrics).sum().data_points()[0].attributes(), "counter_key",
+                   "counter_val");
+  EXPECT_EQ(2U, flusher.cachedMetricsForTest());
+
+  // Metrics which aren't flushed anymore are evicted.
+  gauge_storage_.back()->used_ = false;
+  flushOne(flusher);
+  EXPECT_EQ(1U, flusher.cachedMetricsForTest());
+}
+
 class MockOpenTelemetryGrpcMetricsExporter : public OpenTelemetryGrpcMetricsExporter {
 public:
   MOCK_METHOD(void, send, (MetricsExportRequestPtr &&));
@@ -442,7 +592,7 @@ public:
 
 class MockOtlpMetricsFlusher : public OtlpMetricsFlusher {
 public:
-  MOCK_METHOD(MetricsExportRequestPtr, flush, (Stats::MetricSnapshot&), (const));
+  MOCK_METHOD(std::vector<MetricsExportRequestPtr>, flush, (Stats::MetricSnapshot&));
 };
 
 class OpenTelemetryGrpcSinkTests : public OpenTelemetryStatsSinkTests {
@@ -456,9 +606,11 @@ public:
 };
 
 TEST_F(OpenTelemetryGrpcSinkTests, BasicFlow) {
-  MetricsExportRequestPtr request = std::make_unique<MetricsExportRequest>();
-  EXPECT_CALL(*flusher_, flush(_)).WillOnce(Return(ByMove(std::move(request))));
-  EXPECT_CALL(*exporter_, send(_));
+  std::vector<MetricsExportRequestPtr> requests;
+  requests.push_back(std::make_unique<MetricsExportRequest>());
+  requests.push_back(std::make_unique<MetricsExportRequest>());
+  EXPECT_CALL(*flusher_, flush(_)).WillOnce(Return(ByMove(std::move(requests))));
+  EXPECT_CALL(*exporter_, send(_)).Times(2);
 
   OpenTelemetryGrpcSink sink(flusher_, exporter_);
   sink.flush(snapshot_);
@@ -109,6 +109,32 @@ TEST_P(StatsConfigParameterizedTest, UdpSinkCustomPrefix) {
   EXPECT_EQ(udp_sink->getPrefix(), customPrefix);
 }
 
+TEST_P(StatsConfigParameterizedTest, UdpSinkMaxBytesPerDatagram) {
+  envoy::config::metrics::v3::StatsdSink sink_config;
+  envoy::config::core::v3::Address& address = *sink_config.mutable_address();
+  envoy::config::core::v3::SocketAddress& socket_address = *address.mutable_socket_address();
+  socket_address.set_protocol(envoy::config::core::v3::SocketAddress::UDP);
+  Network::Address::InstanceConstSharedPtr loopback_flavor =
+      Network::Test::getCanonicalLoopbackAddress(GetParam());
+  socket_address.set_address(loopback_flavor->ip()->addressAsString());
+  socket_address.set_port_value(8125);
+  sink_config.mutable_max_bytes_per_datagram()->set_value(1432);
+
+  Server::Configuration::StatsSinkFactory* factory =
+      Registry::FactoryRegistry<Server::Configuration::StatsSinkFactory>::getFactory(StatsdName);
+  ASSERT_NE(factory, nullptr);
+  ProtobufTypes::MessagePtr message = factory->createEmptyConfigProto();
+  TestUtility::jsonConvert(sink_config, *message);
+
+  NiceMock<Server::Configuration::MockServerFactoryContext> server;
+  Stats::SinkPtr sink = factory->createStatsSink(*message, server).value();
+  ASSERT_NE(sink, nullptr);
+
+  auto udp_sink = dynamic_cast<Common::Statsd::UdpStatsdSink*>(sink.get());
+  ASSERT_NE(udp_sink, nullptr);
+  EXPECT_EQ(udp_sink->getBufferSizeForTest(), 1432);
+}
+
 TEST(StatsConfigTest, TcpSinkDefaultPrefix) {
   envoy::config::metrics::v3::StatsdSink sink_config;
   const auto& defaultPrefix = Common::Statsd::getDefaultPrefix();
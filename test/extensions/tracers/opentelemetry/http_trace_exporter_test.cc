@@ -1,7 +1,9 @@
 #include <sys/types.h>
 
 #include "source/common/buffer/zero_copy_input_stream_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
 #include "source/common/version/version.h"
+#include "source/extensions/compression/gzip/decompressor/zlib_decompressor_impl.h"
 #include "source/extensions/tracers/opentelemetry/http_trace_exporter.h"
 
 #include "test/mocks/common.h"
@@ -28,7 +30,7 @@ class OpenTelemetryHttpTraceExporterTest : public testing::Test {
 public:
   OpenTelemetryHttpTraceExporterTest() = default;
 
-  void setup(envoy::config::core::v3::HttpService http_service) {
+  void setup(envoy::config::core::v3::HttpService http_service, bool compress = false) {
     cluster_manager_.thread_local_cluster_.cluster_.info_->name_ = "my_o11y_backend";
     cluster_manager_.initializeThreadLocalClusters({"my_o11y_backend"});
     ON_CALL(cluster_manager_.thread_local_cluster_, httpAsyncClient())
@@ -37,7 +39,7 @@ public:
     cluster_manager_.initializeClusters({"my_o11y_backend"}, {});
 
     trace_exporter_ =
-        std::make_unique<OpenTelemetryHttpTraceExporter>(cluster_manager_, http_service);
+        std::make_unique<OpenTelemetryHttpTraceExporter>(cluster_manager_, http_service, compress);
   }
 
 protected:
@@ -47,6 +49,52 @@ protected:
   NiceMock<Stats::MockIsolatedStatsStore>& mock_scope_ = context_.server_factory_context_.store_;
 };
 
+// Test that the body of an export request is gzip compressed when configured.
+TEST_F(OpenTelemetryHttpTraceExporterTest, ExportSpanCompressed) {
+  std::string yaml_string = fmt::format(R"EOF(
+  http_uri:
+    uri: "https://some-o11y.com/otlp/v1/traces"
+    cluster: "my_o11y_backend"
+    timeout: 0.250s
+  )EOF");
+
+  envoy::config::core::v3::HttpService http_service;
+  TestUtility::loadFromYaml(yaml_string, http_service);
+  setup(http_service, true);
+
+  opentelemetry::proto::collector::trace::v1::ExportTraceServiceRequest
+      export_trace_service_request;
+  for (int i = 0; i < 10; i++) {
+    opentelemetry::proto::trace::v1::Span span;
+    span.set_name("ingress some-o11y.com");
+    *export_trace_service_request.add_resource_spans()->add_scope_spans()->add_spans() = span;
+  }
+
+  Http::MockAsyncClientRequest request(&cluster_manager_.thread_local_cluster_.async_client_);
+  EXPECT_CALL(cluster_manager_.thread_local_cluster_.async_client_, send_(_, _, _))
+      .WillOnce(
+          Invoke([&](Http::RequestMessagePtr& message, Http::AsyncClient::Callbacks&,
+                     const Http::AsyncClient::RequestOptions&) -> Http::AsyncClient::Request* {
+            EXPECT_EQ("gzip", message->headers()
+                                  .get(Http::LowerCaseString("content-encoding"))[0]
+                                  ->value()
+                                  .getStringView());
+            EXPECT_LT(message->body().length(), export_trace_service_request.ByteSizeLong());
+
+            Stats::IsolatedStoreImpl stats_store;
+            Compression::Gzip::Decompressor::ZlibDecompressorImpl decompressor(
+                *stats_store.rootScope(), "test.", 4096, 100);
+            decompressor.init(15 | 16);
+            Buffer::OwnedImpl decompressed;
+            decompressor.decompress(message->body(), decompressed);
+            opentelemetry::proto::collector::trace::v1::ExportTraceServiceRequest received;
+            EXPECT_TRUE(received.ParseFromString(decompressed.toString()));
+            EXPECT_TRUE(TestUtility::protoEqual(received, export_trace_service_request));
+            return &request;
+          }));
+  EXPECT_TRUE(trace_exporter_->log(export_trace_service_request));
+}
+
 // Test exporting an OTLP message via HTTP containing one span
 TEST_F(OpenTelemetryHttpTraceExporterTest, CreateExporterAndExportSpan) {
   std::string yaml_string = fmt::format(R"EOF(
@@ -352,6 +352,57 @@ TEST_F(OpenTelemetryDriverTest, ExportOTLPSpanWithBuffer) {
   EXPECT_EQ(2U, stats_.counter("tracing.opentelemetry.spans_sent").value());
 }
 
+// Verifies that the spans of a trace which wasn't sampled are exported once its local root span
+// ends, if the tail sampler keeps it, and dropped otherwise.
+TEST_F(OpenTelemetryDriverTest, TailSamplingKeepsTraceWithError) {
+  const std::string yaml_string = R"EOF(
+    grpc_service:
+      envoy_grpc:
+        cluster_name: fake-cluster
+      timeout: 0.250s
+    tail_sampling: {}
+    )EOF";
+  envoy::config::trace::v3::OpenTelemetryConfig opentelemetry_config;
+  TestUtility::loadFromYaml(yaml_string, opentelemetry_config);
+  setup(opentelemetry_config);
+  Tracing::TestTraceContextImpl request_headers{
+      {":authority", "test.com"}, {":path", "/"}, {":method", "GET"}};
+
+  Tracing::SpanPtr span =
+      driver_->startSpan(mock_tracing_config_, request_headers, stream_info_, operation_name_,
+                         {Tracing::Reason::NotTraceable, false});
+  Tracing::SpanPtr child =
+      span->spawnChild(mock_tracing_config_, "child", time_system_.systemTime());
+  child->setTag(Tracing::Tags::get().HttpStatusCode, "503");
+
+  EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.opentelemetry.min_flush_spans", 5U))
+      .WillOnce(Return(2));
+  child->finishSpan();
+  EXPECT_EQ(1U, TestUtility::findGauge(stats_, "tracing.opentelemetry.tail_sampling.buffered_spans")
+                    ->value());
+  EXPECT_CALL(*mock_client_, sendRaw(_, _, _, _, _, _));
+  span->finishSpan();
+  EXPECT_EQ(2U, stats_.counter("tracing.opentelemetry.spans_sent").value());
+  EXPECT_EQ(1U, stats_.counter("tracing.opentelemetry.tail_sampling.traces_kept_error").value());
+  EXPECT_EQ(0U, TestUtility::findGauge(stats_, "tracing.opentelemetry.tail_sampling.buffered_spans")
+                    ->value());
+
+  // A trace without an error, and without a latency threshold, is dropped.
+  Tracing::SpanPtr other_span =
+      driver_->startSpan(mock_tracing_config_, request_headers, stream_info_, operation_name_,
+                         {Tracing::Reason::NotTraceable, false});
+  const std::string trace_id = other_span->getTraceId();
+  const std::string span_id = other_span->getSpanId();
+  EXPECT_FALSE(trace_id.empty());
+  EXPECT_CALL(*mock_client_, sendRaw(_, _, _, _, _, _)).Times(0);
+  other_span->finishSpan();
+  // The ids of the span are still available, e.g. to the access logs, once it has finished.
+  EXPECT_EQ(trace_id, other_span->getTraceId());
+  EXPECT_EQ(span_id, other_span->getSpanId());
+  EXPECT_EQ(1U, stats_.counter("tracing.opentelemetry.tail_sampling.traces_dropped").value());
+  EXPECT_EQ(2U, stats_.counter("tracing.opentelemetry.spans_sent").value());
+}
+
 // Verifies the export happens after a timeout
 TEST_F(OpenTelemetryDriverTest, ExportOTLPSpanWithFlushTimeout) {
   timer_ =
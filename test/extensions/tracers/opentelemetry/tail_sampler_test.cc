@@ -0,0 +1,147 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/tracers/opentelemetry/tail_sampler.h"
+
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace OpenTelemetry {
+namespace {
+
+using SpanProto = TailSampler::SpanProto;
+
+class TailSamplerTest : public testing::Test {
+public:
+  TailSampler& tailSampler() {
+    if (!tail_sampler_) {
+      tail_sampler_ = std::make_unique<TailSampler>(config_, time_system_, stats_);
+    }
+    return *tail_sampler_;
+  }
+
+  static SpanProto finishedSpan(absl::string_view trace_id, absl::string_view name,
+                                std::chrono::milliseconds duration = std::chrono::milliseconds(1),
+                                bool error = false) {
+    SpanProto span;
+    span.set_trace_id(std::string(trace_id));
+    span.set_name(std::string(name));
+    span.set_start_time_unix_nano(1000000000);
+    span.set_end_time_unix_nano(1000000000 + std::chrono::nanoseconds(duration).count());
+    if (error) {
+      span.mutable_status()->set_code(
+          ::opentelemetry::proto::trace::v1::Status::STATUS_CODE_ERROR);
+    }
+    return span;
+  }
+
+  static std::vector<std::string> names(const std::vector<SpanProto>& spans) {
+    std::vector<std::string> result;
+    for (const SpanProto& span : spans) {
+      result.push_back(span.name());
+    }
+    return result;
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl store_;
+  TailSamplingStats stats_{
+      TAIL_SAMPLING_STATS(POOL_COUNTER_PREFIX(*store_.rootScope(), "tail_sampling."),
+                          POOL_GAUGE_PREFIX(*store_.rootScope(), "tail_sampling."))};
+  TailSampler::ConfigProto config_;
+  std::unique_ptr<TailSampler> tail_sampler_;
+};
+
+TEST_F(TailSamplerTest, TraceWithErrorIsKept) {
+  EXPECT_TRUE(tailSampler().onSpanFinished(finishedSpan("a", "child", {}, true), false).empty());
+  EXPECT_EQ(stats_.buffered_spans_.value(), 1);
+  EXPECT_GT(stats_.buffered_bytes_.value(), 0);
+  EXPECT_EQ(names(tailSampler().onSpanFinished(finishedSpan("a", "root"), true)),
+            std::vector<std::string>({"child", "root"}));
+  EXPECT_EQ(stats_.traces_kept_error_.value(), 1);
+  EXPECT_EQ(stats_.buffered_spans_.value(), 0);
+  EXPECT_EQ(stats_.buffered_bytes_.value(), 0);
+}
+
+TEST_F(TailSamplerTest, TraceWithErrorIsDroppedIfKeepErrorsIsDisabled) {
+  config_.mutable_keep_errors()->set_value(false);
+  tailSampler().onSpanFinished(finishedSpan("a", "child", {}, true), false);
+  EXPECT_TRUE(tailSampler().onSpanFinished(finishedSpan("a", "root"), true).empty());
+  EXPECT_EQ(stats_.traces_dropped_.value(), 1);
+  EXPECT_EQ(stats_.buffered_spans_.value(), 0);
+}
+
+TEST_F(TailSamplerTest, TraceIsKeptIfLocalRootIsSlow) {
+  config_.mutable_latency_threshold()->set_nanos(100000000);
+  tailSampler().onSpanFinished(finishedSpan("a", "child"), false);
+  SpanProto fast_root = finishedSpan("a", "root", std::chrono::milliseconds(99));
+  EXPECT_TRUE(tailSampler().onSpanFinished(std::move(fast_root), true).empty());
+  EXPECT_EQ(stats_.traces_dropped_.value(), 1);
+
+  tailSampler().onSpanFinished(finishedSpan("b", "child"), false);
+  SpanProto slow_root = finishedSpan("b", "root", std::chrono::milliseconds(100));
+  EXPECT_EQ(names(tailSampler().onSpanFinished(std::move(slow_root), true)),
+            std::vector<std::string>({"child", "root"}));
+  EXPECT_EQ(stats_.traces_kept_latency_.value(), 1);
+}
+
+TEST_F(TailSamplerTest, OtherTracesAreKeptUpToTracesPerSecond) {
+  config_.set_traces_per_second(2);
+  EXPECT_EQ(tailSampler().onSpanFinished(finishedSpan("a", "root"), true).size(), 1);
+  EXPECT_EQ(tailSampler().onSpanFinished(finishedSpan("b", "root"), true).size(), 1);
+  EXPECT_TRUE(tailSampler().onSpanFinished(finishedSpan("c", "root"), true).empty());
+  EXPECT_EQ(stats_.traces_kept_rate_.value(), 2);
+  EXPECT_EQ(stats_.traces_dropped_.value(), 1);
+
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_EQ(tailSampler().onSpanFinished(finishedSpan("d", "root"), true).size(), 1);
+  EXPECT_EQ(stats_.traces_kept_rate_.value(), 3);
+}
+
+TEST_F(TailSamplerTest, FirstBufferedTracesAreEvictedOverMaxBufferedSpans) {
+  config_.mutable_max_buffered_spans()->set_value(2);
+  tailSampler().onSpanFinished(finishedSpan("a", "child1", {}, true), false);
+  tailSampler().onSpanFinished(finishedSpan("b", "child1", {}, true), false);
+  tailSampler().onSpanFinished(finishedSpan("a", "child2", {}, true), false);
+  EXPECT_EQ(stats_.spans_evicted_.value(), 2);
+  EXPECT_EQ(stats_.buffered_spans_.value(), 1);
+
+  // The local root of an evicted trace is decided on its own.
+  EXPECT_EQ(names(tailSampler().onSpanFinished(finishedSpan("a", "root"), true)),
+            std::vector<std::string>());
+  EXPECT_EQ(names(tailSampler().onSpanFinished(finishedSpan("b", "root"), true)),
+            std::vector<std::string>({"child1", "root"}));
+}
+
+TEST_F(TailSamplerTest, FirstBufferedTracesAreEvictedOverMaxBufferedBytes) {
+  const uint64_t span_size = finishedSpan("a", "child").ByteSizeLong();
+  config_.mutable_max_buffered_bytes()->set_value(2 * span_size);
+  tailSampler().onSpanFinished(finishedSpan("a", "child"), false);
+  tailSampler().onSpanFinished(finishedSpan("b", "child"), false);
+  EXPECT_EQ(stats_.spans_evicted_.value(), 0);
+  tailSampler().onSpanFinished(finishedSpan("c", "child"), false);
+  EXPECT_EQ(stats_.spans_evicted_.value(), 1);
+  EXPECT_EQ(stats_.buffered_bytes_.value(), 2 * span_size);
+}
+
+TEST_F(TailSamplerTest, BufferedSpansAreReleasedOnDestruction) {
+  tailSampler().onSpanFinished(finishedSpan("a", "child"), false);
+  EXPECT_EQ(stats_.buffered_spans_.value(), 1);
+  tail_sampler_.reset();
+  EXPECT_EQ(stats_.buffered_spans_.value(), 0);
+  EXPECT_EQ(stats_.buffered_bytes_.value(), 0);
+}
+
+} // namespace
+} // namespace OpenTelemetry
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
@@ -480,6 +480,13 @@ public:
       EXPECT_TRUE(response->complete());
       codec_clients[i]->close();
     }
+    // Whether or not the kernel steers packets by connection ID, none of them should have been
+    // delivered to a worker other than the one the kernel was expected to select.
+    EXPECT_EQ(0u, test_server_
+                      ->counter(version_ == Network::Address::IpVersion::v4
+                                    ? "listener.127.0.0.1_0.udp.downstream_rx_datagram_misrouted"
+                                    : "listener.[__1]_0.udp.downstream_rx_datagram_misrouted")
+                      ->value());
   }
 
 protected:
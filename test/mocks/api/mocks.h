@@ -91,6 +91,8 @@ public:
   MOCK_METHOD(SysCallIntResult, recvmmsg,
               (os_fd_t socket, struct mmsghdr* msgvec, unsigned int vlen, int flags,
                struct timespec* timeout));
+  MOCK_METHOD(SysCallIntResult, sendmmsg,
+              (os_fd_t socket, struct mmsghdr* msgvec, unsigned int vlen, int flags));
   MOCK_METHOD(SysCallIntResult, ftruncate, (int fd, off_t length));
   MOCK_METHOD(SysCallPtrResult, mmap,
               (void* addr, size_t length, int prot, int flags, int fd, off_t offset));
@@ -110,6 +112,7 @@ public:
   MOCK_METHOD(SysCallIntResult, open, (const char* pathname, int flags), (const));
   MOCK_METHOD(SysCallIntResult, open, (const char* pathname, int flags, mode_t mode), (const));
   MOCK_METHOD(SysCallIntResult, unlink, (const char* pathname), (const));
+  MOCK_METHOD(SysCallIntResult, rename, (const char* oldpath, const char* newpath), (const));
   MOCK_METHOD(SysCallIntResult, linkat,
               (os_fd_t olddirfd, const char* oldpath, os_fd_t newdirfd, const char* newpath,
                int flags),
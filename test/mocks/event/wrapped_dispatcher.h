@@ -106,6 +106,8 @@ public:
     return impl_.approximateMonotonicTime();
   }
 
+  MonotonicTime iterationStartTime() const override { return impl_.iterationStartTime(); }
+
   void updateApproximateMonotonicTime() override { impl_.updateApproximateMonotonicTime(); }
 
   bool isThreadSafe() const override { return impl_.isThreadSafe(); }
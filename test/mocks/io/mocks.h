@@ -13,6 +13,7 @@ public:
   MOCK_METHOD(void, unregisterEventfd, ());
   MOCK_METHOD(bool, isEventfdRegistered, (), (const));
   MOCK_METHOD(void, forEveryCompletion, (const CompletionCb& completion_cb));
+  MOCK_METHOD(IoUringResult, waitForCompletion, ());
   MOCK_METHOD(IoUringResult, prepareAccept,
               (os_fd_t fd, struct sockaddr* remote_addr, socklen_t* remote_addr_len,
                Request* user_data));
@@ -25,10 +26,19 @@ public:
   MOCK_METHOD(IoUringResult, prepareWritev,
               (os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs, off_t offset,
                Request* user_data));
+  MOCK_METHOD(IoUringResult, prepareRead,
+              (os_fd_t fd, bool fixed_file, void* buf, unsigned nbytes, off_t offset,
+               int buf_index, Request* user_data));
+  MOCK_METHOD(IoUringResult, prepareWrite,
+              (os_fd_t fd, bool fixed_file, const void* buf, unsigned nbytes, off_t offset,
+               int buf_index, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareClose, (os_fd_t fd, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareCancel, (Request * cancelling_user_data, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareShutdown, (os_fd_t fd, int how, Request* user_data));
   MOCK_METHOD(IoUringResult, submit, ());
+  MOCK_METHOD(IoUringResult, registerFiles, (unsigned count));
+  MOCK_METHOD(IoUringResult, updateRegisteredFile, (unsigned index, os_fd_t fd));
+  MOCK_METHOD(IoUringResult, registerBuffers, (const struct iovec* iovecs, unsigned count));
   MOCK_METHOD(void, injectCompletion, (os_fd_t fd, Request* user_data, int32_t result));
   MOCK_METHOD(void, removeInjectedCompletion, (os_fd_t fd));
 };
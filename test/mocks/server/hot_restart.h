@@ -26,6 +26,7 @@ public:
   MOCK_METHOD(absl::optional<AdminShutdownResponse>, sendParentAdminShutdownRequest, ());
   MOCK_METHOD(void, sendParentTerminateRequest, ());
   MOCK_METHOD(ServerStatsFromParent, mergeParentStatsIfAny, (Stats::StoreRoot & stats_store));
+  MOCK_METHOD(absl::optional<TlsSessionStateFromParent>, getParentTlsSessionState, ());
   MOCK_METHOD(void, shutdown, ());
   MOCK_METHOD(uint32_t, baseId, ());
   MOCK_METHOD(std::string, version, ());
@@ -41,6 +41,8 @@ MockServerContextConfig::MockServerContextConfig() {
   ON_CALL(*this, alpnProtocols()).WillByDefault(testing::ReturnRef(alpn_));
   ON_CALL(*this, signatureAlgorithms()).WillByDefault(testing::ReturnRef(sigalgs_));
   ON_CALL(*this, sessionTicketKeys()).WillByDefault(testing::ReturnRef(ticket_keys_));
+  ON_CALL(*this, sharedSessionResumption())
+      .WillByDefault(testing::ReturnRef(shared_session_resumption_));
   ON_CALL(*this, tlsKeyLogLocal()).WillByDefault(testing::ReturnRef(iplist_));
   ON_CALL(*this, tlsKeyLogRemote()).WillByDefault(testing::ReturnRef(iplist_));
   ON_CALL(*this, tlsKeyLogPath()).WillByDefault(testing::ReturnRef(path_));
@@ -159,6 +159,8 @@ public:
   MOCK_METHOD(const std::vector<SessionTicketKey>&, sessionTicketKeys, (), (const));
   MOCK_METHOD(bool, disableStatelessSessionResumption, (), (const));
   MOCK_METHOD(bool, disableStatefulSessionResumption, (), (const));
+  MOCK_METHOD(const absl::optional<SharedSessionResumptionConfig>&, sharedSessionResumption, (),
+              (const));
   MOCK_METHOD(const Network::Address::IpList&, tlsKeyLogLocal, (), (const));
   MOCK_METHOD(const Network::Address::IpList&, tlsKeyLogRemote, (), (const));
   MOCK_METHOD(const std::string&, tlsKeyLogPath, (), (const));
@@ -172,6 +174,7 @@ public:
   Network::Address::IpList iplist_;
   std::string path_;
   std::vector<SessionTicketKey> ticket_keys_;
+  absl::optional<SharedSessionResumptionConfig> shared_session_resumption_;
 };
 
 class MockTlsCertificateConfig : public TlsCertificateConfig {
@@ -213,6 +216,7 @@ public:
   MOCK_METHOD(bool, onlyVerifyLeafCertificateCrl, (), (const));
   MOCK_METHOD(absl::optional<uint32_t>, maxVerifyDepth, (), (const));
   MOCK_METHOD(bool, autoSniSanMatch, (), (const));
+  MOCK_METHOD(uint32_t, verificationCacheSize, (), (const));
 };
 
 class MockPrivateKeyMethodManager : public PrivateKeyMethodManager {
@@ -32,6 +32,16 @@ MockClusterManager::MockClusterManager()
                     OptRef<xds::core::v3::ResourceLocator>,
                     ProtobufMessage::ValidationVisitor&) { return MockOdCdsApiHandle::create(); }));
   ON_CALL(*this, addOrUpdateCluster(_, _, _)).WillByDefault(Return(false));
+  // Looks the cluster up in clusters(), so that tests only need to mock the latter.
+  ON_CALL(*this, getActiveCluster(_))
+      .WillByDefault(Invoke([this](const std::string& cluster_name) -> ClusterConstOptRef {
+        const ClusterInfoMaps cluster_maps = clusters();
+        auto cluster = cluster_maps.active_clusters_.find(cluster_name);
+        if (cluster == cluster_maps.active_clusters_.end()) {
+          return absl::nullopt;
+        }
+        return cluster->second;
+      }));
 }
 
 MockClusterManager::~MockClusterManager() = default;
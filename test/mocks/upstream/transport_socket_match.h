@@ -21,6 +21,7 @@ public:
               (const envoy::config::core::v3::Metadata*, const envoy::config::core::v3::Metadata*),
               (const));
   MOCK_METHOD(bool, allMatchesSupportAlpn, (), (const));
+  MOCK_METHOD(uint64_t, configHash, (), (const));
 
   Network::UpstreamTransportSocketFactoryPtr socket_factory_;
   Stats::TestUtil::TestStore stats_store_;
@@ -194,6 +194,24 @@ TEST_P(ActiveUdpListenerTest, MultipleFiltersOnReceiveErrorStopIteration) {
   active_listener_->onReceiveError(Api::IoError::IoErrorCode::UnknownError);
 }
 
+// Datagrams for another worker are forwarded to it, and counted.
+TEST_P(ActiveUdpListenerTest, ForwardDatagramToOtherWorker) {
+  setup(2);
+
+  auto* test_filter = new NiceMock<Network::MockUdpListenerReadFilter>(cb_);
+  active_listener_->addReadFilter(Network::UdpListenerReadFilterPtr{test_filter});
+
+  EXPECT_CALL(*test_filter, onData(_)).Times(0);
+  active_listener_->destination_ = 1;
+  active_listener_->onData(Network::UdpRecvData());
+  EXPECT_EQ(1, store_.counterFromString("udp.downstream_rx_datagram_forwarded").value());
+
+  EXPECT_CALL(*test_filter, onData(_));
+  active_listener_->destination_ = 0;
+  active_listener_->onData(Network::UdpRecvData());
+  EXPECT_EQ(1, store_.counterFromString("udp.downstream_rx_datagram_forwarded").value());
+}
+
 } // namespace
 } // namespace Server
 } // namespace Envoy
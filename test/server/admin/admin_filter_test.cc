@@ -1,28 +1,48 @@
 #include "source/server/admin/admin.h"
 #include "source/server/admin/admin_filter.h"
 
+#include "test/mocks/buffer/mocks.h"
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/server/instance.h"
 #include "test/test_common/environment.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
-using testing::ByMove;
 using testing::InSequence;
 using testing::NiceMock;
-using testing::Return;
+
 
 namespace Envoy {
 namespace Server {
 
+// A request whose response consists of a fixed number of chunks.
+class ChunkedRequest : public Admin::Request {
+public:
+  explicit ChunkedRequest(uint32_t num_chunks) : num_chunks_(num_chunks) {}
+
+  Http::Code start(Http::ResponseHeaderMap&) override { return Http::Code::OK; }
+  bool nextChunk(Buffer::Instance& response) override {
+    response.add("chunk");
+    return ++chunks_ < num_chunks_;
+  }
+
+private:
+  const uint32_t num_chunks_;
+  uint32_t chunks_{0};
+};
+
 class AdminFilterTest : public testing::TestWithParam<Network::Address::IpVersion> {
 public:
   AdminFilterTest() : filter_(admin_), request_headers_{{":path", "/"}} {
-    EXPECT_CALL(admin_, makeRequest(_)).WillOnce(Return(ByMove(adminHandlerCallback())));
+    EXPECT_CALL(admin_, makeRequest(_)).WillOnce([this](AdminStream&) {
+      return std::move(request_);
+    });
     filter_.setDecoderFilterCallbacks(callbacks_);
   }
 
   NiceMock<MockAdmin> admin_;
+  Admin::RequestPtr request_{adminHandlerCallback()};
   Stats::IsolatedStoreImpl listener_scope_;
   AdminFilter filter_;
   NiceMock<Http::MockStreamDecoderFilterCallbacks> callbacks_;
@@ -73,5 +93,40 @@ TEST_P(AdminFilterTest, Trailers) {
   EXPECT_EQ(Http::FilterTrailersStatus::StopIteration, filter_.decodeTrailers(request_trailers));
 }
 
+// Each chunk of a multi-chunk response is encoded in its own dispatcher iteration.
+TEST_P(AdminFilterTest, MultipleChunks) {
+  request_ = std::make_unique<ChunkedRequest>(3);
+  auto* next_chunk_cb = new NiceMock<Event::MockSchedulableCallback>(&callbacks_.dispatcher_);
+
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, false));
+  EXPECT_CALL(callbacks_, encodeData(BufferStringEqual("chunk"), false));
+  EXPECT_CALL(*next_chunk_cb, scheduleCallbackNextIteration());
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.decodeHeaders(request_headers_, true));
+
+  EXPECT_CALL(callbacks_, encodeData(BufferStringEqual("chunk"), false));
+  EXPECT_CALL(*next_chunk_cb, scheduleCallbackNextIteration());
+  next_chunk_cb->invokeCallback();
+
+  EXPECT_CALL(callbacks_, encodeData(BufferStringEqual("chunk"), true));
+  EXPECT_CALL(*next_chunk_cb, scheduleCallbackNextIteration()).Times(0);
+  next_chunk_cb->invokeCallback();
+}
+
+// Destroying the stream cancels the encoding of the remaining chunks.
+TEST_P(AdminFilterTest, DestroyedWhileStreaming) {
+  request_ = std::make_unique<ChunkedRequest>(3);
+  testing::MockFunction<void()> next_chunk_cb_destroyed;
+  auto* next_chunk_cb = new NiceMock<Event::MockSchedulableCallback>(&callbacks_.dispatcher_,
+                                                                     &next_chunk_cb_destroyed);
+
+  EXPECT_CALL(callbacks_, encodeData(_, false));
+  EXPECT_CALL(*next_chunk_cb, scheduleCallbackNextIteration());
+  filter_.decodeHeaders(request_headers_, true);
+
+  EXPECT_CALL(next_chunk_cb_destroyed, Call());
+  filter_.onDestroy();
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -1,9 +1,14 @@
 #include "envoy/admin/v3/clusters.pb.h"
 
+#include "source/common/network/address_impl.h"
+#include "source/server/admin/clusters_handler.h"
+
 #include "test/common/upstream/utility.h"
 #include "test/mocks/event/mocks.h"
 #include "test/server/admin/admin_instance.h"
+#include "test/test_common/test_runtime.h"
 
+using testing::HasSubstr;
 using testing::Return;
 using testing::ReturnPointee;
 using testing::ReturnRef;
@@ -245,6 +250,99 @@ fake_cluster::1.2.3.4:80::local_origin_success_rate::93.2
   EXPECT_EQ(expected_text, response2.toString());
 }
 
+// The JSON output is streamed a cluster at a time, and clusters removed while streaming are
+// skipped.
+TEST_P(AdminInstanceTest, ClustersJsonChunked) {
+  Upstream::ClusterManager::ClusterInfoMaps cluster_maps;
+  ON_CALL(server_.cluster_manager_, clusters()).WillByDefault(ReturnPointee(&cluster_maps));
+
+  std::vector<std::unique_ptr<NiceMock<Upstream::MockClusterMockPrioritySet>>> clusters;
+  for (const std::string name : {"cluster_a", "cluster_b", "cluster_c"}) {
+    clusters.push_back(std::make_unique<NiceMock<Upstream::MockClusterMockPrioritySet>>());
+    clusters.back()->info_->name_ = name;
+    cluster_maps.active_clusters_.emplace(name, *clusters.back());
+  }
+
+  ClustersJsonRequest request(server_.cluster_manager_);
+  request.setChunkSize(1);
+  Http::TestResponseHeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::OK, request.start(header_map));
+  EXPECT_EQ(Http::Headers::get().ContentTypeValues.Json, header_map.getContentTypeValue());
+
+  Buffer::OwnedImpl response;
+  EXPECT_TRUE(request.nextChunk(response));
+  EXPECT_THAT(response.toString(), HasSubstr("cluster_a"));
+  cluster_maps.active_clusters_.erase("cluster_b");
+  uint32_t chunks = 1;
+  while (request.nextChunk(response)) {
+    ++chunks;
+  }
+  EXPECT_EQ(2, chunks);
+
+  envoy::admin::v3::Clusters output_proto;
+  TestUtility::loadFromJson(response.toString(), output_proto);
+  ASSERT_EQ(2, output_proto.cluster_statuses_size());
+  EXPECT_EQ("cluster_a", output_proto.cluster_statuses(0).name());
+  EXPECT_EQ("cluster_c", output_proto.cluster_statuses(1).name());
+}
+
+// Without clusters, the JSON output is an empty object, like the JSON rendering of an empty proto.
+TEST_P(AdminInstanceTest, ClustersJsonEmpty) {
+  Buffer::OwnedImpl response;
+  Http::TestResponseHeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::OK, getCallback("/clusters?format=json", header_map, response));
+  EXPECT_EQ("{}", response.toString());
+}
+
+// With streaming disabled, the JSON output is rendered from the proto and pretty-printed.
+TEST_P(AdminInstanceTest, ClustersJsonPrettyWithoutStreaming) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.admin_stream_clusters_json", "false"}});
+  Upstream::ClusterManager::ClusterInfoMaps cluster_maps;
+  ON_CALL(server_.cluster_manager_, clusters()).WillByDefault(ReturnPointee(&cluster_maps));
+  NiceMock<Upstream::MockClusterMockPrioritySet> cluster;
+  cluster_maps.active_clusters_.emplace(cluster.info_->name_, cluster);
+
+  Buffer::OwnedImpl response;
+  Http::TestResponseHeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::OK, getCallback("/clusters?format=json", header_map, response));
+  EXPECT_EQ(Http::Headers::get().ContentTypeValues.Json, header_map.getContentTypeValue());
+  EXPECT_THAT(response.toString(), HasSubstr("{\n \"cluster_statuses\": [\n"));
+  envoy::admin::v3::Clusters output_proto;
+  TestUtility::loadFromJson(response.toString(), output_proto);
+  ASSERT_EQ(1, output_proto.cluster_statuses_size());
+  EXPECT_EQ("fake_cluster", output_proto.cluster_statuses(0).name());
+}
+
+// Envoy internal addresses are rendered like the proto JSON output, omitting an empty endpoint id.
+TEST_P(AdminInstanceTest, ClustersJsonEnvoyInternalAddress) {
+  Upstream::ClusterManager::ClusterInfoMaps cluster_maps;
+  ON_CALL(server_.cluster_manager_, clusters()).WillByDefault(ReturnPointee(&cluster_maps));
+  NiceMock<Upstream::MockClusterMockPrioritySet> cluster;
+  cluster_maps.active_clusters_.emplace(cluster.info_->name_, cluster);
+  Upstream::MockHostSet* host_set = cluster.priority_set_.getMockHostSet(0);
+  for (const std::string endpoint_id : {"", "endpoint"}) {
+    auto host = std::make_shared<NiceMock<Upstream::MockHost>>();
+    Network::Address::InstanceConstSharedPtr address =
+        std::make_shared<Network::Address::EnvoyInternalInstance>("listener", endpoint_id);
+    ON_CALL(*host, address()).WillByDefault(Return(address));
+    host_set->hosts_.emplace_back(host);
+  }
+
+  Buffer::OwnedImpl response;
+  Http::TestResponseHeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::OK, getCallback("/clusters?format=json", header_map, response));
+  envoy::admin::v3::Clusters output_proto;
+  TestUtility::loadFromJson(response.toString(), output_proto);
+  ASSERT_EQ(1, output_proto.cluster_statuses_size());
+  ASSERT_EQ(2, output_proto.cluster_statuses(0).host_statuses_size());
+  EXPECT_THAT(response.toString(),
+              HasSubstr(R"("envoy_internal_address":{"server_listener_name":"listener"})"));
+  EXPECT_THAT(response.toString(), HasSubstr(R"("envoy_internal_address":{)"
+                                             R"("server_listener_name":"listener",)"
+                                             R"("endpoint_id":"endpoint"})"));
+}
+
 TEST_P(AdminInstanceTest, TestSetHealthFlag) {
   std::shared_ptr<Upstream::MockClusterInfo> cluster{new NiceMock<Upstream::MockClusterInfo>()};
   Event::MockDispatcher dispatcher;
@@ -129,6 +129,55 @@ TEST_P(AdminInstanceTest, ConfigDumpMaintainsOrder) {
   }
 }
 
+// The config dump is streamed a config at a time, and produces the same output as when it is
+// rendered at once. Configs whose owners were removed while streaming are skipped.
+TEST_P(AdminInstanceTest, ConfigDumpChunked) {
+  std::vector<ConfigTracker::EntryOwnerPtr> entries;
+  for (const std::string name : {"a", "b", "c"}) {
+    entries.push_back(admin_.getConfigTracker().add(name, [name](const Matchers::StringMatcher&) {
+      auto msg = std::make_unique<ProtobufWkt::StringValue>();
+      msg->set_value(absl::StrCat(name, "_config"));
+      return msg;
+    }));
+  }
+  const std::string expected_json = R"EOF({
+ "configs": [
+  {
+   "@type": "type.googleapis.com/google.protobuf.StringValue",
+   "value": "a_config"
+  },
+  {
+   "@type": "type.googleapis.com/google.protobuf.StringValue",
+   "value": "c_config"
+  }
+ ]
+}
+)EOF";
+
+  ConfigDumpHandler handler(admin_.getConfigTracker(), server_);
+  ConfigDumpRequest request(handler, {});
+  request.setChunkSize(1);
+  Http::TestResponseHeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::OK, request.start(header_map));
+  EXPECT_EQ(Http::Headers::get().ContentTypeValues.Json, header_map.getContentTypeValue());
+  Buffer::OwnedImpl response;
+  EXPECT_TRUE(request.nextChunk(response));
+  entries[1].reset();
+  uint32_t chunks = 1;
+  while (request.nextChunk(response)) {
+    ++chunks;
+  }
+  EXPECT_EQ(2, chunks);
+  EXPECT_EQ(expected_json, response.toString());
+}
+
+TEST_P(AdminInstanceTest, ConfigDumpEmpty) {
+  Buffer::OwnedImpl response;
+  Http::TestResponseHeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::OK, getCallback("/config_dump", header_map, response));
+  EXPECT_EQ("{}\n", response.toString());
+}
+
 // Test that using ?include_eds parameter adds EDS to the config dump.
 TEST_P(AdminInstanceTest, ConfigDumpWithEndpoint) {
   Upstream::ClusterManager::ClusterInfoMaps cluster_maps;
@@ -0,0 +1,130 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "envoy/admin/v3/config_dump_shared.pb.h"
+#include "envoy/config/cluster/v3/cluster.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/utility.h"
+#include "source/server/admin/clusters_handler.h"
+#include "source/server/admin/config_dump_handler.h"
+#include "source/server/admin/config_tracker_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/server/instance.h"
+#include "test/mocks/upstream/cluster_manager.h"
+#include "test/mocks/upstream/cluster_priority_set.h"
+#include "test/mocks/upstream/host.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using ::benchmark::State;
+using Envoy::benchmark::skipExpensiveBenchmarks;
+
+namespace Envoy {
+namespace Server {
+
+// Measures rendering /clusters?format=json and /config_dump for many clusters, and how much of
+// the response is buffered at once, i.e. the size of its largest chunk.
+class StreamingHandlersSpeedTest {
+public:
+  StreamingHandlersSpeedTest(size_t num_clusters) {
+    ON_CALL(cluster_manager_, clusters()).WillByDefault([this]() { return cluster_maps_; });
+    ON_CALL(cluster_manager_, getActiveCluster(testing::_))
+        .WillByDefault([this](const std::string& name) -> Upstream::ClusterConstOptRef {
+          auto cluster = cluster_maps_.active_clusters_.find(name);
+          if (cluster == cluster_maps_.active_clusters_.end()) {
+            return absl::nullopt;
+          }
+          return cluster->second;
+        });
+    // All clusters share a host, which keeps the setup of large benchmarks tractable.
+    ON_CALL(*host_, address()).WillByDefault(testing::Return(address_));
+    for (size_t i = 0; i < num_clusters; ++i) {
+      auto cluster = std::make_unique<NiceMock<Upstream::MockClusterMockPrioritySet>>();
+      cluster->info_->name_ = absl::StrCat("cluster_", i);
+      cluster->priority_set_.getMockHostSet(0)->hosts_.push_back(host_);
+      cluster_maps_.active_clusters_.emplace(cluster->info_->name_, *cluster);
+      clusters_.push_back(std::move(cluster));
+    }
+
+    // The static clusters of the config dump mirror the clusters above.
+    clusters_entry_ = config_tracker_.add("clusters", [num_clusters](
+                                                          const Matchers::StringMatcher&) {
+      auto dump = std::make_unique<envoy::admin::v3::ClustersConfigDump>();
+      for (size_t i = 0; i < num_clusters; ++i) {
+        envoy::config::cluster::v3::Cluster cluster;
+        cluster.set_name(absl::StrCat("cluster_", i));
+        cluster.set_type(envoy::config::cluster::v3::Cluster::STATIC);
+        cluster.mutable_connect_timeout()->set_seconds(1);
+        dump->add_static_clusters()->mutable_cluster()->PackFrom(cluster);
+      }
+      return dump;
+    });
+    ON_CALL(server_, clusterManager()).WillByDefault(testing::ReturnRef(cluster_manager_));
+  }
+
+  void render(State& state, Admin::Request& request) {
+    Http::TestResponseHeaderMapImpl response_headers;
+    RELEASE_ASSERT(request.start(response_headers) == Http::Code::OK, "");
+    uint64_t total_bytes = 0;
+    uint64_t max_chunk_bytes = 0;
+    bool more_data;
+    do {
+      Buffer::OwnedImpl chunk;
+      more_data = request.nextChunk(chunk);
+      total_bytes += chunk.length();
+      max_chunk_bytes = std::max<uint64_t>(max_chunk_bytes, chunk.length());
+    } while (more_data);
+    state.counters["total_bytes"] = total_bytes;
+    state.counters["max_chunk_bytes"] = max_chunk_bytes;
+  }
+
+  void clustersJson(State& state) {
+    ClustersJsonRequest request(cluster_manager_);
+    render(state, request);
+  }
+
+  void configDump(State& state) {
+    ConfigDumpHandler handler(config_tracker_, server_);
+    ConfigDumpRequest request(handler, {});
+    render(state, request);
+  }
+
+  NiceMock<Upstream::MockClusterManager> cluster_manager_;
+  Upstream::ClusterManager::ClusterInfoMaps cluster_maps_;
+  std::vector<std::unique_ptr<NiceMock<Upstream::MockClusterMockPrioritySet>>> clusters_;
+  std::shared_ptr<NiceMock<Upstream::MockHost>> host_{
+      std::make_shared<NiceMock<Upstream::MockHost>>()};
+  Network::Address::InstanceConstSharedPtr address_{
+      Network::Utility::parseInternetAddressNoThrow("10.0.1.1", 1000)};
+  ConfigTrackerImpl config_tracker_;
+  ConfigTracker::EntryOwnerPtr clusters_entry_;
+  NiceMock<MockInstance> server_;
+};
+
+} // namespace Server
+} // namespace Envoy
+
+static void clustersJson(State& state) {
+  // if we've been instructed to skip tests, only run once no matter the argument:
+  const size_t num_clusters = skipExpensiveBenchmarks() ? 1 : state.range(0);
+  Envoy::Server::StreamingHandlersSpeedTest speed_test(num_clusters);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    speed_test.clustersJson(state);
+  }
+}
+
+BENCHMARK(clustersJson)->Arg(1000)->Arg(50000)->Unit(benchmark::kMillisecond);
+
+static void configDump(State& state) {
+  // if we've been instructed to skip tests, only run once no matter the argument:
+  const size_t num_clusters = skipExpensiveBenchmarks() ? 1 : state.range(0);
+  Envoy::Server::StreamingHandlersSpeedTest speed_test(num_clusters);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    speed_test.configDump(state);
+  }
+}
+
+BENCHMARK(configDump)->Arg(1000)->Arg(50000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,117 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "source/common/memory/stats.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/server/hot_restarting_child.h"
+#include "source/server/hot_restarting_parent.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/server/instance.h"
+#include "test/mocks/server/listener_manager.h"
+#include "test/server/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Server {
+
+class NullHotRestartMessageSender : public HotRestartMessageSender {
+public:
+  void sendHotRestartMessage(envoy::HotRestartMessage&&) override {}
+};
+
+// A hot restart parent with many stats, and a child which merges them, with the messages
+// between the two serialized as they would be on the hot restart socket.
+class HotRestartStatsBenchmark {
+public:
+  explicit HotRestartStatsBenchmark(uint32_t num_stats)
+      : parent_(&server_, message_sender_), child_(0, 0, testDomainSocketName(), 0, false, false) {
+    ON_CALL(server_, stats()).WillByDefault(testing::ReturnRef(parent_store_));
+    ON_CALL(server_, listenerManager()).WillByDefault(testing::ReturnRef(listener_manager_));
+    for (uint32_t i = 0; i < num_stats; ++i) {
+      const std::string name = absl::StrCat("cluster.cluster_", i / 100, ".stat_", i % 100);
+      if (i % 2 == 0) {
+        counters_.push_back(&parent_store_.rootScope()->counterFromString(name));
+      } else {
+        parent_store_.rootScope()
+            ->gaugeFromString(name, Stats::Gauge::ImportMode::Accumulate)
+            .set(i);
+      }
+    }
+  }
+
+  void incCounters() {
+    for (Stats::Counter* counter : counters_) {
+      counter->inc();
+    }
+  }
+
+  // Transfers one round of the parent's stats to the child, in chunks of max_stats stats, or in
+  // one message if max_stats is 0.
+  void transfer(uint32_t max_stats) {
+    const int64_t heap_before = Memory::Stats::totalCurrentlyAllocated();
+    bool more = true;
+    while (more) {
+      envoy::HotRestartMessage wrapped_reply;
+      parent_.exportStatsToChild(wrapped_reply.mutable_reply()->mutable_stats(), max_stats);
+      const std::string serialized = wrapped_reply.SerializeAsString();
+      envoy::HotRestartMessage received;
+      RELEASE_ASSERT(received.ParseFromString(serialized), "failed to parse stats reply");
+      peak_message_bytes_ = std::max<uint64_t>(peak_message_bytes_, serialized.size());
+      peak_heap_bytes_ = std::max<int64_t>(
+          peak_heap_bytes_, Memory::Stats::totalCurrentlyAllocated() - heap_before);
+      child_.mergeParentStats(child_store_, received.reply().stats());
+      more = received.reply().stats().more();
+      ++messages_;
+    }
+  }
+
+  testing::NiceMock<MockInstance> server_;
+  testing::NiceMock<MockListenerManager> listener_manager_;
+  NullHotRestartMessageSender message_sender_;
+  Stats::IsolatedStoreImpl parent_store_;
+  Stats::IsolatedStoreImpl child_store_;
+  HotRestartingParent::Internal parent_;
+  HotRestartingChild child_;
+  std::vector<Stats::Counter*> counters_;
+  uint64_t peak_message_bytes_{};
+  int64_t peak_heap_bytes_{};
+  uint64_t messages_{};
+};
+
+// Measures the time it takes until all of the stats of the parent are merged by the child, and
+// the peak size of the messages and of the heap growth while they are transferred. The heap is
+// only measured when built with tcmalloc.
+static void hotRestartStatsTransfer(::benchmark::State& state) {
+  const uint32_t num_stats = benchmark::skipExpensiveBenchmarks() ? 1000 : state.range(0);
+  const uint32_t max_stats = state.range(1);
+  HotRestartStatsBenchmark speed_test(num_stats);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    speed_test.incCounters();
+    state.ResumeTiming();
+    speed_test.transfer(max_stats);
+  }
+  state.counters["messages_per_round"] =
+      static_cast<double>(speed_test.messages_) / state.iterations();
+  state.counters["peak_message_bytes"] = speed_test.peak_message_bytes_;
+  state.counters["peak_heap_bytes"] = speed_test.peak_heap_bytes_;
+  state.SetItemsProcessed(state.iterations() * num_stats);
+}
+
+BENCHMARK(hotRestartStatsTransfer)
+    ->Args({100000, 0})
+    ->Args({100000, HotRestartingChild::DefaultStatsChunkSize})
+    ->Args({1000000, 0})
+    ->Args({1000000, HotRestartingChild::DefaultStatsChunkSize})
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace Server
+} // namespace Envoy
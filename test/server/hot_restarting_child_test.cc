@@ -1,3 +1,4 @@
+#include <list>
 #include <memory>
 
 #include "source/common/api/os_sys_calls_impl.h"
@@ -67,6 +68,38 @@ public:
     });
     udp_forwarding_rpc_stream_.sendHotRestartMessage(child_address_udp_forwarding_, message);
   }
+  // Expects the child to request stats in chunks of max_stats, and replies to each request with
+  // the next of replies.
+  void expectStatsRequests(uint32_t max_stats, const std::vector<HotRestartMessage>& replies) {
+    auto datagrams = std::make_shared<std::list<std::string>>();
+    for (const HotRestartMessage& reply : replies) {
+      const std::string serialized = reply.SerializeAsString();
+      const uint64_t length = htobe64(serialized.size());
+      datagrams->push_back(std::string(reinterpret_cast<const char*>(&length), sizeof(length)) +
+                           serialized);
+    }
+    EXPECT_CALL(os_sys_calls_, sendmsg(_, _, _))
+        .Times(replies.size())
+        .WillRepeatedly([max_stats](int, const msghdr* msg, int) {
+          HotRestartMessage request;
+          EXPECT_TRUE(request.ParseFromArray(
+              static_cast<char*>(msg->msg_iov[0].iov_base) + sizeof(uint64_t),
+              msg->msg_iov[0].iov_len - sizeof(uint64_t)));
+          EXPECT_EQ(max_stats, request.request().stats().max_stats());
+          return Api::SysCallSizeResult{static_cast<ssize_t>(msg->msg_iov[0].iov_len), 0};
+        });
+    EXPECT_CALL(os_sys_calls_, recvmsg(_, _, _))
+        .Times(replies.size())
+        .WillRepeatedly([datagrams](int, msghdr* msg, int) {
+          const std::string datagram = datagrams->front();
+          datagrams->pop_front();
+          msg->msg_control = nullptr;
+          msg->msg_controllen = 0;
+          msg->msg_flags = 0;
+          memcpy(msg->msg_iov[0].iov_base, datagram.data(), datagram.size());
+          return Api::SysCallSizeResult{static_cast<ssize_t>(datagram.size()), 0};
+        });
+  }
   void expectParentTerminateMessages() {
     EXPECT_CALL(os_sys_calls_, sendmsg(_, _, _)).WillOnce([](int, const msghdr* msg, int) {
       return Api::SysCallSizeResult{static_cast<ssize_t>(msg->msg_iov[0].iov_len), 0};
@@ -174,6 +207,48 @@ TEST_F(HotRestartingChildTest, ParentDrainedCallbacksAreCalledImmediatelyWhenAlr
                                                        callback2.AsStdFunction());
 }
 
+TEST_F(HotRestartingChildTest, MergesParentStatsInChunks) {
+  Stats::TestUtil::TestStore store;
+  HotRestartMessage first_chunk;
+  auto* first_stats = first_chunk.mutable_reply()->mutable_stats();
+  (*first_stats->mutable_counter_deltas())["c1"] = 3;
+  first_stats->set_memory_allocated(100);
+  first_stats->set_num_connections(2);
+  first_stats->set_more(true);
+  HotRestartMessage last_chunk;
+  auto* last_stats = last_chunk.mutable_reply()->mutable_stats();
+  (*last_stats->mutable_gauges())["g1"] = 5;
+  last_stats->set_memory_allocated(200);
+  last_stats->set_num_connections(4);
+
+  auto* chunk_callback = new Event::MockSchedulableCallback(&dispatcher_);
+  EXPECT_CALL(*chunk_callback, scheduleCallbackNextIteration());
+  fake_parent_->expectStatsRequests(HotRestartingChild::DefaultStatsChunkSize,
+                                    {first_chunk, last_chunk});
+
+  // Only the first chunk is merged right away.
+  HotRestart::ServerStatsFromParent server_stats =
+      hot_restarting_child_->mergeParentStatsInChunks(store);
+  EXPECT_EQ(100, server_stats.parent_memory_allocated_);
+  EXPECT_EQ(2, server_stats.parent_connections_);
+  EXPECT_EQ(3, store.counter("c1").value());
+  EXPECT_EQ(0, store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).value());
+
+  // A round in progress isn't restarted.
+  server_stats = hot_restarting_child_->mergeParentStatsInChunks(store);
+  EXPECT_EQ(100, server_stats.parent_memory_allocated_);
+
+  chunk_callback->invokeCallback();
+  EXPECT_EQ(5, store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).value());
+
+  // The round is complete, so the parent is asked for its stats again.
+  fake_parent_->expectStatsRequests(HotRestartingChild::DefaultStatsChunkSize, {last_chunk});
+  server_stats = hot_restarting_child_->mergeParentStatsInChunks(store);
+  EXPECT_EQ(200, server_stats.parent_memory_allocated_);
+  EXPECT_EQ(4, server_stats.parent_connections_);
+  EXPECT_EQ(5, store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).value());
+}
+
 TEST_F(HotRestartingChildTest, LogsErrorOnReplyMessageInUdpStream) {
   envoy::HotRestartMessage msg;
   msg.mutable_reply();
@@ -1,6 +1,7 @@
 #include <memory>
 
 #include "source/common/network/address_impl.h"
+#include "source/common/tls/session_resumption_manager.h"
 #include "source/server/hot_restarting_child.h"
 #include "source/server/hot_restarting_parent.h"
 
@@ -268,6 +269,50 @@ TEST_F(HotRestartingParentTest, ExportStatsToChild) {
   }
 }
 
+TEST_F(HotRestartingParentTest, ExportStatsToChildInChunks) {
+  Stats::TestUtil::TestStore store;
+  MockListenerManager listener_manager;
+  EXPECT_CALL(server_, listenerManager()).WillRepeatedly(ReturnRef(listener_manager));
+  EXPECT_CALL(listener_manager, numConnections()).WillRepeatedly(Return(7));
+  EXPECT_CALL(server_, stats()).WillRepeatedly(ReturnRef(store));
+
+  store.counter("c1").inc();
+  store.counter("c2").add(2);
+  store.gauge("g0", Stats::Gauge::ImportMode::Accumulate).set(0);
+  store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).set(123);
+  store.gauge("g2", Stats::Gauge::ImportMode::Accumulate).set(456);
+
+  absl::flat_hash_map<std::string, uint64_t> counter_deltas;
+  absl::flat_hash_map<std::string, uint64_t> gauges;
+  std::vector<int> chunk_sizes;
+  bool more = true;
+  while (more) {
+    HotRestartMessage::Reply::Stats stats;
+    hot_restarting_parent_.exportStatsToChild(&stats, 2);
+    EXPECT_EQ(7, stats.num_connections());
+    chunk_sizes.push_back(stats.counter_deltas_size() + stats.gauges_size());
+    counter_deltas.insert(stats.counter_deltas().begin(), stats.counter_deltas().end());
+    gauges.insert(stats.gauges().begin(), stats.gauges().end());
+    if (chunk_sizes.size() == 1) {
+      // Stats created during a round are left to the next one.
+      store.counter("c3").inc();
+    }
+    more = stats.more();
+  }
+  EXPECT_EQ((std::vector<int>{2, 2, 1}), chunk_sizes);
+  EXPECT_EQ((absl::flat_hash_map<std::string, uint64_t>{{"c1", 1}, {"c2", 2}}), counter_deltas);
+  EXPECT_EQ((absl::flat_hash_map<std::string, uint64_t>{{"g0", 0}, {"g1", 123}, {"g2", 456}}),
+            gauges);
+
+  // The next round starts over, with the counters which changed since the last one.
+  HotRestartMessage::Reply::Stats stats;
+  hot_restarting_parent_.exportStatsToChild(&stats, 10);
+  EXPECT_FALSE(stats.more());
+  EXPECT_EQ(1, stats.counter_deltas_size());
+  EXPECT_EQ(1, stats.counter_deltas().at("c3"));
+  EXPECT_EQ(3, stats.gauges_size());
+}
+
 TEST_F(HotRestartingParentTest, RetainDynamicStats) {
   MockListenerManager listener_manager;
   Stats::SymbolTableImpl parent_symbol_table;
@@ -323,6 +368,32 @@ TEST_F(HotRestartingParentTest, DrainListeners) {
   hot_restarting_parent_.drainListeners();
 }
 
+TEST_F(HotRestartingParentTest, ExportTlsSessionStateToChild) {
+  using Extensions::TransportSockets::Tls::SessionResumptionManager;
+  auto manager = SessionResumptionManager::singleton(
+      server_.singletonManager(), server_.timeSource(), *server_.stats().rootScope());
+  Ssl::ServerContextConfig::SessionTicketKey key;
+  key.name_.fill('n');
+  key.hmac_key_.fill('h');
+  key.aes_key_.fill('a');
+  const SystemTime created{std::chrono::seconds(1234)};
+  manager->importState({{key, created}}, {});
+  ASSERT_TRUE(manager
+                  ->configure({/*max_cached_sessions_=*/100,
+                               /*ticket_key_rotation_interval_=*/std::chrono::hours(1),
+                               /*ticket_key_overlap_=*/std::chrono::hours(2)})
+                  .ok());
+
+  HotRestartMessage::Reply::TlsSessionState state;
+  hot_restarting_parent_.exportTlsSessionStateToChild(&state);
+  ASSERT_EQ(1, state.ticket_keys_size());
+  EXPECT_EQ(std::string(16, 'n'), state.ticket_keys(0).name());
+  EXPECT_EQ(std::string(32, 'h'), state.ticket_keys(0).hmac_key());
+  EXPECT_EQ(std::string(32, 'a'), state.ticket_keys(0).aes_key());
+  EXPECT_EQ(1234000000, state.ticket_keys(0).created_epoch_microseconds());
+  EXPECT_EQ(0, state.sessions_size());
+}
+
 TEST_F(HotRestartingParentTest, UdpPacketIsForwarded) {
   uint32_t worker_index = 12; // arbitrary index
   Network::UdpRecvData packet;
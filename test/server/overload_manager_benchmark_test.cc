@@ -0,0 +1,66 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <chrono>
+
+#include "source/server/overload_manager_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Server {
+
+// Posts a burst of work items to a dispatcher, each of which keeps the thread busy for a while and
+// then checks the event loop latency monitor of the thread, as a load shed point would.
+// Reports how long into the burst the monitor first reached its max loop duration.
+static void eventLoopLatencyBurst(::benchmark::State& state) {
+  const uint32_t burst_size = state.range(0);
+  const std::chrono::microseconds work_duration(state.range(1));
+  const std::chrono::milliseconds max_loop_duration(1);
+
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  TimeSource& time_source = api->timeSource();
+  EventLoopLatencyMonitor monitor(*dispatcher, max_loop_duration);
+
+  double time_to_shed_us = 0;
+  uint64_t items_before_shed = 0;
+  uint64_t bursts = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    // Lets the dispatcher start a new iteration of its event loop, which resets the current
+    // iteration time of the monitor.
+    dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+    const MonotonicTime burst_start = time_source.monotonicTime();
+    bool shed = false;
+    for (uint32_t i = 0; i < burst_size; ++i) {
+      dispatcher->post([&, i]() {
+        const MonotonicTime work_end = time_source.monotonicTime() + work_duration;
+        while (time_source.monotonicTime() < work_end) {
+        }
+        if (!shed && monitor.pressure() >= 1.0) {
+          shed = true;
+          time_to_shed_us += std::chrono::duration<double, std::micro>(
+                                 time_source.monotonicTime() - burst_start)
+                                 .count();
+          items_before_shed += i + 1;
+        }
+      });
+    }
+    dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+    ++bursts;
+  }
+  state.counters["time_to_shed_us"] = time_to_shed_us / bursts;
+  state.counters["items_before_shed"] = static_cast<double>(items_before_shed) / bursts;
+  state.SetItemsProcessed(state.iterations() * burst_size);
+}
+
+BENCHMARK(eventLoopLatencyBurst)
+    ->Args({100, 10})
+    ->Args({100, 50})
+    ->Args({1000, 10})
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace Server
+} // namespace Envoy
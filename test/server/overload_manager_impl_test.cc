@@ -36,6 +36,7 @@ using testing::NiceMock;
 using testing::Pointee;
 using testing::Property;
 using testing::Return;
+using testing::ReturnPointee;
 using testing::SaveArg;
 using testing::UnorderedElementsAreArray;
 
@@ -1195,6 +1196,158 @@ TEST_F(OverloadManagerLoadShedPointImplTest, LoadShedPointShouldUseCurrentReadin
   EXPECT_EQ(overload_action_states[0], UnitFloat(1));
 }
 
+class OverloadManagerEventLoopLatencyTest : public OverloadManagerLoadShedPointImplTest,
+                                            public Envoy::Event::TestUsingSimulatedTime {
+protected:
+  // The dispatcher of the thread local state reports the start of the current event loop
+  // iteration.
+  void startIteration() {
+    iteration_start_ = simTime().monotonicTime();
+    ON_CALL(thread_local_.dispatcher_, iterationStartTime())
+        .WillByDefault(ReturnPointee(&iteration_start_));
+  }
+
+  MonotonicTime iteration_start_;
+};
+
+constexpr char kEventLoopLatencyConfig[] = R"EOF(
+  event_loop_latency_monitor:
+    max_loop_duration: 0.1s
+  loadshed_points:
+    - name: "test_point"
+      triggers:
+        - name: "envoy.resource_monitors.event_loop_latency"
+          threshold:
+            value: 1.0
+)EOF";
+
+TEST_F(OverloadManagerEventLoopLatencyTest, UnknownResourceWithoutMonitor) {
+  const std::string config = R"EOF(
+    loadshed_points:
+      - name: "test_point"
+        triggers:
+          - name: "envoy.resource_monitors.event_loop_latency"
+            threshold:
+              value: 1.0
+  )EOF";
+
+  EXPECT_THROW_WITH_REGEX(createOverloadManager(config), EnvoyException,
+                          "Unknown trigger resource envoy.resource_monitors.event_loop_latency "
+                          "for loadshed point test_point");
+}
+
+// The point sheds load as soon as the current iteration of the event loop runs for longer than
+// the max loop duration, without waiting for the resource monitors to be refreshed.
+TEST_F(OverloadManagerEventLoopLatencyTest, ShedsLoadWhileIterationIsLong) {
+  setDispatcherExpectation();
+  startIteration();
+  auto manager{createOverloadManager(kEventLoopLatencyConfig)};
+  manager->start();
+
+  LoadShedPoint* point = manager->getLoadShedPoint("test_point");
+  ASSERT_NE(point, nullptr);
+  EXPECT_FALSE(point->shouldShedLoad());
+
+  simTime().advanceTimeWait(std::chrono::milliseconds(50));
+  EXPECT_FALSE(point->shouldShedLoad());
+
+  simTime().advanceTimeWait(std::chrono::milliseconds(60));
+  EXPECT_TRUE(point->shouldShedLoad());
+  EXPECT_EQ(1, stats_.counter("overload.test_point.shed_load_count").value());
+}
+
+// Updates of the approximate time of the dispatcher in the middle of an iteration, as QUIC
+// connections make, don't hide how long the iteration has been running.
+TEST_F(OverloadManagerEventLoopLatencyTest, ApproximateTimeUpdatedMidIteration) {
+  setDispatcherExpectation();
+  startIteration();
+  MonotonicTime approximate_time = iteration_start_;
+  ON_CALL(thread_local_.dispatcher_, approximateMonotonicTime())
+      .WillByDefault(ReturnPointee(&approximate_time));
+  auto manager{createOverloadManager(kEventLoopLatencyConfig)};
+  manager->start();
+
+  LoadShedPoint* point = manager->getLoadShedPoint("test_point");
+  ASSERT_NE(point, nullptr);
+  for (int i = 0; i < 3; ++i) {
+    simTime().advanceTimeWait(std::chrono::milliseconds(40));
+    approximate_time = simTime().monotonicTime();
+  }
+  EXPECT_TRUE(point->shouldShedLoad());
+}
+
+// The duration of a long iteration keeps the point shedding load during the next iteration, and
+// is halved with each iteration after it.
+TEST_F(OverloadManagerEventLoopLatencyTest, RecentIterationDurationDecays) {
+  setDispatcherExpectation();
+  startIteration();
+  auto manager{createOverloadManager(kEventLoopLatencyConfig)};
+  manager->start();
+
+  LoadShedPoint* point = manager->getLoadShedPoint("test_point");
+  ASSERT_NE(point, nullptr);
+
+  simTime().advanceTimeWait(std::chrono::milliseconds(150));
+  EXPECT_TRUE(point->shouldShedLoad());
+
+  startIteration();
+  EXPECT_TRUE(point->shouldShedLoad());
+
+  simTime().advanceTimeWait(std::chrono::milliseconds(1));
+  startIteration();
+  EXPECT_FALSE(point->shouldShedLoad());
+}
+
+// The duration of a long iteration also decays with the time elapsed until the next iteration the
+// monitor is checked in, so that a thread which was idle since doesn't shed load.
+TEST_F(OverloadManagerEventLoopLatencyTest, RecentIterationDurationDecaysWhileIdle) {
+  setDispatcherExpectation();
+  startIteration();
+  auto manager{createOverloadManager(kEventLoopLatencyConfig)};
+  manager->start();
+
+  LoadShedPoint* point = manager->getLoadShedPoint("test_point");
+  ASSERT_NE(point, nullptr);
+
+  simTime().advanceTimeWait(std::chrono::milliseconds(150));
+  EXPECT_TRUE(point->shouldShedLoad());
+
+  // Idle iterations, in which no load shed point is checked.
+  for (int i = 0; i < 5; ++i) {
+    simTime().advanceTimeWait(std::chrono::seconds(1));
+    startIteration();
+  }
+  EXPECT_FALSE(point->shouldShedLoad());
+  EXPECT_EQ(1, stats_.counter("overload.test_point.shed_load_count").value());
+}
+
+// The highest pressure of any thread since the previous refresh is reported as a gauge.
+TEST_F(OverloadManagerEventLoopLatencyTest, PressureGauge) {
+  setDispatcherExpectation();
+  startIteration();
+  auto manager{createOverloadManager(kEventLoopLatencyConfig)};
+  manager->start();
+
+  LoadShedPoint* point = manager->getLoadShedPoint("test_point");
+  ASSERT_NE(point, nullptr);
+  Stats::Gauge& pressure =
+      stats_.gauge("overload.envoy.resource_monitors.event_loop_latency.pressure",
+                   Stats::Gauge::ImportMode::Accumulate);
+
+  simTime().advanceTimeWait(std::chrono::milliseconds(110));
+  EXPECT_TRUE(point->shouldShedLoad());
+  startIteration();
+  simTime().advanceTimeWait(std::chrono::milliseconds(20));
+  EXPECT_TRUE(point->shouldShedLoad());
+
+  timer_cb_();
+  EXPECT_EQ(110, pressure.value());
+
+  timer_cb_();
+  EXPECT_EQ(0, pressure.value());
+  manager->stop();
+}
+
 } // namespace
 } // namespace Server
 } // namespace Envoy